@@ -4,36 +4,59 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <pthread.h>
 
 // Forward declarations
 struct Sim;
 struct NetworkManager;
+struct AdminSnapshot;
+struct AdminJob;
 
 // Admin server configuration
 #define ADMIN_DEFAULT_PORT 8081
 #define ADMIN_MAX_CONNECTIONS 10
 #define ADMIN_BUFFER_SIZE 4096
-#define ADMIN_MAX_CLIENTS 5
+#define ADMIN_MAX_CLIENTS 16
+#define ADMIN_MAX_BODY (512 * 1024)           /* 512 KB max request body */
+#define ADMIN_KEEPALIVE_TIMEOUT_MS 5000       /* Idle keep-alive connections are closed after this */
+#define ADMIN_SNAPSHOT_MAX_AGE_US (100 * 1000) /* GETs within this window share one snapshot */
+#define ADMIN_SNAPSHOT_WAIT_MS 250            /* Give up waiting for the tick loop after this */
 
 // Admin server context
+// The HTTP side runs on its own thread.  The tick loop only calls
+// admin_server_update(), which is a mutex check unless the admin thread has
+// asked for a world snapshot (GETs) or queued a mutating request (POSTs).
 struct AdminServer {
     int socket_fd;
     uint16_t port;
     bool running;
     
-    // Client connections
+    // Client connections (keep-alive, multiplexed with poll on the admin thread)
     struct AdminClient {
         int socket_fd;
         bool active;
-        char request_buffer[ADMIN_BUFFER_SIZE];
+        char* request_buffer;                 /* Grows up to ADMIN_BUFFER_SIZE + ADMIN_MAX_BODY */
+        size_t request_capacity;
         size_t request_length;
         uint32_t last_activity;
     } clients[ADMIN_MAX_CLIENTS];
     
+    // Admin thread ↔ tick loop handoff (all fields below guarded by mtx)
+    pthread_t thread;
+    pthread_mutex_t mtx;
+    pthread_cond_t cv;
+    bool thread_started;
+    bool snapshot_requested;                  /* Admin thread waiting for a fresh snapshot */
+    bool snapshot_valid;
+    struct AdminSnapshot* snapshot;           /* Written by tick loop only while requested */
+    struct AdminJob* job;                     /* Pending POST to run on the tick loop */
+    
     // Statistics
     uint32_t total_requests;
     uint32_t total_connections;
     uint32_t start_time;
+    uint32_t snapshots_taken;
+    uint64_t last_snapshot_us;                /* Tick-loop time spent copying the last snapshot */
 };
 
 // HTTP request types
@@ -42,6 +65,7 @@ typedef enum {
     HTTP_POST,
     HTTP_PUT,
     HTTP_DELETE,
+    HTTP_OPTIONS,
     HTTP_UNKNOWN
 } http_method_t;
 
@@ -52,6 +76,8 @@ struct HttpRequest {
     char* body;
     size_t body_length;
     char headers[1024];
+    size_t total_length;    /* Header + body bytes consumed from the connection buffer */
+    bool keep_alive;
 };
 
 struct HttpResponse {
@@ -60,31 +86,44 @@ struct HttpResponse {
     const char* body;
     size_t body_length;
     bool cache_control;
+    bool keep_alive;
 };
 
 // Admin server lifecycle
 int admin_server_init(struct AdminServer* admin, uint16_t port);
 void admin_server_cleanup(struct AdminServer* admin);
+/* Tick-loop side: services snapshot requests and runs queued POSTs. */
 int admin_server_update(struct AdminServer* admin, const struct Sim* sim, 
                        const struct NetworkManager* net_mgr);
 
 // HTTP request handling
+/* Returns 1 when a complete request (headers + Content-Length body) is in
+ * request_data, 0 if more bytes are needed, -1 on a malformed/oversized request. */
 int admin_parse_request(const char* request_data, size_t length, struct HttpRequest* req);
-int admin_handle_request(const struct HttpRequest* req, struct HttpResponse* resp,
-                        const struct Sim* sim, const struct NetworkManager* net_mgr);
+/* Admin-thread dispatch: GETs read the snapshot, POSTs are handed to the tick loop. */
+int admin_handle_request(struct AdminServer* admin, const struct HttpRequest* req,
+                        struct HttpResponse* resp);
 int admin_send_response(int client_fd, const struct HttpResponse* resp);
 
-// API endpoints
-int admin_api_status(struct HttpResponse* resp, const struct Sim* sim,
-                    const struct NetworkManager* net_mgr);
-int admin_api_entities(struct HttpResponse* resp, const struct Sim* sim);
-int admin_api_physics_objects(struct HttpResponse* resp, const struct Sim* sim);
+// World snapshot (read-only copy taken on the tick loop for admin GETs)
+struct AdminSnapshot* admin_snapshot_create(void);
+void admin_snapshot_destroy(struct AdminSnapshot* snap);
+void admin_snapshot_capture(struct AdminSnapshot* snap, const struct Sim* sim);
+
+// API endpoints — read-only ones take the snapshot, mutating ones run on the tick loop
+int admin_api_status(struct HttpResponse* resp, const struct AdminSnapshot* snap);
+int admin_api_entities(struct HttpResponse* resp, const struct AdminSnapshot* snap);
+int admin_api_physics_objects(struct HttpResponse* resp, const struct AdminSnapshot* snap);
 int admin_api_network_stats(struct HttpResponse* resp, const struct NetworkManager* net_mgr);
-int admin_api_performance(struct HttpResponse* resp, const struct Sim* sim);
-int admin_api_map_data(struct HttpResponse* resp, const struct Sim* sim);
-int admin_api_message_stats(struct HttpResponse* resp);
-int admin_api_input_tiers(struct HttpResponse* resp);
-int admin_api_websocket_entities(struct HttpResponse* resp);
+int admin_api_performance(struct HttpResponse* resp, const struct AdminSnapshot* snap);
+int admin_api_map_data(struct HttpResponse* resp, const struct AdminSnapshot* snap);
+int admin_api_message_stats(struct HttpResponse* resp, const struct AdminSnapshot* snap);
+int admin_api_input_tiers(struct HttpResponse* resp, const struct AdminSnapshot* snap);
+int admin_api_websocket_entities(struct HttpResponse* resp, const struct AdminSnapshot* snap);
+int admin_api_profile(struct HttpResponse* resp, const char* query);
+int admin_api_profile_trace(struct HttpResponse* resp);
+int admin_api_metrics(struct HttpResponse* resp);
+int admin_api_replay(struct HttpResponse* resp, const char* action);   /* NULL, "start", "stop" */
 int admin_api_create_ship(struct HttpResponse* resp, float x, float y, uint8_t company);
 int admin_api_create_phantom_brig(struct HttpResponse* resp, float x, float y, uint8_t level);
 int admin_api_set_player_company(struct HttpResponse* resp, uint32_t player_id, uint8_t company_id);
@@ -0,0 +1,43 @@
+#ifndef ADMIN_SNAPSHOT_H
+#define ADMIN_SNAPSHOT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sim/types.h"
+#include "input_validation.h"
+#include "net/websocket_server.h"
+
+/* Read-only world copy served to admin GETs.
+ *
+ * Captured on the tick loop (between input and physics, where admin requests
+ * used to be handled inline) only when the admin thread asks for one, so an
+ * idle dashboard costs nothing.  Only the live prefix of each array is copied;
+ * the admin thread reads it without touching any live simulation state. */
+struct AdminSnapshot {
+    uint32_t tick;
+    uint64_t taken_us;
+
+    // Sim entities (live prefix of struct Sim arrays)
+    struct Ship       ships[MAX_SHIPS];
+    uint16_t          ship_count;
+    struct Player     players[MAX_PLAYERS];
+    uint16_t          player_count;
+    struct Projectile projectiles[MAX_PROJECTILES];
+    uint16_t          projectile_count;
+
+    // WebSocket layer (players compacted to active entries only)
+    SimpleShip        ws_ships[MAX_SHIPS];
+    int               ws_ship_count;
+    WebSocketPlayer   ws_players[MAX_PLAYERS];
+    int               ws_player_count;
+    struct WebSocketStats        ws_stats;
+    bool                         ws_stats_ok;
+    struct WebSocketPerfSnapshot perf;
+
+    PlacedStructure   structures[MAX_PLACED_STRUCTURES];
+    uint32_t          structure_count;
+
+    int               tier_player_counts[INPUT_TIER_COUNT];
+};
+
+#endif /* ADMIN_SNAPSHOT_H */
@@ -3,6 +3,7 @@
 
 #include "net/websocket_server.h"
 #include "sim/simulation.h"
+#include "sim/ship_flooding.h"
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
@@ -11,10 +12,11 @@
 #define BUCKET_PROXIMITY_PX       60.0f
 #define BUCKET_BAIL_HALF_HP       2.0f
 #define BUCKET_BAIL_FULL_HP       4.0f
-#define BUCKET_LOWER_SCOOP_FILL   0.25f  /* lower deck — water must reach 25% hull flood */
-#define BUCKET_UPPER_SCOOP_FILL   0.75f  /* upper deck — water must reach 75% hull flood */
-#define BUCKET_WELL_SCOOP_FILL    0.01f  /* bilge well — scoop at 1% flood */
-#define BUCKET_SCOOP_FILL_GRACE   0.03f  /* tolerance while minigame runs (~2s heal drift) */
+/* Scoop lines live with the flood model (sim/ship_flooding.h) */
+#define BUCKET_LOWER_SCOOP_FILL   FLOOD_COMPARTMENT_LINE[FLOOD_LOWER]  /* lower deck — 25% hull flood */
+#define BUCKET_UPPER_SCOOP_FILL   FLOOD_COMPARTMENT_LINE[FLOOD_UPPER]  /* upper deck — 75% hull flood */
+#define BUCKET_WELL_SCOOP_FILL    FLOOD_COMPARTMENT_LINE[FLOOD_BILGE]  /* bilge well — 1% flood */
+#define BUCKET_SCOOP_FILL_GRACE   FLOOD_SCOOP_GRACE  /* tolerance while minigame runs (~2s heal drift) */
 
 /*
  * Bucket dump rules (server-authoritative):
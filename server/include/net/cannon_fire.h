@@ -8,6 +8,7 @@
 struct WebSocketClient;
 
 int parse_json_uint32_array(const char* json, const char* key, uint32_t* out, int max_out);
+void cannon_fire_init(void);  /* Registers hit-scan metrics; idempotent */
 void handle_cannon_group_config(WebSocketPlayer* player, int group_index, WeaponGroupMode mode, module_id_t* weapon_ids, int weapon_count, uint16_t target_ship_id);
 void tick_ship_weapon_groups(void);
 void handle_cannon_aim(WebSocketPlayer* player, float aim_angle, uint32_t* active_group_indices, int active_group_count);
@@ -21,6 +21,16 @@ void claim_on_fort_destroyed(uint32_t fort_structure_id);
  */
 void claim_tick(uint32_t delta_ms);
 
+/**
+ * Put a flag fort or unfinished Company Fortress back on a per-tick step
+ * after something outside its own tick handed it work (placement, capture,
+ * damage, repair).  No-op for other types and for forts already stepping.
+ */
+void claim_fort_wake(PlacedStructure *s);
+
+/** claim_fort_wake() every fort — once after world_load. */
+void claim_forts_wake_all(void);
+
 /**
  * Apply harvest tax for the given gross yield.
  * Returns the net quantity the player should actually receive.
@@ -79,17 +89,19 @@ void claim_recompute_dominators(uint32_t structure_id);
  *   - Ej ranges over OTHER companies' active non-orphaned anchors.
  *   - tmp_own = ⋃ over Mi of (Mi.disc ∖ ⋃ Mi.dominators discs).
  *
- * Built on a coarse cell grid (8 world units) covering the bounding box of
- * all qualifying anchors. The grid is flood-filled from (px,py); only the
- * connected component containing the placement point is retained.
+ * Built on a coarse cell grid (8 world units, aligned to the world origin)
+ * covering the bounding box of all qualifying anchors, one bit per cell. The
+ * grid is flood-filled from (px,py); only the connected component containing
+ * the placement point is retained, cropped to its own bounding box.
  *
  * Returns NULL if (px,py) is not inside any slice piece.
  */
 typedef struct {
-    float    origin_x, origin_y;
-    float    cell_size;
-    int      w, h;
-    uint8_t *cells;   /* w*h, 1 = in section */
+    float     origin_x, origin_y;
+    float     cell_size;
+    int       w, h;
+    int       stride;   /* uint64_t words per row */
+    uint64_t *bits;     /* h*stride; bit x of row y set = cell in section */
 } ClaimSectionGrid;
 
 ClaimSectionGrid *claim_section_build(uint8_t island_id, uint8_t company_id,
@@ -100,7 +112,40 @@ bool              claim_section_contains(const ClaimSectionGrid *g,
 bool              claim_section_disc_overlaps(const ClaimSectionGrid *g,
                                               float cx, float cy, float r);
 
-/* Invalidates all cached claim-flag section grids (e.g. after a structural
- * change that could alter section geometry).  Safe to call at any time. */
+/* Anchor discs two companies hold on one island, in slot order, for the
+ * capture's union-of-lens geometry: active, non-orphaned, non-flag anchors
+ * (complete flag forts only).  The arrays live in a growable pool that the
+ * next claim_capture_anchors() call reuses. */
+typedef struct {
+    const float    *x, *y, *r;
+    const uint32_t *id;
+    uint32_t        n;
+} ClaimAnchorSet;
+
+bool              claim_capture_anchors(uint8_t island_id, uint8_t mine_co, uint8_t enemy_co,
+                                        ClaimAnchorSet *mine, ClaimAnchorSet *enemy);
+/* (x,y) lies inside at least one disc of the set. */
+bool              claim_anchor_set_covers(const ClaimAnchorSet *set, float x, float y);
+
+/* Cached section for an active claim flag (built on first use), or NULL when
+ * the flag's position lies in no slice piece. */
+const ClaimSectionGrid *claim_flag_section(const PlacedStructure *flag);
+/* Drop a claim flag's cached section (flag consumed or destroyed). */
+void              claim_flag_section_release(uint16_t flag_id);
+
+/* Brings the claim-flag section cache up to date after structures changed:
+ * only sections that a changed claim disc (placed, destroyed, moved,
+ * orphaned, completed, re-owned or re-dominated anchor) can reach are
+ * rebuilt.  O(placed structures).  Safe to call at any time. */
 void              claim_invalidate_cf_sections(void);
 
+/* Number of section builds so far (placement checks and cache refills). */
+uint64_t          claim_section_build_count(void);
+
+/** Effective claim radius for a structure type. */
+static inline float struct_claim_radius(PlacedStructureType t) {
+    if (t == STRUCT_FLAG_FORT)      return CLAIM_RADIUS_FLAG_FORT;
+    if (t == STRUCT_COMPANY_FORTRESS) return CLAIM_RADIUS_COMPANY_FORT;
+    return CLAIM_RADIUS_DEFAULT;
+}
+
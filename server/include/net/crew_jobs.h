@@ -0,0 +1,41 @@
+#pragma once
+#include "net/websocket_server_internal.h"
+
+/* Crew job board.
+ *
+ * Each SimpleShip carries the work its crew can be sent to, kept up to date
+ * by the events that create it instead of being rediscovered by scanning
+ * every module for every NPC each tick:
+ *
+ *   Weapons — aim-in-sector, firing and reloading mark a weapon NEEDED
+ *             through crew_jobs_weapon_needed(), which lists it on the
+ *             first transition.  NEEDED expiry and gunner dispatch walk only
+ *             that list; weapons whose bit was cleared meanwhile (mode
+ *             change, expiry) or that were removed drop out as they are met.
+ *
+ *   Repairs — a missing deck, missing plank slots and damaged modules, read
+ *             from the sim ship.  Module damage bumps struct Ship.module_epoch
+ *             and any placement or removal changes module_count; the list is
+ *             rebuilt only when one of them moved.  Jobs repaired in the
+ *             meantime drop out when the list is read.
+ *
+ * Who takes a job (occupancy, affordability, distance) stays with the
+ * callers in npc_agents.c / npc_world.c. */
+
+/** Set MODULE_STATE_NEEDED on a weapon of `ship` and list it if it wasn't. */
+void crew_jobs_weapon_needed(SimpleShip* ship, ShipModule* mod);
+
+/** Weapons of `ship` currently NEEDED, in the order they were needed.
+ *  Compacts the list first, so every entry returned is live with the bit set. */
+const module_id_t* crew_jobs_needed_weapons(SimpleShip* ship, int* out_count);
+
+/** Open repair jobs for `ship`, rebuilt from `sim` if it changed since the
+ *  last call.  Module jobs that are back at full health are dropped. */
+const CrewRepairJob* crew_jobs_repairs(SimpleShip* ship, struct Ship* sim, int* out_count);
+
+/** Module behind a CREW_JOB_MODULE job and its health ratio (the lower of
+ *  hull and sail for masts), or NULL if the module is gone. */
+ShipModule* crew_job_module(struct Ship* sim, const CrewRepairJob* job, float* out_ratio);
+
+/** True if plank `slot` of the sim ship holds a live plank. */
+bool crew_jobs_plank_intact(const struct Ship* sim, uint8_t ship_seq, int slot);
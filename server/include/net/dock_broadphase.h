@@ -0,0 +1,37 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Broad phase for ship-vs-shipyard collision.
+ *
+ * Shipyards are static, so their world AABBs are filed once into a hashed
+ * grid of DOCK_BP_CELL_PX cells (client px) and only re-filed when the set
+ * of shipyards changes.  Each tick every ship queries the grid with the box
+ * it swept this tick; dock_bp_query() returns only the docks whose AABB
+ * actually overlaps it.  Ships on open water land in empty cells and cost a
+ * hash lookup, so the narrow phase scales with ships at docks rather than
+ * shipyards × ships.  Tick thread only. */
+
+#define DOCK_BP_CELL_PX    1024.0f
+#define DOCK_BP_BUCKETS    1024          /* Power of two                        */
+#define DOCK_BP_MAX_DOCKS  4096          /* = MAX_PLACED_STRUCTURES             */
+
+typedef struct {
+    float min_x, min_y, max_x, max_y;
+} DockBox;
+
+/** World AABB of a box of half-extents (hx, hy) centred on (x, y) and
+ *  rotated by rot_deg. */
+DockBox dock_bp_obb_box(float x, float y, float hx, float hy, float rot_deg);
+
+/** Replace the filed docks with boxes[0..n-1]; a dock's index is its
+ *  position in boxes[].  Docks past DOCK_BP_MAX_DOCKS are dropped. */
+void dock_bp_build(const DockBox *boxes, uint32_t n);
+
+/** Number of docks currently filed. */
+uint32_t dock_bp_count(void);
+
+/** Write the indices of filed docks whose box overlaps *q to out[], in
+ *  ascending order, each once.  Returns how many were written; past cap the
+ *  rest are left out. */
+uint32_t dock_bp_query(const DockBox *q, uint16_t *out, uint32_t cap);
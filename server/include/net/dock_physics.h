@@ -28,9 +28,16 @@ bool dock_point_on_surface(float lx, float ly, bool has_scaffolding);
 void dock_apply_player_collision(const PlacedStructure *dock, float player_r,
                                  bool has_scaffolding, float *wx, float *wy);
 
-/* Ship-dock physics: resolve ships entering the dock zone */
+/* Register dock metrics.  Call once from websocket_server_init. */
+void dock_physics_init(void);
+
+/* Ship-dock physics: resolve ships entering the dock zone.  Only pairs whose
+ * AABBs overlap are solved, and ships resting in a dock sleep until disturbed. */
 void handle_ship_dock_collisions(void);
 
+/* Pairs the last handle_ship_dock_collisions() solved and left asleep. */
+void dock_physics_last_counts(uint32_t *solved, uint32_t *sleeping);
+
 /* True if the brigantine build slot at (dock_x,dock_y,dock_rot_deg) overlaps island land. */
 bool dock_brig_slot_overlaps_land(float dock_x, float dock_y, float dock_rot_deg);
 
@@ -17,3 +17,19 @@ const IslandDef *get_island_for_player(const WebSocketPlayer *player);
  */
 int find_nearest_resource(const IslandDef *isl, float px, float py,
                           int res_type, float range_sq);
+
+/* Depleted nodes respawn from a timer instead of a per-tick scan.  A node
+ * whose footprint has been built over is looked at again every
+ * RESOURCE_RESPAWN_RETRY_MS until it clears. */
+#define RESOURCE_RESPAWN_RETRY_MS 5000u
+
+/** Mark resource `ri` of `isl` depleted and take it out of the island's
+ *  resource grid; it respawns delay_ms from now. */
+void harvest_schedule_respawn(IslandDef *isl, int ri, uint32_t delay_ms);
+
+/** True unless an active structure lies within 60 px of (rx, ry) — a
+ *  player has built over the depleted node's footprint. */
+bool island_resource_can_respawn(float rx, float ry);
+
+/** Re-arm the respawn of every depleted resource — once after world_load. */
+void harvest_respawns_wake_all(void);
@@ -0,0 +1,54 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Sparse world hazard grid for area-denial effects.
+ *
+ * Each tick every live area effect (liquid-flame waves today; smoke or
+ * spreading fire later) is registered as a source, and its footprint is
+ * stamped into the HAZARD_GRID_CELL_PX cells of a hashed world grid as one
+ * bit of the cell's source mask.  Entities then make a single pass, each
+ * sampling the cell it stands in: away from every hazard that is one hash
+ * probe returning 0, and only the sources whose bits are set go on to the
+ * exact test.  Footprints are stamped conservatively, so a source whose
+ * exact test could pass is always in the mask.  If more cells are stamped
+ * than the table holds, every sample returns all sources (still correct,
+ * just not pruned).  Tick thread only. */
+
+#define HAZARD_GRID_CELL_PX   64.0f
+#define HAZARD_GRID_SLOTS     4096     /* Power of two; cells stamped per tick */
+#define HAZARD_MAX_SOURCES    32       /* One mask bit each                    */
+
+typedef enum {
+    HAZARD_FLAME,                      /* Liquid-flame wave front (cone)       */
+} HazardKind;
+
+typedef struct {
+    HazardKind kind;
+    uint32_t   owner;                  /* Registrar's own index (flame_waves[]) */
+    float      ox, oy;                 /* Apex, world client px                */
+    float      dir_x, dir_y;           /* Unit cone axis                       */
+    float      half_angle;             /* Radians; footprint covers this much  */
+    float      reach;                  /* Footprint radius from the apex, px   */
+} HazardSource;
+
+/** Drop every source and stamped cell; call once per tick before adding. */
+void hazard_grid_clear(void);
+
+/**
+ * Register a cone of `half_angle` radians either side of `angle`, out to
+ * `reach` px from (ox, oy), and stamp the cells it touches.  Returns the
+ * source index (its bit in sample masks), or -1 once HAZARD_MAX_SOURCES are
+ * registered.
+ */
+int hazard_grid_add_cone(HazardKind kind, uint32_t owner, float ox, float oy,
+                         float angle, float half_angle, float reach);
+
+/** Number of sources registered since the last clear. */
+uint32_t hazard_grid_source_count(void);
+
+/** Source i (0 .. hazard_grid_source_count() - 1). */
+const HazardSource *hazard_grid_source(uint32_t i);
+
+/** Mask of the sources whose footprint may cover (x, y). */
+uint32_t hazard_grid_sample(float x, float y);
@@ -5,9 +5,9 @@
 #define PLAYER_LEVEL_XP_BASE 100u
 #define PLAYER_MAX_LEVEL     120u
 
-void tick_npc_agents(float dt);
+/** Runs the agents npc_sched_plan() picked this tick, each with its own accumulated dt. */
+void tick_npc_agents(void);
 void tick_cannon_needed_expiry(void);
-void tick_swivel_crew_demand(SimpleShip* ship);
 void assign_weapon_group_crew(SimpleShip* ship);
 void update_npc_cannon_sector(SimpleShip* ship, float aim_angle);
 void npc_apply_xp(WorldNpc* npc, uint32_t xp_gain);
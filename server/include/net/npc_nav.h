@@ -0,0 +1,86 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+
+/* NPC navigation service.
+ *
+ * Walkable grids are baked once per shape and kept for the life of the
+ * process: one per ship type × deck, from the deck collision polygon in
+ * protocol/ship_definitions.h (ship-local client px), and one per island,
+ * from its land polygon or bump circle (world px).  A cell is walkable when
+ * its centre is inside the shape and at least the grid's clearance from the
+ * edge.
+ *
+ * npc_nav_path() answers "how do I get from A to B on this grid" with a
+ * short list of corners (the goal itself is not included):
+ *
+ *   - clear line of sight   → no corners, walk straight (checked first;
+ *                             every path on a convex deck ends here)
+ *   - otherwise             → 8-connected A*, string-pulled to corners
+ *
+ * Results are cached by (grid, start cell, goal cell), so crews walking the
+ * same routes share one search.  Searches draw on a per-tick expansion
+ * budget (npc_nav_begin_tick); once it is spent npc_nav_path() returns
+ * NPC_NAV_BUSY and the caller retries next tick, so a burst of orders is
+ * spread over several ticks instead of stalling one. */
+
+#define NPC_NAV_MAX_GRIDS          32
+#define NPC_NAV_MAX_CORNERS         6      /* Longer paths come back partial   */
+#define NPC_NAV_DECK_CELL          10.0f   /* Client px                        */
+#define NPC_NAV_DECK_CLEARANCE     10.0f
+#define NPC_NAV_ISLAND_CELL        24.0f   /* Minimum; large islands go coarser */
+#define NPC_NAV_ISLAND_CLEARANCE    0.0f
+#define NPC_NAV_MAX_CELLS      (256 * 256)
+#define NPC_NAV_TICK_BUDGET     40000      /* A* expansions per tick           */
+#define NPC_NAV_CACHE_SIZE       1024      /* Power of two                     */
+
+typedef enum {
+    NPC_NAV_OK = 0,      /* Path found (possibly partial)                     */
+    NPC_NAV_NO_PATH,     /* Start or goal off the grid, or not connected      */
+    NPC_NAV_BUSY,        /* Tick budget spent; ask again next tick            */
+} NpcNavResult;
+
+typedef struct {
+    int      count;                              /* Corners before the goal  */
+    bool     partial;                            /* Re-plan from the last one */
+    float    corner[NPC_NAV_MAX_CORNERS][2];
+} NpcNavPath;
+
+typedef struct {
+    uint64_t queries;
+    uint64_t direct;          /* Answered by line of sight alone             */
+    uint64_t cache_hits;
+    uint64_t searches;        /* A* runs                                     */
+    uint64_t expansions;
+    uint64_t busy;            /* Deferred to a later tick                    */
+    uint64_t no_path;
+} NpcNavStats;
+
+/** Register metrics.  Call once from websocket_server_init. */
+void npc_nav_init(void);
+
+/** Refill the per-tick search budget.  Call once per tick before any path
+ *  queries. */
+void npc_nav_begin_tick(void);
+
+/** Grid for one deck of a ship type, baked from `pts` (ship-local client px)
+ *  the first time it is asked for.  -1 if the grid table is full or the
+ *  polygon is degenerate. */
+int npc_nav_deck_grid(uint8_t ship_type, uint8_t deck, const float (*pts)[2], int n);
+
+/** Grid for the land of ISLAND_PRESETS[preset], baked on first use.  -1 on
+ *  failure. */
+int npc_nav_island_grid(int preset);
+
+/** True if (x,y) lies on a walkable cell of `grid`. */
+bool npc_nav_walkable(int grid, float x, float y);
+
+/** Corners from (sx,sy) to (gx,gy) on `grid`.  Coordinates are in the
+ *  grid's frame (ship-local for decks, world for islands). */
+NpcNavResult npc_nav_path(int grid, float sx, float sy, float gx, float gy, NpcNavPath *out);
+
+/** Drop every cached path (grids stay). */
+void npc_nav_cache_clear(void);
+
+/** Cumulative counters since start. */
+void npc_nav_stats(NpcNavStats *out);
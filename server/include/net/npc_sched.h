@@ -0,0 +1,61 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Time-sliced NPC AI scheduler.
+ *
+ * Every tick npc_sched_plan() sorts each active WorldNpc and NpcAgent into a
+ * level of detail by distance to the nearest connected player and by what
+ * it is doing, then picks who runs this tick:
+ *
+ *   HOT   within NPC_LOD_HOT_DIST of a player (anything they can see) or
+ *         being knocked back / grappled                    — every tick
+ *   WARM  within NPC_LOD_WARM_DIST, or out of sight but walking, repairing,
+ *         swimming, burning or gunning at a target         — every 3rd tick
+ *   COLD  everything else                                  — every 15th tick
+ *
+ * At most NPC_SCHED_*_BUDGET entities of each kind run per tick; when more
+ * are due, the most overdue go first (HOT before WARM before COLD on ties)
+ * and the rest wait a tick.  An entity that sits out keeps accumulating dt
+ * and gets all of it on its next run, so rates (walking speed, regen,
+ * stamina, sail slew) are unchanged — only the update cadence drops. */
+
+typedef enum {
+    NPC_LOD_HOT = 0,
+    NPC_LOD_WARM,
+    NPC_LOD_COLD,
+    NPC_LOD_COUNT
+} NpcLod;
+
+#define NPC_LOD_HOT_DIST         6000.0f   /* Client px: max view radius 5500 + margin */
+#define NPC_LOD_WARM_DIST       12000.0f
+#define NPC_LOD_WARM_TICKS          3
+#define NPC_LOD_COLD_TICKS         15
+#define NPC_SCHED_WORLD_BUDGET    128      /* WorldNpc full updates per tick */
+#define NPC_SCHED_AGENT_BUDGET    128      /* NpcAgent updates per tick      */
+#define NPC_SCHED_MAX_DT          1.0f     /* Cap on accumulated dt (s)      */
+
+typedef struct {
+    uint32_t active;
+    uint32_t scheduled;               /* Run this tick                       */
+    uint32_t skipped;                 /* Not due at their LOD                */
+    uint32_t deferred;                /* Due, but past the per-tick budget   */
+    uint32_t per_lod[NPC_LOD_COUNT];  /* Active entities by LOD              */
+} NpcSchedTickStats;
+
+/** Register metrics.  Call once from websocket_server_init. */
+void npc_sched_init(void);
+
+/** Plan this tick for world_npcs[] and npc_agents[].  Call before
+ *  tick_npc_agents() / tick_world_npcs(). */
+void npc_sched_plan(float dt);
+
+/** True when world_npcs[i] runs this tick; *dt receives its accumulated time. */
+bool npc_sched_world_take(int i, float* dt);
+/** True when npc_agents[i] runs this tick; *dt receives its accumulated time. */
+bool npc_sched_agent_take(int i, float* dt);
+/** True when world_npcs[i] is held by an attached grapple (refreshed by plan). */
+bool npc_sched_world_grappled(int i);
+
+/** Counts from the last npc_sched_plan(). */
+void npc_sched_last_stats(NpcSchedTickStats* world, NpcSchedTickStats* agents);
@@ -3,12 +3,20 @@
 
 ShipModule* find_module_on_ship(SimpleShip* ship, uint32_t module_id);
 void dismount_npc(WorldNpc* npc, SimpleShip* ship);
+/** Record a gunner that just reached WORLD_NPC_STATE_AT_GUN in its ship's gunner index. */
+void npc_gunner_index_set(WorldNpc* npc, SimpleShip* ship);
+/** Drop npc from the gunner index before it leaves assigned_weapon_id. */
+void npc_gunner_index_clear(WorldNpc* npc, SimpleShip* ship);
+/** Gunner stationed AT_GUN on module_id, or NULL — O(1) via ship->gunner_by_mid. */
+WorldNpc* npc_gunner_at(SimpleShip* ship, uint32_t module_id);
 void handle_crew_assign(uint16_t ship_id, uint16_t npc_id, const char* task);
 uint32_t spawn_ship_crew(uint16_t ship_id);
 /** Spawn 1–3 swimming ghost-ship survivors at the wreck, assigned to killer company. */
 int ghost_spawn_survivors(float wreck_x, float wreck_y, uint16_t killer_ship_id);
 uint32_t spawn_unclaimed_npc(float wx, float wy, int index);
-void tick_world_npcs(float dt);
+/** Full update for the NPCs npc_sched_plan() picked this tick (each with its own
+ *  accumulated dt); the rest only follow their ship. */
+void tick_world_npcs(void);
 void npc_set_manual_order(WorldNpc* npc, uint32_t player_id);
 void npc_clear_manual_order(WorldNpc* npc);
 
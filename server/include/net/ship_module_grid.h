@@ -0,0 +1,61 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+#include "sim/module_types.h"
+
+/* Per-ship broad phase for module proximity checks.
+ *
+ * Module centres are filed into a uniform grid in ship-local client px, so
+ * walker-vs-module collision and placement overlap tests visit only the
+ * modules near the query point instead of all MAX_MODULES_PER_SHIP.  Modules
+ * sit still in ship-local space, so the grid stays valid until a module is
+ * placed, removed or moved: placement and removal change module_count, which
+ * the grid checks on every use; removals and moves also call
+ * ship_module_grid_invalidate() so a remove-then-place between two uses is
+ * not mistaken for no change.
+ *
+ * Only modules accepted by the build filter are filed (passable planks,
+ * decks, seats, ladders, hatches are left out). */
+
+#define SHIP_MODULE_GRID_CELL_PX    32.0f   /* Starting cell size; doubled until the ship fits */
+#define SHIP_MODULE_GRID_MAX_COLS   48
+#define SHIP_MODULE_GRID_MAX_ROWS   16
+
+typedef struct {
+    bool    valid;
+    uint8_t module_count;                 /* ship->module_count at build time    */
+    uint8_t cols, rows;
+    float   origin_x, origin_y;           /* Ship-local px of cell (0, 0) corner */
+    float   inv_cell;
+    /* Cell c holds refs[start[c] .. start[c + 1]) — modules[] indices,
+     * ascending within a cell. */
+    uint8_t start[SHIP_MODULE_GRID_MAX_COLS * SHIP_MODULE_GRID_MAX_ROWS + 1];
+    uint8_t refs[MAX_MODULES_PER_SHIP];
+    float   ref_x[MAX_MODULES_PER_SHIP];  /* Centre of refs[k], ship-local px    */
+    float   ref_y[MAX_MODULES_PER_SHIP];
+} ShipModuleGrid;
+
+/** Which modules get filed. */
+typedef bool (*ShipModuleGridFilter)(ModuleTypeId type);
+
+/** File modules[0..count-1] that pass `files`. */
+void ship_module_grid_build(ShipModuleGrid* g, const ShipModule* modules, uint8_t count,
+                            ShipModuleGridFilter files);
+
+/** True if g was built from a module array of `count` entries and nothing
+ *  invalidated it since. */
+static inline bool ship_module_grid_current(const ShipModuleGrid* g, uint8_t count) {
+    return g->valid && g->module_count == count;
+}
+
+/** Force a rebuild on next use (module removed, replaced or moved). */
+static inline void ship_module_grid_invalidate(ShipModuleGrid* g) {
+    g->valid = false;
+}
+
+/** Write the modules[] indices of filed modules whose centre lies within
+ *  `reach` px of (x, y) on both axes, ascending.  Callers pass their own
+ *  radius plus the largest radius of the modules they test against.  Returns
+ *  how many were written (never more than MAX_MODULES_PER_SHIP). */
+uint8_t ship_module_grid_query(const ShipModuleGrid* g, float x, float y, float reach,
+                               uint8_t out[MAX_MODULES_PER_SHIP]);
@@ -1,20 +1,100 @@
 #pragma once
+#include <math.h>
 #include <stdint.h>
 #include "net/websocket_server.h"
 
-/** Rebuild shipyard/chest/id lookup tables from placed_structures[]. */
+/* ── Structure store ──────────────────────────────────────────────────────
+ * placed_structures[] is a slot map: placed_structure_count is the high-water
+ * mark, dead slots below it are reused through a free list, and live
+ * structures are also kept in dense per-store and per-type slot lists.
+ * Slots freed during a tick are only handed out again after the next
+ * structure_store_reclaim(), so code that reads a just-destroyed structure
+ * (broadcasts, structure_by_id_any) keeps seeing its data until then. */
+
+/** Stable reference to one occupancy of a slot: (generation << 16) | slot.
+ *  Never 0; goes stale once the structure is freed and its slot reused. */
+typedef uint32_t StructureHandle;
+
+/** Take a zeroed slot, mark it active with `type` and a fresh id, and link it
+ *  into the live lists.  NULL when the store is full. */
+PlacedStructure *structure_alloc(PlacedStructureType type);
+
+/** Mark a structure destroyed and unlink it.  O(1); no-op if already dead. */
+void structure_free(PlacedStructure *s);
+
+/** True if structure_alloc() would succeed. */
+bool structure_store_has_room(void);
+
+/** Make slots freed since the last call available to structure_alloc().
+ *  Called once per tick. */
+void structure_store_reclaim(void);
+
+StructureHandle  structure_handle(const PlacedStructure *s);
+/** Active structure still occupying the handle's slot, or NULL. */
+PlacedStructure *structure_from_handle(StructureHandle h);
+
+/** placed_structures[] slot indices of every active structure, unordered.
+ *  Don't free structures while walking it (walk backwards if you must). */
+const uint32_t *structure_live_slots(uint32_t *count);
+
+/** Same, restricted to one PlacedStructureType. */
+const uint32_t *structure_slots_of_type(PlacedStructureType type, uint32_t *count);
+
+/** Changes whenever a structure of `type` is allocated, freed or re-indexed,
+ *  so callers caching something derived from that type's slot list know
+ *  when to refresh it. */
+uint32_t structure_type_epoch(PlacedStructureType type);
+
+/** Rebuild every index from placed_structures[] as it stands — for callers
+ *  that fill or edit the array wholesale (world load, tests). */
 void structure_index_rebuild(void);
 
+/** Active structure with this id, or NULL.  O(1); ids that no longer name a
+ *  structure (destroyed, slot reused, never issued) return NULL. */
+PlacedStructure *structure_by_id(uint32_t id);
+
+/** Like structure_by_id, but also returns a destroyed structure whose slot
+ *  has not been reused yet (active == false).  For callers that used to
+ *  match on id alone. */
+PlacedStructure *structure_by_id_any(uint32_t id);
+
 /** Active shipyard whose scaffolded_ship_id matches ship_id, or NULL. */
 PlacedStructure *shipyard_by_scaffolded_ship(uint32_t ship_id);
 
 /** Active shipyard with structure id, or NULL. */
 PlacedStructure *shipyard_by_id(uint16_t struct_id);
 
-/** Compact list of placed_structures[] slot indices for active shipyards. */
-uint32_t structure_index_shipyard_count(void);
-const uint32_t *structure_index_shipyard_slots(void);
+/** placed_structures[] slot indices, in slot order, of every active structure
+ *  whose claim circle could cover (wx,wy).  A superset: callers still check
+ *  company, claim_orphaned and the exact radius.  The grid is rebuilt on the
+ *  first query after any alloc/free. */
+const uint32_t *structure_index_claim_candidates(float wx, float wy, uint32_t *count);
+
+/* ── Placement grid ─────────────────────────────────────────────────────────
+ * Every active structure filed under the 25-px cell holding its centre —
+ * floor and ceiling tiles on their centres, walls and door frames on edge
+ * midpoints — so footprint and snapping checks only look at their
+ * neighbourhood.  Kept up to date as structures come and go. */
+
+#define STRUCTURE_CELL_PX  25.0f
+
+/** Placement-grid cell of a world coordinate. */
+static inline int32_t structure_cell(float v) { return (int32_t)lroundf(v / STRUCTURE_CELL_PX); }
+
+/** Bit for one type in a structure_index_near() type mask. */
+#define STRUCT_MASK(t)  (1u << (t))
+
+/** Result list for structure_index_near().  Give each call site its own
+ *  (usually static) so nested queries don't overwrite each other. */
+typedef struct {
+    uint32_t *slots;
+    uint32_t  count;
+    uint32_t  cap;
+} StructureNear;
 
-/** Compact list of placed_structures[] slot indices for active land chests. */
-uint32_t structure_index_chest_count(void);
-const uint32_t *structure_index_chest_slots(void);
+/** Fill `out` with the placed_structures[] slot indices, in slot order, of
+ *  active structures whose type is in `type_mask` (0 = any) and whose centre
+ *  cell overlaps the square of half-side r around (wx,wy) — every centre
+ *  within r on both axes, and then some: callers still do the exact test.
+ *  r = 0 gives the one cell holding (wx,wy).  Returns out->count. */
+uint32_t structure_index_near(StructureNear *out, float wx, float wy, float r, uint32_t type_mask);
@@ -59,12 +59,17 @@ void handle_repair_structure(WebSocketPlayer* player, struct WebSocketClient* cl
 void handle_door_lock(WebSocketPlayer* player, struct WebSocketClient* client, const char* payload);
 
 /**
- * Per-tick advance of any in-progress structure repairs. Raises hp and
- * target_hp at a constant rate (STRUCTURE_REPAIR_FULL_MS for one max_hp of
- * damage) and broadcasts structure_hp_changed when integer values change.
- * Emits repair_complete when target_hp reaches max_hp.
+ * Start the per-tick repair timer of a structure that has a player repair or
+ * passive construction in progress (no-op otherwise, or if already running).
+ * Each step raises hp and target_hp at a constant rate
+ * (STRUCTURE_REPAIR_FULL_MS for one max_hp of damage), broadcasts
+ * structure_hp_changed at ~1 Hz and emits repair_complete when target_hp
+ * reaches max_hp; the timer stops with the work.
  */
-void structure_repair_tick(uint32_t delta_ms);
+void structure_repair_wake(PlacedStructure *s);
+
+/** structure_repair_wake() every live structure — once after world_load. */
+void structure_repairs_wake_all(void);
 
 /**
  * Scan placed_structures[] and destroy any active entry whose hp has reached 0
@@ -3,6 +3,9 @@
 #include "sim/types.h"
 #include "sim/module_ids.h"
 #include "net/quality_payload.h"
+#include "net/npc_nav.h"
+#include "net/ship_module_grid.h"
+#include "util/timer_wheel.h"
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -66,6 +69,21 @@ typedef struct {
     QualityPayload quality;
 } ShipPoolBlueprint;
 
+/** Open repair job on a ship's crew job board (see net/crew_jobs.h). */
+typedef enum {
+    CREW_JOB_DECK   = 0,   // Deck missing — replace first
+    CREW_JOB_PLANK  = 1,   // Plank slot empty or destroyed
+    CREW_JOB_MODULE = 2,   // Module (or mast sail) below full health
+} CrewJobKind;
+
+typedef struct {
+    module_id_t module_id;  // MID of the deck / plank slot / damaged module
+    uint8_t     kind;       // CrewJobKind
+    uint8_t     slot;       // Plank slot (0-9), or sim modules[] index for CREW_JOB_MODULE
+} CrewRepairJob;
+
+#define CREW_REPAIR_JOBS_MAX (MAX_MODULES_PER_SHIP + 11)   /* modules + 10 planks + deck */
+
 // Simple ship structure for WebSocket server
 typedef struct SimpleShip {
     uint16_t ship_id;
@@ -124,6 +142,20 @@ typedef struct SimpleShip {
      * writes to [player->company_id]. */
     WeaponGroup weapon_groups[MAX_COMPANIES][MAX_WEAPON_GROUPS];
 
+    /* Lookup indices keyed by MID_OFFSET(module_id).  They travel with the
+     * struct when ships[] is compacted and are all-zero on a fresh ship.
+     *   module_slot_by_mid   — modules[] slot; checked against modules[].id on
+     *                          every hit and refreshed on a miss.
+     *   gunner_by_mid        — world_npcs[] slot + 1 of the gunner AT_GUN on
+     *                          that module; set on arrival, cleared on dismount,
+     *                          and checked against the WorldNpc on every hit.
+     *   weapon_group_by_mid  — group index + 1 per company; rebuilt on demand
+     *                          after weapon_groups_changed() clears the flag. */
+    uint8_t  module_slot_by_mid[256];
+    uint16_t gunner_by_mid[256];
+    uint8_t  weapon_group_by_mid[MAX_COMPANIES][256];
+    bool     weapon_group_index_valid;
+
     /* Sinking state — entered when hull_health hits 0; ship stays alive for SHIP_SINK_DURATION_MS */
     bool     is_sinking;
     uint32_t sink_start_ms;
@@ -150,6 +182,27 @@ typedef struct SimpleShip {
      *  0 = slot is placeable. Set when a plank is destroyed; blocks placement
      *  for PLANK_WRECKAGE_DURATION_MS. */
     uint32_t plank_wreckage_until_ms[10];
+
+    /* Crew job board (net/crew_jobs.h).  All-zero on a fresh ship = not
+     * built yet; both lists are filled on first use.
+     *   crew_needed   — weapons with MODULE_STATE_NEEDED set, in the order
+     *                   they were needed; cleared bits drop out when walked.
+     *   crew_repairs  — open repair jobs as of the sim ship's module_epoch
+     *                   and module_count; rebuilt when either moves. */
+    module_id_t   crew_needed[MAX_MODULES_PER_SHIP];
+    uint8_t       crew_needed_count;
+    bool          crew_needed_valid;
+    CrewRepairJob crew_repairs[CREW_REPAIR_JOBS_MAX];
+    uint8_t       crew_repair_count;
+    bool          crew_repairs_valid;
+    uint8_t       crew_repairs_module_count;
+    uint32_t      crew_repairs_epoch;
+
+    /* Broad phase for walker-vs-module and placement overlap checks
+     * (net/ship_module_grid.h).  All-zero = not built; built on first use.
+     * Anything that removes, replaces or moves a module must call
+     * ship_module_grid_invalidate() — appends are caught by module_count. */
+    ShipModuleGrid module_grid;
 } SimpleShip;
 
 // NPC behavior types
@@ -198,6 +251,12 @@ typedef enum {
     WORLD_NPC_STATE_REPAIRING = 3, // Arrived at a damaged module and actively repairing it
 } WorldNpcState;
 
+/* WorldNpc.nav_state */
+#define NPC_NAV_STATE_NONE    0   /* nothing planned                       */
+#define NPC_NAV_STATE_QUEUED  1   /* waiting for npc_nav (walks straight)  */
+#define NPC_NAV_STATE_READY   2   /* following nav_corner[]                */
+#define NPC_NAV_STATE_DIRECT  3   /* no grid or no path: walk straight     */
+
 typedef struct WorldNpc {
     uint16_t      id;
     char          name[32];
@@ -306,6 +365,17 @@ typedef struct WorldNpc {
     // 0 = lower deck, 1 = upper deck.  NPCs default to upper deck (1).
     // Used for deck-gated collision filtering with players.
     uint8_t       deck_level;
+
+    // ── Navigation (see net/npc_nav.h) ──────────────────────────────────
+    // Corners of the path toward target_local_x/y, in the same frame.  The
+    // path belongs to (nav_goal_x/y, nav_key); a new target or frame drops it.
+    uint8_t       nav_state;      // NPC_NAV_STATE_*
+    uint8_t       nav_count;      // corners in nav_corner[]
+    uint8_t       nav_next;       // next corner to walk to
+    bool          nav_partial;    // re-plan after the last corner
+    uint32_t      nav_key;        // frame the path was planned in
+    float         nav_goal_x, nav_goal_y;
+    float         nav_corner[NPC_NAV_MAX_CORNERS][2];
 } WorldNpc;
 // ────────────────────────────────────────────────────────────────────────────
 
@@ -519,7 +589,7 @@ typedef struct {
     PlacedStructureType   type;
     ShipConstructionPhase construction_phase; /* Shipyard-only; zero for all other types */
     /* 2-byte fields */
-    uint16_t id;                  /* unique structure ID (max MAX_PLACED_STRUCTURES=512) */
+    uint16_t id;                  /* unique structure ID among live slots (issued by structure_alloc) */
     uint32_t hp;                  /* current hit points */
     uint32_t max_hp;              /* maximum hit points */
     uint32_t target_hp;           /* permanent heal ceiling. Initialised to max_hp at placement; combat damage subtracts from both hp and target_hp so a structure can never auto-repair back to its undamaged ceiling. STRUCT_FLAG_FORT uses this as the heal cap; other types currently track it informationally (target_hp == hp in steady state). */
@@ -566,6 +636,9 @@ typedef struct {
     uint8_t  claim_state;         /* STRUCT_CLAIM_FLAG: CLAIM_FLAG_STATE_*  |  STRUCT_FLAG_FORT (claim phase): CLAIM_FLAG_STATE_CONTEST / CLAIMING_GRACE / CLAIMING */
     float    claim_grace_ms;      /* STRUCT_CLAIM_FLAG: accumulator for the 5 s init/grace before CLAIMING or REVERSING starts  |  STRUCT_FLAG_FORT (claim phase): same purpose */
     uint8_t  claim_phase;         /* STRUCT_FLAG_FORT only: FLAG_FORT_PHASE_* (claim/build/active). Unused for other types. */
+    TimerHandle claim_timer;      /* STRUCT_FLAG_FORT / STRUCT_COMPANY_FORTRESS: next build/claim step on the timer wheel (0 = none) */
+    bool     claim_timer_idle;    /* claim_timer is the slow idle poll rather than a per-tick step */
+    uint32_t claim_broadcast_acc_ms; /* ms since the last fort progress broadcast (throttle to ~1Hz) */
     /* ── Repair state (any structure with target_hp < max_hp) ──
      * Set when a player initiates a repair after paying the upfront cost.
      * Repair completes when hp reaches max_hp; cancelled (no refund) if the
@@ -574,6 +647,7 @@ typedef struct {
     float    repair_progress_ms;  /* ms elapsed since repair started; total = STRUCTURE_REPAIR_FULL_MS */
     uint32_t repair_start_hp;     /* hp at repair start (for rate computation) */
     uint32_t repair_broadcast_acc_ms; /* ms accumulated since last hp broadcast (throttle to ~1Hz) */
+    TimerHandle repair_timer;     /* next repair/construction step on the timer wheel (0 = none) */
     uint32_t last_damaged_ms;     /* get_time_ms() of most recent combat damage; 0 = never */
     bool     under_construction;  /* true while newly placed from schematic; heals 10%→100% passively */
     /* ── Per-structure dominance list ──────────────────────────────────────
@@ -595,9 +669,10 @@ typedef struct {
     char     placer_name[64];     /* display name of builder */
 } PlacedStructure;
 
-#define MAX_PLACED_STRUCTURES 512
-
-#define MAX_PLACED_STRUCTURES 512
+/* Slot capacity of placed_structures[] (see net/structure_index.h).  Fixed:
+ * callers keep PlacedStructure pointers across structure_alloc(), so the
+ * array is never moved.  A full store refuses placements ("world_full"). */
+#define MAX_PLACED_STRUCTURES 4096
 
 typedef struct {
     ItemKind item;
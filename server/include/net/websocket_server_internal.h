@@ -35,7 +35,9 @@ struct WebSocketClient {
     int fd;
     bool connected;
     bool handshake_complete;
-    uint32_t last_ping_time;
+    uint32_t last_ping_time;   /* get_time_ms() when the last WS PING went out */
+    uint32_t ping_nonce;       /* Payload of the unanswered PING; 0 once answered */
+    float    rtt_ms;           /* Smoothed PING→PONG round trip; 0 until the first PONG */
     char ip_address[16]; // INET_ADDRSTRLEN
     uint16_t port;
     uint32_t player_id;
@@ -118,6 +120,14 @@ WebSocketPlayer* find_player(uint32_t player_id);
 WebSocketPlayer* find_player_by_sim_id(entity_id sim_entity_id);
 
 void ship_local_to_world(const SimpleShip* ship, float lx, float ly, float* wx, float* wy);
+
+/* Lag compensation.  lag_comp_view_ms() is the server time whose world the
+ * player was looking at when its latest input arrived (now minus half its
+ * RTT and the client interpolation delay, capped at MAX_REWIND_TIME_MS; now
+ * for NULL).  lag_comp_ship_at() is a ship's transform at that time,
+ * interpolated from the per-tick history; false if the ship is unknown. */
+uint32_t lag_comp_view_ms(const WebSocketPlayer* player);
+bool lag_comp_ship_at(uint16_t ship_id, uint32_t view_ms, float* x, float* y, float* rot);
 void ship_world_to_local(const SimpleShip* ship, float wx, float wy, float* lx, float* ly);
 bool is_outside_deck(uint16_t ship_id, float local_x, float local_y);
 
@@ -141,6 +151,8 @@ void websocket_server_broadcast(const char* message);
 bool is_allied(uint8_t a, uint8_t b);
 void send_cannon_group_state_to_client(struct WebSocketClient* client, SimpleShip* ship);
 WeaponGroup* find_weapon_group(uint16_t ship_id, uint32_t cannon_id, uint8_t company_id);
+/** Call after editing any weapon_groups[][].weapon_ids — drops the ship's group index. */
+void weapon_groups_changed(SimpleShip* ship);
 void fire_swivel(SimpleShip* ship, ShipModule* sw, ShipModule* gsw, WebSocketPlayer* player, uint8_t ammo_type);
 void res_refund_module_demolish(WebSocketPlayer *player, ModuleTypeId type, q16_t health, q16_t max_health);
 bool craft_grant(WebSocketPlayer* player, ItemKind item, int amount);
@@ -159,5 +171,7 @@ void apply_group_gunport_state(SimpleShip* ship, WeaponGroup* group);
 
 /** True when a world NPC index is the attached target of an active grapple hook. */
 bool world_npc_is_grapple_target(int npc_index);
+/** Set mask[i] for every world NPC index held by an attached grapple; clears the rest. */
+void world_npc_grapple_mask(bool* mask, int count);
 /** True when a player is the attached target of another player's grapple hook. */
 bool player_is_grapple_target(uint32_t player_id);
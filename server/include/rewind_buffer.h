@@ -202,4 +202,64 @@ void rewind_buffer_cleanup(rewind_buffer_t* buffer, uint32_t current_tick);
  */
 bool rewind_buffer_can_rewind(const rewind_buffer_t* buffer, uint32_t target_tick);
 
+// ── Ship transform history (live lag compensation) ──────────────────────────
+//
+// The full-state entries above copy the whole simulation per tick.  The live
+// WebSocket combat path only needs where each ship was, so it records one
+// compact structure-of-arrays frame per tick (ids, x, y, rotation in client
+// px / radians) and samples any past instant by interpolating between the two
+// frames that bracket it.  Entities standing on a ship are rewound by
+// re-applying their ship-local position to the ship's past transform.
+
+#define REWIND_SHIP_MAX          200   // Matches MAX_SIMPLE_SHIPS
+#define REWIND_INTERP_DELAY_MS   100   // Client interpolation buffer floor (3 ticks at 30 Hz)
+
+/**
+ * One frame per tick; frame slots form a ring of REWIND_BUFFER_SIZE
+ */
+typedef struct {
+    uint32_t tick[REWIND_BUFFER_SIZE];
+    uint32_t timestamp_ms[REWIND_BUFFER_SIZE];
+    uint16_t count[REWIND_BUFFER_SIZE];
+    uint16_t id[REWIND_BUFFER_SIZE][REWIND_SHIP_MAX];
+    float    x[REWIND_BUFFER_SIZE][REWIND_SHIP_MAX];
+    float    y[REWIND_BUFFER_SIZE][REWIND_SHIP_MAX];
+    float    rot[REWIND_BUFFER_SIZE][REWIND_SHIP_MAX];
+    int      head;                   // Slot the next frame goes into
+    int      frames;                 // Valid frames (<= REWIND_BUFFER_SIZE)
+} rewind_ship_history_t;
+
+/**
+ * Drop every recorded frame
+ */
+void rewind_ships_init(rewind_ship_history_t* hist);
+
+/**
+ * Append this tick's ship transforms (at most REWIND_SHIP_MAX are kept),
+ * overwriting the oldest frame once the ring is full
+ */
+void rewind_ships_record(rewind_ship_history_t* hist, uint32_t tick, uint32_t timestamp_ms,
+                         int count, const uint16_t* ids, const float* xs, const float* ys,
+                         const float* rots);
+
+/**
+ * Transform of ship_id at target_ms, interpolated between the bracketing
+ * frames (rotation along the shorter arc).  Times after the newest frame
+ * give the newest transform and times before the oldest give the oldest.
+ * A ship present in only one of the two frames uses that frame.  Returns
+ * false if no recorded frame contains the ship.
+ */
+bool rewind_ships_sample(const rewind_ship_history_t* hist, uint16_t ship_id, uint32_t target_ms,
+                         float* x, float* y, float* rot);
+
+/**
+ * How far back (ms) to rewind for a client with the given smoothed RTT: the
+ * one-way delay plus the client's interpolation delay, capped at
+ * MAX_REWIND_TIME_MS
+ */
+static inline uint32_t rewind_window_ms(float rtt_ms) {
+    float w = (rtt_ms > 0.0f ? rtt_ms * 0.5f : 0.0f) + (float)REWIND_INTERP_DELAY_MS;
+    return w >= (float)MAX_REWIND_TIME_MS ? MAX_REWIND_TIME_MS : (uint32_t)w;
+}
+
 #endif // REWIND_BUFFER_H
\ No newline at end of file
@@ -0,0 +1,51 @@
+#ifndef SIM_HULL_SDF_H
+#define SIM_HULL_SDF_H
+
+#include "sim/types.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Baked ship-local signed distance fields for hull polygons.
+ *
+ * Every ship of a type shares the same hull, so hull_sdf_bake() interns the
+ * polygon by content and bakes it once: a HULL_SDF_CELL_PX grid (client px,
+ * ship-local) of signed distances to the hull edge, negative inside, plus
+ * per cell the edges that can be nearest to any point in it.  The ship keeps
+ * the shape id in struct Ship.hull_sdf.
+ *
+ * hull_sdf_sample() is the bilinear sample — within HULL_SDF_ERR_PX of the
+ * true signed distance, never above it outside the grid — and settles "far
+ * from the hull" / "deep inside" without touching an edge.  The exact
+ * queries look only at the cell's candidate edges, with the same arithmetic
+ * as a full scan, so they return the same floats.  Ships without a baked
+ * shape fall back to scanning every edge.
+ *
+ * Which edges are solid (plank overlay) stays with the caller: iterate
+ * hull_sdf_candidates() and skip breached edges.  Tick thread only. */
+
+#define HULL_SDF_CELL_PX     4.0f
+#define HULL_SDF_MARGIN_PX   96.0f   /* Grid reach beyond the hull bounding box */
+#define HULL_SDF_ERR_PX      (HULL_SDF_CELL_PX * 1.5f)
+#define HULL_SDF_MAX_SHAPES  8
+
+/** Intern ship->hull_vertices and set ship->hull_sdf (0 when it can't). */
+void hull_sdf_bake(struct Ship* ship);
+
+/** Bilinear signed distance (client px, < 0 inside) at ship-local (lx, ly). */
+float hull_sdf_sample(const struct Ship* ship, float lx, float ly);
+
+/** Exact even-odd point-in-hull test. */
+bool hull_sdf_contains(const struct Ship* ship, float lx, float ly);
+
+/** Exact distance (client px) to the nearest hull edge. */
+float hull_sdf_edge_dist(const struct Ship* ship, float lx, float ly);
+
+/** Inside the hull, or within r of its edge. */
+bool hull_sdf_within(const struct Ship* ship, float lx, float ly, float r);
+
+/** Edges that can be nearest to (lx, ly), as destination vertex indices
+ *  (edge i runs from vertex i-1 to vertex i) in ascending order.  Every
+ *  edge away from the baked grid. */
+const uint8_t* hull_sdf_candidates(const struct Ship* ship, float lx, float ly, int* out_n);
+
+#endif /* SIM_HULL_SDF_H */
@@ -2,6 +2,7 @@
 #include <math.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include "util/timer_wheel.h"
 /**
  * Island definitions — static world features.
  *
@@ -60,25 +61,31 @@ typedef struct {
     int      health;           /* Current health */
     int      max_health;       /* Max health (set at init, depends on type) */
     uint32_t respawn_at_ms;    /* Wall-clock ms when this node should respawn (0 = not depleted) */
+    TimerHandle respawn_timer; /* Pending respawn on the game timer wheel (0 = none) */
+    uint16_t grid_next;        /* Resource grid cell list (ISLAND_RES_NONE = end) */
+    uint16_t grid_prev;
+    bool     in_grid;          /* Standing: filed in the resource grid       */
 } IslandResource;
 
-/* ── Spatial grid for wood (tree) nodes ─────────────────────────────────────
- * Built once by islands_build_grid() after islands_generate_trees().
- * Used by cannonball and player-collision loops for O(1) neighbourhood
- * lookup instead of scanning all resource_count nodes.
+/* ── Resource spatial grid ─────────────────────────────────────────────────
+ * Every standing node (health > 0) of every type, filed under the cell that
+ * holds its centre in one list per type, so harvesting, collisions, cannon
+ * hits and respawn checks only look at their neighbourhood instead of all
+ * resource_count nodes.  Built by islands_build_grid(); nodes leave when
+ * depleted (island_mark_resource_dead) and come back when they respawn
+ * (island_mark_resource_alive).
  *
- * Cell size is chosen to be 2× tree grid spacing so each cell holds ≤4 trees.
- * 32×32 covers a 10240×10240 px area — larger than any current island.
+ * Cells are ISLAND_GRID_CELL_PX wide, or wider on islands whose resources
+ * would not fit 32×32 of them, so every node is always in the grid.
  */
-#define ISLAND_GRID_CELL_PX  320.0f   /* must be >= TREE_GRID_SPACING */
+#define ISLAND_GRID_CELL_PX  320.0f   /* minimum cell size; >= TREE_GRID_SPACING */
 #define ISLAND_GRID_COLS     32
 #define ISLAND_GRID_ROWS     32
-#define ISLAND_GRID_MAXPC    8        /* max wood-node indices stored per cell */
+#define ISLAND_RES_TYPES     6        /* ResType count */
+#define ISLAND_RES_NONE      0xFFFFu  /* end of a cell list */
 
-typedef struct {
-    uint16_t ri[ISLAND_GRID_MAXPC]; /* indices into IslandDef.resources[] */
-    uint8_t  count;
-} IslandGridCell;
+/** Bit for one type in an island_resources_near() type mask. */
+#define RES_MASK(t)  (1u << (t))
 
 typedef struct {
     int            id;
@@ -132,17 +139,16 @@ typedef struct {
     float svx[ISLAND_MAX_VERTS];        /* shallow water poly X offsets from centre (world px) */
     float svy[ISLAND_MAX_VERTS];        /* shallow water poly Y offsets from centre (world px) */
 
-    /* ── Wood spatial grid (built by islands_build_grid) ─────────────────
+    /* ── Resource grid (built by islands_build_grid) ──────────────────────
      * grid_ox/oy = world-px of cell [0][0] corner.
-     * Cell [row][col] covers X in [grid_ox + col*CELL, +CELL), same for Y. */
-    IslandGridCell wood_grid[ISLAND_GRID_ROWS][ISLAND_GRID_COLS];
-    float          grid_ox, grid_oy;  /* world px origin of the grid */
-    int            grid_w,  grid_h;   /* active column and row count */
-
-    /* ── Alive wood index list ────────────────────────────────────────────
-     * Shrinks as trees are destroyed; maintained by island_mark_tree_dead(). */
-    uint16_t alive_wood[ISLAND_MAX_RESOURCES];
-    int      alive_wood_count;
+     * Cell [row][col] covers X in [grid_ox + col*grid_cell, +grid_cell), same
+     * for Y.  grid_cells[row][col][type] heads that type's list. */
+    uint16_t grid_cells[ISLAND_GRID_ROWS][ISLAND_GRID_COLS][ISLAND_RES_TYPES];
+    float    grid_ox, grid_oy;  /* world px origin of the grid */
+    float    grid_cell;         /* cell size (px); 0 = no resources */
+    int      grid_w,  grid_h;   /* active column and row count */
+    float    grid_max_size;     /* largest node size on the island — turns a per-size reach into a query radius */
+    int      alive_count[ISLAND_RES_TYPES];  /* standing nodes per type */
 
     /* ── Stone biome polygons (loaded from island JSON by island_loader.c) ──
      * RES_ROCK nodes are procedurally placed inside all polygons.
@@ -294,40 +300,72 @@ static inline bool island_shallow_poly_contains(const IslandDef *isl, float px,
     return inside != 0;
 }
 
+/* ── Island rasters (island_raster.c) ───────────────────────────────────────
+ * Each island's polygons are classified once at startup onto 128-px tiles
+ * of 16-px cells: a tile or cell entirely inside or outside a layer answers
+ * a point query by lookup, and only cells an edge passes through fall back
+ * to the exact polygon test, so results match the polygon tests exactly.
+ * Tiles near the beach also keep the few beach edges that can be nearest to
+ * any point in them, for exact shoreline distance.  Without a raster (before
+ * islands_build_rasters(), or in tools that never call it) every query runs
+ * the exact test. */
+
+typedef enum {
+    ISLAND_LAYER_LAND,     /* beach polygon (vx/vy), or the bump circle   */
+    ISLAND_LAYER_GRASS,    /* grass polygon (gvx/gvy)                      */
+    ISLAND_LAYER_SHALLOW,  /* shallow-water polygon (svx/svy)              */
+    ISLAND_LAYER_STONE,    /* any stone biome polygon                      */
+    ISLAND_LAYER_METAL,    /* any metal biome polygon                      */
+    ISLAND_LAYER_COUNT
+} IslandLayer;
+
+/** Tiles within this distance of the beach keep candidate edges for
+ *  island_shore_dist(); further out it only has a lower bound. */
+#define ISLAND_SHORE_BAND_PX  512.0f
+
+/**
+ * Rasterize every island.  Call once AFTER islands_apply_rotations() (the
+ * polygons must be final) and before anything queries the layers.
+ */
+void islands_build_rasters(void);
+
+/** Is (px, py) inside `layer` of `isl`?  Same answer as the polygon test. */
+bool island_layer_contains(const IslandDef *isl, IslandLayer layer, float px, float py);
+
+/** The exact polygon test behind island_layer_contains(). */
+bool island_layer_contains_exact(const IslandDef *isl, IslandLayer layer, float px, float py);
+
+/**
+ * Island whose land holds (px, py) — poly_bound_r / bump broad phase plus
+ * the LAND layer — or NULL when the point is at sea.
+ */
+const IslandDef *island_land_at(float px, float py);
+
+/**
+ * Distance from (px, py) to the nearest beach-polygon edge, as
+ * island_poly_edge_dist().  Exact whenever the result is at most max_dist;
+ * otherwise some value above max_dist.  Polygon islands only.
+ */
+float island_shore_dist(const IslandDef *isl, float px, float py, float max_dist);
+
+/**
+ * Nearest exit from the beach polygon for a point inside it: the unit
+ * direction (*out_nx, *out_ny) from (px, py) to the nearest point on any
+ * beach edge, and the distance to it in *out_depth (client px).  Pushing the
+ * point out by depth along the normal puts it on the shoreline.  Only the
+ * edges kept for the point's raster tile are tested; deep inland, or without
+ * a raster, every edge is.  Returns false for islands without a polygon.
+ */
+bool island_poly_nearest_exit(const IslandDef *isl, float px, float py,
+                              float *out_nx, float *out_ny, float *out_depth);
+
 /**
  * Returns true if (px, py) is in the shallow-water zone of the given island:
  *   - outside the island's beach boundary, AND
  *   - within (island_radius * SHALLOW_WATER_SCALE) of that boundary.
  * px, py are world coordinates in CLIENT pixels.
  */
-static inline bool island_in_shallow_water(const IslandDef *isl, float px, float py) {
-    float dx = px - isl->x, dy = py - isl->y;
-    float dist_sq = dx * dx + dy * dy;
-
-    if (isl->vertex_count > 0) {
-        if (isl->shallow_vertex_count > 0) {
-            /* Explicit shallow polygon — compute its broad-phase bound */
-            float shallow_bound_r = 0.0f;
-            for (int vi = 0; vi < isl->shallow_vertex_count; vi++) {
-                float r = sqrtf(isl->svx[vi]*isl->svx[vi] + isl->svy[vi]*isl->svy[vi]);
-                if (r > shallow_bound_r) shallow_bound_r = r;
-            }
-            if (dist_sq > shallow_bound_r * shallow_bound_r) return false;
-            if (island_poly_contains(isl, px, py)) return false;
-            return island_shallow_poly_contains(isl, px, py);
-        }
-        /* No explicit shallow polygon — no shallow zone for this island */
-        return false;
-    } else {
-        float shallow_depth = isl->beach_radius_px * SHALLOW_WATER_SCALE;
-        float broad_outer = isl->beach_radius_px + isl->beach_max_bump + shallow_depth;
-        if (dist_sq > broad_outer * broad_outer) return false;
-        float angle   = atan2f(dy, dx);
-        float beach_r = island_boundary_r(isl->beach_radius_px, isl->beach_bumps, angle);
-        float dist    = sqrtf(dist_sq);
-        return (dist > beach_r) && (dist < beach_r + shallow_depth);
-    }
-}
+bool island_in_shallow_water(const IslandDef *isl, float px, float py);
 
 /**
  * Returns a value in [0, 1] representing how deep inside the shallow-water
@@ -337,42 +375,7 @@ static inline bool island_in_shallow_water(const IslandDef *isl, float px, float
  * Returns 0.0 when outside the shallow zone or inside the island.
  * For polygon islands the gradient follows the polygon edge (not a circle).
  */
-static inline float island_shallow_water_depth(const IslandDef *isl, float px, float py) {
-    float dx = px - isl->x, dy = py - isl->y;
-    float dist_sq = dx * dx + dy * dy;
-
-    if (isl->vertex_count > 0) {
-        if (isl->shallow_vertex_count > 0) {
-            /* Explicit shallow polygon broad-phase */
-            float shallow_bound_r = 0.0f;
-            for (int vi = 0; vi < isl->shallow_vertex_count; vi++) {
-                float r = sqrtf(isl->svx[vi]*isl->svx[vi] + isl->svy[vi]*isl->svy[vi]);
-                if (r > shallow_bound_r) shallow_bound_r = r;
-            }
-            if (dist_sq > shallow_bound_r * shallow_bound_r) return 0.0f;
-            if (island_poly_contains(isl, px, py)) return 0.0f;
-            if (!island_shallow_poly_contains(isl, px, py)) return 0.0f;
-            /* Gradient: 1.0 at sand edge, 0.0 at shallow boundary */
-            float edge_dist = island_poly_edge_dist(isl, px, py);
-            float shallow_depth = shallow_bound_r - isl->poly_bound_r;
-            if (shallow_depth <= 0.0f || edge_dist >= shallow_depth) return 0.0f;
-            float t = 1.0f - edge_dist / shallow_depth;
-            return (t > 1.0f) ? 1.0f : t;
-        }
-        /* No explicit shallow polygon — no shallow zone for this island */
-        return 0.0f;
-    } else {
-        float shallow_depth = isl->beach_radius_px * SHALLOW_WATER_SCALE;
-        float broad_outer = isl->beach_radius_px + isl->beach_max_bump + shallow_depth;
-        if (dist_sq > broad_outer * broad_outer) return 0.0f;
-        float angle   = atan2f(dy, dx);
-        float beach_r = island_boundary_r(isl->beach_radius_px, isl->beach_bumps, angle);
-        float dist    = sqrtf(dist_sq);
-        if (dist <= beach_r || dist >= beach_r + shallow_depth) return 0.0f;
-        float t = 1.0f - (dist - beach_r) / shallow_depth;
-        return (t < 0.0f) ? 0.0f : (t > 1.0f ? 1.0f : t);
-    }
-}
+float island_shallow_water_depth(const IslandDef *isl, float px, float py);
 
 /**
  * Load island polygon data (sand/grass/shallow vertices, centre) from JSON
@@ -407,35 +410,40 @@ void islands_generate_trees(void);
 void islands_generate_zone_resources(void);
 
 /**
- * Build the spatial wood grid and alive_wood list for all islands.
- * Must be called once after islands_generate_trees() completes.
+ * Build the resource grid for all islands from the current resource
+ * positions and health.  Call once after islands_generate_trees(), and
+ * again whenever resource positions change.
  */
 void islands_build_grid(void);
 
 /**
- * Remove a wood node from the alive_wood list and from the spatial grid.
- * Call whenever a tree's health reaches zero.
+ * Take a depleted node out of the resource grid.  Call whenever a node's
+ * health reaches zero.  No-op if it is already out.
  * @param isl  The island that owns the resource.
  * @param ri   Index into isl->resources[].
  */
-void island_mark_tree_dead(IslandDef *isl, int ri);
+void island_mark_resource_dead(IslandDef *isl, int ri);
 
 /**
- * Restores a wood/tree resource into the alive list and spatial grid.
- * Call when a depleted tree respawns.
+ * Put a node back into the resource grid.  Call when a depleted node
+ * respawns.  No-op if it is already in.
  */
-void island_mark_tree_alive(IslandDef *isl, int ri);
+void island_mark_resource_alive(IslandDef *isl, int ri);
+
+/** Result list for island_resources_near().  Give each call site its own
+ *  (usually static) so nested queries don't overwrite each other. */
+typedef struct {
+    uint16_t *ri;
+    uint32_t  count;
+    uint32_t  cap;
+} IslandResourceNear;
 
 /**
- * Returns true if the resource at (rx, ry) is allowed to respawn.
- * A resource is suppressed when any active structure lies within
- * RESPAWN_SUPPRESS_R world-pixels of it — e.g. a player has built over
- * the cleared stump.
- *
- * structs      : pointer to the PlacedStructure array (websocket_server.c)
- * struct_count : number of entries (active + inactive)
+ * Fill `out` with the resources[] indices, in index order, of standing
+ * nodes on `isl` whose type is in `type_mask` (0 = any) and whose cell
+ * overlaps the square of half-side r around (wx,wy) — every centre within
+ * r on both axes, and then some: callers still do the exact test.
+ * Returns out->count.
  */
-#include "net/websocket_server.h"  /* PlacedStructure */
-bool island_resource_can_respawn(float rx, float ry,
-                                 const PlacedStructure *structs,
-                                 uint32_t struct_count);
+uint32_t island_resources_near(IslandResourceNear *out, const IslandDef *isl,
+                               float wx, float wy, float r, uint32_t type_mask);
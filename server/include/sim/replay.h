@@ -0,0 +1,120 @@
+#ifndef SIM_REPLAY_H
+#define SIM_REPLAY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "types.h"
+
+/* Deterministic replay recorder and re-simulator.
+ *
+ * A recording is a header, a full snapshot of every replayed region (the
+ * struct Sim and the island presets the sim collides against, each island's
+ * visual preset stored by name), then one block of records per tick:
+ *
+ *   TICK  [INPUT | WS]*  DELTA*  STEP  [HASH]  TICK_END
+ *
+ * INPUT is every InputCmd handed to sim_process_input (UDP CmdPackets are
+ * converted there).  The recorder applies each one to a shadow copy of the
+ * sim as well, so DELTA holds only what the WebSocket/admin layers wrote
+ * into the sim directly: an XOR against the shadow, run-length coded in
+ * 8-byte words.  Replaying applies the inputs, XORs the delta, and steps;
+ * HASH checkpoints compare sim_state_hash() against the live server's.
+ *
+ * WS records keep the gameplay JSON each player sent that tick (handshakes,
+ * which carry tokens, are left out).  They are not re-executed — their
+ * effect on the sim is already in DELTA — but pirate-replay can list them
+ * next to a slow tick.
+ *
+ * The file stores raw structs, so it only replays on a build with the same
+ * struct layouts; the header carries the sizes and replay refuses a
+ * mismatch. */
+
+#define REPLAY_MAGIC              "PRPL"
+#define REPLAY_VERSION            1
+#define REPLAY_CHECKPOINT_TICKS   10
+#define REPLAY_MAX_BYTES          (2048ull * 1024 * 1024)   /* Recording stops here */
+#define REPLAY_DIR                "data/replays"
+
+typedef enum {
+    REPLAY_REC_SNAPSHOT = 1,   /* u8 region, encoded region vs zeroes      */
+    REPLAY_REC_TICK,           /* u32 tick                                  */
+    REPLAY_REC_INPUT,          /* struct InputCmd                           */
+    REPLAY_REC_WS,             /* u32 player_id, message bytes              */
+    REPLAY_REC_DELTA,          /* u8 region, encoded region vs shadow       */
+    REPLAY_REC_STEP,           /* empty: run sim_step + sim_wrap_world      */
+    REPLAY_REC_HASH,           /* u64 sim_state_hash after the step         */
+    REPLAY_REC_TICK_END        /* u32 live tick duration in µs              */
+} replay_record_t;
+
+typedef enum {
+    REPLAY_REGION_SIM = 0,
+    REPLAY_REGION_ISLANDS,
+    REPLAY_REGION_COUNT
+} replay_region_t;
+
+struct ReplayFileHeader {
+    char     magic[4];
+    uint32_t version;
+    uint32_t sim_size;
+    uint32_t islands_size;
+    uint32_t input_size;
+    int32_t  dt_q16;
+    uint32_t checkpoint_ticks;
+    uint32_t start_tick;
+    uint64_t start_unix_ms;
+};
+
+struct ReplayRecorderStatus {
+    bool     recording;
+    char     path[256];
+    uint32_t start_tick;
+    uint32_t ticks;
+    uint64_t bytes;
+};
+
+// Recording (tick thread, except where noted)
+/* Any thread.  Takes effect at the next replay_tick_begin().  path == NULL
+ * writes REPLAY_DIR/replay_<tick>.bin. */
+void replay_request_start(const char* path);
+void replay_request_stop(void);
+bool replay_recorder_status(struct ReplayRecorderStatus* out);   /* Any thread */
+void replay_recorder_shutdown(void);    /* Flush and close now */
+
+void replay_tick_begin(struct Sim* sim, uint32_t tick);
+void replay_record_input(const struct Sim* sim, const struct InputCmd* cmd);
+void replay_record_ws(uint32_t player_id, const char* msg, size_t len);
+void replay_record_pre_step(const struct Sim* sim);
+void replay_record_post_step(const struct Sim* sim);
+void replay_tick_end(uint32_t tick_duration_us);
+
+// Playback
+struct ReplayStats {
+    uint32_t first_tick;
+    uint32_t last_tick;
+    uint32_t ticks;
+    uint32_t inputs;
+    uint32_t ws_messages;
+    uint32_t checkpoints;
+    uint32_t mismatches;
+    uint32_t first_mismatch_tick;
+    bool     truncated;        /* File ended mid-record (server killed) */
+    uint64_t replay_us;        /* Wall time spent re-simulating         */
+};
+
+struct ReplayCallbacks {
+    /* After each tick; the profiler's last tick is this tick's breakdown */
+    void (*on_tick)(void* user, uint32_t tick, uint32_t live_us, uint32_t replay_us);
+    void (*on_ws)(void* user, uint32_t tick, uint32_t player_id, const char* msg, size_t len);
+    void (*on_mismatch)(void* user, uint32_t tick, uint64_t expected, uint64_t actual);
+    void* user;
+};
+
+/* Re-simulates `path` into `sim` (overwritten by the snapshot) at full
+ * speed, each tick inside prof_tick_begin/end.  Returns 0 when the file
+ * was read (check stats->mismatches), -1 when it could not be opened or
+ * does not match this build. */
+int replay_play(const char* path, struct Sim* sim, const struct ReplayCallbacks* cb,
+                struct ReplayStats* stats);
+
+#endif /* SIM_REPLAY_H */
@@ -0,0 +1,106 @@
+#ifndef SIM_SHIP_FLOODING_H
+#define SIM_SHIP_FLOODING_H
+
+#include "sim/types.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Per-ship flooding model.
+ *
+ * Water aboard is the complement of hull integrity: fill = 1 - hull_health
+ * / 100.  The sim owns hull_health and drains it each step at
+ * ship_flood_drain_rate() (scaled by sturdiness); crews bail it back with
+ * buckets.  This module keeps what bailing needs per ship in dense arrays,
+ * one row per sim ship slot, refreshed once per tick by
+ * ship_flooding_update():
+ *   - gather: one module scan per ship collecting the hull openings (missing
+ *     planks, open and shut gunports), the bilge well, and the plank counts
+ *     behind ingress;
+ *   - update: one branch-free pass over every row computing fill, ingress
+ *     and recovery rates, time to sink, and which compartments hold water a
+ *     bucket can scoop.
+ * Bucket players and NPC bailers read the rows instead of rescanning the
+ * ship's modules per actor.  Code that changes hull_health or opens a
+ * gunport mid-tick calls ship_flooding_touch() so later readers in the
+ * same tick see it.
+ *
+ * Gunports sit above the waterline: open ones are places to pour water
+ * out, not ingress.  Ghost ships and scaffolded ships do not flood.  Tick
+ * thread only. */
+
+#define FLOOD_MAX_SHIPS      MAX_SHIPS
+#define FLOOD_MAX_OPENINGS   32      /* 10 plank slots + 12 gunport snaps, with room */
+#define FLOOD_SCOOP_GRACE    0.03f   /* Fill tolerance while the bucket minigame runs */
+
+/* Water must reach a compartment's line (fraction of full flood) to scoop there */
+typedef enum {
+    FLOOD_BILGE,                     /* Lower-deck well:  1%              */
+    FLOOD_LOWER,                     /* Lower deck:      25%              */
+    FLOOD_UPPER,                     /* Upper deck:      75%              */
+    FLOOD_COMPARTMENTS
+} FloodCompartment;
+
+extern const float FLOOD_COMPARTMENT_LINE[FLOOD_COMPARTMENTS];
+
+typedef enum {
+    FLOOD_OPENING_PLANK        = 1u << 0,   /* Destroyed hull plank        */
+    FLOOD_OPENING_GUNPORT_OPEN = 1u << 1,
+    FLOOD_OPENING_GUNPORT_SHUT = 1u << 2,
+} FloodOpeningKind;
+
+typedef struct {
+    float    x, y;                   /* Ship-local client px; gunports at their snap point */
+    uint16_t module_id;
+    uint8_t  kind;                   /* FloodOpeningKind */
+} FloodOpening;
+
+typedef struct {
+    float   fill;                    /* 0 dry .. 1 sunk                       */
+    float   ingress;                 /* Fill per second from plank damage     */
+    float   recovery;                /* Fill per second the sealed hull sheds */
+    float   secs_to_sink;            /* At the current net rate; INFINITY when not sinking */
+    uint8_t scoop_mask;              /* Bit per FloodCompartment with scoopable water */
+    uint8_t missing_planks;
+    uint8_t leaking_planks;          /* Under 30% health */
+    uint8_t open_gunports;
+} ShipFloodState;
+
+/** Hull drain in HP/s before sturdiness — the sim's sinking rate.  Missing
+ *  planks double it each; leaking planks add half a missing plank's worth. */
+static inline float ship_flood_drain_rate(int missing, int leaking) {
+    float rate = 0.0f;
+    if (missing > 0) {
+        int shift = missing - 1;
+        if (shift > 15) shift = 15;
+        rate += (1.0f / 1.2f) * (float)(1 << shift);
+    }
+    rate += 0.5f * (1.0f / 1.2f) * (float)leaking;
+    return rate;
+}
+
+/** Rebuild every row from ships[0 .. count-1] (the sim's ship array). */
+void ship_flooding_update(const struct Ship* ships, uint32_t count);
+
+/** Re-gather ship's row after a mid-tick hull_health or gunport change. */
+void ship_flooding_touch(const struct Ship* ship);
+
+/** The ship's row (gathered on demand if this tick's update missed it). */
+void ship_flood_state(const struct Ship* ship, ShipFloodState* out);
+
+float ship_flood_fill(const struct Ship* ship);
+
+/** Water in compartment c is deep enough to scoop (within FLOOD_SCOOP_GRACE). */
+bool ship_flood_scoopable(const struct Ship* ship, FloodCompartment c);
+
+/** First lower-deck bilge well, ship-local client px. */
+bool ship_flood_well(const struct Ship* ship, float* out_x, float* out_y);
+
+/** Every opening, in module order; filter on .kind. */
+const FloodOpening* ship_flood_openings(const struct Ship* ship, int* out_n);
+
+/** First opening of the given kinds within reach of (lx, ly); its module id
+ *  goes to out_id when non-NULL. */
+bool ship_flood_near_opening(const struct Ship* ship, float lx, float ly, float reach,
+                             uint8_t kinds, uint16_t* out_id);
+
+#endif /* SIM_SHIP_FLOODING_H */
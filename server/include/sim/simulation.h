@@ -15,6 +15,8 @@ void sim_cleanup(struct Sim* sim);
 
 // Main simulation step (deterministic)
 void sim_step(struct Sim* sim, q16_t dt);
+// Toroidal map wrap the server applies after every step
+void sim_wrap_world(struct Sim* sim);
 
 // State management
 uint64_t sim_state_hash(const struct Sim* sim);
@@ -72,4 +74,9 @@ struct ContactEntry* contact_cache_find(struct ContactCache* cc, entity_id a, en
 struct ContactEntry* contact_cache_upsert(struct ContactCache* cc, entity_id a, entity_id b);
 void contact_cache_age(struct ContactCache* cc, uint32_t current_tick);
 
+// Rope constraints (solved in sim_handle_collisions)
+void sim_ropes_clear(struct Sim* sim);
+bool sim_rope_add(struct Sim* sim, const struct RopeConstraint* rope);
+void sim_solve_ropes(struct Sim* sim);
+
 #endif /* SIM_SIMULATION_H */
\ No newline at end of file
@@ -83,11 +83,13 @@ struct Ship {
     // Hull collision shape (legacy, for compatibility)
     Vec2Q16 hull_vertices[64];
     uint8_t hull_vertex_count;
+    uint8_t hull_sdf;        // hull_sdf_bake() shape (0 = none: exact edge scans)
     q16_t bounding_radius;
 
     // Ship modules (cannons, masts, seats, etc.)
     ShipModule modules[MAX_MODULES_PER_SHIP];
     uint8_t module_count;
+    uint32_t module_epoch;  // Bumped whenever a module takes damage (crew job board)
 
     // Ship control state
     uint8_t desired_sail_openness;
@@ -239,6 +241,33 @@ struct ContactCache {
     struct ContactEntry entries[CONTACT_CACHE_SIZE];
 };
 
+/* ── Rope constraints (grapples) ────────────────────────────────────────────
+ *
+ * One-sided distance constraints: the body (a player in the water or on an
+ * island) may not get farther than `length` from its anchor.  The owner of a
+ * rope re-declares it every tick before sim_step (sim_ropes_clear +
+ * sim_rope_add); the step solves every rope together after integration, so
+ * ship anchors are evaluated where the ship actually ended up.
+ *
+ * Anchors: a ship-local point (cached once when the hook bites), another
+ * player's position, or a fixed world point.  Anchors are never moved by
+ * the rope.                                                                 */
+
+#define MAX_ROPES          128
+#define ROPE_ITERATIONS    4
+
+#define ROPE_ANCHOR_WORLD  0   /* anchor_pos is a world point           */
+#define ROPE_ANCHOR_SHIP   1   /* anchor_pos is ship-local on anchor_id */
+#define ROPE_ANCHOR_PLAYER 2   /* anchor is player anchor_id's position */
+
+struct RopeConstraint {
+    entity_id body;          /* Player pulled by the rope                  */
+    entity_id anchor_id;     /* Ship or player id (SHIP / PLAYER anchors)  */
+    uint8_t   anchor_kind;   /* ROPE_ANCHOR_*                              */
+    Vec2Q16   anchor_pos;    /* Ship-local or world attachment point       */
+    q16_t     length;        /* Max body-anchor distance                   */
+};
+
 // Complete simulation state
 struct Sim {
     uint32_t tick;               // Current simulation tick
@@ -254,6 +283,9 @@ struct Sim {
     uint16_t ship_count;
     uint16_t player_count;
     uint16_t projectile_count;
+
+    // Next entity id to hand out (0 = not yet allocated; starts at 1)
+    entity_id next_entity_id;
     
     // Spatial acceleration structures
     struct SpatialCell spatial_hash[SPATIAL_HASH_SIZE * SPATIAL_HASH_SIZE];
@@ -273,6 +305,10 @@ struct Sim {
 
     // Contact cache for warm-starting collision solvers
     struct ContactCache contact_cache;
+
+    // Rope constraints declared for the next step (see RopeConstraint)
+    struct RopeConstraint ropes[MAX_ROPES];
+    uint16_t              rope_count;
 };
 
 // Simulation configuration
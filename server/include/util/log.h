@@ -2,6 +2,8 @@
 #define UTIL_LOG_H
 
 #include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
 
 typedef enum {
     LOG_LEVEL_DEBUG = 0,
@@ -10,14 +12,53 @@ typedef enum {
     LOG_LEVEL_ERROR = 3
 } log_level_t;
 
+/* Async backend configuration.
+ * Records are captured into a lock-free MPSC ring (format pointer + copied
+ * arguments) and formatted/written by a background drain thread, so the
+ * simulation thread never touches stdio.  When the ring is full the record
+ * is dropped and counted rather than blocking the producer. */
+#define LOG_RING_CAPACITY      4096   /* Must be a power of two */
+#define LOG_RECORD_MAX_ARGS    16
+#define LOG_RECORD_STR_BYTES   256    /* Inline storage for %s arguments */
+
+/* Per-callsite rate limit while the tick clock is running (see log_tick).
+ * Errors and startup/shutdown logging before the first tick are never
+ * limited. */
+#define LOG_SITE_MAX_PER_SEC   20
+
+/* Per-callsite state — one static instance per log_* macro expansion. */
+struct LogSite {
+    uint32_t window_sec;   /* Cached second the counters below belong to */
+    uint32_t emitted;      /* Records emitted in window_sec               */
+    uint32_t suppressed;   /* Records suppressed since the last emit      */
+};
+
+struct LogStats {
+    uint64_t enqueued;     /* Records accepted into the ring              */
+    uint64_t written;      /* Records formatted and written by the drain  */
+    uint64_t dropped;      /* Records lost because the ring was full      */
+    uint64_t suppressed;   /* Records rejected by per-callsite limiting   */
+    uint32_t queued;       /* Records currently waiting in the ring       */
+};
+
 // Logging functions
-void log_init(log_level_t min_level);
-void log_message(log_level_t level, const char* file, int line, const char* fmt, ...);
+void log_init(log_level_t min_level);      /* Sets level and starts the drain thread */
+void log_shutdown(void);                   /* Drains, joins; later logs are synchronous */
+void log_set_output(FILE* out);            /* Default stdout */
+void log_tick(void);                       /* Refresh cached timestamp; call once per tick */
+void log_flush(void);                      /* Block until every queued record is written */
+void log_get_stats(struct LogStats* out);
+void log_message(log_level_t level, struct LogSite* site, const char* file, int line,
+                 const char* fmt, ...);
 
-// Convenience macros
-#define log_debug(fmt, ...) log_message(LOG_LEVEL_DEBUG, __FILE__, __LINE__, fmt, ##__VA_ARGS__)
-#define log_info(fmt, ...)  log_message(LOG_LEVEL_INFO,  __FILE__, __LINE__, fmt, ##__VA_ARGS__)
-#define log_warn(fmt, ...)  log_message(LOG_LEVEL_WARN,  __FILE__, __LINE__, fmt, ##__VA_ARGS__)
-#define log_error(fmt, ...) log_message(LOG_LEVEL_ERROR, __FILE__, __LINE__, fmt, ##__VA_ARGS__)
+// Convenience macros — fmt must be a string literal (records keep the pointer)
+#define LOG_AT_(level, fmt, ...) do { \
+        static struct LogSite _log_site; \
+        log_message(level, &_log_site, __FILE__, __LINE__, "" fmt, ##__VA_ARGS__); \
+    } while (0)
+#define log_debug(fmt, ...) LOG_AT_(LOG_LEVEL_DEBUG, fmt, ##__VA_ARGS__)
+#define log_info(fmt, ...)  LOG_AT_(LOG_LEVEL_INFO,  fmt, ##__VA_ARGS__)
+#define log_warn(fmt, ...)  LOG_AT_(LOG_LEVEL_WARN,  fmt, ##__VA_ARGS__)
+#define log_error(fmt, ...) LOG_AT_(LOG_LEVEL_ERROR, fmt, ##__VA_ARGS__)
 
-#endif /* UTIL_LOG_H */
\ No newline at end of file
+#endif /* UTIL_LOG_H */
@@ -0,0 +1,48 @@
+#ifndef UTIL_METRICS_H
+#define UTIL_METRICS_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+/* Metrics registry exported as OpenMetrics text (GET /metrics on the admin port).
+ *
+ * Counters and histograms live in per-thread shards: the recording thread
+ * does a relaxed load + store on its own cell, with no lock and no shared
+ * cache line, and a scrape sums the shards.  Gauges are a single relaxed
+ * store.  Threads beyond METRICS_SHARDS - 1 share the last shard and fall
+ * back to atomic adds.
+ *
+ * Register once at init and keep the returned id; registration takes a lock.
+ * Names, help text and label strings must be string literals (or otherwise
+ * outlive the registry).  `labels` is the inside of the braces, e.g.
+ * "stream=\"game_state\"", or NULL. */
+
+#define METRICS_MAX           128
+#define METRICS_MAX_CELLS     1024
+#define METRICS_SHARDS        16
+#define METRICS_MAX_BUCKETS   16
+#define METRICS_MAX_COLLECTORS 8
+
+#define METRICS_CONTENT_TYPE  "application/openmetrics-text; version=1.0.0; charset=utf-8"
+
+typedef uint16_t metric_id;    /* 0 = registration failed; recording is a no-op */
+
+metric_id metrics_counter(const char* name, const char* help, const char* labels);
+metric_id metrics_gauge(const char* name, const char* help, const char* labels);
+/* Bucket upper bounds are in recorded units (ascending); `scale` converts
+ * them and the sum to exported units, e.g. 1e-6 for µs → seconds. */
+metric_id metrics_histogram(const char* name, const char* help, const char* labels,
+                            const uint64_t* bounds, int bound_count, double scale);
+
+void metrics_inc(metric_id id, uint64_t n);
+void metrics_gauge_set(metric_id id, int64_t value);
+void metrics_observe(metric_id id, uint64_t value);
+
+/* Extra families produced at scrape time (e.g. profiler summaries).  Called
+ * on the scraping thread, after the registry and before "# EOF". */
+typedef void (*metrics_collector_fn)(FILE* out);
+void metrics_register_collector(metrics_collector_fn fn);
+
+int metrics_write_openmetrics(FILE* out);
+
+#endif /* UTIL_METRICS_H */
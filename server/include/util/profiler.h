@@ -0,0 +1,110 @@
+#ifndef UTIL_PROFILER_H
+#define UTIL_PROFILER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+/* Per-tick phase profiler.
+ *
+ * Named scopes (PROF_BEGIN/PROF_END) nest inside the tick opened by
+ * prof_tick_begin().  Every closed scope is appended to the current tick's
+ * record in a flight-recorder ring holding the last PROF_FLIGHT_TICKS ticks;
+ * at prof_tick_end() the record is published and each scope's duration is
+ * folded into a log-linear (HDR-style) histogram for percentile queries.
+ *
+ * Recording is tick-thread only and costs two clock reads per scope.  Scopes
+ * hit outside a tick (tests, tools, other threads) are ignored.  Readers on
+ * other threads (admin API, SIGUSR2 dump) copy published data under a lock
+ * that the tick thread takes once per tick. */
+
+#define PROF_MAX_SCOPES           64
+#define PROF_MAX_DEPTH            8
+#define PROF_MAX_EVENTS_PER_TICK  256
+#define PROF_FLIGHT_TICKS         256    /* ~8.5 s at 30 Hz */
+
+/* Histogram layout: values below 2^PROF_HIST_SUB_BITS µs get exact buckets,
+ * larger values keep PROF_HIST_SUB_BITS significant bits (~3% error). */
+#define PROF_HIST_SUB_BITS        5
+#define PROF_HIST_SUB             (1u << PROF_HIST_SUB_BITS)
+#define PROF_HIST_BUCKETS         (PROF_HIST_SUB + 27u * PROF_HIST_SUB)
+
+#define PROF_DUMP_DIR             "data/profiles"
+
+struct ProfEvent {
+    uint16_t scope;        /* Scope id (index into prof_scope_name)        */
+    uint8_t  depth;        /* 0 = the tick itself                          */
+    uint8_t  _pad;
+    uint32_t start_us;     /* Offset from the tick's start                 */
+    uint32_t dur_us;
+};
+
+struct ProfTick {
+    uint32_t tick;
+    uint64_t start_us;     /* get_time_us() at prof_tick_begin             */
+    uint32_t dur_us;
+    uint16_t event_count;
+    uint16_t dropped;      /* Scopes lost to PROF_MAX_EVENTS_PER_TICK      */
+    struct ProfEvent events[PROF_MAX_EVENTS_PER_TICK];
+};
+
+struct ProfHistogram {
+    uint64_t count;
+    uint64_t sum_us;
+    uint32_t max_us;
+    uint32_t buckets[PROF_HIST_BUCKETS];
+};
+
+struct ProfScopeStats {
+    const char* name;
+    uint64_t count;
+    uint64_t sum_us;
+    uint32_t mean_us;
+    uint32_t p50_us;
+    uint32_t p99_us;
+    uint32_t p999_us;
+    uint32_t max_us;
+};
+
+// Lifecycle
+void prof_init(void);
+void prof_reset(void);                       /* Clears histograms and the flight recorder */
+
+// Recording (tick thread only)
+uint16_t prof_register(const char* name);    /* Idempotent; name must outlive the profiler */
+void prof_tick_begin(uint32_t tick);
+void prof_tick_end(void);                    /* Closes any scope still open */
+void prof_push(uint16_t scope);
+void prof_pop(void);
+
+#define PROF_BEGIN(name) do { \
+        static uint16_t _prof_id; \
+        if (!_prof_id) _prof_id = prof_register(name); \
+        prof_push(_prof_id); \
+    } while (0)
+#define PROF_END() prof_pop()
+
+// Queries (any thread)
+const char* prof_scope_name(uint16_t scope);
+int  prof_scope_stats(struct ProfScopeStats* out, int max);   /* Returns scopes written */
+bool prof_last_tick(struct ProfTick* out);
+/* "net=120 wstick=3400 ..." for the depth-1 scopes of the last published tick */
+size_t prof_format_last_tick(char* buf, size_t cap);
+
+// Histogram helpers (exposed for tests)
+void     prof_hist_record(struct ProfHistogram* h, uint32_t value_us);
+uint32_t prof_hist_percentile(const struct ProfHistogram* h, double pct);
+
+// Dumps (any thread)
+int prof_write_json(FILE* out, int max_ticks);   /* Stats + last max_ticks breakdowns */
+int prof_write_chrome_trace(FILE* out);          /* chrome://tracing / Perfetto JSON  */
+void prof_write_openmetrics(FILE* out);          /* Summary family for GET /metrics   */
+
+/* SIGUSR2: the handler only sets a flag; the tick loop calls
+ * prof_service_dump_request() outside the measured tick to write
+ * PROF_DUMP_DIR/profile_<tick>.json and .trace.json. */
+void prof_request_dump(void);
+void prof_service_dump_request(void);
+
+#endif /* UTIL_PROFILER_H */
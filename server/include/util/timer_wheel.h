@@ -0,0 +1,78 @@
+#ifndef UTIL_TIMER_WHEEL_H
+#define UTIL_TIMER_WHEEL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Hierarchical timing wheel for game-side deadlines.
+ *
+ * Systems with a few entries waiting on a clock (structure repair, fort
+ * build/claim timers, resource respawns, tombstone and dropped-item expiry)
+ * schedule a timer per entry instead of walking their whole array every
+ * tick.  timer_wheel_advance() is called once per server tick and fires only
+ * the timers that came due; an entry with nothing pending holds no timer and
+ * costs nothing.
+ *
+ * TIMER_WHEEL_LEVELS wheels of TIMER_WHEEL_SLOTS slots each, the first at
+ * TIMER_WHEEL_TICK_MS resolution and each next one TIMER_WHEEL_SLOTS times
+ * coarser (horizon ≈ 74 h); timers cascade down a level as their slot comes
+ * round.  Schedule and cancel are O(1) (schedule amortised: the timer pool
+ * doubles when it runs out).  Timers never fire early and at most
+ * one wheel tick late; a timer scheduled from a handler never fires within
+ * the same advance, so "delay 0" means "next tick".
+ *
+ * Each system registers a kind once (its handler and the metric labels for
+ * its pending/fired counts) and passes a 32-bit argument per timer —
+ * usually a generation-checked handle, so a timer left behind by a freed
+ * entry fires harmlessly.  Tick thread only. */
+
+#define TIMER_WHEEL_TICK_MS     16u
+#define TIMER_WHEEL_SLOT_BITS   6
+#define TIMER_WHEEL_SLOTS       (1u << TIMER_WHEEL_SLOT_BITS)
+#define TIMER_WHEEL_LEVELS      4
+#define TIMER_WHEEL_INIT_TIMERS 4096     /* Pool grows by doubling from here  */
+#define TIMER_WHEEL_HANDLE_BITS 20       /* Pool index bits of a TimerHandle  */
+#define TIMER_WHEEL_MAX_TIMERS  (1u << TIMER_WHEEL_HANDLE_BITS)
+#define TIMER_WHEEL_MAX_KINDS   8
+
+/** (generation << 20) | slot.  Never 0; stale once the timer fires or is
+ *  cancelled. */
+typedef uint32_t TimerHandle;
+
+/** Registered timer kind; 0 = registration failed. */
+typedef uint8_t TimerKind;
+
+/** `elapsed_ms` is the time since the timer was scheduled. */
+typedef void (*TimerFn)(uint32_t arg, uint32_t now_ms, uint32_t elapsed_ms);
+
+/** Drop every timer and restart the wheel clock at now_ms.  Registered kinds
+ *  are kept.  Without a call the clock starts at the first schedule. */
+void timer_wheel_init(uint32_t now_ms);
+
+/** Register a kind.  `metric_labels` is the inside of the braces for its
+ *  pirate_timers_* series (string literal), e.g. "kind=\"tombstone\"". */
+TimerKind timer_wheel_kind(const char* metric_labels, TimerFn fn);
+
+/** Fire `kind`'s handler with `arg` once delay_ms has passed since now_ms.
+ *  The timer pool grows as needed; returns 0 only if it cannot (out of
+ *  memory or TIMER_WHEEL_MAX_TIMERS pending), which is counted in the
+ *  kind's pirate_timers_dropped series. */
+TimerHandle timer_wheel_schedule(TimerKind kind, uint32_t arg,
+                                 uint32_t now_ms, uint32_t delay_ms);
+
+/** Cancel a pending timer.  False (and no-op) for 0 or a stale handle. */
+bool timer_wheel_cancel(TimerHandle h);
+
+/** True while `h` has not fired or been cancelled. */
+bool timer_wheel_pending(TimerHandle h);
+
+/** Fire every timer due at now_ms.  Returns how many fired. */
+uint32_t timer_wheel_advance(uint32_t now_ms);
+
+/** Pending timers of `kind`, or of all kinds for 0. */
+uint32_t timer_wheel_pending_count(TimerKind kind);
+
+/** Timers of `kind` (all kinds for 0) that timer_wheel_schedule() refused. */
+uint64_t timer_wheel_dropped_count(TimerKind kind);
+
+#endif /* UTIL_TIMER_WHEEL_H */
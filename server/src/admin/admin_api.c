@@ -1,12 +1,17 @@
+#define _GNU_SOURCE
 #include "admin/admin_server.h"
+#include "admin/admin_snapshot.h"
 #include "sim/types.h"
 #include "sim/island.h"
+#include "sim/replay.h"
 #include "net/network.h"
 #include "net/websocket_server.h"
 #include "net/ship_init.h"
 #include "input_validation.h"
 #include "util/log.h"
 #include "util/time.h"
+#include "util/profiler.h"
+#include "util/metrics.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -16,19 +21,16 @@
 // Static buffer for JSON responses (to avoid dynamic allocation)
 static char json_buffer[32768];
 
-int admin_api_status(struct HttpResponse* resp, const struct Sim* sim,
-                    const struct NetworkManager* net_mgr) {
-    if (!resp || !sim) return -1;
+int admin_api_status(struct HttpResponse* resp, const struct AdminSnapshot* snap) {
+    if (!resp || !snap) return -1;
     
-    (void)net_mgr; // Unused parameter
     uint32_t current_time = get_time_ms();
     uint32_t uptime = current_time - 0; // TODO: Get actual start time
     
     // Get WebSocket player count for more accurate count
-    struct WebSocketStats ws_stats;
-    uint32_t total_players = sim->player_count;
-    if (websocket_server_get_stats(&ws_stats) == 0) {
-        total_players = ws_stats.connected_clients;
+    uint32_t total_players = snap->player_count;
+    if (snap->ws_stats_ok) {
+        total_players = snap->ws_stats.connected_clients;
     }
     
     int len = snprintf(json_buffer, sizeof(json_buffer),
@@ -42,7 +44,7 @@ int admin_api_status(struct HttpResponse* resp, const struct Sim* sim,
         "}",
         uptime / 1000,
         TICK_RATE_HZ,
-        sim->tick,
+        snap->tick,
         total_players,
         current_time
     );
@@ -58,8 +60,8 @@ int admin_api_status(struct HttpResponse* resp, const struct Sim* sim,
     return 0;
 }
 
-int admin_api_entities(struct HttpResponse* resp, const struct Sim* sim) {
-    if (!resp || !sim) return -1;
+int admin_api_entities(struct HttpResponse* resp, const struct AdminSnapshot* snap) {
+    if (!resp || !snap) return -1;
     
     // Start JSON array
     int offset = snprintf(json_buffer, sizeof(json_buffer), 
@@ -68,8 +70,8 @@ int admin_api_entities(struct HttpResponse* resp, const struct Sim* sim) {
     bool first = true;
     
     // Add ships
-    for (uint32_t i = 0; i < sim->ship_count && offset < (int)sizeof(json_buffer) - 200; i++) {
-        const struct Ship* ship = &sim->ships[i];
+    for (uint32_t i = 0; i < snap->ship_count && offset < (int)sizeof(json_buffer) - 200; i++) {
+        const struct Ship* ship = &snap->ships[i];
         
         if (!first) {
             offset += snprintf(json_buffer + offset, sizeof(json_buffer) - offset, ",\n");
@@ -98,8 +100,8 @@ int admin_api_entities(struct HttpResponse* resp, const struct Sim* sim) {
     }
     
     // Add players
-    for (uint32_t i = 0; i < sim->player_count && offset < (int)sizeof(json_buffer) - 200; i++) {
-        const struct Player* player = &sim->players[i];
+    for (uint32_t i = 0; i < snap->player_count && offset < (int)sizeof(json_buffer) - 200; i++) {
+        const struct Player* player = &snap->players[i];
         
         if (!first) {
             offset += snprintf(json_buffer + offset, sizeof(json_buffer) - offset, ",\n");
@@ -123,8 +125,8 @@ int admin_api_entities(struct HttpResponse* resp, const struct Sim* sim) {
     }
     
     // Add projectiles
-    for (uint32_t i = 0; i < sim->projectile_count && offset < (int)sizeof(json_buffer) - 200; i++) {
-        const struct Projectile* proj = &sim->projectiles[i];
+    for (uint32_t i = 0; i < snap->projectile_count && offset < (int)sizeof(json_buffer) - 200; i++) {
+        const struct Projectile* proj = &snap->projectiles[i];
         
         if (!first) {
             offset += snprintf(json_buffer + offset, sizeof(json_buffer) - offset, ",\n");
@@ -164,18 +166,17 @@ int admin_api_entities(struct HttpResponse* resp, const struct Sim* sim) {
     return 0;
 }
 
-int admin_api_physics_objects(struct HttpResponse* resp, const struct Sim* sim) {
-    if (!resp || !sim) return -1;
+int admin_api_physics_objects(struct HttpResponse* resp, const struct AdminSnapshot* snap) {
+    if (!resp || !snap) return -1;
     
     // Get accurate player count from WebSocket server
-    struct WebSocketStats ws_stats;
     uint32_t websocket_players = 0;
-    if (websocket_server_get_stats(&ws_stats) == 0) {
-        websocket_players = ws_stats.connected_clients;
+    if (snap->ws_stats_ok) {
+        websocket_players = snap->ws_stats.connected_clients;
     }
     
     // Calculate physics statistics
-    uint32_t total_objects = sim->ship_count + websocket_players + sim->projectile_count;
+    uint32_t total_objects = snap->ship_count + websocket_players + snap->projectile_count;
     uint32_t collisions_per_second = 0; // TODO: Track collision rate
     
     int len = snprintf(json_buffer, sizeof(json_buffer),
@@ -193,9 +194,9 @@ int admin_api_physics_objects(struct HttpResponse* resp, const struct Sim* sim)
         "    \"max_y\": %.1f\n"
         "  }\n"
         "}",
-        sim->ship_count,
+        snap->ship_count,
         websocket_players,
-        sim->projectile_count,
+        snap->projectile_count,
         total_objects,
         collisions_per_second,
         (float)FIXED_DT_Q16 / Q16_ONE,
@@ -255,11 +256,10 @@ int admin_api_network_stats(struct HttpResponse* resp, const struct NetworkManag
     return 0;
 }
 
-int admin_api_performance(struct HttpResponse* resp, const struct Sim* sim) {
-    if (!resp || !sim) return -1;
+int admin_api_performance(struct HttpResponse* resp, const struct AdminSnapshot* snap) {
+    if (!resp || !snap) return -1;
 
-    struct WebSocketPerfSnapshot perf;
-    websocket_server_get_perf_snapshot(&perf);
+    const struct WebSocketPerfSnapshot perf = snap->perf;
 
     int len = snprintf(json_buffer, sizeof(json_buffer),
         "{\n"
@@ -284,9 +284,9 @@ int admin_api_performance(struct HttpResponse* resp, const struct Sim* sim) {
         "  \"gs_ditem_last\": %zu,\n"
         "  \"gs_co_last\": %zu\n"
         "}\n",
-        sim->tick,
-        sim->ship_count,
-        sim->player_count,
+        snap->tick,
+        snap->ship_count,
+        snap->player_count,
         (unsigned long long)perf.blob_last_build_us,
         (unsigned long long)perf.blob_max_build_us,
         (unsigned long long)perf.send_build_last_us,
@@ -316,20 +316,19 @@ int admin_api_performance(struct HttpResponse* resp, const struct Sim* sim) {
 }
 
 // Map data API - provides real-time positions of all entities
-int admin_api_map_data(struct HttpResponse* resp, const struct Sim* sim) {
-    if (!resp || !sim) return -1;
+int admin_api_map_data(struct HttpResponse* resp, const struct AdminSnapshot* snap) {
+    if (!resp || !snap) return -1;
 
     int offset = 0;
 
     // Count ghost ships for dashboard
     uint32_t ghost_count = 0;
-    for (uint32_t i = 0; i < sim->ship_count; i++) {
-        if (sim->ships[i].id != 0 && sim->ships[i].company_id == COMPANY_GHOST) ghost_count++;
+    for (uint32_t i = 0; i < snap->ship_count; i++) {
+        if (snap->ships[i].id != 0 && snap->ships[i].company_id == COMPANY_GHOST) ghost_count++;
     }
-    // Fetch simple ships for npc_level lookup
-    SimpleShip* ws_ships = NULL;
-    int ws_ship_count = 0;
-    websocket_server_get_ships(&ws_ships, &ws_ship_count);
+    // Simple ships for npc_level lookup
+    const SimpleShip* ws_ships = snap->ws_ships;
+    int ws_ship_count = snap->ws_ship_count;
 
     offset += snprintf(json_buffer + offset, sizeof(json_buffer) - offset,
         "{\n  \"world\": {\n    \"width\": 1000,\n    \"height\": 1000\n  },\n  \"ghost_count\": %u,\n",
@@ -339,8 +338,8 @@ int admin_api_map_data(struct HttpResponse* resp, const struct Sim* sim) {
     offset += snprintf(json_buffer + offset, sizeof(json_buffer) - offset,
         "  \"ships\": [\n");
     
-    for (uint32_t i = 0; i < sim->ship_count && offset < (int)sizeof(json_buffer) - 200; i++) {
-        const struct Ship* ship = &sim->ships[i];
+    for (uint32_t i = 0; i < snap->ship_count && offset < (int)sizeof(json_buffer) - 200; i++) {
+        const struct Ship* ship = &snap->ships[i];
         if (ship->id == 0) continue; // Skip invalid ships
         
         // Convert Q16.16 fixed-point to float and scale back to client coordinates
@@ -420,7 +419,7 @@ int admin_api_map_data(struct HttpResponse* resp, const struct Sim* sim) {
         
         offset += snprintf(json_buffer + offset, sizeof(json_buffer) - offset,
             "]\n    }%s\n",
-            (i + 1 < sim->ship_count) ? "," : ""
+            (i + 1 < snap->ship_count) ? "," : ""
         );
     }
     
@@ -428,8 +427,8 @@ int admin_api_map_data(struct HttpResponse* resp, const struct Sim* sim) {
         "  ],\n  \"players\": [\n");
     
     // Players
-    for (uint32_t i = 0; i < sim->player_count && offset < (int)sizeof(json_buffer) - 200; i++) {
-        const struct Player* player = &sim->players[i];
+    for (uint32_t i = 0; i < snap->player_count && offset < (int)sizeof(json_buffer) - 200; i++) {
+        const struct Player* player = &snap->players[i];
         if (player->id == 0) continue; // Skip invalid players
         
         // Scale back to client coordinates
@@ -446,7 +445,7 @@ int admin_api_map_data(struct HttpResponse* resp, const struct Sim* sim) {
             "      \"health\": %u\n"
             "    }%s\n",
             player->id, pos_x, pos_y, player->ship_id, player->health,
-            (i + 1 < sim->player_count) ? "," : ""
+            (i + 1 < snap->player_count) ? "," : ""
         );
     }
     
@@ -454,8 +453,8 @@ int admin_api_map_data(struct HttpResponse* resp, const struct Sim* sim) {
         "  ],\n  \"projectiles\": [\n");
     
     // Projectiles (cannonballs)
-    for (uint32_t i = 0; i < sim->projectile_count && offset < (int)sizeof(json_buffer) - 200; i++) {
-        const struct Projectile* proj = &sim->projectiles[i];
+    for (uint32_t i = 0; i < snap->projectile_count && offset < (int)sizeof(json_buffer) - 200; i++) {
+        const struct Projectile* proj = &snap->projectiles[i];
         if (proj->id == 0) continue; // Skip invalid projectiles
         
         // Scale back to client coordinates
@@ -474,7 +473,7 @@ int admin_api_map_data(struct HttpResponse* resp, const struct Sim* sim) {
             "      \"shooter_id\": %u\n"
             "    }%s\n",
             proj->id, pos_x, pos_y, vel_x, vel_y, proj->owner_id,
-            (i + 1 < sim->projectile_count) ? "," : ""
+            (i + 1 < snap->projectile_count) ? "," : ""
         );
     }
     
@@ -522,10 +521,10 @@ int admin_api_map_data(struct HttpResponse* resp, const struct Sim* sim) {
     offset += snprintf(json_buffer + offset, sizeof(json_buffer) - offset,
         "\n  ],\n  \"structures\": [\n");
     {
-        PlacedStructure *ps = NULL;
-        uint32_t ps_count = 0;
+        const PlacedStructure *ps = snap->structures;
+        uint32_t ps_count = snap->structure_count;
         bool ps_first = true;
-        if (websocket_server_get_placed_structures(&ps, &ps_count) == 0) {
+        {
             for (uint32_t si = 0; si < ps_count && offset < (int)sizeof(json_buffer) - 512; si++) {
                 if (!ps[si].active) continue;
                 const char *stype =
@@ -596,11 +595,96 @@ int admin_api_map_data(struct HttpResponse* resp, const struct Sim* sim) {
     return 0;
 }
 
-int admin_api_message_stats(struct HttpResponse* resp) {
+/* Profiler dumps are sized by the flight recorder, not json_buffer, so they
+ * go through a memstream.  The admin thread serves one request at a time;
+ * the previous dump is freed when the next one is built. */
+static char* profile_buffer = NULL;
+
+static int admin_api_send_memstream(struct HttpResponse* resp, int (*writer)(FILE*, int), int arg) {
+    free(profile_buffer);
+    profile_buffer = NULL;
+    size_t size = 0;
+    FILE* ms = open_memstream(&profile_buffer, &size);
+    if (!ms) return -1;
+    int rc = writer(ms, arg);
+    fclose(ms);
+    if (rc != 0) return -1;
+
+    resp->status_code = 200;
+    resp->content_type = "application/json";
+    resp->body = profile_buffer;
+    resp->body_length = size;
+    return 0;
+}
+
+static int write_trace(FILE* out, int unused) {
+    (void)unused;
+    return prof_write_chrome_trace(out);
+}
+
+/* GET /api/profile[?ticks=N] — per-scope percentiles plus the last N ticks'
+ * breakdown from the flight recorder (default 30, max PROF_FLIGHT_TICKS). */
+int admin_api_profile(struct HttpResponse* resp, const char* query) {
+    if (!resp) return -1;
+    int ticks = 30;
+    const char* t = query ? strstr(query, "ticks=") : NULL;
+    if (t) ticks = atoi(t + 6);
+    if (query && strstr(query, "reset=1")) {
+        prof_reset();
+        ticks = 0;
+    }
+    return admin_api_send_memstream(resp, prof_write_json, ticks);
+}
+
+static int write_metrics(FILE* out, int unused) {
+    (void)unused;
+    return metrics_write_openmetrics(out);
+}
+
+/* GET /metrics — OpenMetrics text for Prometheus scrapes */
+int admin_api_metrics(struct HttpResponse* resp) {
+    if (!resp) return -1;
+    if (admin_api_send_memstream(resp, write_metrics, 0) != 0) return -1;
+    resp->content_type = METRICS_CONTENT_TYPE;
+    return 0;
+}
+
+/* GET /api/profile/trace — whole flight recorder in Chrome trace format */
+int admin_api_profile_trace(struct HttpResponse* resp) {
     if (!resp) return -1;
+    return admin_api_send_memstream(resp, write_trace, 0);
+}
+
+/* GET /api/replay — recorder status.  POST /api/replay/start|stop queue the
+ * change for the next tick boundary, so the reply still shows the old state
+ * with "pending" set; recordings go to REPLAY_DIR/replay_<tick>.bin. */
+int admin_api_replay(struct HttpResponse* resp, const char* action) {
+    if (!resp) return -1;
+    if (action && strcmp(action, "start") == 0) replay_request_start(NULL);
+    else if (action && strcmp(action, "stop") == 0) replay_request_stop();
+
+    struct ReplayRecorderStatus st;
+    replay_recorder_status(&st);
+    int len = snprintf(json_buffer, sizeof(json_buffer),
+        "{\"recording\":%s,\"pending\":%s,\"path\":\"%s\",\"startTick\":%u,"
+        "\"ticks\":%u,\"bytes\":%llu}",
+        st.recording ? "true" : "false", action ? "true" : "false",
+        st.path, st.start_tick, st.ticks, (unsigned long long)st.bytes);
+    if (len < 0 || len >= (int)sizeof(json_buffer)) return -1;
+
+    resp->status_code = 200;
+    resp->content_type = "application/json";
+    resp->body = json_buffer;
+    resp->body_length = (size_t)len;
+    resp->cache_control = false;
+    return 0;
+}
+
+int admin_api_message_stats(struct HttpResponse* resp, const struct AdminSnapshot* snap) {
+    if (!resp || !snap) return -1;
     
-    struct WebSocketStats ws_stats;
-    if (websocket_server_get_stats(&ws_stats) != 0) {
+    const struct WebSocketStats ws_stats = snap->ws_stats;
+    if (!snap->ws_stats_ok) {
         // WebSocket server not available, return empty stats
         int len = snprintf(json_buffer, sizeof(json_buffer),
             "{\n"
@@ -654,16 +738,13 @@ int admin_api_message_stats(struct HttpResponse* resp) {
     return 0;
 }
 
-int admin_api_websocket_entities(struct HttpResponse* resp) {
-    if (!resp) return -1;
+int admin_api_websocket_entities(struct HttpResponse* resp, const struct AdminSnapshot* snap) {
+    if (!resp || !snap) return -1;
     
-    SimpleShip* ships = NULL;
-    WebSocketPlayer* players = NULL;
-    int ship_count = 0;
-    int player_count = 0;
-    
-    websocket_server_get_ships(&ships, &ship_count);
-    websocket_server_get_players(&players, &player_count);
+    const SimpleShip* ships = snap->ws_ships;
+    const WebSocketPlayer* players = snap->ws_players;
+    int ship_count = snap->ws_ship_count;
+    int player_count = snap->ws_player_count;
     
     // Start JSON
     int offset = snprintf(json_buffer, sizeof(json_buffer),
@@ -698,8 +779,7 @@ int admin_api_websocket_entities(struct HttpResponse* resp) {
     
     // Add active players
     bool first_player = true;
-    for (int i = 0; i < 100 && offset < (int)sizeof(json_buffer) - 500; i++) {
-        if (!players[i].active) continue;
+    for (int i = 0; i < player_count && offset < (int)sizeof(json_buffer) - 500; i++) {
         
         if (!first_player) offset += snprintf(json_buffer + offset, sizeof(json_buffer) - offset, ",\n");
         first_player = false;
@@ -753,12 +833,12 @@ int admin_api_websocket_entities(struct HttpResponse* resp) {
     return 0;
 }
 // Input tier statistics API endpoint
-int admin_api_input_tiers(struct HttpResponse* resp) {
-    if (!resp) return -1;
+int admin_api_input_tiers(struct HttpResponse* resp, const struct AdminSnapshot* snap) {
+    if (!resp || !snap) return -1;
     
-    // Get global tier statistics
+    // Tier config is static after startup; per-tier player counts come from the snapshot
     extern input_tier_config_t g_tier_config[INPUT_TIER_COUNT];
-    extern int tier_player_counts[INPUT_TIER_COUNT];
+    const int* tier_player_counts = snap->tier_player_counts;
     
     // Calculate total processed inputs per tier
     int total_inputs = 0;
@@ -1,8 +1,11 @@
+#define _GNU_SOURCE
 #include "admin/admin_server.h"
+#include "admin/admin_snapshot.h"
 #include "sim/types.h"
 #include "net/network.h"
 #include "net/claim.h"
 #include "net/structures.h"
+#include "net/harvesting.h"
 #include "util/log.h"
 #include "util/time.h"
 #include "sim/world_save.h"
@@ -15,6 +18,11 @@
 #include <arpa/inet.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <strings.h>
+#include <poll.h>
+#include <pthread.h>
+#include <time.h>
+#include <sys/time.h>
 
 // Simple HTML dashboard with map tab
 static const char* dashboard_html = 
@@ -1158,6 +1166,16 @@ static const char* dashboard_html =
 "</script>\n"
 "</body></html>";
 
+/* Pending POST handed from the admin thread to the tick loop.  Lives on the
+ * admin thread's stack; the admin thread blocks until `done` is set. */
+struct AdminJob {
+    const struct HttpRequest* req;
+    struct HttpResponse* resp;
+    bool done;
+};
+
+static void* admin_thread_main(void* arg);
+
 int admin_server_init(struct AdminServer* admin, uint16_t port) {
     if (!admin) return -1;
     
@@ -1165,6 +1183,9 @@ int admin_server_init(struct AdminServer* admin, uint16_t port) {
     admin->port = port;
     admin->running = true;
     admin->start_time = get_time_ms();
+    for (int i = 0; i < ADMIN_MAX_CLIENTS; i++) {
+        admin->clients[i].socket_fd = -1;
+    }
     
     // Create HTTP socket
     admin->socket_fd = socket(AF_INET, SOCK_STREAM, 0);
@@ -1206,18 +1227,77 @@ int admin_server_init(struct AdminServer* admin, uint16_t port) {
         close(admin->socket_fd);
         return -1;
     }
+
+    admin->snapshot = admin_snapshot_create();
+    if (!admin->snapshot) {
+        log_error("Failed to allocate admin world snapshot");
+        close(admin->socket_fd);
+        return -1;
+    }
+
+    // Serve HTTP from a dedicated thread so requests never run inside the tick
+    if (pthread_mutex_init(&admin->mtx, NULL) != 0) {
+        admin_snapshot_destroy(admin->snapshot);
+        close(admin->socket_fd);
+        return -1;
+    }
+    if (pthread_cond_init(&admin->cv, NULL) != 0) {
+        pthread_mutex_destroy(&admin->mtx);
+        admin_snapshot_destroy(admin->snapshot);
+        close(admin->socket_fd);
+        return -1;
+    }
+    if (pthread_create(&admin->thread, NULL, admin_thread_main, admin) != 0) {
+        log_error("Failed to start admin server thread");
+        pthread_cond_destroy(&admin->cv);
+        pthread_mutex_destroy(&admin->mtx);
+        admin_snapshot_destroy(admin->snapshot);
+        close(admin->socket_fd);
+        return -1;
+    }
+    admin->thread_started = true;
     
-    log_info("Admin server initialized on 127.0.0.1:%u (loopback only)", port);
+    log_info("Admin server initialized on 127.0.0.1:%u (loopback only, own thread)", port);
     return 0;
 }
 
+static void admin_client_close(struct AdminClient* client) {
+    if (client->socket_fd >= 0) close(client->socket_fd);
+    client->socket_fd = -1;
+    client->active = false;
+    client->request_length = 0;
+    /* Keep a header-sized buffer around; drop anything grown for a big POST */
+    if (client->request_capacity > ADMIN_BUFFER_SIZE) {
+        free(client->request_buffer);
+        client->request_buffer = NULL;
+        client->request_capacity = 0;
+    }
+}
+
 void admin_server_cleanup(struct AdminServer* admin) {
     if (!admin) return;
     
     log_info("📋 Starting admin server cleanup...");
     
-    // Stop accepting new connections
+    // Stop accepting new connections and wake the admin thread
+    if (admin->thread_started) {
+        pthread_mutex_lock(&admin->mtx);
+        admin->running = false;
+        pthread_cond_broadcast(&admin->cv);
+        pthread_mutex_unlock(&admin->mtx);
+        pthread_join(admin->thread, NULL);
+        pthread_cond_destroy(&admin->cv);
+        pthread_mutex_destroy(&admin->mtx);
+        admin->thread_started = false;
+    }
     admin->running = false;
+
+    for (int i = 0; i < ADMIN_MAX_CLIENTS; i++) {
+        admin_client_close(&admin->clients[i]);
+        free(admin->clients[i].request_buffer);
+        admin->clients[i].request_buffer = NULL;
+        admin->clients[i].request_capacity = 0;
+    }
     
     if (admin->socket_fd >= 0) {
         // Shutdown the socket gracefully
@@ -1226,262 +1306,402 @@ void admin_server_cleanup(struct AdminServer* admin) {
         admin->socket_fd = -1;
         log_info("🔌 Admin server socket closed");
     }
+
+    admin_snapshot_destroy(admin->snapshot);
+    admin->snapshot = NULL;
+    admin->snapshot_valid = false;
     
     log_info("✅ Admin server cleanup complete");
 }
 
+/* ── Tick-loop side ─────────────────────────────────────────────────────── */
+
+static void admin_route_post(const struct HttpRequest* req, struct HttpResponse* resp);
+
 int admin_server_update(struct AdminServer* admin, const struct Sim* sim,
                        const struct NetworkManager* net_mgr) {
-    if (!admin || !admin->running) return 0;
-    
-    // Accept new connections (simplified)
-    struct sockaddr_in client_addr;
-    socklen_t addr_len = sizeof(client_addr);
-    int client_fd = accept(admin->socket_fd, (struct sockaddr*)&client_addr, &addr_len);
+    (void)net_mgr;
+    if (!admin || !admin->thread_started) return 0;
+
+    pthread_mutex_lock(&admin->mtx);
+    if (admin->snapshot_requested && sim) {
+        uint64_t t0 = get_time_us();
+        admin_snapshot_capture(admin->snapshot, sim);
+        admin->last_snapshot_us = get_time_us() - t0;
+        admin->snapshots_taken++;
+        admin->snapshot_valid = true;
+        admin->snapshot_requested = false;
+        pthread_cond_broadcast(&admin->cv);
+    }
+    /* Mutating requests still run here, between input and physics, exactly
+     * where the old inline handler ran them. */
+    if (admin->job && !admin->job->done) {
+        admin_route_post(admin->job->req, admin->job->resp);
+        admin->job->done = true;
+        pthread_cond_broadcast(&admin->cv);
+    }
+    pthread_mutex_unlock(&admin->mtx);
     
-    if (client_fd >= 0) {
-        /* ── Read full HTTP request (headers + body) ─────────────────────
-         * Use a fixed header buffer for the first recv, then malloc a larger
-         * buffer if Content-Length indicates more body bytes are on the way.
-         * This fixes truncation for large POSTs (e.g. island save JSON).    */
-#define ADMIN_HDR_BUF  4096
-#define ADMIN_MAX_BODY (512 * 1024)   /* 512 KB max request body */
+    return 0;
+}
 
-        char hdr_buf[ADMIN_HDR_BUF];
-        ssize_t hdr_recv = recv(client_fd, hdr_buf, ADMIN_HDR_BUF - 1, 0);
-        char *dyn_buf = NULL;
-        char *buffer;                 /* unified pointer used throughout routing */
+static void admin_route_post(const struct HttpRequest* req, struct HttpResponse* resp) {
+    const char* path = req->path;
+    const char* body = req->body;
+    size_t blen = req->body_length;
 
-        if (hdr_recv <= 0) {
-            close(client_fd);
-            return 0;
+    if (strcmp(path, "/api/world/save") == 0) {
+        int sr = world_save(WORLD_SAVE_DEFAULT_PATH);
+        if (sr == 0) {
+            resp->status_code = 200;
+            resp->content_type = "application/json";
+            resp->body = "{\"ok\":true,\"path\":\"" WORLD_SAVE_DEFAULT_PATH "\"}";
+            resp->body_length = strlen(resp->body);
+        } else {
+            resp->status_code = 500;
+            resp->body = "{\"ok\":false,\"error\":\"save failed\"}";
+            resp->body_length = strlen(resp->body);
+        }
+    } else if (strcmp(path, "/api/world/load") == 0) {
+        int lr = world_load(WORLD_SAVE_DEFAULT_PATH);
+        if (lr == 0) {
+            claim_dominators_sanity_sweep();
+            /* Rebuild shipyard/chest lookup tables (structure_index)
+             * and scrub stale scaffolding links — same as server.c
+             * startup path after world_load(). */
+            shipyard_scaffolding_sanity_sweep();
+            structure_repairs_wake_all();
+            claim_forts_wake_all();
+            harvest_respawns_wake_all();
+            resp->status_code = 200;
+            resp->content_type = "application/json";
+            resp->body = "{\"ok\":true}";
+            resp->body_length = 11;
+        } else {
+            resp->status_code = 500;
+            resp->body = "{\"ok\":false,\"error\":\"load failed\"}";
+            resp->body_length = strlen(resp->body);
         }
-        hdr_buf[hdr_recv] = '\0';
+    } else if (strcmp(path, "/api/islands/save") == 0) {
+        admin_api_islands_save(resp, body, blen);
+    } else if (strcmp(path, "/api/ghost-spawns") == 0) {
+        admin_api_save_ghost_spawns(resp, body, blen);
+    } else if (strcmp(path, "/api/islands/positions") == 0) {
+        admin_api_save_island_positions(resp, body, blen);
+    } else if (strcmp(path, "/api/islands/reposition") == 0) {
+        admin_api_islands_reposition(resp, body, blen);
+    } else if (strcmp(path, "/api/replay/start") == 0) {
+        admin_api_replay(resp, "start");
+    } else if (strcmp(path, "/api/replay/stop") == 0) {
+        admin_api_replay(resp, "stop");
+    } else if (strcmp(path, "/api/admin/ship") == 0) {
+        float x = 400.0f, y = 400.0f;
+        uint8_t company = 1; // COMPANY_PIRATES default
+        if (blen > 0) {
+            const char *p;
+            p = strstr(body, "\"x\"");
+            if (p) { p = strchr(p, ':'); if (p) x = (float)atof(p + 1); }
+            p = strstr(body, "\"y\"");
+            if (p) { p = strchr(p, ':'); if (p) y = (float)atof(p + 1); }
+            p = strstr(body, "\"company\"");
+            if (p) { p = strchr(p, ':'); if (p) company = (uint8_t)atoi(p + 1); }
+        }
+        admin_api_create_ship(resp, x, y, company);
+    } else if (strcmp(path, "/api/admin/phantom-brig") == 0) {
+        float x = 400.0f, y = 400.0f;
+        uint8_t level = 1;
+        if (blen > 0) {
+            const char *p;
+            p = strstr(body, "\"x\"");
+            if (p) { p = strchr(p, ':'); if (p) x = (float)atof(p + 1); }
+            p = strstr(body, "\"y\"");
+            if (p) { p = strchr(p, ':'); if (p) y = (float)atof(p + 1); }
+            p = strstr(body, "\"level\"");
+            if (p) { p = strchr(p, ':'); if (p) { int lv = atoi(p + 1); if (lv >= 1 && lv <= 60) level = (uint8_t)lv; } }
+        }
+        admin_api_create_phantom_brig(resp, x, y, level);
+    } else if (strcmp(path, "/api/admin/player/company") == 0) {
+        uint32_t player_id = 0;
+        uint8_t company = 0;
+        if (blen > 0) {
+            const char *p;
+            p = strstr(body, "\"playerId\"");
+            if (p) { p = strchr(p, ':'); if (p) player_id = (uint32_t)atoi(p + 1); }
+            p = strstr(body, "\"company\"");
+            if (p) { p = strchr(p, ':'); if (p) company = (uint8_t)atoi(p + 1); }
+        }
+        admin_api_set_player_company(resp, player_id, company);
+    } else {
+        resp->status_code = 404;
+        resp->body = "Not Found";
+        resp->body_length = 9;
+    }
+}
+
+/* ── Admin-thread side ──────────────────────────────────────────────────── */
+
+static void admin_deadline_ms(struct timespec* ts, int ms) {
+    clock_gettime(CLOCK_REALTIME, ts);
+    ts->tv_sec  += ms / 1000;
+    ts->tv_nsec += (long)(ms % 1000) * 1000000L;
+    if (ts->tv_nsec >= 1000000000L) {
+        ts->tv_sec++;
+        ts->tv_nsec -= 1000000000L;
+    }
+}
+
+/* Returns a snapshot at most ADMIN_SNAPSHOT_MAX_AGE_US old, asking the tick
+ * loop for a new one if needed.  If the tick loop doesn't answer within
+ * ADMIN_SNAPSHOT_WAIT_MS the request is withdrawn (so it can't be written
+ * while we read) and the previous snapshot, if any, is served instead. */
+static const struct AdminSnapshot* admin_acquire_snapshot(struct AdminServer* admin) {
+    const struct AdminSnapshot* snap = NULL;
 
-        /* Parse Content-Length and locate header/body boundary */
-        char  *body_sep = strstr(hdr_buf, "\r\n\r\n");
-        size_t cl = 0;
-        {
-            const char *p = strstr(hdr_buf, "Content-Length: ");
-            if (!p) p = strstr(hdr_buf, "content-length: ");
-            if (p) cl = (size_t)strtoul(p + 16, NULL, 10);
+    pthread_mutex_lock(&admin->mtx);
+    if (!admin->snapshot_valid ||
+        get_time_us() - admin->snapshot->taken_us > ADMIN_SNAPSHOT_MAX_AGE_US) {
+        struct timespec deadline;
+        admin_deadline_ms(&deadline, ADMIN_SNAPSHOT_WAIT_MS);
+        admin->snapshot_requested = true;
+        while (admin->snapshot_requested && admin->running) {
+            if (pthread_cond_timedwait(&admin->cv, &admin->mtx, &deadline) == ETIMEDOUT) break;
         }
+        admin->snapshot_requested = false;
+    }
+    if (admin->snapshot_valid) snap = admin->snapshot;
+    pthread_mutex_unlock(&admin->mtx);
+    return snap;
+}
 
-        if (cl > 0 && body_sep) {
-            size_t hdr_len   = (size_t)(body_sep + 4 - hdr_buf);
-            size_t in_buf    = (size_t)hdr_recv - hdr_len;          /* body bytes already in hdr_buf */
-            size_t remaining = cl > in_buf ? cl - in_buf : 0;       /* bytes still on the wire */
-            size_t total     = hdr_len + cl;
+/* Hand a mutating request to the tick loop and wait for it to run. */
+static void admin_run_on_tick_loop(struct AdminServer* admin, const struct HttpRequest* req,
+                                   struct HttpResponse* resp) {
+    struct AdminJob job = { .req = req, .resp = resp, .done = false };
 
-            if (remaining > 0 && total <= (size_t)(ADMIN_HDR_BUF + ADMIN_MAX_BODY)) {
-                dyn_buf = (char *)malloc(total + 1);
-                if (dyn_buf) {
-                    memcpy(dyn_buf, hdr_buf, (size_t)hdr_recv);
-                    size_t done = (size_t)hdr_recv;
-                    while (done < total) {
-                        ssize_t n = recv(client_fd, dyn_buf + done, total - done, 0);
-                        if (n <= 0) break;
-                        done += (size_t)n;
-                    }
-                    dyn_buf[done] = '\0';
-                    buffer = dyn_buf;
-                } else {
-                    buffer = hdr_buf;  /* malloc failed; fall back to partial buffer */
-                }
-            } else {
-                buffer = hdr_buf;
-            }
+    pthread_mutex_lock(&admin->mtx);
+    admin->job = &job;
+    while (!job.done && admin->running) {
+        pthread_cond_wait(&admin->cv, &admin->mtx);
+    }
+    admin->job = NULL;
+    pthread_mutex_unlock(&admin->mtx);
+
+    if (!job.done) {
+        resp->status_code = 503;
+        resp->content_type = "application/json";
+        resp->body = "{\"error\":\"server shutting down\"}";
+        resp->body_length = strlen(resp->body);
+    }
+}
+
+static bool admin_path_needs_snapshot(const char* path) {
+    static const char* const paths[] = {
+        "/api/status", "/api/physics", "/api/map", "/api/messages",
+        "/api/input-tiers", "/api/websocket", "/api/performance", NULL
+    };
+    for (int i = 0; paths[i]; i++) {
+        if (strcmp(path, paths[i]) == 0) return true;
+    }
+    return false;
+}
+
+static void admin_route_get(struct AdminServer* admin, const struct HttpRequest* req,
+                            struct HttpResponse* resp) {
+    const char* path = req->path;
+    const struct AdminSnapshot* snap = NULL;
+
+    if (admin_path_needs_snapshot(path)) {
+        snap = admin_acquire_snapshot(admin);
+        if (!snap) {
+            resp->status_code = 503;
+            resp->content_type = "application/json";
+            resp->body = "{\"error\":\"world snapshot unavailable\"}";
+            resp->body_length = strlen(resp->body);
+            return;
+        }
+    }
+
+    if (strcmp(path, "/") == 0) {
+        admin_serve_dashboard(resp);
+    } else if (strcmp(path, "/api/status") == 0) {
+        admin_api_status(resp, snap);
+    } else if (strcmp(path, "/api/physics") == 0) {
+        admin_api_physics_objects(resp, snap);
+    } else if (strcmp(path, "/api/network") == 0) {
+        admin_api_network_stats(resp, NULL);
+    } else if (strcmp(path, "/api/map") == 0) {
+        admin_api_map_data(resp, snap);
+    } else if (strcmp(path, "/api/messages") == 0) {
+        admin_api_message_stats(resp, snap);
+    } else if (strcmp(path, "/api/input-tiers") == 0) {
+        admin_api_input_tiers(resp, snap);
+    } else if (strcmp(path, "/api/websocket") == 0) {
+        admin_api_websocket_entities(resp, snap);
+    } else if (strcmp(path, "/api/performance") == 0) {
+        admin_api_performance(resp, snap);
+    } else if (strcmp(path, "/metrics") == 0) {
+        admin_api_metrics(resp);
+    } else if (strcmp(path, "/api/profile") == 0) {
+        admin_api_profile(resp, req->query_string);
+    } else if (strcmp(path, "/api/profile/trace") == 0) {
+        admin_api_profile_trace(resp);
+    } else if (strcmp(path, "/api/replay") == 0) {
+        admin_api_replay(resp, NULL);
+    } else if (strcmp(path, "/api/islands") == 0) {
+        /* Island presets only change through admin POSTs, which run on the
+         * tick loop while this thread is blocked waiting for them. */
+        admin_api_islands(resp);
+    } else if (strcmp(path, "/api/ghost-spawns") == 0) {
+        admin_api_get_ghost_spawns(resp);
+    } else if (strcmp(path, "/api/world/state") == 0) {
+        /* Return the current save file as JSON */
+        static char world_state_buf[524288]; /* 512 KB */
+        FILE *wf = fopen(WORLD_SAVE_DEFAULT_PATH, "r");
+        if (wf) {
+            size_t n = fread(world_state_buf,
+                             1, sizeof(world_state_buf) - 1, wf);
+            fclose(wf);
+            world_state_buf[n] = '\0';
+            resp->status_code   = 200;
+            resp->content_type  = "application/json";
+            resp->body          = world_state_buf;
+            resp->body_length   = n;
         } else {
-            buffer = hdr_buf;
+            resp->status_code  = 404;
+            resp->body         = "{\"error\":\"No save file found\"}";
+            resp->body_length  = 30;
+        }
+    } else {
+        resp->status_code = 404;
+        resp->body = "Not Found";
+        resp->body_length = 9;
+    }
+}
+
+static bool header_is(const char* line, size_t line_len, const char* name, size_t name_len) {
+    return line_len > name_len && strncasecmp(line, name, name_len) == 0 && line[name_len] == ':';
+}
+
+int admin_parse_request(const char* request_data, size_t length, struct HttpRequest* req) {
+    if (!request_data || !req) return -1;
+    memset(req, 0, sizeof(*req));
+
+    const char* hdr_end = memmem(request_data, length, "\r\n\r\n", 4);
+    if (!hdr_end) {
+        return length >= ADMIN_BUFFER_SIZE ? -1 : 0;
+    }
+    size_t hdr_len = (size_t)(hdr_end + 4 - request_data);
+    if (hdr_len > ADMIN_BUFFER_SIZE) return -1;
+
+    // Request line: METHOD SP target SP version CRLF
+    const char* line_end = memmem(request_data, hdr_len, "\r\n", 2);
+    const char* p = request_data;
+    static const struct { const char* name; http_method_t method; } methods[] = {
+        {"GET ", HTTP_GET}, {"POST ", HTTP_POST}, {"PUT ", HTTP_PUT},
+        {"DELETE ", HTTP_DELETE}, {"OPTIONS ", HTTP_OPTIONS},
+    };
+    req->method = HTTP_UNKNOWN;
+    for (size_t i = 0; i < sizeof(methods) / sizeof(methods[0]); i++) {
+        size_t n = strlen(methods[i].name);
+        if (strncmp(p, methods[i].name, n) == 0) {
+            req->method = methods[i].method;
+            p += n;
+            break;
         }
+    }
+    if (req->method == HTTP_UNKNOWN) return -1;
 
-        ssize_t received = (ssize_t)strlen(buffer);  /* satisfy existing `received > 0` check */
-        if (received > 0) {
-            // Parse request path for GET
-            char *options_start = strstr(buffer, "OPTIONS ");
-            char *path_start = strstr(buffer, "GET ");
-            char *post_start = strstr(buffer, "POST ");
-            if (options_start) {
-                /* CORS preflight — reply with all necessary headers */
-                const char *preflight =
-                    "HTTP/1.1 204 No Content\r\n"
-                    "Access-Control-Allow-Origin: *\r\n"
-                    "Access-Control-Allow-Methods: GET, POST, OPTIONS\r\n"
-                    "Access-Control-Allow-Headers: Content-Type\r\n"
-                    "Access-Control-Max-Age: 86400\r\n"
-                    "Content-Length: 0\r\n"
-                    "Connection: close\r\n"
-                    "\r\n";
-                send(client_fd, preflight, strlen(preflight), 0);
-            } else if (path_start) {
-                path_start += 4;
-                char *path_end = strchr(path_start, ' ');
-                if (path_end) {
-                    *path_end = '\0';
-                    
-                    // Route requests
-                    struct HttpResponse resp = {0};
-                    if (strcmp(path_start, "/") == 0) {
-                        admin_serve_dashboard(&resp);
-                    } else if (strcmp(path_start, "/api/status") == 0) {
-                        admin_api_status(&resp, sim, net_mgr);
-                    } else if (strcmp(path_start, "/api/physics") == 0) {
-                        admin_api_physics_objects(&resp, sim);
-                    } else if (strcmp(path_start, "/api/network") == 0) {
-                        admin_api_network_stats(&resp, net_mgr);
-                    } else if (strcmp(path_start, "/api/map") == 0) {
-                        admin_api_map_data(&resp, sim);
-                    } else if (strcmp(path_start, "/api/messages") == 0) {
-                        admin_api_message_stats(&resp);
-                    } else if (strcmp(path_start, "/api/input-tiers") == 0) {
-                        admin_api_input_tiers(&resp);
-                    } else if (strcmp(path_start, "/api/websocket") == 0) {
-                        admin_api_websocket_entities(&resp);
-                    } else if (strcmp(path_start, "/api/islands") == 0) {
-                        admin_api_islands(&resp);
-                    } else if (strcmp(path_start, "/api/ghost-spawns") == 0) {
-                        admin_api_get_ghost_spawns(&resp);
-                    } else if (strcmp(path_start, "/api/world/state") == 0) {
-                        /* Return the current save file as JSON */
-                        static char world_state_buf[524288]; /* 512 KB */
-                        FILE *wf = fopen(WORLD_SAVE_DEFAULT_PATH, "r");
-                        if (wf) {
-                            size_t n = fread(world_state_buf,
-                                             1, sizeof(world_state_buf) - 1, wf);
-                            fclose(wf);
-                            world_state_buf[n] = '\0';
-                            resp.status_code   = 200;
-                            resp.content_type  = "application/json";
-                            resp.body          = world_state_buf;
-                            resp.body_length   = n;
-                        } else {
-                            resp.status_code  = 404;
-                            resp.body         = "{\"error\":\"No save file found\"}";
-                            resp.body_length  = 30;
-                        }
-                    } else {
-                        resp.status_code = 404;
-                        resp.body = "Not Found";
-                        resp.body_length = 9;
-                    }
-                    
-                    admin_send_response(client_fd, &resp);
-                }
-            } else if (post_start) {
-                post_start += 5;
-                char *path_end = strchr(post_start, ' ');
-                if (path_end) {
-                    // Search for the body BEFORE null-terminating the path, so strstr
-                    // on the full buffer still works (inserting '\0' would cut it short).
-                    char *body = strstr(path_end, "\r\n\r\n");
-                    if (body) body += 4;
+    const char* target_end = memchr(p, ' ', (size_t)(line_end - p));
+    if (!target_end) return -1;
+    const char* query = memchr(p, '?', (size_t)(target_end - p));
+    const char* path_end = query ? query : target_end;
+    size_t path_len = (size_t)(path_end - p);
+    if (path_len >= sizeof(req->path)) return -1;
+    memcpy(req->path, p, path_len);
+    if (query) {
+        size_t qlen = (size_t)(target_end - query - 1);
+        if (qlen >= sizeof(req->query_string)) qlen = sizeof(req->query_string) - 1;
+        memcpy(req->query_string, query + 1, qlen);
+    }
+    // HTTP/1.1 defaults to keep-alive, HTTP/1.0 to close
+    req->keep_alive = (size_t)(line_end - target_end) >= 9 &&
+                      strncmp(target_end + 1, "HTTP/1.1", 8) == 0;
 
-                    *path_end = '\0';
+    // Headers
+    const char* hdrs = line_end + 2;
+    size_t hdrs_len = (size_t)(hdr_end - hdrs);
+    size_t copy = hdrs_len < sizeof(req->headers) - 1 ? hdrs_len : sizeof(req->headers) - 1;
+    memcpy(req->headers, hdrs, copy);
 
-                    struct HttpResponse resp = {0};
-                    if (strcmp(post_start, "/api/world/save") == 0) {
-                        int sr = world_save(WORLD_SAVE_DEFAULT_PATH);
-                        if (sr == 0) {
-                            resp.status_code = 200;
-                            resp.content_type = "application/json";
-                            resp.body = "{\"ok\":true,\"path\":\"" WORLD_SAVE_DEFAULT_PATH "\"}";
-                            resp.body_length = strlen(resp.body);
-                        } else {
-                            resp.status_code = 500;
-                            resp.body = "{\"ok\":false,\"error\":\"save failed\"}";
-                            resp.body_length = strlen(resp.body);
-                        }
-                    } else if (strcmp(post_start, "/api/world/load") == 0) {
-                        int lr = world_load(WORLD_SAVE_DEFAULT_PATH);
-                        if (lr == 0) {
-                            claim_dominators_sanity_sweep();
-                            /* Rebuild shipyard/chest lookup tables (structure_index)
-                             * and scrub stale scaffolding links — same as server.c
-                             * startup path after world_load(). */
-                            shipyard_scaffolding_sanity_sweep();
-                            resp.status_code = 200;
-                            resp.content_type = "application/json";
-                            resp.body = "{\"ok\":true}";
-                            resp.body_length = 12;
-                        } else {
-                            resp.status_code = 500;
-                            resp.body = "{\"ok\":false,\"error\":\"load failed\"}";
-                            resp.body_length = strlen(resp.body);
-                        }
-                    } else if (strcmp(post_start, "/api/islands/save") == 0) {
-                        size_t blen = body ? strlen(body) : 0;
-                        admin_api_islands_save(&resp, body, blen);
-                    } else if (strcmp(post_start, "/api/ghost-spawns") == 0) {
-                        size_t blen = body ? strlen(body) : 0;
-                        admin_api_save_ghost_spawns(&resp, body, blen);
-                    } else if (strcmp(post_start, "/api/islands/positions") == 0) {
-                        size_t blen = body ? strlen(body) : 0;
-                        admin_api_save_island_positions(&resp, body, blen);
-                    } else if (strcmp(post_start, "/api/islands/reposition") == 0) {
-                        size_t blen = body ? strlen(body) : 0;
-                        admin_api_islands_reposition(&resp, body, blen);
-                    } else if (strcmp(post_start, "/api/admin/ship") == 0) {
-                        float x = 400.0f, y = 400.0f;
-                        uint8_t company = 1; // COMPANY_PIRATES default
-                        if (body) {
-                            char *p;
-                            p = strstr(body, "\"x\"");
-                            if (p) { p = strchr(p, ':'); if (p) x = (float)atof(p + 1); }
-                            p = strstr(body, "\"y\"");
-                            if (p) { p = strchr(p, ':'); if (p) y = (float)atof(p + 1); }
-                            p = strstr(body, "\"company\"");
-                            if (p) { p = strchr(p, ':'); if (p) company = (uint8_t)atoi(p + 1); }
-                        }
-                        admin_api_create_ship(&resp, x, y, company);
-                    } else if (strcmp(post_start, "/api/admin/phantom-brig") == 0) {
-                        float x = 400.0f, y = 400.0f;
-                        uint8_t level = 1;
-                        if (body) {
-                            char *p;
-                            p = strstr(body, "\"x\"");
-                            if (p) { p = strchr(p, ':'); if (p) x = (float)atof(p + 1); }
-                            p = strstr(body, "\"y\"");
-                            if (p) { p = strchr(p, ':'); if (p) y = (float)atof(p + 1); }
-                            p = strstr(body, "\"level\"");
-                            if (p) { p = strchr(p, ':'); if (p) { int lv = atoi(p + 1); if (lv >= 1 && lv <= 60) level = (uint8_t)lv; } }
-                        }
-                        admin_api_create_phantom_brig(&resp, x, y, level);
-                    } else if (strcmp(post_start, "/api/admin/player/company") == 0) {
-                        uint32_t player_id = 0;
-                        uint8_t company = 0;
-                        if (body) {
-                            char *p;
-                            p = strstr(body, "\"playerId\"");
-                            if (p) { p = strchr(p, ':'); if (p) player_id = (uint32_t)atoi(p + 1); }
-                            p = strstr(body, "\"company\"");
-                            if (p) { p = strchr(p, ':'); if (p) company = (uint8_t)atoi(p + 1); }
-                        }
-                        admin_api_set_player_company(&resp, player_id, company);
-                    } else {
-                        resp.status_code = 404;
-                        resp.body = "Not Found";
-                        resp.body_length = 9;
-                    }
-                    admin_send_response(client_fd, &resp);
-                }
-            }
+    size_t content_length = 0;
+    for (const char* ln = hdrs; ln < hdr_end; ) {
+        const char* eol = memmem(ln, (size_t)(hdr_end + 2 - ln), "\r\n", 2);
+        if (!eol) eol = hdr_end;
+        size_t ll = (size_t)(eol - ln);
+        if (header_is(ln, ll, "Content-Length", 14)) {
+            content_length = (size_t)strtoul(ln + 15, NULL, 10);
+        } else if (header_is(ln, ll, "Connection", 10)) {
+            const char* v = ln + 11;
+            while (v < eol && *v == ' ') v++;
+            if ((size_t)(eol - v) >= 5 && strncasecmp(v, "close", 5) == 0) req->keep_alive = false;
+            if ((size_t)(eol - v) >= 10 && strncasecmp(v, "keep-alive", 10) == 0) req->keep_alive = true;
         }
-        free(dyn_buf);
-        close(client_fd);
+        ln = eol + 2;
     }
-    
-    return 0;
+
+    if (content_length > ADMIN_MAX_BODY) return -1;
+    if (length < hdr_len + content_length) return 0;
+
+    req->body = (char*)request_data + hdr_len;
+    req->body_length = content_length;
+    req->total_length = hdr_len + content_length;
+    return 1;
 }
 
-int admin_parse_request(const char* request_data, size_t length, struct HttpRequest* req) {
-    (void)request_data; (void)length; (void)req;
-    return 0;  // Simplified
+int admin_handle_request(struct AdminServer* admin, const struct HttpRequest* req,
+                        struct HttpResponse* resp) {
+    if (!admin || !req || !resp) return -1;
+
+    switch (req->method) {
+        case HTTP_OPTIONS:
+            /* CORS preflight — headers are added by admin_send_response */
+            resp->status_code = 204;
+            resp->body = NULL;
+            resp->body_length = 0;
+            break;
+        case HTTP_GET:
+            admin_route_get(admin, req, resp);
+            break;
+        case HTTP_POST:
+            admin_run_on_tick_loop(admin, req, resp);
+            break;
+        default:
+            resp->status_code = 404;
+            resp->body = "Not Found";
+            resp->body_length = 9;
+            break;
+    }
+    if (resp->status_code == 0) {
+        /* Endpoint bailed out without filling the response */
+        resp->status_code = 503;
+        resp->content_type = "application/json";
+        resp->body = "{\"error\":\"unavailable\"}";
+        resp->body_length = strlen(resp->body);
+    }
+    return 0;
 }
 
-int admin_handle_request(const struct HttpRequest* req, struct HttpResponse* resp,
-                        const struct Sim* sim, const struct NetworkManager* net_mgr) {
-    (void)req; (void)resp; (void)sim; (void)net_mgr;
-    return 0;  // Simplified
+static int admin_send_all(int fd, const char* data, size_t len) {
+    while (len > 0) {
+        ssize_t n = send(fd, data, len, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        data += n;
+        len -= (size_t)n;
+    }
+    return 0;
 }
 
 int admin_send_response(int client_fd, const struct HttpResponse* resp) {
@@ -1493,28 +1713,188 @@ int admin_send_response(int client_fd, const struct HttpResponse* resp) {
         "Content-Type: %s\r\n"
         "Content-Length: %zu\r\n"
         "Access-Control-Allow-Origin: *\r\n"
-        "Connection: close\r\n"
+        "%s"
+        "Connection: %s\r\n"
         "\r\n",
         resp->status_code,
         resp->status_code == 200 ? "OK" :
         resp->status_code == 204 ? "No Content" :
+        resp->status_code == 400 ? "Bad Request" :
         resp->status_code == 404 ? "Not Found" :
+        resp->status_code == 413 ? "Payload Too Large" :
         resp->status_code == 503 ? "Service Unavailable" : "Internal Server Error",
         resp->content_type ? resp->content_type : "text/plain",
-        resp->body_length
+        resp->body_length,
+        resp->status_code == 204 ?
+            "Access-Control-Allow-Methods: GET, POST, OPTIONS\r\n"
+            "Access-Control-Allow-Headers: Content-Type\r\n"
+            "Access-Control-Max-Age: 86400\r\n" : "",
+        resp->keep_alive ? "keep-alive\r\nKeep-Alive: timeout=5" : "close"
     );
     
     // Send headers
-    send(client_fd, response_buffer, header_len, 0);
+    if (admin_send_all(client_fd, response_buffer, (size_t)header_len) != 0) return -1;
     
     // Send body if present
     if (resp->body && resp->body_length > 0) {
-        send(client_fd, resp->body, resp->body_length, 0);
+        if (admin_send_all(client_fd, resp->body, resp->body_length) != 0) return -1;
     }
     
     return 0;
 }
 
+/* Pull everything currently readable into the client's buffer.
+ * Returns 0 when drained, 1 if the peer closed, -1 on error/oversize. */
+static int admin_client_read(struct AdminClient* client) {
+    const size_t max_capacity = ADMIN_BUFFER_SIZE + ADMIN_MAX_BODY + 1;
+    for (;;) {
+        if (client->request_length + 1 >= client->request_capacity) {
+            if (client->request_capacity >= max_capacity) return -1;
+            size_t cap = client->request_capacity ? client->request_capacity * 2 : ADMIN_BUFFER_SIZE;
+            if (cap > max_capacity) cap = max_capacity;
+            char* grown = realloc(client->request_buffer, cap);
+            if (!grown) return -1;
+            client->request_buffer = grown;
+            client->request_capacity = cap;
+        }
+        ssize_t n = recv(client->socket_fd, client->request_buffer + client->request_length,
+                         client->request_capacity - client->request_length - 1, MSG_DONTWAIT);
+        if (n > 0) {
+            client->request_length += (size_t)n;
+            continue;
+        }
+        if (n == 0) return 1;
+        if (errno == EINTR) continue;
+        if (errno == EAGAIN || errno == EWOULDBLOCK) return 0;
+        return -1;
+    }
+}
+
+/* Answer every complete request buffered on this connection (pipelining). */
+static void admin_client_service(struct AdminServer* admin, struct AdminClient* client, bool peer_closed) {
+    while (client->active && client->request_length > 0) {
+        struct HttpRequest req;
+        struct HttpResponse resp = {0};
+        int pr = admin_parse_request(client->request_buffer, client->request_length, &req);
+        if (pr == 0) break;
+        if (pr < 0) {
+            resp.status_code = client->request_length >= ADMIN_BUFFER_SIZE ? 413 : 400;
+            resp.body = resp.status_code == 413 ? "Payload Too Large" : "Bad Request";
+            resp.body_length = strlen(resp.body);
+            admin_send_response(client->socket_fd, &resp);
+            admin_client_close(client);
+            return;
+        }
+
+        /* Handlers expect a NUL-terminated body; borrow the byte after it */
+        char saved = client->request_buffer[req.total_length];
+        client->request_buffer[req.total_length] = '\0';
+        admin_handle_request(admin, &req, &resp);
+        resp.keep_alive = req.keep_alive && !peer_closed;
+        int sr = admin_send_response(client->socket_fd, &resp);
+        client->request_buffer[req.total_length] = saved;
+        admin->total_requests++;
+
+        size_t rest = client->request_length - req.total_length;
+        memmove(client->request_buffer, client->request_buffer + req.total_length, rest);
+        client->request_length = rest;
+
+        if (sr != 0 || !resp.keep_alive) {
+            admin_client_close(client);
+            return;
+        }
+    }
+    if (peer_closed) admin_client_close(client);
+}
+
+static void admin_accept_clients(struct AdminServer* admin, uint32_t now_ms) {
+    for (;;) {
+        struct sockaddr_in client_addr;
+        socklen_t addr_len = sizeof(client_addr);
+        int fd = accept(admin->socket_fd, (struct sockaddr*)&client_addr, &addr_len);
+        if (fd < 0) return;
+
+        /* Bound blocking sends so a stalled browser can't wedge the thread */
+        struct timeval tv = { .tv_sec = 2, .tv_usec = 0 };
+        setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+
+        struct AdminClient* slot = NULL;
+        for (int i = 0; i < ADMIN_MAX_CLIENTS; i++) {
+            if (!admin->clients[i].active) { slot = &admin->clients[i]; break; }
+        }
+        if (!slot) {
+            struct HttpResponse resp = {0};
+            resp.status_code = 503;
+            resp.body = "Too many admin connections";
+            resp.body_length = strlen(resp.body);
+            admin_send_response(fd, &resp);
+            close(fd);
+            continue;
+        }
+        slot->socket_fd = fd;
+        slot->active = true;
+        slot->request_length = 0;
+        slot->last_activity = now_ms;
+        admin->total_connections++;
+    }
+}
+
+static void* admin_thread_main(void* arg) {
+    struct AdminServer* admin = (struct AdminServer*)arg;
+    struct pollfd fds[1 + ADMIN_MAX_CLIENTS];
+    int slot_of[1 + ADMIN_MAX_CLIENTS];
+
+    for (;;) {
+        pthread_mutex_lock(&admin->mtx);
+        bool running = admin->running;
+        pthread_mutex_unlock(&admin->mtx);
+        if (!running) break;
+
+        int nfds = 0;
+        fds[nfds].fd = admin->socket_fd;
+        fds[nfds].events = POLLIN;
+        fds[nfds].revents = 0;
+        slot_of[nfds++] = -1;
+        for (int i = 0; i < ADMIN_MAX_CLIENTS; i++) {
+            if (!admin->clients[i].active) continue;
+            fds[nfds].fd = admin->clients[i].socket_fd;
+            fds[nfds].events = POLLIN;
+            fds[nfds].revents = 0;
+            slot_of[nfds++] = i;
+        }
+
+        int ready = poll(fds, (nfds_t)nfds, 100);
+        if (ready < 0 && errno != EINTR) {
+            log_error("Admin server poll failed: %s", strerror(errno));
+            break;
+        }
+
+        uint32_t now = get_time_ms();
+        if (ready > 0) {
+            if (fds[0].revents & POLLIN) admin_accept_clients(admin, now);
+            for (int k = 1; k < nfds; k++) {
+                if (!fds[k].revents) continue;
+                struct AdminClient* client = &admin->clients[slot_of[k]];
+                int rr = admin_client_read(client);
+                if (rr < 0) {
+                    admin_client_close(client);
+                    continue;
+                }
+                client->last_activity = now;
+                admin_client_service(admin, client, rr == 1);
+            }
+        }
+
+        for (int i = 0; i < ADMIN_MAX_CLIENTS; i++) {
+            struct AdminClient* client = &admin->clients[i];
+            if (client->active && now - client->last_activity > ADMIN_KEEPALIVE_TIMEOUT_MS) {
+                admin_client_close(client);
+            }
+        }
+    }
+    return NULL;
+}
+
 int admin_serve_dashboard(struct HttpResponse* resp) {
     if (!resp) return -1;
     
@@ -0,0 +1,67 @@
+#include "admin/admin_server.h"
+#include "admin/admin_snapshot.h"
+#include "util/time.h"
+#include <stdlib.h>
+#include <string.h>
+
+extern int tier_player_counts[INPUT_TIER_COUNT];
+
+struct AdminSnapshot* admin_snapshot_create(void) {
+    return calloc(1, sizeof(struct AdminSnapshot));
+}
+
+void admin_snapshot_destroy(struct AdminSnapshot* snap) {
+    free(snap);
+}
+
+/* Runs on the tick loop.  Copies only live entries so the cost follows the
+ * current world size, not the MAX_* capacities. */
+void admin_snapshot_capture(struct AdminSnapshot* snap, const struct Sim* sim) {
+    if (!snap || !sim) return;
+
+    snap->tick = sim->tick;
+    snap->taken_us = get_time_us();
+
+    snap->ship_count = sim->ship_count > MAX_SHIPS ? MAX_SHIPS : sim->ship_count;
+    memcpy(snap->ships, sim->ships, (size_t)snap->ship_count * sizeof(sim->ships[0]));
+    snap->player_count = sim->player_count > MAX_PLAYERS ? MAX_PLAYERS : sim->player_count;
+    memcpy(snap->players, sim->players, (size_t)snap->player_count * sizeof(sim->players[0]));
+    snap->projectile_count = sim->projectile_count > MAX_PROJECTILES ? MAX_PROJECTILES
+                                                                     : sim->projectile_count;
+    memcpy(snap->projectiles, sim->projectiles,
+           (size_t)snap->projectile_count * sizeof(sim->projectiles[0]));
+
+    SimpleShip* ws_ships = NULL;
+    int ws_ship_count = 0;
+    snap->ws_ship_count = 0;
+    if (websocket_server_get_ships(&ws_ships, &ws_ship_count) == 0 && ws_ships) {
+        if (ws_ship_count > MAX_SHIPS) ws_ship_count = MAX_SHIPS;
+        memcpy(snap->ws_ships, ws_ships, (size_t)ws_ship_count * sizeof(ws_ships[0]));
+        snap->ws_ship_count = ws_ship_count;
+    }
+
+    /* websocket_server_get_players returns the full slot table; compact it */
+    WebSocketPlayer* ws_players = NULL;
+    int ws_active = 0;
+    snap->ws_player_count = 0;
+    if (websocket_server_get_players(&ws_players, &ws_active) == 0 && ws_players) {
+        for (int i = 0; i < MAX_PLAYERS && snap->ws_player_count < ws_active; i++) {
+            if (!ws_players[i].active) continue;
+            snap->ws_players[snap->ws_player_count++] = ws_players[i];
+        }
+    }
+
+    snap->ws_stats_ok = websocket_server_get_stats(&snap->ws_stats) == 0;
+    websocket_server_get_perf_snapshot(&snap->perf);
+
+    PlacedStructure* ps = NULL;
+    uint32_t ps_count = 0;
+    snap->structure_count = 0;
+    if (websocket_server_get_placed_structures(&ps, &ps_count) == 0 && ps) {
+        if (ps_count > MAX_PLACED_STRUCTURES) ps_count = MAX_PLACED_STRUCTURES;
+        memcpy(snap->structures, ps, (size_t)ps_count * sizeof(ps[0]));
+        snap->structure_count = ps_count;
+    }
+
+    memcpy(snap->tier_player_counts, tier_player_counts, sizeof(snap->tier_player_counts));
+}
@@ -10,6 +10,10 @@
 #include <stdio.h>
 #include <math.h>
 
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
 // Static helper functions
 static void copy_simulation_state_to_rewind(rewind_simulation_state_t* dest, const void* src);
 static bool raycast_ship_hit(rewind_vec2_t ray_origin, rewind_vec2_t ray_direction, float ray_length,
@@ -347,4 +351,83 @@ static float calculate_max_movement_distance(float delta_time, float max_speed)
     float base_distance = max_speed * delta_time;
     float tolerance_factor = 1.2f; // 20% tolerance
     return base_distance * tolerance_factor;
-}
\ No newline at end of file
+}
+
+// Ship transform history
+
+void rewind_ships_init(rewind_ship_history_t* hist) {
+    hist->head = 0;
+    hist->frames = 0;
+}
+
+void rewind_ships_record(rewind_ship_history_t* hist, uint32_t tick, uint32_t timestamp_ms,
+                         int count, const uint16_t* ids, const float* xs, const float* ys,
+                         const float* rots) {
+    if (count < 0) count = 0;
+    if (count > REWIND_SHIP_MAX) count = REWIND_SHIP_MAX;
+    int f = hist->head;
+    hist->tick[f] = tick;
+    hist->timestamp_ms[f] = timestamp_ms;
+    hist->count[f] = (uint16_t)count;
+    memcpy(hist->id[f], ids, (size_t)count * sizeof(uint16_t));
+    memcpy(hist->x[f], xs, (size_t)count * sizeof(float));
+    memcpy(hist->y[f], ys, (size_t)count * sizeof(float));
+    memcpy(hist->rot[f], rots, (size_t)count * sizeof(float));
+    hist->head = (f + 1) % REWIND_BUFFER_SIZE;
+    if (hist->frames < REWIND_BUFFER_SIZE) hist->frames++;
+}
+
+/* k-th newest frame (0 = newest) */
+static inline int ship_frame(const rewind_ship_history_t* hist, int k) {
+    return (hist->head - 1 - k + 2 * REWIND_BUFFER_SIZE) % REWIND_BUFFER_SIZE;
+}
+
+/* Index of ship_id in frame f, trying `hint` first (ship order rarely changes
+ * between ticks), or -1 */
+static int ship_index(const rewind_ship_history_t* hist, int f, uint16_t ship_id, int hint) {
+    if (hint >= 0 && hint < hist->count[f] && hist->id[f][hint] == ship_id) return hint;
+    const uint16_t* ids = hist->id[f];
+    for (int i = 0, n = hist->count[f]; i < n; i++)
+        if (ids[i] == ship_id) return i;
+    return -1;
+}
+
+bool rewind_ships_sample(const rewind_ship_history_t* hist, uint16_t ship_id, uint32_t target_ms,
+                         float* x, float* y, float* rot) {
+    if (hist->frames == 0) return false;
+
+    // Newest frame at or before target_ms; `newer` is the one after it
+    int k = 0;
+    while (k < hist->frames - 1 && (int32_t)(hist->timestamp_ms[ship_frame(hist, k)] - target_ms) > 0) k++;
+    int older = ship_frame(hist, k);
+    int newer = k > 0 ? ship_frame(hist, k - 1) : -1;
+
+    int io = ship_index(hist, older, ship_id, -1);
+    int in = newer >= 0 ? ship_index(hist, newer, ship_id, io) : -1;
+    if (io < 0 && in < 0) {
+        // Not in the bracketing pair: fall back to the nearest frame that has it
+        for (int j = 0; j < hist->frames && io < 0; j++) {
+            int f = ship_frame(hist, j);
+            int i = ship_index(hist, f, ship_id, -1);
+            if (i >= 0) { older = f; io = i; }
+        }
+        if (io < 0) return false;
+    }
+    if (in < 0 || io < 0) {
+        int f = io >= 0 ? older : newer, i = io >= 0 ? io : in;
+        *x = hist->x[f][i];
+        *y = hist->y[f][i];
+        *rot = hist->rot[f][i];
+        return true;
+    }
+
+    float span = (float)(int32_t)(hist->timestamp_ms[newer] - hist->timestamp_ms[older]);
+    float t = span > 0.0f ? (float)(int32_t)(target_ms - hist->timestamp_ms[older]) / span : 1.0f;
+    if (t < 0.0f) t = 0.0f;
+    if (t > 1.0f) t = 1.0f;
+    float dr = remainderf(hist->rot[newer][in] - hist->rot[older][io], 2.0f * (float)M_PI);
+    *x = hist->x[older][io] + (hist->x[newer][in] - hist->x[older][io]) * t;
+    *y = hist->y[older][io] + (hist->y[newer][in] - hist->y[older][io]) * t;
+    *rot = hist->rot[older][io] + dr * t;
+    return true;
+}
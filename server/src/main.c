@@ -7,6 +7,8 @@
 #include <errno.h>
 #include "server.h"
 #include "sim/world_save.h"
+#include "util/log.h"
+#include "util/profiler.h"
 
 static volatile int running = 1;
 static struct ServerContext* server_ctx = NULL;
@@ -17,6 +19,11 @@ void signal_handler(int sig) {
         world_save(WORLD_SAVE_DEFAULT_PATH);
         return;
     }
+    if (sig == SIGUSR2) {
+        /* Written by the tick loop between ticks — see prof_service_dump_request */
+        prof_request_dump();
+        return;
+    }
     printf("\n🛑 Received signal %d, initiating graceful shutdown...\n", sig);
     running = 0;
     
@@ -70,11 +77,13 @@ int main(int argc, char *argv[]) {
     signal(SIGINT,  signal_handler);
     signal(SIGTERM, signal_handler);
     signal(SIGUSR1, signal_handler);  /* kill -USR1 <pid> to save world */
+    signal(SIGUSR2, signal_handler);  /* kill -USR2 <pid> to dump the tick profiler */
     signal(SIGPIPE, SIG_IGN); // Ignore broken pipe
     
     // Initialize server context
     int result = server_init(&server_ctx);
     if (result != 0) {
+        log_shutdown();
         fprintf(stderr, "Failed to initialize server: %d\n", result);
         return EXIT_FAILURE;
     }
@@ -2,32 +2,32 @@
 #include "net/websocket_server_internal.h"
 #include "core/math.h"
 #include "sim/module_types.h"
+#include "sim/hull_sdf.h"
+#include "sim/ship_flooding.h"
 #include "util/time.h"
 #include "util/log.h"
 #include <math.h>
 #include <stdio.h>
 #include <string.h>
 
-/* Gunport snap positions — must match client GUNPORT_SNAP_POINTS (ship-local px). */
-static const float GUNPORT_SNAP_X[12] = {
-     152.5f,  77.5f,   2.5f, -72.5f, -147.5f, -222.5f,
-     152.5f,  77.5f,   2.5f, -72.5f, -147.5f, -222.5f
-};
-static const float GUNPORT_SNAP_Y[12] = {
-    -90.0f, -90.0f, -90.0f, -90.0f, -90.0f, -90.0f,
-     90.0f,  90.0f,  90.0f,  90.0f,  90.0f,  90.0f
-};
+/* Water level, compartments, hull openings and the well all come from the
+ * per-ship flood rows (sim/ship_flooding.h); only hull-edge distance is
+ * geometry computed here. */
+
+#define DUMP_OPENINGS  (FLOOD_OPENING_PLANK | FLOOD_OPENING_GUNPORT_OPEN)
 
 static float hull_health_pct(const struct Ship* ship) {
     if (!ship) return 100.0f;
     return Q16_TO_FLOAT(ship->hull_health);
 }
 
-static float water_fill(const struct Ship* ship) {
-    float hp = hull_health_pct(ship);
-    if (hp >= 100.0f) return 0.0f;
-    if (hp <= 0.0f)   return 1.0f;
-    return 1.0f - hp / 100.0f;
+/* Bucket water moved between the sea and the hull */
+static void hull_health_add(struct Ship* ship, float amount) {
+    float health = hull_health_pct(ship) + amount;
+    if (health > 100.0f) health = 100.0f;
+    if (health < 0.0f)   health = 0.0f;
+    ship->hull_health = Q16_FROM_FLOAT(health);
+    ship_flooding_touch(ship);
 }
 
 static float dist2d_sq(float ax, float ay, float bx, float by) {
@@ -36,17 +36,6 @@ static float dist2d_sq(float ax, float ay, float bx, float by) {
     return dx * dx + dy * dy;
 }
 
-static void gunport_snap_pos(const ShipModule* mod, float* gx, float* gy) {
-    uint8_t idx = mod->data.gunport.snap_idx;
-    if (idx < 12) {
-        *gx = GUNPORT_SNAP_X[idx];
-        *gy = GUNPORT_SNAP_Y[idx];
-    } else {
-        *gx = SERVER_TO_CLIENT(Q16_TO_FLOAT(mod->local_pos.x));
-        *gy = SERVER_TO_CLIENT(Q16_TO_FLOAT(mod->local_pos.y));
-    }
-}
-
 /** Nearest point on the hull polygon edge to (lx, ly). */
 static void nearest_hull_edge_point(float lx, float ly, const struct Ship* ship,
                                     float* out_x, float* out_y) {
@@ -57,8 +46,11 @@ static void nearest_hull_edge_point(float lx, float ly, const struct Ship* ship,
 
     float best_d_sq = 1e20f;
     float best_x = lx, best_y = ly;
-    for (int i = 0; i < n; i++) {
-        int j = (i + 1) % n;
+    int cn;
+    const uint8_t* cand = hull_sdf_candidates(ship, lx, ly, &cn);
+    for (int k = 0; k < cn; k++) {
+        int j = cand[k];
+        int i = j ? j - 1 : n - 1;
         float ax = SERVER_TO_CLIENT(Q16_TO_FLOAT(ship->hull_vertices[i].x));
         float ay = SERVER_TO_CLIENT(Q16_TO_FLOAT(ship->hull_vertices[i].y));
         float bx = SERVER_TO_CLIENT(Q16_TO_FLOAT(ship->hull_vertices[j].x));
@@ -127,12 +119,14 @@ static bool gunport_set_open(SimpleShip* simple, struct Ship* sim,
             for (uint8_t cms = 0; cms < simple->module_count; cms++) {
                 if (simple->modules[cms].id == sim->modules[cm].id) {
                     simple->modules[cms].local_pos.y = cannon_new_y;
+                    ship_module_grid_invalidate(&simple->module_grid);
                     break;
                 }
             }
             break;
         }
         recalc_ship_mass(simple);
+        ship_flooding_touch(sim);
 
         char gp_bcast[160];
         snprintf(gp_bcast, sizeof(gp_bcast),
@@ -149,6 +143,15 @@ static bool fill_meets_threshold(float fill, float threshold) {
     return fill >= threshold - BUCKET_SCOOP_FILL_GRACE;
 }
 
+/* Compartment a bucket on this deck scoops from */
+static bool scoopable_at(const struct Ship* ship, uint8_t deck_level, bool near_well) {
+    if (deck_level == 0)
+        return ship_flood_scoopable(ship, near_well ? FLOOD_BILGE : FLOOD_LOWER);
+    if (deck_level == 1)
+        return ship_flood_scoopable(ship, FLOOD_UPPER);
+    return false;
+}
+
 bool bucket_player_has_equipped(const WebSocketPlayer* player) {
     if (!player) return false;
     int slot = (int)player->inventory.active_slot;
@@ -167,17 +170,9 @@ bool bucket_player_has_equipped(const WebSocketPlayer* player) {
 }
 
 bool bucket_near_well(const struct Ship* ship, float local_x, float local_y) {
-    if (!ship) return false;
-    for (uint8_t m = 0; m < ship->module_count; m++) {
-        const ShipModule* mod = &ship->modules[m];
-        if (mod->type_id != MODULE_TYPE_WELL) continue;
-        if (mod->deck_id != 0) continue;
-        float wx = SERVER_TO_CLIENT(Q16_TO_FLOAT(mod->local_pos.x));
-        float wy = SERVER_TO_CLIENT(Q16_TO_FLOAT(mod->local_pos.y));
-        if (dist2d(local_x, local_y, wx, wy, BUCKET_PROXIMITY_PX))
-            return true;
-    }
-    return false;
+    float wx, wy;
+    return ship_flood_well(ship, &wx, &wy)
+        && dist2d(local_x, local_y, wx, wy, BUCKET_PROXIMITY_PX);
 }
 
 bool bucket_can_fill_at(WebSocketPlayer* player, struct Ship* ship,
@@ -192,25 +187,11 @@ bool bucket_can_fill_at(WebSocketPlayer* player, struct Ship* ship,
     const SimpleShip* ss = find_ship(player->parent_ship_id);
     if (ss && ss->company_id == COMPANY_GHOST) return false;
 
-    float fill = water_fill(ship);
-    if (fill <= 0.0f) return false;
-
     /* Server-authoritative: deck and well proximity come from player state only. */
     uint8_t auth_deck = player->deck_level;
     bool near_well = (auth_deck == 0
         && bucket_near_well(ship, player->local_x, player->local_y));
-
-    if (auth_deck == 0) {
-        if (near_well)
-            return fill_meets_threshold(fill, BUCKET_WELL_SCOOP_FILL);
-        return fill_meets_threshold(fill, BUCKET_LOWER_SCOOP_FILL);
-    }
-
-    if (auth_deck == 1) {
-        return fill_meets_threshold(fill, BUCKET_UPPER_SCOOP_FILL);
-    }
-
-    return false;
+    return scoopable_at(ship, auth_deck, near_well);
 }
 
 bool bucket_can_fill(WebSocketPlayer* player, struct Ship* ship) {
@@ -218,57 +199,10 @@ bool bucket_can_fill(WebSocketPlayer* player, struct Ship* ship) {
     return bucket_can_fill_at(player, ship, player->deck_level, at_well);
 }
 
-static bool near_open_gunport(const WebSocketPlayer* player, const struct Ship* ship) {
-    for (uint8_t m = 0; m < ship->module_count; m++) {
-        const ShipModule* mod = &ship->modules[m];
-        if (mod->type_id != MODULE_TYPE_GUNPORT) continue;
-        if (!mod->data.gunport.is_open) continue;
-        float gx, gy;
-        gunport_snap_pos(mod, &gx, &gy);
-        if (dist2d(player->local_x, player->local_y, gx, gy, BUCKET_PROXIMITY_PX))
-            return true;
-    }
-    return false;
-}
-
-static bool near_missing_plank(const WebSocketPlayer* player, const struct Ship* ship) {
-    for (uint8_t m = 0; m < ship->module_count; m++) {
-        const ShipModule* mod = &ship->modules[m];
-        if (mod->type_id != MODULE_TYPE_PLANK) continue;
-        if (mod->health > 0) continue; /* intact plank — not a hull opening */
-        float px = SERVER_TO_CLIENT(Q16_TO_FLOAT(mod->local_pos.x));
-        float py = SERVER_TO_CLIENT(Q16_TO_FLOAT(mod->local_pos.y));
-        if (dist2d(player->local_x, player->local_y, px, py, BUCKET_PROXIMITY_PX))
-            return true;
-    }
-    return false;
-}
-
 /** Minimum distance (client px) from a ship-local point to the hull polygon edge. */
 static float dist_to_hull_edge_client(float lx, float ly, const struct Ship* ship) {
-    float min_dist_sq = 1e20f;
-    int n = ship->hull_vertex_count;
-    if (n < 3) return 1e20f;
-    for (int i = 0; i < n; i++) {
-        int j = (i + 1) % n;
-        float ax = SERVER_TO_CLIENT(Q16_TO_FLOAT(ship->hull_vertices[i].x));
-        float ay = SERVER_TO_CLIENT(Q16_TO_FLOAT(ship->hull_vertices[i].y));
-        float bx = SERVER_TO_CLIENT(Q16_TO_FLOAT(ship->hull_vertices[j].x));
-        float by = SERVER_TO_CLIENT(Q16_TO_FLOAT(ship->hull_vertices[j].y));
-        float edx = bx - ax, edy = by - ay;
-        float len_sq = edx * edx + edy * edy;
-        float t = 0.0f;
-        if (len_sq > 1e-10f) {
-            t = ((lx - ax) * edx + (ly - ay) * edy) / len_sq;
-            if (t < 0.0f) t = 0.0f;
-            if (t > 1.0f) t = 1.0f;
-        }
-        float cx = ax + t * edx, cy = ay + t * edy;
-        float ex = lx - cx, ey = ly - cy;
-        float d  = ex * ex + ey * ey;
-        if (d < min_dist_sq) min_dist_sq = d;
-    }
-    return sqrtf(min_dist_sq);
+    if (ship->hull_vertex_count < 3) return 1e20f;
+    return hull_sdf_edge_dist(ship, lx, ly);
 }
 
 static bool near_hull_edge(const WebSocketPlayer* player, const struct Ship* ship) {
@@ -283,9 +217,9 @@ bool bucket_is_valid_dump_zone_at(const WebSocketPlayer* player, const struct Sh
     /* Dump validity is evaluated on the deck the player is actually standing on. */
     if (deck_level != player->deck_level) return false;
     if (deck_level == 1) return near_hull_edge(player, ship);
-    if (deck_level == 0) {
-        return near_open_gunport(player, ship) || near_missing_plank(player, ship);
-    }
+    if (deck_level == 0)
+        return ship_flood_near_opening(ship, player->local_x, player->local_y,
+                                       BUCKET_PROXIMITY_PX, DUMP_OPENINGS, NULL);
     return false;
 }
 
@@ -330,12 +264,8 @@ bool bucket_apply_fill(WebSocketPlayer* player, struct Ship* ship, bool success,
     float scoop_amount = bucket_drain_amount(fill_level);
 
     const SimpleShip* ss = find_ship(player->parent_ship_id);
-    if (!ss || ss->company_id != COMPANY_GHOST) {
-        float health = hull_health_pct(ship);
-        health += scoop_amount;
-        if (health > 100.0f) health = 100.0f;
-        ship->hull_health = Q16_FROM_FLOAT(health);
-    }
+    if (!ss || ss->company_id != COMPANY_GHOST)
+        hull_health_add(ship, scoop_amount);
 
     player->bucket_fill = fill_level;
     player->bucket_cooldown_until_ms = now + BUCKET_FILL_COOLDOWN_MS;
@@ -371,12 +301,8 @@ bool bucket_apply_dump(WebSocketPlayer* player, struct Ship* ship,
     const SimpleShip* ss = find_ship(player->parent_ship_id);
     /* Valid dump: water left the ship when scooped; empty the bucket, hull unchanged.
      * Invalid dump: water spills on deck — return flood to hull by amount (4 full / 2 half). */
-    if ((!ss || ss->company_id != COMPANY_GHOST) && !valid) {
-        float health = hull_health_pct(ship);
-        health -= amount;
-        if (health < 0.0f) health = 0.0f;
-        ship->hull_health = Q16_FROM_FLOAT(health);
-    }
+    if ((!ss || ss->company_id != COMPANY_GHOST) && !valid)
+        hull_health_add(ship, -amount);
 
     player->bucket_fill = 0;
 
@@ -396,46 +322,6 @@ bool bucket_apply_dump(WebSocketPlayer* player, struct Ship* ship,
 
 /* ── NPC bucket bailer helpers ─────────────────────────────────────────────── */
 
-static bool npc_near_open_gunport(float lx, float ly, const struct Ship* ship) {
-    for (uint8_t m = 0; m < ship->module_count; m++) {
-        const ShipModule* mod = &ship->modules[m];
-        if (mod->type_id != MODULE_TYPE_GUNPORT) continue;
-        if (!mod->data.gunport.is_open) continue;
-        float gx, gy;
-        gunport_snap_pos(mod, &gx, &gy);
-        if (dist2d(lx, ly, gx, gy, BUCKET_PROXIMITY_PX)) return true;
-    }
-    return false;
-}
-
-static bool npc_near_closed_gunport(float lx, float ly, const struct Ship* ship,
-                                    uint16_t* out_id) {
-    for (uint8_t m = 0; m < ship->module_count; m++) {
-        const ShipModule* mod = &ship->modules[m];
-        if (mod->type_id != MODULE_TYPE_GUNPORT) continue;
-        if (mod->data.gunport.is_open) continue;
-        float gx, gy;
-        gunport_snap_pos(mod, &gx, &gy);
-        if (dist2d(lx, ly, gx, gy, BUCKET_PROXIMITY_PX)) {
-            if (out_id) *out_id = mod->id;
-            return true;
-        }
-    }
-    return false;
-}
-
-static bool npc_near_missing_plank(float lx, float ly, const struct Ship* ship) {
-    for (uint8_t m = 0; m < ship->module_count; m++) {
-        const ShipModule* mod = &ship->modules[m];
-        if (mod->type_id != MODULE_TYPE_PLANK) continue;
-        if (mod->health > 0) continue;
-        float px = SERVER_TO_CLIENT(Q16_TO_FLOAT(mod->local_pos.x));
-        float py = SERVER_TO_CLIENT(Q16_TO_FLOAT(mod->local_pos.y));
-        if (dist2d(lx, ly, px, py, BUCKET_PROXIMITY_PX)) return true;
-    }
-    return false;
-}
-
 static bool npc_near_hull_edge(float lx, float ly, const struct Ship* ship) {
     return dist_to_hull_edge_client(lx, ly, ship) <= BUCKET_PROXIMITY_PX;
 }
@@ -445,30 +331,17 @@ bool bucket_npc_can_fill(const WorldNpc* npc, const struct Ship* ship) {
     if (npc->bucket_fill > 0) return false;
     if (ship->flags & SHIP_FLAG_SCAFFOLDED) return false;
 
-    float fill = water_fill(ship);
-    if (fill <= 0.0f) return false;
-
     bool near_well = (npc->deck_level == 0
         && bucket_near_well(ship, npc->local_x, npc->local_y));
-
-    if (npc->deck_level == 0) {
-        if (near_well)
-            return fill_meets_threshold(fill, BUCKET_WELL_SCOOP_FILL);
-        return fill_meets_threshold(fill, BUCKET_LOWER_SCOOP_FILL);
-    }
-    if (npc->deck_level == 1) {
-        return fill_meets_threshold(fill, BUCKET_UPPER_SCOOP_FILL);
-    }
-    return false;
+    return scoopable_at(ship, npc->deck_level, near_well);
 }
 
 bool bucket_npc_is_valid_dump_zone(const WorldNpc* npc, const struct Ship* ship) {
     if (!npc || !ship || npc->ship_id == 0) return false;
     if (npc->deck_level == 1) return npc_near_hull_edge(npc->local_x, npc->local_y, ship);
-    if (npc->deck_level == 0) {
-        return npc_near_open_gunport(npc->local_x, npc->local_y, ship)
-            || npc_near_missing_plank(npc->local_x, npc->local_y, ship);
-    }
+    if (npc->deck_level == 0)
+        return ship_flood_near_opening(ship, npc->local_x, npc->local_y,
+                                       BUCKET_PROXIMITY_PX, DUMP_OPENINGS, NULL);
     return false;
 }
 
@@ -479,17 +352,12 @@ void bucket_npc_find_scoop_target(const WorldNpc* npc, const struct Ship* ship,
     *out_deck = npc ? npc->deck_level : 1;
     if (!npc || !ship) return;
 
-    float fill = water_fill(ship);
+    float fill = ship_flood_fill(ship);
 
-    if (fill_meets_threshold(fill, BUCKET_WELL_SCOOP_FILL)) {
-        for (uint8_t m = 0; m < ship->module_count; m++) {
-            const ShipModule* mod = &ship->modules[m];
-            if (mod->type_id != MODULE_TYPE_WELL || mod->deck_id != 0) continue;
-            *out_x = SERVER_TO_CLIENT(Q16_TO_FLOAT(mod->local_pos.x));
-            *out_y = SERVER_TO_CLIENT(Q16_TO_FLOAT(mod->local_pos.y));
-            *out_deck = 0;
-            return;
-        }
+    if (fill_meets_threshold(fill, BUCKET_WELL_SCOOP_FILL)
+        && ship_flood_well(ship, out_x, out_y)) {
+        *out_deck = 0;
+        return;
     }
 
     if (fill_meets_threshold(fill, BUCKET_UPPER_SCOOP_FILL)) {
@@ -523,12 +391,12 @@ void bucket_npc_find_dump_target(const WorldNpc* npc, const struct Ship* ship,
     float best_x = 0.0f, best_y = 0.0f;
     bool found = false;
 
-    for (uint8_t m = 0; m < ship->module_count; m++) {
-        const ShipModule* mod = &ship->modules[m];
-        if (mod->type_id != MODULE_TYPE_GUNPORT) continue;
-        float gx, gy, wx, wy;
-        gunport_snap_pos(mod, &gx, &gy);
-        gunport_stand_pos(gx, gy, &wx, &wy);
+    int n;
+    const FloodOpening* o = ship_flood_openings(ship, &n);
+    for (int k = 0; k < n; k++) {
+        if (o[k].kind == FLOOD_OPENING_PLANK) continue;
+        float wx, wy;
+        gunport_stand_pos(o[k].x, o[k].y, &wx, &wy);
         float d_sq = dist2d_sq(lx, ly, wx, wy);
         if (!found || d_sq < best_d_sq) {
             found = true;
@@ -538,17 +406,14 @@ void bucket_npc_find_dump_target(const WorldNpc* npc, const struct Ship* ship,
         }
     }
 
-    for (uint8_t m = 0; m < ship->module_count; m++) {
-        const ShipModule* mod = &ship->modules[m];
-        if (mod->type_id != MODULE_TYPE_PLANK || mod->health > 0) continue;
-        float px = SERVER_TO_CLIENT(Q16_TO_FLOAT(mod->local_pos.x));
-        float py = SERVER_TO_CLIENT(Q16_TO_FLOAT(mod->local_pos.y));
-        float d_sq = dist2d_sq(lx, ly, px, py);
+    for (int k = 0; k < n; k++) {
+        if (o[k].kind != FLOOD_OPENING_PLANK) continue;
+        float d_sq = dist2d_sq(lx, ly, o[k].x, o[k].y);
         if (!found || d_sq < best_d_sq) {
             found = true;
             best_d_sq = d_sq;
-            best_x = px;
-            best_y = py;
+            best_x = o[k].x;
+            best_y = o[k].y;
         }
     }
 
@@ -568,7 +433,8 @@ bool bucket_npc_try_open_nearby_gunport(WorldNpc* npc, struct Ship* ship) {
     if (!simple) return false;
 
     uint16_t gunport_id = 0;
-    if (!npc_near_closed_gunport(npc->local_x, npc->local_y, ship, &gunport_id))
+    if (!ship_flood_near_opening(ship, npc->local_x, npc->local_y, BUCKET_PROXIMITY_PX,
+                                 FLOOD_OPENING_GUNPORT_SHUT, &gunport_id))
         return false;
 
     if (!gunport_set_open(simple, ship, gunport_id, 1)) return false;
@@ -585,12 +451,8 @@ bool bucket_npc_apply_fill(WorldNpc* npc, struct Ship* ship) {
 
     float scoop_amount = bucket_drain_amount(2u);
     const SimpleShip* ss = find_ship(npc->ship_id);
-    if (!ss || ss->company_id != COMPANY_GHOST) {
-        float health = hull_health_pct(ship);
-        health += scoop_amount;
-        if (health > 100.0f) health = 100.0f;
-        ship->hull_health = Q16_FROM_FLOAT(health);
-    }
+    if (!ss || ss->company_id != COMPANY_GHOST)
+        hull_health_add(ship, scoop_amount);
 
     npc->bucket_fill = 2;
     npc->bucket_cooldown_until_ms = now + BUCKET_FILL_COOLDOWN_MS;
@@ -605,12 +467,8 @@ bool bucket_npc_apply_dump(WorldNpc* npc, struct Ship* ship) {
     bool valid = bucket_npc_is_valid_dump_zone(npc, ship);
 
     const SimpleShip* ss = find_ship(npc->ship_id);
-    if ((!ss || ss->company_id != COMPANY_GHOST) && !valid) {
-        float health = hull_health_pct(ship);
-        health -= amount;
-        if (health < 0.0f) health = 0.0f;
-        ship->hull_health = Q16_FROM_FLOAT(health);
-    }
+    if ((!ss || ss->company_id != COMPANY_GHOST) && !valid)
+        hull_health_add(ship, -amount);
 
     npc->bucket_fill = 0;
     return true;
@@ -19,10 +19,15 @@
 #include "net/cannon_fire.h"
 #include "net/npc_agents.h"
 #include "net/npc_world.h"
+#include "net/crew_jobs.h"
 #include "net/module_interactions.h"
 #include "net/dock_physics.h"
+#include "net/structure_index.h"
+#include "net/harvesting.h"
+#include "net/hazard_grid.h"
 #include "sim/island.h"
 #include "util/time.h"
+#include "util/metrics.h"
 
 int parse_json_uint32_array(const char* json, const char* key, uint32_t* out, int max_out) {
     // Build search pattern: "key":[
@@ -105,6 +110,7 @@ void handle_cannon_group_config(WebSocketPlayer* player, int group_index,
     for (int i = 0; i < valid_count; i++) {
         group->weapon_ids[i] = valid_ids[i];
     }
+    weapon_groups_changed(ship);
     group->target_ship_id = (mode == WEAPON_GROUP_MODE_TARGETFIRE) ? target_ship_id : 0;
 
     /* Apply current group gunport state to newly assigned cannons.
@@ -177,8 +183,30 @@ WeaponGroup* find_weapon_group(uint16_t ship_id, uint32_t cannon_id, uint8_t com
     SimpleShip* ship = find_ship(ship_id);
     if (!ship) return NULL;
     uint8_t cid = (company_id < MAX_COMPANIES) ? company_id : 0;
+
+    /* Rebuild the MID_OFFSET → group index after any edit.  Lowest group
+     * wins, matching the order of the scan below. */
+    if (!ship->weapon_group_index_valid) {
+        memset(ship->weapon_group_by_mid, 0, sizeof(ship->weapon_group_by_mid));
+        for (int co = 0; co < MAX_COMPANIES; co++) {
+            for (int g = MAX_WEAPON_GROUPS - 1; g >= 0; g--) {
+                WeaponGroup* grp = &ship->weapon_groups[co][g];
+                for (int c = 0; c < grp->weapon_count; c++)
+                    ship->weapon_group_by_mid[co][MID_OFFSET(grp->weapon_ids[c])] = (uint8_t)(g + 1);
+            }
+        }
+        ship->weapon_group_index_valid = true;
+    }
+
+    uint8_t slot = ship->weapon_group_by_mid[cid][MID_OFFSET(cannon_id)];
+    if (slot == 0) return NULL;
+    WeaponGroup* grp = &ship->weapon_groups[cid][slot - 1];
+    for (int c = 0; c < grp->weapon_count; c++) {
+        if (grp->weapon_ids[c] == cannon_id) return grp;
+    }
+    /* Offset collision with a stale ship_seq — fall back to the full scan */
     for (int g = 0; g < MAX_WEAPON_GROUPS; g++) {
-        WeaponGroup* grp = &ship->weapon_groups[cid][g];
+        grp = &ship->weapon_groups[cid][g];
         for (int c = 0; c < grp->weapon_count; c++) {
             if (grp->weapon_ids[c] == cannon_id) return grp;
         }
@@ -186,6 +214,10 @@ WeaponGroup* find_weapon_group(uint16_t ship_id, uint32_t cannon_id, uint8_t com
     return NULL;
 }
 
+void weapon_groups_changed(SimpleShip* ship) {
+    if (ship) ship->weapon_group_index_valid = false;
+}
+
 void tick_ship_weapon_groups(void) {
     for (int si = 0; si < ship_count; si++) {
         SimpleShip* ship = &ships[si];
@@ -359,7 +391,7 @@ void handle_cannon_aim(WebSocketPlayer* player, float aim_angle,
                 if (in_sector) {
                     ShipModule* smod = find_module_on_ship(ship, cannon->id);
                     if (smod) {
-                        smod->state_bits |= MODULE_STATE_NEEDED;
+                        crew_jobs_weapon_needed(ship, smod);
                         uint32_t now = get_time_ms();
                         for (int mi = 0; mi < ship->module_count; mi++) {
                             if (ship->modules[mi].id == cannon->id) {
@@ -434,16 +466,7 @@ void handle_cannon_aim(WebSocketPlayer* player, float aim_angle,
         // When the player is directly mounted on this cannon (at_cannon), they ARE the occupant.
         bool cannon_has_occupant = (cannon->state_bits & MODULE_STATE_OCCUPIED) != 0 || at_cannon;
         if (!cannon_has_occupant) {
-            for (int ni = 0; ni < world_npc_count; ni++) {
-                WorldNpc* wnpc = &world_npcs[ni];
-                if (wnpc->active && wnpc->role == NPC_ROLE_GUNNER &&
-                    wnpc->ship_id == ship->ship_id &&
-                    wnpc->assigned_weapon_id == cannon->id &&
-                    wnpc->state == WORLD_NPC_STATE_AT_GUN) {
-                    cannon_has_occupant = true;
-                    break;
-                }
-            }
+            if (npc_gunner_at(ship, cannon->id)) cannon_has_occupant = true;
         }
         if (!cannon_has_occupant) {
             continue;
@@ -569,7 +592,7 @@ void handle_cannon_aim(WebSocketPlayer* player, float aim_angle,
                 if (fabsf(diff) <= SWIVEL_NEEDED_RANGE) {
                     ShipModule* ssw = find_module_on_ship(ship, sw->id);
                     if (ssw) {
-                        ssw->state_bits |= MODULE_STATE_NEEDED;
+                        crew_jobs_weapon_needed(ship, ssw);
                         uint32_t now = get_time_ms();
                         for (int mi = 0; mi < ship->module_count; mi++) {
                             if (ship->modules[mi].id == sw->id) {
@@ -611,16 +634,7 @@ void handle_cannon_aim(WebSocketPlayer* player, float aim_angle,
          * A WorldNpc in WORLD_NPC_STATE_AT_GUN counts as present. */
         {
             bool swivel_has_occupant = false;
-            for (int ni = 0; ni < world_npc_count; ni++) {
-                WorldNpc* wnpc = &world_npcs[ni];
-                if (wnpc->active && wnpc->role == NPC_ROLE_GUNNER &&
-                    wnpc->ship_id == ship->ship_id &&
-                    wnpc->assigned_weapon_id == sw->id &&
-                    wnpc->state == WORLD_NPC_STATE_AT_GUN) {
-                    swivel_has_occupant = true;
-                    break;
-                }
-            }
+            if (npc_gunner_at(ship, sw->id)) swivel_has_occupant = true;
             if (!swivel_has_occupant) continue;
         }
 
@@ -669,7 +683,7 @@ void fire_cannon(SimpleShip* ship, ShipModule* cannon, WebSocketPlayer* player,
             if (ship->modules[_fi].id == cannon->id) {
                 ship->cannon_last_fire_ms[_fi] = now;
                 ship->cannon_last_needed_ms[_fi] = now;
-                ship->modules[_fi].state_bits |= MODULE_STATE_NEEDED;
+                crew_jobs_weapon_needed(ship, &ship->modules[_fi]);
                 break;
             }
         }
@@ -814,6 +828,8 @@ void fire_cannon(SimpleShip* ship, ShipModule* cannon, WebSocketPlayer* player,
 #define FLAME_RETREAT_SPEED 700.0f  /* px/s — retreat 2× faster than advance */
 /* FIRE_DURATION_MS now defined in cannon_fire.h */
 #define FLAME_HALF_CONE_MODULE (25.0f * (float)(M_PI / 180.0f)) /* wider test vs ±15° entity cone */
+#define FLAME_ENTITY_MARGIN 30.0f   /* walkers this far past the front still catch */
+#define FLAME_MODULE_MARGIN 40.0f   /* modules / deck zones likewise               */
 
 typedef struct {
     bool     active;
@@ -828,6 +844,7 @@ typedef struct {
 } FlameWave;
 
 static FlameWave  flame_waves[MAX_FLAME_WAVES];
+_Static_assert(MAX_FLAME_WAVES <= HAZARD_MAX_SOURCES, "every flame wave needs a hazard grid bit");
 static bool       flame_waves_initialized = false;
 
 /** Broadcast a raw JSON string to every connected WebSocket client. */
@@ -957,11 +974,8 @@ void handle_cannon_force_reload(WebSocketPlayer* player, uint8_t new_ammo_type)
 
     /* ── Island cannon path ── */
     if (player->parent_ship_id == 0 && player->mounted_cannon_structure_id != 0) {
-        for (uint32_t si = 0; si < placed_structure_count; si++) {
-            PlacedStructure* str = &placed_structures[si];
-            if (!str->active) continue;
-            if (str->id != player->mounted_cannon_structure_id) continue;
-
+        PlacedStructure* str = structure_by_id(player->mounted_cannon_structure_id);
+        if (str) {
             str->cannon_loaded_ammo = new_ammo_type;
             str->cannon_reload_ms   = (uint32_t)CANNON_RELOAD_TIME_MS;
 
@@ -1014,6 +1028,54 @@ void handle_cannon_force_reload(WebSocketPlayer* player, uint8_t new_ammo_type)
              player->player_id, reloaded, ship->ship_id);
 }
 
+/* Lag-compensated hit-scan, exported on GET /metrics */
+static struct {
+    metric_id validate;
+    metric_id rewind;
+} g_lag_metrics;
+
+void cannon_fire_init(void) {
+    if (g_lag_metrics.validate) return;   /* Already registered */
+    static const uint64_t validate_bounds_us[] = { 1, 2, 5, 10, 20, 50, 100, 250, 1000 };
+    g_lag_metrics.validate = metrics_histogram("pirate_hitscan_validate_seconds",
+        "Per-shot cost of resolving a lag-compensated hit-scan volley.", NULL,
+        validate_bounds_us, (int)(sizeof(validate_bounds_us) / sizeof(validate_bounds_us[0])), 1e-6);
+    static const uint64_t rewind_bounds_ms[] = { 100, 125, 150, 200, 250, 300, 350 };
+    g_lag_metrics.rewind = metrics_histogram("pirate_hitscan_rewind_seconds",
+        "How far back hit-scan targets were rewound for the shooter's view.", NULL,
+        rewind_bounds_ms, (int)(sizeof(rewind_bounds_ms) / sizeof(rewind_bounds_ms[0])), 1e-3);
+}
+
+/* The last ship rewound for a hit-scan volley; crews are stored ship by
+ * ship, so one history sample usually serves a whole deck. */
+typedef struct {
+    uint16_t ship_id;
+    bool     found;
+    float    x, y, cos_r, sin_r;
+} RewoundShip;
+
+/* Where the shooter saw a target: its deck position on the ship's rewound
+ * transform if it stands on one, else (and for ships with no history) its
+ * current position.  The shooter's own ship is never rewound — it is where
+ * the client predicts it. */
+static void hitscan_target_pos(RewoundShip* rs, uint32_t view_ms, uint16_t ship_id,
+                               float local_x, float local_y, float cur_x, float cur_y,
+                               float* out_x, float* out_y) {
+    *out_x = cur_x;
+    *out_y = cur_y;
+    if (ship_id == 0) return;
+    if (rs->ship_id != ship_id) {
+        float rot = 0.0f;
+        rs->ship_id = ship_id;
+        rs->found = lag_comp_ship_at(ship_id, view_ms, &rs->x, &rs->y, &rot);
+        rs->cos_r = cosf(rot);
+        rs->sin_r = sinf(rot);
+    }
+    if (!rs->found) return;
+    *out_x = rs->x + local_x * rs->cos_r - local_y * rs->sin_r;
+    *out_y = rs->y + local_x * rs->sin_r + local_y * rs->cos_r;
+}
+
 /**
  * Fire the swivel gun a player is currently mounted to.
  *
@@ -1040,7 +1102,7 @@ void fire_swivel(SimpleShip* ship, ShipModule* sw, ShipModule* gsw,
             if (ship->modules[_sfi].id == sw->id) {
                 ship->cannon_last_fire_ms[_sfi]   = now_sw;
                 ship->cannon_last_needed_ms[_sfi] = now_sw;
-                ship->modules[_sfi].state_bits   |= MODULE_STATE_NEEDED;
+                crew_jobs_weapon_needed(ship, &ship->modules[_sfi]);
                 break;
             }
         }
@@ -1094,12 +1156,21 @@ void fire_swivel(SimpleShip* ship, ShipModule* sw, ShipModule* gsw,
             broadcast_cannon_fire(sw->id, ship->ship_id, muzzle_x, muzzle_y, angle, 0, PROJ_TYPE_GRAPESHOT);
         }
 
+        /* Targets are tested where the shooter saw them: rewound by its
+         * half-RTT plus the client interpolation delay (see lag_comp_view_ms) */
+        uint64_t scan_t0 = get_time_us();
+        uint32_t view_ms = lag_comp_view_ms(player);
+        RewoundShip rs = {0};
+
         /* Scan NPCs */
         for (int ni = 0; ni < world_npc_count; ni++) {
             WorldNpc* npc = &world_npcs[ni];
             if (!npc->active) continue;
             if (npc->ship_id == ship->ship_id) continue; /* friendly */
-            float dx = npc->x - muzzle_x, dy = npc->y - muzzle_y;
+            float tx, ty;
+            hitscan_target_pos(&rs, view_ms, npc->ship_id, npc->local_x, npc->local_y,
+                               npc->x, npc->y, &tx, &ty);
+            float dx = tx - muzzle_x, dy = ty - muzzle_y;
             float dist = sqrtf(dx*dx + dy*dy);
             if (dist > GRAPE_RANGE) continue;
             /* Lower-deck crew are shielded by an intact upper deck. */
@@ -1138,7 +1209,10 @@ void fire_swivel(SimpleShip* ship, ShipModule* sw, ShipModule* gsw,
         for (int wpi = 0; wpi < WS_MAX_CLIENTS; wpi++) {
             WebSocketPlayer* wp = &players[wpi];
             if (!wp->active || wp->parent_ship_id == ship->ship_id) continue;
-            float dx = wp->x - muzzle_x, dy = wp->y - muzzle_y;
+            float tx, ty;
+            hitscan_target_pos(&rs, view_ms, wp->parent_ship_id, wp->local_x, wp->local_y,
+                               wp->x, wp->y, &tx, &ty);
+            float dx = tx - muzzle_x, dy = ty - muzzle_y;
             float dist = sqrtf(dx*dx + dy*dy);
             if (dist > GRAPE_RANGE) continue;
             /* Lower-deck players are shielded by an intact upper deck. */
@@ -1173,6 +1247,10 @@ void fire_swivel(SimpleShip* ship, ShipModule* sw, ShipModule* gsw,
             }
         }
 
+        /* Hit messages and deaths are included: they are part of the per-shot cost */
+        metrics_observe(g_lag_metrics.validate, get_time_us() - scan_t0);
+        metrics_observe(g_lag_metrics.rewind, get_time_ms() - view_ms);
+
         log_info("Swivel %u fired GRAPESHOT (hit-scan) on ship %u", sw->id, ship->ship_id);
     } else if (ammo_type == PROJ_TYPE_LIQUID_FLAME) {
         /* ── Flamethrower wave: register / refresh this swivel's wave entry ──────
@@ -1403,16 +1481,7 @@ void handle_cannon_fire(WebSocketPlayer* player, bool fire_all, uint8_t ammo_typ
         /* ── Swivel branch: only fires when an NPC gunner is physically at the station ── */
         if (module->type_id == MODULE_TYPE_SWIVEL) {
             bool swivel_occupied = false;
-            for (int wn = 0; wn < world_npc_count; wn++) {
-                WorldNpc* wnpc = &world_npcs[wn];
-                if (wnpc->active && wnpc->role == NPC_ROLE_GUNNER &&
-                    wnpc->ship_id == ship->ship_id &&
-                    wnpc->assigned_weapon_id == module->id &&
-                    wnpc->state == WORLD_NPC_STATE_AT_GUN) {
-                    swivel_occupied = true;
-                    break;
-                }
-            }
+            if (npc_gunner_at(ship, module->id)) swivel_occupied = true;
             if (!swivel_occupied) continue;
             /* Find SimpleShip copy for timer check and fire_swivel() */
             ShipModule* sw = find_module_by_id(ship, module->id);
@@ -1482,16 +1551,7 @@ void handle_cannon_fire(WebSocketPlayer* player, bool fire_all, uint8_t ammo_typ
             }
             // Check if a WorldNpc gunner is stationed here
             if (!cannon_occupied) {
-                for (int wn = 0; wn < world_npc_count; wn++) {
-                    WorldNpc* wnpc = &world_npcs[wn];
-                    if (wnpc->active && wnpc->role == NPC_ROLE_GUNNER &&
-                        wnpc->ship_id == ship->ship_id &&
-                        wnpc->assigned_weapon_id == module->id &&
-                        wnpc->state == WORLD_NPC_STATE_AT_GUN) {
-                        cannon_occupied = true;
-                        break;
-                    }
-                }
+                if (npc_gunner_at(ship, module->id)) cannon_occupied = true;
             }
             if (!cannon_occupied) {
                 // log_info("  ⏭️  Cannon %u: No crew mounted — skipping", module->id);
@@ -1558,228 +1618,262 @@ void handle_cannon_fire(WebSocketPlayer* player, bool fire_all, uint8_t ammo_typ
              skip_aim_check ? "/FREEFIRE" : "");
 }
 
+/* Exact flame-front test: (x, y) is no more than `margin` px past the wave
+ * front and inside the cone whose half-angle has cosine cos_half. */
+static bool flame_reaches(const HazardSource* h, const FlameWave* fw,
+                          float margin, float cos_half, float x, float y) {
+    float dx = x - h->ox, dy = y - h->oy;
+    float dist = sqrtf(dx*dx + dy*dy);
+    if (dist > fw->wave_dist + margin) return false;
+    float dot = (dist > 0.01f) ? (dx/dist*h->dir_x + dy/dist*h->dir_y) : 1.0f;
+    return dot >= cos_half;
+}
+
+/* Does any flame source in `mask` not fired from ship `own_ship` reach a
+ * walker at (x, y)?  An intact plank on the walker's own ship between the
+ * flame origin and the walker shields them. */
+static bool flame_hits_walker(uint32_t mask, uint32_t own_ship, float x, float y, float cos_hc) {
+    SimpleShip* own = NULL;
+    bool looked_up = false;
+    for (; mask; mask &= mask - 1) {
+        const HazardSource* h = hazard_grid_source((uint32_t)__builtin_ctz(mask));
+        if (h->kind != HAZARD_FLAME) continue;
+        const FlameWave* fw = &flame_waves[h->owner];
+        if (own_ship == fw->ship_id) continue;
+        if (!flame_reaches(h, fw, FLAME_ENTITY_MARGIN, cos_hc, x, y)) continue;
+        if (!looked_up) { own = find_ship_by_id(own_ship); looked_up = true; }
+        if (own && plank_occludes_ray(own, h->ox, h->oy, x, y)) continue;
+        return true;
+    }
+    return false;
+}
+
+/* Wooden modules — any ship (including firing ship; fire doesn't pick sides).
+ * Each module samples the hazard grid at its centre (decks: at each of the 3
+ * zone centres), so ships nowhere near a flame cost one probe per module. */
+static void flame_ignite_modules(float cos_hc_mod) {
+    for (int s = 0; s < ship_count; s++) {
+        if (!ships[s].active) continue;
+        SimpleShip* fship = &ships[s];
+        float cos_r = cosf(fship->rotation);
+        float sin_r = sinf(fship->rotation);
+        struct Ship* fsim = NULL;
+        bool fsim_looked_up = false;
+        for (int m = 0; m < fship->module_count; m++) {
+            ShipModule* mod = &fship->modules[m];
+            ModuleTypeId mt = mod->type_id;
+            if (mt != MODULE_TYPE_PLANK && mt != MODULE_TYPE_DECK &&
+                mt != MODULE_TYPE_MAST) continue;
+            if (mod->state_bits & MODULE_STATE_DESTROYED) continue;
+            /* Compute world-space module position for the flame check.
+             * Deck modules use per-zone ignition; other modules use their centre. */
+            float wx, wy;
+            int hits = 0;     /* flame waves reaching this module this tick */
+            float dist = 0.0f, wave = 0.0f;
+            if (mt == MODULE_TYPE_DECK) {
+                /* Test each of the 3 deck zone centres independently.
+                 * Zone 0 = bow (+160 client), 1 = mid, 2 = stern (-160 client).
+                 * Bits 11-13 are set for each zone that the flame reaches.
+                 * A zone is not ignited if an intact plank on fship lies between
+                 * the flame origin and the zone centre (plank-occlusion rule). */
+                const float zone_lx3[3] = { 160.0f, 0.0f, -160.0f };
+                for (int z = 0; z < 3; z++) {
+                    float z_wx = fship->x + zone_lx3[z] * cos_r;
+                    float z_wy = fship->y + zone_lx3[z] * sin_r;
+                    for (uint32_t mask = hazard_grid_sample(z_wx, z_wy); mask; mask &= mask - 1) {
+                        const HazardSource* h = hazard_grid_source((uint32_t)__builtin_ctz(mask));
+                        if (h->kind != HAZARD_FLAME) continue;
+                        const FlameWave* fw = &flame_waves[h->owner];
+                        if (!flame_reaches(h, fw, FLAME_MODULE_MARGIN, cos_hc_mod, z_wx, z_wy)) continue;
+                        /* Skip if an intact plank blocks flame→zone centre */
+                        if (plank_occludes_ray(fship, h->ox, h->oy, z_wx, z_wy)) continue;
+                        mod->state_bits |= (uint16_t)(1u << (11 + z));
+                        wave = fw->wave_dist;
+                        hits++;
+                    }
+                }
+                if (hits == 0) continue;
+                /* Use ship centre for FIRE_EFFECT position broadcast */
+                wx = fship->x; wy = fship->y;
+            } else {
+                float lx = SERVER_TO_CLIENT(Q16_TO_FLOAT(mod->local_pos.x));
+                float ly = SERVER_TO_CLIENT(Q16_TO_FLOAT(mod->local_pos.y));
+                wx = fship->x + (lx * cos_r - ly * sin_r);
+                wy = fship->y + (lx * sin_r + ly * cos_r);
+                for (uint32_t mask = hazard_grid_sample(wx, wy); mask; mask &= mask - 1) {
+                    const HazardSource* h = hazard_grid_source((uint32_t)__builtin_ctz(mask));
+                    if (h->kind != HAZARD_FLAME) continue;
+                    const FlameWave* fw = &flame_waves[h->owner];
+                    if (!flame_reaches(h, fw, FLAME_MODULE_MARGIN, cos_hc_mod, wx, wy)) continue;
+                    /* Sail fiber plank occlusion: skip if an intact plank
+                     * lies between the flame origin and the mast centre. */
+                    if (mt == MODULE_TYPE_MAST &&
+                        plank_occludes_ray(fship, h->ox, h->oy, wx, wy))
+                        continue;
+                    float dx = wx - h->ox, dy = wy - h->oy;
+                    dist = sqrtf(dx*dx + dy*dy);
+                    wave = fw->wave_dist;
+                    hits++;
+                }
+                if (hits == 0) continue;
+            }
+            /* Sail fiber ignition: boost intensity on each flame contact */
+            if (mt == MODULE_TYPE_MAST) {
+                int ni = (int)mod->data.mast.sail_fire_intensity + 25 * hits;
+                if (ni > 100) ni = 100;
+                mod->data.mast.sail_fire_intensity = (uint8_t)ni;
+            }
+            bool first = (mod->fire_timer_ms == 0);
+            mod->fire_timer_ms = FIRE_DURATION_MS;
+            if (global_sim) {
+                if (!fsim_looked_up) { fsim = find_sim_ship(fship->ship_id); fsim_looked_up = true; }
+                if (fsim) {
+                    for (uint8_t mi = 0; mi < fsim->module_count; mi++) {
+                        if (fsim->modules[mi].id == mod->id) {
+                            fsim->modules[mi].fire_timer_ms = FIRE_DURATION_MS;
+                            fsim->modules[mi].state_bits    = mod->state_bits;
+                            if (mod->type_id == MODULE_TYPE_MAST)
+                                fsim->modules[mi].data.mast.sail_fire_intensity =
+                                    mod->data.mast.sail_fire_intensity;
+                            break;
+                        }
+                    }
+                }
+            }
+            /* Always broadcast FIRE_EFFECT — refreshes client timer on every
+               flame contact, preventing client/server desync where client timer
+               expires while server keeps module burning. */
+            log_info("🔥 Module %u (ship %u type %d) %s by flame wave (dist=%.1f wave=%.1f)",
+                     mod->id, fship->ship_id, (int)mt,
+                     first ? "ignited" : "re-ignited", dist, wave);
+            {
+                char fmsg[256];
+                snprintf(fmsg, sizeof(fmsg),
+                    "{\"type\":\"FIRE_EFFECT\",\"entityType\":\"module\","
+                    "\"shipId\":%u,\"moduleId\":%u,"
+                    "\"x\":%.1f,\"y\":%.1f,\"durationMs\":%u}",
+                    fship->ship_id, mod->id, wx, wy, FIRE_DURATION_MS);
+                broadcast_json_all(fmsg);
+            }
+        }
+    }
+}
+
 /**
  * Advance all active flamethrower waves, apply fire to newly-reached targets,
  * and broadcast the current wave state to clients.
  * Called every cannon-update tick (every 100 ms).
+ *
+ * Advancing waves are stamped into the hazard grid first; NPCs, players and
+ * modules then each sample it once, so overlapping waves cost one pass over
+ * the entities rather than one per wave.  An entity reached by several waves
+ * in a tick is ignited (and broadcast) once.
  */
 void update_flame_waves(uint32_t time_elapsed) {
-        if (flame_waves_initialized) {
-            const float cos_hc = cosf(FLAME_HALF_CONE);
-            const float dt_s   = (float)time_elapsed / 1000.0f;
-            for (int fi = 0; fi < MAX_FLAME_WAVES; fi++) {
-                FlameWave* fw = &flame_waves[fi];
-                if (!fw->active) continue;
-
-                /* Check staleness — start retreating if no pulse for > FLAME_STALE_MS */
-                uint32_t now_fw2 = get_time_ms();
-                if (!fw->retreating && (now_fw2 - fw->last_fire_ms) > FLAME_STALE_MS) {
-                    fw->retreating   = true;
-                    fw->retreat_dist = 0.0f;
-                }
+    if (!flame_waves_initialized) return;
+    const float cos_hc = cosf(FLAME_HALF_CONE);
+    const float dt_s   = (float)time_elapsed / 1000.0f;
+    uint32_t now_fw2   = get_time_ms();
+
+    /* ── Advance / retreat every wave; stamp the advancing ones ── */
+    hazard_grid_clear();
+    for (int fi = 0; fi < MAX_FLAME_WAVES; fi++) {
+        FlameWave* fw = &flame_waves[fi];
+        if (!fw->active) continue;
+
+        /* Check staleness — start retreating if no pulse for > FLAME_STALE_MS */
+        if (!fw->retreating && (now_fw2 - fw->last_fire_ms) > FLAME_STALE_MS) {
+            fw->retreating   = true;
+            fw->retreat_dist = 0.0f;
+        }
 
-                /* Advance leading edge */
-                if (!fw->retreating) {
-                    fw->wave_dist += dt_s * FLAME_WAVE_SPEED;
-                    if (fw->wave_dist > FLAME_RANGE) fw->wave_dist = FLAME_RANGE;
-                }
+        /* Advance leading edge */
+        if (!fw->retreating) {
+            fw->wave_dist += dt_s * FLAME_WAVE_SPEED;
+            if (fw->wave_dist > FLAME_RANGE) fw->wave_dist = FLAME_RANGE;
+        }
 
-                /* Advance retreat front — faster than advance so flame snaps off */
-                if (fw->retreating) {
-                    fw->retreat_dist += dt_s * FLAME_RETREAT_SPEED;
-                    if (fw->retreat_dist >= FLAME_RANGE) {
-                        /* Fully retreated — deactivate */
-                        fw->active = false;
-                        char dead_msg[128];
-                        snprintf(dead_msg, sizeof(dead_msg),
-                            "{\"type\":\"FLAME_WAVE_UPDATE\",\"cannonId\":%u,\"dead\":true}",
-                            fw->swivel_id);
-                        broadcast_json_all(dead_msg);
-                        continue;
-                    }
-                }
+        /* Advance retreat front — faster than advance so flame snaps off */
+        if (fw->retreating) {
+            fw->retreat_dist += dt_s * FLAME_RETREAT_SPEED;
+            if (fw->retreat_dist >= FLAME_RANGE) {
+                /* Fully retreated — deactivate */
+                fw->active = false;
+                char dead_msg[128];
+                snprintf(dead_msg, sizeof(dead_msg),
+                    "{\"type\":\"FLAME_WAVE_UPDATE\",\"cannonId\":%u,\"dead\":true}",
+                    fw->swivel_id);
+                broadcast_json_all(dead_msg);
+                continue;
+            }
+        }
 
-                /* ── Apply fire to targets within the leading wave front ── */
-                if (!fw->retreating) {
-                    float fdir_x = cosf(fw->fire_angle);
-                    float fdir_y = sinf(fw->fire_angle);
-
-                    /* NPCs */
-                    for (int ni = 0; ni < world_npc_count; ni++) {
-                        WorldNpc* npc = &world_npcs[ni];
-                        if (!npc->active) continue;
-                        if (npc->ship_id == fw->ship_id) continue;
-                        if (npc->in_water) continue; /* NPC is in water */
-                        float dx = npc->x - fw->origin_x, dy = npc->y - fw->origin_y;
-                        float dist = sqrtf(dx*dx + dy*dy);
-                        if (dist > fw->wave_dist + 30.0f) continue;
-                        float dot = (dist > 0.01f) ? (dx/dist*fdir_x + dy/dist*fdir_y) : 1.0f;
-                        if (dot < cos_hc) continue;
-                        /* Plank-occlusion check: if an intact plank on the NPC's own ship lies
-                         * between the flame origin and the NPC, the plank shields them. */
-                        {
-                            SimpleShip* npc_ship = find_ship_by_id(npc->ship_id);
-                            if (npc_ship && plank_occludes_ray(npc_ship, fw->origin_x, fw->origin_y,
-                                                               npc->x, npc->y)) continue;
-                        }
-                        npc->fire_timer_ms = FIRE_DURATION_MS;
-                        {
-                            char fmsg[256];
-                            snprintf(fmsg, sizeof(fmsg),
-                                "{\"type\":\"FIRE_EFFECT\",\"entityType\":\"npc\",\"id\":%u,"
-                                "\"x\":%.1f,\"y\":%.1f,\"durationMs\":%u}",
-                                npc->id, npc->x, npc->y, FIRE_DURATION_MS);
-                            broadcast_json_all(fmsg);
-                        }
-                    }
+        /* Footprint: the wider module cone out to the farthest margin */
+        if (!fw->retreating)
+            hazard_grid_add_cone(HAZARD_FLAME, (uint32_t)fi, fw->origin_x, fw->origin_y,
+                                 fw->fire_angle, FLAME_HALF_CONE_MODULE,
+                                 fw->wave_dist + FLAME_MODULE_MARGIN);
+    }
 
-                    /* Players */
-                    for (int wpi = 0; wpi < WS_MAX_CLIENTS; wpi++) {
-                        WebSocketPlayer* wp = &players[wpi];
-                        if (!wp->active) continue;
-                        if (wp->parent_ship_id == fw->ship_id) continue;
-                        if (wp->movement_state == PLAYER_STATE_SWIMMING) continue; /* player is in water */
-                        float dx = wp->x - fw->origin_x, dy = wp->y - fw->origin_y;
-                        float dist = sqrtf(dx*dx + dy*dy);
-                        if (dist > fw->wave_dist + 30.0f) continue;
-                        float dot = (dist > 0.01f) ? (dx/dist*fdir_x + dy/dist*fdir_y) : 1.0f;
-                        if (dot < cos_hc) continue;
-                        /* Same plank-occlusion check for players as for NPCs */
-                        {
-                            SimpleShip* pl_ship = find_ship_by_id(wp->parent_ship_id);
-                            if (pl_ship && plank_occludes_ray(pl_ship, fw->origin_x, fw->origin_y,
-                                                              wp->x, wp->y)) continue;
-                        }
-                        wp->fire_timer_ms = FIRE_DURATION_MS;
-                        {
-                            char fmsg[256];
-                            snprintf(fmsg, sizeof(fmsg),
-                                "{\"type\":\"FIRE_EFFECT\",\"entityType\":\"player\",\"id\":%u,"
-                                "\"x\":%.1f,\"y\":%.1f,\"durationMs\":%u}",
-                                wp->player_id, wp->x, wp->y, FIRE_DURATION_MS);
-                            broadcast_json_all(fmsg);
-                        }
-                    }
+    /* ── Apply fire to targets within the leading wave fronts ── */
+    if (hazard_grid_source_count() > 0) {
+        /* NPCs */
+        for (int ni = 0; ni < world_npc_count; ni++) {
+            WorldNpc* npc = &world_npcs[ni];
+            if (!npc->active) continue;
+            if (npc->in_water) continue; /* NPC is in water */
+            uint32_t mask = hazard_grid_sample(npc->x, npc->y);
+            if (!mask || !flame_hits_walker(mask, npc->ship_id, npc->x, npc->y, cos_hc)) continue;
+            npc->fire_timer_ms = FIRE_DURATION_MS;
+            {
+                char fmsg[256];
+                snprintf(fmsg, sizeof(fmsg),
+                    "{\"type\":\"FIRE_EFFECT\",\"entityType\":\"npc\",\"id\":%u,"
+                    "\"x\":%.1f,\"y\":%.1f,\"durationMs\":%u}",
+                    npc->id, npc->x, npc->y, FIRE_DURATION_MS);
+                broadcast_json_all(fmsg);
+            }
+        }
 
-                    /* Wooden modules — any ship (including firing ship; fire doesn't pick sides) */
-                    const float cos_hc_mod = cosf(FLAME_HALF_CONE_MODULE);
-                    for (int s = 0; s < ship_count; s++) {
-                        if (!ships[s].active) continue;
-                        SimpleShip* fship = &ships[s];
-                        float cos_r = cosf(fship->rotation);
-                        float sin_r = sinf(fship->rotation);
-                        for (int m = 0; m < fship->module_count; m++) {
-                            ShipModule* mod = &fship->modules[m];
-                            ModuleTypeId mt = mod->type_id;
-                            if (mt != MODULE_TYPE_PLANK && mt != MODULE_TYPE_DECK &&
-                                mt != MODULE_TYPE_MAST) continue;
-                            if (mod->state_bits & MODULE_STATE_DESTROYED) continue;
-                            /* Compute world-space module position for the flame check.
-                             * Deck modules use per-zone ignition; other modules use their centre. */
-                            float lx, ly, wx, wy, dist = 0.0f;
-                            if (mt == MODULE_TYPE_DECK) {
-                                /* Test each of the 3 deck zone centres independently.
-                                 * Zone 0 = bow (+160 client), 1 = mid, 2 = stern (-160 client).
-                                 * Bits 11-13 are set for each zone that the flame reaches.
-                                 * A zone is not ignited if an intact plank on fship lies between
-                                 * the flame origin and the zone centre (plank-occlusion rule). */
-                                const float zone_lx3[3] = { 160.0f, 0.0f, -160.0f };
-                                bool any_zone = false;
-                                for (int z = 0; z < 3; z++) {
-                                    float z_wx = fship->x + zone_lx3[z] * cos_r;
-                                    float z_wy = fship->y + zone_lx3[z] * sin_r;
-                                    float zdx = z_wx - fw->origin_x, zdy = z_wy - fw->origin_y;
-                                    float zdist = sqrtf(zdx*zdx + zdy*zdy);
-                                    if (zdist > fw->wave_dist + 40.0f) continue;
-                                    float zdot = (zdist > 0.01f)
-                                        ? (zdx/zdist*fdir_x + zdy/zdist*fdir_y) : 1.0f;
-                                    if (zdot < cos_hc_mod) continue;
-                                    /* Skip if an intact plank blocks flame→zone centre */
-                                    if (plank_occludes_ray(fship, fw->origin_x, fw->origin_y,
-                                                           z_wx, z_wy)) continue;
-                                    mod->state_bits |= (uint16_t)(1u << (11 + z));
-                                    any_zone = true;
-                                }
-                                if (!any_zone) continue;
-                                /* Use ship centre for FIRE_EFFECT position broadcast */
-                                lx = 0.0f; ly = 0.0f;
-                                wx = fship->x; wy = fship->y;
-                            } else {
-                                lx = SERVER_TO_CLIENT(Q16_TO_FLOAT(mod->local_pos.x));
-                                ly = SERVER_TO_CLIENT(Q16_TO_FLOAT(mod->local_pos.y));
-                                wx = fship->x + (lx * cos_r - ly * sin_r);
-                                wy = fship->y + (lx * sin_r + ly * cos_r);
-                                float dx = wx - fw->origin_x, dy = wy - fw->origin_y;
-                                dist = sqrtf(dx*dx + dy*dy);
-                                if (dist > fw->wave_dist + 40.0f) continue;
-                                float dot = (dist > 0.01f) ? (dx/dist*fdir_x + dy/dist*fdir_y) : 1.0f;
-                                if (dot < cos_hc_mod) continue;
-                                /* Sail fiber plank occlusion: skip if an intact plank
-                                 * lies between the flame origin and the mast centre. */
-                                if (mt == MODULE_TYPE_MAST &&
-                                    plank_occludes_ray(fship, fw->origin_x, fw->origin_y, wx, wy))
-                                    continue;
-                            }
-                            /* Sail fiber ignition: boost intensity on each flame contact */
-                            if (mt == MODULE_TYPE_MAST) {
-                                int ni = (int)mod->data.mast.sail_fire_intensity + 25;
-                                if (ni > 100) ni = 100;
-                                mod->data.mast.sail_fire_intensity = (uint8_t)ni;
-                            }
-                            bool first = (mod->fire_timer_ms == 0);
-                            mod->fire_timer_ms = FIRE_DURATION_MS;
-                            if (global_sim) {
-                                struct Ship* _fss = find_sim_ship(fship->ship_id);
-                                if (_fss) {
-                                    for (uint8_t mi = 0; mi < _fss->module_count; mi++) {
-                                        if (_fss->modules[mi].id == mod->id) {
-                                            _fss->modules[mi].fire_timer_ms = FIRE_DURATION_MS;
-                                            _fss->modules[mi].state_bits    = mod->state_bits;
-                                            if (mod->type_id == MODULE_TYPE_MAST)
-                                                _fss->modules[mi].data.mast.sail_fire_intensity =
-                                                    mod->data.mast.sail_fire_intensity;
-                                            break;
-                                        }
-                                    }
-                                }
-                            }
-                            /* Always broadcast FIRE_EFFECT — refreshes client timer on every
-                               flame contact, preventing client/server desync where client timer
-                               expires while server keeps module burning. */
-                            log_info("🔥 Module %u (ship %u type %d) %s by flame wave (dist=%.1f wave=%.1f)",
-                                     mod->id, fship->ship_id, (int)mt,
-                                     first ? "ignited" : "re-ignited", dist, fw->wave_dist);
-                            {
-                                char fmsg[256];
-                                snprintf(fmsg, sizeof(fmsg),
-                                    "{\"type\":\"FIRE_EFFECT\",\"entityType\":\"module\","
-                                    "\"shipId\":%u,\"moduleId\":%u,"
-                                    "\"x\":%.1f,\"y\":%.1f,\"durationMs\":%u}",
-                                    fship->ship_id, mod->id, wx, wy, FIRE_DURATION_MS);
-                                broadcast_json_all(fmsg);
-                            }
-                        }
-                    }
-                } /* end !retreating fire application */
-
-                /* Broadcast current wave state — client interpolates between ticks */
-                {
-                    char state_msg[320];
-                    snprintf(state_msg, sizeof(state_msg),
-                        "{\"type\":\"FLAME_WAVE_UPDATE\","
-                        "\"cannonId\":%u,\"shipId\":%u,"
-                        "\"x\":%.1f,\"y\":%.1f,\"angle\":%.3f,"
-                        "\"halfCone\":%.4f,\"waveDist\":%.1f,"
-                        "\"retreating\":%s,\"retreatDist\":%.1f}",
-                        fw->swivel_id, fw->ship_id,
-                        fw->origin_x, fw->origin_y, fw->fire_angle,
-                        FLAME_HALF_CONE, fw->wave_dist,
-                        fw->retreating ? "true" : "false",
-                        fw->retreat_dist);
-                    broadcast_json_all(state_msg);
-                }
+        /* Players */
+        for (int wpi = 0; wpi < WS_MAX_CLIENTS; wpi++) {
+            WebSocketPlayer* wp = &players[wpi];
+            if (!wp->active) continue;
+            if (wp->movement_state == PLAYER_STATE_SWIMMING) continue; /* player is in water */
+            uint32_t mask = hazard_grid_sample(wp->x, wp->y);
+            if (!mask || !flame_hits_walker(mask, wp->parent_ship_id, wp->x, wp->y, cos_hc)) continue;
+            wp->fire_timer_ms = FIRE_DURATION_MS;
+            {
+                char fmsg[256];
+                snprintf(fmsg, sizeof(fmsg),
+                    "{\"type\":\"FIRE_EFFECT\",\"entityType\":\"player\",\"id\":%u,"
+                    "\"x\":%.1f,\"y\":%.1f,\"durationMs\":%u}",
+                    wp->player_id, wp->x, wp->y, FIRE_DURATION_MS);
+                broadcast_json_all(fmsg);
             }
-        } /* end FLAME WAVE UPDATE */
+        }
+
+        flame_ignite_modules(cosf(FLAME_HALF_CONE_MODULE));
+    }
+
+    /* Broadcast current wave state — client interpolates between ticks */
+    for (int fi = 0; fi < MAX_FLAME_WAVES; fi++) {
+        FlameWave* fw = &flame_waves[fi];
+        if (!fw->active) continue;
+        char state_msg[320];
+        snprintf(state_msg, sizeof(state_msg),
+            "{\"type\":\"FLAME_WAVE_UPDATE\","
+            "\"cannonId\":%u,\"shipId\":%u,"
+            "\"x\":%.1f,\"y\":%.1f,\"angle\":%.3f,"
+            "\"halfCone\":%.4f,\"waveDist\":%.1f,"
+            "\"retreating\":%s,\"retreatDist\":%.1f}",
+            fw->swivel_id, fw->ship_id,
+            fw->origin_x, fw->origin_y, fw->fire_angle,
+            FLAME_HALF_CONE, fw->wave_dist,
+            fw->retreating ? "true" : "false",
+            fw->retreat_dist);
+        broadcast_json_all(state_msg);
+    }
 }
 
 /* ────────────────────────────────────────────────────────────────────────────
@@ -1795,11 +1889,22 @@ void update_flame_waves(uint32_t time_elapsed) {
 #define PROJ_HIT_STRUCT_DAMAGE      3000u   /* HP deducted per cannonball hit (buildings) */
 #define PROJ_HIT_FORT_DAMAGE          25u   /* HP deducted per cannonball hit (forts)     */
 #define TREE_COLLISION_R_PX         22.0f   /* tree stop radius, client pixels     */
+#define BOULDER_HIT_R_PX            38.0f   /* boulder ellipse base radius         */
+#define BOULDER_HIT_MAX_AXIS        1.35f   /* widest ellipse axis, × base × size  */
 /* TREE_TRUNK_R_PX now defined in cannon_fire.h */
 #define STRUCT_FLOOR_HALF_EXT       25.0f   /* floor tile half-extent (50px tile)  */
 #define STRUCT_WB_HALF_W            22.0f   /* workbench half-width  (44px wide)   */
 #define STRUCT_WB_HALF_H            15.5f   /* workbench half-height (31px tall)   */
 #define STRUCT_WB_BROAD_R           26.5f   /* broad-phase radius (AABB diagonal)  */
+#define STRUCT_WALL_BROAD_R         25.5f   /* wall/door OBB (50×10) half-diagonal */
+#define STRUCT_NEAR_R               30.0f   /* widest footprint queried below (fortress) */
+#define STRUCT_NEAR_MASK  (STRUCT_MASK(STRUCT_WALL) | STRUCT_MASK(STRUCT_DOOR_FRAME) |   \
+                           STRUCT_MASK(STRUCT_DOOR) | STRUCT_MASK(STRUCT_WORKBENCH) |     \
+                           STRUCT_MASK(STRUCT_WOODEN_FLOOR) | STRUCT_MASK(STRUCT_CANNON) | \
+                           STRUCT_MASK(STRUCT_FLAG_FORT) | STRUCT_MASK(STRUCT_COMPANY_FORTRESS) | \
+                           STRUCT_MASK(STRUCT_CHEST))
+
+_Static_assert(ISLAND_COUNT <= 32, "projectile broad phase keeps one bit per island");
 
 void check_projectile_static_collisions(struct Sim* sim) {
     if (!sim) return;
@@ -1813,27 +1918,41 @@ void check_projectile_static_collisions(struct Sim* sim) {
 
         /* ── Island broad-phase: skip projectiles that are out at sea ────── */
         /* Only run structure/tree checks when the cannonball is within the
-         * outer boundary of at least one island (beach_radius + max_bump). */
+         * outer boundary of at least one island (beach_radius + max_bump).
+         * The same pass records which islands have a tree or boulder within
+         * reach, so the resource passes below skip the rest. */
         bool near_island = false;
-        for (int ii = 0; ii < ISLAND_COUNT && !near_island; ii++) {
+        uint32_t res_islands = 0;   /* bit ii: island ii's resources in reach */
+        for (int ii = 0; ii < ISLAND_COUNT; ii++) {
             const IslandDef* isl = &ISLAND_PRESETS[ii];
             float broad_r = (isl->vertex_count > 0) ? isl->poly_bound_r
                                                        : (isl->beach_radius_px + isl->beach_max_bump);
+            float reach = fmaxf(TREE_COLLISION_R_PX, BOULDER_HIT_R_PX * BOULDER_HIT_MAX_AXIS)
+                        * isl->grid_max_size;
             float idx = px - isl->x;
             float idy = py - isl->y;
-            if (idx * idx + idy * idy <= broad_r * broad_r) near_island = true;
+            float ds  = idx * idx + idy * idy;
+            if (ds <= broad_r * broad_r) near_island = true;
+            if (ds <= (broad_r + reach) * (broad_r + reach)) res_islands |= 1u << ii;
         }
         if (!near_island) { i++; continue; }
 
         /* ── Test vs. placed structures ──────────────────────────────────── */
+        /* Every pass but the shipyards' takes its candidates from one
+         * placement-grid query, in slot order so each pass hits what a full
+         * scan of that type would. */
+        static StructureNear near_structs;
+        structure_index_near(&near_structs, px, py, STRUCT_NEAR_R, STRUCT_NEAR_MASK);
+
         /* Pass 0: walls — thin hard barriers, hit before workbenches/floors. */
-        for (uint32_t si = 0; si < placed_structure_count && !removed; si++) {
-            PlacedStructure* s = &placed_structures[si];
+        for (uint32_t k = 0; k < near_structs.count && !removed; k++) {
+            PlacedStructure* s = &placed_structures[near_structs.slots[k]];
             if (!s->active || s->type != STRUCT_WALL) continue;
+            float dx = px - s->x, dy = py - s->y;
+            if (dx * dx + dy * dy > STRUCT_WALL_BROAD_R * STRUCT_WALL_BROAD_R) continue;
             /* OBB test in wall-local space */
             float wrad = wall_get_rad(s->x, s->y);
             float wc = cosf(-wrad), wsn = sinf(-wrad);
-            float dx = px - s->x, dy = py - s->y;
             float lx = dx * wc - dy * wsn;
             float ly = dx * wsn + dy * wc;
             if (fabsf(lx) > 25.0f || fabsf(ly) > 5.0f) continue;
@@ -1849,14 +1968,15 @@ void check_projectile_static_collisions(struct Sim* sim) {
         /* Pass 0b: door frames and doors — same OBB shape as walls.
          * Door frames are two thin posts (treated as one slab for hit purposes).
          * Closed doors block cannonballs; open doors do not. */
-        for (uint32_t si = 0; si < placed_structure_count && !removed; si++) {
-            PlacedStructure* s = &placed_structures[si];
+        for (uint32_t k = 0; k < near_structs.count && !removed; k++) {
+            PlacedStructure* s = &placed_structures[near_structs.slots[k]];
             if (!s->active) continue;
             if (s->type != STRUCT_DOOR_FRAME && s->type != STRUCT_DOOR) continue;
             if (s->type == STRUCT_DOOR && s->open) continue; /* open door: passable */
+            float dx = px - s->x, dy = py - s->y;
+            if (dx * dx + dy * dy > STRUCT_WALL_BROAD_R * STRUCT_WALL_BROAD_R) continue;
             float wrad = wall_get_rad(s->x, s->y);
             float wc = cosf(-wrad), wsn = sinf(-wrad);
-            float dx = px - s->x, dy = py - s->y;
             float lx = dx * wc - dy * wsn;
             float ly = dx * wsn + dy * wc;
             if (fabsf(lx) > 25.0f || fabsf(ly) > 5.0f) continue;
@@ -1870,8 +1990,8 @@ void check_projectile_static_collisions(struct Sim* sim) {
 
         /* Pass 1: workbenches — checked first so they can be independently
          * hit and damaged even when a floor tile below overlaps the same area. */
-        for (uint32_t si = 0; si < placed_structure_count && !removed; si++) {
-            PlacedStructure* s = &placed_structures[si];
+        for (uint32_t k = 0; k < near_structs.count && !removed; k++) {
+            PlacedStructure* s = &placed_structures[near_structs.slots[k]];
             if (!s->active || s->type != STRUCT_WORKBENCH) continue;
             float dx = px - s->x;
             float dy = py - s->y;
@@ -1889,8 +2009,8 @@ void check_projectile_static_collisions(struct Sim* sim) {
         }
 
         /* Pass 2: floors (only if no workbench was hit in Pass 1) */
-        for (uint32_t si = 0; si < placed_structure_count && !removed; si++) {
-            PlacedStructure* s = &placed_structures[si];
+        for (uint32_t k = 0; k < near_structs.count && !removed; k++) {
+            PlacedStructure* s = &placed_structures[near_structs.slots[k]];
             if (!s->active || s->type != STRUCT_WOODEN_FLOOR) continue;
             float dx = px - s->x;
             float dy = py - s->y;
@@ -1908,8 +2028,8 @@ void check_projectile_static_collisions(struct Sim* sim) {
 
         /* Pass 3: island cannons — checked after floors so the cannon barrel
          * takes direct hits rather than the underlying floor absorbing them. */
-        for (uint32_t si = 0; si < placed_structure_count && !removed; si++) {
-            PlacedStructure* s = &placed_structures[si];
+        for (uint32_t k = 0; k < near_structs.count && !removed; k++) {
+            PlacedStructure* s = &placed_structures[near_structs.slots[k]];
             if (!s->active || s->type != STRUCT_CANNON) continue;
             float dx = px - s->x;
             float dy = py - s->y;
@@ -1930,9 +2050,11 @@ void check_projectile_static_collisions(struct Sim* sim) {
         #define SY_HH      DOCK_HH
         #define SY_ARM_T   DOCK_ARM_T
         #define SY_BACK_T  DOCK_BACK_T
-        for (uint32_t si = 0; si < placed_structure_count && !removed; si++) {
-            PlacedStructure* s = &placed_structures[si];
-            if (!s->active || s->type != STRUCT_SHIPYARD) continue;
+        uint32_t n_yards;
+        const uint32_t* yards = structure_slots_of_type(STRUCT_SHIPYARD, &n_yards);
+        for (uint32_t k = 0; k < n_yards && !removed; k++) {
+            PlacedStructure* s = &placed_structures[yards[k]];
+            if (!s->active) continue;
             /* Broad radial cull (bounding circle of 170×445 box ≈ 476) */
             float bdx = px - s->x, bdy = py - s->y;
             if (bdx * bdx + bdy * bdy > 476.0f * 476.0f) continue;
@@ -1968,8 +2090,8 @@ void check_projectile_static_collisions(struct Sim* sim) {
          * Hit radii match the rendered tower footprint (≈44px / 60px tile).
          * apply_structure_damage gates the CLAIMING phase internally, so it's
          * safe to hit-test unconditionally here. */
-        for (uint32_t si = 0; si < placed_structure_count && !removed; si++) {
-            PlacedStructure* s = &placed_structures[si];
+        for (uint32_t k = 0; k < near_structs.count && !removed; k++) {
+            PlacedStructure* s = &placed_structures[near_structs.slots[k]];
             if (!s->active) continue;
             float hit_r;
             if (s->type == STRUCT_FLAG_FORT)            hit_r = 22.0f;
@@ -1990,8 +2112,8 @@ void check_projectile_static_collisions(struct Sim* sim) {
         /* Pass 6: land chests (STRUCT_CHEST) — AABB 36×26 px (half 18×13). */
         #define STRUCT_CHEST_HALF_W  18.0f
         #define STRUCT_CHEST_HALF_H  13.0f
-        for (uint32_t si = 0; si < placed_structure_count && !removed; si++) {
-            PlacedStructure* s = &placed_structures[si];
+        for (uint32_t k = 0; k < near_structs.count && !removed; k++) {
+            PlacedStructure* s = &placed_structures[near_structs.slots[k]];
             if (!s->active || s->type != STRUCT_CHEST) continue;
             float dx = px - s->x;
             float dy = py - s->y;
@@ -2008,57 +2130,46 @@ void check_projectile_static_collisions(struct Sim* sim) {
         #undef STRUCT_CHEST_HALF_W
         #undef STRUCT_CHEST_HALF_H
 
-        /* ── Test vs. island trees (spatial grid lookup) ────────────────── */
+        /* ── Test vs. island trees (resource grid lookup) ───────────────── */
         if (!removed) {
+            static IslandResourceNear near_trees;
             for (int ii = 0; ii < ISLAND_COUNT && !removed; ii++) {
+                if (!(res_islands & (1u << ii))) continue;
                 IslandDef* isl = &ISLAND_PRESETS[ii];
-                if (isl->grid_w == 0) continue; /* no wood nodes */
-
-                /* Compute the 3×3 neighbourhood of cells around the projectile */
-                int center_col = (int)((px - isl->grid_ox) / ISLAND_GRID_CELL_PX);
-                int center_row = (int)((py - isl->grid_oy) / ISLAND_GRID_CELL_PX);
-
-                for (int dr = -1; dr <= 1 && !removed; dr++) {
-                    int row = center_row + dr;
-                    if (row < 0 || row >= isl->grid_h) continue;
-                    for (int dc = -1; dc <= 1 && !removed; dc++) {
-                        int col = center_col + dc;
-                        if (col < 0 || col >= isl->grid_w) continue;
-                        const IslandGridCell *cell = &isl->wood_grid[row][col];
-                        for (int k = 0; k < cell->count && !removed; k++) {
-                            int ri = cell->ri[k];
-                            IslandResource* res = &isl->resources[ri];
-                            if (res->health <= 0) continue;
-                            float tx = isl->x + res->ox;
-                            float ty = isl->y + res->oy;
-                            float dx = px - tx;
-                            float dy = py - ty;
-                            if (dx * dx + dy * dy <= (TREE_COLLISION_R_PX * res->size) * (TREE_COLLISION_R_PX * res->size)) {
-                                const int CANNON_TREE_DMG = 30;
-                                res->health -= CANNON_TREE_DMG;
-                                if (res->health < 0) res->health = 0;
-                                if (res->health == 0) {
-                                    island_mark_tree_dead(isl, ri);
-                                    res->respawn_at_ms = get_time_ms() + 120000u; /* 2 min */
-                                }
-                                char tmsg[160];
-                                snprintf(tmsg, sizeof(tmsg),
-                                         "{\"type\":\"resource_damaged\",\"island_id\":%u"
-                                         ",\"ri\":%d,\"ox\":%.1f,\"oy\":%.1f,\"hp\":%d,\"maxHp\":%d}",
-                                         (unsigned)isl->id, ri, res->ox, res->oy, res->health, res->max_health);
-                                websocket_server_broadcast(tmsg);
-                                char htmsg[96];
-                                snprintf(htmsg, sizeof(htmsg),
-                                         "{\"type\":\"tree_cannonball_hit\",\"x\":%.1f,\"y\":%.1f}",
-                                         tx, ty);
-                                websocket_server_broadcast(htmsg);
-                                memmove(&sim->projectiles[i], &sim->projectiles[i + 1],
-                                        ((size_t)sim->projectile_count - (size_t)i - 1u)
-                                        * sizeof(struct Projectile));
-                                sim->projectile_count--;
-                                removed = true;
-                            }
+                if (isl->alive_count[RES_WOOD] == 0) continue;
+                island_resources_near(&near_trees, isl, px, py,
+                                      TREE_COLLISION_R_PX * isl->grid_max_size, RES_MASK(RES_WOOD));
+                for (uint32_t k = 0; k < near_trees.count && !removed; k++) {
+                    int ri = near_trees.ri[k];
+                    IslandResource* res = &isl->resources[ri];
+                    if (res->health <= 0) continue;
+                    float tx = isl->x + res->ox;
+                    float ty = isl->y + res->oy;
+                    float dx = px - tx;
+                    float dy = py - ty;
+                    if (dx * dx + dy * dy <= (TREE_COLLISION_R_PX * res->size) * (TREE_COLLISION_R_PX * res->size)) {
+                        const int CANNON_TREE_DMG = 30;
+                        res->health -= CANNON_TREE_DMG;
+                        if (res->health < 0) res->health = 0;
+                        if (res->health == 0) {
+                            harvest_schedule_respawn(isl, ri, 120000u); /* 2 min */
                         }
+                        char tmsg[160];
+                        snprintf(tmsg, sizeof(tmsg),
+                                 "{\"type\":\"resource_damaged\",\"island_id\":%u"
+                                 ",\"ri\":%d,\"ox\":%.1f,\"oy\":%.1f,\"hp\":%d,\"maxHp\":%d}",
+                                 (unsigned)isl->id, ri, res->ox, res->oy, res->health, res->max_health);
+                        websocket_server_broadcast(tmsg);
+                        char htmsg[96];
+                        snprintf(htmsg, sizeof(htmsg),
+                                 "{\"type\":\"tree_cannonball_hit\",\"x\":%.1f,\"y\":%.1f}",
+                                 tx, ty);
+                        websocket_server_broadcast(htmsg);
+                        memmove(&sim->projectiles[i], &sim->projectiles[i + 1],
+                                ((size_t)sim->projectile_count - (size_t)i - 1u)
+                                * sizeof(struct Projectile));
+                        sim->projectile_count--;
+                        removed = true;
                     }
                 }
             }
@@ -2066,16 +2177,20 @@ void check_projectile_static_collisions(struct Sim* sim) {
 
         /* ── Test vs. island boulders — rotated ellipse, matches renderer/sim ─ */
         if (!removed) {
-            static const float BOULDER_BASE_HIT_R = 38.0f;
             static const float BSX[5] = { 1.00f, 0.88f, 1.18f, 0.72f, 1.35f };
             static const float BSY[5] = { 0.72f, 0.88f, 0.60f, 1.00f, 0.50f };
             static const float BSR[5] = { 0.00f, 0.40f, -0.20f,  1.20f, 0.15f };
             const int   CANNON_BOULDER_DMG  = 50;
+            static IslandResourceNear near_boulders;
             for (int ii = 0; ii < ISLAND_COUNT && !removed; ii++) {
+                if (!(res_islands & (1u << ii))) continue;
                 IslandDef* isl = &ISLAND_PRESETS[ii];
-                for (int ri = 0; ri < isl->resource_count && !removed; ri++) {
+                island_resources_near(&near_boulders, isl, px, py,
+                                      BOULDER_HIT_R_PX * BOULDER_HIT_MAX_AXIS * isl->grid_max_size,
+                                      RES_MASK(RES_BOULDER) | RES_MASK(RES_STONE_BOULDER));
+                for (uint32_t k = 0; k < near_boulders.count && !removed; k++) {
+                    int ri = near_boulders.ri[k];
                     IslandResource* res = &isl->resources[ri];
-                    if (res->type_id != RES_BOULDER && res->type_id != RES_STONE_BOULDER) continue;
                     if (res->health <= 0) continue;
                     float bx = isl->x + res->ox;
                     float by = isl->y + res->oy;
@@ -2085,8 +2200,8 @@ void check_projectile_static_collisions(struct Sim* sim) {
                     uint32_t bseed = ((uint32_t)((int)res->ox * 73856093))
                                    ^ ((uint32_t)((int)res->oy * 19349663));
                     int bsi = (int)((bseed >> 4) % 5u);
-                    float ax = BOULDER_BASE_HIT_R * res->size * BSX[bsi];
-                    float ay = BOULDER_BASE_HIT_R * res->size * BSY[bsi];
+                    float ax = BOULDER_HIT_R_PX * res->size * BSX[bsi];
+                    float ay = BOULDER_HIT_R_PX * res->size * BSY[bsi];
                     float theta = BSR[bsi] + ((float)((bseed >> 8) & 0xFFu) / 256.0f)
                                   * (2.0f * 3.14159265f);
                     float ec = cosf(theta), es = sinf(theta);
@@ -2097,7 +2212,7 @@ void check_projectile_static_collisions(struct Sim* sim) {
                     res->health -= CANNON_BOULDER_DMG;
                     if (res->health < 0) res->health = 0;
                     if (res->health == 0) {
-                        res->respawn_at_ms = get_time_ms() + 180000u; /* 3 min */
+                        harvest_schedule_respawn(isl, ri, 180000u); /* 3 min */
                     }
                     char bmsg[160];
                     snprintf(bmsg, sizeof(bmsg),
@@ -2216,13 +2331,11 @@ void fire_island_cannon(PlacedStructure* str, WebSocketPlayer* player) {
  */
 void handle_island_cannon_aim(WebSocketPlayer* player, float aim_angle) {
     if (!player || player->mounted_cannon_structure_id == 0) return;
-    for (uint32_t si = 0; si < placed_structure_count; si++) {
-        if (!placed_structures[si].active) continue;
-        if (placed_structures[si].id != player->mounted_cannon_structure_id) continue;
-
+    PlacedStructure* str = structure_by_id(player->mounted_cannon_structure_id);
+    if (str) {
         /* Barrel faces at (rotation_deg × π/180 − π/2) in world space — same convention
          * used in the client renderer (barrel points local −y, base rotation from placement). */
-        float facing = placed_structures[si].rotation * (float)(M_PI / 180.0) - (float)(M_PI / 2.0);
+        float facing = str->rotation * (float)(M_PI / 180.0) - (float)(M_PI / 2.0);
 
         /* Compute signed offset from facing direction */
         float offset = aim_angle - facing;
@@ -2237,9 +2350,8 @@ void handle_island_cannon_aim(WebSocketPlayer* player, float aim_angle) {
         }
 
         float clamped = facing + offset;
-        placed_structures[si].cannon_desired_aim_angle = clamped;
+        str->cannon_desired_aim_angle = clamped;
         player->cannon_aim_angle = clamped;
-        break;
     }
 }
 
@@ -2250,13 +2362,10 @@ void handle_island_cannon_aim(WebSocketPlayer* player, float aim_angle) {
  */
 int handle_island_cannon_fire(WebSocketPlayer* player) {
     if (!player || player->mounted_cannon_structure_id == 0) return 1;
-    for (uint32_t si = 0; si < placed_structure_count; si++) {
-        if (!placed_structures[si].active) continue;
-        if (placed_structures[si].id != player->mounted_cannon_structure_id) continue;
-        placed_structures[si].no_ammo_flag = false;
-        fire_island_cannon(&placed_structures[si], player);
-        if (placed_structures[si].no_ammo_flag) return 2; /* no ammo */
-        return 0; /* fired */
-    }
-    return 1;
+    PlacedStructure* str = structure_by_id(player->mounted_cannon_structure_id);
+    if (!str) return 1;
+    str->no_ammo_flag = false;
+    fire_island_cannon(str, player);
+    if (str->no_ammo_flag) return 2; /* no ammo */
+    return 0; /* fired */
 }
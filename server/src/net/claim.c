@@ -36,58 +36,24 @@
 #include "net/websocket_protocol.h"
 #include "net/structures.h"
 #include "net/claim.h"
+#include "net/structure_index.h"
 #include "sim/island.h"
 #include "util/log.h"
 #include "util/time.h"
+#include "util/timer_wheel.h"
 
 /* ── Global claim table ──────────────────────────────────────────────────── */
 
 IslandClaim island_claims[MAX_ISLAND_CLAIMS];
 int         island_claim_count = 0;
 
-/* ── Claim-flag section cache ────────────────────────────────────────────────
- * One ClaimSectionGrid per claim flag (indexed by structure ID).  Built lazily
- * on first use; invalidated (freed) on any structural change that could alter
- * the section geometry (placement, destruction, or a capture that rewrites
- * dominator lists).  Player-presence detection uses `claim_section_contains`
- * instead of the simpler two-disc intersection so the contest area matches the
- * full connected section the flag was placed into.
- */
-static ClaimSectionGrid *cf_section_cache[MAX_PLACED_STRUCTURES]; /* indexed by s->id */
-
-void claim_invalidate_cf_sections(void) {
-    for (int i = 0; i < MAX_PLACED_STRUCTURES; i++) {
-        if (cf_section_cache[i]) {
-            claim_section_free(cf_section_cache[i]);
-            cf_section_cache[i] = NULL;
-        }
-    }
-}
-
-static void cf_section_release(uint16_t struct_id) {
-    if (struct_id < MAX_PLACED_STRUCTURES && cf_section_cache[struct_id]) {
-        claim_section_free(cf_section_cache[struct_id]);
-        cf_section_cache[struct_id] = NULL;
-    }
-}
-
 /* ── Helpers ─────────────────────────────────────────────────────────────── */
 
-/* Forward declaration — defined later in this file. */
-static PlacedStructure *find_struct_by_id(uint32_t id);
-
 static inline float dist2(float ax, float ay, float bx, float by) {
     float dx = ax - bx, dy = ay - by;
     return dx * dx + dy * dy;
 }
 
-/** Effective claim radius for a structure type. */
-static inline float struct_claim_radius(PlacedStructureType t) {
-    if (t == STRUCT_FLAG_FORT)      return CLAIM_RADIUS_FLAG_FORT;
-    if (t == STRUCT_COMPANY_FORTRESS) return CLAIM_RADIUS_COMPANY_FORT;
-    return CLAIM_RADIUS_DEFAULT;
-}
-
 /** Only floors, flag forts, and company forts participate in the DOM system.
  *  Workbenches, claim flags, and any future decorative structures must never
  *  appear in a DOM list or have their own DOM list populated. */
@@ -211,15 +177,7 @@ void claim_dominators_sanity_sweep(void) {
         int w = 0;
         for (int r = 0; r < ps->dominator_count; r++) {
             uint32_t did = ps->dominators[r];
-            bool valid = false;
-            if (did != ps->id) {
-                for (uint32_t j = 0; j < placed_structure_count; j++) {
-                    if (placed_structures[j].id == did && placed_structures[j].active) {
-                        valid = true;
-                        break;
-                    }
-                }
-            }
+            bool valid = did != ps->id && structure_by_id(did) != NULL;
             if (valid) {
                 ps->dominators[w++] = did;
             } else {
@@ -240,14 +198,8 @@ void claim_dominators_sanity_sweep(void) {
  *  that exactly reflects their NEW dominance relationships, regardless of
  *  any prior incremental state. Broadcasts the new list if it changed. */
 void claim_recompute_dominators(uint32_t structure_id) {
-    PlacedStructure *me = NULL;
-    for (uint32_t i = 0; i < placed_structure_count; i++) {
-        if (placed_structures[i].id == structure_id) {
-            me = &placed_structures[i];
-            break;
-        }
-    }
-    if (!me || !me->active) return;
+    PlacedStructure *me = structure_by_id(structure_id);
+    if (!me) return;
     /* Only DOM-eligible structures (floors, flag forts, company forts) can
      * have a DOM list.  Workbenches etc. are ignored entirely. */
     if (!dom_eligible(me->type)) return;
@@ -356,14 +308,8 @@ static void claim_rebuild_graph(uint16_t fort_struct_id, uint32_t company_id) {
     }
 
     /* Seed: find the fort in the placed_structures array. */
-    int fort_idx = -1;
-    for (uint32_t i = 0; i < placed_structure_count; i++) {
-        if (placed_structures[i].active &&
-            placed_structures[i].id == fort_struct_id) {
-            fort_idx = (int)i;
-            break;
-        }
-    }
+    PlacedStructure *fort = structure_by_id(fort_struct_id);
+    int fort_idx = fort ? (int)(fort - placed_structures) : -1;
     if (fort_idx < 0) {
         /* Fort not found — mark all company structures orphaned. */
         for (uint32_t i = 0; i < placed_structure_count; i++) {
@@ -495,7 +441,7 @@ bool claim_register_company_fortress(uint8_t island_id, uint32_t company_id,
         if (s->island_id != island_id) continue;
         if (s->id == struct_id) continue;              /* keep the one that just completed */
         if (s->fortress_complete) continue;            /* keep other completed ones (shouldn't exist) */
-        s->active = false;
+        structure_free(s);
         char dmsg[128];
         snprintf(dmsg, sizeof(dmsg),
                  "{\"type\":\"structure_demolished\",\"structure_id\":%u}", s->id);
@@ -532,9 +478,15 @@ void claim_on_fort_destroyed(uint32_t fort_structure_id) {
 
 /* ── Territory query ─────────────────────────────────────────────────────── */
 
+/* Each query walks only the structures the claim grid lists for the point's
+ * cell (see structure_index_claim_candidates), in slot order, so results
+ * match a full scan of placed_structures[]. */
+
 bool territory_is_claimed_by(float wx, float wy, uint32_t company_id) {
-    for (uint32_t i = 0; i < placed_structure_count; i++) {
-        PlacedStructure *s = &placed_structures[i];
+    uint32_t n;
+    const uint32_t *cand = structure_index_claim_candidates(wx, wy, &n);
+    for (uint32_t k = 0; k < n; k++) {
+        PlacedStructure *s = &placed_structures[cand[k]];
         if (!s->active) continue;
         if (s->company_id != company_id) continue;
         if (s->claim_orphaned) continue;
@@ -545,8 +497,10 @@ bool territory_is_claimed_by(float wx, float wy, uint32_t company_id) {
 }
 
 bool territory_is_claimed_by_any(float wx, float wy, uint32_t *out_company_id) {
-    for (uint32_t i = 0; i < placed_structure_count; i++) {
-        PlacedStructure *s = &placed_structures[i];
+    uint32_t n;
+    const uint32_t *cand = structure_index_claim_candidates(wx, wy, &n);
+    for (uint32_t k = 0; k < n; k++) {
+        PlacedStructure *s = &placed_structures[cand[k]];
         if (!s->active) continue;
         if (s->claim_orphaned) continue;
         if (s->company_id == COMPANY_UNCLAIMED) continue;
@@ -561,8 +515,10 @@ bool territory_is_claimed_by_any(float wx, float wy, uint32_t *out_company_id) {
 
 bool territory_is_contested(float wx, float wy) {
     uint32_t first_co = 0;
-    for (uint32_t i = 0; i < placed_structure_count; i++) {
-        PlacedStructure *s = &placed_structures[i];
+    uint32_t n;
+    const uint32_t *cand = structure_index_claim_candidates(wx, wy, &n);
+    for (uint32_t k = 0; k < n; k++) {
+        PlacedStructure *s = &placed_structures[cand[k]];
         if (!s->active) continue;
         if (s->claim_orphaned) continue;
         if (s->company_id == COMPANY_UNCLAIMED) continue;
@@ -578,20 +534,15 @@ bool territory_is_contested(float wx, float wy) {
     return false;
 }
 
-/* Lookup a placed structure by id. Returns NULL if not found / inactive. */
-static PlacedStructure *find_placed(uint32_t id) {
-    for (uint32_t i = 0; i < placed_structure_count; i++) {
-        if (placed_structures[i].id == id) return &placed_structures[i];
-    }
-    return NULL;
-}
-
 bool claim_point_in_my_territory(float wx, float wy, uint32_t my_company) {
     if (my_company == 0) return false;
 
+    uint32_t n;
+    const uint32_t *cand = structure_index_claim_candidates(wx, wy, &n);
+
     /* (a) my own structures, uncarved by any enemy dominator. */
-    for (uint32_t i = 0; i < placed_structure_count; i++) {
-        PlacedStructure *s = &placed_structures[i];
+    for (uint32_t c = 0; c < n; c++) {
+        PlacedStructure *s = &placed_structures[cand[c]];
         if (!s->active) continue;
         if (s->claim_orphaned) continue;
         if (s->company_id != my_company) continue;
@@ -600,9 +551,8 @@ bool claim_point_in_my_territory(float wx, float wy, uint32_t my_company) {
 
         bool carved = false;
         for (uint8_t k = 0; k < s->dominator_count; k++) {
-            PlacedStructure *d = find_placed(s->dominators[k]);
+            PlacedStructure *d = structure_by_id(s->dominators[k]);
             if (!d) continue;
-            if (!d->active) continue;
             if (d->claim_orphaned) continue;
             if (d->company_id == my_company) continue; /* same-company never carves */
             float dr = struct_claim_radius(d->type);
@@ -612,8 +562,8 @@ bool claim_point_in_my_territory(float wx, float wy, uint32_t my_company) {
     }
 
     /* (b) enemy structures whose dominators list contains one of mine. */
-    for (uint32_t i = 0; i < placed_structure_count; i++) {
-        PlacedStructure *victim = &placed_structures[i];
+    for (uint32_t c = 0; c < n; c++) {
+        PlacedStructure *victim = &placed_structures[cand[c]];
         if (!victim->active) continue;
         if (victim->claim_orphaned) continue;
         if (victim->company_id == my_company) continue;
@@ -623,9 +573,8 @@ bool claim_point_in_my_territory(float wx, float wy, uint32_t my_company) {
         if (dist2(wx, wy, victim->x, victim->y) > vr * vr) continue;
 
         for (uint8_t k = 0; k < victim->dominator_count; k++) {
-            PlacedStructure *d = find_placed(victim->dominators[k]);
+            PlacedStructure *d = structure_by_id(victim->dominators[k]);
             if (!d) continue;
-            if (!d->active) continue;
             if (d->claim_orphaned) continue;
             if (d->company_id != my_company) continue;
             float dr = struct_claim_radius(d->type);
@@ -640,70 +589,63 @@ bool claim_point_in_my_territory(float wx, float wy, uint32_t my_company) {
 /**
  * Transfer all structures within radius of (fx,fy) from old_co → new_co.
  */
-/* ── Company Fortress build-tick ─────────────────────────────────────────
-   Advances/pauses the 15-minute build timer on every incomplete fortress.   */
-static uint32_t fortress_broadcast_acc_ms = 0;
-static void fortress_tick(uint32_t delta_ms) {
-    fortress_broadcast_acc_ms += delta_ms;
-    bool do_broadcast = (fortress_broadcast_acc_ms >= 1000u);
-    if (do_broadcast) fortress_broadcast_acc_ms = 0;
-
-    for (uint32_t si = 0; si < placed_structure_count; si++) {
-        PlacedStructure *s = &placed_structures[si];
-        if (!s->active) continue;
-        if (s->type != STRUCT_COMPANY_FORTRESS) continue;
-        if (s->fortress_complete) continue;
-
-        float    fx  = s->x, fy = s->y;
-        uint8_t  isl = s->island_id;
-        uint8_t  co  = s->company_id;
-
-        /* Detect any enemy player within contest radius */
-        bool contested = false;
-        for (uint32_t pi = 0; pi < MAX_PLAYERS; pi++) {
-            WebSocketPlayer *p = &players[pi];
-            if (!p->active || p->player_id == 0) continue;
-            if ((uint8_t)p->company_id == co) continue;
-            if ((uint8_t)p->on_island_id != isl) continue;
-            float dx = p->x - fx, dy = p->y - fy;
-            if (dx*dx + dy*dy <= CLAIM_RADIUS_COMPANY_FORT * CLAIM_RADIUS_COMPANY_FORT) {
-                contested = true;
-                break;
-            }
-        }
-        s->claim_contested = contested;
-
-        if (!contested) {
-            s->claim_progress_ms += (float)delta_ms;
-            if (s->claim_progress_ms >= (float)COMPANY_FORTRESS_BUILD_MS) {
-                s->claim_progress_ms = (float)COMPANY_FORTRESS_BUILD_MS;
-                s->fortress_complete = true;
-                s->hp                = s->max_hp;
-
-                log_info("🏰 Company Fortress #%u (company %u, island %u) COMPLETED!",
-                         s->id, co, isl);
-                claim_register_company_fortress(isl, (uint32_t)co,
-                                                s->id, s->placer_id);
-                char msg[192];
-                snprintf(msg, sizeof(msg),
-                         "{\"type\":\"fortress_complete\",\"structure_id\":%u"
-                         ",\"company_id\":%u,\"island_id\":%u}", s->id, co, isl);
-                websocket_server_broadcast(msg);
-                continue;
-            }
+/* ── Company Fortress build step ─────────────────────────────────────────
+   Advances/pauses the 15-minute build timer of one incomplete fortress.
+   Driven every tick by the fort's timer until the build completes.      */
+static void fortress_step(PlacedStructure *s, uint32_t delta_ms) {
+    s->claim_broadcast_acc_ms += delta_ms;
+    bool do_broadcast = (s->claim_broadcast_acc_ms >= 1000u);
+    if (do_broadcast) s->claim_broadcast_acc_ms = 0;
+
+    float    fx  = s->x, fy = s->y;
+    uint8_t  isl = s->island_id;
+    uint8_t  co  = s->company_id;
+
+    /* Detect any enemy player within contest radius */
+    bool contested = false;
+    for (uint32_t pi = 0; pi < MAX_PLAYERS; pi++) {
+        WebSocketPlayer *p = &players[pi];
+        if (!p->active || p->player_id == 0) continue;
+        if ((uint8_t)p->company_id == co) continue;
+        if ((uint8_t)p->on_island_id != isl) continue;
+        float dx = p->x - fx, dy = p->y - fy;
+        if (dx*dx + dy*dy <= CLAIM_RADIUS_COMPANY_FORT * CLAIM_RADIUS_COMPANY_FORT) {
+            contested = true;
+            break;
         }
-
-        if (do_broadcast) {
+    }
+    s->claim_contested = contested;
+
+    if (!contested) {
+        s->claim_progress_ms += (float)delta_ms;
+        if (s->claim_progress_ms >= (float)COMPANY_FORTRESS_BUILD_MS) {
+            s->claim_progress_ms = (float)COMPANY_FORTRESS_BUILD_MS;
+            s->fortress_complete = true;
+            s->hp                = s->max_hp;
+
+            log_info("🏰 Company Fortress #%u (company %u, island %u) COMPLETED!",
+                     s->id, co, isl);
+            claim_register_company_fortress(isl, (uint32_t)co,
+                                            s->id, s->placer_id);
             char msg[192];
             snprintf(msg, sizeof(msg),
-                     "{\"type\":\"fortress_build_progress\",\"structure_id\":%u"
-                     ",\"company_id\":%u,\"island_id\":%u"
-                     ",\"progress_ms\":%.0f,\"total_ms\":%u,\"contested\":%s}",
-                     s->id, co, isl, s->claim_progress_ms,
-                     COMPANY_FORTRESS_BUILD_MS, contested ? "true" : "false");
+                     "{\"type\":\"fortress_complete\",\"structure_id\":%u"
+                     ",\"company_id\":%u,\"island_id\":%u}", s->id, co, isl);
             websocket_server_broadcast(msg);
+            return;
         }
     }
+
+    if (do_broadcast) {
+        char msg[192];
+        snprintf(msg, sizeof(msg),
+                 "{\"type\":\"fortress_build_progress\",\"structure_id\":%u"
+                 ",\"company_id\":%u,\"island_id\":%u"
+                 ",\"progress_ms\":%.0f,\"total_ms\":%u,\"contested\":%s}",
+                 s->id, co, isl, s->claim_progress_ms,
+                 COMPANY_FORTRESS_BUILD_MS, contested ? "true" : "false");
+        websocket_server_broadcast(msg);
+    }
 }
 
 /* ── Flag-Fort heal/activation tick ──────────────────────────────────────
@@ -713,324 +655,393 @@ static void fortress_tick(uint32_t delta_ms) {
  * FLAG_FORT_ACTIVE_HP_PCT threshold flips `fortress_complete`; the same
  * threshold is used in reverse (combat damage that drops HP below 30%
  * sets fortress_complete=false until it heals back). */
-static uint32_t flag_fort_broadcast_acc_ms = 0;
-static void flag_fort_tick(uint32_t delta_ms) {
-    flag_fort_broadcast_acc_ms += delta_ms;
-    bool do_broadcast = (flag_fort_broadcast_acc_ms >= 1000u);
-    if (do_broadcast) flag_fort_broadcast_acc_ms = 0;
-
-    for (uint32_t si = 0; si < placed_structure_count; si++) {
-        PlacedStructure *s = &placed_structures[si];
-        if (!s->active) continue;
-        if (s->type != STRUCT_FLAG_FORT) continue;
-
-        /* ════════════════════════════════════════════════════════════════
-         * PHASE: UNCLAIMING — fort was captured; its HP drains at 1%/s
-         * toward 0, then it enters the CLAIMING countdown for destruction.
-         * Checked BEFORE the claim_orphaned skip because UNCLAIMING forts
-         * are marked claim_orphaned=true (stops territory projection) but
-         * still need to tick. */
-        if (s->claim_phase == FLAG_FORT_PHASE_DEMOLISHING) {
-            uint8_t  isl = s->island_id;
-            uint8_t  co  = s->company_id;
-            float    dt  = (float)delta_ms;
-            /* 1% of max_hp per second — slow visible drain */
-            float drain = (float)s->max_hp * dt / 100000.0f;
-            s->claim_progress_ms -= drain;
-            if (s->claim_progress_ms < 0.0f) s->claim_progress_ms = 0.0f;
-            s->hp        = (uint16_t)s->claim_progress_ms;
-            s->target_hp = s->hp; /* prevent any repair system from countering the drain */
-
-            if (s->hp == 0) {
-                /* HP fully drained → enter CLAIMING for final countdown.
-                 * Defenders (original owner's company) can stall the timer;
-                 * if the zone is empty or attacker-only it counts down to
-                 * destruction with no grace period. */
-                s->claim_phase       = FLAG_FORT_PHASE_CLAIMING;
-                s->claim_progress_ms = 0.99f * (float)FLAG_FORT_CLAIM_MS;  /* start at 99% so bar goes 99%→0 */
-                s->claim_state       = CLAIM_FLAG_STATE_CONTEST;
-                s->claim_grace_ms    = 0.0f;
-                s->claim_contested   = false;
-                log_info("🚩 Flag Fort #%u (company %u, island %u) HP drained → CLAIMING (final countdown)",
-                         s->id, co, isl);
-                char umsg[320];
-                snprintf(umsg, sizeof(umsg),
-                         "{\"type\":\"flag_fort_build_progress\",\"structure_id\":%u"
-                         ",\"company_id\":%u,\"island_id\":%u"
-                         ",\"hp\":0,\"max_hp\":%u,\"fortress_complete\":false"
-                         ",\"contested\":false,\"claim_phase\":%u"
-                         ",\"claim_progress_ms\":%.0f,\"claim_total_ms\":%u"
-                         ",\"claim_state\":%u,\"claim_grace_ms\":0}",
-                         s->id, co, isl, s->max_hp,
-                         (unsigned)FLAG_FORT_PHASE_CLAIMING,
-                         s->claim_progress_ms, FLAG_FORT_CLAIM_MS,
-                         (unsigned)CLAIM_FLAG_STATE_CONTEST);
-                websocket_server_broadcast(umsg);
-            } else if (do_broadcast) {
-                char umsg[256];
-                snprintf(umsg, sizeof(umsg),
-                         "{\"type\":\"flag_fort_build_progress\",\"structure_id\":%u"
-                         ",\"company_id\":%u,\"island_id\":%u"
-                         ",\"hp\":%u,\"max_hp\":%u,\"fortress_complete\":false"
-                         ",\"contested\":false,\"claim_phase\":%u"
-                         ",\"claim_progress_ms\":%.0f,\"claim_total_ms\":0}",
-                         s->id, co, isl, s->hp, s->max_hp,
-                         (unsigned)FLAG_FORT_PHASE_DEMOLISHING,
-                         s->claim_progress_ms);
-                websocket_server_broadcast(umsg);
-            }
-            continue;
-        }
-
-        /* Post-demolish CLAIMING (hp==0, claim_orphaned=true) must still tick
-         * so the destruction countdown runs.  All other orphaned forts skip. */
-        if (s->claim_orphaned && !(s->claim_phase == FLAG_FORT_PHASE_CLAIMING && s->hp == 0)) continue;
-
-        float    fx  = s->x, fy = s->y;
+static void flag_fort_step(PlacedStructure *s, uint32_t delta_ms) {
+    s->claim_broadcast_acc_ms += delta_ms;
+    bool do_broadcast = (s->claim_broadcast_acc_ms >= 1000u);
+    if (do_broadcast) s->claim_broadcast_acc_ms = 0;
+
+    /* ════════════════════════════════════════════════════════════════
+     * PHASE: UNCLAIMING — fort was captured; its HP drains at 1%/s
+     * toward 0, then it enters the CLAIMING countdown for destruction.
+     * Checked BEFORE the claim_orphaned skip because UNCLAIMING forts
+     * are marked claim_orphaned=true (stops territory projection) but
+     * still need to tick. */
+    if (s->claim_phase == FLAG_FORT_PHASE_DEMOLISHING) {
         uint8_t  isl = s->island_id;
         uint8_t  co  = s->company_id;
         float    dt  = (float)delta_ms;
-
-        /* ── Save migration / sanity: if claim_phase is uninitialised (0) on
-         * a structure whose HP already indicates a later phase, snap it. This
-         * covers world saves written before claim_phase existed. */
-        if (s->claim_phase == FLAG_FORT_PHASE_CLAIMING) {
-            float hp_pct = (s->max_hp > 0) ? ((float)s->hp / (float)s->max_hp) : 0.0f;
-            if (hp_pct >= FLAG_FORT_ACTIVE_HP_PCT) {
-                s->claim_phase       = FLAG_FORT_PHASE_ACTIVE;
-                s->fortress_complete = true;
-                s->claim_progress_ms = (float)s->hp;
-            } else if (hp_pct > FLAG_FORT_INITIAL_HP_PCT + 0.001f) {
-                /* Already past initial HP — must be mid-build. */
-                s->claim_phase       = FLAG_FORT_PHASE_BUILDING;
-                s->claim_progress_ms = (float)s->hp;
-            }
+        /* 1% of max_hp per second — slow visible drain */
+        float drain = (float)s->max_hp * dt / 100000.0f;
+        s->claim_progress_ms -= drain;
+        if (s->claim_progress_ms < 0.0f) s->claim_progress_ms = 0.0f;
+        s->hp        = (uint16_t)s->claim_progress_ms;
+        s->target_hp = s->hp; /* prevent any repair system from countering the drain */
+
+        if (s->hp == 0) {
+            /* HP fully drained → enter CLAIMING for final countdown.
+             * Defenders (original owner's company) can stall the timer;
+             * if the zone is empty or attacker-only it counts down to
+             * destruction with no grace period. */
+            s->claim_phase       = FLAG_FORT_PHASE_CLAIMING;
+            s->claim_progress_ms = 0.99f * (float)FLAG_FORT_CLAIM_MS;  /* start at 99% so bar goes 99%→0 */
+            s->claim_state       = CLAIM_FLAG_STATE_CONTEST;
+            s->claim_grace_ms    = 0.0f;
+            s->claim_contested   = false;
+            log_info("🚩 Flag Fort #%u (company %u, island %u) HP drained → CLAIMING (final countdown)",
+                     s->id, co, isl);
+            char umsg[320];
+            snprintf(umsg, sizeof(umsg),
+                     "{\"type\":\"flag_fort_build_progress\",\"structure_id\":%u"
+                     ",\"company_id\":%u,\"island_id\":%u"
+                     ",\"hp\":0,\"max_hp\":%u,\"fortress_complete\":false"
+                     ",\"contested\":false,\"claim_phase\":%u"
+                     ",\"claim_progress_ms\":%.0f,\"claim_total_ms\":%u"
+                     ",\"claim_state\":%u,\"claim_grace_ms\":0}",
+                     s->id, co, isl, s->max_hp,
+                     (unsigned)FLAG_FORT_PHASE_CLAIMING,
+                     s->claim_progress_ms, FLAG_FORT_CLAIM_MS,
+                     (unsigned)CLAIM_FLAG_STATE_CONTEST);
+            websocket_server_broadcast(umsg);
+        } else if (do_broadcast) {
+            char umsg[256];
+            snprintf(umsg, sizeof(umsg),
+                     "{\"type\":\"flag_fort_build_progress\",\"structure_id\":%u"
+                     ",\"company_id\":%u,\"island_id\":%u"
+                     ",\"hp\":%u,\"max_hp\":%u,\"fortress_complete\":false"
+                     ",\"contested\":false,\"claim_phase\":%u"
+                     ",\"claim_progress_ms\":%.0f,\"claim_total_ms\":0}",
+                     s->id, co, isl, s->hp, s->max_hp,
+                     (unsigned)FLAG_FORT_PHASE_DEMOLISHING,
+                     s->claim_progress_ms);
+            websocket_server_broadcast(umsg);
         }
+        return;
+    }
 
-        /* ════════════════════════════════════════════════════════════════
-         * PHASE: CLAIMING (1 min ground-claim, mirrors claim_flag rules)
-         *   - non-damageable (handled at damage source)
-         *   - HP pinned at 10% (we leave it where placement put it)
-         *   - claim_progress_ms counts FLAG_FORT_CLAIM_MS → 0
-         *   - enemy player in radius → CONTEST (stall, no progress)
-         *   - allies-only → CLAIMING (after 5 s grace)
-         *   - empty → CONTEST (stall)
-         * On reaching 0 → transition to BUILDING phase. */
-        if (s->claim_phase == FLAG_FORT_PHASE_CLAIMING) {
-            /* hp==0 means this fort transitioned here from UNCLAIMING (it
-             * was captured and its HP was drained to zero).  In that mode
-             * the contestant logic is inverted: the ORIGINAL OWNER's players
-             * stall the destruction timer; everyone else (or an empty zone)
-             * counts it down toward the fort being destroyed. */
-            bool is_post_capture = (s->hp == 0);
-
-            bool ally_present  = false;
-            bool enemy_present = false;
-            for (uint32_t pi = 0; pi < MAX_PLAYERS; pi++) {
-                WebSocketPlayer *p = &players[pi];
-                if (!p->active || p->player_id == 0) continue;
-                if ((uint8_t)p->on_island_id != isl) continue;
-                float dx = p->x - fx, dy = p->y - fy;
-                if (dx*dx + dy*dy > CLAIM_RADIUS_FLAG_FORT * CLAIM_RADIUS_FLAG_FORT) continue;
-                if ((uint8_t)p->company_id == co) ally_present = true;
-                else                              enemy_present = true;
-            }
-
-            uint8_t desired;
-            if (is_post_capture) {
-                /* Defenders (original owner) stall; empty or attacker → countdown */
-                desired = ally_present ? CLAIM_FLAG_STATE_CONTEST : CLAIM_FLAG_STATE_CLAIMING;
-            } else if (enemy_present) {
-                desired = CLAIM_FLAG_STATE_CONTEST;
-            } else if (ally_present) {
-                desired = CLAIM_FLAG_STATE_CLAIMING;
-            } else {
-                desired = CLAIM_FLAG_STATE_CONTEST;
-            }
-
-            if (desired == CLAIM_FLAG_STATE_CONTEST) {
-                s->claim_state    = CLAIM_FLAG_STATE_CONTEST;
-                s->claim_grace_ms = 0.0f;
-            } else { /* CLAIMING */
-                if (is_post_capture) {
-                    /* No grace period for post-capture countdown */
-                    if (s->claim_state != CLAIM_FLAG_STATE_CLAIMING) {
-                        s->claim_state    = CLAIM_FLAG_STATE_CLAIMING;
-                        s->claim_grace_ms = 0.0f;
-                    }
-                } else if (s->claim_state == CLAIM_FLAG_STATE_CLAIMING) {
-                    /* already counting down */
-                } else if (s->claim_state == CLAIM_FLAG_STATE_CLAIMING_GRACE) {
-                    s->claim_grace_ms += dt;
-                    if (s->claim_grace_ms >= (float)FLAG_FORT_CLAIM_GRACE_MS) {
-                        s->claim_state    = CLAIM_FLAG_STATE_CLAIMING;
-                        s->claim_grace_ms = 0.0f;
-                    }
-                } else {
-                    s->claim_state    = CLAIM_FLAG_STATE_CLAIMING_GRACE;
-                    s->claim_grace_ms = 0.0f;
-                }
-            }
-            s->claim_contested = (s->claim_state == CLAIM_FLAG_STATE_CONTEST);
-
-            if (s->claim_state == CLAIM_FLAG_STATE_CLAIMING) {
-                /* Post-capture UNCLAIMING drains 10× faster than a normal claim */
-                s->claim_progress_ms -= (is_post_capture ? 10.0f * dt : dt);
-                if (s->claim_progress_ms <= 0.0f) {
-                    if (is_post_capture) {
-                        /* Post-capture countdown expired — fort is destroyed */
-                        log_info("🚩 Flag Fort #%u (company %u, island %u) reclaim window expired → destroyed",
-                                 s->id, co, isl);
-                        destroy_placed_structure(s->id, NAN, NAN);
-                        continue;
-                    }
-                    /* Claim phase complete → enter BUILDING.
-                     * Re-purpose claim_progress_ms as the float-HP accumulator. */
-                    s->claim_phase       = FLAG_FORT_PHASE_BUILDING;
-                    s->claim_progress_ms = (float)s->hp;
-                    s->claim_state       = CLAIM_FLAG_STATE_CONTEST;
-                    s->claim_grace_ms    = 0.0f;
-                    s->claim_contested   = false;
-                    log_info("🚩 Flag Fort #%u (company %u, island %u) claim phase complete → BUILDING",
-                             s->id, co, isl);
-                }
-            }
-
-            if (do_broadcast) {
-                char msg[320];
-                snprintf(msg, sizeof(msg),
-                         "{\"type\":\"flag_fort_build_progress\",\"structure_id\":%u"
-                         ",\"company_id\":%u,\"island_id\":%u"
-                         ",\"hp\":%u,\"max_hp\":%u,\"fortress_complete\":false"
-                         ",\"contested\":%s,\"claim_phase\":%u"
-                         ",\"claim_progress_ms\":%.0f,\"claim_total_ms\":%u"
-                         ",\"claim_state\":%u,\"claim_grace_ms\":%.0f}",
-                         s->id, co, isl,
-                         s->hp, s->max_hp,
-                         s->claim_contested ? "true" : "false",
-                         (unsigned)s->claim_phase,
-                         s->claim_progress_ms,
-                         FLAG_FORT_CLAIM_MS,
-                         (unsigned)s->claim_state,
-                         s->claim_grace_ms);
-                websocket_server_broadcast(msg);
-            }
-            continue;
+    /* Post-demolish CLAIMING (hp==0, claim_orphaned=true) must still tick
+     * so the destruction countdown runs.  All other orphaned forts skip. */
+    if (s->claim_orphaned && !(s->claim_phase == FLAG_FORT_PHASE_CLAIMING && s->hp == 0)) return;
+
+    float    fx  = s->x, fy = s->y;
+    uint8_t  isl = s->island_id;
+    uint8_t  co  = s->company_id;
+    float    dt  = (float)delta_ms;
+
+    /* ── Save migration / sanity: if claim_phase is uninitialised (0) on
+     * a structure whose HP already indicates a later phase, snap it. This
+     * covers world saves written before claim_phase existed. */
+    if (s->claim_phase == FLAG_FORT_PHASE_CLAIMING) {
+        float hp_pct = (s->max_hp > 0) ? ((float)s->hp / (float)s->max_hp) : 0.0f;
+        if (hp_pct >= FLAG_FORT_ACTIVE_HP_PCT) {
+            s->claim_phase       = FLAG_FORT_PHASE_ACTIVE;
+            s->fortress_complete = true;
+            s->claim_progress_ms = (float)s->hp;
+        } else if (hp_pct > FLAG_FORT_INITIAL_HP_PCT + 0.001f) {
+            /* Already past initial HP — must be mid-build. */
+            s->claim_phase       = FLAG_FORT_PHASE_BUILDING;
+            s->claim_progress_ms = (float)s->hp;
         }
+    }
 
-        /* ════════════════════════════════════════════════════════════════
-         * PHASE: BUILDING / ACTIVE (existing heal + activation gate)
-         * Detect any enemy player within the fort's claim radius — heal is
-         * paused while contested (mirrors Company Fortress behaviour). */
-        bool contested = false;
+    /* ════════════════════════════════════════════════════════════════
+     * PHASE: CLAIMING (1 min ground-claim, mirrors claim_flag rules)
+     *   - non-damageable (handled at damage source)
+     *   - HP pinned at 10% (we leave it where placement put it)
+     *   - claim_progress_ms counts FLAG_FORT_CLAIM_MS → 0
+     *   - enemy player in radius → CONTEST (stall, no progress)
+     *   - allies-only → CLAIMING (after 5 s grace)
+     *   - empty → CONTEST (stall)
+     * On reaching 0 → transition to BUILDING phase. */
+    if (s->claim_phase == FLAG_FORT_PHASE_CLAIMING) {
+        /* hp==0 means this fort transitioned here from UNCLAIMING (it
+         * was captured and its HP was drained to zero).  In that mode
+         * the contestant logic is inverted: the ORIGINAL OWNER's players
+         * stall the destruction timer; everyone else (or an empty zone)
+         * counts it down toward the fort being destroyed. */
+        bool is_post_capture = (s->hp == 0);
+
+        bool ally_present  = false;
+        bool enemy_present = false;
         for (uint32_t pi = 0; pi < MAX_PLAYERS; pi++) {
             WebSocketPlayer *p = &players[pi];
             if (!p->active || p->player_id == 0) continue;
-            if ((uint8_t)p->company_id == co) continue;
             if ((uint8_t)p->on_island_id != isl) continue;
             float dx = p->x - fx, dy = p->y - fy;
-            if (dx*dx + dy*dy <= CLAIM_RADIUS_FLAG_FORT * CLAIM_RADIUS_FLAG_FORT) {
-                contested = true;
-                break;
-            }
-        }
-        s->claim_contested = contested;
-
-        /* hp is uint16_t and per-tick heal is sub-1 (≈0.027 hp at 16ms), so
-         * naïve integer accumulation truncates to zero every tick. We carry
-         * a float accumulator in claim_progress_ms (repurposed for flag forts:
-         * "fractional current hp" in [0, max_hp]) and re-derive integer hp
-         * by truncation each tick. The float is normally `hp + fractional`
-         * (0 ≤ fractional < 1). External writes to s->hp (combat damage or
-         * repair) will set hp to a value that is NOT equal to truncate(float)
-         * — detect that and resync the float to hp so healing resumes from
-         * the new integer value. */
-        if ((uint32_t)s->claim_progress_ms != s->hp) {
-            s->claim_progress_ms = (float)s->hp;
+            if (dx*dx + dy*dy > CLAIM_RADIUS_FLAG_FORT * CLAIM_RADIUS_FLAG_FORT) continue;
+            if ((uint8_t)p->company_id == co) ally_present = true;
+            else                              enemy_present = true;
         }
 
-        /* Save migration: target_hp is the heal ceiling. Forts saved before this
-         * field existed read back as 0 — default to max_hp so they can repair. */
-        if (s->target_hp == 0 || s->target_hp > s->max_hp) s->target_hp = s->max_hp;
-        /* Heal toward target_hp (target_hp ≤ max_hp; combat damage permanently
-         * lowers target_hp via apply_structure_damage). Contesting no longer
-         * pauses building progression — only combat damage can slow it. */
-        if (s->claim_progress_ms < (float)s->target_hp) {
-            float heal = (float)s->max_hp * (float)delta_ms / (float)FLAG_FORT_BUILD_MS;
-            s->claim_progress_ms += heal;
-            if (s->claim_progress_ms > (float)s->target_hp) s->claim_progress_ms = (float)s->target_hp;
-            s->hp = (uint16_t)s->claim_progress_ms;
+        uint8_t desired;
+        if (is_post_capture) {
+            /* Defenders (original owner) stall; empty or attacker → countdown */
+            desired = ally_present ? CLAIM_FLAG_STATE_CONTEST : CLAIM_FLAG_STATE_CLAIMING;
+        } else if (enemy_present) {
+            desired = CLAIM_FLAG_STATE_CONTEST;
+        } else if (ally_present) {
+            desired = CLAIM_FLAG_STATE_CLAIMING;
+        } else {
+            desired = CLAIM_FLAG_STATE_CONTEST;
         }
 
-        /* Activation / deactivation gate (BUILDING ↔ ACTIVE). */
-        bool should_be_active = ((float)s->hp >= FLAG_FORT_ACTIVE_HP_PCT * (float)s->max_hp);
-        uint8_t new_phase = should_be_active ? FLAG_FORT_PHASE_ACTIVE : FLAG_FORT_PHASE_BUILDING;
-        if (new_phase != s->claim_phase || should_be_active != s->fortress_complete) {
-            bool was_active = s->fortress_complete;
-            s->claim_phase       = new_phase;
-            s->fortress_complete = should_be_active;
-            char amsg[224];
-            snprintf(amsg, sizeof(amsg),
-                     "{\"type\":\"flag_fort_active\",\"structure_id\":%u"
-                     ",\"company_id\":%u,\"island_id\":%u,\"active\":%s"
-                     ",\"claim_phase\":%u}",
-                     s->id, co, isl, should_be_active ? "true" : "false",
-                     (unsigned)new_phase);
-            websocket_server_broadcast(amsg);
-            log_info("🚩 Flag Fort #%u (company %u, island %u) %s (hp=%u/%u)",
-                     s->id, co, isl,
-                     should_be_active ? "ACTIVATED" : "deactivated",
-                     s->hp, s->max_hp);
+        if (desired == CLAIM_FLAG_STATE_CONTEST) {
+            s->claim_state    = CLAIM_FLAG_STATE_CONTEST;
+            s->claim_grace_ms = 0.0f;
+        } else { /* CLAIMING */
+            if (is_post_capture) {
+                /* No grace period for post-capture countdown */
+                if (s->claim_state != CLAIM_FLAG_STATE_CLAIMING) {
+                    s->claim_state    = CLAIM_FLAG_STATE_CLAIMING;
+                    s->claim_grace_ms = 0.0f;
+                }
+            } else if (s->claim_state == CLAIM_FLAG_STATE_CLAIMING) {
+                /* already counting down */
+            } else if (s->claim_state == CLAIM_FLAG_STATE_CLAIMING_GRACE) {
+                s->claim_grace_ms += dt;
+                if (s->claim_grace_ms >= (float)FLAG_FORT_CLAIM_GRACE_MS) {
+                    s->claim_state    = CLAIM_FLAG_STATE_CLAIMING;
+                    s->claim_grace_ms = 0.0f;
+                }
+            } else {
+                s->claim_state    = CLAIM_FLAG_STATE_CLAIMING_GRACE;
+                s->claim_grace_ms = 0.0f;
+            }
+        }
+        s->claim_contested = (s->claim_state == CLAIM_FLAG_STATE_CONTEST);
 
-            if (should_be_active && !was_active) {
-                /* Fort just became active — its own DOM list was already
-                 * populated at placement. Flag forts never appear in enemy
-                 * DOM lists, so no reverse registration is needed here. */
+        if (s->claim_state == CLAIM_FLAG_STATE_CLAIMING) {
+            /* Post-capture UNCLAIMING drains 10× faster than a normal claim */
+            s->claim_progress_ms -= (is_post_capture ? 10.0f * dt : dt);
+            if (s->claim_progress_ms <= 0.0f) {
+                if (is_post_capture) {
+                    /* Post-capture countdown expired — fort is destroyed */
+                    log_info("🚩 Flag Fort #%u (company %u, island %u) reclaim window expired → destroyed",
+                             s->id, co, isl);
+                    destroy_placed_structure(s->id, NAN, NAN);
+                    return;
+                }
+                /* Claim phase complete → enter BUILDING.
+                 * Re-purpose claim_progress_ms as the float-HP accumulator. */
+                s->claim_phase       = FLAG_FORT_PHASE_BUILDING;
+                s->claim_progress_ms = (float)s->hp;
+                s->claim_state       = CLAIM_FLAG_STATE_CONTEST;
+                s->claim_grace_ms    = 0.0f;
+                s->claim_contested   = false;
+                log_info("🚩 Flag Fort #%u (company %u, island %u) claim phase complete → BUILDING",
+                         s->id, co, isl);
             }
         }
 
         if (do_broadcast) {
-            char msg[352];
+            char msg[320];
             snprintf(msg, sizeof(msg),
                      "{\"type\":\"flag_fort_build_progress\",\"structure_id\":%u"
                      ",\"company_id\":%u,\"island_id\":%u"
-                     ",\"hp\":%u,\"max_hp\":%u,\"target_hp\":%u,\"fortress_complete\":%s"
-                     ",\"contested\":%s,\"claim_phase\":%u}",
+                     ",\"hp\":%u,\"max_hp\":%u,\"fortress_complete\":false"
+                     ",\"contested\":%s,\"claim_phase\":%u"
+                     ",\"claim_progress_ms\":%.0f,\"claim_total_ms\":%u"
+                     ",\"claim_state\":%u,\"claim_grace_ms\":%.0f}",
                      s->id, co, isl,
-                     s->hp, s->max_hp, s->target_hp,
-                     s->fortress_complete ? "true" : "false",
-                     contested ? "true" : "false",
-                     (unsigned)s->claim_phase);
+                     s->hp, s->max_hp,
+                     s->claim_contested ? "true" : "false",
+                     (unsigned)s->claim_phase,
+                     s->claim_progress_ms,
+                     FLAG_FORT_CLAIM_MS,
+                     (unsigned)s->claim_state,
+                     s->claim_grace_ms);
             websocket_server_broadcast(msg);
         }
+        return;
     }
+
+    /* ════════════════════════════════════════════════════════════════
+     * PHASE: BUILDING / ACTIVE (existing heal + activation gate)
+     * Detect any enemy player within the fort's claim radius — heal is
+     * paused while contested (mirrors Company Fortress behaviour). */
+    bool contested = false;
+    for (uint32_t pi = 0; pi < MAX_PLAYERS; pi++) {
+        WebSocketPlayer *p = &players[pi];
+        if (!p->active || p->player_id == 0) continue;
+        if ((uint8_t)p->company_id == co) continue;
+        if ((uint8_t)p->on_island_id != isl) continue;
+        float dx = p->x - fx, dy = p->y - fy;
+        if (dx*dx + dy*dy <= CLAIM_RADIUS_FLAG_FORT * CLAIM_RADIUS_FLAG_FORT) {
+            contested = true;
+            break;
+        }
+    }
+    s->claim_contested = contested;
+
+    /* hp is uint16_t and per-tick heal is sub-1 (≈0.027 hp at 16ms), so
+     * naïve integer accumulation truncates to zero every tick. We carry
+     * a float accumulator in claim_progress_ms (repurposed for flag forts:
+     * "fractional current hp" in [0, max_hp]) and re-derive integer hp
+     * by truncation each tick. The float is normally `hp + fractional`
+     * (0 ≤ fractional < 1). External writes to s->hp (combat damage or
+     * repair) will set hp to a value that is NOT equal to truncate(float)
+     * — detect that and resync the float to hp so healing resumes from
+     * the new integer value. */
+    if ((uint32_t)s->claim_progress_ms != s->hp) {
+        s->claim_progress_ms = (float)s->hp;
+    }
+
+    /* Save migration: target_hp is the heal ceiling. Forts saved before this
+     * field existed read back as 0 — default to max_hp so they can repair. */
+    if (s->target_hp == 0 || s->target_hp > s->max_hp) s->target_hp = s->max_hp;
+    /* Heal toward target_hp (target_hp ≤ max_hp; combat damage permanently
+     * lowers target_hp via apply_structure_damage). Contesting no longer
+     * pauses building progression — only combat damage can slow it. */
+    if (s->claim_progress_ms < (float)s->target_hp) {
+        float heal = (float)s->max_hp * (float)delta_ms / (float)FLAG_FORT_BUILD_MS;
+        s->claim_progress_ms += heal;
+        if (s->claim_progress_ms > (float)s->target_hp) s->claim_progress_ms = (float)s->target_hp;
+        s->hp = (uint16_t)s->claim_progress_ms;
+    }
+
+    /* Activation / deactivation gate (BUILDING ↔ ACTIVE). */
+    bool should_be_active = ((float)s->hp >= FLAG_FORT_ACTIVE_HP_PCT * (float)s->max_hp);
+    uint8_t new_phase = should_be_active ? FLAG_FORT_PHASE_ACTIVE : FLAG_FORT_PHASE_BUILDING;
+    if (new_phase != s->claim_phase || should_be_active != s->fortress_complete) {
+        bool was_active = s->fortress_complete;
+        s->claim_phase       = new_phase;
+        s->fortress_complete = should_be_active;
+        char amsg[224];
+        snprintf(amsg, sizeof(amsg),
+                 "{\"type\":\"flag_fort_active\",\"structure_id\":%u"
+                 ",\"company_id\":%u,\"island_id\":%u,\"active\":%s"
+                 ",\"claim_phase\":%u}",
+                 s->id, co, isl, should_be_active ? "true" : "false",
+                 (unsigned)new_phase);
+        websocket_server_broadcast(amsg);
+        log_info("🚩 Flag Fort #%u (company %u, island %u) %s (hp=%u/%u)",
+                 s->id, co, isl,
+                 should_be_active ? "ACTIVATED" : "deactivated",
+                 s->hp, s->max_hp);
+
+        if (should_be_active && !was_active) {
+            /* Fort just became active — its own DOM list was already
+             * populated at placement. Flag forts never appear in enemy
+             * DOM lists, so no reverse registration is needed here. */
+        }
+    }
+
+    if (do_broadcast) {
+        char msg[352];
+        snprintf(msg, sizeof(msg),
+                 "{\"type\":\"flag_fort_build_progress\",\"structure_id\":%u"
+                 ",\"company_id\":%u,\"island_id\":%u"
+                 ",\"hp\":%u,\"max_hp\":%u,\"target_hp\":%u,\"fortress_complete\":%s"
+                 ",\"contested\":%s,\"claim_phase\":%u}",
+                 s->id, co, isl,
+                 s->hp, s->max_hp, s->target_hp,
+                 s->fortress_complete ? "true" : "false",
+                 contested ? "true" : "false",
+                 (unsigned)s->claim_phase);
+        websocket_server_broadcast(msg);
+    }
+}
+
+/* ── Fort timers ─────────────────────────────────────────────────────────
+ * Each flag fort and each unfinished Company Fortress keeps one timer on the
+ * game timer wheel.  While a fort has work (claiming, building, healing,
+ * demolishing) the timer re-arms for the next tick and the step gets the
+ * time since the last one.  A settled flag fort only needs its contest flag
+ * and the 1 Hz progress broadcast, so it drops to FLAG_FORT_IDLE_POLL_MS; a
+ * finished fortress holds no timer at all.  Anything that hands a fort new
+ * work calls claim_fort_wake(). */
+#define FLAG_FORT_IDLE_POLL_MS 1000u
+
+static void claim_fort_fire(uint32_t arg, uint32_t now_ms, uint32_t elapsed_ms);
+
+static TimerKind claim_fort_kind(void) {
+    static TimerKind kind;
+    if (!kind) kind = timer_wheel_kind("kind=\"claim_fort\"", claim_fort_fire);
+    return kind;
+}
+
+static bool flag_fort_busy(const PlacedStructure *s) {
+    if (s->claim_phase == FLAG_FORT_PHASE_DEMOLISHING) return true;
+    if (s->claim_phase == FLAG_FORT_PHASE_CLAIMING)
+        return !s->claim_orphaned || s->hp == 0;
+    return !s->claim_orphaned && s->hp < s->target_hp;
+}
+
+static void claim_fort_arm(PlacedStructure *s, uint32_t now_ms, bool idle) {
+    s->claim_timer_idle = idle;
+    s->claim_timer = timer_wheel_schedule(claim_fort_kind(), structure_handle(s), now_ms,
+                                          idle ? FLAG_FORT_IDLE_POLL_MS : 0u);
+}
+
+static void claim_fort_fire(uint32_t arg, uint32_t now_ms, uint32_t elapsed_ms) {
+    PlacedStructure *s = structure_from_handle(arg);
+    if (!s) return;   /* destroyed */
+    /* A newer timer owns this fort (re-armed after a world reload) */
+    if (timer_wheel_pending(s->claim_timer)) return;
+    s->claim_timer = 0;
+    if (s->type == STRUCT_COMPANY_FORTRESS) {
+        if (s->fortress_complete) return;
+        fortress_step(s, elapsed_ms);
+        if (!s->fortress_complete) claim_fort_arm(s, now_ms, false);
+    } else if (s->type == STRUCT_FLAG_FORT) {
+        flag_fort_step(s, elapsed_ms);
+        if (s->active) claim_fort_arm(s, now_ms, !flag_fort_busy(s));
+    }
+}
+
+void claim_fort_wake(PlacedStructure *s) {
+    if (!s || !s->active) return;
+    if (s->type == STRUCT_COMPANY_FORTRESS) {
+        if (s->fortress_complete) return;
+    } else if (s->type != STRUCT_FLAG_FORT) {
+        return;
+    }
+    /* A per-tick step already pending covers it; an idle poll is replaced so
+     * the first busy step isn't credited with the idle time before it */
+    if (timer_wheel_pending(s->claim_timer)) {
+        if (!s->claim_timer_idle) return;
+        timer_wheel_cancel(s->claim_timer);
+    }
+    claim_fort_arm(s, get_time_ms(), false);
+}
+
+void claim_forts_wake_all(void) {
+    uint32_t n;
+    const uint32_t *slots = structure_slots_of_type(STRUCT_FLAG_FORT, &n);
+    for (uint32_t i = 0; i < n; i++) claim_fort_wake(&placed_structures[slots[i]]);
+    slots = structure_slots_of_type(STRUCT_COMPANY_FORTRESS, &n);
+    for (uint32_t i = 0; i < n; i++) claim_fort_wake(&placed_structures[slots[i]]);
 }
 
 void claim_tick(uint32_t delta_ms) {
-    /* Advance Company Fortress build timers */
-    fortress_tick(delta_ms);
-    /* Advance Flag Fort heal/activation gate */
-    flag_fort_tick(delta_ms);
-    /* Advance any in-progress player-initiated structure repairs */
-    structure_repair_tick(delta_ms);
+    /* Fortress builds, flag-fort phases and structure repairs run from their
+     * own timers (timer_wheel_advance in websocket_server_tick). */
+    structure_garbage_collect();
 
     /* ── Claim-flag progress ──────────────────────────────────────────── */
-    for (uint32_t si = 0; si < placed_structure_count; si++) {
-        PlacedStructure *s = &placed_structures[si];
+    /* Pick up anchor changes made since the last tick (orphaning, fort
+     * completion, captures) before any flag reads its cached section. */
+    claim_invalidate_cf_sections();
+
+    /* Flags resolve in slot order, as a full scan would.  The type list is
+     * copied first: resolving a flag frees structures (flags included). */
+    static uint32_t flag_slots[MAX_PLACED_STRUCTURES];
+    uint32_t n_flags;
+    const uint32_t *cf = structure_slots_of_type(STRUCT_CLAIM_FLAG, &n_flags);
+    for (uint32_t k = 0; k < n_flags; k++) {
+        uint32_t v = cf[k], b = k;
+        for (; b > 0 && flag_slots[b - 1] > v; b--) flag_slots[b] = flag_slots[b - 1];
+        flag_slots[b] = v;
+    }
+    for (uint32_t fk = 0; fk < n_flags; fk++) {
+        PlacedStructure *s = &placed_structures[flag_slots[fk]];
         if (!s->active) continue;
         if (s->type != STRUCT_CLAIM_FLAG) continue;
 
         float dt = (float)delta_ms;
 
         /* Resolve source structures by id */
-        PlacedStructure *src_mine  = NULL;
-        PlacedStructure *src_enemy = NULL;
-        for (uint32_t ti = 0; ti < placed_structure_count; ti++) {
-            PlacedStructure *t = &placed_structures[ti];
-            if (!t->active) continue;
-            if (t->id == s->claim_linked_fort)  src_mine  = t;
-            if (t->id == s->claim_source_enemy) src_enemy = t;
-        }
+        PlacedStructure *src_mine  = structure_by_id(s->claim_linked_fort);
+        PlacedStructure *src_enemy = structure_by_id(s->claim_source_enemy);
         /* If mine is gone/orphaned or company ownership changed, the flag is
          * invalid.  src_enemy being orphaned is intentional (inactive territory
          * capture) — keep the flag alive in that case. */
@@ -1038,8 +1049,8 @@ void claim_tick(uint32_t delta_ms) {
             src_mine->claim_orphaned ||
             src_mine->company_id  != s->company_id ||
             src_enemy->company_id == s->company_id) {
-            cf_section_release(s->id);
-            s->active = false;
+            claim_flag_section_release(s->id);
+            structure_free(s);
             char dmsg[128];
             snprintf(dmsg, sizeof(dmsg),
                      "{\"type\":\"structure_demolished\",\"structure_id\":%u}", s->id);
@@ -1059,14 +1070,9 @@ void claim_tick(uint32_t delta_ms) {
         /* The section is the connected component of (lens_union ∖ tmp_own)
          * containing the flag's position.  It is the canonical "contest area"
          * and is larger than the single src_mine∩src_enemy lens when multiple
-         * overlapping pairs exist on the island.  Built lazily; invalidated by
-         * claim_invalidate_cf_sections() whenever structures change. */
-        if (s->id < MAX_PLACED_STRUCTURES && !cf_section_cache[s->id]) {
-            cf_section_cache[s->id] = claim_section_build(
-                s->island_id, s->company_id, s->x, s->y);
-        }
-        const ClaimSectionGrid *sec = (s->id < MAX_PLACED_STRUCTURES)
-                                      ? cf_section_cache[s->id] : NULL;
+         * overlapping pairs exist on the island.  Cached per flag and rebuilt
+         * only when claim_invalidate_cf_sections() sees a change nearby. */
+        const ClaimSectionGrid *sec = claim_flag_section(s);
 
         bool ally_present  = false;
         bool enemy_present = false;
@@ -1201,6 +1207,7 @@ void claim_tick(uint32_t delta_ms) {
                 src_mine->hp                = 1;
                 src_mine->target_hp         = src_mine->max_hp;
                 src_mine->claim_progress_ms = 1.0f;
+                claim_fort_wake(src_mine);
 
                 /* Flip DOM relationship. */
                 if (dominators_remove(src_mine, src_enemy->id))
@@ -1228,8 +1235,8 @@ void claim_tick(uint32_t delta_ms) {
                          s->id, src_mine->id, co, isl);
 
                 /* Consume the claim flag. */
-                cf_section_release(s->id);
-                s->active = false;
+                claim_flag_section_release(s->id);
+                structure_free(s);
                 char dmsg[128];
                 snprintf(dmsg, sizeof(dmsg),
                          "{\"type\":\"structure_demolished\",\"structure_id\":%u}", s->id);
@@ -1253,13 +1260,11 @@ void claim_tick(uint32_t delta_ms) {
                 memset(ict_visited, 0, sizeof(bool) * placed_structure_count);
                 int ict_n = 0, iqh = 0, iqt = 0;
 
-                for (uint32_t i = 0; i < placed_structure_count; i++) {
-                    if (placed_structures[i].id == src_enemy->id) {
-                        ict_visited[i] = true;
-                        ict_ids[ict_n++] = src_enemy->id;
-                        ict_queue[iqt++] = (int32_t)i;
-                        break;
-                    }
+                {
+                    uint32_t i = (uint32_t)(src_enemy - placed_structures);
+                    ict_visited[i] = true;
+                    ict_ids[ict_n++] = src_enemy->id;
+                    ict_queue[iqt++] = (int32_t)i;
                 }
                 while (iqh < iqt) {
                     int32_t ci = ict_queue[iqh++];
@@ -1295,16 +1300,8 @@ void claim_tick(uint32_t delta_ms) {
                     static int32_t  rq[MAX_PLACED_STRUCTURES];
                     memset(ict_reach, 0, sizeof(bool) * (size_t)ict_n);
 
-                    /* Cache pointers for speed (avoid repeated linear scans). */
-                    for (int k = 0; k < ict_n; k++) {
-                        ict_ptrs[k] = NULL;
-                        for (uint32_t i = 0; i < placed_structure_count; i++) {
-                            if (placed_structures[i].active &&
-                                placed_structures[i].id == ict_ids[k]) {
-                                ict_ptrs[k] = &placed_structures[i]; break;
-                            }
-                        }
-                    }
+                    for (int k = 0; k < ict_n; k++)
+                        ict_ptrs[k] = structure_by_id(ict_ids[k]);
 
                     float mine_cr = struct_claim_radius(src_mine->type);
                     int rqh2 = 0, rqt2 = 0;
@@ -1349,12 +1346,7 @@ void claim_tick(uint32_t delta_ms) {
 
                 int converted_n = 0;
                 for (int k = 0; k < ict_n; k++) {
-                    PlacedStructure *os = NULL;
-                    for (uint32_t i = 0; i < placed_structure_count; i++) {
-                        if (placed_structures[i].active && placed_structures[i].id == ict_ids[k]) {
-                            os = &placed_structures[i]; break;
-                        }
-                    }
+                    PlacedStructure *os = structure_by_id(ict_ids[k]);
                     if (!os) continue;
                     /* Flag forts are already draining in DEMOLISHING — leave them. */
                     if (os->type == STRUCT_FLAG_FORT) continue;
@@ -1404,8 +1396,8 @@ void claim_tick(uint32_t delta_ms) {
                 log_info("🏴 Claim Flag #%u: inactive sweep → %d structure(s) transferred (co %u→%u, island %u)",
                          s->id, converted_n, old_co, s->company_id, isl);
                 claim_invalidate_cf_sections();
-                cf_section_release(s->id);
-                s->active = false;
+                claim_flag_section_release(s->id);
+                structure_free(s);
                 char dmsg_ict[128];
                 snprintf(dmsg_ict, sizeof(dmsg_ict),
                          "{\"type\":\"structure_demolished\",\"structure_id\":%u}", s->id);
@@ -1422,25 +1414,10 @@ void claim_tick(uint32_t delta_ms) {
              * this island, not just the single (src_mine × src_enemy) pair that
              * was registered at placement time.  Using only the single pair would
              * leave structures that lie in other overlapping lenses uncaptured. */
-            static float    mine_anch_x[256], mine_anch_y[256], mine_anch_r[256];
-            static uint32_t mine_anch_id[256];
-            static float    enmy_anch_x[256], enmy_anch_y[256], enmy_anch_r[256];
-            static uint32_t enmy_anch_id[256];
-            int mine_an = 0, enmy_an = 0;
-            for (uint32_t ai = 0; ai < placed_structure_count; ai++) {
-                PlacedStructure *an = &placed_structures[ai];
-                if (!an->active || an->claim_orphaned || an->island_id != isl) continue;
-                if (an->type == STRUCT_CLAIM_FLAG) continue;
-                float ar = struct_claim_radius(an->type);
-                if (ar <= 0.0f) continue;
-                if (an->type == STRUCT_FLAG_FORT && !an->fortress_complete) continue;
-                if (an->company_id == (uint8_t)s->company_id && mine_an < 256) {
-                    mine_anch_x[mine_an] = an->x; mine_anch_y[mine_an] = an->y;
-                    mine_anch_r[mine_an] = ar; mine_anch_id[mine_an] = an->id; mine_an++;
-                } else if (an->company_id == old_co && enmy_an < 256) {
-                    enmy_anch_x[enmy_an] = an->x; enmy_anch_y[enmy_an] = an->y;
-                    enmy_anch_r[enmy_an] = ar; enmy_anch_id[enmy_an] = an->id; enmy_an++;
-                }
+            ClaimAnchorSet mine, enmy;
+            if (!claim_capture_anchors(isl, (uint8_t)s->company_id, (uint8_t)old_co, &mine, &enmy)) {
+                log_warn("🏴 Claim Flag #%u: out of memory gathering anchors — capture deferred", s->id);
+                continue;
             }
 
             /* ── Collect victims & challengers using union-of-lens geometry.
@@ -1455,18 +1432,8 @@ void claim_tick(uint32_t delta_ms) {
                 PlacedStructure *ps = &placed_structures[i];
                 if (!ps->active || ps->claim_orphaned) continue;
                 if (ps->island_id != isl || ps->id == s->id) continue;
-                bool v_in_mine = false;
-                for (int _a = 0; _a < mine_an && !v_in_mine; _a++) {
-                    float _dx = ps->x - mine_anch_x[_a], _dy = ps->y - mine_anch_y[_a];
-                    if (_dx*_dx + _dy*_dy <= mine_anch_r[_a] * mine_anch_r[_a]) v_in_mine = true;
-                }
-                if (!v_in_mine) continue;
-                bool v_in_enmy = false;
-                for (int _a = 0; _a < enmy_an && !v_in_enmy; _a++) {
-                    float _dx = ps->x - enmy_anch_x[_a], _dy = ps->y - enmy_anch_y[_a];
-                    if (_dx*_dx + _dy*_dy <= enmy_anch_r[_a] * enmy_anch_r[_a]) v_in_enmy = true;
-                }
-                if (!v_in_enmy) continue;
+                if (!claim_anchor_set_covers(&mine, ps->x, ps->y)) continue;
+                if (!claim_anchor_set_covers(&enmy, ps->x, ps->y)) continue;
                 if (ps->company_id == old_co) {
                     if (struct_claim_radius(ps->type) > 0.0f)
                         if (victim_n < MAX_PLACED_STRUCTURES) victim_ids[victim_n++] = ps->id;
@@ -1476,12 +1443,7 @@ void claim_tick(uint32_t delta_ms) {
             }
             /* Does the enemy fort's centre lie inside the contested section?
              * It is trivially inside its own disc; check against all mine discs. */
-            bool enemy_center_in_intersection = false;
-            for (int _a = 0; _a < mine_an && !enemy_center_in_intersection; _a++) {
-                float _dx = src_enemy->x - mine_anch_x[_a], _dy = src_enemy->y - mine_anch_y[_a];
-                if (_dx*_dx + _dy*_dy <= mine_anch_r[_a] * mine_anch_r[_a])
-                    enemy_center_in_intersection = true;
-            }
+            bool enemy_center_in_intersection = claim_anchor_set_covers(&mine, src_enemy->x, src_enemy->y);
 
             /* Only add src_enemy to the victim list (eligible for DEMOLISHING)
              * when its centre is inside the intersection.  When the centre is
@@ -1501,6 +1463,7 @@ void claim_tick(uint32_t delta_ms) {
                     src_enemy->claim_phase       = FLAG_FORT_PHASE_DEMOLISHING;
                     src_enemy->fortress_complete = false;
                     src_enemy->claim_progress_ms = (float)src_enemy->hp;
+                    claim_fort_wake(src_enemy);
                 }
                 claim_demote_orphaned_in_all_dominators(orphaned_id);
 
@@ -1558,11 +1521,8 @@ void claim_tick(uint32_t delta_ms) {
              *    destruction; company fortresses lose their island claim. */
             for (int vi = 0; vi < victim_n; vi++) {
                 if (victim_ids[vi] == orphaned_id) continue; /* already handled */
-                PlacedStructure *vs = NULL;
-                for (uint32_t k = 0; k < placed_structure_count; k++) {
-                    if (placed_structures[k].id == victim_ids[vi]) { vs = &placed_structures[k]; break; }
-                }
-                if (!vs || !vs->active || vs->claim_orphaned) continue;
+                PlacedStructure *vs = structure_by_id(victim_ids[vi]);
+                if (!vs || vs->claim_orphaned) continue;
 
                 vs->claim_orphaned = true;
                 if (vs->type == STRUCT_FLAG_FORT) {
@@ -1570,6 +1530,7 @@ void claim_tick(uint32_t delta_ms) {
                     vs->claim_phase       = FLAG_FORT_PHASE_DEMOLISHING;
                     vs->fortress_complete = false;
                     vs->claim_progress_ms = (float)vs->hp;
+                    claim_fort_wake(vs);
                 }
                 claim_demote_orphaned_in_all_dominators(vs->id);
 
@@ -1608,10 +1569,7 @@ void claim_tick(uint32_t delta_ms) {
              *  is 0 (the claim flag was the only challenger structure in the
              *  section) but a permanent territorial anchor exists nearby. */
             for (int vi = 0; vi < victim_n; vi++) {
-                PlacedStructure *victim = NULL;
-                for (uint32_t k = 0; k < placed_structure_count; k++) {
-                    if (placed_structures[k].id == victim_ids[vi]) { victim = &placed_structures[k]; break; }
-                }
+                PlacedStructure *victim = structure_by_id_any(victim_ids[vi]);
                 if (!victim) continue;
 
                 bool changed = false;
@@ -1682,13 +1640,8 @@ void claim_tick(uint32_t delta_ms) {
                      * contest) plus any other challengers inside the area. */
                     if (dominators_prepend(ff, src_mine->id)) changed = true;
                     for (int ci = 0; ci < chall_n; ci++) {
-                        PlacedStructure *cs = NULL;
-                        for (uint32_t k = 0; k < placed_structure_count; k++) {
-                            if (placed_structures[k].id == chall_ids[ci]) {
-                                cs = &placed_structures[k]; break;
-                            }
-                        }
-                        if (!cs || !cs->active || cs->claim_orphaned) continue;
+                        PlacedStructure *cs = structure_by_id(chall_ids[ci]);
+                        if (!cs || cs->claim_orphaned) continue;
                         if (dominators_prepend(ff, chall_ids[ci])) changed = true;
                     }
                     if (changed) {
@@ -1722,18 +1675,8 @@ void claim_tick(uint32_t delta_ms) {
                     if (ps->type == STRUCT_COMPANY_FORTRESS) continue;
                     if (ps->type == STRUCT_CLAIM_FLAG) continue;
                     /* Must be in the contested section: inside ANY mine disc AND any enemy disc. */
-                    bool c_in_mine = false;
-                    for (int _a = 0; _a < mine_an && !c_in_mine; _a++) {
-                        float _dx = ps->x - mine_anch_x[_a], _dy = ps->y - mine_anch_y[_a];
-                        if (_dx*_dx + _dy*_dy <= mine_anch_r[_a] * mine_anch_r[_a]) c_in_mine = true;
-                    }
-                    if (!c_in_mine) continue;
-                    bool c_in_enmy = false;
-                    for (int _a = 0; _a < enmy_an && !c_in_enmy; _a++) {
-                        float _dx = ps->x - enmy_anch_x[_a], _dy = ps->y - enmy_anch_y[_a];
-                        if (_dx*_dx + _dy*_dy <= enmy_anch_r[_a] * enmy_anch_r[_a]) c_in_enmy = true;
-                    }
-                    if (!c_in_enmy) continue;
+                    if (!claim_anchor_set_covers(&mine, ps->x, ps->y)) continue;
+                    if (!claim_anchor_set_covers(&enmy, ps->x, ps->y)) continue;
 
                     uint8_t from_co = ps->company_id;
                     ps->company_id     = (uint8_t)s->company_id;
@@ -1777,16 +1720,16 @@ void claim_tick(uint32_t delta_ms) {
              *     structures no longer subordinate to this victim).
              * This covers pairs where a structure's centre lies outside the
              * intersection but whose disc still contributes to the section. */
-            for (int _mi = 0; _mi < mine_an; _mi++) {
-                PlacedStructure *_mp = find_struct_by_id(mine_anch_id[_mi]);
-                if (!_mp || !_mp->active || _mp->claim_orphaned) continue;
-                for (int _ei = 0; _ei < enmy_an; _ei++) {
-                    float _sum = mine_anch_r[_mi] + enmy_anch_r[_ei];
-                    float _dx  = mine_anch_x[_mi] - enmy_anch_x[_ei];
-                    float _dy  = mine_anch_y[_mi] - enmy_anch_y[_ei];
+            for (uint32_t _mi = 0; _mi < mine.n; _mi++) {
+                PlacedStructure *_mp = structure_by_id(mine.id[_mi]);
+                if (!_mp || _mp->claim_orphaned) continue;
+                for (uint32_t _ei = 0; _ei < enmy.n; _ei++) {
+                    float _sum = mine.r[_mi] + enmy.r[_ei];
+                    float _dx  = mine.x[_mi] - enmy.x[_ei];
+                    float _dy  = mine.y[_mi] - enmy.y[_ei];
                     if (_dx*_dx + _dy*_dy >= _sum * _sum) continue;
-                    PlacedStructure *_ep = find_struct_by_id(enmy_anch_id[_ei]);
-                    if (!_ep || !_ep->active) continue;
+                    PlacedStructure *_ep = structure_by_id(enmy.id[_ei]);
+                    if (!_ep) continue;
                     /* challenger id → enemy DOM list */
                     if (dominators_prepend(_ep, _mp->id))
                         broadcast_structure_dominators(_ep);
@@ -1811,8 +1754,8 @@ void claim_tick(uint32_t delta_ms) {
                     _ff->company_id != (uint8_t)old_co) continue;
                 claim_rebuild_graph((uint16_t)_ff->id, (uint32_t)_ff->company_id);
             }
-            log_info("🏴 Claim Flag #%u: pair sweep done (%d mine × %d enemy anchors), graphs rebuilt",
-                     s->id, mine_an, enmy_an);
+            log_info("🏴 Claim Flag #%u: pair sweep done (%u mine × %u enemy anchors), graphs rebuilt",
+                     s->id, mine.n, enmy.n);
 
             /* Invalidate all section caches — the capture rewrote dominator
              * lists and graph state, so every other claim flag's section may
@@ -1820,7 +1763,7 @@ void claim_tick(uint32_t delta_ms) {
             claim_invalidate_cf_sections();
 
             /* Consume the claim flag */
-            s->active = false;
+            structure_free(s);
             char dmsg2[128];
             snprintf(dmsg2, sizeof(dmsg2),
                      "{\"type\":\"structure_demolished\",\"structure_id\":%u}", s->id);
@@ -1829,8 +1772,8 @@ void claim_tick(uint32_t delta_ms) {
         } else if (do_destroy) {
             /* Reverse timer maxed — flag defeated. */
             log_info("🏴 Claim Flag #%u destroyed (timer reversed to full)", s->id);
-            cf_section_release(s->id);
-            s->active = false;
+            claim_flag_section_release(s->id);
+            structure_free(s);
             char dmsg[128];
             snprintf(dmsg, sizeof(dmsg),
                      "{\"type\":\"structure_demolished\",\"structure_id\":%u}", s->id);
@@ -1908,14 +1851,8 @@ int claim_apply_harvest_tax(WebSocketPlayer *player, float wx, float wy,
  * claim flag flips the priority. The enemy structures themselves are not
  * touched. */
 void claim_register_placement_dominators(uint16_t new_structure_id) {
-    PlacedStructure *me = NULL;
-    for (uint32_t i = 0; i < placed_structure_count; i++) {
-        if (placed_structures[i].id == new_structure_id) {
-            me = &placed_structures[i];
-            break;
-        }
-    }
-    if (!me || !me->active) return;
+    PlacedStructure *me = structure_by_id(new_structure_id);
+    if (!me) return;
 
     float mx = me->x, my = me->y;
     float mr = struct_claim_radius(me->type);
@@ -1951,248 +1888,3 @@ void claim_register_placement_dominators(uint16_t new_structure_id) {
     }
     if (changed_me) broadcast_structure_dominators(me);
 }
-
-/* ───────────────────────────────────────────────────────────────────────────
- *  Claim section flood-fill (see net/claim.h for semantics).
- * ─────────────────────────────────────────────────────────────────────────── */
-
-/* Resolve a dominator id to its current PlacedStructure (or NULL). Linear,
- * but `placed_structure_count` is small in practice and dominator lists are
- * tiny (MAX_DOMINATORS).
- */
-static PlacedStructure *find_struct_by_id(uint32_t id) {
-    for (uint32_t i = 0; i < placed_structure_count; i++) {
-        if (placed_structures[i].id == id) return &placed_structures[i];
-    }
-    return NULL;
-}
-
-ClaimSectionGrid *claim_section_build(uint8_t island_id, uint8_t company_id,
-                                      float px, float py) {
-    /* Gather Mi / Ej indices and compute the union bbox. */
-    uint32_t cap = placed_structure_count + 1;
-    uint32_t *mine_idx  = (uint32_t*)malloc(sizeof(uint32_t) * cap);
-    uint32_t *enemy_idx = (uint32_t*)malloc(sizeof(uint32_t) * cap);
-    if (!mine_idx || !enemy_idx) { free(mine_idx); free(enemy_idx); return NULL; }
-    int n_mine = 0, n_enemy = 0;
-    float bbx_min = px, bby_min = py, bbx_max = px, bby_max = py;
-    bool have_bb = false;
-
-    for (uint32_t i = 0; i < placed_structure_count; i++) {
-        PlacedStructure *ps = &placed_structures[i];
-        if (!ps->active) continue;
-        if (ps->claim_orphaned) continue;
-        if (ps->island_id != island_id) continue;
-        if (ps->type == STRUCT_FLAG_FORT && !ps->fortress_complete) continue;
-        if (ps->type == STRUCT_CLAIM_FLAG) continue;   /* not a territorial anchor */
-        if (ps->company_id == COMPANY_UNCLAIMED) continue;
-        float r = struct_claim_radius(ps->type);
-        if (ps->company_id == company_id) {
-            mine_idx[n_mine++] = i;
-        } else {
-            enemy_idx[n_enemy++] = i;
-        }
-        float xmin = ps->x - r, xmax = ps->x + r;
-        float ymin = ps->y - r, ymax = ps->y + r;
-        if (!have_bb) {
-            bbx_min = xmin; bbx_max = xmax;
-            bby_min = ymin; bby_max = ymax;
-            have_bb = true;
-        } else {
-            if (xmin < bbx_min) bbx_min = xmin;
-            if (xmax > bbx_max) bbx_max = xmax;
-            if (ymin < bby_min) bby_min = ymin;
-            if (ymax > bby_max) bby_max = ymax;
-        }
-    }
-
-    if (n_mine == 0 || n_enemy == 0) {
-        free(mine_idx); free(enemy_idx);
-        return NULL;
-    }
-
-    /* Always include the placement point in the grid bbox (1-cell margin). */
-    if (px < bbx_min) bbx_min = px;
-    if (px > bbx_max) bbx_max = px;
-    if (py < bby_min) bby_min = py;
-    if (py > bby_max) bby_max = py;
-
-    const float cell = 8.0f;
-    float ox = bbx_min - cell;
-    float oy = bby_min - cell;
-    int   w  = (int)ceilf((bbx_max - ox) / cell) + 2;
-    int   h  = (int)ceilf((bby_max - oy) / cell) + 2;
-    if (w <= 0 || h <= 0 || w > 4096 || h > 4096) {
-        free(mine_idx); free(enemy_idx);
-        return NULL;
-    }
-
-    size_t n = (size_t)w * (size_t)h;
-    uint8_t *slice = (uint8_t*)calloc(n, 1);
-    uint8_t *own   = (uint8_t*)calloc(n, 1);
-    if (!slice || !own) {
-        free(slice); free(own);
-        free(mine_idx); free(enemy_idx);
-        return NULL;
-    }
-
-    /* tmp_own: cells inside some Mi.disc but not inside any of that Mi's
-     * dominator discs. */
-    for (int km = 0; km < n_mine; km++) {
-        PlacedStructure *mi = &placed_structures[mine_idx[km]];
-        float mr  = struct_claim_radius(mi->type);
-        float mr2 = mr * mr;
-        int gx0 = (int)floorf((mi->x - mr - ox) / cell);
-        int gx1 = (int)ceilf ((mi->x + mr - ox) / cell);
-        int gy0 = (int)floorf((mi->y - mr - oy) / cell);
-        int gy1 = (int)ceilf ((mi->y + mr - oy) / cell);
-        if (gx0 < 0) gx0 = 0;
-        if (gy0 < 0) gy0 = 0;
-        if (gx1 >= w) gx1 = w - 1;
-        if (gy1 >= h) gy1 = h - 1;
-        for (int gy = gy0; gy <= gy1; gy++) {
-            float wy = oy + ((float)gy + 0.5f) * cell;
-            float dy = wy - mi->y;
-            for (int gx = gx0; gx <= gx1; gx++) {
-                float wx = ox + ((float)gx + 0.5f) * cell;
-                float dx = wx - mi->x;
-                if (dx*dx + dy*dy > mr2) continue;
-                bool carved = false;
-                for (int di = 0; di < mi->dominator_count; di++) {
-                    PlacedStructure *d = find_struct_by_id(mi->dominators[di]);
-                    if (!d || !d->active || d->claim_orphaned) continue;
-                    if (d->type == STRUCT_FLAG_FORT && !d->fortress_complete) continue;
-                    float dr  = struct_claim_radius(d->type);
-                    float ddx = wx - d->x, ddy = wy - d->y;
-                    if (ddx*ddx + ddy*ddy <= dr*dr) { carved = true; break; }
-                }
-                if (!carved) own[(size_t)gy * w + gx] = 1;
-            }
-        }
-    }
-
-    /* Lens union: for each (Mi, Ej) with overlapping discs, mark cells
-     * inside both discs. */
-    for (int km = 0; km < n_mine; km++) {
-        PlacedStructure *mi = &placed_structures[mine_idx[km]];
-        float mr  = struct_claim_radius(mi->type);
-        float mr2 = mr * mr;
-        for (int ke = 0; ke < n_enemy; ke++) {
-            PlacedStructure *ej = &placed_structures[enemy_idx[ke]];
-            float er  = struct_claim_radius(ej->type);
-            float er2 = er * er;
-            float dxc = mi->x - ej->x, dyc = mi->y - ej->y;
-            float sum = mr + er;
-            if (dxc*dxc + dyc*dyc >= sum*sum) continue;
-
-            float lxmn = (mi->x - mr) > (ej->x - er) ? (mi->x - mr) : (ej->x - er);
-            float lxmx = (mi->x + mr) < (ej->x + er) ? (mi->x + mr) : (ej->x + er);
-            float lymn = (mi->y - mr) > (ej->y - er) ? (mi->y - mr) : (ej->y - er);
-            float lymx = (mi->y + mr) < (ej->y + er) ? (mi->y + mr) : (ej->y + er);
-            int gx0 = (int)floorf((lxmn - ox) / cell);
-            int gx1 = (int)ceilf ((lxmx - ox) / cell);
-            int gy0 = (int)floorf((lymn - oy) / cell);
-            int gy1 = (int)ceilf ((lymx - oy) / cell);
-            if (gx0 < 0) gx0 = 0;
-            if (gy0 < 0) gy0 = 0;
-            if (gx1 >= w) gx1 = w - 1;
-            if (gy1 >= h) gy1 = h - 1;
-            for (int gy = gy0; gy <= gy1; gy++) {
-                float wy   = oy + ((float)gy + 0.5f) * cell;
-                float dy_m = wy - mi->y, dy_e = wy - ej->y;
-                for (int gx = gx0; gx <= gx1; gx++) {
-                    float wx   = ox + ((float)gx + 0.5f) * cell;
-                    float dx_m = wx - mi->x, dx_e = wx - ej->x;
-                    if (dx_m*dx_m + dy_m*dy_m > mr2) continue;
-                    if (dx_e*dx_e + dy_e*dy_e > er2) continue;
-                    slice[(size_t)gy * w + gx] = 1;
-                }
-            }
-        }
-    }
-
-    /* slice ∖ own */
-    for (size_t i = 0; i < n; i++) if (own[i]) slice[i] = 0;
-    free(own);
-    free(mine_idx);
-    free(enemy_idx);
-
-    /* Locate placement cell. */
-    int cgx = (int)floorf((px - ox) / cell);
-    int cgy = (int)floorf((py - oy) / cell);
-    if (cgx < 0 || cgy < 0 || cgx >= w || cgy >= h) { free(slice); return NULL; }
-    if (!slice[(size_t)cgy * w + cgx]) { free(slice); return NULL; }
-
-    /* BFS flood-fill (4-connected). */
-    uint8_t *section = (uint8_t*)calloc(n, 1);
-    int     *stack   = (int*)malloc(sizeof(int) * n);
-    if (!section || !stack) { free(slice); free(section); free(stack); return NULL; }
-    int sp = 0;
-    int seed = cgy * w + cgx;
-    section[seed] = 1;
-    stack[sp++] = seed;
-    while (sp > 0) {
-        int k = stack[--sp];
-        int x = k % w, y = k / w;
-        if (x > 0     && slice[k - 1] && !section[k - 1]) { section[k - 1] = 1; stack[sp++] = k - 1; }
-        if (x < w - 1 && slice[k + 1] && !section[k + 1]) { section[k + 1] = 1; stack[sp++] = k + 1; }
-        if (y > 0     && slice[k - w] && !section[k - w]) { section[k - w] = 1; stack[sp++] = k - w; }
-        if (y < h - 1 && slice[k + w] && !section[k + w]) { section[k + w] = 1; stack[sp++] = k + w; }
-    }
-    free(slice);
-    free(stack);
-
-    ClaimSectionGrid *g = (ClaimSectionGrid*)malloc(sizeof(*g));
-    if (!g) { free(section); return NULL; }
-    g->origin_x  = ox;
-    g->origin_y  = oy;
-    g->cell_size = cell;
-    g->w         = w;
-    g->h         = h;
-    g->cells     = section;
-    return g;
-}
-
-void claim_section_free(ClaimSectionGrid *g) {
-    if (!g) return;
-    free(g->cells);
-    free(g);
-}
-
-bool claim_section_contains(const ClaimSectionGrid *g, float x, float y) {
-    if (!g) return false;
-    int gx = (int)floorf((x - g->origin_x) / g->cell_size);
-    int gy = (int)floorf((y - g->origin_y) / g->cell_size);
-    if (gx < 0 || gy < 0 || gx >= g->w || gy >= g->h) return false;
-    return g->cells[(size_t)gy * g->w + gx] != 0;
-}
-
-/**
- * Returns true if any cell of the section grid lies within radius r of (cx,cy).
- * Used to detect flag forts whose claim disc overlaps the contested section
- * without the fort's own centre being inside it.
- */
-bool claim_section_disc_overlaps(const ClaimSectionGrid *g,
-                                 float cx, float cy, float r) {
-    if (!g || r <= 0.0f) return false;
-    float r2  = r * r;
-    int gx0 = (int)floorf((cx - r - g->origin_x) / g->cell_size);
-    int gx1 = (int)ceilf ((cx + r - g->origin_x) / g->cell_size);
-    int gy0 = (int)floorf((cy - r - g->origin_y) / g->cell_size);
-    int gy1 = (int)ceilf ((cy + r - g->origin_y) / g->cell_size);
-    if (gx0 < 0) gx0 = 0;
-    if (gy0 < 0) gy0 = 0;
-    if (gx1 >= g->w) gx1 = g->w - 1;
-    if (gy1 >= g->h) gy1 = g->h - 1;
-    for (int gy = gy0; gy <= gy1; gy++) {
-        float wy = g->origin_y + ((float)gy + 0.5f) * g->cell_size;
-        float dy = wy - cy;
-        for (int gx = gx0; gx <= gx1; gx++) {
-            if (!g->cells[(size_t)gy * g->w + gx]) continue;
-            float wx = g->origin_x + ((float)gx + 0.5f) * g->cell_size;
-            float dx = wx - cx;
-            if (dx*dx + dy*dy <= r2) return true;
-        }
-    }
-    return false;
-}
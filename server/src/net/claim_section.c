@@ -0,0 +1,672 @@
+/**
+ * claim_section.c — Claim-flag contest sections (see net/claim.h).
+ *
+ * A section is rasterised on an 8-unit cell lattice anchored at the world
+ * origin, one bit per cell (64 cells per word).  Disc coverage is computed
+ * per row as a span of cells, so rasterising own/slice is a few word writes
+ * per row instead of a distance test per cell, and the flood fill walks
+ * horizontal runs.  Scratch buffers are kept between builds.
+ *
+ * Claim flags keep their section cached.  claim_invalidate_cf_sections()
+ * compares every structure's claim-relevant state against a per-slot shadow
+ * and drops only the cached sections a changed claim disc can reach.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "net/claim.h"
+#include "net/structure_index.h"
+#include "net/websocket_server_internal.h"
+
+#define SECTION_CELL     8.0f
+#define SECTION_MAX_DIM  4096
+
+/* ── Bit rows ────────────────────────────────────────────────────────────── */
+
+static inline int row_words(int w) { return (w + 63) >> 6; }
+
+static inline bool bit_get(const uint64_t *row, int x) {
+    return (row[x >> 6] >> (x & 63)) & 1u;
+}
+
+/* Mask of bits [lo,hi] within one word, 0 <= lo <= hi <= 63 */
+static inline uint64_t word_mask(int lo, int hi) {
+    uint64_t m = (hi == 63) ? ~0ull : ((1ull << (hi + 1)) - 1);
+    return m & ~((1ull << lo) - 1);
+}
+
+static void bits_set_range(uint64_t *row, int x0, int x1) {
+    int w0 = x0 >> 6, w1 = x1 >> 6;
+    if (w0 == w1) { row[w0] |= word_mask(x0 & 63, x1 & 63); return; }
+    row[w0] |= word_mask(x0 & 63, 63);
+    for (int k = w0 + 1; k < w1; k++) row[k] = ~0ull;
+    row[w1] |= word_mask(0, x1 & 63);
+}
+
+static void bits_clear_range(uint64_t *row, int x0, int x1) {
+    int w0 = x0 >> 6, w1 = x1 >> 6;
+    if (w0 == w1) { row[w0] &= ~word_mask(x0 & 63, x1 & 63); return; }
+    row[w0] &= ~word_mask(x0 & 63, 63);
+    for (int k = w0 + 1; k < w1; k++) row[k] = 0;
+    row[w1] &= ~word_mask(0, x1 & 63);
+}
+
+static bool bits_any_range(const uint64_t *row, int x0, int x1) {
+    int w0 = x0 >> 6, w1 = x1 >> 6;
+    if (w0 == w1) return (row[w0] & word_mask(x0 & 63, x1 & 63)) != 0;
+    if (row[w0] & word_mask(x0 & 63, 63)) return true;
+    for (int k = w0 + 1; k < w1; k++) if (row[k]) return true;
+    return (row[w1] & word_mask(0, x1 & 63)) != 0;
+}
+
+/* 64 bits of `row` starting at bit x (bits past the row read as whatever the
+ * next word holds; callers mask). */
+static inline uint64_t bits_window(const uint64_t *row, int words, int x) {
+    int w = x >> 6, b = x & 63;
+    uint64_t lo = row[w] >> b;
+    if (b && w + 1 < words) lo |= row[w + 1] << (64 - b);
+    return lo;
+}
+
+/* Longest run of set bits containing x (bit x must be set). */
+static void bits_run(const uint64_t *row, int w, int x, int *out_l, int *out_r) {
+    int l = x, r = x;
+    while (l > 0) {
+        int wi = (l - 1) >> 6, b = (l - 1) & 63;
+        uint64_t inv = ~row[wi] & word_mask(0, b);   /* zeros at or below l-1 */
+        if (inv) { l = (wi << 6) + 64 - __builtin_clzll(inv); break; }
+        l = wi << 6;
+    }
+    while (r < w - 1) {
+        int wi = (r + 1) >> 6, b = (r + 1) & 63;
+        uint64_t inv = ~row[wi] & word_mask(b, 63);  /* zeros at or above r+1 */
+        if (inv) { r = (wi << 6) + __builtin_ctzll(inv) - 1; break; }
+        r = (wi << 6) + 63;
+    }
+    if (r > w - 1) r = w - 1;
+    *out_l = l;
+    *out_r = r;
+}
+
+static inline bool cell_inside(int gx, float ox, float cell, float cx, float dy, float r2) {
+    float dx = ox + ((float)gx + 0.5f) * cell - cx;
+    return dx * dx + dy * dy <= r2;
+}
+
+/* Cells of row gy (centres at ox + (gx+0.5)*cell) inside the disc, using the
+ * same float test as a per-cell scan.  Returns false when the row misses. */
+static bool disc_row_span(float cx, float cy, float r2, float ox, float oy, float cell,
+                          int gy, int w, int *out_x0, int *out_x1) {
+    float wy  = oy + ((float)gy + 0.5f) * cell;
+    float dy  = wy - cy;
+    float rem = r2 - dy * dy;
+    if (rem < 0.0f) return false;
+    float half = sqrtf(rem);
+    int x0 = (int)ceilf((cx - half - ox) / cell - 0.5f);
+    int x1 = (int)floorf((cx + half - ox) / cell - 0.5f);
+    /* sqrt/division rounding can be off by one cell at either end */
+    while (cell_inside(x0 - 1, ox, cell, cx, dy, r2)) x0--;
+    while (x0 <= x1 && !cell_inside(x0, ox, cell, cx, dy, r2)) x0++;
+    while (cell_inside(x1 + 1, ox, cell, cx, dy, r2)) x1++;
+    while (x1 >= x0 && !cell_inside(x1, ox, cell, cx, dy, r2)) x1--;
+    if (x0 < 0) x0 = 0;
+    if (x1 > w - 1) x1 = w - 1;
+    if (x0 > x1) return false;
+    *out_x0 = x0;
+    *out_x1 = x1;
+    return true;
+}
+
+/* ── Scratch pool ────────────────────────────────────────────────────────── */
+
+static uint64_t *sc_own, *sc_slice, *sc_sec, *sc_row;
+static size_t    sc_words_cap, sc_row_cap;
+static int32_t  *sc_stack;
+static size_t    sc_stack_cap;
+static uint32_t *sc_mine, *sc_enemy;
+static uint32_t  sc_anchor_cap;
+/* Row spans of every gathered anchor disc (x0,x1 pairs, x0 > x1 where the
+ * row misses), rows span_gy0[k]..span_gy1[k] starting at span_off[k]. */
+static int32_t  *sc_span;
+static size_t    sc_span_cap;
+static size_t   *sc_span_off;
+static int32_t  *sc_span_gy0, *sc_span_gy1;
+
+static bool grow(void **p, size_t *cap, size_t need, size_t elem) {
+    if (need <= *cap) return true;
+    size_t c = *cap ? *cap : 256;
+    while (c < need) c *= 2;
+    void *np = realloc(*p, c * elem);
+    if (!np) return false;
+    *p = np;
+    *cap = c;
+    return true;
+}
+
+static bool scratch_reserve(size_t words, int stride, uint32_t anchors) {
+    size_t wc = sc_words_cap, rc = sc_row_cap, ac = sc_anchor_cap;
+    if (!grow((void **)&sc_own, &wc, words, sizeof(uint64_t))) return false;
+    wc = sc_words_cap;
+    if (!grow((void **)&sc_slice, &wc, words, sizeof(uint64_t))) return false;
+    wc = sc_words_cap;
+    if (!grow((void **)&sc_sec, &wc, words, sizeof(uint64_t))) return false;
+    sc_words_cap = wc;
+    if (!grow((void **)&sc_row, &rc, (size_t)stride, sizeof(uint64_t))) return false;
+    sc_row_cap = rc;
+    if (!grow((void **)&sc_mine, &ac, anchors, sizeof(uint32_t))) return false;
+    ac = sc_anchor_cap;
+    if (!grow((void **)&sc_enemy, &ac, anchors, sizeof(uint32_t))) return false;
+    ac = sc_anchor_cap;
+    if (!grow((void **)&sc_span_off, &ac, anchors, sizeof(size_t))) return false;
+    ac = sc_anchor_cap;
+    if (!grow((void **)&sc_span_gy0, &ac, anchors, sizeof(int32_t))) return false;
+    ac = sc_anchor_cap;
+    if (!grow((void **)&sc_span_gy1, &ac, anchors, sizeof(int32_t))) return false;
+    sc_anchor_cap = (uint32_t)ac;
+    return true;
+}
+
+static bool stack_push(size_t *sp, int32_t v) {
+    if (!grow((void **)&sc_stack, &sc_stack_cap, *sp + 1, sizeof(int32_t))) return false;
+    sc_stack[(*sp)++] = v;
+    return true;
+}
+
+/* ── Build ───────────────────────────────────────────────────────────────── */
+
+/* Fills the row spans of anchor slot k's disc; *used is the span cursor. */
+static bool anchor_spans(uint32_t k, const PlacedStructure *ps, float ox, float oy,
+                         float cell, int w, int h, size_t *used) {
+    float r = struct_claim_radius(ps->type);
+    int gy0 = (int)floorf((ps->y - r - oy) / cell), gy1 = (int)ceilf((ps->y + r - oy) / cell);
+    if (gy0 < 0) gy0 = 0;
+    if (gy1 > h - 1) gy1 = h - 1;
+    sc_span_off[k] = *used;
+    sc_span_gy0[k] = gy0;
+    sc_span_gy1[k] = gy1;
+    if (gy1 < gy0) return true;
+    if (!grow((void **)&sc_span, &sc_span_cap, *used + 2 * (size_t)(gy1 - gy0 + 1), sizeof(int32_t)))
+        return false;
+    for (int gy = gy0; gy <= gy1; gy++) {
+        int a = 1, b = 0;
+        disc_row_span(ps->x, ps->y, r * r, ox, oy, cell, gy, w, &a, &b);
+        sc_span[(*used)++] = a;
+        sc_span[(*used)++] = b;
+    }
+    return true;
+}
+
+/* Dominators of mi that still subtract from its own territory */
+static int live_dominators(const PlacedStructure *mi, const PlacedStructure **dom) {
+    int n = 0;
+    for (int di = 0; di < mi->dominator_count; di++) {
+        PlacedStructure *d = structure_by_id(mi->dominators[di]);
+        if (!d || d->claim_orphaned) continue;
+        if (d->type == STRUCT_FLAG_FORT && !d->fortress_complete) continue;
+        dom[n++] = d;
+    }
+    return n;
+}
+
+/* Span of anchor slot k on row gy; false when the row misses the disc */
+static inline bool span_at(uint32_t k, int gy, int *a, int *b) {
+    if (gy < sc_span_gy0[k] || gy > sc_span_gy1[k]) return false;
+    const int32_t *sp = &sc_span[sc_span_off[k] + 2 * (size_t)(gy - sc_span_gy0[k])];
+    *a = sp[0];
+    *b = sp[1];
+    return *a <= *b;
+}
+
+static bool is_anchor(const PlacedStructure *ps) {
+    if (!ps->active || ps->claim_orphaned) return false;
+    if (ps->type == STRUCT_FLAG_FORT && !ps->fortress_complete) return false;
+    if (ps->type == STRUCT_CLAIM_FLAG) return false;   /* not a territorial anchor */
+    return ps->company_id != COMPANY_UNCLAIMED;
+}
+
+/* Builds into `out` (whose bits buffer is reused if large enough).  Returns
+ * false when (px,py) is in no slice piece. */
+static uint64_t section_builds;
+
+static bool section_build_into(uint8_t island_id, uint8_t company_id, float px, float py,
+                               ClaimSectionGrid *out, size_t *out_cap) {
+    section_builds++;
+    if (!scratch_reserve(0, 1, placed_structure_count + 1)) return false;
+
+    /* Gather Mi / Ej indices and compute the union bbox. */
+    uint32_t n_mine = 0, n_enemy = 0;
+    float bbx_min = px, bby_min = py, bbx_max = px, bby_max = py;
+    for (uint32_t i = 0; i < placed_structure_count; i++) {
+        PlacedStructure *ps = &placed_structures[i];
+        if (ps->island_id != island_id || !is_anchor(ps)) continue;
+        if (ps->company_id == company_id) sc_mine[n_mine++] = i;
+        else                              sc_enemy[n_enemy++] = i;
+        float r = struct_claim_radius(ps->type);
+        if (ps->x - r < bbx_min) bbx_min = ps->x - r;
+        if (ps->x + r > bbx_max) bbx_max = ps->x + r;
+        if (ps->y - r < bby_min) bby_min = ps->y - r;
+        if (ps->y + r > bby_max) bby_max = ps->y + r;
+    }
+    if (n_mine == 0 || n_enemy == 0) return false;
+
+    /* Lattice anchored at the world origin, so a cell covers the same ground
+     * no matter which anchors set the bbox — a cached section stays exact
+     * when an unrelated anchor elsewhere on the island changes. */
+    const float cell = SECTION_CELL;
+    float ox = (floorf(bbx_min / cell) - 1.0f) * cell;
+    float oy = (floorf(bby_min / cell) - 1.0f) * cell;
+    int   w  = (int)ceilf((bbx_max - ox) / cell) + 2;
+    int   h  = (int)ceilf((bby_max - oy) / cell) + 2;
+    if (w <= 0 || h <= 0 || w > SECTION_MAX_DIM || h > SECTION_MAX_DIM) return false;
+
+    /* The placement cell alone decides whether there is a section: reject
+     * before rasterising anything unless it lies in some Mi/Ej lens and in
+     * no Mi's own territory. */
+    int cgx = (int)floorf((px - ox) / cell);
+    int cgy = (int)floorf((py - oy) / cell);
+    if (cgx < 0 || cgy < 0 || cgx >= w || cgy >= h) return false;
+    float ccy  = oy + ((float)cgy + 0.5f) * cell;
+    bool  lens = false;
+    for (uint32_t km = 0; km < n_mine; km++) {
+        const PlacedStructure *mi = &placed_structures[sc_mine[km]];
+        float mr = struct_claim_radius(mi->type);
+        if (!cell_inside(cgx, ox, cell, mi->x, ccy - mi->y, mr * mr)) continue;
+        const PlacedStructure *dom[MAX_DOMINATORS];
+        int n_dom = live_dominators(mi, dom), k = 0;
+        for (; k < n_dom; k++) {
+            float dr = struct_claim_radius(dom[k]->type);
+            if (cell_inside(cgx, ox, cell, dom[k]->x, ccy - dom[k]->y, dr * dr)) break;
+        }
+        if (k == n_dom) return false;   /* owned */
+        for (uint32_t ke = 0; ke < n_enemy && !lens; ke++) {
+            const PlacedStructure *ej = &placed_structures[sc_enemy[ke]];
+            float er  = struct_claim_radius(ej->type);
+            float dxc = mi->x - ej->x, dyc = mi->y - ej->y;
+            float sum = mr + er;
+            lens = dxc*dxc + dyc*dyc < sum*sum &&
+                   cell_inside(cgx, ox, cell, ej->x, ccy - ej->y, er * er);
+        }
+    }
+    if (!lens) return false;
+
+    int    stride = row_words(w);
+    size_t words  = (size_t)stride * (size_t)h;
+    if (!scratch_reserve(words, stride, placed_structure_count + 1)) return false;
+    memset(sc_own,   0, words * sizeof(uint64_t));
+    memset(sc_slice, 0, words * sizeof(uint64_t));
+    memset(sc_sec,   0, words * sizeof(uint64_t));
+
+    /* Rasterise each disc once: slots [0,n_mine) mine, then enemies. */
+    size_t used = 0;
+    for (uint32_t km = 0; km < n_mine; km++)
+        if (!anchor_spans(km, &placed_structures[sc_mine[km]], ox, oy, cell, w, h, &used)) return false;
+    for (uint32_t ke = 0; ke < n_enemy; ke++)
+        if (!anchor_spans(n_mine + ke, &placed_structures[sc_enemy[ke]], ox, oy, cell, w, h, &used)) return false;
+
+    /* tmp_own: cells inside some Mi.disc but not inside any of that Mi's
+     * dominator discs.  Dominators are resolved once per Mi. */
+    for (uint32_t km = 0; km < n_mine; km++) {
+        const PlacedStructure *dom[MAX_DOMINATORS];
+        int n_dom = live_dominators(&placed_structures[sc_mine[km]], dom);
+        for (int gy = sc_span_gy0[km]; gy <= sc_span_gy1[km]; gy++) {
+            int a, b;
+            if (!span_at(km, gy, &a, &b)) continue;
+            uint64_t *own = &sc_own[(size_t)gy * stride];
+            if (n_dom == 0) { bits_set_range(own, a, b); continue; }
+            int wa = a >> 6, wb = b >> 6;
+            memset(&sc_row[wa], 0, (size_t)(wb - wa + 1) * sizeof(uint64_t));
+            bits_set_range(sc_row, a, b);
+            for (int k = 0; k < n_dom; k++) {
+                float dr = struct_claim_radius(dom[k]->type);
+                int c, d;
+                if (!disc_row_span(dom[k]->x, dom[k]->y, dr * dr, ox, oy, cell, gy, w, &c, &d)) continue;
+                if (c < a) c = a;
+                if (d > b) d = b;
+                if (c <= d) bits_clear_range(sc_row, c, d);
+            }
+            for (int k = wa; k <= wb; k++) own[k] |= sc_row[k];
+        }
+    }
+
+    /* Lens union: for each (Mi, Ej) with overlapping discs, mark cells
+     * inside both discs. */
+    for (uint32_t km = 0; km < n_mine; km++) {
+        const PlacedStructure *mi = &placed_structures[sc_mine[km]];
+        float mr = struct_claim_radius(mi->type);
+        for (uint32_t ke = 0; ke < n_enemy; ke++) {
+            const PlacedStructure *ej = &placed_structures[sc_enemy[ke]];
+            float er  = struct_claim_radius(ej->type);
+            float dxc = mi->x - ej->x, dyc = mi->y - ej->y;
+            float sum = mr + er;
+            if (dxc*dxc + dyc*dyc >= sum*sum) continue;
+
+            int gy0 = sc_span_gy0[km] > sc_span_gy0[n_mine + ke] ? sc_span_gy0[km] : sc_span_gy0[n_mine + ke];
+            int gy1 = sc_span_gy1[km] < sc_span_gy1[n_mine + ke] ? sc_span_gy1[km] : sc_span_gy1[n_mine + ke];
+            for (int gy = gy0; gy <= gy1; gy++) {
+                int a, b, c, d;
+                if (!span_at(km, gy, &a, &b) || !span_at(n_mine + ke, gy, &c, &d)) continue;
+                if (c > a) a = c;
+                if (d < b) b = d;
+                if (a <= b) bits_set_range(&sc_slice[(size_t)gy * stride], a, b);
+            }
+        }
+    }
+
+    /* slice ∖ own */
+    for (size_t k = 0; k < words; k++) sc_slice[k] &= ~sc_own[k];
+
+    if (!bit_get(&sc_slice[(size_t)cgy * stride], cgx)) return false;
+
+    /* Span flood fill (4-connected): fill the whole run around a seed, then
+     * seed the first cell of every unfilled slice run touching it above and
+     * below. */
+    int minx = cgx, maxx = cgx, miny = cgy, maxy = cgy;
+    size_t sp = 0;
+    if (!stack_push(&sp, cgy * w + cgx)) return false;
+    while (sp > 0) {
+        int32_t k = sc_stack[--sp];
+        int x = k % w, y = k / w;
+        uint64_t *sec = &sc_sec[(size_t)y * stride];
+        if (bit_get(sec, x)) continue;
+        int l, r;
+        bits_run(&sc_slice[(size_t)y * stride], w, x, &l, &r);
+        bits_set_range(sec, l, r);
+        if (l < minx) minx = l;
+        if (r > maxx) maxx = r;
+        if (y < miny) miny = y;
+        if (y > maxy) maxy = y;
+
+        for (int ny = y - 1; ny <= y + 1; ny += 2) {
+            if (ny < 0 || ny >= h) continue;
+            const uint64_t *srow = &sc_slice[(size_t)ny * stride];
+            const uint64_t *frow = &sc_sec[(size_t)ny * stride];
+            uint64_t carry = 0;
+            for (int wi = l >> 6; wi <= (r >> 6); wi++) {
+                int lo = (wi == (l >> 6)) ? (l & 63) : 0;
+                int hi = (wi == (r >> 6)) ? (r & 63) : 63;
+                uint64_t m = srow[wi] & ~frow[wi] & word_mask(lo, hi);
+                uint64_t starts = m & ~((m << 1) | carry);
+                carry = m >> 63;
+                while (starts) {
+                    int bx = (wi << 6) + __builtin_ctzll(starts);
+                    starts &= starts - 1;
+                    if (!stack_push(&sp, ny * w + bx)) return false;
+                }
+            }
+        }
+    }
+
+    /* Keep only the section's own bounding box. */
+    int cw = maxx - minx + 1, ch = maxy - miny + 1;
+    int cstride = row_words(cw);
+    size_t cwords = (size_t)cstride * (size_t)ch;
+    if (cwords > *out_cap) {
+        uint64_t *nb = realloc(out->bits, cwords * sizeof(uint64_t));
+        if (!nb) return false;
+        out->bits = nb;
+        *out_cap  = cwords;
+    }
+    for (int y = 0; y < ch; y++) {
+        const uint64_t *src = &sc_sec[(size_t)(miny + y) * stride];
+        uint64_t *dst = &out->bits[(size_t)y * cstride];
+        for (int k = 0; k < cstride; k++) dst[k] = bits_window(src, stride, minx + k * 64);
+        if (cw & 63) dst[cstride - 1] &= word_mask(0, (cw & 63) - 1);
+    }
+    out->origin_x  = ox + (float)minx * cell;
+    out->origin_y  = oy + (float)miny * cell;
+    out->cell_size = cell;
+    out->w         = cw;
+    out->h         = ch;
+    out->stride    = cstride;
+    return true;
+}
+
+ClaimSectionGrid *claim_section_build(uint8_t island_id, uint8_t company_id,
+                                      float px, float py) {
+    ClaimSectionGrid *g = calloc(1, sizeof(*g));
+    if (!g) return NULL;
+    size_t cap = 0;
+    if (!section_build_into(island_id, company_id, px, py, g, &cap)) {
+        claim_section_free(g);
+        return NULL;
+    }
+    return g;
+}
+
+void claim_section_free(ClaimSectionGrid *g) {
+    if (!g) return;
+    free(g->bits);
+    free(g);
+}
+
+bool claim_section_contains(const ClaimSectionGrid *g, float x, float y) {
+    if (!g) return false;
+    int gx = (int)floorf((x - g->origin_x) / g->cell_size);
+    int gy = (int)floorf((y - g->origin_y) / g->cell_size);
+    if (gx < 0 || gy < 0 || gx >= g->w || gy >= g->h) return false;
+    return bit_get(&g->bits[(size_t)gy * g->stride], gx);
+}
+
+/**
+ * Returns true if any cell of the section grid lies within radius r of (cx,cy).
+ * Used to detect flag forts whose claim disc overlaps the contested section
+ * without the fort's own centre being inside it.
+ */
+bool claim_section_disc_overlaps(const ClaimSectionGrid *g,
+                                 float cx, float cy, float r) {
+    if (!g || r <= 0.0f) return false;
+    int gy0 = (int)floorf((cy - r - g->origin_y) / g->cell_size);
+    int gy1 = (int)ceilf ((cy + r - g->origin_y) / g->cell_size);
+    if (gy0 < 0) gy0 = 0;
+    if (gy1 >= g->h) gy1 = g->h - 1;
+    for (int gy = gy0; gy <= gy1; gy++) {
+        int a, b;
+        if (!disc_row_span(cx, cy, r * r, g->origin_x, g->origin_y, g->cell_size,
+                           gy, g->w, &a, &b)) continue;
+        if (bits_any_range(&g->bits[(size_t)gy * g->stride], a, b)) return true;
+    }
+    return false;
+}
+
+/* ── Capture anchors ─────────────────────────────────────────────────────── */
+
+/* Mine discs in [0, n_mine), enemy discs after them; sized to the store so a
+ * base of any size keeps every anchor. */
+static float    *ca_x, *ca_y, *ca_r;
+static uint32_t *ca_id;
+static size_t    ca_cap;
+
+bool claim_capture_anchors(uint8_t island_id, uint8_t mine_co, uint8_t enemy_co,
+                           ClaimAnchorSet *mine, ClaimAnchorSet *enemy) {
+    memset(mine, 0, sizeof(*mine));
+    memset(enemy, 0, sizeof(*enemy));
+    size_t need = (size_t)placed_structure_count * 2 + 1, c;
+    c = ca_cap; if (!grow((void **)&ca_x,  &c, need, sizeof(float)))    return false;
+    c = ca_cap; if (!grow((void **)&ca_y,  &c, need, sizeof(float)))    return false;
+    c = ca_cap; if (!grow((void **)&ca_r,  &c, need, sizeof(float)))    return false;
+    c = ca_cap; if (!grow((void **)&ca_id, &c, need, sizeof(uint32_t))) return false;
+    ca_cap = c;
+
+    /* Enemies go to the upper half first, then move down to follow mine */
+    uint32_t n_mine = 0, n_enemy = 0;
+    for (uint32_t i = 0; i < placed_structure_count; i++) {
+        const PlacedStructure *an = &placed_structures[i];
+        if (!an->active || an->claim_orphaned || an->island_id != island_id) continue;
+        if (an->type == STRUCT_CLAIM_FLAG) continue;
+        float ar = struct_claim_radius(an->type);
+        if (ar <= 0.0f) continue;
+        if (an->type == STRUCT_FLAG_FORT && !an->fortress_complete) continue;
+        uint32_t k;
+        if (an->company_id == mine_co)       k = n_mine++;
+        else if (an->company_id == enemy_co) k = placed_structure_count + n_enemy++;
+        else continue;
+        ca_x[k] = an->x; ca_y[k] = an->y; ca_r[k] = ar; ca_id[k] = an->id;
+    }
+    if (n_enemy) {
+        memmove(&ca_x[n_mine],  &ca_x[placed_structure_count],  n_enemy * sizeof(float));
+        memmove(&ca_y[n_mine],  &ca_y[placed_structure_count],  n_enemy * sizeof(float));
+        memmove(&ca_r[n_mine],  &ca_r[placed_structure_count],  n_enemy * sizeof(float));
+        memmove(&ca_id[n_mine], &ca_id[placed_structure_count], n_enemy * sizeof(uint32_t));
+    }
+    *mine  = (ClaimAnchorSet){ ca_x, ca_y, ca_r, ca_id, n_mine };
+    *enemy = (ClaimAnchorSet){ ca_x + n_mine, ca_y + n_mine, ca_r + n_mine, ca_id + n_mine, n_enemy };
+    return true;
+}
+
+bool claim_anchor_set_covers(const ClaimAnchorSet *set, float x, float y) {
+    for (uint32_t k = 0; k < set->n; k++) {
+        float dx = x - set->x[k], dy = y - set->y[k];
+        if (dx * dx + dy * dy <= set->r[k] * set->r[k]) return true;
+    }
+    return false;
+}
+
+/* ── Claim-flag section cache ────────────────────────────────────────────── */
+
+typedef struct {
+    uint16_t flag_id;
+    uint8_t  island_id;
+    uint8_t  company_id;
+    bool     built;
+    bool     has_section;
+    float    dep_x0, dep_y0, dep_x1, dep_y1;   /* A change to a claim disc
+                                                * touching this rect can alter
+                                                * the section */
+    ClaimSectionGrid grid;
+    size_t   bits_cap;
+} CfSection;
+
+static CfSection *cf_sections;
+static size_t     cf_section_count, cf_section_cap;
+
+/* Claim-relevant state of each placed_structures[] slot at the last sync.
+ * Every live non-flag structure is tracked, not just anchors: a structure
+ * can subtract territory as someone's dominator without being an anchor. */
+typedef struct {
+    float    x, y;
+    uint32_t dom_hash;
+    uint8_t  island_id, company_id;
+    uint8_t  type;
+    bool     live;
+    bool     anchor;
+    bool     dominates;
+} AnchorShadow;
+
+static AnchorShadow *shadow;
+static size_t        shadow_count, shadow_cap;
+
+static CfSection *cf_find(uint16_t flag_id) {
+    for (size_t i = 0; i < cf_section_count; i++)
+        if (cf_sections[i].flag_id == flag_id) return &cf_sections[i];
+    return NULL;
+}
+
+const ClaimSectionGrid *claim_flag_section(const PlacedStructure *flag) {
+    CfSection *e = cf_find(flag->id);
+    if (e && (e->island_id != flag->island_id || e->company_id != flag->company_id))
+        e->built = false;
+    if (!e) {
+        if (!grow((void **)&cf_sections, &cf_section_cap, cf_section_count + 1, sizeof(CfSection)))
+            return NULL;
+        e = &cf_sections[cf_section_count++];
+        memset(e, 0, sizeof(*e));
+        e->flag_id = flag->id;
+    }
+    if (!e->built) {
+        e->built       = true;
+        e->island_id   = flag->island_id;
+        e->company_id  = flag->company_id;
+        e->has_section = section_build_into(flag->island_id, flag->company_id,
+                                            flag->x, flag->y, &e->grid, &e->bits_cap);
+        float c = SECTION_CELL;
+        if (e->has_section) {
+            e->dep_x0 = e->grid.origin_x - c;
+            e->dep_y0 = e->grid.origin_y - c;
+            e->dep_x1 = e->grid.origin_x + (float)(e->grid.w + 1) * c;
+            e->dep_y1 = e->grid.origin_y + (float)(e->grid.h + 1) * c;
+        } else {
+            /* No section: only a disc covering the flag can create one */
+            e->dep_x0 = flag->x - c;  e->dep_x1 = flag->x + c;
+            e->dep_y0 = flag->y - c;  e->dep_y1 = flag->y + c;
+        }
+    }
+    return e->has_section ? &e->grid : NULL;
+}
+
+void claim_flag_section_release(uint16_t flag_id) {
+    CfSection *e = cf_find(flag_id);
+    if (!e) return;
+    free(e->grid.bits);
+    *e = cf_sections[--cf_section_count];
+}
+
+/* World-space test on purpose: a dominator need not share the flag's island */
+static void dirty_disc(float x, float y, float r) {
+    for (size_t i = 0; i < cf_section_count; i++) {
+        CfSection *e = &cf_sections[i];
+        if (!e->built) continue;
+        if (x + r < e->dep_x0 || x - r > e->dep_x1) continue;
+        if (y + r < e->dep_y0 || y - r > e->dep_y1) continue;
+        e->built = false;
+    }
+}
+
+static AnchorShadow shadow_of(const PlacedStructure *ps) {
+    AnchorShadow a;
+    memset(&a, 0, sizeof(a));
+    a.live = ps->active && ps->type != STRUCT_CLAIM_FLAG;
+    if (!a.live) return a;
+    a.anchor    = is_anchor(ps);
+    a.dominates = !ps->claim_orphaned &&
+                  !(ps->type == STRUCT_FLAG_FORT && !ps->fortress_complete);
+    a.x = ps->x;
+    a.y = ps->y;
+    a.island_id  = ps->island_id;
+    a.company_id = ps->company_id;
+    a.type       = (uint8_t)ps->type;
+    uint32_t h = 2166136261u;
+    for (int k = 0; k < ps->dominator_count; k++) h = (h ^ ps->dominators[k]) * 16777619u;
+    a.dom_hash = h;
+    return a;
+}
+
+static bool shadow_same(const AnchorShadow *a, const AnchorShadow *b) {
+    if (!a->live && !b->live) return true;
+    return a->live == b->live && a->anchor == b->anchor && a->dominates == b->dominates &&
+           a->x == b->x && a->y == b->y &&
+           a->island_id == b->island_id && a->company_id == b->company_id &&
+           a->type == b->type && a->dom_hash == b->dom_hash;
+}
+
+void claim_invalidate_cf_sections(void) {
+    if (!grow((void **)&shadow, &shadow_cap, placed_structure_count, sizeof(AnchorShadow))) {
+        /* Can't track changes: drop everything */
+        for (size_t i = 0; i < cf_section_count; i++) cf_sections[i].built = false;
+        return;
+    }
+    size_t n = placed_structure_count > shadow_count ? placed_structure_count : shadow_count;
+    for (size_t i = 0; i < n; i++) {
+        AnchorShadow now;
+        if (i < placed_structure_count) now = shadow_of(&placed_structures[i]);
+        else                            memset(&now, 0, sizeof(now));
+        AnchorShadow was;
+        if (i < shadow_count) was = shadow[i];
+        else                  memset(&was, 0, sizeof(was));
+        if (shadow_same(&was, &now)) continue;
+        if (was.live) dirty_disc(was.x, was.y, struct_claim_radius((PlacedStructureType)was.type));
+        if (now.live) dirty_disc(now.x, now.y, struct_claim_radius((PlacedStructureType)now.type));
+        if (i < placed_structure_count) shadow[i] = now;
+    }
+    shadow_count = placed_structure_count;
+
+    /* Forget flags that went away without a release (demolished, destroyed) */
+    for (size_t i = 0; i < cf_section_count;) {
+        PlacedStructure *f = structure_by_id(cf_sections[i].flag_id);
+        if (f && f->type == STRUCT_CLAIM_FLAG) { i++; continue; }
+        claim_flag_section_release(cf_sections[i].flag_id);
+    }
+}
+
+uint64_t claim_section_build_count(void) { return section_builds; }
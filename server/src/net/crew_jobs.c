@@ -0,0 +1,141 @@
+#include <string.h>
+#include "net/crew_jobs.h"
+#include "net/npc_world.h"
+
+/* ── Weapons ──────────────────────────────────────────────────────────────── */
+
+static bool is_weapon(const ShipModule* mod) {
+    return mod->type_id == MODULE_TYPE_CANNON || mod->type_id == MODULE_TYPE_SWIVEL;
+}
+
+/* A zeroed board adopts whatever NEEDED bits the ship already carries
+ * (fresh ship, world load) once. */
+static void needed_adopt(SimpleShip* ship) {
+    ship->crew_needed_valid = true;
+    ship->crew_needed_count = 0;
+    for (int m = 0; m < ship->module_count; m++) {
+        const ShipModule* mod = &ship->modules[m];
+        if (is_weapon(mod) && (mod->state_bits & MODULE_STATE_NEEDED))
+            ship->crew_needed[ship->crew_needed_count++] = (module_id_t)mod->id;
+    }
+}
+
+void crew_jobs_weapon_needed(SimpleShip* ship, ShipModule* mod) {
+    if (!ship || !mod) return;
+    if (!ship->crew_needed_valid) needed_adopt(ship);
+    bool was = (mod->state_bits & MODULE_STATE_NEEDED) != 0;
+    mod->state_bits |= MODULE_STATE_NEEDED;
+    if (was) {
+        /* Normally listed already; a bit set behind the board's back (or a
+         * list that was full) is picked up here */
+        for (int k = 0; k < ship->crew_needed_count; k++)
+            if (ship->crew_needed[k] == (module_id_t)mod->id) return;
+    }
+    if (ship->crew_needed_count < MAX_MODULES_PER_SHIP)
+        ship->crew_needed[ship->crew_needed_count++] = (module_id_t)mod->id;
+}
+
+const module_id_t* crew_jobs_needed_weapons(SimpleShip* ship, int* out_count) {
+    if (!ship->crew_needed_valid) needed_adopt(ship);
+    int kept = 0;
+    for (int k = 0; k < ship->crew_needed_count; k++) {
+        ShipModule* mod = find_module_on_ship(ship, ship->crew_needed[k]);
+        if (!mod || !is_weapon(mod) || !(mod->state_bits & MODULE_STATE_NEEDED)) continue;
+        ship->crew_needed[kept++] = ship->crew_needed[k];
+    }
+    ship->crew_needed_count = (uint8_t)kept;
+    *out_count = kept;
+    return ship->crew_needed;
+}
+
+/* ── Repairs ──────────────────────────────────────────────────────────────── */
+
+bool crew_jobs_plank_intact(const struct Ship* sim, uint8_t ship_seq, int slot) {
+    if (!sim || slot < 0 || slot >= 10) return false;
+    uint16_t expected = MID(ship_seq, MODULE_OFFSET_PLANK(slot));
+    for (uint8_t m = 0; m < sim->module_count; m++) {
+        const ShipModule* mod = &sim->modules[m];
+        if ((uint32_t)mod->id != (uint32_t)expected) continue;
+        if (mod->state_bits & MODULE_STATE_DESTROYED) return false;
+        if (mod->health <= 0) return false;
+        return true;
+    }
+    return false;
+}
+
+static float module_ratio(const ShipModule* mod) {
+    float ratio = (float)mod->health / (float)mod->max_health;
+    if (mod->type_id == MODULE_TYPE_MAST) {
+        float fhmax = Q16_TO_FLOAT(mod->data.mast.fiber_max_health);
+        if (fhmax > 0.0f) {
+            float fiber_ratio = Q16_TO_FLOAT(mod->data.mast.fiber_health) / fhmax;
+            if (fiber_ratio < ratio) ratio = fiber_ratio;
+        }
+    }
+    return ratio;
+}
+
+/* Planks are replace-only: they show up as missing slots, never as damage */
+static bool module_needs_repair(const ShipModule* mod) {
+    if (mod->type_id == MODULE_TYPE_PLANK) return false;
+    if (mod->state_bits & MODULE_STATE_DESTROYED) return false;
+    if (mod->max_health == 0) return false;
+    return module_ratio(mod) < 1.0f;
+}
+
+static void repairs_rebuild(SimpleShip* ship, const struct Ship* sim) {
+    CrewRepairJob* jobs = ship->crew_repairs;
+    int n = 0;
+
+    bool deck_present = false;
+    for (uint8_t m = 0; m < sim->module_count; m++)
+        if (sim->modules[m].type_id == MODULE_TYPE_DECK) { deck_present = true; break; }
+    if (!deck_present)
+        jobs[n++] = (CrewRepairJob){ MID(ship->ship_seq, MODULE_OFFSET_DECK), CREW_JOB_DECK, 0 };
+
+    for (int k = 0; k < 10; k++)
+        if (!crew_jobs_plank_intact(sim, ship->ship_seq, k))
+            jobs[n++] = (CrewRepairJob){ MID(ship->ship_seq, MODULE_OFFSET_PLANK(k)), CREW_JOB_PLANK, (uint8_t)k };
+
+    for (uint8_t m = 0; m < sim->module_count && n < CREW_REPAIR_JOBS_MAX; m++)
+        if (module_needs_repair(&sim->modules[m]))
+            jobs[n++] = (CrewRepairJob){ (module_id_t)sim->modules[m].id, CREW_JOB_MODULE, m };
+
+    ship->crew_repair_count         = (uint8_t)n;
+    ship->crew_repairs_valid        = true;
+    ship->crew_repairs_epoch        = sim->module_epoch;
+    ship->crew_repairs_module_count = sim->module_count;
+}
+
+ShipModule* crew_job_module(struct Ship* sim, const CrewRepairJob* job, float* out_ratio) {
+    ShipModule* mod = NULL;
+    if (job->slot < sim->module_count && sim->modules[job->slot].id == job->module_id) {
+        mod = &sim->modules[job->slot];
+    } else {
+        for (uint8_t m = 0; m < sim->module_count; m++)
+            if (sim->modules[m].id == job->module_id) { mod = &sim->modules[m]; break; }
+    }
+    if (mod && out_ratio) *out_ratio = mod->max_health > 0 ? module_ratio(mod) : 1.0f;
+    return mod;
+}
+
+const CrewRepairJob* crew_jobs_repairs(SimpleShip* ship, struct Ship* sim, int* out_count) {
+    if (!ship->crew_repairs_valid ||
+        ship->crew_repairs_epoch != sim->module_epoch ||
+        ship->crew_repairs_module_count != sim->module_count)
+        repairs_rebuild(ship, sim);
+
+    int kept = 0;
+    for (int k = 0; k < ship->crew_repair_count; k++) {
+        CrewRepairJob job = ship->crew_repairs[k];
+        if (job.kind == CREW_JOB_MODULE) {
+            ShipModule* mod = crew_job_module(sim, &job, NULL);
+            if (!mod || !module_needs_repair(mod)) continue;
+            job.slot = (uint8_t)(mod - sim->modules);
+        }
+        ship->crew_repairs[kept++] = job;
+    }
+    ship->crew_repair_count = (uint8_t)kept;
+    *out_count = kept;
+    return ship->crew_repairs;
+}
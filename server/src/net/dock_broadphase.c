@@ -0,0 +1,117 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "net/dock_broadphase.h"
+#include "util/log.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/* Filed docks in counting-sort layout: bucket b holds
+ * g_refs[g_start[b] .. g_start[b + 1]).  Buckets are hashed cells, so a
+ * bucket can also hold docks from a distant cell — the box test drops them. */
+static DockBox   g_box[DOCK_BP_MAX_DOCKS];
+static uint32_t  g_stamp[DOCK_BP_MAX_DOCKS];   /* Last query that reported it */
+static uint32_t  g_count;
+static uint32_t  g_start[DOCK_BP_BUCKETS + 1];
+static uint16_t *g_refs;
+static uint32_t  g_refs_cap;
+static uint32_t  g_query;
+
+static inline int32_t cell_of(float v) {
+    return (int32_t)floorf(v / DOCK_BP_CELL_PX);
+}
+
+static inline uint32_t bucket_of(int32_t cx, int32_t cy) {
+    return ((uint32_t)cx * 73856093u ^ (uint32_t)cy * 19349663u) & (DOCK_BP_BUCKETS - 1);
+}
+
+static inline bool overlaps(const DockBox *a, const DockBox *b) {
+    return a->min_x <= b->max_x && a->max_x >= b->min_x &&
+           a->min_y <= b->max_y && a->max_y >= b->min_y;
+}
+
+DockBox dock_bp_obb_box(float x, float y, float hx, float hy, float rot_deg) {
+    float r = rot_deg * (float)M_PI / 180.0f;
+    float c = fabsf(cosf(r)), s = fabsf(sinf(r));
+    float ex = c * hx + s * hy;
+    float ey = s * hx + c * hy;
+    return (DockBox){ x - ex, y - ey, x + ex, y + ey };
+}
+
+void dock_bp_build(const DockBox *boxes, uint32_t n) {
+    if (n > DOCK_BP_MAX_DOCKS) {
+        log_warn("dock broad phase: %u shipyards, only %u filed", n, DOCK_BP_MAX_DOCKS);
+        n = DOCK_BP_MAX_DOCKS;
+    }
+    memcpy(g_box, boxes, n * sizeof(DockBox));
+    memset(g_stamp, 0, n * sizeof(uint32_t));
+    g_count = n;
+
+    uint32_t per_bucket[DOCK_BP_BUCKETS + 1];
+    memset(per_bucket, 0, sizeof(per_bucket));
+    uint32_t total = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        const DockBox *d = &g_box[i];
+        for (int32_t cy = cell_of(d->min_y); cy <= cell_of(d->max_y); cy++)
+            for (int32_t cx = cell_of(d->min_x); cx <= cell_of(d->max_x); cx++) {
+                per_bucket[bucket_of(cx, cy)]++;
+                total++;
+            }
+    }
+    if (total > g_refs_cap) {
+        uint16_t *grown = realloc(g_refs, total * sizeof(uint16_t));
+        if (!grown) {
+            log_error("dock broad phase: out of memory for %u cell refs", total);
+            g_count = 0;
+            memset(g_start, 0, sizeof(g_start));
+            return;
+        }
+        g_refs = grown;
+        g_refs_cap = total;
+    }
+
+    g_start[0] = 0;
+    for (uint32_t b = 0; b < DOCK_BP_BUCKETS; b++) g_start[b + 1] = g_start[b] + per_bucket[b];
+    memcpy(per_bucket, g_start, DOCK_BP_BUCKETS * sizeof(uint32_t));
+    for (uint32_t i = 0; i < n; i++) {
+        const DockBox *d = &g_box[i];
+        for (int32_t cy = cell_of(d->min_y); cy <= cell_of(d->max_y); cy++)
+            for (int32_t cx = cell_of(d->min_x); cx <= cell_of(d->max_x); cx++)
+                g_refs[per_bucket[bucket_of(cx, cy)]++] = (uint16_t)i;
+    }
+}
+
+uint32_t dock_bp_count(void) {
+    return g_count;
+}
+
+uint32_t dock_bp_query(const DockBox *q, uint16_t *out, uint32_t cap) {
+    if (g_count == 0 || cap == 0) return 0;
+    if (++g_query == 0) {
+        memset(g_stamp, 0, g_count * sizeof(uint32_t));
+        g_query = 1;
+    }
+
+    uint32_t n = 0;
+    for (int32_t cy = cell_of(q->min_y); cy <= cell_of(q->max_y); cy++) {
+        for (int32_t cx = cell_of(q->min_x); cx <= cell_of(q->max_x); cx++) {
+            uint32_t b = bucket_of(cx, cy);
+            for (uint32_t k = g_start[b]; k < g_start[b + 1] && n < cap; k++) {
+                uint16_t d = g_refs[k];
+                if (g_stamp[d] == g_query) continue;
+                g_stamp[d] = g_query;
+                if (overlaps(q, &g_box[d])) out[n++] = d;
+            }
+        }
+    }
+    /* Insertion sort: a ship rarely touches more than a couple of docks */
+    for (uint32_t i = 1; i < n; i++) {
+        uint16_t d = out[i];
+        uint32_t j = i;
+        for (; j > 0 && out[j - 1] > d; j--) out[j] = out[j - 1];
+        out[j] = d;
+    }
+    return n;
+}
@@ -1,6 +1,7 @@
 #include "net/websocket_server_internal.h"
 #include "net/structure_index.h"
 #include "net/dock_physics.h"
+#include "net/dock_broadphase.h"
 #include "sim/island.h"
 #define _USE_MATH_DEFINES
 #include <math.h>
@@ -8,6 +9,7 @@
 #include <stdbool.h>
 #include <stdlib.h>
 #include "util/log.h"
+#include "util/metrics.h"
 
 // Define M_PI if not available
 #ifndef M_PI
@@ -23,11 +25,12 @@
    floor tile and computing atan2(wall - floor) + pi/2 (wall runs perpendicular
    to the floor-centre -> edge-midpoint vector, same formula used by the client). */
 float wall_get_rad(float wx, float wy) {
+    static StructureNear floors;
     float best_dist2 = 35.0f * 35.0f;
     float best_rad   = 0.0f;
-    for (uint32_t fi = 0; fi < placed_structure_count; fi++) {
-        if (!placed_structures[fi].active) continue;
-        if (placed_structures[fi].type != STRUCT_WOODEN_FLOOR) continue;
+    structure_index_near(&floors, wx, wy, 35.0f, STRUCT_MASK(STRUCT_WOODEN_FLOOR));
+    for (uint32_t k = 0; k < floors.count; k++) {
+        uint32_t fi = floors.slots[k];
         float dx = wx - placed_structures[fi].x;
         float dy = wy - placed_structures[fi].y;
         float d2 = dx * dx + dy * dy;
@@ -38,10 +41,11 @@ float wall_get_rad(float wx, float wy) {
 
 /* Check whether any active floor tile has a wall/door at one of its rotated edge midpoints. */
 bool wall_has_support(float wx, float wy) {
+    static StructureNear floors;
     const float EDGE_TOL = 4.0f, HALF = 25.0f;
-    for (uint32_t fi = 0; fi < placed_structure_count; fi++) {
-        PlacedStructure *f = &placed_structures[fi];
-        if (!f->active || f->type != STRUCT_WOODEN_FLOOR) continue;
+    structure_index_near(&floors, wx, wy, HALF + EDGE_TOL, STRUCT_MASK(STRUCT_WOODEN_FLOOR));
+    for (uint32_t k = 0; k < floors.count; k++) {
+        PlacedStructure *f = &placed_structures[floors.slots[k]];
         float rad = f->rotation * (float)M_PI / 180.0f;
         float c = cosf(rad), sn = sinf(rad);
         /* Rotated edge midpoints: N(0,-H), S(0,+H), W(-H,0), E(+H,0) in local space */
@@ -154,24 +158,7 @@ void dock_apply_player_collision(const PlacedStructure *sy, float player_r,
 }
 
 static bool world_point_on_island_land(float px, float py) {
-    for (int ii = 0; ii < ISLAND_COUNT; ii++) {
-        const IslandDef *isl = &ISLAND_PRESETS[ii];
-        float dx = px - isl->x, dy = py - isl->y;
-        float dist_sq = dx * dx + dy * dy;
-        if (isl->vertex_count > 0) {
-            if (dist_sq < isl->poly_bound_r * isl->poly_bound_r
-                && island_poly_contains(isl, px, py)) {
-                return true;
-            }
-        } else {
-            float broad_r = isl->beach_radius_px + isl->beach_max_bump;
-            if (dist_sq >= broad_r * broad_r) continue;
-            float angle   = atan2f(dy, dx);
-            float narrow_r = island_boundary_r(isl->beach_radius_px, isl->beach_bumps, angle);
-            if (dist_sq < narrow_r * narrow_r) return true;
-        }
-    }
-    return false;
+    return island_land_at(px, py) != NULL;
 }
 
 bool dock_brig_slot_overlaps_land(float dock_x, float dock_y, float dock_rot_deg) {
@@ -291,9 +278,18 @@ static bool dock_wall_sat(const float *hdx, const float *hdy, int N,
     return true;
 }
 
-void handle_ship_dock_collisions(void) {
-    if (!global_sim) return;
-
+/* Accumulated per-wall impulses of one (dock, ship) pair, carried from one
+ * solve to the next for warm starting. */
+typedef struct {
+    float P_n[3], P_f[3];
+} DockImpulse;
+
+/* Solve one ship against one dock's three walls: CCD pre-pass, warm-started
+ * SAT contact solver, angular cap and rotational CCD.  `warm` is the pair's
+ * last solve (NULL for a new pair); this solve's impulses go to `out`.
+ * Returns true if the ship's position was corrected. */
+static bool dock_resolve_ship(PlacedStructure *sy, struct Ship *ship,
+                              const DockImpulse *warm, DockImpulse *out) {
     static const struct { float cx, cy, hx, hy; } WALLS[3] = {
         { -(DOCK_HW - DOCK_ARM_T/2.0f), 0.0f,      DOCK_ARM_T/2.0f,  DOCK_HH          },
         {  (DOCK_HW - DOCK_ARM_T/2.0f), 0.0f,      DOCK_ARM_T/2.0f,  DOCK_HH          },
@@ -313,652 +309,810 @@ void handle_ship_dock_collisions(void) {
      * impulses from wall A to inform the response at wall B. */
     static const int   N_ITER        = 3;
 
-    const uint32_t *yslots = structure_index_shipyard_slots();
-    uint32_t yc = structure_index_shipyard_count();
-    for (uint32_t yi = 0; yi < yc; yi++) {
-        PlacedStructure *sy = &placed_structures[yslots[yi]];
-
-        for (uint32_t si = 0; si < global_sim->ship_count; si++) {
-            struct Ship *ship = &global_sim->ships[si];
-            if ((uint32_t)ship->id == sy->scaffolded_ship_id) continue;
-
-            /* Broad phase */
-            float sxc  = SERVER_TO_CLIENT(Q16_TO_FLOAT(ship->position.x));
-            float syc  = SERVER_TO_CLIENT(Q16_TO_FLOAT(ship->position.y));
-            float brad = SERVER_TO_CLIENT(Q16_TO_FLOAT(ship->bounding_radius));
-            float ddx  = sxc - sy->x, ddy = syc - sy->y;
-            float broad = brad + DOCK_HH + DOCK_HW;
-            if (ddx * ddx + ddy * ddy > broad * broad) continue;
-
-            /* Build hull in dock-local px */
-            int N = (int)ship->hull_vertex_count; if (N < 3) continue;
-            float ship_rad = Q16_TO_FLOAT(ship->rotation);
-            float cs = cosf(ship_rad), ss = sinf(ship_rad);
-            float hdx[64], hdy[64];
+    memset(out, 0, sizeof(*out));
+    float sxc  = SERVER_TO_CLIENT(Q16_TO_FLOAT(ship->position.x));
+    float syc  = SERVER_TO_CLIENT(Q16_TO_FLOAT(ship->position.y));
+    float brad = SERVER_TO_CLIENT(Q16_TO_FLOAT(ship->bounding_radius));
+
+    /* Build hull in dock-local px */
+    int N = (int)ship->hull_vertex_count; if (N < 3) return false;
+    float ship_rad = Q16_TO_FLOAT(ship->rotation);
+    float cs = cosf(ship_rad), ss = sinf(ship_rad);
+    float hdx[64], hdy[64];
+    for (int vi = 0; vi < N; vi++) {
+        float lhx = SERVER_TO_CLIENT(Q16_TO_FLOAT(ship->hull_vertices[vi].x));
+        float lhy = SERVER_TO_CLIENT(Q16_TO_FLOAT(ship->hull_vertices[vi].y));
+        float wx  = sxc + lhx * cs - lhy * ss;
+        float wy  = syc + lhx * ss + lhy * cs;
+        dock_world_to_local(sy, wx, wy, &hdx[vi], &hdy[vi]);
+    }
+    float lx, ly;
+    dock_world_to_local(sy, sxc, syc, &lx, &ly);
+
+    /* Ship velocity in dock-local px/s */
+    float dock_rad = sy->rotation * (float)M_PI / 180.0f;
+    float dc = cosf(dock_rad), ds = sinf(dock_rad);
+    float vx_w = SERVER_TO_CLIENT(Q16_TO_FLOAT(ship->velocity.x));
+    float vy_w = SERVER_TO_CLIENT(Q16_TO_FLOAT(ship->velocity.y));
+    float vx_dl =  vx_w * dc + vy_w * ds;
+    float vy_dl = -vx_w * ds + vy_w * dc;
+    float omega  = Q16_TO_FLOAT(ship->angular_velocity);
+
+    /* Physics in client-px space: I_px = I_server * (WORLD_SCALE_FACTOR)^2 */
+    float mass_f    = Q16_TO_FLOAT(ship->mass);
+    float inertia_f = Q16_TO_FLOAT(ship->moment_inertia) * 100.0f;
+    float inv_mass    = (mass_f    > 0.0f) ? 1.0f / mass_f    : 0.0f;
+    float inv_inertia = (inertia_f > 0.0f) ? 1.0f / inertia_f : 0.0f;
+
+    float total_push_x = 0.0f, total_push_y = 0.0f;
+    bool  moved = false;
+
+    /* Per-wall accumulated impulse (normal + friction).
+     * Clamped across iterations so Coulomb friction is bounded by the
+     * total normal impulse applied so far, not just this iteration's. */
+    float P_n[3] = {0.0f, 0.0f, 0.0f};
+    float P_f[3] = {0.0f, 0.0f, 0.0f};
+
+    /* Working velocity — updated after every wall within every iteration
+     * so wall B in iteration 2 sees the corrected state from wall A. */
+    float cur_vx = vx_dl, cur_vy = vy_dl, cur_w = omega;
+
+    /* ── Translational CCD pre-pass ──────────────────────────────────
+     * The SAT solver below can only resolve overlaps it can see.  If
+     * the ship moves faster than a wall's thickness in one tick it may
+     * fully pass through before the SAT check runs, giving zero
+     * penetration and therefore zero response (the classic tunnelling
+     * bug).
+     *
+     * We sweep the bounding circle from (lx - vx_dl*dt, ly - vy_dl*dt)
+     * — the position one tick ago — to (lx, ly) against each of the
+     * three inner-facing dock wall segments.  If we find a hit, we
+     * rewind to just before the TOI, reflect the penetrating velocity
+     * component, and rebuild the hull array so the SAT solver still
+     * runs on the corrected state.                                    */
+    {
+        float dt_tick = 1.0f / (float)TICK_RATE_HZ;
+        float ax_ccd = lx - vx_dl * dt_tick;
+        float ay_ccd = ly - vy_dl * dt_tick;
+        float disp_x = lx - ax_ccd, disp_y = ly - ay_ccd;
+
+        /* Only bother if the ship actually moved a meaningful amount */
+        if (disp_x * disp_x + disp_y * disp_y > 0.25f) {
+            float ai_ccd = DOCK_HW - DOCK_ARM_T;                 /* 120 */
+            float bi_ccd = DOCK_HH - DOCK_BACK_T;                /* 395 */
+
+            /* Inner-facing wall segments in dock-local px.
+             * nx/ny is the outward (interior-facing) normal. */
+            struct { float x0,y0,x1,y1, nx,ny; } iw[3] = {
+                { -ai_ccd, -DOCK_HH, -ai_ccd,  DOCK_HH,   1.0f,  0.0f },
+                {  ai_ccd, -DOCK_HH,  ai_ccd,  DOCK_HH,  -1.0f,  0.0f },
+                { -ai_ccd,   -bi_ccd,  ai_ccd, -bi_ccd,   0.0f,  1.0f },
+            };
+
+            float best_t = 2.0f, best_nx = 0.0f, best_ny = 0.0f;
+
+            for (int wi = 0; wi < 3; wi++) {
+                float ex = iw[wi].x1 - iw[wi].x0;
+                float ey = iw[wi].y1 - iw[wi].y0;
+                float elen = sqrtf(ex*ex + ey*ey);
+                if (elen < 1e-6f) continue;
+
+                float enx = iw[wi].nx, eny = iw[wi].ny;
+                float d0 = (ax_ccd - iw[wi].x0)*enx + (ay_ccd - iw[wi].y0)*eny;
+                float d1 = (lx     - iw[wi].x0)*enx + (ly     - iw[wi].y0)*eny;
+                float dd  = d1 - d0;
+                if (fabsf(dd) < 1e-10f) continue;
+
+                /* Circle surface touches the wall line at t where d(t) == ±brad */
+                float target_d = (d0 > 0.0f) ? brad : -brad;
+                float t = (target_d - d0) / dd;
+                if (t < 0.0f || t > 1.0f) continue;
+
+                /* Confirm contact point is within segment extent */
+                float cx_t = ax_ccd + disp_x * t;
+                float cy_t = ay_ccd + disp_y * t;
+                float proj = ((cx_t - iw[wi].x0)*ex + (cy_t - iw[wi].y0)*ey)
+                             / (elen * elen);
+                if (proj < 0.0f || proj > 1.0f) continue;
+
+                if (t < best_t) {
+                    best_t  = t;
+                    best_nx = enx;
+                    best_ny = eny;
+                }
+            }
+
+            if (best_t <= 1.0f) {
+                /* Rewind to just before the wall */
+                float safe_t  = fmaxf(best_t - 0.01f, 0.0f);
+                float new_lx  = ax_ccd + disp_x * safe_t;
+                float new_ly  = ay_ccd + disp_y * safe_t;
+
+                /* Reflect penetrating velocity component */
+                float vn_ccd  = vx_dl * best_nx + vy_dl * best_ny;
+                if (vn_ccd < 0.0f) {
+                    vx_dl   -= (1.0f + RESTITUTION) * vn_ccd * best_nx;
+                    vy_dl   -= (1.0f + RESTITUTION) * vn_ccd * best_ny;
+                    cur_vx   = vx_dl;
+                    cur_vy   = vy_dl;
+
+                    /* Write corrected velocity back to sim ship (rotate
+                     * dock-local → world, then px/s → server units/s) */
+                    float vx_w2 = vx_dl * dc - vy_dl * ds;
+                    float vy_w2 = vx_dl * ds + vy_dl * dc;
+                    ship->velocity.x = Q16_FROM_FLOAT(CLIENT_TO_SERVER(vx_w2));
+                    ship->velocity.y = Q16_FROM_FLOAT(CLIENT_TO_SERVER(vy_w2));
+                }
+
+                /* Write corrected position back to sim ship */
+                float new_wx2, new_wy2;
+                dock_local_to_world(sy, new_lx, new_ly, &new_wx2, &new_wy2);
+                ship->position.x = Q16_FROM_FLOAT(CLIENT_TO_SERVER(new_wx2));
+                ship->position.y = Q16_FROM_FLOAT(CLIENT_TO_SERVER(new_wy2));
+                moved = true;
+
+                /* Rebuild hull vertices in dock-local space so the SAT
+                 * solver below sees the corrected position. */
+                float offset_x = new_lx - lx, offset_y = new_ly - ly;
+                lx = new_lx;
+                ly = new_ly;
+                for (int vi = 0; vi < N; vi++) {
+                    hdx[vi] += offset_x;
+                    hdy[vi] += offset_y;
+                }
+            }
+        }
+    } /* end translational CCD pre-pass */
+
+    /* Warm start: seed P_n/P_f with 80% of the pair's last accumulated
+     * impulse so the solver starts near the converged answer instead of
+     * building up from zero. */
+    if (warm) {
+        for (int wi = 0; wi < 3; wi++) {
+            P_n[wi] = warm->P_n[wi] * 0.8f;
+            P_f[wi] = warm->P_f[wi] * 0.8f;
+        }
+        /* Apply warm-start impulse to working velocity */
+        for (int wi = 0; wi < 3; wi++) {
+            if (P_n[wi] <= 0.0f) continue;
+            float pen, wnx, wny, wcx, wcy;
+            if (!dock_wall_sat(hdx, hdy, N,
+                               WALLS[wi].cx, WALLS[wi].cy,
+                               WALLS[wi].hx, WALLS[wi].hy,
+                               lx, ly,
+                               &pen, &wnx, &wny, &wcx, &wcy)) {
+                P_n[wi] = 0; P_f[wi] = 0; continue;
+            }
+            float wrx = wcx - lx, wry = wcy - ly;
+            cur_vx += P_n[wi] * wnx * inv_mass;
+            cur_vy += P_n[wi] * wny * inv_mass;
+            cur_w  += (wrx * (P_n[wi] * wny) - wry * (P_n[wi] * wnx)) * inv_inertia;
+            /* Friction warm-start */
+            float vt_x2 = -wny, vt_y2 = wnx; /* tangent direction */
+            cur_vx += P_f[wi] * vt_x2 * inv_mass;
+            cur_vy += P_f[wi] * vt_y2 * inv_mass;
+            cur_w  += (wrx * (P_f[wi] * vt_y2) - wry * (P_f[wi] * vt_x2)) * inv_inertia;
+        }
+    }
+
+    /* dt in seconds (for Baumgarte bias = β/dt * max(pen-slop, 0)) */
+    float dt_s = 1.0f / (float)TICK_RATE_HZ;
+
+    for (int iter = 0; iter < N_ITER; iter++) {
+        for (int wi = 0; wi < 3; wi++) {
+            float pen, nx, ny, cx, cy;
+            if (!dock_wall_sat(hdx, hdy, N,
+                               WALLS[wi].cx, WALLS[wi].cy,
+                               WALLS[wi].hx, WALLS[wi].hy,
+                               lx, ly,
+                               &pen, &nx, &ny, &cx, &cy)) continue;
+
+            /* Positional correction: apply fraction of remaining penetration
+             * each iteration (Baumgarte-style spreading).  Subsequent
+             * iterations re-detect the reduced penetration automatically. */
+            float corr = BAUMGARTE * fmaxf(pen - SLOP, 0.0f);
+            if (corr > 0.0f) {
+                lx += nx * corr; ly += ny * corr;
+                for (int vi = 0; vi < N; vi++) { hdx[vi] += nx * corr; hdy[vi] += ny * corr; }
+                total_push_x += nx * corr; total_push_y += ny * corr;
+            }
+
+            /* Lever arm from ship origin to contact point */
+            float rx = cx - lx, ry = cy - ly;
+
+            /* Velocity at contact: v_cm + ω×r */
+            float vc_x = cur_vx + cur_w * (-ry);
+            float vc_y = cur_vy + cur_w * ( rx);
+            float vc_n = vc_x * nx + vc_y * ny;
+
+            /* ── Normal impulse with Baumgarte velocity bias ── */
+            float rxn   = rx * ny - ry * nx;
+            float denom = inv_mass + rxn * rxn * inv_inertia;
+            if (denom < 1e-10f) continue;
+
+            /* bias = β/dt * max(pen - slop, 0): drains residual positional
+             * error that Baumgarte pos-correction didn't fully remove. */
+            float bias = (BAUMGARTE / dt_s) * fmaxf(pen - SLOP, 0.0f);
+
+            /* Impulse increment (clamped: normal impulse can only push, never pull) */
+            float dP = (-(1.0f + RESTITUTION) * vc_n + bias) / denom;
+            float P_n_new = fmaxf(P_n[wi] + dP, 0.0f);
+            float J = P_n_new - P_n[wi];
+            P_n[wi] = P_n_new;
+
+            cur_vx += J * nx * inv_mass;
+            cur_vy += J * ny * inv_mass;
+            cur_w  += (rx * (J * ny) - ry * (J * nx)) * inv_inertia;
+
+            /* ── Friction impulse (Coulomb, clamped against accumulated P_n) ── */
+            /* Re-sample velocity after normal impulse for correct tangential v */
+            float vc_x2 = cur_vx + cur_w * (-ry);
+            float vc_y2 = cur_vy + cur_w * ( rx);
+            float vc_n2 = vc_x2 * nx + vc_y2 * ny;
+            float vt_x  = vc_x2 - vc_n2 * nx;
+            float vt_y  = vc_y2 - vc_n2 * ny;
+            float vt_len = sqrtf(vt_x * vt_x + vt_y * vt_y);
+            if (vt_len > 0.001f) {
+                float tx = vt_x / vt_len, ty = vt_y / vt_len;
+                float rxt   = rx * ty - ry * tx;
+                float denom_t = inv_mass + rxt * rxt * inv_inertia;
+                if (denom_t > 1e-10f) {
+                    float dPf    = -vt_len / denom_t;
+                    float Pf_max = WALL_FRICTION * P_n[wi]; /* clamp against TOTAL accumulated normal */
+                    float Pf_new = P_f[wi] + dPf;
+                    if (Pf_new >  Pf_max) Pf_new =  Pf_max;
+                    if (Pf_new < -Pf_max) Pf_new = -Pf_max;
+                    float Jf = Pf_new - P_f[wi];
+                    P_f[wi] = Pf_new;
+                    cur_vx += Jf * tx * inv_mass;
+                    cur_vy += Jf * ty * inv_mass;
+                    cur_w  += (rx * (Jf * ty) - ry * (Jf * tx)) * inv_inertia;
+                }
+            }
+        }
+    } /* end N_ITER */
+
+    /* ── Equal-and-opposite reaction pass ─────────────────────────
+     *
+     * Simple idea: for each active wall contact, measure the
+     * residual approach velocity (linear + angular).  If the
+     * contact point is still moving into the wall, apply the
+     * exact impulse to zero it out.  The wall provides whatever
+     * reaction is needed — no prediction, no clamps. */
+    for (int wi = 0; wi < 3; wi++) {
+        if (P_n[wi] <= 0.0f) continue;
+
+        float pen, nx, ny, cx, cy;
+        if (!dock_wall_sat(hdx, hdy, N,
+                           WALLS[wi].cx, WALLS[wi].cy,
+                           WALLS[wi].hx, WALLS[wi].hy,
+                           lx, ly,
+                           &pen, &nx, &ny, &cx, &cy)) continue;
+
+        float rx = cx - lx, ry = cy - ly;
+        float vc_x = cur_vx + cur_w * (-ry);
+        float vc_y = cur_vy + cur_w * ( rx);
+        float vc_n = vc_x * nx + vc_y * ny;
+
+        if (vc_n < 0.0f) {
+            float rxn   = rx * ny - ry * nx;
+            float denom = inv_mass + rxn * rxn * inv_inertia;
+            if (denom < 1e-10f) continue;
+            float J = -vc_n / denom;
+            cur_vx += J * nx * inv_mass;
+            cur_vy += J * ny * inv_mass;
+            cur_w  += rxn * J * inv_inertia;
+            P_n[wi] += J;
+        }
+    }
+
+    /* ── Dock angular velocity cap ────────────────────────────────
+     *
+     * The friction impulse in the N_ITER loop only resists rotation
+     * when one or more hull vertices are actively touching a wall.
+     * When the ship is centred in the dock it can freely spin up via
+     * rudder input until a vertex eventually hits a wall.  By then the
+     * angular momentum is so large that even the rotational CCD (below)
+     * has to deliver a harsh bounce impulse.
+     *
+     * Instead, continuously limit cur_w to the angular velocity at
+     * which the fastest-moving hull vertex would reach the nearest
+     * inner wall within one tick:
+     *
+     *   For vertex i at distance R_i from the ship centre:
+     *     dx_i(ω) = R_i * |ω| * dt   (arc length, linear approx)
+     *
+     *   Clearance to each inner wall face:
+     *     left_clear  = hdx[i] - (-ai)  = hdx[i] + ai
+     *     right_clear = ai - hdx[i]
+     *     back_clear  = hdy[i] - (-bi)  = hdy[i] + bi
+     *
+     *   If dx_i(ω) > min_clearance_i → vertex would hit.
+     *   ω_max_i = min_clearance_i / (R_i * dt)
+     *
+     *   ω_max = min over all vertices of ω_max_i, with a floor of
+     *   DOCK_OMEGA_FLOOR so the ship can still make slow progress.  */
+    {
+        static const float DOCK_OMEGA_FLOOR = 0.04f; /* rad/s min */
+        static const float DOCK_ANGULAR_EXTRA_DRAG = 0.80f; /* extra drag multiplier inside dock */
+        float dt_tick = 1.0f / (float)TICK_RATE_HZ;
+        float ai_cap  = DOCK_HW - DOCK_ARM_T;   /* 120 px inner half-width */
+        float bi_cap  = DOCK_HH - DOCK_BACK_T;  /* 395 px inner half-height */
+
+        float omega_max = 1e10f;
+
+        for (int vi = 0; vi < N; vi++) {
+            float vx_l = hdx[vi], vy_l = hdy[vi];
+
+            /* Distance from ship centre to this vertex */
+            float dvx = vx_l - lx, dvy = vy_l - ly;
+            float R = sqrtf(dvx * dvx + dvy * dvy);
+            if (R < 0.5f) continue;      /* vertex too close to pivot */
+
+            /* Clearance to each inner wall face (negative = already through) */
+            float cl_left  = vx_l - (-ai_cap);   /* to left arm inner  */
+            float cl_right = ai_cap  - vx_l;     /* to right arm inner */
+            float cl_back  = vy_l - (-bi_cap);   /* to back wall inner */
+
+            /* Only constrain if vertex is actually inside the dock channel */
+            float min_cl = 1e10f;
+            if (vx_l > -ai_cap)            min_cl = fminf(min_cl, cl_left);
+            if (vx_l <  ai_cap)            min_cl = fminf(min_cl, cl_right);
+            if (vy_l > -bi_cap && fabsf(vx_l) < ai_cap)
+                                           min_cl = fminf(min_cl, cl_back);
+
+            if (min_cl < 0.0f) min_cl = 0.0f;   /* already penetrating */
+
+            /* Max ω so arc < clearance in one tick */
+            float w_lim = min_cl / (R * dt_tick);
+            if (w_lim < omega_max) omega_max = w_lim;
+        }
+
+        /* Apply floor */
+        if (omega_max < DOCK_OMEGA_FLOOR) omega_max = DOCK_OMEGA_FLOOR;
+
+        /* Clamp and also apply extra drag so accumulated angular momentum
+         * bleeds off quickly while inside the dock */
+        cur_w *= DOCK_ANGULAR_EXTRA_DRAG;
+        if (cur_w >  omega_max) cur_w =  omega_max;
+        if (cur_w < -omega_max) cur_w = -omega_max;
+    }
+
+    /* Accumulated impulse for next tick's warm start */
+    for (int wi = 0; wi < 3; wi++) {
+        out->P_n[wi] = P_n[wi];
+        out->P_f[wi] = P_f[wi];
+    }
+
+    /* Write back position */
+    if (total_push_x * total_push_x + total_push_y * total_push_y > 0.0001f) {
+        float new_wx, new_wy;
+        dock_local_to_world(sy, lx, ly, &new_wx, &new_wy);
+        ship->position.x = Q16_FROM_FLOAT(CLIENT_TO_SERVER(new_wx));
+        ship->position.y = Q16_FROM_FLOAT(CLIENT_TO_SERVER(new_wy));
+        moved = true;
+    }
+
+    /* ── Rotational CCD ───────────────────────────────────────────
+     *
+     * Each hull vertex traces a circular arc as the ship rotates by
+     * dθ = cur_w · dt over one tick.  We test every arc against every
+     * dock wall segment.  If any intersection is found, we rewind cur_w
+     * to the earliest safe angle and apply a bounce impulse.
+     *
+     * Arc–line-segment intersection:
+     *   Vertex at angle θ in dock-local space:
+     *     Vx(θ) = ox + R·cos(α + θ)
+     *     Vy(θ) = oy + R·sin(α + θ)
+     *   where (ox,oy) = ship center in dock-local, R = distance from
+     *   center to vertex, α = initial angle of vertex from center.
+     *
+     *   Each wall is 4 line segments (edges of the AABB).  For a segment
+     *   from P to Q, the arc crosses that line when the signed distance
+     *   from V(θ) to the line changes sign.  We sample the arc at
+     *   N_ARC_SAMPLES points and detect zero-crossings, then refine
+     *   with bisection.
+     *
+     * Dock walls (3 AABBs → up to 12 segments, but only inner-facing
+     * edges matter):
+     *   Left arm inner:  x = -(DOCK_HW - DOCK_ARM_T) = -120, y ∈ [-445, +445]
+     *   Right arm inner: x = +(DOCK_HW - DOCK_ARM_T) = +120, y ∈ [-445, +445]
+     *   Back wall inner: y = -(DOCK_HH - DOCK_BACK_T) = -395, x ∈ [-120, +120]
+     */
+    {
+        float dt_tick = 1.0f / (float)TICK_RATE_HZ;
+        float dtheta = cur_w * dt_tick;
+
+        /* Skip if angular displacement is negligible */
+        if (fabsf(dtheta) > 1e-5f) {
+            /* Inner-facing wall segments in dock-local coords.
+             * Only the edges facing the interior can be hit by rotation. */
+            const float arm_inner = DOCK_HW - DOCK_ARM_T;  /* 120 */
+            const float back_inner = -(DOCK_HH - DOCK_BACK_T); /* -395 */
+            struct { float x0, y0, x1, y1; float nx, ny; } segs[] = {
+                /* Left arm inner edge (faces +x) */
+                { -arm_inner, -DOCK_HH, -arm_inner, +DOCK_HH,  1.0f, 0.0f },
+                /* Right arm inner edge (faces -x) */
+                {  arm_inner, -DOCK_HH,  arm_inner, +DOCK_HH, -1.0f, 0.0f },
+                /* Back wall inner edge (faces +y) */
+                { -arm_inner, back_inner, arm_inner, back_inner, 0.0f, 1.0f },
+            };
+            const int N_SEGS = 3;
+
+            /* Pre-compute per-vertex polar coords relative to ship center
+             * in dock-local space. */
+            float vR[64], vAlpha[64];
             for (int vi = 0; vi < N; vi++) {
-                float lhx = SERVER_TO_CLIENT(Q16_TO_FLOAT(ship->hull_vertices[vi].x));
-                float lhy = SERVER_TO_CLIENT(Q16_TO_FLOAT(ship->hull_vertices[vi].y));
-                float wx  = sxc + lhx * cs - lhy * ss;
-                float wy  = syc + lhx * ss + lhy * cs;
-                dock_world_to_local(sy, wx, wy, &hdx[vi], &hdy[vi]);
+                float vdx = hdx[vi] - lx, vdy = hdy[vi] - ly;
+                vR[vi] = sqrtf(vdx * vdx + vdy * vdy);
+                vAlpha[vi] = atan2f(vdy, vdx);
             }
-            float lx, ly;
-            dock_world_to_local(sy, sxc, syc, &lx, &ly);
 
-            /* Ship velocity in dock-local px/s */
+            /* Current ship rotation in dock-local frame.
+             * ship_rad is in world; subtract dock rotation to get dock-local. */
             float dock_rad = sy->rotation * (float)M_PI / 180.0f;
-            float dc = cosf(dock_rad), ds = sinf(dock_rad);
-            float vx_w = SERVER_TO_CLIENT(Q16_TO_FLOAT(ship->velocity.x));
-            float vy_w = SERVER_TO_CLIENT(Q16_TO_FLOAT(ship->velocity.y));
-            float vx_dl =  vx_w * dc + vy_w * ds;
-            float vy_dl = -vx_w * ds + vy_w * dc;
-            float omega  = Q16_TO_FLOAT(ship->angular_velocity);
-
-            /* Physics in client-px space: I_px = I_server * (WORLD_SCALE_FACTOR)^2 */
-            float mass_f    = Q16_TO_FLOAT(ship->mass);
-            float inertia_f = Q16_TO_FLOAT(ship->moment_inertia) * 100.0f;
-            float inv_mass    = (mass_f    > 0.0f) ? 1.0f / mass_f    : 0.0f;
-            float inv_inertia = (inertia_f > 0.0f) ? 1.0f / inertia_f : 0.0f;
-
-            float total_push_x = 0.0f, total_push_y = 0.0f;
-
-            /* Per-wall accumulated impulse (normal + friction).
-             * Clamped across iterations so Coulomb friction is bounded by the
-             * total normal impulse applied so far, not just this iteration's. */
-            float P_n[3] = {0.0f, 0.0f, 0.0f};
-            float P_f[3] = {0.0f, 0.0f, 0.0f};
-
-            /* Working velocity — updated after every wall within every iteration
-             * so wall B in iteration 2 sees the corrected state from wall A. */
-            float cur_vx = vx_dl, cur_vy = vy_dl, cur_w = omega;
-
-            /* ── Translational CCD pre-pass ──────────────────────────────────
-             * The SAT solver below can only resolve overlaps it can see.  If
-             * the ship moves faster than a wall's thickness in one tick it may
-             * fully pass through before the SAT check runs, giving zero
-             * penetration and therefore zero response (the classic tunnelling
-             * bug).
+            (void)dock_rad; /* local_rot_base calculation preserved for future use */
+            float local_rot_base __attribute__((unused)) = ship_rad - dock_rad;
+
+            /* Find earliest TOI across all vertices × all wall segments.
              *
-             * We sweep the bounding circle from (lx - vx_dl*dt, ly - vy_dl*dt)
-             * — the position one tick ago — to (lx, ly) against each of the
-             * three inner-facing dock wall segments.  If we find a hit, we
-             * rewind to just before the TOI, reflect the penetrating velocity
-             * component, and rebuild the hull array so the SAT solver still
-             * runs on the corrected state.                                    */
-            {
-                float dt_tick = 1.0f / (float)TICK_RATE_HZ;
-                float ax_ccd = lx - vx_dl * dt_tick;
-                float ay_ccd = ly - vy_dl * dt_tick;
-                float disp_x = lx - ax_ccd, disp_y = ly - ay_ccd;
-
-                /* Only bother if the ship actually moved a meaningful amount */
-                if (disp_x * disp_x + disp_y * disp_y > 0.25f) {
-                    float ai_ccd = DOCK_HW - DOCK_ARM_T;                 /* 120 */
-                    float bi_ccd = DOCK_HH - DOCK_BACK_T;                /* 395 */
-
-                    /* Inner-facing wall segments in dock-local px.
-                     * nx/ny is the outward (interior-facing) normal. */
-                    struct { float x0,y0,x1,y1, nx,ny; } iw[3] = {
-                        { -ai_ccd, -DOCK_HH, -ai_ccd,  DOCK_HH,   1.0f,  0.0f },
-                        {  ai_ccd, -DOCK_HH,  ai_ccd,  DOCK_HH,  -1.0f,  0.0f },
-                        { -ai_ccd,   -bi_ccd,  ai_ccd, -bi_ccd,   0.0f,  1.0f },
-                    };
-
-                    float best_t = 2.0f, best_nx = 0.0f, best_ny = 0.0f;
-
-                    for (int wi = 0; wi < 3; wi++) {
-                        float ex = iw[wi].x1 - iw[wi].x0;
-                        float ey = iw[wi].y1 - iw[wi].y0;
-                        float elen = sqrtf(ex*ex + ey*ey);
-                        if (elen < 1e-6f) continue;
-
-                        float enx = iw[wi].nx, eny = iw[wi].ny;
-                        float d0 = (ax_ccd - iw[wi].x0)*enx + (ay_ccd - iw[wi].y0)*eny;
-                        float d1 = (lx     - iw[wi].x0)*enx + (ly     - iw[wi].y0)*eny;
-                        float dd  = d1 - d0;
-                        if (fabsf(dd) < 1e-10f) continue;
-
-                        /* Circle surface touches the wall line at t where d(t) == ±brad */
-                        float target_d = (d0 > 0.0f) ? brad : -brad;
-                        float t = (target_d - d0) / dd;
-                        if (t < 0.0f || t > 1.0f) continue;
-
-                        /* Confirm contact point is within segment extent */
-                        float cx_t = ax_ccd + disp_x * t;
-                        float cy_t = ay_ccd + disp_y * t;
-                        float proj = ((cx_t - iw[wi].x0)*ex + (cy_t - iw[wi].y0)*ey)
-                                     / (elen * elen);
-                        if (proj < 0.0f || proj > 1.0f) continue;
-
-                        if (t < best_t) {
-                            best_t  = t;
-                            best_nx = enx;
-                            best_ny = eny;
-                        }
-                    }
+             * For each vertex, its dock-local position at fractional time t ∈ [0,1]:
+             *   θ(t) = local_rot_base + dtheta·t   (but vertex angle is baked into vAlpha)
+             *   Vx(t) = lx + R·cos(vAlpha + dtheta·t)
+             *   Vy(t) = ly + R·sin(vAlpha + dtheta·t)
+             *
+             * For axis-aligned wall segments, intersection reduces to:
+             *   Vertical wall (x = wx): cos(vAlpha + dtheta·t) = (wx - lx) / R
+             *   Horizontal wall (y = wy): sin(vAlpha + dtheta·t) = (wy - ly) / R
+             * These have closed-form acos/asin solutions. */
 
-                    if (best_t <= 1.0f) {
-                        /* Rewind to just before the wall */
-                        float safe_t  = fmaxf(best_t - 0.01f, 0.0f);
-                        float new_lx  = ax_ccd + disp_x * safe_t;
-                        float new_ly  = ay_ccd + disp_y * safe_t;
-
-                        /* Reflect penetrating velocity component */
-                        float vn_ccd  = vx_dl * best_nx + vy_dl * best_ny;
-                        if (vn_ccd < 0.0f) {
-                            vx_dl   -= (1.0f + RESTITUTION) * vn_ccd * best_nx;
-                            vy_dl   -= (1.0f + RESTITUTION) * vn_ccd * best_ny;
-                            cur_vx   = vx_dl;
-                            cur_vy   = vy_dl;
-
-                            /* Write corrected velocity back to sim ship (rotate
-                             * dock-local → world, then px/s → server units/s) */
-                            float vx_w2 = vx_dl * dc - vy_dl * ds;
-                            float vy_w2 = vx_dl * ds + vy_dl * dc;
-                            ship->velocity.x = Q16_FROM_FLOAT(CLIENT_TO_SERVER(vx_w2));
-                            ship->velocity.y = Q16_FROM_FLOAT(CLIENT_TO_SERVER(vy_w2));
-                        }
+            float best_t = 2.0f;  /* >1 means no hit */
+            float best_nx = 0.0f, best_ny = 0.0f;
+            int best_vi = -1;  /* which vertex hit */
 
-                        /* Write corrected position back to sim ship */
-                        float new_wx2, new_wy2;
-                        dock_local_to_world(sy, new_lx, new_ly, &new_wx2, &new_wy2);
-                        ship->position.x = Q16_FROM_FLOAT(CLIENT_TO_SERVER(new_wx2));
-                        ship->position.y = Q16_FROM_FLOAT(CLIENT_TO_SERVER(new_wy2));
-
-                        /* Rebuild hull vertices in dock-local space so the SAT
-                         * solver below sees the corrected position. */
-                        float offset_x = new_lx - lx, offset_y = new_ly - ly;
-                        lx = new_lx;
-                        ly = new_ly;
-                        for (int vi = 0; vi < N; vi++) {
-                            hdx[vi] += offset_x;
-                            hdy[vi] += offset_y;
+            for (int vi = 0; vi < N; vi++) {
+                if (vR[vi] < 0.5f) continue;  /* vertex at center, can't reach wall */
+
+                for (int si = 0; si < N_SEGS; si++) {
+                    float wnx = segs[si].nx, wny = segs[si].ny;
+
+                    if (fabsf(wnx) > 0.5f) {
+                        /* Vertical wall: x = segs[si].x0 */
+                        float wx = segs[si].x0;
+                        float y_lo = fminf(segs[si].y0, segs[si].y1);
+                        float y_hi = fmaxf(segs[si].y0, segs[si].y1);
+
+                        /* cos(vAlpha + dtheta·t) = (wx - lx) / R */
+                        float cosval = (wx - lx) / vR[vi];
+                        if (cosval < -1.0f || cosval > 1.0f) continue;
+
+                        float target_angle = acosf(cosval);
+                        /* Two solution branches: +(target) and -(target) */
+                        float solutions[2] = { target_angle, -target_angle };
+
+                        for (int sb = 0; sb < 2; sb++) {
+                            /* Solve: vAlpha[vi] + dtheta·t ≡ solutions[sb] (mod 2π)
+                             * t = (solutions[sb] - vAlpha[vi] + 2πk) / dtheta */
+                            float base_angle = solutions[sb] - vAlpha[vi];
+
+                            /* Try multiple wraps to find t ∈ (0, 1] */
+                            for (int k = -2; k <= 2; k++) {
+                                float angle = base_angle + (float)k * 2.0f * (float)M_PI;
+                                float t = angle / dtheta;
+                                if (t <= 1e-4f || t > 1.0f) continue;
+                                if (t >= best_t) continue;
+
+                                /* Check y is within segment bounds */
+                                float vy_at_t = ly + vR[vi] * sinf(vAlpha[vi] + dtheta * t);
+                                if (vy_at_t < y_lo || vy_at_t > y_hi) continue;
+
+                                best_t = t;
+                                best_nx = wnx;
+                                best_ny = wny;
+                                best_vi = vi;
+                            }
+                        }
+                    } else {
+                        /* Horizontal wall: y = segs[si].y0 */
+                        float wy = segs[si].y0;
+                        float x_lo = fminf(segs[si].x0, segs[si].x1);
+                        float x_hi = fmaxf(segs[si].x0, segs[si].x1);
+
+                        /* sin(vAlpha + dtheta·t) = (wy - ly) / R */
+                        float sinval = (wy - ly) / vR[vi];
+                        if (sinval < -1.0f || sinval > 1.0f) continue;
+
+                        float target_angle = asinf(sinval);
+                        /* Two solution branches: target and π - target */
+                        float solutions[2] = { target_angle, (float)M_PI - target_angle };
+
+                        for (int sb = 0; sb < 2; sb++) {
+                            float base_angle = solutions[sb] - vAlpha[vi];
+
+                            for (int k = -2; k <= 2; k++) {
+                                float angle = base_angle + (float)k * 2.0f * (float)M_PI;
+                                float t = angle / dtheta;
+                                if (t <= 1e-4f || t > 1.0f) continue;
+                                if (t >= best_t) continue;
+
+                                /* Check x is within segment bounds */
+                                float vx_at_t = lx + vR[vi] * cosf(vAlpha[vi] + dtheta * t);
+                                if (vx_at_t < x_lo || vx_at_t > x_hi) continue;
+
+                                best_t = t;
+                                best_nx = wnx;
+                                best_ny = wny;
+                                best_vi = vi;
+                            }
                         }
                     }
                 }
-            } /* end translational CCD pre-pass */
-
-            /* Warm start from contact cache: seed P_n/P_f with 80% of last
-             * tick's accumulated impulse so the solver starts near the
-             * converged answer instead of building up from zero.
-             * Dock entity ID is encoded as 0xFF00 | dock_index so it never
-             * collides with real entity IDs (which start from 1). */
-            entity_id dock_pseudo_id = (entity_id)(0xFF00u | (uint16_t)yslots[yi]);
-            struct ContactEntry* dock_ce = contact_cache_find(
-                &global_sim->contact_cache, ship->id, dock_pseudo_id);
-            if (dock_ce && dock_ce->n_contacts == 3) {
-                for (int wi = 0; wi < 3; wi++) {
-                    P_n[wi] = dock_ce->P_n[wi] * 0.8f;
-                    P_f[wi] = dock_ce->P_f[wi] * 0.8f;
-                }
-                /* Apply warm-start impulse to working velocity */
-                for (int wi = 0; wi < 3; wi++) {
-                    if (P_n[wi] <= 0.0f) continue;
-                    float pen, wnx, wny, wcx, wcy;
-                    if (!dock_wall_sat(hdx, hdy, N,
-                                       WALLS[wi].cx, WALLS[wi].cy,
-                                       WALLS[wi].hx, WALLS[wi].hy,
-                                       lx, ly,
-                                       &pen, &wnx, &wny, &wcx, &wcy)) {
-                        P_n[wi] = 0; P_f[wi] = 0; continue;
-                    }
-                    float wrx = wcx - lx, wry = wcy - ly;
-                    cur_vx += P_n[wi] * wnx * inv_mass;
-                    cur_vy += P_n[wi] * wny * inv_mass;
-                    cur_w  += (wrx * (P_n[wi] * wny) - wry * (P_n[wi] * wnx)) * inv_inertia;
-                    /* Friction warm-start */
-                    float vt_x2 = -wny, vt_y2 = wnx; /* tangent direction */
-                    cur_vx += P_f[wi] * vt_x2 * inv_mass;
-                    cur_vy += P_f[wi] * vt_y2 * inv_mass;
-                    cur_w  += (wrx * (P_f[wi] * vt_y2) - wry * (P_f[wi] * vt_x2)) * inv_inertia;
-                }
             }
 
-            /* dt in seconds (for Baumgarte bias = β/dt * max(pen-slop, 0)) */
-            float dt_s = 1.0f / (float)TICK_RATE_HZ;
-
-            for (int iter = 0; iter < N_ITER; iter++) {
-                for (int wi = 0; wi < 3; wi++) {
-                    float pen, nx, ny, cx, cy;
-                    if (!dock_wall_sat(hdx, hdy, N,
-                                       WALLS[wi].cx, WALLS[wi].cy,
-                                       WALLS[wi].hx, WALLS[wi].hy,
-                                       lx, ly,
-                                       &pen, &nx, &ny, &cx, &cy)) continue;
-
-                    /* Positional correction: apply fraction of remaining penetration
-                     * each iteration (Baumgarte-style spreading).  Subsequent
-                     * iterations re-detect the reduced penetration automatically. */
-                    float corr = BAUMGARTE * fmaxf(pen - SLOP, 0.0f);
-                    if (corr > 0.0f) {
-                        lx += nx * corr; ly += ny * corr;
-                        for (int vi = 0; vi < N; vi++) { hdx[vi] += nx * corr; hdy[vi] += ny * corr; }
-                        total_push_x += nx * corr; total_push_y += ny * corr;
-                    }
+            if (best_t <= 1.0f && best_vi >= 0) {
+                /* Rewind angular velocity to just before impact */
+                float safe_t = fmaxf(best_t - 0.02f, 0.0f);
+                float safe_dtheta = dtheta * safe_t;
+                cur_w = safe_dtheta / dt_tick;
 
-                    /* Lever arm from ship origin to contact point */
-                    float rx = cx - lx, ry = cy - ly;
+                /* ── Proper rigid-body impulse at the CCD contact ──
+                 *
+                 * Compute the contact point (vertex position at TOI),
+                 * lever arm, and contact velocity.  Then apply the same
+                 * normal + friction impulse formulas used in the SAT
+                 * solver, so rotation is damped physically. */
 
-                    /* Velocity at contact: v_cm + ω×r */
-                    float vc_x = cur_vx + cur_w * (-ry);
-                    float vc_y = cur_vy + cur_w * ( rx);
-                    float vc_n = vc_x * nx + vc_y * ny;
+                /* Contact point: vertex position at safe_t */
+                float cp_x = lx + vR[best_vi] * cosf(vAlpha[best_vi] + dtheta * safe_t);
+                float cp_y = ly + vR[best_vi] * sinf(vAlpha[best_vi] + dtheta * safe_t);
 
-                    /* ── Normal impulse with Baumgarte velocity bias ── */
-                    float rxn   = rx * ny - ry * nx;
-                    float denom = inv_mass + rxn * rxn * inv_inertia;
-                    if (denom < 1e-10f) continue;
+                /* Lever arm from ship center to contact */
+                float rx = cp_x - lx, ry = cp_y - ly;
 
-                    /* bias = β/dt * max(pen - slop, 0): drains residual positional
-                     * error that Baumgarte pos-correction didn't fully remove. */
-                    float bias = (BAUMGARTE / dt_s) * fmaxf(pen - SLOP, 0.0f);
+                /* Contact velocity: v_cm + ω × r */
+                float vc_x = cur_vx + cur_w * (-ry);
+                float vc_y = cur_vy + cur_w * ( rx);
+                float vc_n = vc_x * best_nx + vc_y * best_ny;
 
-                    /* Impulse increment (clamped: normal impulse can only push, never pull) */
-                    float dP = (-(1.0f + RESTITUTION) * vc_n + bias) / denom;
-                    float P_n_new = fmaxf(P_n[wi] + dP, 0.0f);
-                    float J = P_n_new - P_n[wi];
-                    P_n[wi] = P_n_new;
+                /* ── Normal impulse ── */
+                float rxn = rx * best_ny - ry * best_nx;
+                float denom_n = inv_mass + rxn * rxn * inv_inertia;
+                if (denom_n > 1e-10f && vc_n < 0.0f) {
+                    float Jn = -(1.0f + RESTITUTION) * vc_n / denom_n;
+                    if (Jn < 0.0f) Jn = 0.0f;  /* only push, never pull */
 
-                    cur_vx += J * nx * inv_mass;
-                    cur_vy += J * ny * inv_mass;
-                    cur_w  += (rx * (J * ny) - ry * (J * nx)) * inv_inertia;
+                    cur_vx += Jn * best_nx * inv_mass;
+                    cur_vy += Jn * best_ny * inv_mass;
+                    cur_w  += rxn * Jn * inv_inertia;
 
-                    /* ── Friction impulse (Coulomb, clamped against accumulated P_n) ── */
-                    /* Re-sample velocity after normal impulse for correct tangential v */
+                    /* ── Friction impulse (Coulomb) ── */
+                    /* Re-sample velocity after normal impulse */
                     float vc_x2 = cur_vx + cur_w * (-ry);
                     float vc_y2 = cur_vy + cur_w * ( rx);
-                    float vc_n2 = vc_x2 * nx + vc_y2 * ny;
-                    float vt_x  = vc_x2 - vc_n2 * nx;
-                    float vt_y  = vc_y2 - vc_n2 * ny;
+                    float vc_n2 = vc_x2 * best_nx + vc_y2 * best_ny;
+                    float vt_x = vc_x2 - vc_n2 * best_nx;
+                    float vt_y = vc_y2 - vc_n2 * best_ny;
                     float vt_len = sqrtf(vt_x * vt_x + vt_y * vt_y);
                     if (vt_len > 0.001f) {
                         float tx = vt_x / vt_len, ty = vt_y / vt_len;
-                        float rxt   = rx * ty - ry * tx;
+                        float rxt = rx * ty - ry * tx;
                         float denom_t = inv_mass + rxt * rxt * inv_inertia;
                         if (denom_t > 1e-10f) {
-                            float dPf    = -vt_len / denom_t;
-                            float Pf_max = WALL_FRICTION * P_n[wi]; /* clamp against TOTAL accumulated normal */
-                            float Pf_new = P_f[wi] + dPf;
-                            if (Pf_new >  Pf_max) Pf_new =  Pf_max;
-                            if (Pf_new < -Pf_max) Pf_new = -Pf_max;
-                            float Jf = Pf_new - P_f[wi];
-                            P_f[wi] = Pf_new;
+                            float Jf = -vt_len / denom_t;
+                            float Jf_max = WALL_FRICTION * Jn;
+                            if (Jf < -Jf_max) Jf = -Jf_max;
+                            if (Jf >  Jf_max) Jf =  Jf_max;
                             cur_vx += Jf * tx * inv_mass;
                             cur_vy += Jf * ty * inv_mass;
-                            cur_w  += (rx * (Jf * ty) - ry * (Jf * tx)) * inv_inertia;
+                            cur_w  += rxt * Jf * inv_inertia;
                         }
                     }
                 }
-            } /* end N_ITER */
-
-            /* ── Equal-and-opposite reaction pass ─────────────────────────
-             *
-             * Simple idea: for each active wall contact, measure the
-             * residual approach velocity (linear + angular).  If the
-             * contact point is still moving into the wall, apply the
-             * exact impulse to zero it out.  The wall provides whatever
-             * reaction is needed — no prediction, no clamps. */
-            for (int wi = 0; wi < 3; wi++) {
-                if (P_n[wi] <= 0.0f) continue;
 
-                float pen, nx, ny, cx, cy;
-                if (!dock_wall_sat(hdx, hdy, N,
-                                   WALLS[wi].cx, WALLS[wi].cy,
-                                   WALLS[wi].hx, WALLS[wi].hy,
-                                   lx, ly,
-                                   &pen, &nx, &ny, &cx, &cy)) continue;
-
-                float rx = cx - lx, ry = cy - ly;
-                float vc_x = cur_vx + cur_w * (-ry);
-                float vc_y = cur_vy + cur_w * ( rx);
-                float vc_n = vc_x * nx + vc_y * ny;
-
-                if (vc_n < 0.0f) {
-                    float rxn   = rx * ny - ry * nx;
-                    float denom = inv_mass + rxn * rxn * inv_inertia;
-                    if (denom < 1e-10f) continue;
-                    float J = -vc_n / denom;
-                    cur_vx += J * nx * inv_mass;
-                    cur_vy += J * ny * inv_mass;
-                    cur_w  += rxn * J * inv_inertia;
-                    P_n[wi] += J;
+                /* Push the ship center slightly away from the wall
+                 * to prevent resting vertex from sitting on the edge. */
+                lx += best_nx * 1.5f;
+                ly += best_ny * 1.5f;
+                for (int vi2 = 0; vi2 < N; vi2++) {
+                    hdx[vi2] += best_nx * 1.5f;
+                    hdy[vi2] += best_ny * 1.5f;
                 }
+                float cw_x, cw_y;
+                dock_local_to_world(sy, lx, ly, &cw_x, &cw_y);
+                ship->position.x = Q16_FROM_FLOAT(CLIENT_TO_SERVER(cw_x));
+                ship->position.y = Q16_FROM_FLOAT(CLIENT_TO_SERVER(cw_y));
+                moved = true;
             }
+        }
+    }
 
-            /* ── Dock angular velocity cap ────────────────────────────────
-             *
-             * The friction impulse in the N_ITER loop only resists rotation
-             * when one or more hull vertices are actively touching a wall.
-             * When the ship is centred in the dock it can freely spin up via
-             * rudder input until a vertex eventually hits a wall.  By then the
-             * angular momentum is so large that even the rotational CCD (below)
-             * has to deliver a harsh bounce impulse.
-             *
-             * Instead, continuously limit cur_w to the angular velocity at
-             * which the fastest-moving hull vertex would reach the nearest
-             * inner wall within one tick:
-             *
-             *   For vertex i at distance R_i from the ship centre:
-             *     dx_i(ω) = R_i * |ω| * dt   (arc length, linear approx)
-             *
-             *   Clearance to each inner wall face:
-             *     left_clear  = hdx[i] - (-ai)  = hdx[i] + ai
-             *     right_clear = ai - hdx[i]
-             *     back_clear  = hdy[i] - (-bi)  = hdy[i] + bi
-             *
-             *   If dx_i(ω) > min_clearance_i → vertex would hit.
-             *   ω_max_i = min_clearance_i / (R_i * dt)
-             *
-             *   ω_max = min over all vertices of ω_max_i, with a floor of
-             *   DOCK_OMEGA_FLOOR so the ship can still make slow progress.  */
-            {
-                static const float DOCK_OMEGA_FLOOR = 0.04f; /* rad/s min */
-                static const float DOCK_ANGULAR_EXTRA_DRAG = 0.80f; /* extra drag multiplier inside dock */
-                float dt_tick = 1.0f / (float)TICK_RATE_HZ;
-                float ai_cap  = DOCK_HW - DOCK_ARM_T;   /* 120 px inner half-width */
-                float bi_cap  = DOCK_HH - DOCK_BACK_T;  /* 395 px inner half-height */
-
-                float omega_max = 1e10f;
-
-                for (int vi = 0; vi < N; vi++) {
-                    float vx_l = hdx[vi], vy_l = hdy[vi];
-
-                    /* Distance from ship centre to this vertex */
-                    float dvx = vx_l - lx, dvy = vy_l - ly;
-                    float R = sqrtf(dvx * dvx + dvy * dvy);
-                    if (R < 0.5f) continue;      /* vertex too close to pivot */
-
-                    /* Clearance to each inner wall face (negative = already through) */
-                    float cl_left  = vx_l - (-ai_cap);   /* to left arm inner  */
-                    float cl_right = ai_cap  - vx_l;     /* to right arm inner */
-                    float cl_back  = vy_l - (-bi_cap);   /* to back wall inner */
-
-                    /* Only constrain if vertex is actually inside the dock channel */
-                    float min_cl = 1e10f;
-                    if (vx_l > -ai_cap)            min_cl = fminf(min_cl, cl_left);
-                    if (vx_l <  ai_cap)            min_cl = fminf(min_cl, cl_right);
-                    if (vy_l > -bi_cap && fabsf(vx_l) < ai_cap)
-                                                   min_cl = fminf(min_cl, cl_back);
-
-                    if (min_cl < 0.0f) min_cl = 0.0f;   /* already penetrating */
-
-                    /* Max ω so arc < clearance in one tick */
-                    float w_lim = min_cl / (R * dt_tick);
-                    if (w_lim < omega_max) omega_max = w_lim;
-                }
+    /* Write back velocity: apply the total velocity delta to the ship.
+     * cur_v* - initial v* = accumulated effect of all iterations. */
+    float dv_x = cur_vx - vx_dl, dv_y = cur_vy - vy_dl, domega = cur_w - omega;
+    if (dv_x * dv_x + dv_y * dv_y > 1e-8f || fabsf(domega) > 1e-8f) {
+        float dvw_x = dv_x * dc - dv_y * ds;
+        float dvw_y = dv_x * ds + dv_y * dc;
+        ship->velocity.x = Q16_FROM_FLOAT(Q16_TO_FLOAT(ship->velocity.x) + CLIENT_TO_SERVER(dvw_x));
+        ship->velocity.y = Q16_FROM_FLOAT(Q16_TO_FLOAT(ship->velocity.y) + CLIENT_TO_SERVER(dvw_y));
+        ship->angular_velocity = Q16_FROM_FLOAT(Q16_TO_FLOAT(ship->angular_velocity) + domega);
+    }
+    return moved;
+}
 
-                /* Apply floor */
-                if (omega_max < DOCK_OMEGA_FLOOR) omega_max = DOCK_OMEGA_FLOOR;
+/* ─── Broad phase and sleeping contacts ──────────────────────────────────────
+ * Shipyards are filed in the dock broad phase, re-filed only when the set of
+ * shipyards changes.  Every tick each ship queries it with the box its
+ * bounding circle swept this tick (the CCD pre-pass looks one tick back), and
+ * only the overlapping (dock, ship) pairs reach dock_resolve_ship(), in the
+ * same dock-then-ship order as a full shipyards × ships scan.
+ *
+ * A pair whose ship ends DOCK_SLEEP_TICKS solves in a row slow and without a
+ * positional correction goes to sleep: it skips the solver until the ship
+ * speeds up, turns, or drifts off the pose it came to rest in (bumped by
+ * another ship, teleported), or until the dock or ship goes away.  Each
+ * pair's warm-start impulses live in its DockRest entry, keyed by dock
+ * handle and ship id, so a woken pair starts from its resting impulses. */
+#define DOCK_SLEEP_TICKS      15        /* Half a second at rest             */
+#define DOCK_SLEEP_SPEED      2.0f      /* Client px/s                       */
+#define DOCK_SLEEP_OMEGA      0.01f     /* rad/s                             */
+#define DOCK_SLEEP_DRIFT      0.5f      /* Client px off the resting pose    */
+#define DOCK_SLEEP_DRIFT_RAD  0.002f
+#define DOCK_SHIP_MAX_DOCKS   8         /* Docks one ship can touch at once  */
+#define DOCK_MAX_PAIRS        (MAX_SHIPS * 4)
+
+typedef struct {
+    uint64_t    key;        /* (dock StructureHandle << 32) | ship id */
+    q16_t       x, y, rot;  /* Ship pose after its last solve         */
+    uint16_t    rest_ticks; /* Consecutive solves that ended at rest  */
+    DockImpulse impulse;    /* Warm start for the pair's next solve   */
+} DockRest;
+
+/* g_rest[g_rest_cur] holds last tick's pairs sorted by key */
+static DockRest g_rest[2][DOCK_MAX_PAIRS];
+static uint32_t g_rest_n[2];
+static int      g_rest_cur;
+
+static uint32_t g_dock_slot[DOCK_BP_MAX_DOCKS];   /* Broad-phase index → slot */
+static uint32_t g_dock_epoch;
+static bool     g_docks_filed;
+
+static struct {
+    metric_id solved;
+    metric_id sleeping;
+} g_metrics;
+static uint32_t g_last_solved, g_last_sleeping;
+
+void dock_physics_init(void) {
+    if (g_metrics.solved) return;   /* Already registered */
+    static const char help[] = "Ship-dock pairs that passed the broad phase, by outcome.";
+    g_metrics.solved   = metrics_counter("pirate_dock_contacts", help, "state=\"solved\"");
+    g_metrics.sleeping = metrics_counter("pirate_dock_contacts", help, "state=\"sleeping\"");
+}
 
-                /* Clamp and also apply extra drag so accumulated angular momentum
-                 * bleeds off quickly while inside the dock */
-                cur_w *= DOCK_ANGULAR_EXTRA_DRAG;
-                if (cur_w >  omega_max) cur_w =  omega_max;
-                if (cur_w < -omega_max) cur_w = -omega_max;
-            }
+static void dock_bp_refresh(void) {
+    uint32_t epoch = structure_type_epoch(STRUCT_SHIPYARD);
+    if (g_docks_filed && epoch == g_dock_epoch) return;
+
+    static DockBox boxes[DOCK_BP_MAX_DOCKS];
+    uint32_t yc;
+    const uint32_t *yslots = structure_slots_of_type(STRUCT_SHIPYARD, &yc);
+    if (yc > DOCK_BP_MAX_DOCKS) yc = DOCK_BP_MAX_DOCKS;
+    for (uint32_t i = 0; i < yc; i++) {
+        const PlacedStructure *sy = &placed_structures[yslots[i]];
+        boxes[i] = dock_bp_obb_box(sy->x, sy->y, DOCK_HW, DOCK_HH, sy->rotation);
+        g_dock_slot[i] = yslots[i];
+    }
+    dock_bp_build(boxes, yc);
+    g_dock_epoch  = epoch;
+    g_docks_filed = true;
+}
 
-            /* Store accumulated impulse into contact cache for next tick */
-            {
-                struct ContactEntry* ce_dock = contact_cache_upsert(
-                    &global_sim->contact_cache, ship->id, dock_pseudo_id);
-                ce_dock->last_tick = global_sim->tick;
-                ce_dock->n_contacts = 3;
-                for (int wi = 0; wi < 3; wi++) {
-                    ce_dock->P_n[wi] = P_n[wi];
-                    ce_dock->P_f[wi] = P_f[wi];
-                }
-            }
+static const DockRest *dock_rest_find(uint64_t key) {
+    const DockRest *r = g_rest[g_rest_cur];
+    uint32_t lo = 0, hi = g_rest_n[g_rest_cur];
+    while (lo < hi) {
+        uint32_t mid = (lo + hi) / 2;
+        if (r[mid].key < key) lo = mid + 1; else hi = mid;
+    }
+    return (lo < g_rest_n[g_rest_cur] && r[lo].key == key) ? &r[lo] : NULL;
+}
 
-            /* Write back position */
-            if (total_push_x * total_push_x + total_push_y * total_push_y > 0.0001f) {
-                float new_wx, new_wy;
-                dock_local_to_world(sy, lx, ly, &new_wx, &new_wy);
-                ship->position.x = Q16_FROM_FLOAT(CLIENT_TO_SERVER(new_wx));
-                ship->position.y = Q16_FROM_FLOAT(CLIENT_TO_SERVER(new_wy));
-            }
+static bool dock_ship_slow(const struct Ship *ship) {
+    float vx = SERVER_TO_CLIENT(Q16_TO_FLOAT(ship->velocity.x));
+    float vy = SERVER_TO_CLIENT(Q16_TO_FLOAT(ship->velocity.y));
+    return vx * vx + vy * vy < DOCK_SLEEP_SPEED * DOCK_SLEEP_SPEED &&
+           fabsf(Q16_TO_FLOAT(ship->angular_velocity)) < DOCK_SLEEP_OMEGA;
+}
 
-            /* ── Rotational CCD ───────────────────────────────────────────
-             *
-             * Each hull vertex traces a circular arc as the ship rotates by
-             * dθ = cur_w · dt over one tick.  We test every arc against every
-             * dock wall segment.  If any intersection is found, we rewind cur_w
-             * to the earliest safe angle and apply a bounce impulse.
-             *
-             * Arc–line-segment intersection:
-             *   Vertex at angle θ in dock-local space:
-             *     Vx(θ) = ox + R·cos(α + θ)
-             *     Vy(θ) = oy + R·sin(α + θ)
-             *   where (ox,oy) = ship center in dock-local, R = distance from
-             *   center to vertex, α = initial angle of vertex from center.
-             *
-             *   Each wall is 4 line segments (edges of the AABB).  For a segment
-             *   from P to Q, the arc crosses that line when the signed distance
-             *   from V(θ) to the line changes sign.  We sample the arc at
-             *   N_ARC_SAMPLES points and detect zero-crossings, then refine
-             *   with bisection.
-             *
-             * Dock walls (3 AABBs → up to 12 segments, but only inner-facing
-             * edges matter):
-             *   Left arm inner:  x = -(DOCK_HW - DOCK_ARM_T) = -120, y ∈ [-445, +445]
-             *   Right arm inner: x = +(DOCK_HW - DOCK_ARM_T) = +120, y ∈ [-445, +445]
-             *   Back wall inner: y = -(DOCK_HH - DOCK_BACK_T) = -395, x ∈ [-120, +120]
-             */
-            {
-                float dt_tick = 1.0f / (float)TICK_RATE_HZ;
-                float dtheta = cur_w * dt_tick;
-
-                /* Skip if angular displacement is negligible */
-                if (fabsf(dtheta) > 1e-5f) {
-                    /* Inner-facing wall segments in dock-local coords.
-                     * Only the edges facing the interior can be hit by rotation. */
-                    const float arm_inner = DOCK_HW - DOCK_ARM_T;  /* 120 */
-                    const float back_inner = -(DOCK_HH - DOCK_BACK_T); /* -395 */
-                    struct { float x0, y0, x1, y1; float nx, ny; } segs[] = {
-                        /* Left arm inner edge (faces +x) */
-                        { -arm_inner, -DOCK_HH, -arm_inner, +DOCK_HH,  1.0f, 0.0f },
-                        /* Right arm inner edge (faces -x) */
-                        {  arm_inner, -DOCK_HH,  arm_inner, +DOCK_HH, -1.0f, 0.0f },
-                        /* Back wall inner edge (faces +y) */
-                        { -arm_inner, back_inner, arm_inner, back_inner, 0.0f, 1.0f },
-                    };
-                    const int N_SEGS = 3;
-
-                    /* Pre-compute per-vertex polar coords relative to ship center
-                     * in dock-local space. */
-                    float vR[64], vAlpha[64];
-                    for (int vi = 0; vi < N; vi++) {
-                        float vdx = hdx[vi] - lx, vdy = hdy[vi] - ly;
-                        vR[vi] = sqrtf(vdx * vdx + vdy * vdy);
-                        vAlpha[vi] = atan2f(vdy, vdx);
-                    }
+static bool dock_ship_asleep(const struct Ship *ship, const DockRest *r) {
+    if (r->rest_ticks < DOCK_SLEEP_TICKS || !dock_ship_slow(ship)) return false;
+    float dx = SERVER_TO_CLIENT(Q16_TO_FLOAT(ship->position.x - r->x));
+    float dy = SERVER_TO_CLIENT(Q16_TO_FLOAT(ship->position.y - r->y));
+    return dx * dx + dy * dy < DOCK_SLEEP_DRIFT * DOCK_SLEEP_DRIFT &&
+           fabsf(Q16_TO_FLOAT(ship->rotation - r->rot)) < DOCK_SLEEP_DRIFT_RAD;
+}
 
-                    /* Current ship rotation in dock-local frame.
-                     * ship_rad is in world; subtract dock rotation to get dock-local. */
-                    float dock_rad = sy->rotation * (float)M_PI / 180.0f;
-                    (void)dock_rad; /* local_rot_base calculation preserved for future use */
-                    float local_rot_base __attribute__((unused)) = ship_rad - dock_rad;
-
-                    /* Find earliest TOI across all vertices × all wall segments.
-                     *
-                     * For each vertex, its dock-local position at fractional time t ∈ [0,1]:
-                     *   θ(t) = local_rot_base + dtheta·t   (but vertex angle is baked into vAlpha)
-                     *   Vx(t) = lx + R·cos(vAlpha + dtheta·t)
-                     *   Vy(t) = ly + R·sin(vAlpha + dtheta·t)
-                     *
-                     * For axis-aligned wall segments, intersection reduces to:
-                     *   Vertical wall (x = wx): cos(vAlpha + dtheta·t) = (wx - lx) / R
-                     *   Horizontal wall (y = wy): sin(vAlpha + dtheta·t) = (wy - ly) / R
-                     * These have closed-form acos/asin solutions. */
-
-                    float best_t = 2.0f;  /* >1 means no hit */
-                    float best_nx = 0.0f, best_ny = 0.0f;
-                    int best_vi = -1;  /* which vertex hit */
-
-                    for (int vi = 0; vi < N; vi++) {
-                        if (vR[vi] < 0.5f) continue;  /* vertex at center, can't reach wall */
-
-                        for (int si = 0; si < N_SEGS; si++) {
-                            float wnx = segs[si].nx, wny = segs[si].ny;
-
-                            if (fabsf(wnx) > 0.5f) {
-                                /* Vertical wall: x = segs[si].x0 */
-                                float wx = segs[si].x0;
-                                float y_lo = fminf(segs[si].y0, segs[si].y1);
-                                float y_hi = fmaxf(segs[si].y0, segs[si].y1);
-
-                                /* cos(vAlpha + dtheta·t) = (wx - lx) / R */
-                                float cosval = (wx - lx) / vR[vi];
-                                if (cosval < -1.0f || cosval > 1.0f) continue;
-
-                                float target_angle = acosf(cosval);
-                                /* Two solution branches: +(target) and -(target) */
-                                float solutions[2] = { target_angle, -target_angle };
-
-                                for (int sb = 0; sb < 2; sb++) {
-                                    /* Solve: vAlpha[vi] + dtheta·t ≡ solutions[sb] (mod 2π)
-                                     * t = (solutions[sb] - vAlpha[vi] + 2πk) / dtheta */
-                                    float base_angle = solutions[sb] - vAlpha[vi];
-
-                                    /* Try multiple wraps to find t ∈ (0, 1] */
-                                    for (int k = -2; k <= 2; k++) {
-                                        float angle = base_angle + (float)k * 2.0f * (float)M_PI;
-                                        float t = angle / dtheta;
-                                        if (t <= 1e-4f || t > 1.0f) continue;
-                                        if (t >= best_t) continue;
-
-                                        /* Check y is within segment bounds */
-                                        float vy_at_t = ly + vR[vi] * sinf(vAlpha[vi] + dtheta * t);
-                                        if (vy_at_t < y_lo || vy_at_t > y_hi) continue;
-
-                                        best_t = t;
-                                        best_nx = wnx;
-                                        best_ny = wny;
-                                        best_vi = vi;
-                                    }
-                                }
-                            } else {
-                                /* Horizontal wall: y = segs[si].y0 */
-                                float wy = segs[si].y0;
-                                float x_lo = fminf(segs[si].x0, segs[si].x1);
-                                float x_hi = fmaxf(segs[si].x0, segs[si].x1);
-
-                                /* sin(vAlpha + dtheta·t) = (wy - ly) / R */
-                                float sinval = (wy - ly) / vR[vi];
-                                if (sinval < -1.0f || sinval > 1.0f) continue;
-
-                                float target_angle = asinf(sinval);
-                                /* Two solution branches: target and π - target */
-                                float solutions[2] = { target_angle, (float)M_PI - target_angle };
-
-                                for (int sb = 0; sb < 2; sb++) {
-                                    float base_angle = solutions[sb] - vAlpha[vi];
-
-                                    for (int k = -2; k <= 2; k++) {
-                                        float angle = base_angle + (float)k * 2.0f * (float)M_PI;
-                                        float t = angle / dtheta;
-                                        if (t <= 1e-4f || t > 1.0f) continue;
-                                        if (t >= best_t) continue;
-
-                                        /* Check x is within segment bounds */
-                                        float vx_at_t = lx + vR[vi] * cosf(vAlpha[vi] + dtheta * t);
-                                        if (vx_at_t < x_lo || vx_at_t > x_hi) continue;
-
-                                        best_t = t;
-                                        best_nx = wnx;
-                                        best_ny = wny;
-                                        best_vi = vi;
-                                    }
-                                }
-                            }
-                        }
-                    }
+static int cmp_u32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
 
-                    if (best_t <= 1.0f && best_vi >= 0) {
-                        /* Rewind angular velocity to just before impact */
-                        float safe_t = fmaxf(best_t - 0.02f, 0.0f);
-                        float safe_dtheta = dtheta * safe_t;
-                        cur_w = safe_dtheta / dt_tick;
-
-                        /* ── Proper rigid-body impulse at the CCD contact ──
-                         *
-                         * Compute the contact point (vertex position at TOI),
-                         * lever arm, and contact velocity.  Then apply the same
-                         * normal + friction impulse formulas used in the SAT
-                         * solver, so rotation is damped physically. */
-
-                        /* Contact point: vertex position at safe_t */
-                        float cp_x = lx + vR[best_vi] * cosf(vAlpha[best_vi] + dtheta * safe_t);
-                        float cp_y = ly + vR[best_vi] * sinf(vAlpha[best_vi] + dtheta * safe_t);
-
-                        /* Lever arm from ship center to contact */
-                        float rx = cp_x - lx, ry = cp_y - ly;
-
-                        /* Contact velocity: v_cm + ω × r */
-                        float vc_x = cur_vx + cur_w * (-ry);
-                        float vc_y = cur_vy + cur_w * ( rx);
-                        float vc_n = vc_x * best_nx + vc_y * best_ny;
-
-                        /* ── Normal impulse ── */
-                        float rxn = rx * best_ny - ry * best_nx;
-                        float denom_n = inv_mass + rxn * rxn * inv_inertia;
-                        if (denom_n > 1e-10f && vc_n < 0.0f) {
-                            float Jn = -(1.0f + RESTITUTION) * vc_n / denom_n;
-                            if (Jn < 0.0f) Jn = 0.0f;  /* only push, never pull */
-
-                            cur_vx += Jn * best_nx * inv_mass;
-                            cur_vy += Jn * best_ny * inv_mass;
-                            cur_w  += rxn * Jn * inv_inertia;
-
-                            /* ── Friction impulse (Coulomb) ── */
-                            /* Re-sample velocity after normal impulse */
-                            float vc_x2 = cur_vx + cur_w * (-ry);
-                            float vc_y2 = cur_vy + cur_w * ( rx);
-                            float vc_n2 = vc_x2 * best_nx + vc_y2 * best_ny;
-                            float vt_x = vc_x2 - vc_n2 * best_nx;
-                            float vt_y = vc_y2 - vc_n2 * best_ny;
-                            float vt_len = sqrtf(vt_x * vt_x + vt_y * vt_y);
-                            if (vt_len > 0.001f) {
-                                float tx = vt_x / vt_len, ty = vt_y / vt_len;
-                                float rxt = rx * ty - ry * tx;
-                                float denom_t = inv_mass + rxt * rxt * inv_inertia;
-                                if (denom_t > 1e-10f) {
-                                    float Jf = -vt_len / denom_t;
-                                    float Jf_max = WALL_FRICTION * Jn;
-                                    if (Jf < -Jf_max) Jf = -Jf_max;
-                                    if (Jf >  Jf_max) Jf =  Jf_max;
-                                    cur_vx += Jf * tx * inv_mass;
-                                    cur_vy += Jf * ty * inv_mass;
-                                    cur_w  += rxt * Jf * inv_inertia;
-                                }
-                            }
-                        }
+static int cmp_rest(const void *a, const void *b) {
+    uint64_t x = ((const DockRest *)a)->key, y = ((const DockRest *)b)->key;
+    return (x > y) - (x < y);
+}
 
-                        /* Push the ship center slightly away from the wall
-                         * to prevent resting vertex from sitting on the edge. */
-                        lx += best_nx * 1.5f;
-                        ly += best_ny * 1.5f;
-                        for (int vi2 = 0; vi2 < N; vi2++) {
-                            hdx[vi2] += best_nx * 1.5f;
-                            hdy[vi2] += best_ny * 1.5f;
-                        }
-                        float cw_x, cw_y;
-                        dock_local_to_world(sy, lx, ly, &cw_x, &cw_y);
-                        ship->position.x = Q16_FROM_FLOAT(CLIENT_TO_SERVER(cw_x));
-                        ship->position.y = Q16_FROM_FLOAT(CLIENT_TO_SERVER(cw_y));
-                    }
-                }
-            }
+void handle_ship_dock_collisions(void) {
+    if (!global_sim) return;
+    dock_bp_refresh();
+
+    int next = g_rest_cur ^ 1;
+    g_rest_n[next] = 0;
+    g_last_solved = g_last_sleeping = 0;
+    if (dock_bp_count() == 0) { g_rest_cur = next; return; }
+
+    /* Candidate pairs as (broad-phase index << 16) | ship index */
+    static uint32_t pairs[MAX_SHIPS * DOCK_SHIP_MAX_DOCKS];
+    uint32_t pair_count = 0;
+    const float dt = 1.0f / (float)TICK_RATE_HZ;
+    for (uint32_t si = 0; si < global_sim->ship_count; si++) {
+        const struct Ship *ship = &global_sim->ships[si];
+        float x0   = SERVER_TO_CLIENT(Q16_TO_FLOAT(ship->position.x));
+        float y0   = SERVER_TO_CLIENT(Q16_TO_FLOAT(ship->position.y));
+        float brad = SERVER_TO_CLIENT(Q16_TO_FLOAT(ship->bounding_radius));
+        float x1   = x0 - SERVER_TO_CLIENT(Q16_TO_FLOAT(ship->velocity.x)) * dt;
+        float y1   = y0 - SERVER_TO_CLIENT(Q16_TO_FLOAT(ship->velocity.y)) * dt;
+        DockBox swept = { fminf(x0, x1) - brad, fminf(y0, y1) - brad,
+                          fmaxf(x0, x1) + brad, fmaxf(y0, y1) + brad };
+        uint16_t hit[DOCK_SHIP_MAX_DOCKS];
+        uint32_t nh = dock_bp_query(&swept, hit, DOCK_SHIP_MAX_DOCKS);
+        for (uint32_t k = 0; k < nh; k++) pairs[pair_count++] = ((uint32_t)hit[k] << 16) | si;
+    }
+    qsort(pairs, pair_count, sizeof(pairs[0]), cmp_u32);
+
+    uint32_t solved = 0, sleeping = 0;
+    for (uint32_t p = 0; p < pair_count; p++) {
+        uint32_t slot = g_dock_slot[pairs[p] >> 16];
+        PlacedStructure *sy = &placed_structures[slot];
+        struct Ship *ship = &global_sim->ships[pairs[p] & 0xFFFFu];
+        if ((uint32_t)ship->id == sy->scaffolded_ship_id) continue;
+
+        uint64_t key = ((uint64_t)structure_handle(sy) << 32) | (uint32_t)ship->id;
+        const DockRest *prev = dock_rest_find(key);
+        DockRest *r = (g_rest_n[next] < DOCK_MAX_PAIRS) ? &g_rest[next][g_rest_n[next]++] : NULL;
+
+        if (prev && dock_ship_asleep(ship, prev)) {
+            if (r) *r = *prev;
+            sleeping++;
+            continue;
+        }
 
-            /* Write back velocity: apply the total velocity delta to the ship.
-             * cur_v* - initial v* = accumulated effect of all iterations. */
-            float dv_x = cur_vx - vx_dl, dv_y = cur_vy - vy_dl, domega = cur_w - omega;
-            if (dv_x * dv_x + dv_y * dv_y > 1e-8f || fabsf(domega) > 1e-8f) {
-                float dvw_x = dv_x * dc - dv_y * ds;
-                float dvw_y = dv_x * ds + dv_y * dc;
-                ship->velocity.x = Q16_FROM_FLOAT(Q16_TO_FLOAT(ship->velocity.x) + CLIENT_TO_SERVER(dvw_x));
-                ship->velocity.y = Q16_FROM_FLOAT(Q16_TO_FLOAT(ship->velocity.y) + CLIENT_TO_SERVER(dvw_y));
-                ship->angular_velocity = Q16_FROM_FLOAT(Q16_TO_FLOAT(ship->angular_velocity) + domega);
-            }
+        DockImpulse impulse;
+        bool moved = dock_resolve_ship(sy, ship, prev ? &prev->impulse : NULL, &impulse);
+        solved++;
+        if (!r) continue;
+        r->key = key;
+        r->impulse = impulse;
+        r->x   = ship->position.x;
+        r->y   = ship->position.y;
+        r->rot = ship->rotation;
+        r->rest_ticks = 0;
+        if (!moved && dock_ship_slow(ship)) {
+            /* A pair that just woke starts counting again */
+            uint16_t prior = (prev && prev->rest_ticks < DOCK_SLEEP_TICKS) ? prev->rest_ticks : 0;
+            r->rest_ticks = prior + 1;
         }
     }
+
+    qsort(g_rest[next], g_rest_n[next], sizeof(DockRest), cmp_rest);
+    g_rest_cur = next;
+    g_last_solved   = solved;
+    g_last_sleeping = sleeping;
+    metrics_inc(g_metrics.solved, solved);
+    metrics_inc(g_metrics.sleeping, sleeping);
+}
+
+void dock_physics_last_counts(uint32_t *solved, uint32_t *sleeping) {
+    *solved   = g_last_solved;
+    *sleeping = g_last_sleeping;
 }
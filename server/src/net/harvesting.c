@@ -6,7 +6,9 @@
 #include "net/websocket_server_internal.h"
 #include "net/npc_agents.h"
 #include "net/claim.h"
+#include "net/structure_index.h"
 #include "util/time.h"
+#include "util/timer_wheel.h"
 
 /* Players must be within one full floor-tile (50px) to harvest a resource. */
 #define HARVEST_RANGE 50.0f
@@ -60,11 +62,14 @@ int find_nearest_resource(const IslandDef *isl, float px, float py,
     /* Effective range scales with node size: larger nodes are easier to reach.
      * size < 1.0 → still uses base_range (no penalty for small nodes).
      * We track best as (d / eff_range)^2 so different-sized nodes are compared fairly. */
+    static IslandResourceNear near;
+    float reach = base_range * (isl->grid_max_size >= 1.0f ? isl->grid_max_size : 1.0f);
+    island_resources_near(&near, isl, px, py, reach, RES_MASK(res_type));
     float best_score = 1.0f;  /* 1.0 = exactly at the boundary; < 1.0 = inside */
     int   best_ri    = -1;
-    for (int ri = 0; ri < isl->resource_count; ri++) {
+    for (uint32_t k = 0; k < near.count; k++) {
+        int ri = near.ri[k];
         const IslandResource *r = &isl->resources[ri];
-        if (r->type_id != res_type) continue;
         if (r->health  <= 0)        continue;
         float dx   = px - (isl->x + r->ox);
         float dy   = py - (isl->y + r->oy);
@@ -153,10 +158,7 @@ void handle_harvest_resource(WebSocketPlayer* player, struct WebSocketClient* cl
         IslandResource *res = &isl->resources[best_ri];
         res->health -= wood_damage;
         if (res->health < 0) res->health = 0;
-        if (res->health == 0) {
-            island_mark_tree_dead(isl, best_ri);
-            res->respawn_at_ms = get_time_ms() + RESPAWN_MS_WOOD;
-        }
+        if (res->health == 0) harvest_schedule_respawn(isl, best_ri, RESPAWN_MS_WOOD);
         char dmsg[160];
         snprintf(dmsg, sizeof(dmsg),
                  "{\"type\":\"resource_damaged\",\"island_id\":%u,\"ri\":%d,\"ox\":%.1f,\"oy\":%.1f,\"hp\":%d,\"maxHp\":%d}",
@@ -250,7 +252,7 @@ void handle_harvest_fiber(WebSocketPlayer* player, struct WebSocketClient* clien
             IslandResource *res = &isl->resources[best_ri];
             res->health -= fiber_damage;
             if (res->health < 0) res->health = 0;
-            if (res->health == 0) res->respawn_at_ms = get_time_ms() + RESPAWN_MS_FIBER;
+            if (res->health == 0) harvest_schedule_respawn(isl, best_ri, RESPAWN_MS_FIBER);
             char dmsg[160];
             snprintf(dmsg, sizeof(dmsg),
                      "{\"type\":\"resource_damaged\",\"island_id\":%u,\"ri\":%d,\"ox\":%.1f,\"oy\":%.1f,\"hp\":%d,\"maxHp\":%d}",
@@ -375,7 +377,7 @@ void handle_harvest_rock(WebSocketPlayer* player, struct WebSocketClient* client
             IslandResource *res = &isl->resources[best_ri];
             res->health -= rock_damage;
             if (res->health < 0) res->health = 0;
-            if (res->health == 0) res->respawn_at_ms = get_time_ms() + RESPAWN_MS_ROCK;
+            if (res->health == 0) harvest_schedule_respawn(isl, best_ri, RESPAWN_MS_ROCK);
             char dmsg[160];
             snprintf(dmsg, sizeof(dmsg),
                      "{\"type\":\"resource_damaged\",\"island_id\":%u,\"ri\":%d,\"ox\":%.1f,\"oy\":%.1f,\"hp\":%d,\"maxHp\":%d}",
@@ -444,6 +446,7 @@ void handle_harvest_stone(WebSocketPlayer* player, struct WebSocketClient* clien
             IslandResource *res = &isl->resources[best_ri];
             res->health -= stone_damage;
             if (res->health < 0) res->health = 0;
+            if (res->health == 0) island_mark_resource_dead(isl, best_ri);
             char dmsg[160];
             snprintf(dmsg, sizeof(dmsg),
                      "{\"type\":\"resource_damaged\",\"island_id\":%u,\"ri\":%d,\"ox\":%.1f,\"oy\":%.1f,\"hp\":%d,\"maxHp\":%d}",
@@ -560,7 +563,7 @@ void handle_harvest_boulder(WebSocketPlayer* player, struct WebSocketClient* cli
             IslandResource *res = &isl->resources[best_ri];
             res->health -= boulder_damage;
             if (res->health < 0) res->health = 0;
-            if (res->health == 0) res->respawn_at_ms = get_time_ms() + RESPAWN_MS_BOULDER;
+            if (res->health == 0) harvest_schedule_respawn(isl, best_ri, RESPAWN_MS_BOULDER);
             char dmsg[160];
             snprintf(dmsg, sizeof(dmsg),
                      "{\"type\":\"resource_damaged\",\"island_id\":%u,\"ri\":%d,\"ox\":%.1f,\"oy\":%.1f,\"hp\":%d,\"maxHp\":%d}",
@@ -593,3 +596,87 @@ send_boulder_ret:;
     if (frame_len > 0 && frame_len < sizeof(frame))
         send(client->fd, frame, frame_len, 0);
 }
+
+/* ── Resource respawn timers ──────────────────────────────────────────────── */
+
+bool island_resource_can_respawn(float rx, float ry) {
+    /* Any structure type within this radius blocks respawn. */
+    const float RESPAWN_SUPPRESS_R = 60.0f;
+    static StructureNear near;
+    structure_index_near(&near, rx, ry, RESPAWN_SUPPRESS_R, 0);
+    for (uint32_t k = 0; k < near.count; k++) {
+        const PlacedStructure *s = &placed_structures[near.slots[k]];
+        float dx = s->x - rx;
+        float dy = s->y - ry;
+        if (dx*dx + dy*dy < RESPAWN_SUPPRESS_R * RESPAWN_SUPPRESS_R)
+            return false;
+    }
+    return true;
+}
+
+static void resource_respawn_fire(uint32_t arg, uint32_t now_ms, uint32_t elapsed_ms);
+
+static TimerKind resource_respawn_kind(void) {
+    static TimerKind kind;
+    if (!kind) kind = timer_wheel_kind("kind=\"resource_respawn\"", resource_respawn_fire);
+    return kind;
+}
+
+/* arg = island preset index << 16 | resource index */
+static void resource_respawn_arm(IslandDef *isl, int ri, uint32_t now_ms, uint32_t delay_ms) {
+    IslandResource *res = &isl->resources[ri];
+    timer_wheel_cancel(res->respawn_timer);
+    uint32_t arg = ((uint32_t)(isl - ISLAND_PRESETS) << 16) | (uint32_t)ri;
+    res->respawn_timer = timer_wheel_schedule(resource_respawn_kind(), arg, now_ms, delay_ms);
+}
+
+void harvest_schedule_respawn(IslandDef *isl, int ri, uint32_t delay_ms) {
+    uint32_t now = get_time_ms();
+    island_mark_resource_dead(isl, ri);
+    isl->resources[ri].respawn_at_ms = now + delay_ms;
+    resource_respawn_arm(isl, ri, now, delay_ms);
+}
+
+void harvest_respawns_wake_all(void) {
+    uint32_t now = get_time_ms();
+    for (int ii = 0; ii < ISLAND_COUNT; ii++) {
+        IslandDef *isl = &ISLAND_PRESETS[ii];
+        for (int ri = 0; ri < isl->resource_count; ri++) {
+            IslandResource *res = &isl->resources[ri];
+            if (res->health > 0 || res->respawn_at_ms == 0) continue;
+            int32_t left = (int32_t)(res->respawn_at_ms - now);
+            resource_respawn_arm(isl, ri, now, left > 0 ? (uint32_t)left : 0u);
+        }
+    }
+}
+
+/* Restore the node once its timer is up and no structure is built over it */
+static void resource_respawn_fire(uint32_t arg, uint32_t now_ms, uint32_t elapsed_ms) {
+    (void)elapsed_ms;
+    int ii = (int)(arg >> 16), ri = (int)(arg & 0xFFFFu);
+    if (ii >= ISLAND_COUNT) return;
+    IslandDef *isl = &ISLAND_PRESETS[ii];
+    if (ri >= isl->resource_count) return;
+    IslandResource *res = &isl->resources[ri];
+    /* A newer timer owns this node (re-armed after a world reload) */
+    if (timer_wheel_pending(res->respawn_timer)) return;
+    res->respawn_timer = 0;
+    if (res->health > 0 || res->respawn_at_ms == 0) return;
+
+    float wx = isl->x + res->ox;
+    float wy = isl->y + res->oy;
+    if (!island_resource_can_respawn(wx, wy)) {
+        resource_respawn_arm(isl, ri, now_ms, RESOURCE_RESPAWN_RETRY_MS);
+        return;
+    }
+    res->health = res->max_health;
+    res->respawn_at_ms = 0;
+    island_mark_resource_alive(isl, ri);
+    /* Broadcast to all clients */
+    char rmsg[160];
+    snprintf(rmsg, sizeof(rmsg),
+             "{\"type\":\"resource_respawned\",\"island_id\":%d,\"ri\":%d,"
+             "\"ox\":%.1f,\"oy\":%.1f,\"hp\":%d,\"maxHp\":%d}",
+             isl->id, ri, res->ox, res->oy, res->health, res->max_health);
+    websocket_server_broadcast(rmsg);
+}
@@ -0,0 +1,144 @@
+#include <math.h>
+#include <string.h>
+#include "net/hazard_grid.h"
+#include "util/log.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/* Open-addressed cell table.  A slot is live only while its generation
+ * matches g_gen, so clearing is a counter bump rather than a memset. */
+static int32_t      g_cx[HAZARD_GRID_SLOTS], g_cy[HAZARD_GRID_SLOTS];
+static uint32_t     g_mask[HAZARD_GRID_SLOTS];
+static uint32_t     g_slot_gen[HAZARD_GRID_SLOTS];
+static uint32_t     g_gen = 1;
+static uint32_t     g_used;
+static bool         g_saturated;          /* Table full: every sample is "all" */
+static HazardSource g_src[HAZARD_MAX_SOURCES];
+static uint32_t     g_src_count;
+
+#define MAX_LOAD  (HAZARD_GRID_SLOTS * 3 / 4)
+
+static inline int32_t cell_of(float v) {
+    return (int32_t)floorf(v / HAZARD_GRID_CELL_PX);
+}
+
+static inline uint32_t slot_of(int32_t cx, int32_t cy) {
+    return ((uint32_t)cx * 73856093u ^ (uint32_t)cy * 19349663u) & (HAZARD_GRID_SLOTS - 1);
+}
+
+static inline uint32_t all_sources(void) {
+    return g_src_count >= 32 ? 0xFFFFFFFFu : (1u << g_src_count) - 1u;
+}
+
+void hazard_grid_clear(void) {
+    if (++g_gen == 0) {
+        memset(g_slot_gen, 0, sizeof(g_slot_gen));
+        g_gen = 1;
+    }
+    g_used = 0;
+    g_saturated = false;
+    g_src_count = 0;
+}
+
+static void stamp(int32_t cx, int32_t cy, uint32_t bit) {
+    for (uint32_t s = slot_of(cx, cy);; s = (s + 1) & (HAZARD_GRID_SLOTS - 1)) {
+        if (g_slot_gen[s] != g_gen) {
+            if (g_used >= MAX_LOAD) {
+                if (!g_saturated)
+                    log_warn("hazard grid: more than %u cells this tick — sampling unpruned", MAX_LOAD);
+                g_saturated = true;
+                return;
+            }
+            g_slot_gen[s] = g_gen;
+            g_cx[s] = cx;
+            g_cy[s] = cy;
+            g_mask[s] = bit;
+            g_used++;
+            return;
+        }
+        if (g_cx[s] == cx && g_cy[s] == cy) {
+            g_mask[s] |= bit;
+            return;
+        }
+    }
+}
+
+static uint32_t lookup(int32_t cx, int32_t cy) {
+    for (uint32_t s = slot_of(cx, cy);; s = (s + 1) & (HAZARD_GRID_SLOTS - 1)) {
+        if (g_slot_gen[s] != g_gen) return 0;
+        if (g_cx[s] == cx && g_cy[s] == cy) return g_mask[s];
+    }
+}
+
+/* Could any point of the cell's circumscribed circle (centre c, radius rc)
+ * lie in the cone?  Conservative: widens the cone by the angle the circle
+ * subtends. */
+static bool cell_touches_cone(const HazardSource *h, float cx, float cy, float rc) {
+    float dx = cx - h->ox, dy = cy - h->oy;
+    float d = sqrtf(dx * dx + dy * dy);
+    if (d > h->reach + rc) return false;
+    if (d <= rc) return true;
+    float widen = asinf(rc / d);
+    if (h->half_angle + widen >= (float)M_PI) return true;
+    float c = (dx * h->dir_x + dy * h->dir_y) / d;
+    if (c > 1.0f) c = 1.0f; else if (c < -1.0f) c = -1.0f;
+    return acosf(c) <= h->half_angle + widen;
+}
+
+int hazard_grid_add_cone(HazardKind kind, uint32_t owner, float ox, float oy,
+                         float angle, float half_angle, float reach) {
+    if (g_src_count >= HAZARD_MAX_SOURCES) return -1;
+    int idx = (int)g_src_count++;
+    HazardSource *h = &g_src[idx];
+    h->kind = kind;
+    h->owner = owner;
+    h->ox = ox;
+    h->oy = oy;
+    h->dir_x = cosf(angle);
+    h->dir_y = sinf(angle);
+    h->half_angle = half_angle;
+    h->reach = reach;
+
+    /* Box: apex, both rim ends, and any axis extreme the arc sweeps past */
+    float x0 = ox, y0 = oy, x1 = ox, y1 = oy;
+    for (int e = -1; e <= 1; e += 2) {
+        float a = angle + (float)e * half_angle;
+        float px = ox + reach * cosf(a), py = oy + reach * sinf(a);
+        x0 = fminf(x0, px); x1 = fmaxf(x1, px);
+        y0 = fminf(y0, py); y1 = fmaxf(y1, py);
+    }
+    for (int q = 0; q < 4; q++) {
+        float a = (float)q * (float)(M_PI / 2.0);
+        float diff = remainderf(a - angle, 2.0f * (float)M_PI);
+        if (fabsf(diff) > half_angle) continue;
+        float px = ox + reach * cosf(a), py = oy + reach * sinf(a);
+        x0 = fminf(x0, px); x1 = fmaxf(x1, px);
+        y0 = fminf(y0, py); y1 = fmaxf(y1, py);
+    }
+
+    const float rc = HAZARD_GRID_CELL_PX * 0.70711f + 0.5f;
+    uint32_t bit = 1u << idx;
+    for (int32_t cy = cell_of(y0); cy <= cell_of(y1); cy++)
+        for (int32_t cx = cell_of(x0); cx <= cell_of(x1); cx++) {
+            float ccx = ((float)cx + 0.5f) * HAZARD_GRID_CELL_PX;
+            float ccy = ((float)cy + 0.5f) * HAZARD_GRID_CELL_PX;
+            if (cell_touches_cone(h, ccx, ccy, rc)) stamp(cx, cy, bit);
+        }
+    return idx;
+}
+
+uint32_t hazard_grid_source_count(void) {
+    return g_src_count;
+}
+
+const HazardSource *hazard_grid_source(uint32_t i) {
+    return i < g_src_count ? &g_src[i] : NULL;
+}
+
+uint32_t hazard_grid_sample(float x, float y) {
+    if (g_src_count == 0) return 0;
+    if (g_saturated) return all_sources();
+    return lookup(cell_of(x), cell_of(y));
+}
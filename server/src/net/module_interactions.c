@@ -84,13 +84,20 @@ bool plank_occludes_ray(const SimpleShip* ship,
 }
 
 /**
- * Find module by ID on a ship
+ * Find module by ID on a ship.  Checks the slot cached in
+ * ship->module_slot_by_mid first; modules[] is reordered by removals, so a
+ * stale slot falls through to the scan, which refreshes the cache.
  */
 ShipModule* find_module_by_id(SimpleShip* ship, uint32_t module_id) {
     if (!ship) return NULL;
-    
+
+    uint8_t cached = ship->module_slot_by_mid[MID_OFFSET(module_id)];
+    if (cached < ship->module_count && ship->modules[cached].id == module_id)
+        return &ship->modules[cached];
+
     for (int i = 0; i < ship->module_count; i++) {
         if (ship->modules[i].id == module_id) {
+            ship->module_slot_by_mid[MID_OFFSET(module_id)] = (uint8_t)i;
             return &ship->modules[i];
         }
     }
@@ -8,6 +8,8 @@
 #include "net/npc_agents.h"
 #include "net/npc_world.h"
 #include "net/module_interactions.h"
+#include "net/npc_sched.h"
+#include "net/crew_jobs.h"
 
 /* ── NPC global levelling constants ───────────────────────────────────────── */
 /* Max global level: 1 base + 65 upgrades */
@@ -81,11 +83,14 @@ void npc_aim_cannon_at_world(SimpleShip* ship, ShipModule* cannon, float target_
 /**
  * Tick all active NPC agents — gunners aim/fire, helmsmen steer, riggers adjust sails.
  */
-void tick_npc_agents(float dt) {
+void tick_npc_agents(void) {
     for (int i = 0; i < npc_count; i++) {
         NpcAgent* npc = &npc_agents[i];
         if (!npc->active) continue;
 
+        float dt;
+        if (!npc_sched_agent_take(i, &dt)) continue;   /* Off-tick at its LOD */
+
         SimpleShip* ship = find_ship(npc->ship_id);
         if (!ship) continue;
 
@@ -103,19 +108,8 @@ void tick_npc_agents(float dt) {
                 if (is_allied(ship->company_id, target->company_id)) break;
 
                 // Only aim/fire while the WorldNpc gunner is stationary at this weapon.
-                // Find the corresponding WorldNpc for this module and check its state.
-                bool npc_at_gun = false;
-                for (int wn = 0; wn < world_npc_count; wn++) {
-                    WorldNpc* wnpc = &world_npcs[wn];
-                    if (wnpc->active && wnpc->role == NPC_ROLE_GUNNER &&
-                        wnpc->ship_id == ship->ship_id &&
-                        wnpc->assigned_weapon_id == module->id &&
-                        wnpc->state == WORLD_NPC_STATE_AT_GUN) {
-                        npc_at_gun = true;
-                        break;
-                    }
-                }
-                if (!npc_at_gun) break;
+                // The ship's gunner index maps the module straight to that WorldNpc.
+                if (!npc_gunner_at(ship, module->id)) break;
 
                 /* ── Swivel path ──────────────────────────────────────────── */
                 if (module->type_id == MODULE_TYPE_SWIVEL) {
@@ -328,6 +322,7 @@ void dispatch_gunner_to_weapon(WorldNpc* npc, SimpleShip* ship,
     float barrel_angle = Q16_TO_FLOAT(cannon->local_rot) - (float)(M_PI / 2.0f);
     /* Swivels are smaller — NPC stands slightly closer to the pivot */
     const float CANNON_MOUNT_DIST = (cannon->type_id == MODULE_TYPE_SWIVEL) ? 18.0f : 25.0f;
+    if (npc->role == NPC_ROLE_GUNNER) npc_gunner_index_clear(npc, ship);
     npc->assigned_weapon_id = cannon_id;
     /* Cannons are always on a specific deck (0=lower, 1=upper), never deck-independent.
      * Use deck_id directly if it's 0 or 1; legacy saves that stored 0xFF default to top deck. */
@@ -352,17 +347,21 @@ void dispatch_gunner_to_weapon(WorldNpc* npc, SimpleShip* ship,
 }
 
 /**
- * tick_cannon_needed_expiry — run once per server tick.
+ * tick_cannon_needed_expiry — run once per server tick.  Only weapons on a
+ * ship's crew job board can carry NEEDED, so only those are checked.
  */
 void tick_cannon_needed_expiry(void) {
     uint32_t now = get_time_ms();
     for (int s = 0; s < ship_count; s++) {
         SimpleShip* ship = &ships[s];
         if (!ship->active) continue;
-        for (int m = 0; m < ship->module_count; m++) {
+        int needed_count;
+        const module_id_t* needed = crew_jobs_needed_weapons(ship, &needed_count);
+        for (int k = 0; k < needed_count; k++) {
+            int m = 0;
+            while (m < ship->module_count && ship->modules[m].id != needed[k]) m++;
+            if (m == ship->module_count) continue;
             ShipModule* mod = &ship->modules[m];
-            if (mod->type_id != MODULE_TYPE_CANNON && mod->type_id != MODULE_TYPE_SWIVEL) continue;
-            if (!(mod->state_bits & MODULE_STATE_NEEDED)) continue;
 
             uint32_t last_aim = ship->cannon_last_needed_ms[m];
             if (last_aim == 0) {
@@ -389,26 +388,19 @@ void tick_cannon_needed_expiry(void) {
     }
 }
 
-/**
- * Mark swivel guns as NEEDED when this ship's NPC agents have an active enemy target.
- */
-void tick_swivel_crew_demand(SimpleShip* ship) {
-    (void)ship; /* NEEDED for swivels is now driven by handle_cannon_aim sector-check, same as cannons */
-}
-
 /**
  * Assign free on-duty gunner NPCs to any weapon-group cannon that is currently
- * unmanned and has MODULE_STATE_NEEDED set.
+ * unmanned and has MODULE_STATE_NEEDED set — taken from the ship's crew job
+ * board, so a ship nobody is aiming from costs nothing here.
  */
 void assign_weapon_group_crew(SimpleShip* ship) {
     if (!ship) return;
 
-    for (int m = 0; m < ship->module_count; m++) {
-        ShipModule* mod = &ship->modules[m];
-        if (mod->type_id != MODULE_TYPE_CANNON && mod->type_id != MODULE_TYPE_SWIVEL) continue;
-
-        /* Only dispatch to weapons that are actively NEEDED. */
-        if (!(mod->state_bits & MODULE_STATE_NEEDED)) continue;
+    int needed_count;
+    const module_id_t* needed = crew_jobs_needed_weapons(ship, &needed_count);
+    for (int k = 0; k < needed_count; k++) {
+        ShipModule* mod = find_module_on_ship(ship, needed[k]);
+        if (!mod) continue;
 
         /* Check occupancy: player seated here? */
         bool occupied = false;
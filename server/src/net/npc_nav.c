@@ -0,0 +1,461 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "net/npc_nav.h"
+#include "sim/island.h"
+#include "util/log.h"
+#include "util/metrics.h"
+
+#define NAV_KEY_DECK(type, deck)  (0x01000000u | ((uint32_t)(type) << 8) | (uint32_t)(deck))
+#define NAV_KEY_ISLAND(id)        (0x02000000u | ((uint32_t)(id) & 0xFFFFu))
+
+typedef struct {
+    uint32_t key;            /* 0 = unused                                   */
+    float    ox, oy;         /* World/local position of cell (0,0)'s corner  */
+    float    cell;
+    int      w, h;
+    uint8_t *walk;           /* w*h, 1 = walkable                            */
+} NavGrid;
+
+static NavGrid g_grids[NPC_NAV_MAX_GRIDS];
+static int     g_grid_count;
+
+/* ── Path cache ───────────────────────────────────────────────────────────── */
+
+typedef struct {
+    uint32_t     grid_plus1;  /* 0 = empty                                   */
+    uint32_t     start, goal; /* Cell indices                                */
+    uint32_t     used;        /* g_clock at last hit, for replacement        */
+    NpcNavResult result;
+    NpcNavPath   path;
+} CacheEntry;
+
+#define CACHE_WAYS 4
+
+static CacheEntry g_cache[NPC_NAV_CACHE_SIZE];
+static uint32_t   g_clock;
+
+/* ── A* scratch (one search at a time) ────────────────────────────────────── */
+
+static float    s_g[NPC_NAV_MAX_CELLS];
+static int32_t  s_parent[NPC_NAV_MAX_CELLS];
+static uint32_t s_seen[NPC_NAV_MAX_CELLS];    /* == s_gen: g/parent valid     */
+static uint32_t s_done[NPC_NAV_MAX_CELLS];    /* == s_gen: closed             */
+static uint32_t s_gen;
+
+typedef struct { float f; int32_t idx; } HeapNode;
+#define HEAP_CAP (NPC_NAV_MAX_CELLS * 2)   /* Lazy deletion: cells can be pushed more than once */
+static HeapNode s_heap[HEAP_CAP];
+static int      s_heap_n;
+
+static int32_t  s_trail[NPC_NAV_MAX_CELLS];   /* Reconstructed cell path      */
+
+static int32_t     g_budget = NPC_NAV_TICK_BUDGET;
+static NpcNavStats g_stats;
+
+static struct {
+    metric_id result[5];      /* direct, cached, searched, busy, no_path */
+    metric_id expansions;
+} g_metrics;
+
+void npc_nav_init(void) {
+    if (g_metrics.expansions) return;   /* Already registered */
+    static const char help_q[] = "NPC path queries by how they were answered.";
+    g_metrics.result[0] = metrics_counter("pirate_npc_nav_queries", help_q, "result=\"direct\"");
+    g_metrics.result[1] = metrics_counter("pirate_npc_nav_queries", help_q, "result=\"cached\"");
+    g_metrics.result[2] = metrics_counter("pirate_npc_nav_queries", help_q, "result=\"searched\"");
+    g_metrics.result[3] = metrics_counter("pirate_npc_nav_queries", help_q, "result=\"busy\"");
+    g_metrics.result[4] = metrics_counter("pirate_npc_nav_queries", help_q, "result=\"no_path\"");
+    g_metrics.expansions = metrics_counter("pirate_npc_nav_expansions",
+                                           "A* nodes expanded by NPC path searches.", NULL);
+}
+
+void npc_nav_begin_tick(void) {
+    g_budget = NPC_NAV_TICK_BUDGET;
+}
+
+void npc_nav_stats(NpcNavStats *out) {
+    *out = g_stats;
+}
+
+void npc_nav_cache_clear(void) {
+    memset(g_cache, 0, sizeof(g_cache));
+}
+
+/* ── Grid baking ──────────────────────────────────────────────────────────── */
+
+static bool poly_contains(const float (*p)[2], int n, float x, float y) {
+    bool in = false;
+    for (int i = 0, j = n - 1; i < n; j = i++) {
+        if (((p[i][1] > y) != (p[j][1] > y)) &&
+            (x < (p[j][0] - p[i][0]) * (y - p[i][1]) / (p[j][1] - p[i][1] + 1e-12f) + p[i][0]))
+            in = !in;
+    }
+    return in;
+}
+
+static float poly_edge_dist(const float (*p)[2], int n, float x, float y) {
+    float best = 1e30f;
+    for (int i = 0; i < n; i++) {
+        int j = (i + 1) % n;
+        float ex = p[j][0] - p[i][0], ey = p[j][1] - p[i][1];
+        float len2 = ex * ex + ey * ey;
+        float t = len2 > 1e-10f ? ((x - p[i][0]) * ex + (y - p[i][1]) * ey) / len2 : 0.0f;
+        if (t < 0.0f) t = 0.0f;
+        if (t > 1.0f) t = 1.0f;
+        float dx = x - (p[i][0] + t * ex), dy = y - (p[i][1] + t * ey);
+        float d2 = dx * dx + dy * dy;
+        if (d2 < best) best = d2;
+    }
+    return sqrtf(best);
+}
+
+static int grid_find(uint32_t key) {
+    for (int i = 0; i < g_grid_count; i++)
+        if (g_grids[i].key == key) return i;
+    return -1;
+}
+
+/* Claim a grid slot covering [x0,x1]×[y0,y1] at `cell` (coarsened to fit
+ * NPC_NAV_MAX_CELLS).  Cells start unwalkable. */
+static NavGrid *grid_new(uint32_t key, float x0, float y0, float x1, float y1, float cell) {
+    if (g_grid_count >= NPC_NAV_MAX_GRIDS) {
+        log_warn("⚠️ NPC nav: grid table full, key 0x%08x gets no grid", key);
+        return NULL;
+    }
+    int w, h;
+    for (;;) {
+        w = (int)ceilf((x1 - x0) / cell);
+        h = (int)ceilf((y1 - y0) / cell);
+        if (w < 1) w = 1;
+        if (h < 1) h = 1;
+        if ((size_t)w * (size_t)h <= NPC_NAV_MAX_CELLS) break;
+        cell *= 1.25f;
+    }
+    uint8_t *walk = calloc((size_t)w * (size_t)h, 1);
+    if (!walk) return NULL;
+    NavGrid *g = &g_grids[g_grid_count++];
+    g->key  = key;
+    g->ox   = x0;
+    g->oy   = y0;
+    g->cell = cell;
+    g->w    = w;
+    g->h    = h;
+    g->walk = walk;
+    return g;
+}
+
+static inline float cell_cx(const NavGrid *g, int cx) { return g->ox + ((float)cx + 0.5f) * g->cell; }
+static inline float cell_cy(const NavGrid *g, int cy) { return g->oy + ((float)cy + 0.5f) * g->cell; }
+
+int npc_nav_deck_grid(uint8_t ship_type, uint8_t deck, const float (*pts)[2], int n) {
+    uint32_t key = NAV_KEY_DECK(ship_type, deck);
+    int gi = grid_find(key);
+    if (gi >= 0) return gi;
+    if (n < 3) return -1;
+
+    float x0 = pts[0][0], x1 = x0, y0 = pts[0][1], y1 = y0;
+    for (int i = 1; i < n; i++) {
+        if (pts[i][0] < x0) x0 = pts[i][0];
+        if (pts[i][0] > x1) x1 = pts[i][0];
+        if (pts[i][1] < y0) y0 = pts[i][1];
+        if (pts[i][1] > y1) y1 = pts[i][1];
+    }
+    NavGrid *g = grid_new(key, x0, y0, x1, y1, NPC_NAV_DECK_CELL);
+    if (!g) return -1;
+    int walkable = 0;
+    for (int cy = 0; cy < g->h; cy++)
+        for (int cx = 0; cx < g->w; cx++) {
+            float x = cell_cx(g, cx), y = cell_cy(g, cy);
+            if (poly_contains(pts, n, x, y) && poly_edge_dist(pts, n, x, y) >= NPC_NAV_DECK_CLEARANCE) {
+                g->walk[cy * g->w + cx] = 1;
+                walkable++;
+            }
+        }
+    log_info("🧭 NPC nav: deck grid ship_type=%u deck=%u %dx%d (%d walkable)",
+             ship_type, deck, g->w, g->h, walkable);
+    return (int)(g - g_grids);
+}
+
+int npc_nav_island_grid(int preset) {
+    if (preset < 0 || preset >= ISLAND_COUNT) return -1;
+    const IslandDef *isl = &ISLAND_PRESETS[preset];
+    uint32_t key = NAV_KEY_ISLAND(isl->id);
+    int gi = grid_find(key);
+    if (gi >= 0) return gi;
+
+    float r = isl->vertex_count > 0 ? isl->poly_bound_r : isl->beach_radius_px + isl->beach_max_bump;
+    if (r <= 0.0f) return -1;
+    NavGrid *g = grid_new(key, isl->x - r, isl->y - r, isl->x + r, isl->y + r, NPC_NAV_ISLAND_CELL);
+    if (!g) return -1;
+    int walkable = 0;
+    for (int cy = 0; cy < g->h; cy++)
+        for (int cx = 0; cx < g->w; cx++) {
+            if (island_layer_contains(isl, ISLAND_LAYER_LAND, cell_cx(g, cx), cell_cy(g, cy))) {
+                g->walk[cy * g->w + cx] = 1;
+                walkable++;
+            }
+        }
+    log_info("🧭 NPC nav: island %d grid %dx%d @%.0fpx (%d walkable)",
+             isl->id, g->w, g->h, g->cell, walkable);
+    return (int)(g - g_grids);
+}
+
+/* ── Queries ──────────────────────────────────────────────────────────────── */
+
+static inline bool cell_of(const NavGrid *g, float x, float y, int *cx, int *cy) {
+    *cx = (int)floorf((x - g->ox) / g->cell);
+    *cy = (int)floorf((y - g->oy) / g->cell);
+    return *cx >= 0 && *cy >= 0 && *cx < g->w && *cy < g->h;
+}
+
+static inline bool walk_at(const NavGrid *g, int cx, int cy) {
+    return cx >= 0 && cy >= 0 && cx < g->w && cy < g->h && g->walk[cy * g->w + cx];
+}
+
+bool npc_nav_walkable(int grid, float x, float y) {
+    if (grid < 0 || grid >= g_grid_count) return false;
+    const NavGrid *g = &g_grids[grid];
+    int cx, cy;
+    return cell_of(g, x, y, &cx, &cy) && g->walk[cy * g->w + cx];
+}
+
+/* Nearest walkable cell within a few rings of (cx,cy), for endpoints that sit
+ * in the clearance band or just off the grid. */
+static bool snap_walkable(const NavGrid *g, int *cx, int *cy) {
+    if (walk_at(g, *cx, *cy)) return true;
+    for (int r = 1; r <= 3; r++) {
+        int best = -1, bx = 0, by = 0;
+        for (int dy = -r; dy <= r; dy++)
+            for (int dx = -r; dx <= r; dx++) {
+                if (abs(dx) != r && abs(dy) != r) continue;
+                if (!walk_at(g, *cx + dx, *cy + dy)) continue;
+                int d = dx * dx + dy * dy;
+                if (best < 0 || d < best) { best = d; bx = *cx + dx; by = *cy + dy; }
+            }
+        if (best >= 0) { *cx = bx; *cy = by; return true; }
+    }
+    return false;
+}
+
+/* Every cell the segment passes through is walkable, except the two end
+ * cells (endpoints may sit in the clearance band).  Grid traversal after
+ * Amanatides & Woo, so diagonal corner cuts are caught. */
+static bool line_of_sight(const NavGrid *g, float ax, float ay, float bx, float by) {
+    float fx = (ax - g->ox) / g->cell, fy = (ay - g->oy) / g->cell;
+    float tx = (bx - g->ox) / g->cell, ty = (by - g->oy) / g->cell;
+    int cx = (int)floorf(fx), cy = (int)floorf(fy);
+    int ex = (int)floorf(tx), ey = (int)floorf(ty);
+    float dx = tx - fx, dy = ty - fy;
+    int sx = dx > 0 ? 1 : -1, sy = dy > 0 ? 1 : -1;
+    float tdx = dx != 0.0f ? fabsf(1.0f / dx) : INFINITY;
+    float tdy = dy != 0.0f ? fabsf(1.0f / dy) : INFINITY;
+    float tmx = dx != 0.0f ? (dx > 0 ? (float)(cx + 1) - fx : fx - (float)cx) * tdx : INFINITY;
+    float tmy = dy != 0.0f ? (dy > 0 ? (float)(cy + 1) - fy : fy - (float)cy) * tdy : INFINITY;
+    int steps = abs(ex - cx) + abs(ey - cy);
+    for (int i = 0; i < steps; i++) {
+        if (tmx < tmy) { cx += sx; tmx += tdx; }
+        else           { cy += sy; tmy += tdy; }
+        if ((cx != ex || cy != ey) && !walk_at(g, cx, cy)) return false;
+    }
+    return true;
+}
+
+static void heap_push(float f, int32_t idx) {
+    if (s_heap_n == HEAP_CAP) return;   /* Degrades the search, never overruns */
+    int i = s_heap_n++;
+    while (i > 0) {
+        int p = (i - 1) / 2;
+        if (s_heap[p].f <= f) break;
+        s_heap[i] = s_heap[p];
+        i = p;
+    }
+    s_heap[i] = (HeapNode){ f, idx };
+}
+
+static int32_t heap_pop(void) {
+    int32_t top = s_heap[0].idx;
+    HeapNode last = s_heap[--s_heap_n];
+    int i = 0;
+    for (;;) {
+        int c = 2 * i + 1;
+        if (c >= s_heap_n) break;
+        if (c + 1 < s_heap_n && s_heap[c + 1].f < s_heap[c].f) c++;
+        if (last.f <= s_heap[c].f) break;
+        s_heap[i] = s_heap[c];
+        i = c;
+    }
+    s_heap[i] = last;
+    return top;
+}
+
+static inline float octile(int ax, int ay, int bx, int by) {
+    int dx = abs(ax - bx), dy = abs(ay - by);
+    int lo = dx < dy ? dx : dy, hi = dx < dy ? dy : dx;
+    return (float)(hi - lo) + 1.41421356f * (float)lo;
+}
+
+/* A* from cell s to cell t.  Returns the number of cells on the path (into
+ * s_trail, start first), or 0 if t is unreachable.  *expanded gets the work. */
+static int astar(const NavGrid *g, int32_t s, int32_t t, int32_t *expanded) {
+    static const int DX[8] = { 1, -1, 0,  0, 1,  1, -1, -1 };
+    static const int DY[8] = { 0,  0, 1, -1, 1, -1,  1, -1 };
+    static const float COST[8] = { 1, 1, 1, 1, 1.41421356f, 1.41421356f, 1.41421356f, 1.41421356f };
+
+    if (++s_gen == 0) {
+        memset(s_seen, 0, sizeof(s_seen));
+        memset(s_done, 0, sizeof(s_done));
+        s_gen = 1;
+    }
+    int tx = t % g->w, ty = t / g->w;
+    s_heap_n = 0;
+    s_g[s] = 0.0f;
+    s_parent[s] = -1;
+    s_seen[s] = s_gen;
+    heap_push(octile(s % g->w, s / g->w, tx, ty), s);
+    *expanded = 0;
+
+    while (s_heap_n > 0) {
+        int32_t cur = heap_pop();
+        if (s_done[cur] == s_gen) continue;
+        s_done[cur] = s_gen;
+        (*expanded)++;
+        if (cur == t) {
+            int n = 0;
+            for (int32_t c = t; c >= 0; c = s_parent[c]) s_trail[n++] = c;
+            for (int i = 0; i < n / 2; i++) {
+                int32_t tmp = s_trail[i];
+                s_trail[i] = s_trail[n - 1 - i];
+                s_trail[n - 1 - i] = tmp;
+            }
+            return n;
+        }
+        int cx = cur % g->w, cy = cur / g->w;
+        for (int k = 0; k < 8; k++) {
+            int nx = cx + DX[k], ny = cy + DY[k];
+            if (!walk_at(g, nx, ny)) continue;
+            /* No squeezing diagonally between two blocked cells */
+            if (k >= 4 && (!walk_at(g, cx + DX[k], cy) || !walk_at(g, cx, cy + DY[k]))) continue;
+            int32_t ni = ny * g->w + nx;
+            if (s_done[ni] == s_gen) continue;
+            float ng = s_g[cur] + COST[k];
+            if (s_seen[ni] == s_gen && ng >= s_g[ni]) continue;
+            s_seen[ni] = s_gen;
+            s_g[ni] = ng;
+            s_parent[ni] = cur;
+            heap_push(ng + octile(nx, ny, tx, ty), ni);
+        }
+    }
+    return 0;
+}
+
+/* Corners of the cell path, string-pulled between cell centres. */
+static void string_pull(const NavGrid *g, int n, NpcNavPath *out) {
+    out->count = 0;
+    out->partial = false;
+    int goal = n - 1;
+    float ax = cell_cx(g, s_trail[0] % g->w), ay = cell_cy(g, s_trail[0] / g->w);
+    int i = 0;
+    for (;;) {
+        float gx = cell_cx(g, s_trail[goal] % g->w), gy = cell_cy(g, s_trail[goal] / g->w);
+        if (line_of_sight(g, ax, ay, gx, gy)) return;
+        int j = i + 1;
+        while (j + 1 < goal) {
+            int32_t c = s_trail[j + 1];
+            if (!line_of_sight(g, ax, ay, cell_cx(g, c % g->w), cell_cy(g, c / g->w))) break;
+            j++;
+        }
+        if (out->count == NPC_NAV_MAX_CORNERS) {
+            out->partial = true;
+            return;
+        }
+        ax = cell_cx(g, s_trail[j] % g->w);
+        ay = cell_cy(g, s_trail[j] / g->w);
+        out->corner[out->count][0] = ax;
+        out->corner[out->count][1] = ay;
+        out->count++;
+        i = j;
+    }
+}
+
+static CacheEntry *cache_slot(uint32_t grid, uint32_t s, uint32_t t, bool *hit) {
+    uint32_t h = (grid * 0x9E3779B1u) ^ (s * 0x85EBCA77u) ^ (t * 0xC2B2AE3Du);
+    h ^= h >> 15;
+    CacheEntry *victim = NULL;
+    for (int w = 0; w < CACHE_WAYS; w++) {
+        CacheEntry *e = &g_cache[(h + (uint32_t)w) & (NPC_NAV_CACHE_SIZE - 1)];
+        if (e->grid_plus1 == grid + 1 && e->start == s && e->goal == t) {
+            *hit = true;
+            return e;
+        }
+        if (!victim || e->grid_plus1 == 0 || (victim->grid_plus1 != 0 && e->used < victim->used))
+            victim = e;
+    }
+    *hit = false;
+    return victim;
+}
+
+static NpcNavResult count_result(NpcNavResult r, int which) {
+    metrics_inc(g_metrics.result[which], 1);
+    return r;
+}
+
+NpcNavResult npc_nav_path(int grid, float sx, float sy, float gx, float gy, NpcNavPath *out) {
+    out->count = 0;
+    out->partial = false;
+    g_stats.queries++;
+    if (grid < 0 || grid >= g_grid_count) {
+        g_stats.no_path++;
+        return count_result(NPC_NAV_NO_PATH, 4);
+    }
+    const NavGrid *g = &g_grids[grid];
+
+    int scx, scy, tcx, tcy;
+    bool s_in = cell_of(g, sx, sy, &scx, &scy);
+    bool t_in = cell_of(g, gx, gy, &tcx, &tcy);
+    if (!s_in || !t_in || !snap_walkable(g, &scx, &scy) || !snap_walkable(g, &tcx, &tcy)) {
+        g_stats.no_path++;
+        return count_result(NPC_NAV_NO_PATH, 4);
+    }
+    if (line_of_sight(g, sx, sy, gx, gy)) {
+        g_stats.direct++;
+        return count_result(NPC_NAV_OK, 0);
+    }
+
+    uint32_t s = (uint32_t)(scy * g->w + scx), t = (uint32_t)(tcy * g->w + tcx);
+    bool hit;
+    CacheEntry *e = cache_slot((uint32_t)grid, s, t, &hit);
+    if (hit) {
+        e->used = ++g_clock;
+        *out = e->path;
+        g_stats.cache_hits++;
+        if (e->result == NPC_NAV_NO_PATH) g_stats.no_path++;
+        return count_result(e->result, 1);
+    }
+    if (g_budget <= 0) {
+        g_stats.busy++;
+        return count_result(NPC_NAV_BUSY, 3);
+    }
+
+    int32_t expanded;
+    int n = astar(g, (int32_t)s, (int32_t)t, &expanded);
+    g_budget -= expanded;
+    g_stats.searches++;
+    g_stats.expansions += (uint64_t)expanded;
+    metrics_inc(g_metrics.expansions, (uint64_t)expanded);
+
+    NpcNavResult r = NPC_NAV_OK;
+    if (n == 0) {
+        r = NPC_NAV_NO_PATH;
+        g_stats.no_path++;
+    } else {
+        string_pull(g, n, out);
+    }
+    e->grid_plus1 = (uint32_t)grid + 1;
+    e->start  = s;
+    e->goal   = t;
+    e->used   = ++g_clock;
+    e->result = r;
+    e->path   = *out;
+    return count_result(r, r == NPC_NAV_OK ? 2 : 4);
+}
@@ -0,0 +1,221 @@
+#include <string.h>
+#include "net/npc_sched.h"
+#include "net/websocket_server_internal.h"
+#include "util/metrics.h"
+
+/* Per-entity schedule state, indexed like world_npcs[] / npc_agents[]. */
+typedef struct {
+    float    accum;       /* dt accumulated since the last run       */
+    uint32_t last_run;    /* g_tick of the last run                  */
+    uint8_t  lod;
+    bool     run;         /* Picked by this tick's plan              */
+    bool     live;        /* Slot was active at the last plan        */
+} SchedSlot;
+
+#define SCHED_OVERDUE_LEVELS 64
+#define SCHED_BUCKETS        (SCHED_OVERDUE_LEVELS * NPC_LOD_COUNT)
+
+static SchedSlot g_world[MAX_WORLD_NPCS];
+static SchedSlot g_agent[MAX_NPC_AGENTS];
+static bool      g_grappled[MAX_WORLD_NPCS];
+static uint32_t  g_tick;
+
+static NpcSchedTickStats g_world_stats;
+static NpcSchedTickStats g_agent_stats;
+
+/* Connected players' world positions, refreshed by each plan */
+static float g_px[WS_MAX_CLIENTS], g_py[WS_MAX_CLIENTS];
+static int   g_pcount;
+
+static const uint32_t LOD_INTERVAL[NPC_LOD_COUNT] = { 1, NPC_LOD_WARM_TICKS, NPC_LOD_COLD_TICKS };
+
+static struct {
+    metric_id world[3];   /* scheduled, skipped, deferred */
+    metric_id agent[3];
+    metric_id world_lod[NPC_LOD_COUNT];
+    metric_id agent_lod[NPC_LOD_COUNT];
+} g_metrics;
+
+void npc_sched_init(void) {
+    if (g_metrics.world[0]) return;   /* Already registered */
+    static const char help_upd[] = "NPC AI updates by outcome: run, not due at its LOD, or over the per-tick budget.";
+    g_metrics.world[0] = metrics_counter("pirate_npc_ai_updates", help_upd, "kind=\"world\",result=\"scheduled\"");
+    g_metrics.world[1] = metrics_counter("pirate_npc_ai_updates", help_upd, "kind=\"world\",result=\"skipped\"");
+    g_metrics.world[2] = metrics_counter("pirate_npc_ai_updates", help_upd, "kind=\"world\",result=\"deferred\"");
+    g_metrics.agent[0] = metrics_counter("pirate_npc_ai_updates", help_upd, "kind=\"agent\",result=\"scheduled\"");
+    g_metrics.agent[1] = metrics_counter("pirate_npc_ai_updates", help_upd, "kind=\"agent\",result=\"skipped\"");
+    g_metrics.agent[2] = metrics_counter("pirate_npc_ai_updates", help_upd, "kind=\"agent\",result=\"deferred\"");
+    static const char help_lod[] = "Active NPCs by AI level of detail.";
+    g_metrics.world_lod[NPC_LOD_HOT]  = metrics_gauge("pirate_npc_ai_lod", help_lod, "kind=\"world\",lod=\"hot\"");
+    g_metrics.world_lod[NPC_LOD_WARM] = metrics_gauge("pirate_npc_ai_lod", help_lod, "kind=\"world\",lod=\"warm\"");
+    g_metrics.world_lod[NPC_LOD_COLD] = metrics_gauge("pirate_npc_ai_lod", help_lod, "kind=\"world\",lod=\"cold\"");
+    g_metrics.agent_lod[NPC_LOD_HOT]  = metrics_gauge("pirate_npc_ai_lod", help_lod, "kind=\"agent\",lod=\"hot\"");
+    g_metrics.agent_lod[NPC_LOD_WARM] = metrics_gauge("pirate_npc_ai_lod", help_lod, "kind=\"agent\",lod=\"warm\"");
+    g_metrics.agent_lod[NPC_LOD_COLD] = metrics_gauge("pirate_npc_ai_lod", help_lod, "kind=\"agent\",lod=\"cold\"");
+}
+
+/* ── LOD classification ───────────────────────────────────────────────────── */
+
+static float nearest_player_d2(float x, float y) {
+    float best = 1e30f;
+    for (int p = 0; p < g_pcount; p++) {
+        float dx = g_px[p] - x, dy = g_py[p] - y;
+        float d2 = dx * dx + dy * dy;
+        if (d2 < best) best = d2;
+    }
+    return best;
+}
+
+static uint8_t world_npc_lod(const WorldNpc* npc, int i) {
+    float d2 = nearest_player_d2(npc->x, npc->y);
+    if (d2 <= NPC_LOD_HOT_DIST * NPC_LOD_HOT_DIST || g_grappled[i] ||
+        npc->velocity_x != 0.0f || npc->velocity_y != 0.0f)
+        return NPC_LOD_HOT;
+    if (d2 <= NPC_LOD_WARM_DIST * NPC_LOD_WARM_DIST ||
+        npc->state == WORLD_NPC_STATE_MOVING || npc->state == WORLD_NPC_STATE_REPAIRING ||
+        npc->in_water || npc->fire_timer_ms > 0)
+        return NPC_LOD_WARM;
+    return NPC_LOD_COLD;
+}
+
+static uint8_t agent_lod(const NpcAgent* agent) {
+    SimpleShip* ship = find_ship(agent->ship_id);
+    if (!ship) return NPC_LOD_COLD;
+    float d2 = nearest_player_d2(ship->x, ship->y);
+    if (d2 <= NPC_LOD_HOT_DIST * NPC_LOD_HOT_DIST) return NPC_LOD_HOT;
+    if (d2 <= NPC_LOD_WARM_DIST * NPC_LOD_WARM_DIST ||
+        (agent->role == NPC_ROLE_GUNNER && agent->target_ship_id != 0))
+        return NPC_LOD_WARM;
+    return NPC_LOD_COLD;
+}
+
+/* ── Planning ─────────────────────────────────────────────────────────────── */
+
+/* lods[i] == 0xFF marks an inactive slot.  Due entities are bucketed by how
+ * many ticks overdue they are (most overdue first) and then by LOD, and the
+ * buckets are filled in order until the budget runs out. */
+static void plan_group(SchedSlot* slots, const uint8_t* lods, int count, int budget,
+                       float dt, NpcSchedTickStats* st) {
+    uint16_t bucket_count[SCHED_BUCKETS];
+    uint8_t  bucket_of[MAX_WORLD_NPCS > MAX_NPC_AGENTS ? MAX_WORLD_NPCS : MAX_NPC_AGENTS];
+    memset(bucket_count, 0, sizeof(bucket_count));
+    memset(st, 0, sizeof(*st));
+
+    for (int i = 0; i < count; i++) {
+        SchedSlot* s = &slots[i];
+        s->run = false;
+        if (lods[i] == 0xFF) {
+            s->live = false;
+            s->accum = 0.0f;
+            continue;
+        }
+        if (!s->live) {
+            /* New occupant of this slot: due at once, with no carried time */
+            s->live = true;
+            s->accum = 0.0f;
+            s->last_run = g_tick - NPC_LOD_COLD_TICKS;
+        }
+        s->lod = lods[i];
+        s->accum += dt;
+        if (s->accum > NPC_SCHED_MAX_DT) s->accum = NPC_SCHED_MAX_DT;
+        st->active++;
+        st->per_lod[s->lod]++;
+
+        uint32_t waited = g_tick - s->last_run;
+        uint32_t interval = LOD_INTERVAL[s->lod];
+        if (waited < interval) {
+            st->skipped++;
+            bucket_of[i] = 0xFF;
+            continue;
+        }
+        uint32_t overdue = waited - interval;
+        if (overdue >= SCHED_OVERDUE_LEVELS) overdue = SCHED_OVERDUE_LEVELS - 1;
+        bucket_of[i] = (uint8_t)((SCHED_OVERDUE_LEVELS - 1 - overdue) * NPC_LOD_COUNT + s->lod);
+        bucket_count[bucket_of[i]]++;
+    }
+
+    /* Turn counts into per-bucket allowances */
+    int left = budget;
+    for (int b = 0; b < SCHED_BUCKETS; b++) {
+        int take = bucket_count[b] < left ? bucket_count[b] : left;
+        bucket_count[b] = (uint16_t)take;
+        left -= take;
+    }
+
+    for (int i = 0; i < count; i++) {
+        if (lods[i] == 0xFF || bucket_of[i] == 0xFF) continue;
+        if (bucket_count[bucket_of[i]] == 0) {
+            st->deferred++;
+            continue;
+        }
+        bucket_count[bucket_of[i]]--;
+        slots[i].run = true;
+        slots[i].last_run = g_tick;
+        st->scheduled++;
+    }
+}
+
+void npc_sched_plan(float dt) {
+    g_tick++;
+
+    g_pcount = 0;
+    for (int p = 0; p < WS_MAX_CLIENTS; p++) {
+        if (!players[p].active) continue;
+        g_px[g_pcount] = players[p].x;
+        g_py[g_pcount] = players[p].y;
+        g_pcount++;
+    }
+    world_npc_grapple_mask(g_grappled, MAX_WORLD_NPCS);
+
+    uint8_t lods[MAX_WORLD_NPCS > MAX_NPC_AGENTS ? MAX_WORLD_NPCS : MAX_NPC_AGENTS];
+
+    for (int i = 0; i < MAX_WORLD_NPCS; i++) {
+        const WorldNpc* npc = &world_npcs[i];
+        lods[i] = (i < world_npc_count && npc->active) ? world_npc_lod(npc, i) : 0xFF;
+    }
+    plan_group(g_world, lods, MAX_WORLD_NPCS, NPC_SCHED_WORLD_BUDGET, dt, &g_world_stats);
+
+    for (int i = 0; i < MAX_NPC_AGENTS; i++) {
+        const NpcAgent* agent = &npc_agents[i];
+        lods[i] = (i < npc_count && agent->active) ? agent_lod(agent) : 0xFF;
+    }
+    plan_group(g_agent, lods, MAX_NPC_AGENTS, NPC_SCHED_AGENT_BUDGET, dt, &g_agent_stats);
+
+    metrics_inc(g_metrics.world[0], g_world_stats.scheduled);
+    metrics_inc(g_metrics.world[1], g_world_stats.skipped);
+    metrics_inc(g_metrics.world[2], g_world_stats.deferred);
+    metrics_inc(g_metrics.agent[0], g_agent_stats.scheduled);
+    metrics_inc(g_metrics.agent[1], g_agent_stats.skipped);
+    metrics_inc(g_metrics.agent[2], g_agent_stats.deferred);
+    for (int l = 0; l < NPC_LOD_COUNT; l++) {
+        metrics_gauge_set(g_metrics.world_lod[l], g_world_stats.per_lod[l]);
+        metrics_gauge_set(g_metrics.agent_lod[l], g_agent_stats.per_lod[l]);
+    }
+}
+
+static bool take(SchedSlot* s, float* dt) {
+    if (!s->run) return false;
+    s->run = false;
+    *dt = s->accum;
+    s->accum = 0.0f;
+    return true;
+}
+
+bool npc_sched_world_take(int i, float* dt) {
+    if (i < 0 || i >= MAX_WORLD_NPCS) return false;
+    return take(&g_world[i], dt);
+}
+
+bool npc_sched_agent_take(int i, float* dt) {
+    if (i < 0 || i >= MAX_NPC_AGENTS) return false;
+    return take(&g_agent[i], dt);
+}
+
+bool npc_sched_world_grappled(int i) {
+    return i >= 0 && i < MAX_WORLD_NPCS && g_grappled[i];
+}
+
+void npc_sched_last_stats(NpcSchedTickStats* world, NpcSchedTickStats* agents) {
+    if (world)  *world  = g_world_stats;
+    if (agents) *agents = g_agent_stats;
+}
@@ -9,12 +9,17 @@
 #include "net/npc_world.h"
 #include "net/npc_agents.h"
 #include "net/module_interactions.h"
+#include "net/npc_sched.h"
+#include "net/npc_nav.h"
+#include "net/crew_jobs.h"
 #include "net/ship_schematics.h"
 #include "net/ship_chest_resources.h"
 #include "net/ship_plank_wreckage.h"
 #include "net/bucket_bail.h"
 #include "sim/module_types.h"
 #include "sim/island.h"
+#include "sim/deck_utils.h"
+#include "sim/hull_sdf.h"
 
 // ── Repairer occupancy: small precomputed set rebuilt each tick ──────────────
 typedef struct { uint16_t npc_id; uint16_t ship_id; module_id_t mod_id; } NpcOccEntry;
@@ -27,35 +32,6 @@ static bool occ_taken_by_other(const NpcOccEntry* buf, int cnt,
     return false;
 }
 
-/** True when a plank slot has a live module (not destroyed / zero HP). */
-static bool npc_plank_slot_intact(const struct Ship* sim_ship, uint8_t ship_seq, int slot) {
-    if (!sim_ship || slot < 0 || slot >= 10) return false;
-    uint16_t expected = MID(ship_seq, MODULE_OFFSET_PLANK(slot));
-    for (uint8_t m = 0; m < sim_ship->module_count; m++) {
-        const ShipModule* mod = &sim_ship->modules[m];
-        if ((uint32_t)mod->id != (uint32_t)expected) continue;
-        if (mod->state_bits & MODULE_STATE_DESTROYED) return false;
-        if (mod->health <= 0) return false;
-        return true;
-    }
-    return false;
-}
-
-/** First missing plank slot that is not blocked by wreckage, or -1. */
-static int npc_find_missing_plank_slot(const struct Ship* sim_ship, SimpleShip* simple,
-                                       uint8_t ship_seq,
-                                       const NpcOccEntry* occ_buf, int occ_cnt,
-                                       uint16_t npc_id, uint16_t ship_id) {
-    for (int k = 0; k < 10; k++) {
-        if (npc_plank_slot_intact(sim_ship, ship_seq, k)) continue;
-        if (simple && ship_plank_wreckage_blocks(simple, k)) continue;
-        uint32_t plank_mid = MID(ship_seq, MODULE_OFFSET_PLANK(k));
-        if (occ_taken_by_other(occ_buf, occ_cnt, npc_id, ship_id, plank_mid)) continue;
-        return k;
-    }
-    return -1;
-}
-
 /** Sync a sim-layer module back into the SimpleShip mirror. */
 static void npc_sync_module_to_simple(SimpleShip* simple, const ShipModule* mod) {
     if (!simple || !mod) return;
@@ -266,6 +242,17 @@ static void get_module_interact_pos(const ShipModule* mod, float* out_x, float*
 #define REPAIR_GUNPORT_INSET 50.0f   /* gunports sit right on the hull wall   */
 #define REPAIR_PLANK_INSET   40.0f   /* extra inset vs the gunner's 28 units  */
 
+// Plank centre positions in client-space local coords (match HULL_POINTS in modules.ts)
+// Order: bow_port, bow_starboard, 3× starboard, stern_starboard, stern_port, 3× port
+static const float s_plank_cx[10] = {
+     246.25f,  246.25f,  115.0f,  -35.0f, -185.0f,
+    -281.25f, -281.25f, -185.0f,  -35.0f,  115.0f
+};
+static const float s_plank_cy[10] = {
+     45.0f, -45.0f, -90.0f, -90.0f, -90.0f,
+    -45.0f,  45.0f,  90.0f,  90.0f,  90.0f
+};
+
 static void get_module_repair_pos(const ShipModule* mod, float* out_x, float* out_y) {
     float cx = SERVER_TO_CLIENT(Q16_TO_FLOAT(mod->local_pos.x));
     float cy = SERVER_TO_CLIENT(Q16_TO_FLOAT(mod->local_pos.y));
@@ -314,22 +301,143 @@ static void get_module_repair_pos(const ShipModule* mod, float* out_x, float* ou
     }
 }
 
+typedef struct {
+    CrewJobKind kind;
+    uint32_t    module_id;
+    float       x, y;        // Ship-local spot to work from
+    float       ratio;       // Health ratio (CREW_JOB_MODULE)
+} NpcRepairPick;
+
+/**
+ * Next repair job for `npc` from its ship's crew job board, by priority:
+ * missing deck, first placeable missing plank, then the most damaged module
+ * nobody else has taken — or, when every one is taken, the most damaged one
+ * to help with.  Jobs the ship's chest cannot pay for are passed over.
+ */
+static bool npc_pick_repair_job(const WorldNpc* npc, SimpleShip* simple, struct Ship* sim_ship,
+                                const NpcOccEntry* occ_buf, int occ_cnt, NpcRepairPick* out) {
+    int job_count;
+    const CrewRepairJob* jobs = crew_jobs_repairs(simple, sim_ship, &job_count);
+    bool plank_seen = false;
+    const CrewRepairJob* best = NULL;
+    const CrewRepairJob* stack = NULL;
+    float best_ratio = 1.0f, stack_ratio = 1.0f;
+    for (int k = 0; k < job_count; k++) {
+        const CrewRepairJob* job = &jobs[k];
+        bool taken = occ_taken_by_other(occ_buf, occ_cnt, npc->id, npc->ship_id, job->module_id);
+        switch ((CrewJobKind)job->kind) {
+        case CREW_JOB_DECK:
+            if (taken || !npc_repair_job_affordable(simple, sim_ship, job->module_id)) break;
+            *out = (NpcRepairPick){ CREW_JOB_DECK, job->module_id, 0.0f, 0.0f, 0.0f };
+            return true;
+        case CREW_JOB_PLANK: {
+            /* Only the first free slot is offered (wreckage blocks placement) */
+            if (plank_seen || taken || ship_plank_wreckage_blocks(simple, job->slot)) break;
+            plank_seen = true;
+            if (!npc_repair_job_affordable(simple, sim_ship, job->module_id)) break;
+            // Pull inward toward ship centre by REPAIR_PLANK_INSET units
+            float pcx = s_plank_cx[job->slot], pcy = s_plank_cy[job->slot];
+            float pmag = sqrtf(pcx * pcx + pcy * pcy);
+            if (pmag > 0.0f) { pcx -= (pcx / pmag) * REPAIR_PLANK_INSET; pcy -= (pcy / pmag) * REPAIR_PLANK_INSET; }
+            *out = (NpcRepairPick){ CREW_JOB_PLANK, job->module_id, pcx, pcy, 0.0f };
+            return true;
+        }
+        case CREW_JOB_MODULE: {
+            float ratio;
+            if (!crew_job_module(sim_ship, job, &ratio)) break;
+            if (!npc_repair_job_affordable(simple, sim_ship, job->module_id)) break;
+            if (!taken && ratio < best_ratio)  { best  = job; best_ratio  = ratio; }
+            if ( taken && ratio < stack_ratio) { stack = job; stack_ratio = ratio; }
+            break;
+        }
+        }
+    }
+    if (!best) { best = stack; best_ratio = stack_ratio; }
+    if (!best) return false;
+    ShipModule* mod = crew_job_module(sim_ship, best, NULL);
+    out->kind      = CREW_JOB_MODULE;
+    out->module_id = best->module_id;
+    out->ratio     = best_ratio;
+    get_module_repair_pos(mod, &out->x, &out->y);
+    return true;
+}
+
+static void npc_take_repair_job(WorldNpc* npc, const NpcRepairPick* pick,
+                                NpcOccEntry* occ_buf, int* occ_cnt, const char* how) {
+    npc->target_local_x        = pick->x;
+    npc->target_local_y        = pick->y;
+    npc->assigned_weapon_id    = pick->module_id;
+    npc->repair_resources_paid = false;
+    npc->state                 = WORLD_NPC_STATE_MOVING;
+    occ_buf[(*occ_cnt)++] = (NpcOccEntry){ npc->id, npc->ship_id, (module_id_t)pick->module_id };
+    if (pick->kind == CREW_JOB_DECK)
+        log_info("🔨 NPC %u (%s) %s to replace missing deck", npc->id, npc->name, how);
+    else if (pick->kind == CREW_JOB_PLANK)
+        log_debug("🔨 NPC %u (%s) %s to place missing plank %u", npc->id, npc->name, how, pick->module_id);
+    else
+        log_info("🔧 NPC %u (%s) %s to repair module %u (%.0f%% HP)",
+                 npc->id, npc->name, how, pick->module_id, pick->ratio * 100.0f);
+}
+
 /**
  * Find a module on a SimpleShip by module ID.
  * Returns a pointer into ship->modules[], or NULL if not found.
  */
 ShipModule* find_module_on_ship(SimpleShip* ship, uint32_t module_id) {
-    for (int m = 0; m < ship->module_count; m++) {
-        if (ship->modules[m].id == module_id)
-            return &ship->modules[m];
+    return find_module_by_id(ship, module_id);
+}
+
+/* ── Gunner index ───────────────────────────────────────────────────────────
+ * ship->gunner_by_mid[MID_OFFSET(module)] holds world_npcs[] slot + 1 of the
+ * gunner stationed there.  WorldNpcs never change slot, and every hit is
+ * checked against the NPC itself, so an entry left behind by a path that
+ * moves a gunner on without dismount_npc() is caught on the next lookup. */
+static bool npc_is_gunner_at(const WorldNpc* npc, const SimpleShip* ship, uint32_t module_id) {
+    return npc->active && npc->role == NPC_ROLE_GUNNER &&
+           npc->ship_id == ship->ship_id &&
+           npc->assigned_weapon_id == module_id &&
+           npc->state == WORLD_NPC_STATE_AT_GUN;
+}
+
+/* The indexed gunner left: hand the slot to any other gunner already AT_GUN
+ * there (two crew can end up on one cannon).  Runs once per departure. */
+static void npc_gunner_index_refill(SimpleShip* ship, uint32_t module_id, const WorldNpc* leaving) {
+    uint16_t* entry = &ship->gunner_by_mid[MID_OFFSET(module_id)];
+    *entry = 0;
+    for (int i = 0; i < world_npc_count; i++) {
+        if (&world_npcs[i] != leaving && npc_is_gunner_at(&world_npcs[i], ship, module_id)) {
+            *entry = (uint16_t)(i + 1);
+            return;
+        }
     }
-    return NULL;
+}
+
+void npc_gunner_index_set(WorldNpc* npc, SimpleShip* ship) {
+    if (!ship || npc->assigned_weapon_id == 0) return;
+    ship->gunner_by_mid[MID_OFFSET(npc->assigned_weapon_id)] = (uint16_t)(npc - world_npcs + 1);
+}
+
+void npc_gunner_index_clear(WorldNpc* npc, SimpleShip* ship) {
+    if (!ship || npc->assigned_weapon_id == 0) return;
+    if (ship->gunner_by_mid[MID_OFFSET(npc->assigned_weapon_id)] == (uint16_t)(npc - world_npcs + 1))
+        npc_gunner_index_refill(ship, npc->assigned_weapon_id, npc);
+}
+
+WorldNpc* npc_gunner_at(SimpleShip* ship, uint32_t module_id) {
+    uint16_t entry = ship->gunner_by_mid[MID_OFFSET(module_id)];
+    if (entry == 0) return NULL;
+    WorldNpc* npc = &world_npcs[entry - 1];
+    if (npc_is_gunner_at(npc, ship, module_id)) return npc;
+    npc_gunner_index_refill(ship, module_id, npc);
+    entry = ship->gunner_by_mid[MID_OFFSET(module_id)];
+    return entry ? &world_npcs[entry - 1] : NULL;
 }
 
 /* Dismount the NPC from whatever module/role it currently holds, freeing that
  * slot for other crew.  Does NOT set a new target or role — caller does that. */
 void dismount_npc(WorldNpc* npc, SimpleShip* ship) {
     if (npc->role == NPC_ROLE_GUNNER) {
+        npc_gunner_index_clear(npc, ship);
         npc->wants_cannon       = false;
         npc->assigned_weapon_id = 0;
         /* Re-run sector so remaining gunners can claim the vacated cannon */
@@ -790,31 +898,10 @@ uint32_t spawn_unclaimed_npc(float wx, float wy, int index) {
 #define NPC_COMMAND_RANGE 900.0f
 
 static bool npc_point_on_island_land(float wx, float wy, uint32_t* out_island_id) {
-    for (int ii = 0; ii < ISLAND_COUNT; ii++) {
-        const IslandDef* isl = &ISLAND_PRESETS[ii];
-        float dx = wx - isl->x, dy = wy - isl->y;
-        float ds = dx * dx + dy * dy;
-        bool on;
-        if (isl->vertex_count > 0) {
-            on = (ds < isl->poly_bound_r * isl->poly_bound_r)
-              && island_poly_contains(isl, wx, wy);
-        } else {
-            float broad_r = isl->beach_radius_px + isl->beach_max_bump;
-            if (ds >= broad_r * broad_r) {
-                on = false;
-            } else {
-                float angle = atan2f(dy, dx);
-                float nr = island_boundary_r(isl->beach_radius_px,
-                                             isl->beach_bumps, angle);
-                on = (ds < nr * nr);
-            }
-        }
-        if (on) {
-            if (out_island_id) *out_island_id = (uint32_t)isl->id;
-            return true;
-        }
-    }
-    return false;
+    const IslandDef* isl = island_land_at(wx, wy);
+    if (!isl) return false;
+    if (out_island_id) *out_island_id = (uint32_t)isl->id;
+    return true;
 }
 
 static bool npc_still_on_island(const WorldNpc* npc) {
@@ -823,16 +910,9 @@ static bool npc_still_on_island(const WorldNpc* npc) {
         const IslandDef* isl = &ISLAND_PRESETS[ii];
         if ((uint32_t)isl->id != npc->on_island_id) continue;
         float dx = npc->x - isl->x, dy = npc->y - isl->y;
-        float ds = dx * dx + dy * dy;
-        if (isl->vertex_count > 0) {
-            return (ds < isl->poly_bound_r * isl->poly_bound_r)
-                && island_poly_contains(isl, npc->x, npc->y);
-        }
-        float broad_r = isl->beach_radius_px + isl->beach_max_bump;
-        if (ds >= broad_r * broad_r) return false;
-        float angle = atan2f(dy, dx);
-        float nr = island_boundary_r(isl->beach_radius_px, isl->beach_bumps, angle);
-        return ds < nr * nr;
+        if (isl->vertex_count > 0 &&
+            dx * dx + dy * dy >= isl->poly_bound_r * isl->poly_bound_r) return false;
+        return island_layer_contains(isl, ISLAND_LAYER_LAND, npc->x, npc->y);
     }
     return false;
 }
@@ -983,53 +1063,12 @@ static void npc_cancel_manual_order(WorldNpc* npc, const char* reason) {
 
 #define NPC_HULL_TOUCH_RADIUS 18.0f  /* client px — ~NPC body radius */
 
-static bool npc_point_in_hull_client(float lx, float ly, const struct Ship* sim_ship) {
-    int n = sim_ship->hull_vertex_count;
-    bool inside = false;
-    for (int i = 0, j = n - 1; i < n; j = i++) {
-        float xi = SERVER_TO_CLIENT(Q16_TO_FLOAT(sim_ship->hull_vertices[i].x));
-        float yi = SERVER_TO_CLIENT(Q16_TO_FLOAT(sim_ship->hull_vertices[i].y));
-        float xj = SERVER_TO_CLIENT(Q16_TO_FLOAT(sim_ship->hull_vertices[j].x));
-        float yj = SERVER_TO_CLIENT(Q16_TO_FLOAT(sim_ship->hull_vertices[j].y));
-        if (((yi > ly) != (yj > ly)) &&
-            (lx < (xj - xi) * (ly - yi) / (yj - yi + 1e-12f) + xi))
-            inside = !inside;
-    }
-    return inside;
-}
-
-static float npc_dist_to_hull_edge_client(float lx, float ly, const struct Ship* sim_ship) {
-    float min_dist_sq = 1e20f;
-    int n = sim_ship->hull_vertex_count;
-    for (int i = 0; i < n; i++) {
-        int j = (i + 1) % n;
-        float ax = SERVER_TO_CLIENT(Q16_TO_FLOAT(sim_ship->hull_vertices[i].x));
-        float ay = SERVER_TO_CLIENT(Q16_TO_FLOAT(sim_ship->hull_vertices[i].y));
-        float bx = SERVER_TO_CLIENT(Q16_TO_FLOAT(sim_ship->hull_vertices[j].x));
-        float by = SERVER_TO_CLIENT(Q16_TO_FLOAT(sim_ship->hull_vertices[j].y));
-        float edx = bx - ax, edy = by - ay;
-        float len_sq = edx * edx + edy * edy;
-        float t = 0.0f;
-        if (len_sq > 1e-10f) {
-            t = ((lx - ax) * edx + (ly - ay) * edy) / len_sq;
-            if (t < 0.0f) t = 0.0f;
-            if (t > 1.0f) t = 1.0f;
-        }
-        float cx = ax + t * edx, cy = ay + t * edy;
-        float ex = lx - cx, ey = ly - cy;
-        float d  = ex * ex + ey * ey;
-        if (d < min_dist_sq) min_dist_sq = d;
-    }
-    return sqrtf(min_dist_sq);
-}
-
 static bool npc_touching_hull(float wx, float wy,
                               const SimpleShip* ship, const struct Ship* sim_ship) {
     if (!ship || !sim_ship || sim_ship->hull_vertex_count < 3) return false;
     float lx, ly;
     ship_world_to_local(ship, wx, wy, &lx, &ly);
-    if (npc_point_in_hull_client(lx, ly, sim_ship)) return true;
-    return npc_dist_to_hull_edge_client(lx, ly, sim_ship) <= NPC_HULL_TOUCH_RADIUS;
+    return hull_sdf_within(sim_ship, lx, ly, NPC_HULL_TOUCH_RADIUS);
 }
 
 /** True when an NPC may walk/swim aboard without grapples (same faction). */
@@ -1088,27 +1127,132 @@ static void npc_abort_foreign_boarding(WorldNpc* npc, uint16_t ship_id) {
              npc->id, npc->name, (unsigned)ship_id);
 }
 
+/* ── Path following (see net/npc_nav.h) ──────────────────────────────────────
+ * MOVING NPCs steer through nav_corner[] toward target_local_x/y.  A plan is
+ * made when the target or the frame changes; if the tick's search budget is
+ * spent the NPC joins nav_queue (walking straight meanwhile) and is served
+ * first, in order, at the start of the next tick. */
+
+static uint16_t nav_queue[MAX_WORLD_NPCS];
+static int      nav_queue_n;
+
+/* Frame the NPC walks in: a deck (ship-local coords) or an island (world
+ * coords).  0 = open water, where there is nothing to steer around. */
+static uint32_t nav_frame_key(const WorldNpc* npc) {
+    if (npc->ship_id != 0)
+        return 0x80000000u | ((uint32_t)npc->deck_level << 16) | npc->ship_id;
+    if (npc->boarding_ship_id != 0) return 0;
+    return npc->on_island_id;
+}
+
+static int nav_grid_for(const WorldNpc* npc) {
+    if (npc->ship_id != 0) {
+        SimpleShip*  ship = find_ship(npc->ship_id);
+        struct Ship* sim  = find_sim_ship(npc->ship_id);
+        if (!ship || !sim || sim->deck_count == 0) return -1;
+        const ShipDeck* deck = ship_get_deck(sim, npc->deck_level);
+        if (!deck) deck = &sim->decks[0];
+        return npc_nav_deck_grid(ship->ship_type, deck->id,
+                                 deck->collision_px, deck->collision_count);
+    }
+    /* Island paths only for walks that stay on the island; heading for the
+     * water is a straight line to the beach. */
+    if (npc->on_island_id == 0 ||
+        npc_island_at(npc->target_local_x, npc->target_local_y) != npc->on_island_id)
+        return -1;
+    for (int ii = 0; ii < ISLAND_COUNT; ii++)
+        if ((uint32_t)ISLAND_PRESETS[ii].id == npc->on_island_id)
+            return npc_nav_island_grid(ii);
+    return -1;
+}
+
+/* Plan from the NPC's position.  False if the search budget is spent. */
+static bool npc_nav_plan(WorldNpc* npc) {
+    NpcNavPath path;
+    int grid = nav_grid_for(npc);
+    NpcNavResult r = npc_nav_path(grid, npc->local_x, npc->local_y,
+                                  npc->nav_goal_x, npc->nav_goal_y, &path);
+    if (r == NPC_NAV_BUSY) return false;
+    npc->nav_next    = 0;
+    npc->nav_count   = 0;
+    npc->nav_partial = false;
+    npc->nav_state   = NPC_NAV_STATE_DIRECT;
+    if (r == NPC_NAV_OK && (path.count > 0 || path.partial)) {
+        memcpy(npc->nav_corner, path.corner, sizeof(path.corner));
+        npc->nav_count   = (uint8_t)path.count;
+        npc->nav_partial = path.partial;
+        npc->nav_state   = NPC_NAV_STATE_READY;
+    }
+    return true;
+}
+
+static void npc_nav_request(WorldNpc* npc, int idx) {
+    if (npc->nav_state == NPC_NAV_STATE_QUEUED) return;
+    if (nav_queue_n == 0 && npc_nav_plan(npc)) return;
+    npc->nav_count = 0;
+    npc->nav_state = NPC_NAV_STATE_QUEUED;
+    if (nav_queue_n < MAX_WORLD_NPCS) nav_queue[nav_queue_n++] = (uint16_t)idx;
+}
+
+/* Serve waiting NPCs oldest first; whoever the budget doesn't reach keeps
+ * their place. */
+static void npc_nav_flush(void) {
+    npc_nav_begin_tick();
+    int kept = 0;
+    for (int q = 0; q < nav_queue_n; q++) {
+        WorldNpc* npc = &world_npcs[nav_queue[q]];
+        if (!npc->active || npc->nav_state != NPC_NAV_STATE_QUEUED) continue;
+        if (npc->state != WORLD_NPC_STATE_MOVING) {
+            npc->nav_state = NPC_NAV_STATE_NONE;
+            continue;
+        }
+        if (!npc_nav_plan(npc)) nav_queue[kept++] = nav_queue[q];
+    }
+    nav_queue_n = kept;
+}
+
+/* Point to walk toward this tick: the next corner, or the target itself. */
+static void npc_nav_steer(WorldNpc* npc, int idx, float* tx, float* ty) {
+    uint32_t key = nav_frame_key(npc);
+    if (npc->nav_state == NPC_NAV_STATE_NONE || npc->nav_key != key ||
+        npc->nav_goal_x != npc->target_local_x || npc->nav_goal_y != npc->target_local_y) {
+        npc->nav_key    = key;
+        npc->nav_goal_x = npc->target_local_x;
+        npc->nav_goal_y = npc->target_local_y;
+        npc->nav_count  = 0;
+        if (key == 0) {
+            npc->nav_state = NPC_NAV_STATE_DIRECT;
+        } else {
+            if (npc->nav_state != NPC_NAV_STATE_QUEUED) npc->nav_state = NPC_NAV_STATE_NONE;
+            npc_nav_request(npc, idx);
+        }
+    }
+    if (npc->nav_state == NPC_NAV_STATE_READY && npc->nav_next >= npc->nav_count &&
+        npc->nav_partial)
+        npc_nav_request(npc, idx);   /* Past the last corner of a long route */
+    if (npc->nav_state == NPC_NAV_STATE_READY && npc->nav_next < npc->nav_count) {
+        *tx = npc->nav_corner[npc->nav_next][0];
+        *ty = npc->nav_corner[npc->nav_next][1];
+        return;
+    }
+    *tx = npc->target_local_x;
+    *ty = npc->target_local_y;
+}
+
 /**
  * Tick world NPCs: animate movement across deck, then update world positions.
  */
-void tick_world_npcs(float dt) {
+void tick_world_npcs(void) {
     g_npcs_dirty = true; // NPCs ticked this frame — JSON must be rebuilt
     /* Trim trailing inactive slots so world_npc_count stays accurate */
     while (world_npc_count > 0 && !world_npcs[world_npc_count - 1].active)
         world_npc_count--;
-    // Plank centre positions in client-space local coords (match HULL_POINTS in modules.ts)
-    // Order: bow_port, bow_starboard, 3× starboard, stern_starboard, stern_port, 3× port
-    static const float s_plank_cx[10] = {
-         246.25f,  246.25f,  115.0f,  -35.0f, -185.0f,
-        -281.25f, -281.25f, -185.0f,  -35.0f,  115.0f
-    };
-    static const float s_plank_cy[10] = {
-         45.0f, -45.0f, -90.0f, -90.0f, -90.0f,
-        -45.0f,  45.0f,  90.0f,  90.0f,  90.0f
-    };
 
     // Snapshot current repairer assignments for O(1) occupancy checks.
     // Updated inline when a new claim is made mid-tick.
+    /* Path requests left over from last tick go before this tick's */
+    npc_nav_flush();
+
     NpcOccEntry occ_buf[MAX_WORLD_NPCS];
     int occ_cnt = 0;
     for (int _bi = 0; _bi < world_npc_count; _bi++) {
@@ -1122,7 +1266,19 @@ void tick_world_npcs(float dt) {
         if (!npc->active) continue;
 
         /* Grapple rope owns world position — updated later in update_grapple_hooks(). */
-        const bool grappled = world_npc_is_grapple_target(i);
+        const bool grappled = npc_sched_world_grappled(i);
+
+        /* Off-tick at its LOD: only follow the ship so x/y stay exact for
+         * hit tests; AI, movement and vitals catch up with the full dt on
+         * the next scheduled run. */
+        float dt;
+        if (!npc_sched_world_take(i, &dt)) {
+            if (!grappled && npc->ship_id != 0) {
+                SimpleShip* ship = find_ship(npc->ship_id);
+                if (ship) ship_local_to_world(ship, npc->local_x, npc->local_y, &npc->x, &npc->y);
+            }
+            continue;
+        }
 
         if (!grappled && npc->state == WORLD_NPC_STATE_MOVING) {
             /* Player-issued move: cancel if the commander walked out of range. */
@@ -1146,86 +1302,35 @@ void tick_world_npcs(float dt) {
             if (npc->order_player_id == 0 &&
                 npc->role == NPC_ROLE_REPAIRER && npc->assigned_weapon_id == 0 && global_sim) {
                 struct Ship* intr_ship = find_sim_ship(npc->ship_id);
-                if (intr_ship) {
-                    // Resolve ship_seq for MID-based module IDs
-                    SimpleShip* _intr_ss = find_ship(npc->ship_id);
-                    uint8_t _intr_seq = _intr_ss ? _intr_ss->ship_seq : (uint8_t)(npc->ship_id & 0xFF);
-                    uint16_t _intr_deck_mid = MID(_intr_seq, MODULE_OFFSET_DECK);
-
-                    // Check for missing deck (highest priority)
-                    bool intr_deck_present = false;
-                    for (uint8_t m = 0; m < intr_ship->module_count; m++) {
-                        if (intr_ship->modules[m].type_id == MODULE_TYPE_DECK) { intr_deck_present = true; break; }
-                    }
-                    bool intr_deck_taken = !intr_deck_present &&
-                        occ_taken_by_other(occ_buf, occ_cnt, npc->id, npc->ship_id, _intr_deck_mid);
-                    if (!intr_deck_present && !intr_deck_taken &&
-                        _intr_ss && npc_repair_job_affordable(_intr_ss, intr_ship, _intr_deck_mid)) {
-                        npc->target_local_x          = 0.0f;
-                        npc->target_local_y          = 0.0f;
-                        npc->assigned_weapon_id      = _intr_deck_mid;
-                        npc->repair_resources_paid   = false;
-                        occ_buf[occ_cnt++] = (NpcOccEntry){ npc->id, npc->ship_id, _intr_deck_mid };
-                        log_info("🔨 NPC %u (%s) interrupted — redirecting to replace missing deck",
-                                 npc->id, npc->name);
-                    } else {
-                    int intr_missing = npc_find_missing_plank_slot(
-                        intr_ship, _intr_ss, _intr_seq, occ_buf, occ_cnt, npc->id, npc->ship_id);
-                    if (intr_missing >= 0) {
-                        uint32_t intr_plank_mid = MID(_intr_seq, MODULE_OFFSET_PLANK(intr_missing));
-                        if (_intr_ss && npc_repair_job_affordable(_intr_ss, intr_ship, intr_plank_mid)) {
-                        float pcx = s_plank_cx[intr_missing], pcy = s_plank_cy[intr_missing];
-                        float pmag = sqrtf(pcx * pcx + pcy * pcy);
-                        if (pmag > 0.0f) { pcx -= (pcx / pmag) * 28.0f; pcy -= (pcy / pmag) * 28.0f; }
-                        npc->target_local_x          = pcx;
-                        npc->target_local_y          = pcy;
-                        npc->assigned_weapon_id      = intr_plank_mid;
-                        npc->repair_resources_paid   = false;
-                        occ_buf[occ_cnt++] = (NpcOccEntry){ npc->id, npc->ship_id, npc->assigned_weapon_id };
-                        log_info("🔨 NPC %u (%s) interrupted — redirecting to missing plank %u",
-                                 npc->id, npc->name, npc->assigned_weapon_id);
-                        }
-                    } else {
-                        // Check for damaged modules (planks are replace-only, not repaired)
-                        ShipModule* intr_mod = NULL;
-                        ShipModule* intr_stack = NULL;
-                        float intr_worst = 1.0f, intr_stack_r = 1.0f;
-                        for (uint8_t m = 0; m < intr_ship->module_count; m++) {
-                            ShipModule* mod = &intr_ship->modules[m];
-                            if (mod->type_id == MODULE_TYPE_PLANK) continue;
-                            if (mod->state_bits & MODULE_STATE_DESTROYED) continue;
-                            if (mod->max_health == 0) continue;
-                            float ratio = (float)mod->health / (float)mod->max_health;
-                            if (ratio >= 1.0f) continue;
-                            if (_intr_ss && !npc_repair_job_affordable(_intr_ss, intr_ship, (uint32_t)mod->id)) continue;
-                            bool taken = occ_taken_by_other(occ_buf, occ_cnt, npc->id, npc->ship_id, (uint32_t)mod->id);
-                            if (!taken && ratio < intr_worst)  { intr_mod   = mod; intr_worst  = ratio; }
-                            if ( taken && ratio < intr_stack_r){ intr_stack = mod; intr_stack_r = ratio; }
-                        }
-                        if (!intr_mod) intr_mod = intr_stack;
-                        if (intr_mod) {
-                            float mx, my;
-                            get_module_interact_pos(intr_mod, &mx, &my);
-                            npc->target_local_x          = mx;
-                            npc->target_local_y          = my;
-                            npc->assigned_weapon_id      = (uint32_t)intr_mod->id;
-                            npc->repair_resources_paid   = false;
-                            occ_buf[occ_cnt++] = (NpcOccEntry){ npc->id, npc->ship_id, npc->assigned_weapon_id };
-                            log_info("🔧 NPC %u (%s) interrupted — redirecting to damaged module %u (%.0f%% HP)",
-                                     npc->id, npc->name, intr_mod->id, intr_worst * 100.0f);
-                        }
-                    }
-                    } // end deck-missing else
-                }
+                SimpleShip*  intr_ss   = find_ship(npc->ship_id);
+                NpcRepairPick pick;
+                if (intr_ship && intr_ss &&
+                    npc_pick_repair_job(npc, intr_ss, intr_ship, occ_buf, occ_cnt, &pick))
+                    npc_take_repair_job(npc, &pick, occ_buf, &occ_cnt, "interrupted — redirecting");
             }
 
-            float dx   = npc->target_local_x - npc->local_x;
-            float dy   = npc->target_local_y - npc->local_y;
-            float dist = sqrtf(dx * dx + dy * dy);
+            float tx, ty;
             float step = npc->move_speed * dt;
+            npc_nav_steer(npc, i, &tx, &ty);
+            /* Corners on the way are passed through, not arrived at */
+            while (npc->nav_state == NPC_NAV_STATE_READY && npc->nav_next < npc->nav_count) {
+                float cdx = tx - npc->local_x, cdy = ty - npc->local_y;
+                float cd  = sqrtf(cdx * cdx + cdy * cdy);
+                if (cd > step && cd >= 0.5f) break;
+                npc->local_x = tx;
+                npc->local_y = ty;
+                step = cd < step ? step - cd : 0.0f;
+                npc->nav_next++;
+                npc_nav_steer(npc, i, &tx, &ty);
+            }
+
+            float dx   = tx - npc->local_x;
+            float dy   = ty - npc->local_y;
+            float dist = sqrtf(dx * dx + dy * dy);
             if (dist <= step || dist < 0.5f) {
-                npc->local_x = npc->target_local_x;
-                npc->local_y = npc->target_local_y;
+                npc->local_x   = npc->target_local_x;
+                npc->local_y   = npc->target_local_y;
+                npc->nav_state = NPC_NAV_STATE_NONE;
 
                 /* ── Boarding arrival: reached swim target on/near hull ── */
                 if (npc->boarding_ship_id != 0 && npc->ship_id == 0) {
@@ -1247,6 +1352,8 @@ void tick_world_npcs(float dt) {
                     npc->state = (npc->role == NPC_ROLE_REPAIRER)
                                ? WORLD_NPC_STATE_REPAIRING
                                : WORLD_NPC_STATE_AT_GUN;
+                    if (npc->role == NPC_ROLE_GUNNER)
+                        npc_gunner_index_set(npc, find_ship(npc->ship_id));
                     if (npc->order_player_id != 0 && npc->ship_id != 0) {
                         npc->idle_local_x = npc->local_x;
                         npc->idle_local_y = npc->local_y;
@@ -1535,7 +1642,7 @@ void tick_world_npcs(float dt) {
                 // If it's a plank slot that's empty, place a new plank first
                 if (MODULE_OFFSET_IS_PLANK(MID_OFFSET((uint16_t)target_id))) {
                     int idx = (int)(MID_OFFSET((uint16_t)target_id) - MODULE_OFFSET_PLANK_BASE);
-                    bool module_exists = npc_plank_slot_intact(sim_ship, simple ? simple->ship_seq : (uint8_t)(npc->ship_id & 0xFF), idx);
+                    bool module_exists = crew_jobs_plank_intact(sim_ship, simple ? simple->ship_seq : (uint8_t)(npc->ship_id & 0xFF), idx);
                     if (!module_exists && sim_ship->module_count < MAX_MODULES_PER_SHIP) {
                         if (simple && ship_plank_wreckage_blocks(simple, idx)) {
                             still_working = true;
@@ -1638,97 +1745,12 @@ void tick_world_npcs(float dt) {
         if (npc->state == WORLD_NPC_STATE_IDLE) {
             if (!sim_ship) continue;
 
-            // Resolve ship_seq for MID-based module IDs
+            // Next job from the ship's crew job board (missing deck, missing
+            // plank, damaged module — in that order)
             SimpleShip* _idle_ss = find_ship(npc->ship_id);
-            uint8_t _idle_seq = _idle_ss ? _idle_ss->ship_seq : (uint8_t)(npc->ship_id & 0xFF);
-            uint16_t _idle_deck_mid = MID(_idle_seq, MODULE_OFFSET_DECK);
-
-            // --- 0. Check for missing deck (highest priority) -------------------
-            bool deck_present = false;
-            for (uint8_t m = 0; m < sim_ship->module_count; m++) {
-                if (sim_ship->modules[m].type_id == MODULE_TYPE_DECK) { deck_present = true; break; }
-            }
-            if (!deck_present) {
-                if (!occ_taken_by_other(occ_buf, occ_cnt, npc->id, npc->ship_id, _idle_deck_mid) &&
-                    npc_repair_job_affordable(_idle_ss, sim_ship, _idle_deck_mid)) {
-                    npc->target_local_x          = 0.0f;
-                    npc->target_local_y          = 0.0f;
-                    npc->assigned_weapon_id      = _idle_deck_mid;
-                    npc->repair_resources_paid   = false;
-                    npc->state                   = WORLD_NPC_STATE_MOVING;
-                    occ_buf[occ_cnt++] = (NpcOccEntry){ npc->id, npc->ship_id, _idle_deck_mid };
-                    log_info("🔨 NPC %u (%s) → walking to replace missing deck", npc->id, npc->name);
-                    continue;
-                }
-            }
-
-            // --- 1. Check for missing planks (replace-only; wreckage blocks placement) ---
-            int missing_idx = npc_find_missing_plank_slot(
-                sim_ship, _idle_ss, _idle_seq, occ_buf, occ_cnt, npc->id, npc->ship_id);
-
-            if (missing_idx >= 0) {
-                uint32_t plank_mid = MID(_idle_seq, MODULE_OFFSET_PLANK(missing_idx));
-                if (!npc_repair_job_affordable(_idle_ss, sim_ship, plank_mid)) {
-                    /* no resources — skip plank placement */
-                } else {
-                // Pull inward toward ship centre by REPAIR_PLANK_INSET units
-                float pcx = s_plank_cx[missing_idx], pcy = s_plank_cy[missing_idx];
-                float pmag = sqrtf(pcx * pcx + pcy * pcy);
-                if (pmag > 0.0f) { pcx -= (pcx / pmag) * REPAIR_PLANK_INSET; pcy -= (pcy / pmag) * REPAIR_PLANK_INSET; }
-                npc->target_local_x          = pcx;
-                npc->target_local_y          = pcy;
-                npc->assigned_weapon_id      = plank_mid;
-                npc->repair_resources_paid   = false;
-                npc->state                   = WORLD_NPC_STATE_MOVING;
-                occ_buf[occ_cnt++] = (NpcOccEntry){ npc->id, npc->ship_id, npc->assigned_weapon_id };
-                log_debug("🔨 NPC %u (%s) → walking to place missing plank %u",
-                         npc->id, npc->name, npc->assigned_weapon_id);
-                continue;
-                }
-            }
-
-            // --- 2. Check for damaged modules (planks are replace-only, not repaired) ---
-            // First pass: prefer a module NOT already claimed by another NPC.
-            // If everything damaged is taken, fall back to stacking on the worst one.
-            ShipModule* target_mod  = NULL;
-            ShipModule* stack_mod   = NULL; // fallback: most-damaged taken module
-            float worst_ratio  = 1.0f;
-            float stack_ratio  = 1.0f;
-            for (uint8_t m = 0; m < sim_ship->module_count; m++) {
-                ShipModule* mod = &sim_ship->modules[m];
-                if (mod->type_id == MODULE_TYPE_PLANK) continue;
-                if (mod->state_bits & MODULE_STATE_DESTROYED) continue;
-                if (mod->max_health == 0) continue;
-                float ratio = (float)mod->health / (float)mod->max_health;
-                // For masts, also consider fiber (sail) health damage
-                if (mod->type_id == MODULE_TYPE_MAST) {
-                    float fhmax = Q16_TO_FLOAT(mod->data.mast.fiber_max_health);
-                    if (fhmax > 0.0f) {
-                        float fh = Q16_TO_FLOAT(mod->data.mast.fiber_health);
-                        float fiber_ratio = fh / fhmax;
-                        if (fiber_ratio < ratio) ratio = fiber_ratio;
-                    }
-                }
-                if (ratio >= 1.0f) continue;
-                if (_idle_ss && !npc_repair_job_affordable(_idle_ss, sim_ship, (uint32_t)mod->id)) continue;
-                bool taken = occ_taken_by_other(occ_buf, occ_cnt, npc->id, npc->ship_id, (uint32_t)mod->id);
-                if (!taken && ratio < worst_ratio) { target_mod = mod; worst_ratio = ratio; }
-                if ( taken && ratio < stack_ratio)  { stack_mod  = mod; stack_ratio = ratio; }
-            }
-            // If no untaken module available, allow stacking on the most-damaged taken one
-            if (!target_mod) target_mod = stack_mod;
-
-            if (target_mod) {
-                float mx, my;
-                get_module_repair_pos(target_mod, &mx, &my);
-                npc->target_local_x          = mx;
-                npc->target_local_y          = my;
-                npc->assigned_weapon_id      = (uint32_t)target_mod->id;
-                npc->repair_resources_paid   = false;
-                npc->state                   = WORLD_NPC_STATE_MOVING;
-                occ_buf[occ_cnt++] = (NpcOccEntry){ npc->id, npc->ship_id, npc->assigned_weapon_id };
-                log_info("🔧 NPC %u (%s) → walking to repair module %u (%.0f%% HP)",
-                         npc->id, npc->name, target_mod->id, worst_ratio * 100.0f);
+            NpcRepairPick pick;
+            if (_idle_ss && npc_pick_repair_job(npc, _idle_ss, sim_ship, occ_buf, occ_cnt, &pick)) {
+                npc_take_repair_job(npc, &pick, occ_buf, &occ_cnt, "→ walking");
                 continue;
             }
 
@@ -1,5 +1,6 @@
 #include "net/ship_chest_resources.h"
 #include "net/websocket_server_internal.h"
+#include "net/structure_index.h"
 #include "util/log.h"
 #include "util/time.h"
 #include <math.h>
@@ -196,17 +197,14 @@ void ship_chest_sync_to_sim(const SimpleShip *simple, struct Ship *sim_ship) {
 }
 
 bool ship_chest_spawn_ruin_wreck(const SimpleShip *s, float wx, float wy) {
-    if (!s || placed_structure_count >= MAX_PLACED_STRUCTURES) return false;
+    if (!s || !structure_store_has_room()) return false;
 
     uint32_t wood, fiber, metal, stone;
     ship_chest_aggregate(s, &wood, &fiber, &metal, &stone);
     if ((wood + fiber + metal + stone) == 0) return false;
 
-    PlacedStructure *wr = &placed_structures[placed_structure_count];
-    memset(wr, 0, sizeof(*wr));
-    wr->active               = true;
-    wr->id                   = next_structure_id++;
-    wr->type                 = STRUCT_WRECK;
+    PlacedStructure *wr = structure_alloc(STRUCT_WRECK);
+    if (!wr) return false;
     wr->x                    = wx;
     wr->y                    = wy;
     wr->island_id            = 0;
@@ -217,7 +215,6 @@ bool ship_chest_spawn_ruin_wreck(const SimpleShip *s, float wx, float wy) {
     wr->chest_stone          = (uint16_t)(stone > 65535u ? 65535u : stone);
     wr->wreck_expires_ms     = get_time_ms() + 900000u;
     snprintf(wr->placer_name, sizeof(wr->placer_name), "chest_ruin");
-    placed_structure_count++;
 
     char wbcast[256];
     snprintf(wbcast, sizeof(wbcast),
@@ -9,6 +9,7 @@
 #define M_PI 3.14159265358979323846
 #endif
 #include "net/websocket_server_internal.h"
+#include "net/structure_index.h"
 #include "net/npc_world.h"
 #include "net/ship_init.h"
 #include "net/npc_world.h"
@@ -191,7 +192,8 @@ void tick_sinking_ships(void) {
          * Build a loot table from the sunk ship's modules + ammo, then place
          * a STRUCT_WRECK at the same world position.  Players can swim out
          * and E-interact to salvage one slot at a time.                   */
-        if (placed_structure_count < MAX_PLACED_STRUCTURES) {
+        PlacedStructure *w = structure_alloc(STRUCT_WRECK);
+        if (w) {
             /* Shared RNG for loot + blueprint rolls */
             uint32_t rng = (uint32_t)(get_time_ms() ^ (sunk_id * 2654435761u) ^ 0xB17EC0DEu);
 
@@ -207,11 +209,6 @@ void tick_sinking_ships(void) {
             l_count++;
 
             /* -- Place wreck -- */
-            PlacedStructure *w = &placed_structures[placed_structure_count];
-            memset(w, 0, sizeof(*w));
-            w->active           = true;
-            w->id               = next_structure_id++;
-            w->type             = STRUCT_WRECK;
             w->x                = wx;
             w->y                = wy;
             w->island_id        = 0;          /* at sea */
@@ -253,7 +250,6 @@ void tick_sinking_ships(void) {
                 w->wreck_bp_count = (uint8_t)bp_n;
             }
             strncpy(w->placer_name, "shipwreck", sizeof(w->placer_name) - 1);
-            placed_structure_count++;
 
             /* Best loot tier among the dropped blueprints (-1 = none) — used by
              * clients to color the salvage glint. */
@@ -323,6 +319,7 @@ void ship_init_default_weapon_groups(SimpleShip* ship) {
             }
         }
     }
+    weapon_groups_changed(ship);
 
 }
 
@@ -676,8 +673,10 @@ static void ghost_sanitize_modules(SimpleShip* ship) {
         if (ghost_is_physics_cannon(&ship->modules[m]))
             ship->modules[write++] = ship->modules[m];
     }
-    if (write != ship->module_count)
+    if (write != ship->module_count) {
         ship->module_count = write;
+        ship_module_grid_invalidate(&ship->module_grid);
+    }
 
     if (global_sim) {
         for (uint32_t si = 0; si < global_sim->ship_count; si++) {
@@ -728,6 +727,7 @@ uint32_t websocket_server_create_ghost_ship(float x, float y, uint8_t level) {
                 ship->modules[write++] = ship->modules[m];
         }
         ship->module_count = write;
+        ship_module_grid_invalidate(&ship->module_grid);
 
         if (global_sim) {
             for (uint32_t si = 0; si < global_sim->ship_count; si++) {
@@ -1092,7 +1092,8 @@ static float ghost_dist2_to(SimpleShip *from, SimpleShip *to) {
 }
 
 /* Shortest distance (client px) from (px,py) to the nearest island beach edge.
- * Returns 0 when the point is on or inside the island polygon / beach disc. */
+ * Returns 0 when the point is on or inside the island polygon / beach disc;
+ * beyond GHOST_ISLAND_DEAGGRO_DIST only "further than that" is exact. */
 static float ghost_nearest_island_edge_dist(float px, float py) {
     float best = 1e30f;
     for (int ii = 0; ii < ISLAND_COUNT; ii++) {
@@ -1102,10 +1103,10 @@ static float ghost_nearest_island_edge_dist(float px, float py) {
         float edge_dist;
 
         if (isl->vertex_count > 0) {
-            if (island_poly_contains(isl, px, py)) {
+            if (island_layer_contains(isl, ISLAND_LAYER_LAND, px, py)) {
                 edge_dist = 0.0f;
             } else {
-                edge_dist = island_poly_edge_dist(isl, px, py);
+                edge_dist = island_shore_dist(isl, px, py, GHOST_ISLAND_DEAGGRO_DIST);
             }
         } else {
             float angle   = atan2f(dy, dx);
@@ -1130,7 +1131,7 @@ static bool ghost_target_has_island_protection(SimpleShip *target) {
     for (int ii = 0; ii < ISLAND_COUNT; ii++) {
         const IslandDef *isl = &ISLAND_PRESETS[ii];
         if (island_in_shallow_water(isl, px, py)) return true;
-        if (isl->vertex_count > 0 && island_poly_contains(isl, px, py)) return true;
+        if (isl->vertex_count > 0 && island_layer_contains(isl, ISLAND_LAYER_LAND, px, py)) return true;
     }
 
     return ghost_nearest_island_edge_dist(px, py) <= GHOST_ISLAND_DEAGGRO_DIST;
@@ -1494,11 +1495,12 @@ void tick_ghost_ships(float dt) {
  * passed, broadcasting a wreck_removed message for each.                */
 void tick_wrecks(void) {
     uint32_t now = get_time_ms();
-    for (uint32_t i = 0; i < placed_structure_count; i++) {
-        PlacedStructure *w = &placed_structures[i];
-        if (!w->active || w->type != STRUCT_WRECK) continue;
+    uint32_t n;
+    const uint32_t *wrecks = structure_slots_of_type(STRUCT_WRECK, &n);
+    for (uint32_t k = n; k-- > 0;) {   /* backwards: freeing swaps the tail in */
+        PlacedStructure *w = &placed_structures[wrecks[k]];
         if (w->wreck_expires_ms != 0 && now >= w->wreck_expires_ms) {
-            w->active = false;
+            structure_free(w);
             char bcast[64];
             snprintf(bcast, sizeof(bcast),
                      "{\"type\":\"wreck_removed\",\"id\":%u}", (unsigned)w->id);
@@ -0,0 +1,101 @@
+#include <math.h>
+#include <string.h>
+#include "net/ship_module_grid.h"
+
+void ship_module_grid_build(ShipModuleGrid* g, const ShipModule* modules, uint8_t count,
+                            ShipModuleGridFilter files) {
+    uint8_t idx[MAX_MODULES_PER_SHIP];
+    float   mx[MAX_MODULES_PER_SHIP], my[MAX_MODULES_PER_SHIP];
+    uint8_t n = 0;
+    float min_x = 0.0f, min_y = 0.0f, max_x = 0.0f, max_y = 0.0f;
+    if (count > MAX_MODULES_PER_SHIP) count = MAX_MODULES_PER_SHIP;
+
+    for (uint8_t m = 0; m < count; m++) {
+        if (files && !files(modules[m].type_id)) continue;
+        float x = SERVER_TO_CLIENT(Q16_TO_FLOAT(modules[m].local_pos.x));
+        float y = SERVER_TO_CLIENT(Q16_TO_FLOAT(modules[m].local_pos.y));
+        if (n == 0 || x < min_x) min_x = x;
+        if (n == 0 || x > max_x) max_x = x;
+        if (n == 0 || y < min_y) min_y = y;
+        if (n == 0 || y > max_y) max_y = y;
+        idx[n] = m; mx[n] = x; my[n] = y;
+        n++;
+    }
+
+    g->valid        = true;
+    g->module_count = count;
+    g->origin_x     = min_x;
+    g->origin_y     = min_y;
+
+    float cell = SHIP_MODULE_GRID_CELL_PX;
+    while ((max_x - min_x) / cell >= (float)SHIP_MODULE_GRID_MAX_COLS ||
+           (max_y - min_y) / cell >= (float)SHIP_MODULE_GRID_MAX_ROWS) {
+        cell *= 2.0f;
+    }
+    g->inv_cell = 1.0f / cell;
+    g->cols = (n == 0) ? 0 : (uint8_t)((max_x - min_x) * g->inv_cell) + 1;
+    g->rows = (n == 0) ? 0 : (uint8_t)((max_y - min_y) * g->inv_cell) + 1;
+    if (g->cols > SHIP_MODULE_GRID_MAX_COLS) g->cols = SHIP_MODULE_GRID_MAX_COLS;
+    if (g->rows > SHIP_MODULE_GRID_MAX_ROWS) g->rows = SHIP_MODULE_GRID_MAX_ROWS;
+
+    uint32_t cells = (uint32_t)g->cols * g->rows;
+    uint16_t cell_of[MAX_MODULES_PER_SHIP];
+    uint8_t  fill[SHIP_MODULE_GRID_MAX_COLS * SHIP_MODULE_GRID_MAX_ROWS + 1];
+    memset(fill, 0, (cells + 1) * sizeof(uint8_t));
+    for (uint8_t k = 0; k < n; k++) {
+        uint32_t cx = (uint32_t)((mx[k] - min_x) * g->inv_cell);
+        uint32_t cy = (uint32_t)((my[k] - min_y) * g->inv_cell);
+        if (cx >= g->cols) cx = g->cols - 1u;
+        if (cy >= g->rows) cy = g->rows - 1u;
+        cell_of[k] = (uint16_t)(cy * g->cols + cx);
+        fill[cell_of[k]]++;
+    }
+
+    g->start[0] = 0;
+    for (uint32_t c = 0; c < cells; c++) g->start[c + 1] = (uint8_t)(g->start[c] + fill[c]);
+    memcpy(fill, g->start, cells * sizeof(uint8_t));
+    for (uint8_t k = 0; k < n; k++) {   /* k ascends, so each cell stays sorted */
+        uint8_t at = fill[cell_of[k]]++;
+        g->refs[at]  = idx[k];
+        g->ref_x[at] = mx[k];
+        g->ref_y[at] = my[k];
+    }
+}
+
+static inline int32_t clamp_cell(float v, uint8_t limit) {
+    if (v < 0.0f) return 0;
+    int32_t c = (int32_t)v;
+    return c >= (int32_t)limit ? (int32_t)limit - 1 : c;
+}
+
+uint8_t ship_module_grid_query(const ShipModuleGrid* g, float x, float y, float reach,
+                               uint8_t out[MAX_MODULES_PER_SHIP]) {
+    if (g->cols == 0 || g->rows == 0) return 0;
+    float lo_x = (x - reach - g->origin_x) * g->inv_cell;
+    float hi_x = (x + reach - g->origin_x) * g->inv_cell;
+    float lo_y = (y - reach - g->origin_y) * g->inv_cell;
+    float hi_y = (y + reach - g->origin_y) * g->inv_cell;
+    if (hi_x < 0.0f || hi_y < 0.0f || lo_x >= (float)g->cols || lo_y >= (float)g->rows)
+        return 0;
+
+    int32_t cx0 = clamp_cell(lo_x, g->cols), cx1 = clamp_cell(hi_x, g->cols);
+    int32_t cy0 = clamp_cell(lo_y, g->rows), cy1 = clamp_cell(hi_y, g->rows);
+    uint8_t n = 0;
+    for (int32_t cy = cy0; cy <= cy1; cy++) {
+        for (int32_t cx = cx0; cx <= cx1; cx++) {
+            uint32_t c = (uint32_t)cy * g->cols + (uint32_t)cx;
+            for (uint8_t k = g->start[c]; k < g->start[c + 1]; k++) {
+                if (fabsf(g->ref_x[k] - x) > reach || fabsf(g->ref_y[k] - y) > reach) continue;
+                out[n++] = g->refs[k];
+            }
+        }
+    }
+    /* Callers resolve in modules[] order, as the full scans did */
+    for (uint8_t i = 1; i < n; i++) {
+        uint8_t v = out[i];
+        uint8_t j = i;
+        for (; j > 0 && out[j - 1] > v; j--) out[j] = out[j - 1];
+        out[j] = v;
+    }
+    return n;
+}
@@ -2,6 +2,7 @@
 #include "net/crafting.h"
 #include "net/quality.h"
 #include "net/websocket_server_internal.h"
+#include "net/structure_index.h"
 #include "net/websocket_protocol.h"
 #include "util/log.h"
 #include "util/time.h"
@@ -266,13 +267,10 @@ bool ship_has_workbench(const SimpleShip* ship) {
 
 static int spawn_schematic_wreck_batch(float wx, float wy, int batch_idx,
                                        const ShipPoolBlueprint* batch, int batch_count) {
-    if (batch_count <= 0 || placed_structure_count >= MAX_PLACED_STRUCTURES) return 0;
+    if (batch_count <= 0) return 0;
 
-    PlacedStructure* w = &placed_structures[placed_structure_count];
-    memset(w, 0, sizeof(*w));
-    w->active           = true;
-    w->id               = next_structure_id++;
-    w->type             = STRUCT_WRECK;
+    PlacedStructure* w = structure_alloc(STRUCT_WRECK);
+    if (!w) return 0;
     {
         float ang = (float)batch_idx * 0.85f;
         w->x = wx + cosf(ang) * 18.0f;
@@ -298,7 +296,6 @@ static int spawn_schematic_wreck_batch(float wx, float wy, int batch_idx,
     }
 
     snprintf(w->placer_name, sizeof(w->placer_name), "workbench_ruin");
-    placed_structure_count++;
 
     char wbcast[280];
     snprintf(wbcast, sizeof(wbcast),
@@ -1,51 +1,252 @@
 #include "net/structure_index.h"
 #include "net/websocket_server_internal.h"
+#include <math.h>
+#include <stdlib.h>
 #include <string.h>
 
-#define STRUCT_ID_INDEX_CAP      512
+#define STRUCT_ID_SPACE          65536   /* PlacedStructure.id is a uint16_t */
+#define STRUCT_TYPE_COUNT        (STRUCT_BED + 1)
 #define SHIP_SCAFFOLD_INDEX_CAP  512
 
-static int16_t  struct_id_to_idx[STRUCT_ID_INDEX_CAP];
-static int16_t  ship_scaffold_to_idx[SHIP_SCAFFOLD_INDEX_CAP];
-static uint32_t shipyard_slots[MAX_PLACED_STRUCTURES];
-static uint32_t shipyard_count;
-static uint32_t chest_slots[MAX_PLACED_STRUCTURES];
-static uint32_t chest_count;
+_Static_assert(MAX_PLACED_STRUCTURES <= 65536, "StructureHandle keeps the slot in 16 bits");
+
+/* id → placed_structures[] slot for every slot below placed_structure_count
+ * with a nonzero id, active or not (a destroyed structure keeps its slot and
+ * id until the slot is reused).  Entries are only trusted after checking the
+ * slot still holds that id, so a stale entry reads as "not found". */
+static int32_t  struct_id_to_idx[STRUCT_ID_SPACE];
+static uint32_t index_built_for = UINT32_MAX;   /* placed_structure_count at build */
+
+/* Slot map.  slot_gen[] counts occupancies of each slot (0 = never used);
+ * live_pos[]/type_pos[] locate a live slot in its dense lists for O(1)
+ * swap-removal.  Freed slots wait in retired_slots[] until the next reclaim. */
+static uint16_t slot_gen[MAX_PLACED_STRUCTURES];
+static uint32_t live_slots[MAX_PLACED_STRUCTURES];
+static uint32_t live_count;
+static uint32_t live_pos[MAX_PLACED_STRUCTURES];
+static uint32_t type_slots[STRUCT_TYPE_COUNT][MAX_PLACED_STRUCTURES];
+static uint32_t type_count[STRUCT_TYPE_COUNT];
+static uint32_t type_pos[MAX_PLACED_STRUCTURES];
+static uint32_t free_slots[MAX_PLACED_STRUCTURES];
+static uint32_t free_count;
+static uint32_t retired_slots[MAX_PLACED_STRUCTURES];
+static uint32_t retired_count;
+static uint32_t type_epoch[STRUCT_TYPE_COUNT];
+
+static int32_t  ship_scaffold_to_idx[SHIP_SCAFFOLD_INDEX_CAP];
+
+static bool claim_grid_dirty = true;
+static void claim_grid_build(void);
+
+static void place_grid_reset(void);
+static void place_grid_added(uint32_t slot);
+static void place_grid_removed(uint32_t slot);
+
+static inline bool type_listed(PlacedStructureType t) {
+    return (unsigned)t < STRUCT_TYPE_COUNT;
+}
+
+static void link_live(uint32_t slot) {
+    PlacedStructure *s = &placed_structures[slot];
+    live_pos[slot] = live_count;
+    live_slots[live_count++] = slot;
+    if (type_listed(s->type)) {
+        type_epoch[s->type]++;
+        type_pos[slot] = type_count[s->type];
+        type_slots[s->type][type_count[s->type]++] = slot;
+    }
+}
+
+static void unlink_live(uint32_t slot) {
+    PlacedStructure *s = &placed_structures[slot];
+    uint32_t last = live_slots[--live_count];
+    live_slots[live_pos[slot]] = last;
+    live_pos[last] = live_pos[slot];
+    if (type_listed(s->type)) {
+        type_epoch[s->type]++;
+        uint32_t *list = type_slots[s->type];
+        last = list[--type_count[s->type]];
+        list[type_pos[slot]] = last;
+        type_pos[last] = type_pos[slot];
+    }
+}
 
 void structure_index_rebuild(void)
 {
-    for (int i = 0; i < STRUCT_ID_INDEX_CAP; i++) struct_id_to_idx[i] = -1;
+    for (uint32_t i = 0; i < STRUCT_ID_SPACE; i++) struct_id_to_idx[i] = -1;
+    index_built_for = placed_structure_count;
+
     for (int i = 0; i < SHIP_SCAFFOLD_INDEX_CAP; i++) ship_scaffold_to_idx[i] = -1;
-    shipyard_count = 0;
-    chest_count    = 0;
+    live_count    = 0;
+    free_count    = 0;
+    retired_count = 0;
+    memset(type_count, 0, sizeof(type_count));
+    for (int t = 0; t < STRUCT_TYPE_COUNT; t++) type_epoch[t]++;
+    place_grid_reset();
 
     for (uint32_t i = 0; i < placed_structure_count; i++) {
         PlacedStructure *s = &placed_structures[i];
-        if (!s->active) continue;
 
-        if (s->id > 0 && s->id < STRUCT_ID_INDEX_CAP)
-            struct_id_to_idx[s->id] = (int16_t)i;
+        /* Active occupant wins over a dead slot still holding the same id */
+        if (s->id != 0 && (struct_id_to_idx[s->id] < 0 || s->active))
+            struct_id_to_idx[s->id] = (int32_t)i;
+        if (!s->active) {
+            free_slots[free_count++] = i;
+            continue;
+        }
+        if (slot_gen[i] == 0) slot_gen[i] = 1;
+        link_live(i);
+        place_grid_added(i);
 
-        if (s->type == STRUCT_SHIPYARD) {
-            if (shipyard_count < MAX_PLACED_STRUCTURES)
-                shipyard_slots[shipyard_count++] = i;
-            if (s->scaffolded_ship_id > 0 &&
-                s->scaffolded_ship_id < SHIP_SCAFFOLD_INDEX_CAP) {
-                ship_scaffold_to_idx[s->scaffolded_ship_id] = (int16_t)i;
-            }
-        } else if (s->type == STRUCT_CHEST) {
-            if (chest_count < MAX_PLACED_STRUCTURES)
-                chest_slots[chest_count++] = i;
+        if (s->type == STRUCT_SHIPYARD && s->scaffolded_ship_id > 0 &&
+            s->scaffolded_ship_id < SHIP_SCAFFOLD_INDEX_CAP) {
+            ship_scaffold_to_idx[s->scaffolded_ship_id] = (int32_t)i;
         }
     }
+    /* Hand out low slots first */
+    for (uint32_t a = 0, b = free_count; a + 1 < b; a++, b--) {
+        uint32_t t = free_slots[a];
+        free_slots[a] = free_slots[b - 1];
+        free_slots[b - 1] = t;
+    }
+
+    claim_grid_dirty = true;
+}
+
+/* Silent appends (tests, older loaders) only ever grow the array, so a count
+ * change is enough to notice them. */
+static inline void index_sync(void) {
+    if (index_built_for != placed_structure_count) structure_index_rebuild();
+}
+
+bool structure_store_has_room(void)
+{
+    index_sync();
+    return free_count > 0 || retired_count > 0 ||
+           placed_structure_count < MAX_PLACED_STRUCTURES;
+}
+
+void structure_store_reclaim(void)
+{
+    while (retired_count > 0) free_slots[free_count++] = retired_slots[--retired_count];
+}
+
+/* next_structure_id wraps at 65535: skip 0 and ids a slot still holds */
+static uint16_t next_free_id(void)
+{
+    for (;;) {
+        uint16_t id = next_structure_id++;
+        if (id == 0) continue;
+        int32_t idx = struct_id_to_idx[id];
+        if (idx >= 0 && (uint32_t)idx < placed_structure_count &&
+            placed_structures[idx].id == id) continue;
+        return id;
+    }
+}
+
+PlacedStructure *structure_alloc(PlacedStructureType type)
+{
+    index_sync();
+    uint32_t slot;
+    if (free_count > 0) {
+        slot = free_slots[--free_count];
+    } else if (placed_structure_count < MAX_PLACED_STRUCTURES) {
+        slot = placed_structure_count++;
+        index_built_for = placed_structure_count;
+    } else if (retired_count > 0) {
+        /* Full: reuse this tick's frees rather than refuse the placement */
+        slot = retired_slots[--retired_count];
+    } else {
+        log_warn("⚠️ Structure store full (%d slots): no room for a type %d structure",
+                 MAX_PLACED_STRUCTURES, (int)type);
+        return NULL;
+    }
+
+    PlacedStructure *s = &placed_structures[slot];
+    memset(s, 0, sizeof(*s));
+    s->active = true;
+    s->type   = type;
+    s->id     = next_free_id();
+    struct_id_to_idx[s->id] = (int32_t)slot;
+    if (++slot_gen[slot] == 0) slot_gen[slot] = 1;
+    link_live(slot);
+    place_grid_added(slot);
+    claim_grid_dirty = true;
+    return s;
+}
+
+void structure_free(PlacedStructure *s)
+{
+    uint32_t slot = (uint32_t)(s - placed_structures);
+    if (slot >= placed_structure_count || !s->active) return;
+    index_sync();
+    s->active = false;
+    unlink_live(slot);
+    place_grid_removed(slot);
+    retired_slots[retired_count++] = slot;
+    claim_grid_dirty = true;
+}
+
+StructureHandle structure_handle(const PlacedStructure *s)
+{
+    uint32_t slot = (uint32_t)(s - placed_structures);
+    return ((uint32_t)slot_gen[slot] << 16) | slot;
+}
+
+PlacedStructure *structure_from_handle(StructureHandle h)
+{
+    uint32_t slot = h & 0xFFFFu;
+    if (h == 0 || slot >= placed_structure_count) return NULL;
+    if (slot_gen[slot] != (uint16_t)(h >> 16)) return NULL;
+    PlacedStructure *s = &placed_structures[slot];
+    return s->active ? s : NULL;
+}
+
+const uint32_t *structure_live_slots(uint32_t *count)
+{
+    index_sync();
+    *count = live_count;
+    return live_slots;
+}
+
+const uint32_t *structure_slots_of_type(PlacedStructureType type, uint32_t *count)
+{
+    index_sync();
+    if (!type_listed(type)) { *count = 0; return live_slots; }
+    *count = type_count[type];
+    return type_slots[type];
+}
+
+uint32_t structure_type_epoch(PlacedStructureType type)
+{
+    index_sync();
+    return type_listed(type) ? type_epoch[type] : 0;
+}
+
+PlacedStructure *structure_by_id_any(uint32_t id)
+{
+    if (id == 0 || id >= STRUCT_ID_SPACE) return NULL;
+    index_sync();
+    int32_t idx = struct_id_to_idx[id];
+    if (idx < 0 || (uint32_t)idx >= placed_structure_count) return NULL;
+    PlacedStructure *s = &placed_structures[idx];
+    return s->id == id ? s : NULL;
+}
+
+PlacedStructure *structure_by_id(uint32_t id)
+{
+    PlacedStructure *s = structure_by_id_any(id);
+    return (s && s->active) ? s : NULL;
 }
 
 PlacedStructure *shipyard_by_scaffolded_ship(uint32_t ship_id)
 {
     if (ship_id == 0) return NULL;
-    if (ship_id < SHIP_SCAFFOLD_INDEX_CAP) {
-        int16_t idx = ship_scaffold_to_idx[ship_id];
-        if (idx >= 0) {
+    index_sync();
+    bool cacheable = ship_id < SHIP_SCAFFOLD_INDEX_CAP;
+    if (cacheable) {
+        int32_t idx = ship_scaffold_to_idx[ship_id];
+        if (idx >= 0 && (uint32_t)idx < placed_structure_count) {
             PlacedStructure *s = &placed_structures[(uint32_t)idx];
             if (s->active && s->type == STRUCT_SHIPYARD &&
                 s->scaffolded_ship_id == ship_id) {
@@ -53,35 +254,334 @@ PlacedStructure *shipyard_by_scaffolded_ship(uint32_t ship_id)
             }
         }
     }
-    for (uint32_t i = 0; i < shipyard_count; i++) {
-        PlacedStructure *s = &placed_structures[shipyard_slots[i]];
-        if (s->active && s->scaffolded_ship_id == ship_id) return s;
+    /* scaffolded_ship_id is edited in place; fall back and remember */
+    uint32_t n;
+    const uint32_t *yards = structure_slots_of_type(STRUCT_SHIPYARD, &n);
+    for (uint32_t i = 0; i < n; i++) {
+        PlacedStructure *s = &placed_structures[yards[i]];
+        if (s->scaffolded_ship_id != ship_id) continue;
+        if (cacheable) ship_scaffold_to_idx[ship_id] = (int32_t)yards[i];
+        return s;
     }
     return NULL;
 }
 
 PlacedStructure *shipyard_by_id(uint16_t struct_id)
 {
-    if (struct_id == 0) return NULL;
-    if (struct_id < STRUCT_ID_INDEX_CAP) {
-        int16_t idx = struct_id_to_idx[struct_id];
-        if (idx >= 0) {
-            PlacedStructure *s = &placed_structures[(uint32_t)idx];
-            if (s->active && s->type == STRUCT_SHIPYARD && s->id == struct_id)
-                return s;
+    PlacedStructure *s = structure_by_id(struct_id);
+    return (s && s->type == STRUCT_SHIPYARD) ? s : NULL;
+}
+
+/* ── Claim territory grid ─────────────────────────────────────────────────── */
+
+/* Hash grid of claim-circle coverage.  Every active structure is entered in
+ * each cell its largest possible claim circle touches; cells hold slot
+ * indices in slot order so callers that take the first match see the same
+ * structure a full scan would.  Company, orphan state and exact radius are
+ * left to the caller — captures and orphaning flip those in place without
+ * touching the index.  Structures never move, so only alloc/free and
+ * wholesale rebuilds change it; those mark it dirty and the next query
+ * rebuilds it. */
+
+#define CLAIM_GRID_CELL    512.0f
+#define CLAIM_GRID_RADIUS  (CLAIM_RADIUS_FLAG_FORT > CLAIM_RADIUS_COMPANY_FORT \
+                            ? (CLAIM_RADIUS_FLAG_FORT > CLAIM_RADIUS_DEFAULT ? CLAIM_RADIUS_FLAG_FORT : CLAIM_RADIUS_DEFAULT) \
+                            : (CLAIM_RADIUS_COMPANY_FORT > CLAIM_RADIUS_DEFAULT ? CLAIM_RADIUS_COMPANY_FORT : CLAIM_RADIUS_DEFAULT))
+
+typedef struct {
+    int32_t  cx, cy;
+    uint32_t start;      /* Offset into claim_grid_slots                */
+    uint32_t count;
+    bool     used;
+} ClaimCell;
+
+static ClaimCell *claim_cells;
+static uint32_t   claim_cell_cap;      /* Power of two                      */
+static uint32_t  *claim_grid_slots;
+static uint32_t   claim_grid_slot_cap;
+
+static inline uint32_t claim_cell_hash(int32_t cx, int32_t cy) {
+    uint32_t h = (uint32_t)cx * 0x9E3779B1u ^ (uint32_t)cy * 0x85EBCA77u;
+    return h ^ (h >> 15);
+}
+
+static inline int32_t claim_cell_coord(float v) {
+    return (int32_t)floorf(v / CLAIM_GRID_CELL);
+}
+
+/* Bucket for (cx,cy): the occupied one, or the empty one it would go in. */
+static ClaimCell *claim_cell_slot(int32_t cx, int32_t cy) {
+    uint32_t mask = claim_cell_cap - 1;
+    for (uint32_t h = claim_cell_hash(cx, cy) & mask;; h = (h + 1) & mask) {
+        ClaimCell *c = &claim_cells[h];
+        if (!c->used || (c->cx == cx && c->cy == cy)) return c;
+    }
+}
+
+/* Returns false when the table needs to grow. */
+static bool claim_grid_count_pass(uint32_t *cells_used, uint32_t *entries) {
+    *cells_used = 0;
+    *entries    = 0;
+    for (uint32_t i = 0; i < placed_structure_count; i++) {
+        const PlacedStructure *s = &placed_structures[i];
+        if (!s->active) continue;
+        int32_t x0 = claim_cell_coord(s->x - CLAIM_GRID_RADIUS), x1 = claim_cell_coord(s->x + CLAIM_GRID_RADIUS);
+        int32_t y0 = claim_cell_coord(s->y - CLAIM_GRID_RADIUS), y1 = claim_cell_coord(s->y + CLAIM_GRID_RADIUS);
+        for (int32_t cy = y0; cy <= y1; cy++)
+            for (int32_t cx = x0; cx <= x1; cx++) {
+                ClaimCell *c = claim_cell_slot(cx, cy);
+                if (!c->used) {
+                    /* Keep load under one half so probes stay short */
+                    if (++*cells_used * 2 > claim_cell_cap) return false;
+                    c->used = true;
+                    c->cx = cx;
+                    c->cy = cy;
+                }
+                c->count++;
+                (*entries)++;
+            }
+    }
+    return true;
+}
+
+static void claim_grid_build(void) {
+    if (claim_cell_cap == 0) claim_cell_cap = 256;
+
+    uint32_t cells_used, entries;
+    for (;;) {
+        if (!claim_cells) {
+            claim_cells = calloc(claim_cell_cap, sizeof(ClaimCell));
+            if (!claim_cells) goto oom;
+        } else {
+            memset(claim_cells, 0, claim_cell_cap * sizeof(ClaimCell));
         }
+        if (claim_grid_count_pass(&cells_used, &entries)) break;
+        free(claim_cells);
+        claim_cells = NULL;
+        claim_cell_cap *= 2;
+    }
+
+    if (entries > claim_grid_slot_cap) {
+        uint32_t cap = claim_grid_slot_cap ? claim_grid_slot_cap : 1024;
+        while (cap < entries) cap *= 2;
+        uint32_t *grown = realloc(claim_grid_slots, cap * sizeof(uint32_t));
+        if (!grown) goto oom;
+        claim_grid_slots    = grown;
+        claim_grid_slot_cap = cap;
     }
-    /* Fallback: next_structure_id is monotonic and never reused, so ids can
-     * exceed STRUCT_ID_INDEX_CAP on long-running servers. */
-    for (uint32_t i = 0; i < shipyard_count; i++) {
-        PlacedStructure *s = &placed_structures[shipyard_slots[i]];
-        if (s->active && s->id == struct_id) return s;
+
+    /* Counts → start offsets; count is reused as the fill cursor */
+    uint32_t off = 0;
+    for (uint32_t h = 0; h < claim_cell_cap; h++) {
+        ClaimCell *c = &claim_cells[h];
+        if (!c->used) continue;
+        c->start = off;
+        off += c->count;
+        c->count = 0;
     }
-    return NULL;
+
+    /* Second pass fills the cells in slot order */
+    for (uint32_t i = 0; i < placed_structure_count; i++) {
+        const PlacedStructure *s = &placed_structures[i];
+        if (!s->active) continue;
+        int32_t x0 = claim_cell_coord(s->x - CLAIM_GRID_RADIUS), x1 = claim_cell_coord(s->x + CLAIM_GRID_RADIUS);
+        int32_t y0 = claim_cell_coord(s->y - CLAIM_GRID_RADIUS), y1 = claim_cell_coord(s->y + CLAIM_GRID_RADIUS);
+        for (int32_t cy = y0; cy <= y1; cy++)
+            for (int32_t cx = x0; cx <= x1; cx++) {
+                ClaimCell *c = claim_cell_slot(cx, cy);
+                claim_grid_slots[c->start + c->count++] = i;
+            }
+    }
+    return;
+
+oom:
+    log_error("❌ Claim grid: out of memory for %u structures", placed_structure_count);
+    free(claim_cells);
+    claim_cells    = NULL;
+    claim_cell_cap = 0;
 }
 
-uint32_t structure_index_shipyard_count(void) { return shipyard_count; }
-const uint32_t *structure_index_shipyard_slots(void) { return shipyard_slots; }
+const uint32_t *structure_index_claim_candidates(float wx, float wy, uint32_t *count)
+{
+    *count = 0;
+    index_sync();
+    if (claim_grid_dirty) {
+        claim_grid_build();
+        claim_grid_dirty = false;
+    }
+    if (!claim_cells) return NULL;
+    ClaimCell *c = claim_cell_slot(claim_cell_coord(wx), claim_cell_coord(wy));
+    if (!c->used) return NULL;
+    *count = c->count;
+    return &claim_grid_slots[c->start];
+}
+
+/* ── Placement grid ───────────────────────────────────────────────────────── */
+
+/* Open-addressed cells, each heading an intrusive list of the slots whose
+ * centre falls in it.  Unlike the claim grid this one is maintained in
+ * place: structure_free() unlinks at once, while a fresh structure — whose
+ * position its caller fills in after structure_alloc() returns — waits on a
+ * pending list and is filed on the next query.  Structures never move.
+ * Cells are never removed; the table is re-hashed when it fills up and
+ * emptied by structure_index_rebuild(). */
+
+#define PLACE_NONE     0
+#define PLACE_PENDING  1
+#define PLACE_LINKED   2
+
+typedef struct {
+    int32_t cx, cy;
+    int32_t head;        /* First slot, -1 when empty */
+    bool    used;
+} PlaceCell;
+
+static PlaceCell *place_cells;
+static uint32_t   place_cell_cap;       /* Power of two                      */
+static uint32_t   place_cells_used;
+static int32_t    place_next[MAX_PLACED_STRUCTURES];
+static int32_t    place_prev[MAX_PLACED_STRUCTURES];
+static uint32_t   place_cell_of[MAX_PLACED_STRUCTURES];
+static uint8_t    place_state[MAX_PLACED_STRUCTURES];
+static uint32_t   place_pending[MAX_PLACED_STRUCTURES];
+static uint32_t   place_pending_count;
 
-uint32_t structure_index_chest_count(void) { return chest_count; }
-const uint32_t *structure_index_chest_slots(void) { return chest_slots; }
+static PlaceCell *place_cell_slot(int32_t cx, int32_t cy) {
+    uint32_t mask = place_cell_cap - 1;
+    for (uint32_t h = claim_cell_hash(cx, cy) & mask;; h = (h + 1) & mask) {
+        PlaceCell *c = &place_cells[h];
+        if (!c->used || (c->cx == cx && c->cy == cy)) return c;
+    }
+}
+
+static void place_link(uint32_t slot) {
+    const PlacedStructure *s = &placed_structures[slot];
+    PlaceCell *c = place_cell_slot(structure_cell(s->x), structure_cell(s->y));
+    if (!c->used) {
+        c->used = true;
+        c->cx   = structure_cell(s->x);
+        c->cy   = structure_cell(s->y);
+        c->head = -1;
+        place_cells_used++;
+    }
+    place_cell_of[slot] = (uint32_t)(c - place_cells);
+    place_prev[slot] = -1;
+    place_next[slot] = c->head;
+    if (c->head >= 0) place_prev[c->head] = (int32_t)slot;
+    c->head = (int32_t)slot;
+    place_state[slot] = PLACE_LINKED;
+}
+
+static void place_unlink(uint32_t slot) {
+    if (place_prev[slot] >= 0) place_next[place_prev[slot]] = place_next[slot];
+    else                       place_cells[place_cell_of[slot]].head = place_next[slot];
+    if (place_next[slot] >= 0) place_prev[place_next[slot]] = place_prev[slot];
+    place_state[slot] = PLACE_NONE;
+}
+
+/* (Re)allocate the table at `cap` cells and file every linked slot again.
+ * False (table dropped, queries fall back to a scan) when out of memory. */
+static bool place_grid_alloc(uint32_t cap) {
+    uint32_t linked = 0;
+    for (uint32_t i = 0; i < placed_structure_count; i++) linked += place_state[i] == PLACE_LINKED;
+    while (cap < 2 * (linked + 1)) cap *= 2;
+    free(place_cells);
+    place_cells      = calloc(cap, sizeof(PlaceCell));
+    place_cell_cap   = place_cells ? cap : 0;
+    place_cells_used = 0;
+    if (!place_cells) {
+        log_error("❌ Placement grid: out of memory for %u cells", cap);
+        return false;
+    }
+    for (uint32_t i = 0; i < placed_structure_count; i++)
+        if (place_state[i] == PLACE_LINKED) place_link(i);
+    return true;
+}
+
+static void place_grid_reset(void) {
+    memset(place_state, PLACE_NONE, sizeof(place_state));
+    place_pending_count = 0;
+    if (place_cells) memset(place_cells, 0, place_cell_cap * sizeof(PlaceCell));
+    place_cells_used = 0;
+}
+
+static void place_grid_added(uint32_t slot) {
+    if (place_state[slot] == PLACE_LINKED) place_unlink(slot);
+    if (place_state[slot] == PLACE_PENDING) return;   /* freed and re-taken before a flush */
+    place_state[slot] = PLACE_PENDING;
+    place_pending[place_pending_count++] = slot;
+}
+
+static void place_grid_removed(uint32_t slot) {
+    /* A pending slot is dropped by the flush once it sees it inactive */
+    if (place_state[slot] == PLACE_LINKED) place_unlink(slot);
+}
+
+/* File everything allocated since the last query */
+static bool place_grid_flush(void) {
+    if (!place_cells && !place_grid_alloc(1024)) return false;
+    for (uint32_t k = 0; k < place_pending_count; k++) {
+        uint32_t slot = place_pending[k];
+        if (place_state[slot] != PLACE_PENDING) continue;
+        if (slot >= placed_structure_count || !placed_structures[slot].active) {
+            place_state[slot] = PLACE_NONE;
+            continue;
+        }
+        /* Keep load under one half so probes stay short */
+        if ((place_cells_used + 1) * 2 > place_cell_cap && !place_grid_alloc(place_cell_cap * 2))
+            return false;
+        place_link(slot);
+    }
+    place_pending_count = 0;
+    return true;
+}
+
+static void near_push(StructureNear *out, uint32_t slot) {
+    if (out->count == out->cap) {
+        uint32_t cap = out->cap ? out->cap * 2 : 64;
+        uint32_t *grown = realloc(out->slots, cap * sizeof(uint32_t));
+        if (!grown) {
+            log_error("❌ Placement grid: out of memory for %u results", cap);
+            return;
+        }
+        out->slots = grown;
+        out->cap   = cap;
+    }
+    out->slots[out->count++] = slot;
+}
+
+uint32_t structure_index_near(StructureNear *out, float wx, float wy, float r, uint32_t type_mask)
+{
+    out->count = 0;
+    index_sync();
+    int32_t x0 = structure_cell(wx - r), x1 = structure_cell(wx + r);
+    int32_t y0 = structure_cell(wy - r), y1 = structure_cell(wy + r);
+
+    if (!place_grid_flush()) {
+        for (uint32_t k = 0; k < live_count; k++) {
+            uint32_t slot = live_slots[k];
+            const PlacedStructure *s = &placed_structures[slot];
+            if (type_mask && !(type_mask & STRUCT_MASK(s->type))) continue;
+            int32_t cx = structure_cell(s->x), cy = structure_cell(s->y);
+            if (cx >= x0 && cx <= x1 && cy >= y0 && cy <= y1) near_push(out, slot);
+        }
+    } else {
+        for (int32_t cy = y0; cy <= y1; cy++)
+            for (int32_t cx = x0; cx <= x1; cx++) {
+                const PlaceCell *c = place_cell_slot(cx, cy);
+                if (!c->used) continue;
+                for (int32_t i = c->head; i >= 0; i = place_next[i]) {
+                    if (type_mask && !(type_mask & STRUCT_MASK(placed_structures[i].type))) continue;
+                    near_push(out, (uint32_t)i);
+                }
+            }
+    }
+
+    /* Slot order, so first-match callers see what a full scan would */
+    for (uint32_t a = 1; a < out->count; a++) {
+        uint32_t v = out->slots[a], b = a;
+        for (; b > 0 && out->slots[b - 1] > v; b--) out->slots[b] = out->slots[b - 1];
+        out->slots[b] = v;
+    }
+    return out->count;
+}
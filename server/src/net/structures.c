@@ -22,112 +22,87 @@
 #include "sim/island.h"
 #include "sim/simulation.h"
 #include "util/time.h"
-
-/* ── Spatial hash for ceiling-connectivity flood-fill (O(N) cascade) ─────────
- * Tiles sit on a 50-px grid; walls sit at edge midpoints (25-px offset). We key
- * by 25-px cells so both ceilings and walls/door_frames have unique integer
- * coordinates. Open-addressing linear-probe hash, capacity = MAX_PLACED_STRUCTURES*4
- * (load factor ≤ 0.25, no resize ever needed). */
-#define CELL_HASH_CAP (MAX_PLACED_STRUCTURES * 4)
-typedef struct { int32_t cx, cy, idx; } CellEntry;
-
-static inline int32_t cell_x(float x) { return (int32_t)lroundf(x / 25.0f); }
-static inline int32_t cell_y(float y) { return (int32_t)lroundf(y / 25.0f); }
-
-static inline uint32_t cell_hash(int32_t cx, int32_t cy) {
-    uint32_t h = (uint32_t)cx * 2654435761u ^ (uint32_t)cy * 40503u;
-    return h & (CELL_HASH_CAP - 1);
-}
-
-static void cell_put(CellEntry *t, int32_t cx, int32_t cy, int32_t idx) {
-    uint32_t h = cell_hash(cx, cy);
-    while (t[h].idx >= 0) {
-        if (t[h].cx == cx && t[h].cy == cy) { t[h].idx = idx; return; }
-        h = (h + 1) & (CELL_HASH_CAP - 1);
-    }
-    t[h].cx = cx; t[h].cy = cy; t[h].idx = idx;
-}
-
-static int32_t cell_get(const CellEntry *t, int32_t cx, int32_t cy) {
-    uint32_t h = cell_hash(cx, cy);
-    while (t[h].idx >= 0) {
-        if (t[h].cx == cx && t[h].cy == cy) return t[h].idx;
-        h = (h + 1) & (CELL_HASH_CAP - 1);
-    }
-    return -1;
-}
+#include "util/timer_wheel.h"
 
 /*
- * cascade_orphan_ceilings — flood-fill from walls/door_frames through edge-adjacent
- * ceilings; demolish any ceiling not reachable to a wall.
+ * cascade_orphan_ceilings — demolish every ceiling near (fx,fy) that can no
+ * longer reach a wall/door_frame through edge-adjacent ceilings.
  *
- * O(N) using two spatial hashes (walls + ceilings) and a BFS queue. Ceilings are
- * square 50×50 tiles, so rotation only permutes the 4 edge offsets — they always
- * map to the same set of 4 cells regardless of placement angle.
+ * Flood-fills from each ceiling within seed_r of the removed piece through the
+ * placement grid: a group with a wall at any member's edge midpoint stands,
+ * a group without one comes down.  Groups away from the removal are left
+ * alone — they kept whatever support they had.  Cost is the size of the
+ * groups touched, not the world.  Tiles sit on a 50-px grid and walls at edge
+ * midpoints, so in 25-px cells a ceiling's walls are ±1 cell away and its
+ * neighbours ±2; rotation only permutes the 4 offsets.
  *
  * Caller must already have removed/marked-inactive the wall that triggered this.
  */
-static void cascade_orphan_ceilings(uint32_t trigger_id, const char *trigger_kind) {
-    static CellEntry walls[CELL_HASH_CAP];
-    static CellEntry ceils[CELL_HASH_CAP];
-    static int32_t   queue[MAX_PLACED_STRUCTURES];
-    static bool      reached[MAX_PLACED_STRUCTURES];
-
-    for (uint32_t i = 0; i < CELL_HASH_CAP; i++) { walls[i].idx = -1; ceils[i].idx = -1; }
-    for (uint32_t i = 0; i < placed_structure_count; i++) reached[i] = false;
-    int32_t qh = 0, qt = 0;
-
-    /* Build wall-support map */
-    for (uint32_t i = 0; i < placed_structure_count; i++) {
-        const PlacedStructure *s = &placed_structures[i];
-        if (!s->active) continue;
-        if (s->type != STRUCT_WALL && s->type != STRUCT_DOOR_FRAME) continue;
-        cell_put(walls, cell_x(s->x), cell_y(s->y), (int32_t)i);
+static bool ceiling_has_wall(int32_t cx, int32_t cy) {
+    static StructureNear walls;
+    const uint32_t mask = STRUCT_MASK(STRUCT_WALL) | STRUCT_MASK(STRUCT_DOOR_FRAME);
+    const int32_t dx[4] = { 0, 0, -1, 1 };
+    const int32_t dy[4] = { -1, 1, 0, 0 };
+    for (int k = 0; k < 4; k++) {
+        float ex = (float)(cx + dx[k]) * STRUCTURE_CELL_PX;
+        float ey = (float)(cy + dy[k]) * STRUCTURE_CELL_PX;
+        if (structure_index_near(&walls, ex, ey, 0.0f, mask) > 0) return true;
     }
+    return false;
+}
 
-    /* Build ceiling map and seed the queue with directly-supported ceilings */
-    for (uint32_t i = 0; i < placed_structure_count; i++) {
-        const PlacedStructure *c = &placed_structures[i];
-        if (!c->active || c->type != STRUCT_CEILING) continue;
-        int32_t cx = cell_x(c->x), cy = cell_y(c->y);
-        cell_put(ceils, cx, cy, (int32_t)i);
-        if (cell_get(walls, cx,     cy - 1) >= 0 ||
-            cell_get(walls, cx,     cy + 1) >= 0 ||
-            cell_get(walls, cx - 1, cy    ) >= 0 ||
-            cell_get(walls, cx + 1, cy    ) >= 0) {
-            reached[i] = true;
-            queue[qt++] = (int32_t)i;
-        }
+static void cascade_orphan_ceilings(float fx, float fy, float seed_r,
+                                    uint32_t trigger_id, const char *trigger_kind) {
+    static StructureNear seeds, adj;
+    static int32_t   queue[MAX_PLACED_STRUCTURES];
+    static uint32_t  visited[MAX_PLACED_STRUCTURES];   /* == visit_epoch once reached */
+    static uint32_t  visit_epoch;
+    const uint32_t ceil_mask = STRUCT_MASK(STRUCT_CEILING);
+
+    if (++visit_epoch == 0) {
+        memset(visited, 0, sizeof(visited));
+        visit_epoch = 1;
     }
+    structure_index_near(&seeds, fx, fy, seed_r, ceil_mask);
+    for (uint32_t k = 0; k < seeds.count; k++) {
+        uint32_t seed = seeds.slots[k];
+        if (visited[seed] == visit_epoch) continue;
 
-    /* BFS: spread reachability through edge-adjacent ceilings (Δ = ±2 cells = ±50px) */
-    while (qh < qt) {
-        int32_t ai = queue[qh++];
-        const PlacedStructure *a = &placed_structures[ai];
-        int32_t cx = cell_x(a->x), cy = cell_y(a->y);
-        const int32_t dx[4] = {  2, -2,  0,  0 };
-        const int32_t dy[4] = {  0,  0,  2, -2 };
-        for (int k = 0; k < 4; k++) {
-            int32_t bi = cell_get(ceils, cx + dx[k], cy + dy[k]);
-            if (bi >= 0 && !reached[bi]) {
-                reached[bi] = true;
-                queue[qt++] = bi;
+        /* BFS one connected group, noting whether any member is wall-supported */
+        int32_t qh = 0, qt = 0;
+        bool supported = false;
+        visited[seed] = visit_epoch;
+        queue[qt++] = (int32_t)seed;
+        while (qh < qt) {
+            const PlacedStructure *a = &placed_structures[queue[qh++]];
+            int32_t cx = structure_cell(a->x), cy = structure_cell(a->y);
+            if (!supported && ceiling_has_wall(cx, cy)) supported = true;
+            const int32_t dx[4] = {  2, -2,  0,  0 };
+            const int32_t dy[4] = {  0,  0,  2, -2 };
+            for (int d = 0; d < 4; d++) {
+                structure_index_near(&adj, (float)(cx + dx[d]) * STRUCTURE_CELL_PX,
+                                     (float)(cy + dy[d]) * STRUCTURE_CELL_PX, 0.0f, ceil_mask);
+                for (uint32_t j = 0; j < adj.count; j++) {
+                    uint32_t bi = adj.slots[j];
+                    if (visited[bi] == visit_epoch) continue;
+                    visited[bi] = visit_epoch;
+                    queue[qt++] = (int32_t)bi;
+                }
             }
         }
-    }
+        if (supported) continue;
 
-    /* Demolish unreached ceilings */
-    for (uint32_t i = 0; i < placed_structure_count; i++) {
-        PlacedStructure *c = &placed_structures[i];
-        if (!c->active || c->type != STRUCT_CEILING) continue;
-        if (reached[i]) continue;
-        c->active = false;
-        char cm[128];
-        snprintf(cm, sizeof(cm),
-                 "{\"type\":\"structure_demolished\",\"structure_id\":%u}", c->id);
-        websocket_server_broadcast(cm);
-        log_info("🔨 Cascade-demolished ceiling %u (lost wall connectivity after %s %u removed)",
-                 c->id, trigger_kind, trigger_id);
+        /* Demolish the unsupported group */
+        for (int32_t q = 0; q < qt; q++) {
+            PlacedStructure *c = &placed_structures[queue[q]];
+            structure_free(c);
+            char cm[128];
+            snprintf(cm, sizeof(cm),
+                     "{\"type\":\"structure_demolished\",\"structure_id\":%u}", c->id);
+            websocket_server_broadcast(cm);
+            log_info("🔨 Cascade-demolished ceiling %u (lost wall connectivity after %s %u removed)",
+                     c->id, trigger_kind, trigger_id);
+        }
     }
 }
 
@@ -268,6 +243,8 @@ static int scale_schematic_res_cost(int base, float mult) {
 
 void handle_place_structure(WebSocketPlayer* player, struct WebSocketClient* client, const char* payload) {
     char response[256];
+    /* Placement-grid neighbourhood, refilled by each check below */
+    static StructureNear near;
 
     /* Parse placement position and structure type up front.
        Round px/py to 1 decimal place so the stored position exactly matches the
@@ -317,25 +294,8 @@ void handle_place_structure(WebSocketPlayer* player, struct WebSocketClient* cli
 
     uint32_t target_island_id = 0;
     {
-        for (int ii = 0; ii < ISLAND_COUNT; ii++) {
-            const IslandDef *isl = &ISLAND_PRESETS[ii];
-            float dx     = px - isl->x, dy = py - isl->y;
-            float dist_sq = dx*dx + dy*dy;
-            bool on_isl;
-            if (isl->vertex_count > 0) {
-                on_isl = (dist_sq < isl->poly_bound_r * isl->poly_bound_r)
-                      && island_poly_contains(isl, px, py);
-            } else {
-                float broad_r = isl->beach_radius_px + isl->beach_max_bump;
-                if (dist_sq >= broad_r * broad_r) { on_isl = false; }
-                else {
-                    float angle   = atan2f(dy, dx);
-                    float narrow_r = island_boundary_r(isl->beach_radius_px, isl->beach_bumps, angle);
-                    on_isl = (dist_sq < narrow_r * narrow_r);
-                }
-            }
-            if (on_isl) { target_island_id = (uint32_t)isl->id; break; }
-        }
+        const IslandDef *isl = island_land_at(px, py);
+        if (isl) target_island_id = (uint32_t)isl->id;
     }
     if (target_island_id == 0 && strcmp(stype, "wooden_floor") == 0) {
         snprintf(response, sizeof(response),
@@ -359,9 +319,9 @@ void handle_place_structure(WebSocketPlayer* player, struct WebSocketClient* cli
             goto ps_send;
         }
         /* Prevent stacking multiple shipyards too close together */
-        for (uint32_t si = 0; si < placed_structure_count; si++) {
-            if (!placed_structures[si].active) continue;
-            if (placed_structures[si].type != STRUCT_SHIPYARD) continue;
+        structure_index_near(&near, px, py, 120.0f, STRUCT_MASK(STRUCT_SHIPYARD));
+        for (uint32_t k = 0; k < near.count; k++) {
+            uint32_t si = near.slots[k];
             float ddx = placed_structures[si].x - px;
             float ddy = placed_structures[si].y - py;
             if (ddx*ddx + ddy*ddy < 120.0f * 120.0f) {
@@ -509,9 +469,10 @@ void handle_place_structure(WebSocketPlayer* player, struct WebSocketClient* cli
        placement; their claim_orphaned flag marks them as dead territory. */
     if (stype_enum != STRUCT_CLAIM_FLAG && !in_my_dominant_area) {
         bool enemy_block = false;
-        for (uint32_t si = 0; si < placed_structure_count && !enemy_block; si++) {
-            PlacedStructure *es = &placed_structures[si];
-            if (!es->active) continue;
+        uint32_t ncand;
+        const uint32_t *cand = structure_index_claim_candidates(px, py, &ncand);
+        for (uint32_t k = 0; k < ncand && !enemy_block; k++) {
+            PlacedStructure *es = &placed_structures[cand[k]];
             if (es->company_id == 0) continue;                           /* neutral  */
             if (es->company_id == (uint8_t)player->company_id) continue; /* own      */
             if (es->claim_orphaned) continue;                            /* dead fort */
@@ -544,10 +505,10 @@ void handle_place_structure(WebSocketPlayer* player, struct WebSocketClient* cli
         /* Max 3 flag forts per company per island */
         {
             int company_fort_count = 0;
-            for (uint32_t si = 0; si < placed_structure_count; si++) {
-                PlacedStructure *ex = &placed_structures[si];
-                if (!ex->active) continue;
-                if (ex->type != STRUCT_FLAG_FORT) continue;
+            uint32_t nforts;
+            const uint32_t *forts = structure_slots_of_type(STRUCT_FLAG_FORT, &nforts);
+            for (uint32_t k = 0; k < nforts; k++) {
+                PlacedStructure *ex = &placed_structures[forts[k]];
                 if ((uint8_t)ex->island_id != (uint8_t)target_island_id) continue;
                 if (ex->company_id != (uint8_t)player->company_id) continue;
                 company_fort_count++;
@@ -637,13 +598,8 @@ void handle_place_structure(WebSocketPlayer* player, struct WebSocketClient* cli
          * what they hold. Dominance: cf_src_enemy.dominators[] contains
          * cf_src_mine → Mi dominates Ej (Mi already won this slice). */
         {
-            PlacedStructure *mine_ps = NULL, *enemy_ps = NULL;
-            for (uint32_t si = 0; si < placed_structure_count; si++) {
-                PlacedStructure *ex = &placed_structures[si];
-                if (!ex->active) continue;
-                if (ex->id == cf_src_mine)  mine_ps  = ex;
-                if (ex->id == cf_src_enemy) enemy_ps = ex;
-            }
+            PlacedStructure *mine_ps  = structure_by_id(cf_src_mine);
+            PlacedStructure *enemy_ps = structure_by_id(cf_src_enemy);
             if (mine_ps && enemy_ps) {
                 for (uint8_t di = 0; di < enemy_ps->dominator_count; di++) {
                     if (enemy_ps->dominators[di] == mine_ps->id) {
@@ -716,29 +672,17 @@ void handle_place_structure(WebSocketPlayer* player, struct WebSocketClient* cli
          * is treated as a single region — my company may only contest it with
          * one flag at a time, regardless of which fort/structure pair was
          * chosen as the (mine, enemy) source. */
-        uint8_t enemy_company = 0;
-        for (uint32_t si = 0; si < placed_structure_count; si++) {
-            PlacedStructure *ex = &placed_structures[si];
-            if (ex->active && ex->id == cf_src_enemy) {
-                enemy_company = ex->company_id;
-                break;
-            }
-        }
-        for (uint32_t si = 0; si < placed_structure_count; si++) {
-            PlacedStructure *ex = &placed_structures[si];
-            if (!ex->active) continue;
-            if (ex->type != STRUCT_CLAIM_FLAG) continue;
+        PlacedStructure *cf_enemy_ps = structure_by_id(cf_src_enemy);
+        uint8_t enemy_company = cf_enemy_ps ? cf_enemy_ps->company_id : 0;
+        uint32_t nflags;
+        const uint32_t *flags = structure_slots_of_type(STRUCT_CLAIM_FLAG, &nflags);
+        for (uint32_t k = 0; k < nflags; k++) {
+            PlacedStructure *ex = &placed_structures[flags[k]];
             if (ex->company_id != (uint8_t)player->company_id) continue;
             if (ex->island_id  != (uint8_t)target_island_id) continue;
             /* Find this existing flag's enemy company. */
-            uint8_t ex_enemy_company = 0;
-            for (uint32_t sj = 0; sj < placed_structure_count; sj++) {
-                PlacedStructure *es = &placed_structures[sj];
-                if (es->active && es->id == ex->claim_source_enemy) {
-                    ex_enemy_company = es->company_id;
-                    break;
-                }
-            }
+            PlacedStructure *es = structure_by_id(ex->claim_source_enemy);
+            uint8_t ex_enemy_company = es ? es->company_id : 0;
             if (ex_enemy_company == enemy_company) {
                 snprintf(response, sizeof(response),
                          "{\"type\":\"place_structure_fail\",\"reason\":\"contested_area_already_claimed\"}");
@@ -784,9 +728,10 @@ void handle_place_structure(WebSocketPlayer* player, struct WebSocketClient* cli
     /* Wooden floor: OBB-OBB overlap check via SAT.
        No two floor tiles may share interior space regardless of their rotation angles. */
     if (stype_enum == STRUCT_WOODEN_FLOOR) {
-        for (uint32_t si = 0; si < placed_structure_count; si++) {
-            if (!placed_structures[si].active) continue;
-            if (placed_structures[si].type != STRUCT_WOODEN_FLOOR) continue;
+        /* Two 50-px squares can only overlap with centres under 50·√2 apart */
+        structure_index_near(&near, px, py, 71.0f, STRUCT_MASK(STRUCT_WOODEN_FLOOR));
+        for (uint32_t k = 0; k < near.count; k++) {
+            uint32_t si = near.slots[k];
             float exist_rad = placed_structures[si].rotation * (float)M_PI / 180.0f;
             if (floor_tiles_overlap(px, py, place_rad,
                                     placed_structures[si].x, placed_structures[si].y, exist_rad)) {
@@ -813,10 +758,13 @@ void handle_place_structure(WebSocketPlayer* player, struct WebSocketClient* cli
         const float HALF    = 25.0f; /* half tile */
         float rc = cosf(-place_rad), rs = sinf(-place_rad);
         bool blocked = false;
+        static IslandResourceNear near_trees;
         for (int ii = 0; ii < ISLAND_COUNT && !blocked; ii++) {
             const IslandDef *isl = &ISLAND_PRESETS[ii];
-            for (int ri = 0; ri < isl->resource_count && !blocked; ri++) {
-                if (isl->resources[ri].type_id != RES_WOOD) continue;
+            /* Tile corner (HALF·√2) plus the tree radius */
+            island_resources_near(&near_trees, isl, px, py, HALF * 1.4143f + TREE_R, RES_MASK(RES_WOOD));
+            for (uint32_t k = 0; k < near_trees.count && !blocked; k++) {
+                int ri = near_trees.ri[k];
                 if (isl->resources[ri].health <= 0) continue; /* depleted — no longer an obstacle */
                 float tx = isl->x + isl->resources[ri].ox;
                 float ty = isl->y + isl->resources[ri].oy;
@@ -853,11 +801,15 @@ void handle_place_structure(WebSocketPlayer* player, struct WebSocketClient* cli
         /* Forward rotation to bring floor-local points back to world */
         float frc_f = cosf(place_rad), frs_f = sinf(place_rad);
         bool blocked = false;
+        static IslandResourceNear near_boulders;
         for (int ii = 0; ii < ISLAND_COUNT && !blocked; ii++) {
             const IslandDef *isl = &ISLAND_PRESETS[ii];
-            for (int ri = 0; ri < isl->resource_count && !blocked; ri++) {
-                const IslandResource *res = &isl->resources[ri];
-                if (res->type_id != RES_BOULDER && res->type_id != RES_STONE_BOULDER) continue;
+            /* Tile corner plus the widest ellipse axis (1.35 × base × size) */
+            island_resources_near(&near_boulders, isl, px, py,
+                                  HALF * 1.4143f + BOULDER_BASE_R * 1.35f * isl->grid_max_size,
+                                  RES_MASK(RES_BOULDER) | RES_MASK(RES_STONE_BOULDER));
+            for (uint32_t k = 0; k < near_boulders.count && !blocked; k++) {
+                const IslandResource *res = &isl->resources[near_boulders.ri[k]];
                 if (res->health <= 0) continue;
                 float bx = isl->x + res->ox, by = isl->y + res->oy;
                 /* Boulder centre in floor local frame */
@@ -899,9 +851,10 @@ void handle_place_structure(WebSocketPlayer* player, struct WebSocketClient* cli
         bool has_floor     = false;
         bool wrong_company = false;
         const float HALF_TILE = 25.0f;
-        for (uint32_t si = 0; si < placed_structure_count; si++) {
-            if (!placed_structures[si].active) continue;
-            if (placed_structures[si].type != STRUCT_WOODEN_FLOOR) continue;
+        /* Inside a tile means within HALF_TILE·√2 of its centre */
+        structure_index_near(&near, px, py, 36.0f, STRUCT_MASK(STRUCT_WOODEN_FLOOR));
+        for (uint32_t k = 0; k < near.count; k++) {
+            uint32_t si = near.slots[k];
             /* Rotate placement point into floor's local space */
             float rad = placed_structures[si].rotation * (float)M_PI / 180.0f;
             float c   = cosf(-rad), s = sinf(-rad);
@@ -932,9 +885,10 @@ void handle_place_structure(WebSocketPlayer* player, struct WebSocketClient* cli
         bool wrong_company = false;
         bool bed_on_tile   = false;
         const float HALF_TILE = 25.0f;
-        for (uint32_t si = 0; si < placed_structure_count; si++) {
-            if (!placed_structures[si].active) continue;
-            if (placed_structures[si].type != STRUCT_WOODEN_FLOOR) continue;
+        /* Inside a tile means within HALF_TILE·√2 of its centre */
+        structure_index_near(&near, px, py, 36.0f, STRUCT_MASK(STRUCT_WOODEN_FLOOR));
+        for (uint32_t k = 0; k < near.count; k++) {
+            uint32_t si = near.slots[k];
             float rad = placed_structures[si].rotation * (float)M_PI / 180.0f;
             float c   = cosf(-rad), s = sinf(-rad);
             float ddx = px - placed_structures[si].x;
@@ -950,9 +904,9 @@ void handle_place_structure(WebSocketPlayer* player, struct WebSocketClient* cli
             }
         }
         /* Also ensure no bed already exists at approximately this position */
-        for (uint32_t si = 0; si < placed_structure_count && !bed_on_tile; si++) {
-            if (!placed_structures[si].active) continue;
-            if (placed_structures[si].type != STRUCT_BED) continue;
+        structure_index_near(&near, px, py, 30.0f, STRUCT_MASK(STRUCT_BED));
+        for (uint32_t k = 0; k < near.count && !bed_on_tile; k++) {
+            uint32_t si = near.slots[k];
             float ddx = placed_structures[si].x - px;
             float ddy = placed_structures[si].y - py;
             if (ddx*ddx + ddy*ddy < 30.0f * 30.0f) bed_on_tile = true;
@@ -976,9 +930,10 @@ void handle_place_structure(WebSocketPlayer* player, struct WebSocketClient* cli
         bool has_floor     = false;
         bool wrong_company = false;
         const float HALF_TILE = 25.0f;
-        for (uint32_t si = 0; si < placed_structure_count; si++) {
-            if (!placed_structures[si].active) continue;
-            if (placed_structures[si].type != STRUCT_WOODEN_FLOOR) continue;
+        /* Inside a tile means within HALF_TILE·√2 of its centre */
+        structure_index_near(&near, px, py, 36.0f, STRUCT_MASK(STRUCT_WOODEN_FLOOR));
+        for (uint32_t k = 0; k < near.count; k++) {
+            uint32_t si = near.slots[k];
             float rad = placed_structures[si].rotation * (float)M_PI / 180.0f;
             float c   = cosf(-rad), s = sinf(-rad);
             float ddx = px - placed_structures[si].x;
@@ -1011,10 +966,10 @@ void handle_place_structure(WebSocketPlayer* player, struct WebSocketClient* cli
         bool wall_occupied = false;
         float wall_rad    = 0.0f;  /* actual wall orientation in world space */
         /* First: overlap check — no two walls/doors at same position */
-        for (uint32_t si = 0; si < placed_structure_count; si++) {
-            if (!placed_structures[si].active) continue;
-            if (placed_structures[si].type != STRUCT_WALL &&
-                placed_structures[si].type != STRUCT_DOOR_FRAME) continue;
+        structure_index_near(&near, px, py, EDGE_TOL,
+                             STRUCT_MASK(STRUCT_WALL) | STRUCT_MASK(STRUCT_DOOR_FRAME));
+        for (uint32_t k = 0; k < near.count; k++) {
+            uint32_t si = near.slots[k];
             if (fabsf(placed_structures[si].x - px) < EDGE_TOL &&
                 fabsf(placed_structures[si].y - py) < EDGE_TOL) {
                 wall_occupied = true; break;
@@ -1028,9 +983,9 @@ void handle_place_structure(WebSocketPlayer* player, struct WebSocketClient* cli
         /* Validate floor-edge alignment and determine orientation.
            Each floor may be rotated, so compute the 4 edge-midpoint positions
            by rotating the canonical ±HALF_TILE offsets by that floor's angle. */
-        for (uint32_t si = 0; si < placed_structure_count && !has_edge; si++) {
-            if (!placed_structures[si].active) continue;
-            if (placed_structures[si].type != STRUCT_WOODEN_FLOOR) continue;
+        structure_index_near(&near, px, py, HALF_TILE + EDGE_TOL, STRUCT_MASK(STRUCT_WOODEN_FLOOR));
+        for (uint32_t k = 0; k < near.count && !has_edge; k++) {
+            uint32_t si = near.slots[k];
             float fx  = placed_structures[si].x;
             float fy  = placed_structures[si].y;
             float rad = placed_structures[si].rotation * (float)M_PI / 180.0f;
@@ -1092,13 +1047,12 @@ void handle_place_structure(WebSocketPlayer* player, struct WebSocketClient* cli
         {
             const float BLOCK_R = 35.0f;
             bool struct_in_way = false;
-            for (uint32_t si = 0; si < placed_structure_count && !struct_in_way; si++) {
-                if (!placed_structures[si].active) continue;
-                if (placed_structures[si].type == STRUCT_WOODEN_FLOOR) continue;
-                if (placed_structures[si].type == STRUCT_WALL) continue;
-                if (placed_structures[si].type == STRUCT_DOOR_FRAME) continue;
-                if (placed_structures[si].type == STRUCT_DOOR) continue;
-                if (placed_structures[si].type == STRUCT_CEILING) continue;
+            structure_index_near(&near, px, py, BLOCK_R,
+                                 ~(STRUCT_MASK(STRUCT_WOODEN_FLOOR) | STRUCT_MASK(STRUCT_WALL) |
+                                   STRUCT_MASK(STRUCT_DOOR_FRAME) | STRUCT_MASK(STRUCT_DOOR) |
+                                   STRUCT_MASK(STRUCT_CEILING)));
+            for (uint32_t k = 0; k < near.count && !struct_in_way; k++) {
+                uint32_t si = near.slots[k];
                 float dpx = placed_structures[si].x - px;
                 float dpy = placed_structures[si].y - py;
                 if (dpx*dpx + dpy*dpy < BLOCK_R * BLOCK_R) struct_in_way = true;
@@ -1118,9 +1072,9 @@ void handle_place_structure(WebSocketPlayer* player, struct WebSocketClient* cli
         const float HALF_TILE = 25.0f;
         const float TILE      = 50.0f;
         /* Overlap: no two ceilings at same position */
-        for (uint32_t si = 0; si < placed_structure_count; si++) {
-            if (!placed_structures[si].active) continue;
-            if (placed_structures[si].type != STRUCT_CEILING) continue;
+        structure_index_near(&near, px, py, EDGE_TOL, STRUCT_MASK(STRUCT_CEILING));
+        for (uint32_t k = 0; k < near.count; k++) {
+            uint32_t si = near.slots[k];
             if (fabsf(placed_structures[si].x - px) < EDGE_TOL &&
                 fabsf(placed_structures[si].y - py) < EDGE_TOL) {
                 snprintf(response, sizeof(response),
@@ -1141,10 +1095,10 @@ void handle_place_structure(WebSocketPlayer* player, struct WebSocketClient* cli
             for (int ei = 0; ei < 4 && !supported; ei++) {
                 float ex = px + edge_offs[ei].ldx * c - edge_offs[ei].ldy * s;
                 float ey = py + edge_offs[ei].ldx * s + edge_offs[ei].ldy * c;
-                for (uint32_t si = 0; si < placed_structure_count && !supported; si++) {
-                    if (!placed_structures[si].active) continue;
-                    if (placed_structures[si].type != STRUCT_WALL &&
-                        placed_structures[si].type != STRUCT_DOOR_FRAME) continue;
+                structure_index_near(&near, ex, ey, EDGE_TOL,
+                                     STRUCT_MASK(STRUCT_WALL) | STRUCT_MASK(STRUCT_DOOR_FRAME));
+                for (uint32_t k = 0; k < near.count && !supported; k++) {
+                    uint32_t si = near.slots[k];
                     if (fabsf(placed_structures[si].x - ex) < EDGE_TOL &&
                         fabsf(placed_structures[si].y - ey) < EDGE_TOL) {
                         supported = true;
@@ -1154,9 +1108,9 @@ void handle_place_structure(WebSocketPlayer* player, struct WebSocketClient* cli
         }
         /* Check 2: an adjacent ceiling tile exists (center is ~TILE away) */
         if (!supported) {
-            for (uint32_t si = 0; si < placed_structure_count && !supported; si++) {
-                if (!placed_structures[si].active) continue;
-                if (placed_structures[si].type != STRUCT_CEILING) continue;
+            structure_index_near(&near, px, py, TILE + EDGE_TOL, STRUCT_MASK(STRUCT_CEILING));
+            for (uint32_t k = 0; k < near.count && !supported; k++) {
+                uint32_t si = near.slots[k];
                 float cr = placed_structures[si].rotation * (float)M_PI / 180.0f;
                 float cc = cosf(cr), cs = sinf(cr);
                 /* 4 adjacent tile centres from this existing ceiling */
@@ -1182,9 +1136,9 @@ void handle_place_structure(WebSocketPlayer* player, struct WebSocketClient* cli
         {
             const float FLOOR_UNDER_R = 100.0f;
             bool has_floor = false;
-            for (uint32_t si = 0; si < placed_structure_count && !has_floor; si++) {
-                if (!placed_structures[si].active) continue;
-                if (placed_structures[si].type != STRUCT_WOODEN_FLOOR) continue;
+            structure_index_near(&near, px, py, FLOOR_UNDER_R, STRUCT_MASK(STRUCT_WOODEN_FLOOR));
+            for (uint32_t k = 0; k < near.count && !has_floor; k++) {
+                uint32_t si = near.slots[k];
                 if (placed_structures[si].company_id != (uint8_t)player->company_id) continue;
                 float fdx = placed_structures[si].x - px;
                 float fdy = placed_structures[si].y - py;
@@ -1203,8 +1157,10 @@ void handle_place_structure(WebSocketPlayer* player, struct WebSocketClient* cli
         const float POS_TOL = 3.0f;
         bool has_frame  = false;
         bool door_taken = false;
-        for (uint32_t si = 0; si < placed_structure_count; si++) {
-            if (!placed_structures[si].active) continue;
+        structure_index_near(&near, px, py, POS_TOL,
+                             STRUCT_MASK(STRUCT_DOOR_FRAME) | STRUCT_MASK(STRUCT_DOOR));
+        for (uint32_t k = 0; k < near.count; k++) {
+            uint32_t si = near.slots[k];
             if (fabsf(placed_structures[si].x - px) >= POS_TOL ||
                 fabsf(placed_structures[si].y - py) >= POS_TOL) continue;
             if (placed_structures[si].type == STRUCT_DOOR_FRAME) has_frame  = true;
@@ -1226,7 +1182,7 @@ void handle_place_structure(WebSocketPlayer* player, struct WebSocketClient* cli
     float place_rotation = place_rotation_deg; /* already parsed above */
 
     /* Space for more structures? */
-    if (placed_structure_count >= MAX_PLACED_STRUCTURES) {
+    if (!structure_store_has_room()) {
         snprintf(response, sizeof(response),
                  "{\"type\":\"place_structure_fail\",\"reason\":\"world_full\"}");
         goto ps_send;
@@ -1254,15 +1210,13 @@ void handle_place_structure(WebSocketPlayer* player, struct WebSocketClient* cli
         if (ns > 0) craft_consume(player, ITEM_STONE, ns);
     }
 
-    /* Add structure */
-    uint16_t new_id = next_structure_id++;
-    placed_structures[placed_structure_count].active     = true;
-    placed_structures[placed_structure_count].id         = new_id;
-    placed_structures[placed_structure_count].type       = stype_enum;
-    placed_structures[placed_structure_count].island_id  = target_island_id;
-    placed_structures[placed_structure_count].x          = px;
-    placed_structures[placed_structure_count].y          = py;
-    placed_structures[placed_structure_count].company_id = (uint8_t)player->company_id;
+    /* Add structure (room was checked above, so this cannot fail) */
+    PlacedStructure *new_s = structure_alloc(stype_enum);
+    uint16_t new_id = new_s->id;
+    new_s->island_id  = target_island_id;
+    new_s->x          = px;
+    new_s->y          = py;
+    new_s->company_id = (uint8_t)player->company_id;
     /* Per-type initial HP */
     uint32_t init_hp;
     switch (stype_enum) {
@@ -1277,50 +1231,47 @@ void handle_place_structure(WebSocketPlayer* player, struct WebSocketClient* cli
         case STRUCT_SHIPYARD:     init_hp = 150000; break;
         default:                  init_hp =    100; break;
     }
-    placed_structures[placed_structure_count].max_hp     = init_hp;
-    placed_structures[placed_structure_count].under_construction = req_schematic;
+    new_s->max_hp     = init_hp;
+    new_s->under_construction = req_schematic;
     if (req_schematic) {
         /* Schematic placement: start at 10% HP and passively build up */
         uint32_t start_hp = init_hp / 10;
         if (start_hp < 1) start_hp = 1;
-        placed_structures[placed_structure_count].hp         = start_hp;
-        placed_structures[placed_structure_count].target_hp  = init_hp;
+        new_s->hp         = start_hp;
+        new_s->target_hp  = init_hp;
     } else {
-        placed_structures[placed_structure_count].hp         = init_hp;
-        placed_structures[placed_structure_count].target_hp  = init_hp;
+        new_s->hp         = init_hp;
+        new_s->target_hp  = init_hp;
     }
     /* Apply source-item quality: store payload and scale HP by durability mult */
-    placed_structures[placed_structure_count].quality = place_quality;
+    new_s->quality = place_quality;
     if (place_quality.quality_q8 != 0) {
         uint16_t dm_q8 = place_quality.stat_mult_q8[STAT_DURABILITY];
         if (dm_q8 > 256) {  /* 256 = 1.00x; only scale up */
-            PlacedStructure* qs = &placed_structures[placed_structure_count];
+            PlacedStructure* qs = new_s;
             qs->max_hp    = (uint32_t)(((uint64_t)qs->max_hp    * dm_q8) / 256);
             qs->target_hp = (uint32_t)(((uint64_t)qs->target_hp * dm_q8) / 256);
             qs->hp        = (uint32_t)(((uint64_t)qs->hp        * dm_q8) / 256);
         }
     }
-    placed_structures[placed_structure_count].placer_id  = player->player_id;
-    snprintf(placed_structures[placed_structure_count].placer_name,
-             sizeof(placed_structures[placed_structure_count].placer_name),
+    new_s->placer_id  = player->player_id;
+    snprintf(new_s->placer_name,
+             sizeof(new_s->placer_name),
              "%s", player->name);
-    placed_structures[placed_structure_count].open        = false;
-    placed_structures[placed_structure_count].door_locked = (stype_enum == STRUCT_DOOR);
-    placed_structures[placed_structure_count].rotation   =
+    new_s->open        = false;
+    new_s->door_locked = (stype_enum == STRUCT_DOOR);
+    new_s->rotation   =
         (stype_enum == STRUCT_WOODEN_FLOOR || stype_enum == STRUCT_WORKBENCH ||
          stype_enum == STRUCT_SHIPYARD || stype_enum == STRUCT_CEILING ||
          stype_enum == STRUCT_CANNON || stype_enum == STRUCT_BED) ? place_rotation : 0.0f;
     /* Cannon: initialise aim angle to match the placement rotation so first fire goes the right way.
        The barrel points "up" in local space (−y), which corresponds to rotRad − π/2 in world space. */
     if (stype_enum == STRUCT_CANNON) {
-        placed_structures[placed_structure_count].cannon_aim_angle =
+        new_s->cannon_aim_angle =
             place_rotation * (float)M_PI / 180.0f - (float)(M_PI / 2.0);
-        placed_structures[placed_structure_count].cannon_desired_aim_angle =
-            placed_structures[placed_structure_count].cannon_aim_angle;
+        new_s->cannon_desired_aim_angle =
+            new_s->cannon_aim_angle;
     }
-    placed_structure_count++;
-
-    structure_index_rebuild();
 
     /* New territorial anchor — invalidate claim-flag section caches so
      * claim flags re-evaluate their contest area next tick. */
@@ -1345,7 +1296,7 @@ void handle_place_structure(WebSocketPlayer* player, struct WebSocketClient* cli
          * onto enemy territory (it cannot be used as the "mine" source for
          * a claim flag); the client also renders it as its own non-merging
          * blob in the overlay. */
-        PlacedStructure *ff = &placed_structures[placed_structure_count - 1];
+        PlacedStructure *ff = new_s;
         ff->max_hp            = 100000;
         ff->hp                = (uint32_t)(100000 * FLAG_FORT_INITIAL_HP_PCT);
         ff->target_hp         = ff->max_hp; /* heal ceiling; permanently reduced by combat damage */
@@ -1354,7 +1305,7 @@ void handle_place_structure(WebSocketPlayer* player, struct WebSocketClient* cli
         ff->claim_state       = CLAIM_FLAG_STATE_CONTEST;
         ff->claim_grace_ms    = 0.0f;
         /* Flag forts manage their own HP progression through claim phases (claim.c).
-         * Clear under_construction so structure_repair_tick does not also passively
+         * Clear under_construction so the repair timer does not also passively
          * heal the fort and bypass the CLAIMING → BUILDING → ACTIVE phase logic. */
         ff->under_construction = false;
 
@@ -1363,9 +1314,9 @@ void handle_place_structure(WebSocketPlayer* player, struct WebSocketClient* cli
          * fortress belonging to the SAME company on the SAME island whose
          * claim radius contains the placement point. */
         bool in_friendly_active = false;
-        for (uint32_t qi = 0; qi < placed_structure_count - 1; qi++) {
+        for (uint32_t qi = 0; qi < placed_structure_count; qi++) {
             PlacedStructure *q = &placed_structures[qi];
-            if (!q->active) continue;
+            if (!q->active || q == ff) continue;
             if (q->claim_orphaned) continue;
             if (!q->fortress_complete) continue;
             if (q->company_id != ff->company_id) continue;
@@ -1378,7 +1329,7 @@ void handle_place_structure(WebSocketPlayer* player, struct WebSocketClient* cli
 
         if (in_friendly_active) {
             /* Skip claim phase entirely; jump straight to BUILDING.
-             * claim_progress_ms is now the float HP accumulator (see flag_fort_tick). */
+             * claim_progress_ms is now the float HP accumulator (see flag_fort_step). */
             ff->claim_phase       = FLAG_FORT_PHASE_BUILDING;
             ff->claim_progress_ms = (float)ff->hp;
         } else {
@@ -1397,19 +1348,19 @@ void handle_place_structure(WebSocketPlayer* player, struct WebSocketClient* cli
 
     /* Company Fortress: start build timer (HP = 1 until complete) */
     if (stype_enum == STRUCT_COMPANY_FORTRESS) {
-        placed_structures[placed_structure_count - 1].max_hp            = 1000;
-        placed_structures[placed_structure_count - 1].hp                = 1;   /* incomplete */
-        placed_structures[placed_structure_count - 1].target_hp         = 1000;
-        placed_structures[placed_structure_count - 1].claim_progress_ms = 0.0f;
-        placed_structures[placed_structure_count - 1].fortress_complete  = false;
-        placed_structures[placed_structure_count - 1].claim_contested    = false;
+        new_s->max_hp            = 1000;
+        new_s->hp                = 1;   /* incomplete */
+        new_s->target_hp         = 1000;
+        new_s->claim_progress_ms = 0.0f;
+        new_s->fortress_complete  = false;
+        new_s->claim_contested    = false;
         log_info("🏰 Player %u started building Company Fortress #%u on island %u",
                  player->player_id, new_id, target_island_id);
     }
 
     /* Claim Flag: link to (mine, enemy) source structures, start countdown at full */
     if (stype_enum == STRUCT_CLAIM_FLAG) {
-        PlacedStructure *cf = &placed_structures[placed_structure_count - 1];
+        PlacedStructure *cf = new_s;
         cf->claim_linked_fort       = cf_src_mine;
         cf->claim_source_enemy      = cf_src_enemy;
         cf->claim_progress_ms       = (float)FLAG_CLAIM_DURATION_MS; /* starts FULL, ticks down to 0 = capture */
@@ -1419,6 +1370,10 @@ void handle_place_structure(WebSocketPlayer* player, struct WebSocketClient* cli
         cf->claim_targets_fortress  = false;                         /* legacy field — unused in new flow */
     }
 
+    /* Start the schematic build-up and fort timers */
+    structure_repair_wake(new_s);
+    claim_fort_wake(new_s);
+
     log_info("🏗️ Player %u placed %s (id=%u) at (%.1f,%.1f) on island %u",
              player->player_id, stype, new_id, px, py, target_island_id);
 
@@ -1426,26 +1381,26 @@ void handle_place_structure(WebSocketPlayer* player, struct WebSocketClient* cli
     char bcast[384];
     bool new_is_door = (stype_enum == STRUCT_DOOR);
     bool new_is_cannon = (stype_enum == STRUCT_CANNON);
-    float bcast_rot  = placed_structures[placed_structure_count - 1].rotation;
+    float bcast_rot  = new_s->rotation;
     char cannon_extra[64] = "";
     if (new_is_cannon) {
         snprintf(cannon_extra, sizeof(cannon_extra),
                  ",\"cannon_aim_angle\":%.4f",
-                 placed_structures[placed_structure_count - 1].cannon_aim_angle);
+                 new_s->cannon_aim_angle);
     }
-    uint32_t bcast_hp     = placed_structures[placed_structure_count - 1].hp;
-    uint32_t bcast_max_hp = placed_structures[placed_structure_count - 1].max_hp;
-    uint32_t bcast_target = placed_structures[placed_structure_count - 1].target_hp;
+    uint32_t bcast_hp     = new_s->hp;
+    uint32_t bcast_max_hp = new_s->max_hp;
+    uint32_t bcast_target = new_s->target_hp;
     /* Door: initial locked state (always true for new doors) */
     char door_lock_extra[32] = "";
     if (new_is_door) {
         snprintf(door_lock_extra, sizeof(door_lock_extra),
                  ",\"locked\":%s",
-                 placed_structures[placed_structure_count - 1].door_locked ? "true" : "false");
+                 new_s->door_locked ? "true" : "false");
     }
     /* Flag-fort phase initial broadcast (claim/build/active). Other types: 0. */
     uint8_t bcast_phase = (stype_enum == STRUCT_FLAG_FORT)
-        ? placed_structures[placed_structure_count - 1].claim_phase : 0u;
+        ? new_s->claim_phase : 0u;
     char phase_extra[48] = "";
     if (stype_enum == STRUCT_FLAG_FORT) {
         snprintf(phase_extra, sizeof(phase_extra), ",\"claim_phase\":%u", (unsigned)bcast_phase);
@@ -1455,8 +1410,8 @@ void handle_place_structure(WebSocketPlayer* player, struct WebSocketClient* cli
     if (stype_enum == STRUCT_CLAIM_FLAG) {
         snprintf(cflag_extra, sizeof(cflag_extra),
                  ",\"claim_linked_fort\":%u,\"claim_source_enemy\":%u",
-                 (unsigned)placed_structures[placed_structure_count - 1].claim_linked_fort,
-                 (unsigned)placed_structures[placed_structure_count - 1].claim_source_enemy);
+                 (unsigned)new_s->claim_linked_fort,
+                 (unsigned)new_s->claim_source_enemy);
     }
     snprintf(bcast, sizeof(bcast),
              "{\"type\":\"structure_placed\",\"id\":%u,\"structure_type\":\"%s\","
@@ -1523,9 +1478,8 @@ void handle_structure_interact(WebSocketPlayer* player, struct WebSocketClient*
     }
 
     /* ── Wreck salvage (works anywhere in the sea, not island-gated) ─────── */
-    for (uint32_t i = 0; i < placed_structure_count; i++) {
-        PlacedStructure *w = &placed_structures[i];
-        if (!w->active || w->type != STRUCT_WRECK || w->id != sid) continue;
+    PlacedStructure *w = structure_by_id(sid);
+    if (w && w->type == STRUCT_WRECK) {
 
         /* Range check — must be within STRUCT_INTERACT_R client units to salvage */
         float dx = player->x - w->x;
@@ -1545,7 +1499,7 @@ void handle_structure_interact(WebSocketPlayer* player, struct WebSocketClient*
                              w->chest_metal + w->chest_stone;
             if (total == 0) {
                 /* Empty ruin — remove it */
-                w->active = false;
+                structure_free(w);
                 char bcast[64];
                 snprintf(bcast, sizeof(bcast),
                          "{\"type\":\"wreck_removed\",\"id\":%u}", (unsigned)w->id);
@@ -1590,7 +1544,7 @@ void handle_structure_interact(WebSocketPlayer* player, struct WebSocketClient*
 
                 char bbcast[96];
                 if (w->wreck_loot_count == 0 && w->wreck_bp_count == 0) {
-                    w->active = false;
+                    structure_free(w);
                     snprintf(bbcast, sizeof(bbcast),
                              "{\"type\":\"wreck_removed\",\"id\":%u}", (unsigned)w->id);
                 } else {
@@ -1613,7 +1567,7 @@ void handle_structure_interact(WebSocketPlayer* player, struct WebSocketClient*
 
         if (w->wreck_loot_count == 0) {
             /* Empty wreck — remove it */
-            w->active = false;
+            structure_free(w);
             char bcast[64];
             snprintf(bcast, sizeof(bcast),
                      "{\"type\":\"wreck_removed\",\"id\":%u}", (unsigned)w->id);
@@ -1659,7 +1613,7 @@ void handle_structure_interact(WebSocketPlayer* player, struct WebSocketClient*
         /* Broadcast wreck state update */
         char bcast[96];
         if (w->wreck_loot_count == 0 && w->wreck_bp_count == 0) {
-            w->active = false;
+            structure_free(w);
             snprintf(bcast, sizeof(bcast),
                      "{\"type\":\"wreck_removed\",\"id\":%u}", (unsigned)w->id);
         } else {
@@ -1684,8 +1638,9 @@ void handle_structure_interact(WebSocketPlayer* player, struct WebSocketClient*
         goto si_send;
     }
 
-    for (uint32_t i = 0; i < placed_structure_count; i++) {
-        if (!placed_structures[i].active || placed_structures[i].id != sid) continue;
+    PlacedStructure *target = structure_by_id(sid);
+    if (target) {
+        uint32_t i = (uint32_t)(target - placed_structures);
         float dx = player->x - placed_structures[i].x;
         float dy = player->y - placed_structures[i].y;
         float max_ir = (placed_structures[i].type == STRUCT_SHIPYARD)
@@ -1840,14 +1795,11 @@ static void bed_sync_sim_player(WebSocketPlayer* player) {
 }
 
 static bool player_near_island_bed(WebSocketPlayer* player, uint32_t bed_id) {
-    for (uint32_t i = 0; i < placed_structure_count; i++) {
-        const PlacedStructure* s = &placed_structures[i];
-        if (!s->active || s->type != STRUCT_BED || s->id != bed_id) continue;
-        float dx = player->x - s->x;
-        float dy = player->y - s->y;
-        return (dx * dx + dy * dy) <= (BED_TRAVEL_RANGE * BED_TRAVEL_RANGE);
-    }
-    return false;
+    const PlacedStructure* s = structure_by_id(bed_id);
+    if (!s || s->type != STRUCT_BED) return false;
+    float dx = player->x - s->x;
+    float dy = player->y - s->y;
+    return (dx * dx + dy * dy) <= (BED_TRAVEL_RANGE * BED_TRAVEL_RANGE);
 }
 
 static bool player_near_ship_bed(WebSocketPlayer* player, uint16_t ship_id, uint16_t module_id) {
@@ -1894,18 +1846,14 @@ static void teleport_player_to_ship_bed(WebSocketPlayer* player, SimpleShip* shi
 
 bool respawn_player_at_island_bed(WebSocketPlayer* player, uint32_t bed_id)
 {
-    for (uint32_t i = 0; i < placed_structure_count; i++) {
-        const PlacedStructure* bed = &placed_structures[i];
-        if (!bed->active || bed->type != STRUCT_BED || bed->id != bed_id)
-            continue;
-        if (!bed_company_ok(player, bed->company_id))
-            return false;
-        teleport_player_to_island_bed(player, bed);
-        log_info("🛏️  Player %u respawned at island bed %u (%.1f,%.1f)",
-                 player->player_id, bed_id, player->x, player->y);
-        return true;
-    }
-    return false;
+    const PlacedStructure* bed = structure_by_id(bed_id);
+    if (!bed || bed->type != STRUCT_BED) return false;
+    if (!bed_company_ok(player, bed->company_id))
+        return false;
+    teleport_player_to_island_bed(player, bed);
+    log_info("🛏️  Player %u respawned at island bed %u (%.1f,%.1f)",
+             player->player_id, bed_id, player->x, player->y);
+    return true;
 }
 
 bool respawn_player_at_ship_bed(WebSocketPlayer* player, uint16_t ship_id, uint16_t module_id)
@@ -1982,14 +1930,8 @@ void handle_bed_travel(WebSocketPlayer* player, struct WebSocketClient* client,
     }
 
     if (src_is_island) {
-        PlacedStructure* src = NULL;
-        for (uint32_t i = 0; i < placed_structure_count; i++) {
-            if (!placed_structures[i].active) continue;
-            if (placed_structures[i].type != STRUCT_BED) continue;
-            if (placed_structures[i].id != src_island) continue;
-            src = &placed_structures[i];
-            break;
-        }
+        PlacedStructure* src = structure_by_id(src_island);
+        if (src && src->type != STRUCT_BED) src = NULL;
         if (!src || !bed_company_ok(player, src->company_id) ||
             !player_near_island_bed(player, src_island)) {
             snprintf(response, sizeof(response),
@@ -2009,14 +1951,8 @@ void handle_bed_travel(WebSocketPlayer* player, struct WebSocketClient* client,
     }
 
     if (tgt_is_island) {
-        PlacedStructure* tgt = NULL;
-        for (uint32_t i = 0; i < placed_structure_count; i++) {
-            if (!placed_structures[i].active) continue;
-            if (placed_structures[i].type != STRUCT_BED) continue;
-            if (placed_structures[i].id != tgt_island) continue;
-            tgt = &placed_structures[i];
-            break;
-        }
+        PlacedStructure* tgt = structure_by_id(tgt_island);
+        if (tgt && tgt->type != STRUCT_BED) tgt = NULL;
         if (!tgt || !bed_company_ok(player, tgt->company_id)) {
             snprintf(response, sizeof(response),
                      "{\"type\":\"bed_travel_fail\",\"reason\":\"bed_not_found\"}");
@@ -2105,9 +2041,9 @@ void handle_land_chest_transfer(WebSocketPlayer* player, struct WebSocketClient*
     }
 
     /* Find the chest structure — also accept chest-ruin wrecks (read-only) */
-    for (uint32_t i = 0; i < placed_structure_count; i++) {
-        if (!placed_structures[i].active) continue;
-        if (placed_structures[i].id != sid) continue;
+    PlacedStructure *chest_ps = structure_by_id(sid);
+    if (chest_ps) {
+        uint32_t i = (uint32_t)(chest_ps - placed_structures);
 
         bool is_ruin = (placed_structures[i].type == STRUCT_WRECK &&
                         placed_structures[i].wreck_resource_cache);
@@ -2185,7 +2121,7 @@ void handle_land_chest_transfer(WebSocketPlayer* player, struct WebSocketClient*
                                placed_structures[i].chest_metal +
                                placed_structures[i].chest_stone;
                 if (tot == 0) {
-                    placed_structures[i].active = false;
+                    structure_free(&placed_structures[i]);
                     char bcast[64];
                     snprintf(bcast, sizeof(bcast),
                              "{\"type\":\"wreck_removed\",\"id\":%u}", (unsigned)sid);
@@ -2245,9 +2181,9 @@ void handle_land_chest_drop(WebSocketPlayer* player, struct WebSocketClient* cli
         goto lcd_send;
     }
 
-    for (uint32_t i = 0; i < placed_structure_count; i++) {
-        if (!placed_structures[i].active) continue;
-        if (placed_structures[i].id != sid) continue;
+    PlacedStructure *chest_ps = structure_by_id(sid);
+    if (chest_ps) {
+        uint32_t i = (uint32_t)(chest_ps - placed_structures);
         if (placed_structures[i].type != STRUCT_CHEST
             && placed_structures[i].type != STRUCT_SHIPYARD) {
             snprintf(response, sizeof(response), "{\"type\":\"land_chest_fail\",\"reason\":\"not_chest\"}");
@@ -2369,13 +2305,8 @@ void handle_shipyard_action(WebSocketPlayer* player, struct WebSocketClient* cli
     (void)module; /* parsed for future use */
 
     /* Find shipyard */
-    PlacedStructure* sy = NULL;
-    for (uint32_t i = 0; i < placed_structure_count; i++) {
-        if (placed_structures[i].active && placed_structures[i].id == sid
-            && placed_structures[i].type == STRUCT_SHIPYARD) {
-            sy = &placed_structures[i]; break;
-        }
-    }
+    PlacedStructure* sy = structure_by_id(sid);
+    if (sy && sy->type != STRUCT_SHIPYARD) sy = NULL;
     if (!sy) {
         snprintf(response, sizeof(response),
                  "{\"type\":\"shipyard_action_fail\",\"reason\":\"not_found\"}");
@@ -2426,7 +2357,6 @@ void handle_shipyard_action(WebSocketPlayer* player, struct WebSocketClient* cli
         sy->construction_phase   = CONSTRUCTION_BUILDING;
         sy->construction_company = player->company_id;
         sy->scaffolded_ship_id   = new_ship_id;
-        structure_index_rebuild();
         log_info("⚓ Shipyard %u: skeleton spawned as ship %u", sid, new_ship_id);
 
     } else if (strcmp(action, "add_module") == 0) {
@@ -2457,7 +2387,6 @@ void handle_shipyard_action(WebSocketPlayer* player, struct WebSocketClient* cli
         sy->construction_phase  = CONSTRUCTION_EMPTY;
         sy->modules_placed      = 0;
         sy->scaffolded_ship_id  = 0;
-        structure_index_rebuild();
         char bcast[512];
         build_shipyard_state_json(bcast, sizeof(bcast), sy, released_id, player->player_id, NULL);
         websocket_server_broadcast(bcast);
@@ -2492,22 +2421,19 @@ sya_send:;
  *
  * 1. Finds the structure by ID, marks it inactive, broadcasts structure_demolished.
  * 2. If it was a floor, cascade-destroys dependent workbenches, walls, door_frames,
- *    ceilings, and doors (using active=false + broadcast for each).
+ *    ceilings, and doors (using structure_free + broadcast for each).
  * 3. If it was a door_frame, cascade-destroys any door sitting on it.
- * 4. Compacts inactive entries from placed_structures[] in one final pass so the
- *    array stays dense and placed_structure_count stays accurate.
+ *
+ * Freed slots keep their data until the next structure_store_reclaim(), so
+ * the structure stays readable for the rest of the tick.
  *
  * Safe to call from any code path (demolish, cannon hit, etc.).
  */
 void destroy_placed_structure(uint32_t structure_id, float hit_x, float hit_y) {
     /* Find the target */
-    uint32_t idx = UINT32_MAX;
-    for (uint32_t i = 0; i < placed_structure_count; i++) {
-        if (placed_structures[i].active && placed_structures[i].id == structure_id) {
-            idx = i; break;
-        }
-    }
-    if (idx == UINT32_MAX) return; /* not found */
+    PlacedStructure *target = structure_by_id(structure_id);
+    if (!target) return; /* not found */
+    uint32_t idx = (uint32_t)(target - placed_structures);
 
     PlacedStructureType dtype = placed_structures[idx].type;
     float fx = placed_structures[idx].x;
@@ -2525,7 +2451,7 @@ void destroy_placed_structure(uint32_t structure_id, float hit_x, float hit_y) {
     }
 
     /* Mark primary dead and broadcast */
-    placed_structures[idx].active = false;
+    structure_free(target);
     char msg[256];
     if (!isnan(hit_x) && !isnan(hit_y)) {
         snprintf(msg, sizeof(msg),
@@ -2556,8 +2482,7 @@ void destroy_placed_structure(uint32_t structure_id, float hit_x, float hit_y) {
 
     /* ── Shipyard destroyed: release any scaffolded ship ──────────────── */
     if (dtype == STRUCT_SHIPYARD) {
-        /* Find the shipyard in the (still-in-array) slot — already marked inactive
-         * but idx is still valid before the compact pass at the end. */
+        /* Already freed, but the slot is not reused before the next reclaim */
         uint32_t rel_id = placed_structures[idx].scaffolded_ship_id;
         if (rel_id != 0 && global_sim) {
             for (uint32_t si = 0; si < global_sim->ship_count; si++) {
@@ -2574,14 +2499,10 @@ void destroy_placed_structure(uint32_t structure_id, float hit_x, float hit_y) {
     }
 
     /* ── Chest ruin: spawn resource wreck so items can be salvaged ─────── */
+    PlacedStructure *w = NULL;
     if (dtype == STRUCT_CHEST &&
         (chest_ruin_wood + chest_ruin_fiber + chest_ruin_metal + chest_ruin_stone) > 0 &&
-        placed_structure_count < MAX_PLACED_STRUCTURES) {
-        PlacedStructure *w = &placed_structures[placed_structure_count];
-        memset(w, 0, sizeof(*w));
-        w->active               = true;
-        w->id                   = next_structure_id++;
-        w->type                 = STRUCT_WRECK;
+        (w = structure_alloc(STRUCT_WRECK)) != NULL) {
         w->x                    = fx;
         w->y                    = fy;
         w->island_id            = fisland;
@@ -2592,7 +2513,6 @@ void destroy_placed_structure(uint32_t structure_id, float hit_x, float hit_y) {
         w->chest_stone          = chest_ruin_stone;
         w->wreck_expires_ms     = get_time_ms() + 900000u; /* 15 min */
         snprintf(w->placer_name, sizeof(w->placer_name), "chest_ruin");
-        placed_structure_count++;
 
         uint32_t wreck_id  = w->id;
         uint32_t wreck_exp = w->wreck_expires_ms;
@@ -2615,21 +2535,28 @@ void destroy_placed_structure(uint32_t structure_id, float hit_x, float hit_y) {
 
     /* ── Cascade: floor destroyed ──────────────────────────────────────── */
     if (dtype == STRUCT_WOODEN_FLOOR) {
-        for (uint32_t ci = 0; ci < placed_structure_count; ci++) {
-            PlacedStructure* c = &placed_structures[ci];
+        /* Everything the floor could have held: walls within 30 px, and
+         * workbenches and cannons inside its footprint */
+        static StructureNear held, support;
+        structure_index_near(&held, fx, fy, 36.0f,
+                             STRUCT_MASK(STRUCT_WORKBENCH) | STRUCT_MASK(STRUCT_WALL) |
+                             STRUCT_MASK(STRUCT_DOOR_FRAME) | STRUCT_MASK(STRUCT_DOOR) |
+                             STRUCT_MASK(STRUCT_CANNON));
+        for (uint32_t hk = 0; hk < held.count; hk++) {
+            PlacedStructure* c = &placed_structures[held.slots[hk]];
             if (!c->active) continue;
 
             if (c->type == STRUCT_WORKBENCH) {
                 if (fabsf(c->x - fx) > 25.0f || fabsf(c->y - fy) > 25.0f) continue;
                 /* Any other active floor still supporting this workbench? */
                 bool has = false;
-                for (uint32_t fi = 0; fi < placed_structure_count && !has; fi++) {
-                    PlacedStructure* f = &placed_structures[fi];
-                    if (!f->active || f->type != STRUCT_WOODEN_FLOOR) continue;
+                structure_index_near(&support, c->x, c->y, 25.0f, STRUCT_MASK(STRUCT_WOODEN_FLOOR));
+                for (uint32_t fk = 0; fk < support.count && !has; fk++) {
+                    PlacedStructure* f = &placed_structures[support.slots[fk]];
                     if (fabsf(c->x - f->x) <= 25.0f && fabsf(c->y - f->y) <= 25.0f) has = true;
                 }
                 if (!has) {
-                    c->active = false;
+                    structure_free(c);
                     char cm[128];
                     snprintf(cm, sizeof(cm),
                              "{\"type\":\"structure_demolished\",\"structure_id\":%u}", c->id);
@@ -2646,7 +2573,7 @@ void destroy_placed_structure(uint32_t structure_id, float hit_x, float hit_y) {
                 if (!has) {
                     bool was_frame = (c->type == STRUCT_DOOR_FRAME);
                     float dfx = c->x, dfy = c->y;
-                    c->active = false;
+                    structure_free(c);
                     char cm[128];
                     snprintf(cm, sizeof(cm),
                              "{\"type\":\"structure_demolished\",\"structure_id\":%u}", c->id);
@@ -2654,11 +2581,12 @@ void destroy_placed_structure(uint32_t structure_id, float hit_x, float hit_y) {
                     log_info("🔨 Cascade-demolished wall/frame/door %u (floor %u removed)", c->id, structure_id);
                     /* door_frame lost: cascade any door on it */
                     if (was_frame) {
-                        for (uint32_t di = 0; di < placed_structure_count; di++) {
-                            PlacedStructure* dp = &placed_structures[di];
-                            if (!dp->active || dp->type != STRUCT_DOOR) continue;
+                        structure_index_near(&support, dfx, dfy, 3.0f, STRUCT_MASK(STRUCT_DOOR));
+                        for (uint32_t dk = 0; dk < support.count; dk++) {
+                            PlacedStructure* dp = &placed_structures[support.slots[dk]];
+                            if (!dp->active) continue;
                             if (fabsf(dp->x - dfx) >= 3.0f || fabsf(dp->y - dfy) >= 3.0f) continue;
-                            dp->active = false;
+                            structure_free(dp);
                             char dm[128];
                             snprintf(dm, sizeof(dm),
                                      "{\"type\":\"structure_demolished\",\"structure_id\":%u}", dp->id);
@@ -2673,9 +2601,9 @@ void destroy_placed_structure(uint32_t structure_id, float hit_x, float hit_y) {
                  * Check using the same OBB test as place_cannon. */
                 const float HALF_TILE = 25.0f;
                 bool has_floor = false;
-                for (uint32_t fi = 0; fi < placed_structure_count && !has_floor; fi++) {
-                    PlacedStructure* f = &placed_structures[fi];
-                    if (!f->active || f->type != STRUCT_WOODEN_FLOOR) continue;
+                structure_index_near(&support, c->x, c->y, 36.0f, STRUCT_MASK(STRUCT_WOODEN_FLOOR));
+                for (uint32_t fk = 0; fk < support.count && !has_floor; fk++) {
+                    PlacedStructure* f = &placed_structures[support.slots[fk]];
                     if (f->company_id != c->company_id) continue;
                     float rad = f->rotation * (float)M_PI / 180.0f;
                     float fc  = cosf(-rad), fs = sinf(-rad);
@@ -2686,7 +2614,7 @@ void destroy_placed_structure(uint32_t structure_id, float hit_x, float hit_y) {
                     if (fabsf(lx) <= HALF_TILE && fabsf(ly) <= HALF_TILE) has_floor = true;
                 }
                 if (!has_floor) {
-                    c->active = false;
+                    structure_free(c);
                     char cm[128];
                     snprintf(cm, sizeof(cm),
                              "{\"type\":\"structure_demolished\",\"structure_id\":%u}", c->id);
@@ -2702,11 +2630,13 @@ void destroy_placed_structure(uint32_t structure_id, float hit_x, float hit_y) {
 
     /* ── Cascade: door_frame destroyed ────────────────────────────────── */
     if (dtype == STRUCT_DOOR_FRAME) {
-        for (uint32_t di = 0; di < placed_structure_count; di++) {
-            PlacedStructure* dp = &placed_structures[di];
-            if (!dp->active || dp->type != STRUCT_DOOR) continue;
+        static StructureNear doors;
+        structure_index_near(&doors, fx, fy, 3.0f, STRUCT_MASK(STRUCT_DOOR));
+        for (uint32_t dk = 0; dk < doors.count; dk++) {
+            PlacedStructure* dp = &placed_structures[doors.slots[dk]];
+            if (!dp->active) continue;
             if (fabsf(dp->x - fx) >= 3.0f || fabsf(dp->y - fy) >= 3.0f) continue;
-            dp->active = false;
+            structure_free(dp);
             char dm[128];
             snprintf(dm, sizeof(dm),
                      "{\"type\":\"structure_demolished\",\"structure_id\":%u}", dp->id);
@@ -2725,17 +2655,12 @@ void destroy_placed_structure(uint32_t structure_id, float hit_x, float hit_y) {
         const char *kind = dtype == STRUCT_WALL       ? "wall"
                          : dtype == STRUCT_DOOR_FRAME ? "door_frame"
                                                       : "floor";
-        cascade_orphan_ceilings(structure_id, kind);
-    }
-
-    /* ── Compact inactive entries out of the array in one pass ─────────── */
-    uint32_t write = 0;
-    for (uint32_t read = 0; read < placed_structure_count; read++) {
-        if (placed_structures[read].active)
-            placed_structures[write++] = placed_structures[read];
+        /* A wall props the ceilings either side of it (centres 25 px off);
+         * the floor cascade above takes out walls up to 30 px from the
+         * floor, whose ceilings sit another 25 px out */
+        float seed_r = dtype == STRUCT_WOODEN_FLOOR ? 55.0f : 25.0f;
+        cascade_orphan_ceilings(fx, fy, seed_r, structure_id, kind);
     }
-    placed_structure_count = write;
-    structure_index_rebuild();
 }
 
 /*
@@ -2841,6 +2766,8 @@ bool apply_structure_damage(PlacedStructure *s, uint32_t dmg, float hit_x, float
         destroy_placed_structure(sid, hit_x, hit_y);
         return true;
     }
+    /* Damage can drop a flag fort below its activation threshold */
+    if (s->type == STRUCT_FLAG_FORT) claim_fort_wake(s);
     /* Use impact position (hit_x/hit_y) so the client shows the damage number
      * at the cannonball's point of impact rather than the structure's centre. */
     float bx = (!isnan(hit_x)) ? hit_x : s->x;
@@ -2866,8 +2793,9 @@ void handle_demolish_structure(WebSocketPlayer* player, struct WebSocketClient*
     const char* sp = strstr(payload, "\"structure_id\":");
     if (sp) sscanf(sp + 15, "%u", &sid);
 
-    for (uint32_t i = 0; i < placed_structure_count; i++) {
-        if (!placed_structures[i].active || placed_structures[i].id != sid) continue;
+    PlacedStructure *target = structure_by_id(sid);
+    if (target) {
+        uint32_t i = (uint32_t)(target - placed_structures);
         float dx = player->x - placed_structures[i].x;
         float dy = player->y - placed_structures[i].y;
         if (dx*dx + dy*dy > STRUCT_INTERACT_R * STRUCT_INTERACT_R) {
@@ -3008,6 +2936,7 @@ void handle_demolish_module(WebSocketPlayer* player, struct WebSocketClient* cli
                     &ship->modules[mod_idx + 1],
                     ((size_t)ship->module_count - (size_t)mod_idx - 1) * sizeof(ShipModule));
             ship->module_count--;
+            ship_module_grid_invalidate(&ship->module_grid);
 
             /* Remove from global_sim counterpart */
             if (global_sim) {
@@ -3086,6 +3015,7 @@ void handle_demolish_module(WebSocketPlayer* player, struct WebSocketClient* cli
                 &ship->modules[mod_idx + 1],
                 ((size_t)ship->module_count - (size_t)mod_idx - 1) * sizeof(ShipModule));
         ship->module_count--;
+        ship_module_grid_invalidate(&ship->module_grid);
 
         /* Remove from global_sim counterpart */
         if (global_sim) {
@@ -3171,6 +3101,7 @@ void handle_demolish_module(WebSocketPlayer* player, struct WebSocketClient* cli
                     memmove(&ship->modules[m], &ship->modules[m + 1],
                             ((size_t)ship->module_count - m - 1) * sizeof(ShipModule));
                     ship->module_count--;
+                    ship_module_grid_invalidate(&ship->module_grid);
 
                     res_refund_module_demolish(player, t, casc_health, casc_max_hp);
                     /* do NOT increment m — we've shifted the array */
@@ -3313,6 +3244,7 @@ void handle_salvage_module(WebSocketPlayer* player, struct WebSocketClient* clie
                 &ship->modules[mod_idx + 1],
                 ((size_t)ship->module_count - (size_t)mod_idx - 1) * sizeof(ShipModule));
         ship->module_count--;
+        ship_module_grid_invalidate(&ship->module_grid);
 
         /* Remove from global_sim counterpart */
         if (global_sim) {
@@ -3427,10 +3359,8 @@ void handle_repair_structure(WebSocketPlayer* player, struct WebSocketClient* cl
     const char* sp = strstr(payload, "\"structure_id\":");
     if (sp) sscanf(sp + 15, "%u", &sid);
 
-    for (uint32_t i = 0; i < placed_structure_count; i++) {
-        PlacedStructure *s = &placed_structures[i];
-        if (!s->active || s->id != sid) continue;
-
+    PlacedStructure *s = structure_by_id(sid);
+    if (s) {
         /* Range */
         float dx = player->x - s->x;
         float dy = player->y - s->y;
@@ -3523,6 +3453,7 @@ void handle_repair_structure(WebSocketPlayer* player, struct WebSocketClient* cl
         s->repair_progress_ms = 0.0f;
         s->repair_start_hp    = s->hp;
         s->repair_broadcast_acc_ms = 0;
+        structure_repair_wake(s);
 
         /* Broadcast started */
         char smsg[256];
@@ -3547,112 +3478,150 @@ rs_send:;
     if (flen > 0 && flen < sizeof(frm)) send(client->fd, frm, flen, 0);
 }
 
-void structure_repair_tick(uint32_t delta_ms) {
-    if (delta_ms == 0) return;
-    /* Opportunistically run the garbage collector on every tick — the
-     * function is self-throttled to at most once every 30 s. */
-    structure_garbage_collect();
-    /* Rate: STRUCTURE_REPAIR_FULL_MS restores max_hp worth of HP.
-     * Under-construction structures also regen passively (no player required),
-     * but at half the rate (60s for full HP vs 30s for player-assisted). */
-    const uint32_t CONSTRUCTION_RATE_MS = 60000u; /* 60s passive build regen */
-    for (uint32_t i = 0; i < placed_structure_count; i++) {
-        PlacedStructure *s = &placed_structures[i];
-        if (!s->active) continue;
+/* ── Repair / construction timers ────────────────────────────────────────
+ * A structure being repaired by a player, or building up passively after a
+ * schematic placement, keeps a per-tick timer on the game timer wheel
+ * (repair_timer); every other structure holds none.  Whatever starts the
+ * work calls structure_repair_wake(). */
 
-        /* Determine whether this tick should run for this structure */
-        bool passive_construction = s->under_construction && s->hp < s->target_hp;
-        if (s->repair_player_id == 0 && !passive_construction) continue;
+/* Rate: STRUCTURE_REPAIR_FULL_MS restores max_hp worth of HP.
+ * Under-construction structures also regen passively (no player required),
+ * but at half the rate (60s for full HP vs 30s for player-assisted). */
+#define CONSTRUCTION_RATE_MS 60000u /* 60s passive build regen */
 
-        /* If structure was destroyed mid-repair, repair_player_id was cleared
-         * by destroy_placed_structure (active=false). Skip stale state. */
-        if (!passive_construction && (s->target_hp >= s->max_hp || s->max_hp == 0)) {
-            /* Nothing more to repair */
-            s->repair_player_id   = 0;
-            s->repair_progress_ms = 0.0f;
-            continue;
+static void structure_repair_fire(uint32_t arg, uint32_t now_ms, uint32_t elapsed_ms);
+
+static TimerKind structure_repair_kind(void) {
+    static TimerKind kind;
+    if (!kind) kind = timer_wheel_kind("kind=\"structure_repair\"", structure_repair_fire);
+    return kind;
+}
+
+static bool structure_repair_due(const PlacedStructure *s) {
+    return s->repair_player_id != 0 || (s->under_construction && s->hp < s->target_hp);
+}
+
+void structure_repair_wake(PlacedStructure *s) {
+    if (!s || !s->active || !structure_repair_due(s)) return;
+    if (timer_wheel_pending(s->repair_timer)) return;
+    s->repair_timer = timer_wheel_schedule(structure_repair_kind(), structure_handle(s),
+                                           get_time_ms(), 0);
+}
+
+void structure_repairs_wake_all(void) {
+    uint32_t live_n;
+    const uint32_t *live = structure_live_slots(&live_n);
+    for (uint32_t i = 0; i < live_n; i++) structure_repair_wake(&placed_structures[live[i]]);
+}
+
+/* Advance one structure's repair or construction by delta_ms */
+static void structure_repair_step(PlacedStructure *s, uint32_t delta_ms) {
+    /* Determine whether this tick should run for this structure */
+    bool passive_construction = s->under_construction && s->hp < s->target_hp;
+    if (s->repair_player_id == 0 && !passive_construction) return;
+
+    /* If structure was destroyed mid-repair, repair_player_id was cleared
+     * by destroy_placed_structure (structure_free). Skip stale state. */
+    if (!passive_construction && (s->target_hp >= s->max_hp || s->max_hp == 0)) {
+        /* Nothing more to repair */
+        s->repair_player_id   = 0;
+        s->repair_progress_ms = 0.0f;
+        return;
+    }
+    /* Flag fort entering CLAIMING is impossible mid-repair, but defensive: */
+    if (s->repair_player_id != 0 &&
+        s->type == STRUCT_FLAG_FORT && s->claim_phase == FLAG_FORT_PHASE_CLAIMING) {
+        s->repair_player_id   = 0;
+        s->repair_progress_ms = 0.0f;
+        return;
+    }
+
+    /* Choose rate: player-assisted uses STRUCTURE_REPAIR_FULL_MS; passive construction is slower */
+    uint32_t rate_ms = (s->repair_player_id != 0)
+        ? STRUCTURE_REPAIR_FULL_MS
+        : CONSTRUCTION_RATE_MS;
+
+    s->repair_progress_ms += (float)delta_ms;
+    s->repair_broadcast_acc_ms += delta_ms;
+    /* HP gained = max_hp * delta / rate_ms, accumulated fractional */
+    float hp_gained_f = (float)s->max_hp * s->repair_progress_ms / (float)rate_ms;
+    uint32_t hp_gain_int = (uint32_t)hp_gained_f;
+    if (hp_gain_int > 0) {
+        /* Reset accumulator carry for next tick */
+        float consumed_ms = (float)hp_gain_int * (float)rate_ms / (float)s->max_hp;
+        s->repair_progress_ms -= consumed_ms;
+        if (s->repair_progress_ms < 0.0f) s->repair_progress_ms = 0.0f;
+
+        if (passive_construction) {
+            /* Construction regen: raise hp toward target_hp only */
+            uint32_t new_hp = s->hp + hp_gain_int;
+            if (new_hp > s->target_hp) new_hp = s->target_hp;
+            s->hp = new_hp;
+        } else {
+            uint32_t cap = s->max_hp;
+            uint32_t new_hp        = s->hp + hp_gain_int;
+            uint32_t new_target_hp = s->target_hp + hp_gain_int;
+            if (new_hp        > cap) new_hp        = cap;
+            if (new_target_hp > cap) new_target_hp = cap;
+            s->hp        = new_hp;
+            s->target_hp = new_target_hp;
         }
-        /* Flag fort entering CLAIMING is impossible mid-repair, but defensive: */
-        if (s->repair_player_id != 0 &&
-            s->type == STRUCT_FLAG_FORT && s->claim_phase == FLAG_FORT_PHASE_CLAIMING) {
+    }
+
+    /* Throttle hp_changed broadcasts to ~1Hz so clients see steady
+     * progress without flooding. Always broadcast on completion. */
+    int complete = passive_construction
+        ? (s->hp >= s->target_hp ? 1 : 0)
+        : (s->target_hp >= s->max_hp ? 1 : 0);
+    if (s->repair_broadcast_acc_ms < 1000u && !complete) return;
+    s->repair_broadcast_acc_ms = 0;
+
+    /* Broadcast hp change */
+    char msg[224];
+    snprintf(msg, sizeof(msg),
+             "{\"type\":\"structure_hp_changed\","
+             "\"structure_id\":%u,\"hp\":%u,\"max_hp\":%u,\"target_hp\":%u"
+             ",\"x\":%.1f,\"y\":%.1f}",
+             s->id, (unsigned)s->hp, (unsigned)s->max_hp, (unsigned)s->target_hp, s->x, s->y);
+    websocket_server_broadcast(msg);
+
+    /* Completion */
+    if (complete) {
+        if (passive_construction) {
+            /* Construction finished */
+            s->under_construction = false;
+            s->repair_progress_ms = 0.0f;
+            s->repair_broadcast_acc_ms = 0;
+            log_info("🏗️ Construction complete on structure %u", s->id);
+        } else {
+            uint32_t pid = s->repair_player_id;
             s->repair_player_id   = 0;
             s->repair_progress_ms = 0.0f;
-            continue;
-        }
-
-        /* Choose rate: player-assisted uses STRUCTURE_REPAIR_FULL_MS; passive construction is slower */
-        uint32_t rate_ms = (s->repair_player_id != 0)
-            ? STRUCTURE_REPAIR_FULL_MS
-            : CONSTRUCTION_RATE_MS;
-
-        s->repair_progress_ms += (float)delta_ms;
-        s->repair_broadcast_acc_ms += delta_ms;
-        /* HP gained = max_hp * delta / rate_ms, accumulated fractional */
-        float hp_gained_f = (float)s->max_hp * s->repair_progress_ms / (float)rate_ms;
-        uint32_t hp_gain_int = (uint32_t)hp_gained_f;
-        if (hp_gain_int > 0) {
-            /* Reset accumulator carry for next tick */
-            float consumed_ms = (float)hp_gain_int * (float)rate_ms / (float)s->max_hp;
-            s->repair_progress_ms -= consumed_ms;
-            if (s->repair_progress_ms < 0.0f) s->repair_progress_ms = 0.0f;
-
-            if (passive_construction) {
-                /* Construction regen: raise hp toward target_hp only */
-                uint32_t new_hp = s->hp + hp_gain_int;
-                if (new_hp > s->target_hp) new_hp = s->target_hp;
-                s->hp = new_hp;
-            } else {
-                uint32_t cap = s->max_hp;
-                uint32_t new_hp        = s->hp + hp_gain_int;
-                uint32_t new_target_hp = s->target_hp + hp_gain_int;
-                if (new_hp        > cap) new_hp        = cap;
-                if (new_target_hp > cap) new_target_hp = cap;
-                s->hp        = new_hp;
-                s->target_hp = new_target_hp;
-            }
-        }
-
-        /* Throttle hp_changed broadcasts to ~1Hz so clients see steady
-         * progress without flooding. Always broadcast on completion. */
-        int complete = passive_construction
-            ? (s->hp >= s->target_hp ? 1 : 0)
-            : (s->target_hp >= s->max_hp ? 1 : 0);
-        if (s->repair_broadcast_acc_ms < 1000u && !complete) continue;
-        s->repair_broadcast_acc_ms = 0;
-
-        /* Broadcast hp change */
-        char msg[224];
-        snprintf(msg, sizeof(msg),
-                 "{\"type\":\"structure_hp_changed\","
-                 "\"structure_id\":%u,\"hp\":%u,\"max_hp\":%u,\"target_hp\":%u"
-                 ",\"x\":%.1f,\"y\":%.1f}",
-                 s->id, (unsigned)s->hp, (unsigned)s->max_hp, (unsigned)s->target_hp, s->x, s->y);
-        websocket_server_broadcast(msg);
-
-        /* Completion */
-        if (complete) {
-            if (passive_construction) {
-                /* Construction finished */
-                s->under_construction = false;
-                s->repair_progress_ms = 0.0f;
-                s->repair_broadcast_acc_ms = 0;
-                log_info("🏗️ Construction complete on structure %u", s->id);
-            } else {
-                uint32_t pid = s->repair_player_id;
-                s->repair_player_id   = 0;
-                s->repair_progress_ms = 0.0f;
-                s->repair_broadcast_acc_ms = 0;
-                char cmsg[160];
-                snprintf(cmsg, sizeof(cmsg),
-                         "{\"type\":\"repair_complete\",\"structure_id\":%u,\"player_id\":%u}",
-                         s->id, pid);
-                websocket_server_broadcast(cmsg);
-                log_info("🔧 Repair complete on structure %u (player %u)", s->id, pid);
-            }
+            s->repair_broadcast_acc_ms = 0;
+            char cmsg[160];
+            snprintf(cmsg, sizeof(cmsg),
+                     "{\"type\":\"repair_complete\",\"structure_id\":%u,\"player_id\":%u}",
+                     s->id, pid);
+            websocket_server_broadcast(cmsg);
+            log_info("🔧 Repair complete on structure %u (player %u)", s->id, pid);
         }
     }
 }
 
+static void structure_repair_fire(uint32_t arg, uint32_t now_ms, uint32_t elapsed_ms) {
+    PlacedStructure *s = structure_from_handle(arg);
+    if (!s) return;   /* destroyed mid-repair */
+    /* A newer timer owns this structure (re-armed after a world reload) */
+    if (timer_wheel_pending(s->repair_timer)) return;
+    s->repair_timer = 0;
+    uint32_t hp_before = s->hp;
+    structure_repair_step(s, elapsed_ms);
+    /* A repaired flag fort may cross its activation threshold */
+    if (s->type == STRUCT_FLAG_FORT && s->hp != hp_before) claim_fort_wake(s);
+    if (structure_repair_due(s))
+        s->repair_timer = timer_wheel_schedule(structure_repair_kind(), arg, now_ms, 0);
+}
+
 /*
  * structure_garbage_collect — remove any active structure left with hp=0.
  *
@@ -3672,28 +3641,23 @@ void structure_garbage_collect(void) {
     if (now < next_run_ms) return;
     next_run_ms = now + 30000u; /* run at most every 30 s */
 
+    /* Slots stay put when structures are destroyed, so one pass suffices;
+     * cascade victims later in the array are skipped as inactive. */
     uint32_t purged = 0;
-    bool found = true;
-    while (found) {
-        found = false;
-        for (uint32_t i = 0; i < placed_structure_count; i++) {
-            PlacedStructure *s = &placed_structures[i];
-            if (!s->active)     continue;
-            if (s->max_hp == 0) continue; /* 0 max_hp = intentionally has no health bar */
-            if (s->hp != 0)     continue; /* still alive */
-
-            /* Exemptions */
-            if (s->type == STRUCT_CLAIM_FLAG) continue;
-            if (s->type == STRUCT_FLAG_FORT && s->claim_phase == FLAG_FORT_PHASE_CLAIMING) continue;
-
-            log_info("🗑️ GC: purging dead structure id=%u type=%u at (%.0f, %.0f)",
-                     (unsigned)s->id, (unsigned)s->type, s->x, s->y);
-            uint32_t sid = s->id;
-            destroy_placed_structure(sid, NAN, NAN); /* may compact array — restart scan */
-            purged++;
-            found = true;
-            break; /* restart outer while loop with fresh indices */
-        }
+    for (uint32_t i = 0; i < placed_structure_count; i++) {
+        PlacedStructure *s = &placed_structures[i];
+        if (!s->active)     continue;
+        if (s->max_hp == 0) continue; /* 0 max_hp = intentionally has no health bar */
+        if (s->hp != 0)     continue; /* still alive */
+
+        /* Exemptions */
+        if (s->type == STRUCT_CLAIM_FLAG) continue;
+        if (s->type == STRUCT_FLAG_FORT && s->claim_phase == FLAG_FORT_PHASE_CLAIMING) continue;
+
+        log_info("🗑️ GC: purging dead structure id=%u type=%u at (%.0f, %.0f)",
+                 (unsigned)s->id, (unsigned)s->type, s->x, s->y);
+        destroy_placed_structure(s->id, NAN, NAN);
+        purged++;
     }
     if (purged > 0) {
         log_info("🗑️ GC: purged %u dead structure(s)", purged);
@@ -3720,9 +3684,8 @@ void handle_door_lock(WebSocketPlayer* player, struct WebSocketClient* client, c
         goto dl_send;
     }
 
-    for (uint32_t i = 0; i < placed_structure_count; i++) {
-        PlacedStructure *s = &placed_structures[i];
-        if (!s->active || s->id != sid) continue;
+    PlacedStructure *s = structure_by_id(sid);
+    if (s) {
         if (s->type != STRUCT_DOOR) {
             snprintf(response, sizeof(response),
                      "{\"type\":\"door_lock_fail\",\"reason\":\"not_a_door\"}");
@@ -6,7 +6,10 @@
 #include "net/bucket_bail.h"
 #include "sim/ship_level.h"
 #include "sim/island.h"
+#include "sim/hull_sdf.h"
 #include "sim/world_save.h"
+#include "sim/replay.h"
+#include "sim/ship_flooding.h"
 #include "server.h"
 #include "net/websocket_protocol.h"
 #include "net/network.h"
@@ -14,6 +17,10 @@
 #include "core/math.h"
 #include "util/log.h"
 #include "util/time.h"
+#include "util/profiler.h"
+#include "util/metrics.h"
+#include "util/timer_wheel.h"
+#include "rewind_buffer.h"
 #include <string.h>
 #include <strings.h>
 #include <stdbool.h>
@@ -95,6 +102,8 @@ static int structure_quality_tier(const PlacedStructure* s) {
 #define WS_OPCODE_CLOSE 0x8
 #define WS_OPCODE_PING 0x9
 #define WS_OPCODE_PONG 0xA
+#define WS_PING_INTERVAL_MS 1000   /* RTT probe for lag compensation */
+#define WS_PING_TIMEOUT_MS  5000   /* Give up on an unanswered probe */
 
 /* ISLANDS JSON + WebSocket frame buffers. Procedural tree resources push the
  * payload past 2 MB; keep headroom for future island growth. */
@@ -213,6 +222,7 @@ typedef struct {
     char            owner_name[64];
     PlayerInventory inventory;      /* full copy of player inventory at time of death */
     uint32_t        spawn_time_ms;
+    TimerHandle     expiry_timer;   /* TOMBSTONE_TTL_MS despawn on the timer wheel */
     bool            active;
 } Tombstone;
 
@@ -223,6 +233,8 @@ static int       tombstone_live_count = 0;
 static void tombstone_deactivate(Tombstone* t) {
     if (t && t->active) {
         t->active = false;
+        timer_wheel_cancel(t->expiry_timer);
+        t->expiry_timer = 0;
         if (tombstone_live_count > 0) tombstone_live_count--;
     }
 }
@@ -240,6 +252,7 @@ typedef struct {
     float    local_x, local_y; /* ship-local offset when ship_id != 0 */
     uint8_t  deck_level;    /* 0 = lower deck, 1 = upper deck (when ship_id != 0) */
     uint32_t spawn_time_ms;
+    TimerHandle expiry_timer; /* DROPPED_ITEM_TTL_MS despawn on the timer wheel */
     bool     active;
     /* Quality blueprint schematic — pickup adds to player->schematics[], not bag. */
     bool            is_schematic;
@@ -251,18 +264,67 @@ static DroppedItem dropped_items[MAX_DROPPED_ITEMS];
 static uint32_t    next_dropped_item_id = 1;
 static int         dropped_item_live_count = 0;
 
-static void dropped_item_activate(DroppedItem* di) {
-    di->active = true;
-    dropped_item_live_count++;
-}
+static void dropped_item_activate(DroppedItem* di);
 
 static void dropped_item_deactivate(DroppedItem* di) {
     if (di && di->active) {
         di->active = false;
+        timer_wheel_cancel(di->expiry_timer);
+        di->expiry_timer = 0;
         if (dropped_item_live_count > 0) dropped_item_live_count--;
     }
 }
 
+/* ── Tombstone / dropped item expiry ──────────────────────────────────────────
+ * One timer per live entry, armed at spawn and cancelled on pickup; arg is the
+ * array slot and the handler checks the id still matches. */
+static void tombstone_expire(uint32_t arg, uint32_t now_ms, uint32_t elapsed_ms);
+static void dropped_item_expire(uint32_t arg, uint32_t now_ms, uint32_t elapsed_ms);
+
+static TimerKind tombstone_expiry_kind(void) {
+    static TimerKind kind;
+    if (!kind) kind = timer_wheel_kind("kind=\"tombstone\"", tombstone_expire);
+    return kind;
+}
+
+static TimerKind dropped_item_expiry_kind(void) {
+    static TimerKind kind;
+    if (!kind) kind = timer_wheel_kind("kind=\"dropped_item\"", dropped_item_expire);
+    return kind;
+}
+
+static void tombstone_expire(uint32_t arg, uint32_t now_ms, uint32_t elapsed_ms) {
+    (void)now_ms; (void)elapsed_ms;
+    if (arg >= MAX_TOMBSTONES) return;
+    Tombstone* t = &tombstones[arg];
+    if (!t->active) return;
+    t->expiry_timer = 0;
+    tombstone_deactivate(t);
+    char dm[128];
+    snprintf(dm, sizeof(dm),
+        "{\"type\":\"tombstone_despawned\",\"id\":%u}", t->id);
+    websocket_server_broadcast(dm);
+    log_info("⚰️  Tombstone %u expired (15-min TTL)", t->id);
+}
+
+static void dropped_item_activate(DroppedItem* di) {
+    di->active = true;
+    dropped_item_live_count++;
+    di->expiry_timer = timer_wheel_schedule(dropped_item_expiry_kind(),
+                                            (uint32_t)(di - dropped_items),
+                                            di->spawn_time_ms, DROPPED_ITEM_TTL_MS);
+}
+
+static void dropped_item_expire(uint32_t arg, uint32_t now_ms, uint32_t elapsed_ms) {
+    (void)now_ms; (void)elapsed_ms;
+    if (arg >= MAX_DROPPED_ITEMS) return;
+    DroppedItem* di = &dropped_items[arg];
+    if (!di->active) return;
+    di->expiry_timer = 0;
+    dropped_item_deactivate(di);
+    log_info("📦  Dropped item %u expired (5-min TTL)", di->id);
+}
+
 /* ── Grapple hook system ──────────────────────────────────────────────────────
  * Each connected player slot has one grapple hook entry.  Hooks travel as
  * projectiles, attach to the first valid target in range, then pull that
@@ -305,7 +367,7 @@ typedef struct {
     float        vel_x, vel_y;  /* direction the hook is flying                  */
     float        origin_x, origin_y;
     int          target_type;   /* GRAPPLE_TARGET_* once attached                */
-    uint32_t     target_id;     /* id of attached entity                         */
+    uint32_t     target_id;     /* id of attached entity (StructureHandle for wrecks) */
     uint32_t     fire_time_ms;
     float        max_range;     /* charge-scaled range for this shot (px)        */
     float        rope_length;   /* current max allowed rope length (px)          */
@@ -549,6 +611,45 @@ static size_t g_gs_total_last = 0, g_gs_total_max = 0;
 static size_t g_gs_ships_last = 0, g_gs_players_last = 0, g_gs_npcs_last = 0;
 static size_t g_gs_proj_last = 0, g_gs_tmb_last = 0, g_gs_ditem_last = 0, g_gs_co_last = 0;
 
+/* Exported on GET /metrics; registered in websocket_server_init. */
+static struct {
+    metric_id bytes_game_state;
+    metric_id bytes_hit_events;
+    metric_id bytes_broadcast;
+    metric_id bytes_direct;
+    metric_id send_eagain;
+    metric_id send_errors;
+    metric_id send_deferred;       /* Clients pushed to next tick by the RR budget */
+    metric_id gs_payload;
+    metric_id blob_build;
+    metric_id blob_fallback;
+} g_ws_metrics;
+
+static void register_ws_metrics(void) {
+    if (g_ws_metrics.bytes_game_state) return;   /* Already registered */
+    static const char help_bytes[] = "WebSocket bytes handed to send(), by stream.";
+    g_ws_metrics.bytes_game_state = metrics_counter("pirate_ws_sent_bytes", help_bytes, "stream=\"game_state\"");
+    g_ws_metrics.bytes_hit_events = metrics_counter("pirate_ws_sent_bytes", help_bytes, "stream=\"hit_events\"");
+    g_ws_metrics.bytes_broadcast  = metrics_counter("pirate_ws_sent_bytes", help_bytes, "stream=\"broadcast\"");
+    g_ws_metrics.bytes_direct     = metrics_counter("pirate_ws_sent_bytes", help_bytes, "stream=\"direct\"");
+    g_ws_metrics.send_eagain = metrics_counter("pirate_ws_send_eagain",
+        "GAME_STATE frames skipped because the socket buffer was full.", NULL);
+    g_ws_metrics.send_errors = metrics_counter("pirate_ws_send_errors",
+        "Hard send errors that disconnected a client.", NULL);
+    g_ws_metrics.send_deferred = metrics_gauge("pirate_ws_send_deferred_clients",
+        "Clients deferred to the next tick by the per-tick send budget.", NULL);
+    static const uint64_t payload_bounds[] = { 1024, 4096, 8192, 16384, 32768, 65536, 131072, 262144 };
+    g_ws_metrics.gs_payload = metrics_histogram("pirate_ws_game_state_bytes",
+        "Per-client GAME_STATE payload size.", NULL,
+        payload_bounds, (int)(sizeof(payload_bounds) / sizeof(payload_bounds[0])), 1.0);
+    static const uint64_t build_bounds_us[] = { 250, 500, 1000, 2000, 5000, 10000, 20000, 50000 };
+    g_ws_metrics.blob_build = metrics_histogram("pirate_blob_build_seconds",
+        "Shared snapshot blob build time on the blob worker.", NULL,
+        build_bounds_us, (int)(sizeof(build_bounds_us) / sizeof(build_bounds_us[0])), 1e-6);
+    g_ws_metrics.blob_fallback = metrics_counter("pirate_blob_fallback_builds",
+        "Blob builds done synchronously on the tick thread.", NULL);
+}
+
 /* Compact list of live player slots — maintained on connect/disconnect so blob
  * submit avoids scanning all WS_MAX_CLIENTS every tick. */
 static uint8_t g_player_active_slots[WS_MAX_CLIENTS];
@@ -734,8 +835,8 @@ static void yard_add_nearby_chest_resources(const PlacedStructure *sy, float yr2
                                           uint32_t *wood, uint32_t *fiber,
                                           uint32_t *metal, uint32_t *stone)
 {
-    const uint32_t *cslots = structure_index_chest_slots();
-    uint32_t cc = structure_index_chest_count();
+    uint32_t cc;
+    const uint32_t *cslots = structure_slots_of_type(STRUCT_CHEST, &cc);
     for (uint32_t ci = 0; ci < cc; ci++) {
         PlacedStructure *c = &placed_structures[cslots[ci]];
         float cdx = c->x - sy->x, cdy = c->y - sy->y;
@@ -778,8 +879,8 @@ static bool res_can_afford_combined_cost(const WebSocketPlayer *p, const SimpleS
     if (s) {
         const float YR = 50.0f; /* 500 client-px — matches client YARD_RANGE_SQ */
         const float YR2 = YR * YR;
-        const uint32_t *yslots = structure_index_shipyard_slots();
-        uint32_t yc = structure_index_shipyard_count();
+        uint32_t yc;
+        const uint32_t *yslots = structure_slots_of_type(STRUCT_SHIPYARD, &yc);
         for (uint32_t yi = 0; yi < yc; yi++) {
             PlacedStructure *sy = &placed_structures[yslots[yi]];
             float sdx = s->x - sy->x, sdy = s->y - sy->y;
@@ -809,8 +910,8 @@ static void res_consume_combined_cost(WebSocketPlayer *p, SimpleShip *s,
     if (s) {
         const float YR = 50.0f;
         const float YR2 = YR * YR;
-        const uint32_t *yslots = structure_index_shipyard_slots();
-        uint32_t yc = structure_index_shipyard_count();
+        uint32_t yc;
+        const uint32_t *yslots = structure_slots_of_type(STRUCT_SHIPYARD, &yc);
         for (uint32_t yi = 0; yi < yc && (need_wood || need_fiber || need_metal || need_stone); yi++) {
             PlacedStructure *sy = &placed_structures[yslots[yi]];
             float sdx = s->x - sy->x, sdy = s->y - sy->y;
@@ -820,8 +921,8 @@ static void res_consume_combined_cost(WebSocketPlayer *p, SimpleShip *s,
             take = need_fiber <= sy->chest_fiber ? need_fiber : sy->chest_fiber; sy->chest_fiber -= take; need_fiber -= take;
             take = need_metal <= sy->chest_metal ? need_metal : sy->chest_metal; sy->chest_metal -= take; need_metal -= take;
             take = need_stone <= sy->chest_stone ? need_stone : sy->chest_stone; sy->chest_stone -= take; need_stone -= take;
-            const uint32_t *cslots = structure_index_chest_slots();
-            uint32_t cc = structure_index_chest_count();
+            uint32_t cc;
+            const uint32_t *cslots = structure_slots_of_type(STRUCT_CHEST, &cc);
             for (uint32_t ci = 0; ci < cc && (need_wood || need_fiber || need_metal || need_stone); ci++) {
                 PlacedStructure *c = &placed_structures[cslots[ci]];
                 float cdx = c->x - sy->x, cdy = c->y - sy->y;
@@ -859,8 +960,8 @@ static void yard_pool_totals(const SimpleShip *s,
     if (!s) return;
     const float YR = 50.0f;
     const float YR2 = YR * YR;
-    const uint32_t *yslots = structure_index_shipyard_slots();
-    uint32_t yc = structure_index_shipyard_count();
+    uint32_t yc;
+    const uint32_t *yslots = structure_slots_of_type(STRUCT_SHIPYARD, &yc);
     for (uint32_t yi = 0; yi < yc; yi++) {
         PlacedStructure *sy = &placed_structures[yslots[yi]];
         float sdx = s->x - sy->x, sdy = s->y - sy->y;
@@ -893,8 +994,8 @@ static void res_consume_yard_cost(SimpleShip *s, const ShipModuleResourceCost *c
     uint16_t need_stone = cost->stone;
     const float YR = 50.0f;
     const float YR2 = YR * YR;
-    const uint32_t *yslots = structure_index_shipyard_slots();
-    uint32_t yc = structure_index_shipyard_count();
+    uint32_t yc;
+    const uint32_t *yslots = structure_slots_of_type(STRUCT_SHIPYARD, &yc);
     for (uint32_t yi = 0; yi < yc && (need_wood || need_fiber || need_metal || need_stone); yi++) {
         PlacedStructure *sy = &placed_structures[yslots[yi]];
         float sdx = s->x - sy->x, sdy = s->y - sy->y;
@@ -904,8 +1005,8 @@ static void res_consume_yard_cost(SimpleShip *s, const ShipModuleResourceCost *c
         take = need_fiber <= sy->chest_fiber ? need_fiber : sy->chest_fiber; sy->chest_fiber -= take; need_fiber -= take;
         take = need_metal <= sy->chest_metal ? need_metal : sy->chest_metal; sy->chest_metal -= take; need_metal -= take;
         take = need_stone <= sy->chest_stone ? need_stone : sy->chest_stone; sy->chest_stone -= take; need_stone -= take;
-        const uint32_t *cslots = structure_index_chest_slots();
-        uint32_t cc = structure_index_chest_count();
+        uint32_t cc;
+        const uint32_t *cslots = structure_slots_of_type(STRUCT_CHEST, &cc);
         for (uint32_t ci = 0; ci < cc && (need_wood || need_fiber || need_metal || need_stone); ci++) {
             PlacedStructure *c = &placed_structures[cslots[ci]];
             float cdx = c->x - sy->x, cdy = c->y - sy->y;
@@ -1066,8 +1167,10 @@ static void sync_simple_ships_from_simulation(void) {
     // For every active shipyard that has a scaffolded_ship_id, snap the sim
     // ship's position/rotation to the dock center and zero its velocities so
     // it never drifts away during construction.
-    for (uint32_t yi = 0; yi < structure_index_shipyard_count(); yi++) {
-        PlacedStructure* sy = &placed_structures[structure_index_shipyard_slots()[yi]];
+    uint32_t yc;
+    const uint32_t *yslots = structure_slots_of_type(STRUCT_SHIPYARD, &yc);
+    for (uint32_t yi = 0; yi < yc; yi++) {
+        PlacedStructure* sy = &placed_structures[yslots[yi]];
         if (sy->scaffolded_ship_id == 0) continue;
 
         struct Ship* sim_ship = find_sim_ship(sy->scaffolded_ship_id);
@@ -1108,6 +1211,43 @@ static void sync_simple_ships_from_simulation(void) {
      * dock angular-velocity constraint is not overwritten by the rudder setter. */
 }
 
+// ── Lag compensation ─────────────────────────────────────────────────────────
+// One SoA frame of every active ship's transform per tick; hit-scan weapons
+// rewind targets to the instant the shooter was seeing.
+
+static rewind_ship_history_t g_ship_history;
+
+static void record_ship_history(void) {
+    static uint16_t ids[REWIND_SHIP_MAX];
+    static float    xs[REWIND_SHIP_MAX], ys[REWIND_SHIP_MAX], rots[REWIND_SHIP_MAX];
+    int n = 0;
+    for (int s = 0; s < ship_count && n < REWIND_SHIP_MAX; s++) {
+        if (!ships[s].active) continue;
+        ids[n]  = ships[s].ship_id;
+        xs[n]   = ships[s].x;
+        ys[n]   = ships[s].y;
+        rots[n] = ships[s].rotation;
+        n++;
+    }
+    rewind_ships_record(&g_ship_history, global_sim ? global_sim->tick : 0, get_time_ms(),
+                        n, ids, xs, ys, rots);
+}
+
+uint32_t lag_comp_view_ms(const WebSocketPlayer* player) {
+    uint32_t now = get_time_ms();
+    if (!player) return now;
+    for (int i = 0; i < WS_MAX_CLIENTS; i++) {
+        const struct WebSocketClient* c = &ws_server.clients[i];
+        if (c->connected && c->player_id == player->player_id)
+            return now - rewind_window_ms(c->rtt_ms);
+    }
+    return now;
+}
+
+bool lag_comp_ship_at(uint16_t ship_id, uint32_t view_ms, float* x, float* y, float* rot) {
+    return rewind_ships_sample(&g_ship_history, ship_id, view_ms, x, y, rot);
+}
+
 __attribute__((unused))
 static void ship_clamp_to_deck(const SimpleShip* ship, float* local_x, float* local_y) {
     if (*local_x < ship->deck_min_x) *local_x = ship->deck_min_x;
@@ -1171,8 +1311,6 @@ static bool grapple_ray_hull_intersect(const struct Ship* sim_ship,
 #define GRAPPLE_HULL_ATTACH_TOL 28.0f  /* hook must be this close to the hull edge (px) */
 #define GRAPPLE_HULL_INSET      25.0f  /* px inward from hull edge — contact, not plank snap */
 
-static float player_dist_to_hull_edge_client(float lx, float ly, const struct Ship* sim_ship);
-
 /** Hull-edge attach point on the bearing from ship centre through (hook_lx, hook_ly). */
 static bool grapple_bearing_hull_attach(const struct Ship* sim_ship,
                                           float hook_lx, float hook_ly,
@@ -1191,7 +1329,7 @@ static bool grapple_hook_on_hull(const SimpleShip* ship, const struct Ship* sim_
     if (!ship || !sim_ship || sim_ship->hull_vertex_count < 3) return false;
     float hlx, hly;
     ship_world_to_local(ship, hook_wx, hook_wy, &hlx, &hly);
-    if (player_dist_to_hull_edge_client(hlx, hly, sim_ship) > GRAPPLE_HULL_ATTACH_TOL)
+    if (hull_sdf_edge_dist(sim_ship, hlx, hly) > GRAPPLE_HULL_ATTACH_TOL)
         return false;
     return grapple_bearing_hull_attach(sim_ship, hlx, hly, out_lx, out_ly);
 }
@@ -1268,63 +1406,24 @@ static void grapple_attach_to_ship(GrappleHook* gh, SimpleShip* ship,
 
 #define PLAYER_HULL_TOUCH_RADIUS 8.0f  /* client px — matches sim player radius */
 
-static bool player_point_in_hull_client(float lx, float ly, const struct Ship* sim_ship) {
-    int n = sim_ship->hull_vertex_count;
-    if (n < 3) return false;
-    bool inside = false;
-    for (int i = 0, j = n - 1; i < n; j = i++) {
-        float xi = SERVER_TO_CLIENT(Q16_TO_FLOAT(sim_ship->hull_vertices[i].x));
-        float yi = SERVER_TO_CLIENT(Q16_TO_FLOAT(sim_ship->hull_vertices[i].y));
-        float xj = SERVER_TO_CLIENT(Q16_TO_FLOAT(sim_ship->hull_vertices[j].x));
-        float yj = SERVER_TO_CLIENT(Q16_TO_FLOAT(sim_ship->hull_vertices[j].y));
-        if (((yi > ly) != (yj > ly)) &&
-            (lx < (xj - xi) * (ly - yi) / (yj - yi + 1e-12f) + xi))
-            inside = !inside;
-    }
-    return inside;
-}
-
-static float player_dist_to_hull_edge_client(float lx, float ly, const struct Ship* sim_ship) {
-    float min_dist_sq = 1e20f;
-    int n = sim_ship->hull_vertex_count;
-    for (int i = 0; i < n; i++) {
-        int j = (i + 1) % n;
-        float ax = SERVER_TO_CLIENT(Q16_TO_FLOAT(sim_ship->hull_vertices[i].x));
-        float ay = SERVER_TO_CLIENT(Q16_TO_FLOAT(sim_ship->hull_vertices[i].y));
-        float bx = SERVER_TO_CLIENT(Q16_TO_FLOAT(sim_ship->hull_vertices[j].x));
-        float by = SERVER_TO_CLIENT(Q16_TO_FLOAT(sim_ship->hull_vertices[j].y));
-        float edx = bx - ax, edy = by - ay;
-        float len_sq = edx * edx + edy * edy;
-        float t = 0.0f;
-        if (len_sq > 1e-10f) {
-            t = ((lx - ax) * edx + (ly - ay) * edy) / len_sq;
-            if (t < 0.0f) t = 0.0f;
-            if (t > 1.0f) t = 1.0f;
-        }
-        float cx = ax + t * edx, cy = ay + t * edy;
-        float ex = lx - cx, ey = ly - cy;
-        float d  = ex * ex + ey * ey;
-        if (d < min_dist_sq) min_dist_sq = d;
-    }
-    return sqrtf(min_dist_sq);
-}
-
 /** True when a swimming player's body circle overlaps the ship hull polygon. */
 static bool player_touching_hull(float wx, float wy,
                                  const SimpleShip* ship, const struct Ship* sim_ship) {
     if (!ship || !sim_ship || sim_ship->hull_vertex_count < 3) return false;
     float lx, ly;
     ship_world_to_local(ship, wx, wy, &lx, &ly);
-    if (player_point_in_hull_client(lx, ly, sim_ship)) return true;
-    return player_dist_to_hull_edge_client(lx, ly, sim_ship) <= PLAYER_HULL_TOUCH_RADIUS;
+    return hull_sdf_within(sim_ship, lx, ly, PLAYER_HULL_TOUCH_RADIUS);
 }
 
 // Helper: minimum distance from a local point (server float units) to the nearest hull edge segment.
 static float swivel_dist_to_hull_edge(float sx, float sy, const struct Ship* ship) {
     float min_dist_sq = 1e20f;
     uint8_t n = ship->hull_vertex_count;
-    for (uint8_t i = 0; i < n; i++) {
-        uint8_t j = (i + 1) % n;
+    int cn;
+    const uint8_t* cand = hull_sdf_candidates(ship, SERVER_TO_CLIENT(sx), SERVER_TO_CLIENT(sy), &cn);
+    for (int k = 0; k < cn; k++) {
+        uint8_t j = cand[k];
+        uint8_t i = j ? j - 1 : n - 1;
         float ax = Q16_TO_FLOAT(ship->hull_vertices[i].x);
         float ay = Q16_TO_FLOAT(ship->hull_vertices[i].y);
         float bx = Q16_TO_FLOAT(ship->hull_vertices[j].x);
@@ -1449,7 +1548,25 @@ static float module_placement_radius(ModuleTypeId type) {
  *   - Masts are deck-independent: they collide against and with every deck level.
  *   - All other modules only collide with modules on the same deck or deck_id==255.
  */
-static uint16_t modules_overlap_id_at(const SimpleShip* ship,
+#define MODULE_PLACEMENT_RADIUS_MAX 28.0f   /* Largest module_placement_radius()   */
+/* Walker query reach: PLAYER_RADIUS (8) + ramp half-diagonal (~31), plus one
+ * push of slack since pushes move the walker while the candidates are walked. */
+#define MODULE_COLLISION_REACH      64.0f
+
+/** Modules any proximity check can hit: solid for walkers or for placement. */
+static bool module_grid_files(ModuleTypeId type) {
+    return module_placement_radius(type) > 0.0f || module_collision_radius(type) > 0.0f;
+}
+
+/** The ship's module grid, rebuilt first if modules changed since it was built. */
+static const ShipModuleGrid* ship_modules_grid(SimpleShip* ship) {
+    if (!ship_module_grid_current(&ship->module_grid, ship->module_count))
+        ship_module_grid_build(&ship->module_grid, ship->modules, ship->module_count,
+                               module_grid_files);
+    return &ship->module_grid;
+}
+
+static uint16_t modules_overlap_id_at(SimpleShip* ship,
                                        ModuleTypeId new_type, float new_x, float new_y,
                                        uint8_t new_deck, int snap_idx) {
     float r_new = module_placement_radius(new_type);
@@ -1459,7 +1576,16 @@ static uint16_t modules_overlap_id_at(const SimpleShip* ship,
     /* Snap-mode: cannon placed at a gunport slot — only block same-slot duplicates */
     bool snap_mode = (new_type == MODULE_TYPE_CANNON && snap_idx >= 0 && snap_idx <= 11);
 
-    for (uint8_t m = 0; m < ship->module_count; m++) {
+    /* Snap-mode matches by slot, not position, so it walks every module. */
+    uint8_t near[MAX_MODULES_PER_SHIP];
+    uint8_t near_count = ship->module_count;
+    if (!snap_mode) {
+        near_count = ship_module_grid_query(ship_modules_grid(ship), new_x, new_y,
+                                            r_new + MODULE_PLACEMENT_RADIUS_MAX, near);
+    }
+
+    for (uint8_t k = 0; k < near_count; k++) {
+        uint8_t m = snap_mode ? k : near[k];
         const ShipModule* mod = &ship->modules[m];
 
         float r_ex = module_placement_radius(mod->type_id);
@@ -1495,7 +1621,7 @@ static uint16_t modules_overlap_id_at(const SimpleShip* ship,
 }
 
 /* Thin bool wrapper kept for mast / swivel / chest callers that don't need the ID. */
-static bool modules_overlap_at(const SimpleShip* ship,
+static bool modules_overlap_at(SimpleShip* ship,
                                 ModuleTypeId new_type, float new_x, float new_y,
                                 uint8_t new_deck) {
     return modules_overlap_id_at(ship, new_type, new_x, new_y, new_deck, -1) != 0;
@@ -1563,6 +1689,20 @@ static bool hull_section_plank_alive(const SimpleShip* ship, int slot) {
     return false; // all covering planks are gone — gap in the hull
 }
 
+/** Plank overlay: bit `slot` set while hull section `slot` is solid.  One
+ *  lookup per section instead of one per edge. */
+static uint16_t hull_solid_slots(const SimpleShip* ship) {
+    uint16_t solid = 0;
+    for (int slot = 0; slot <= 9; slot++)
+        if (hull_section_plank_alive(ship, slot)) solid |= (uint16_t)(1u << slot);
+    return solid;
+}
+
+static bool hull_edge_solid(uint16_t solid, int edge_i, int nv) {
+    int slot = hull_edge_to_plank_slot(edge_i, nv);
+    return slot < 0 || (solid & (1u << slot));
+}
+
 /**
  * Push (new_local_x, new_local_y) back inside the ship's hull polygon if it
  * has crossed an edge or is within INSET of one.  Used on the lower deck so
@@ -1651,31 +1791,11 @@ static bool ws_player_walk_target(WebSocketPlayer* p,
  * Called at every dock/ship exit so the player doesn't oscillate in SWIMMING when
  * they step directly from a dock/ship hull onto adjacent island shore. */
 static bool player_try_land_on_island(WebSocketPlayer *p, float x, float y) {
-    for (int ii = 0; ii < ISLAND_COUNT; ii++) {
-        const IslandDef *isl = &ISLAND_PRESETS[ii];
-        float dx = x - isl->x, dy = y - isl->y;
-        float ds = dx * dx + dy * dy;
-        bool on;
-        if (isl->vertex_count > 0) {
-            on = (ds < isl->poly_bound_r * isl->poly_bound_r)
-              && island_poly_contains(isl, x, y);
-        } else {
-            float broad_r = isl->beach_radius_px + isl->beach_max_bump;
-            if (ds >= broad_r * broad_r) { on = false; }
-            else {
-                float angle = atan2f(dy, dx);
-                float nr = island_boundary_r(isl->beach_radius_px,
-                                             isl->beach_bumps, angle);
-                on = (ds < nr * nr);
-            }
-        }
-        if (on) {
-            p->on_island_id    = (uint32_t)isl->id;
-            p->movement_state  = PLAYER_STATE_WALKING;
-            return true;
-        }
-    }
-    return false;
+    const IslandDef *isl = island_land_at(x, y);
+    if (!isl) return false;
+    p->on_island_id    = (uint32_t)isl->id;
+    p->movement_state  = PLAYER_STATE_WALKING;
+    return true;
 }
 
 static void resolve_player_hull_containment(const SimpleShip* ship,
@@ -1687,6 +1807,10 @@ static void resolve_player_hull_containment(const SimpleShip* ship,
     struct Ship* sim_ship = find_sim_ship(ship->ship_id);
     if (!sim_ship || sim_ship->hull_vertex_count < 3) return;
 
+    // Comfortably inside (the common case): the SDF settles it, and neither
+    // pass would move the player.
+    if (hull_sdf_sample(sim_ship, *new_local_x, *new_local_y) < -(INSET + HULL_SDF_ERR_PX)) return;
+
     const uint8_t n = sim_ship->hull_vertex_count;
 
     // Cache hull as client-px float coords (small fixed buffer; hull is ≤64 vtx).
@@ -1720,12 +1844,16 @@ static void resolve_player_hull_containment(const SimpleShip* ship,
         }
 
         // 2) Find the closest point on the polygon boundary, remembering the
-        //    edge index so we can look up which plank guards it.
+        //    edge index so we can look up which plank guards it.  Only the
+        //    edges the SDF cell says can be nearest, in hull order.
         float best_dist2  = 1e30f;
         float best_cx     = px,   best_cy = py;
         float best_nx     = 0.0f, best_ny = 0.0f;
         int   best_edge_i = -1;
-        for (int i = 0, j = nv - 1; i < nv; j = i++) {
+        int   cand_n;
+        const uint8_t* cand = hull_sdf_candidates(sim_ship, px, py, &cand_n);
+        for (int k = 0; k < cand_n; k++) {
+            int i = cand[k], j = i ? i - 1 : nv - 1;
             float ax = hx[j], ay = hy[j];
             float bx = hx[i], by = hy[i];
             float ex = bx - ax, ey = by - ay;
@@ -1799,6 +1927,11 @@ static bool resolve_swimmer_ship_hull_collision(const SimpleShip* ship,
     ship_world_to_local(ship, *world_x, *world_y, &lx, &ly);
     ship_world_to_local(ship, old_x, old_y, &olx, &oly);
 
+    /* Clear of the hull: no edge within reach of the motion or the body. */
+    float mx = lx - olx, my = ly - oly;
+    float reach = sqrtf(mx * mx + my * my) + PLAYER_RADIUS + HULL_SDF_ERR_PX;
+    if (fabsf(hull_sdf_sample(sim_ship, olx, oly)) > reach) return false;
+
     const uint8_t n = sim_ship->hull_vertex_count;
     float hxv[64], hyv[64];
     uint8_t nv = n < 64 ? n : 64;
@@ -1834,13 +1967,13 @@ static bool resolve_swimmer_ship_hull_collision(const SimpleShip* ship,
     /* Ghost ship hulls are always fully solid — players cannot pass through
      * a breached section or board a ghost ship. Skip plank-alive checks. */
     bool _ghost_hull = (ship->ship_type == SHIP_TYPE_GHOST);
+    uint16_t solid = _ghost_hull ? 0xFFFFu : hull_solid_slots(ship);
 
-    float mx = lx - olx, my = ly - oly;
     if (mx * mx + my * my > 1e-9f) {
         float best_t = 1e30f;
         int   best_i = -1, best_j = -1;
         for (int i = 0, j = (int)nv - 1; i < (int)nv; j = i++) {
-            if (!_ghost_hull && !hull_section_plank_alive(ship, hull_edge_to_plank_slot(i, nv)))
+            if (!hull_edge_solid(solid, i, nv))
                 continue; /* breach: passable (player ships only) */
             float ax = hxv[j], ay = hyv[j];
             float ex = hxv[i] - ax, ey = hyv[i] - ay;
@@ -1870,7 +2003,7 @@ static bool resolve_swimmer_ship_hull_collision(const SimpleShip* ship,
     /* Pass 2: contact pushout (two iterations so corners settle). */
     for (int iter = 0; iter < 2; iter++) {
         for (int i = 0, j = (int)nv - 1; i < (int)nv; j = i++) {
-            if (!_ghost_hull && !hull_section_plank_alive(ship, hull_edge_to_plank_slot(i, nv)))
+            if (!hull_edge_solid(solid, i, nv))
                 continue; /* breach: passable (player ships only) */
 
             float ax = hxv[j], ay = hyv[j];
@@ -1922,15 +2055,19 @@ static bool resolve_swimmer_ship_hull_collision(const SimpleShip* ship,
  *     collides with masts (they span every deck). Hull boundary is enforced
  *     by resolve_player_hull_containment(), so planks/hull act as walls.
  */
-static void resolve_player_module_collisions(const SimpleShip* ship,
+static void resolve_player_module_collisions(SimpleShip* ship,
                                              module_id_t mounted_module_id,
                                              uint8_t player_deck_level,
                                              float* new_local_x, float* new_local_y)
 {
     const float PLAYER_RADIUS = 8.0f; // client pixels — matches sim radius
 
-    for (uint8_t m = 0; m < ship->module_count; m++) {
-        const ShipModule* mod = &ship->modules[m];
+    uint8_t near[MAX_MODULES_PER_SHIP];
+    uint8_t near_count = ship_module_grid_query(ship_modules_grid(ship),
+                                                *new_local_x, *new_local_y,
+                                                MODULE_COLLISION_REACH, near);
+    for (uint8_t k = 0; k < near_count; k++) {
+        const ShipModule* mod = &ship->modules[near[k]];
 
         // Skip modules the player is mounted to
         if (mod->id == mounted_module_id) continue;
@@ -2393,6 +2530,7 @@ void apply_group_gunport_state(SimpleShip* ship, WeaponGroup* group) {
                 ? ((gp_y < 0) ? gp_y + Q16_FROM_FLOAT(1.0f) : gp_y - Q16_FROM_FLOAT(1.0f))
                 : ((gp_y < 0) ? gp_y + Q16_FROM_FLOAT(4.0f) : gp_y - Q16_FROM_FLOAT(4.0f));
             cannon_s->local_pos.y = new_cannon_y;
+            ship_module_grid_invalidate(&ship->module_grid);
             /* Mirror gunport and cannon position to sim layer */
             if (sim_ship) {
                 for (uint8_t sm = 0; sm < sim_ship->module_count; sm++) {
@@ -2412,6 +2550,7 @@ void apply_group_gunport_state(SimpleShip* ship, WeaponGroup* group) {
         }
     }
     recalc_ship_mass(ship);
+    if (sim_ship) ship_flooding_touch(sim_ship);
 }
 
 void board_player_on_ship(WebSocketPlayer* player, SimpleShip* ship, float local_x, float local_y) {
@@ -3903,6 +4042,7 @@ static void* blob_worker_main(void* arg) {
         build_shared_blobs_from_snapshot(job, &g_blob_worker.output_bufs[write_idx],
                                          &g_blob_worker_lut);
         uint64_t _dt = get_time_us() - _t0;
+        metrics_observe(g_ws_metrics.blob_build, _dt);
 
         pthread_mutex_lock(&g_blob_worker.mtx);
         g_blob_worker.output_read_idx = write_idx;
@@ -4024,6 +4164,7 @@ static const SharedBlobOutput* blob_worker_peek_output(void) {
 }
 
 static void blob_worker_note_fallback_build(void) {
+    metrics_inc(g_ws_metrics.blob_fallback, 1);
     if (!g_blob_worker.started) return;
     pthread_mutex_lock(&g_blob_worker.mtx);
     g_blob_worker.fallback_sync_builds++;
@@ -4186,6 +4327,9 @@ void player_die(WebSocketPlayer* player) {
         t->inventory      = player->inventory;  /* full struct copy */
         t->spawn_time_ms  = get_time_ms();
         t->active         = true;
+        t->expiry_timer   = timer_wheel_schedule(tombstone_expiry_kind(),
+                                                 (uint32_t)(t - tombstones),
+                                                 t->spawn_time_ms, TOMBSTONE_TTL_MS);
         tombstone_live_count++;
 
         /* Broadcast tombstone_spawned ─────────────────────────────────── */
@@ -4327,7 +4471,7 @@ static void handle_collect_tombstone(WebSocketPlayer* player,
 static void ws_send_text(int fd, const char* msg) {
     char frame[256];
     size_t fl = websocket_create_frame(WS_OPCODE_TEXT, msg, strlen(msg), frame, sizeof(frame));
-    if (fl > 0) send(fd, frame, fl, 0);
+    if (fl > 0 && send(fd, frame, fl, 0) > 0) metrics_inc(g_ws_metrics.bytes_direct, fl);
 }
 
 /* Helper: serialize tombstone inventory and send tombstone_items to one client. */
@@ -5147,9 +5291,38 @@ static void grapple_apply_entity_rope(GrappleHook* gh, WebSocketPlayer* owner,
     gh->hook_y = *tgt_y;
 }
 
-/** Per-tick grapple physics.  Called from the main server tick with dt seconds. */
+/**
+ * Declare a rope on a sim player for this tick's sim_step.  The anchor point
+ * (ax, ay) is in client px: ship-local for ROPE_ANCHOR_SHIP, world for
+ * ROPE_ANCHOR_WORLD, ignored for ROPE_ANCHOR_PLAYER.  Returns false when the
+ * rope cannot go to the sim (no sim entity, table full) so the caller can fall
+ * back to moving the player itself.
+ */
+static bool grapple_emit_rope(entity_id body, uint8_t anchor_kind, entity_id anchor_id,
+                              float ax, float ay, float length) {
+    if (!global_sim || body == 0) return false;
+    if (length < 0.0f) length = 0.0f;
+    struct RopeConstraint rc = {
+        .body        = body,
+        .anchor_id   = anchor_id,
+        .anchor_kind = anchor_kind,
+        .anchor_pos  = { Q16_FROM_FLOAT(CLIENT_TO_SERVER(ax)), Q16_FROM_FLOAT(CLIENT_TO_SERVER(ay)) },
+        .length      = Q16_FROM_FLOAT(CLIENT_TO_SERVER(length)),
+    };
+    return sim_rope_add(global_sim, &rc);
+}
+
+/** Per-tick grapple physics.  Called from the main server tick with dt seconds.
+ *
+ * Ropes whose pulled body is an unboarded player are not resolved here: they
+ * are declared to the sim (grapple_emit_rope) and solved together inside
+ * sim_step, after the ship they hang from has moved.  The player_sync copy-back
+ * adopts the solved position next tick.  Boarded bodies (pinned to their deck
+ * in the sim), NPCs, items and wrecks are still moved here. */
 static void update_grapple_hooks(float dt, uint32_t now_ms)
 {
+    if (global_sim) sim_ropes_clear(global_sim);
+
     for (int si = 0; si < WS_MAX_CLIENTS; si++) {
         GrappleHook* gh = &grapple_hooks[si];
         if (!gh->active) continue;
@@ -5283,6 +5456,16 @@ static void update_grapple_hooks(float dt, uint32_t now_ms)
                 struct Ship* _sim = find_sim_ship((uint32_t)ships[shp].ship_id);
                 if (!_sim || _sim->hull_vertex_count < 3) continue;
 
+                /* Bounding-circle reject before the per-edge hull scans: neither
+                 * attach test can succeed unless the rope segment comes within
+                 * the hull's radius (+ attach tolerance) of the ship centre. */
+                float _reach = SERVER_TO_CLIENT(Q16_TO_FLOAT(_sim->bounding_radius)) +
+                               GRAPPLE_HULL_ATTACH_TOL;
+                if (grapple_seg_dist_sq(ships[shp].x, ships[shp].y,
+                                        gh->origin_x, gh->origin_y,
+                                        gh->hook_x, gh->hook_y, NULL, NULL) > _reach * _reach)
+                    continue;
+
                 float _lhx, _lhy;
                 bool _hull_hit = grapple_hook_on_hull(&ships[shp], _sim,
                                                       gh->hook_x, gh->hook_y,
@@ -5301,9 +5484,10 @@ static void update_grapple_hooks(float dt, uint32_t now_ms)
             /* Wreck structures (chest_ruin flotsam) — tip AND rope-line check.
              * Requires minimum travel so a wreck sitting next to the player's
              * ship does not immediately swallow the hook the moment it spawns. */
-            for (int wi = 0; wi < (int)placed_structure_count && !hit && _can_hit_ship; wi++) {
-                PlacedStructure* wr = &placed_structures[wi];
-                if (!wr->active || wr->type != STRUCT_WRECK) continue;
+            uint32_t _wrc;
+            const uint32_t *_wrs = structure_slots_of_type(STRUCT_WRECK, &_wrc);
+            for (uint32_t wi = 0; wi < _wrc && !hit && _can_hit_ship; wi++) {
+                PlacedStructure* wr = &placed_structures[_wrs[wi]];
                 float wdx = gh->hook_x - wr->x;
                 float wdy = gh->hook_y - wr->y;
                 bool _tip_wr = (wdx*wdx + wdy*wdy <= GRAPPLE_HIT_R_WRECK * GRAPPLE_HIT_R_WRECK);
@@ -5317,7 +5501,7 @@ static void update_grapple_hooks(float dt, uint32_t now_ms)
                 if (_tip_wr) {
                     gh->state       = GRAPPLE_ATTACHED;
                     gh->target_type = GRAPPLE_TARGET_WRECK;
-                    gh->target_id   = (uint32_t)wi;
+                    gh->target_id   = structure_handle(wr);
                     gh->hook_x      = wr->x;
                     gh->hook_y      = wr->y;
                     hit = true;
@@ -5429,6 +5613,23 @@ static void update_grapple_hooks(float dt, uint32_t now_ms)
                 float tdist = sqrtf(tdx * tdx + tdy * tdy);
                 if (tdist < 0.5f) break;
 
+                /* Swimming / on-foot owner: the sim solves the rope against the ship's
+                 * post-step transform.  Reel-in shortens the rope by this tick's step. */
+                if (owner->parent_ship_id == 0 && !gh->reel_out) {
+                    float len = gh->rope_length;
+                    if (gh->reel_in) {
+                        len = tdist - GRAPPLE_REEL_PULL * dt;
+                        if (len < 0.0f) len = 0.0f;
+                    }
+                    if (grapple_emit_rope(owner->sim_entity_id, ROPE_ANCHOR_SHIP, tship->ship_id,
+                                          gh->vel_x, gh->vel_y, len)) {
+                        if (gh->reel_in) gh->rope_length = len;
+                        /* Taut: a stale client position would undo the pull next tick. */
+                        if (tdist > len) owner->client_pos_ms = 0;
+                        break;
+                    }
+                }
+
                 float nx = tdx / tdist;
                 float ny = tdy / tdist;
 
@@ -5468,6 +5669,24 @@ static void update_grapple_hooks(float dt, uint32_t now_ms)
                 WebSocketPlayer* tgt = find_player(gh->target_id);
                 if (!tgt || !tgt->active) { grapple_detach(si); break; }
 
+                /* Unboarded target: rope solved in the sim, anchored on the owner
+                 * (or on the owner's deck spot, so it follows the ship this step). */
+                if (tgt->parent_ship_id == 0 && !gh->reel_out) {
+                    bool roped = (owner->parent_ship_id == 0)
+                        ? grapple_emit_rope(tgt->sim_entity_id, ROPE_ANCHOR_PLAYER,
+                                            owner->sim_entity_id, 0.0f, 0.0f, gh->rope_length)
+                        : grapple_emit_rope(tgt->sim_entity_id, ROPE_ANCHOR_SHIP,
+                                            owner->parent_ship_id, owner->local_x, owner->local_y,
+                                            gh->rope_length);
+                    if (roped) {
+                        gh->hook_x = tgt->x;
+                        gh->hook_y = tgt->y;
+                        tgt->client_pos_ms = 0;
+                        grapple_refresh_target_swim_state(tgt, owner);
+                        break;
+                    }
+                }
+
                 grapple_apply_entity_rope(gh, owner, &tgt->x, &tgt->y);
                 grapple_sync_target_ws_player(tgt, owner);
                 break;
@@ -5484,13 +5703,10 @@ static void update_grapple_hooks(float dt, uint32_t now_ms)
             }
 
             case GRAPPLE_TARGET_WRECK: {
-                int wi = (int)gh->target_id;
-                if (wi < 0 || wi >= (int)placed_structure_count ||
-                    !placed_structures[wi].active ||
-                    placed_structures[wi].type != STRUCT_WRECK) {
+                PlacedStructure* twr = structure_from_handle(gh->target_id);
+                if (!twr || twr->type != STRUCT_WRECK) {
                     grapple_detach(si); break;
                 }
-                PlacedStructure* twr = &placed_structures[wi];
                 float tdx   = owner->x - twr->x;
                 float tdy   = owner->y - twr->y;
                 float tdist = sqrtf(tdx * tdx + tdy * tdy);
@@ -5563,7 +5779,7 @@ static void update_grapple_hooks(float dt, uint32_t now_ms)
                     bool _fully_looted = (twr->wreck_bp_count == 0 && twr->wreck_loot_count == 0);
                     if (_fully_looted) {
                         uint32_t wreck_id = twr->id;
-                        twr->active = false;
+                        structure_free(twr);
                         char wbcast[96];
                         snprintf(wbcast, sizeof(wbcast),
                                  "{\"type\":\"wreck_removed\",\"id\":%u}", (unsigned)wreck_id);
@@ -5682,6 +5898,18 @@ static bool grapple_target_is_entity(uint8_t target_type) {
     return target_type == GRAPPLE_TARGET_PLAYER || target_type == GRAPPLE_TARGET_NPC;
 }
 
+void world_npc_grapple_mask(bool* mask, int count) {
+    memset(mask, 0, (size_t)count * sizeof(bool));
+    for (int si = 0; si < WS_MAX_CLIENTS; si++) {
+        const GrappleHook* gh = &grapple_hooks[si];
+        if (gh->active && gh->state == GRAPPLE_ATTACHED &&
+            gh->target_type == GRAPPLE_TARGET_NPC &&
+            (int)gh->target_id < count) {
+            mask[gh->target_id] = true;
+        }
+    }
+}
+
 bool world_npc_is_grapple_target(int npc_index) {
     if (npc_index < 0 || npc_index >= world_npc_count) return false;
     for (int si = 0; si < WS_MAX_CLIENTS; si++) {
@@ -5898,6 +6126,7 @@ static void remove_player(uint32_t player_id) {
 // ── Ship control (sail/rudder) ───────────────────────────────────────────────
 #include "net/ship_control.h"
 #include "net/npc_agents.h"
+#include "net/npc_sched.h"
 #include "net/npc_world.h"
 
 // ── Cannon aim, fire, weapon groups ─────────────────────────────────────────
@@ -6011,6 +6240,7 @@ static ssize_t send_all(int fd, const char *buf, size_t len) {
         }
         if (n == 0) return (ssize_t)sent;
         sent += (size_t)n;
+        metrics_inc(g_ws_metrics.bytes_direct, (uint64_t)n);
     }
     return (ssize_t)sent;
 }
@@ -6054,6 +6284,189 @@ size_t websocket_create_frame(uint8_t opcode, const char* payload, size_t payloa
     return frame_len;
 }
 
+/* ── STRUCTURES list ─────────────────────────────────────────────────────────
+ * Full placed-structures snapshot sent on handshake and GET_STRUCTURES.  The
+ * store holds up to MAX_PLACED_STRUCTURES entries, so the JSON and frame
+ * buffers grow on demand rather than truncating at a fixed size. */
+
+static char  *structs_json;
+static size_t structs_json_cap;
+static char  *structs_frame;
+static size_t structs_frame_cap;
+
+static bool structs_reserve(char **buf, size_t *cap, size_t need) {
+    if (need <= *cap) return true;
+    size_t ncap = *cap ? *cap : 65536;
+    while (ncap < need) ncap *= 2;
+    char *grown = realloc(*buf, ncap);
+    if (!grown) return false;
+    *buf = grown;
+    *cap = ncap;
+    return true;
+}
+
+static const char *structure_type_name(PlacedStructureType t) {
+    switch (t) {
+        case STRUCT_WOODEN_FLOOR:     return "wooden_floor";
+        case STRUCT_WORKBENCH:        return "workbench";
+        case STRUCT_WALL:             return "wall";
+        case STRUCT_DOOR_FRAME:       return "door_frame";
+        case STRUCT_DOOR:             return "door";
+        case STRUCT_SHIPYARD:         return "shipyard";
+        case STRUCT_WRECK:            return "wreck";
+        case STRUCT_CEILING:          return "wood_ceiling";
+        case STRUCT_CANNON:           return "cannon";
+        case STRUCT_FLAG_FORT:        return "flag_fort";
+        case STRUCT_CLAIM_FLAG:       return "claim_flag";
+        case STRUCT_COMPANY_FORTRESS: return "company_fortress";
+        case STRUCT_CHEST:            return "chest";
+        default:                      return "unknown";
+    }
+}
+
+/* Append one structure's JSON object at *pos.  Returns false on OOM. */
+static bool append_structure_json(const PlacedStructure *s, bool first, size_t *pos) {
+    char sy_extra[256] = "";
+    char cannon_extra[96] = "";
+    char claim_extra[320] = "";
+    char dom_extra[512] = "";
+    char chest_extra[128] = "";
+    char wreck_extra[40] = "";
+    char qt_extra[24] = "";
+    bool is_door = (s->type == STRUCT_DOOR);
+
+    if (s->type == STRUCT_WRECK) {
+        int wt = wreck_best_tier(s);
+        if (wt >= 0) snprintf(wreck_extra, sizeof(wreck_extra), ",\"wreck_tier\":%d", wt);
+    }
+    {
+        int qt = structure_quality_tier(s);
+        if (qt >= 0) snprintf(qt_extra, sizeof(qt_extra), ",\"qt\":%d", qt);
+    }
+    format_dominators_extra(s, dom_extra, sizeof(dom_extra));
+    if (s->type == STRUCT_CHEST || s->type == STRUCT_SHIPYARD) {
+        snprintf(chest_extra, sizeof(chest_extra),
+                 ",\"chest_wood\":%u,\"chest_fiber\":%u,\"chest_metal\":%u,\"chest_stone\":%u",
+                 (unsigned)s->chest_wood, (unsigned)s->chest_fiber,
+                 (unsigned)s->chest_metal, (unsigned)s->chest_stone);
+    }
+    if (s->type == STRUCT_SHIPYARD) {
+        char mj[128] = "[]";
+        if (s->modules_placed) {
+            int m = 0;
+            mj[m++] = '[';
+            const char* mn[6] = {"hull_left","hull_right","deck","mast","cannon_port","cannon_stbd"};
+            bool mfirst = true;
+            for (int b = 0; b < 6; b++) {
+                if (s->modules_placed & (1u << b)) {
+                    if (!mfirst) mj[m++] = ',';
+                    m += snprintf(mj + m, (int)sizeof(mj) - m, "\"%s\"", mn[b]);
+                    mfirst = false;
+                }
+            }
+            mj[m++] = ']';
+            mj[m]   = '\0';
+        }
+        const char* phase = s->construction_phase == CONSTRUCTION_BUILDING ? "building" : "empty";
+        snprintf(sy_extra, sizeof(sy_extra),
+                 ",\"construction_phase\":\"%s\",\"modules_placed\":%s,\"scaffolded_ship_id\":%u",
+                 phase, mj, (unsigned)s->scaffolded_ship_id);
+    }
+    if (s->type == STRUCT_CANNON) {
+        snprintf(cannon_extra, sizeof(cannon_extra),
+                 ",\"cannon_aim_angle\":%.4f,\"cannon_reload_ms\":%u,\"cannon_loaded_ammo\":%u",
+                 s->cannon_aim_angle, s->cannon_reload_ms, (unsigned)s->cannon_loaded_ammo);
+    }
+    if (s->type == STRUCT_COMPANY_FORTRESS) {
+        snprintf(claim_extra, sizeof(claim_extra),
+                 ",\"fortress_build_progress\":%.0f,\"fortress_complete\":%s,\"fortress_contested\":%s,\"claim_orphaned\":%s",
+                 s->claim_progress_ms,
+                 s->fortress_complete ? "true" : "false",
+                 s->claim_contested   ? "true" : "false",
+                 s->claim_orphaned    ? "true" : "false");
+    }
+    if (s->type == STRUCT_CLAIM_FLAG) {
+        snprintf(claim_extra, sizeof(claim_extra),
+                 ",\"claim_progress_ms\":%.0f,\"claim_contested\":%s,\"claim_state\":%u,\"claim_grace_ms\":%.0f,\"claim_targets_fortress\":%s,\"claim_linked_fort\":%u,\"claim_source_enemy\":%u",
+                 s->claim_progress_ms,
+                 s->claim_contested        ? "true" : "false",
+                 (unsigned)s->claim_state,
+                 s->claim_grace_ms,
+                 s->claim_targets_fortress ? "true" : "false",
+                 (unsigned)s->claim_linked_fort,
+                 (unsigned)s->claim_source_enemy);
+    } else if (s->type == STRUCT_FLAG_FORT) {
+        float ff_prog = (s->max_hp > 0)
+            ? ((float)s->hp / (float)s->max_hp) * (float)FLAG_FORT_BUILD_MS
+            : 0.0f;
+        snprintf(claim_extra, sizeof(claim_extra),
+                 ",\"claim_orphaned\":%s"
+                 ",\"fortress_complete\":%s"
+                 ",\"fortress_build_progress\":%.0f"
+                 ",\"fortress_contested\":%s"
+                 ",\"claim_phase\":%u"
+                 ",\"claim_progress_ms\":%.0f,\"claim_total_ms\":%u"
+                 ",\"claim_state\":%u,\"claim_grace_ms\":%.0f",
+                 s->claim_orphaned    ? "true" : "false",
+                 s->fortress_complete ? "true" : "false",
+                 ff_prog,
+                 s->claim_contested   ? "true" : "false",
+                 (unsigned)s->claim_phase,
+                 (s->claim_phase == FLAG_FORT_PHASE_CLAIMING) ? s->claim_progress_ms : 0.0f,
+                 (unsigned)FLAG_FORT_CLAIM_MS,
+                 (unsigned)s->claim_state,
+                 s->claim_grace_ms);
+    }
+
+    for (;;) {
+        size_t room = structs_json_cap - *pos;
+        int n = snprintf(structs_json + *pos, room,
+                         "%s{\"id\":%u,\"structure_type\":\"%s\","
+                         "\"island_id\":%u,\"x\":%.1f,\"y\":%.1f,"
+                         "\"company_id\":%u,\"hp\":%u,\"max_hp\":%u,\"target_hp\":%u,\"placer_name\":\"%s\""
+                         ",\"rotation\":%.2f%s%s%s%s%s%s%s%s%s}",
+                         first ? "" : ",",
+                         s->id, structure_type_name(s->type),
+                         s->island_id, s->x, s->y,
+                         (unsigned)s->company_id, (unsigned)s->hp,
+                         (unsigned)s->max_hp, (unsigned)s->target_hp,
+                         s->placer_name, s->rotation,
+                         is_door ? (s->open ? ",\"open\":true" : ",\"open\":false") : "",
+                         is_door ? (s->door_locked ? ",\"locked\":true" : ",\"locked\":false") : "",
+                         sy_extra, cannon_extra, claim_extra, dom_extra,
+                         chest_extra, wreck_extra, qt_extra);
+        if (n < 0) return false;
+        if ((size_t)n < room) { *pos += (size_t)n; return true; }
+        if (!structs_reserve(&structs_json, &structs_json_cap, *pos + (size_t)n + 1)) return false;
+    }
+}
+
+/* Send the STRUCTURES list to one client.  Returns the number of structures
+ * sent, or -1 if the message could not be built. */
+static int send_structures_list(struct WebSocketClient *client) {
+    static const char head[] = "{\"type\":\"STRUCTURES\",\"structures\":[";
+    if (!structs_reserve(&structs_json, &structs_json_cap, sizeof(head) + 3)) return -1;
+    size_t pos = (size_t)snprintf(structs_json, structs_json_cap, "%s", head);
+
+    uint32_t n;
+    const uint32_t *live = structure_live_slots(&n);
+    for (uint32_t i = 0; i < n; i++) {
+        if (!append_structure_json(&placed_structures[live[i]], i == 0, &pos)) {
+            log_error("❌ STRUCTURES: out of memory after %u of %u structures", i, n);
+            return -1;
+        }
+    }
+    if (!structs_reserve(&structs_json, &structs_json_cap, pos + 3)) return -1;
+    pos += (size_t)snprintf(structs_json + pos, structs_json_cap - pos, "]}");
+
+    if (!structs_reserve(&structs_frame, &structs_frame_cap, pos + 10)) return -1;
+    size_t flen = websocket_create_frame(WS_OPCODE_TEXT, structs_json, pos,
+                                         structs_frame, structs_frame_cap);
+    if (flen == 0) return -1;
+    send_all(client->fd, structs_frame, flen);
+    return (int)n;
+}
+
 void websocket_server_set_simulation(struct Sim* sim) {
     global_sim = sim;
     log_info("✅ WebSocket server linked to simulation for collision detection");
@@ -6070,6 +6483,7 @@ int websocket_server_init(uint16_t port) {
      * called before any client connects so the ISLANDS message is complete. */
     islands_load_from_files("data/islands");
     islands_apply_rotations();
+    islands_build_rasters();
     islands_generate_zone_resources();
     islands_generate_trees();
     islands_build_grid();
@@ -6077,6 +6491,13 @@ int websocket_server_init(uint16_t port) {
 
     memset(&ws_server, 0, sizeof(ws_server));
     ws_server.port = port;
+    register_ws_metrics();
+    npc_sched_init();
+    npc_nav_init();
+    dock_physics_init();
+    cannon_fire_init();
+    rewind_ships_init(&g_ship_history);
+    timer_wheel_init(get_time_ms());
     
     // Create TCP socket
     ws_server.socket_fd = socket(AF_INET, SOCK_STREAM, 0);
@@ -6243,6 +6664,9 @@ int websocket_server_update(struct Sim* sim) {
     /* Check cannonball hits against structures and trees from last sim tick */
     check_projectile_static_collisions(sim);
 
+    /* Flooding rows for this tick's bucket handlers and NPC bailers */
+    ship_flooding_update(sim->ships, sim->ship_count);
+
     // Accept new connections
     struct sockaddr_in client_addr;
     socklen_t addr_len = sizeof(client_addr);
@@ -6280,6 +6704,8 @@ int websocket_server_update(struct Sim* sim) {
             ws_server.clients[slot].connected = true;
             ws_server.clients[slot].handshake_complete = false;
             ws_server.clients[slot].last_ping_time = get_time_ms();
+            ws_server.clients[slot].ping_nonce = 0;
+            ws_server.clients[slot].rtt_ms = 0.0f;
             ws_server.clients[slot].player_id = 0; // Will be assigned during handshake
             ws_server.clients[slot].recv_buf_len = 0;
             ws_server.clients[slot].frag_buf_len = 0;
@@ -6300,10 +6726,25 @@ int websocket_server_update(struct Sim* sim) {
     }
     
     // Process existing clients
+    uint32_t now_ms = get_time_ms();
     for (int i = 0; i < WS_MAX_CLIENTS; i++) {
         if (!ws_server.clients[i].connected) continue;
         
         struct WebSocketClient* client = &ws_server.clients[i];
+
+        /* RTT probe: one PING in flight at a time, carrying a fresh nonce;
+         * only a PONG echoing that nonce is timed (against last_ping_time) */
+        uint32_t ping_wait = client->ping_nonce ? WS_PING_TIMEOUT_MS : WS_PING_INTERVAL_MS;
+        if (client->handshake_complete && now_ms - client->last_ping_time >= ping_wait) {
+            uint32_t nonce = ((uint32_t)rand() << 16) ^ (uint32_t)rand();
+            if (nonce == 0) nonce = 1;
+            char ping[16];
+            size_t ping_len = websocket_create_frame(WS_OPCODE_PING, (const char*)&nonce, sizeof(nonce),
+                                                     ping, sizeof(ping));
+            if (ping_len > 0) send_all(client->fd, ping, ping_len);
+            client->ping_nonce     = nonce;
+            client->last_ping_time = now_ms;
+        }
         /* Recv directly into the accumulation buffer at the current write offset
          * so no bytes are ever silently dropped (avoids TCP stream desync). */
         size_t avail = sizeof(client->recv_buf) - client->recv_buf_len;
@@ -6426,6 +6867,11 @@ int websocket_server_update(struct Sim* sim) {
                             }
                         }
 
+                        /* Replay log: gameplay messages only — handshakes carry tokens */
+                        if (strcmp(msg_type, "handshake") != 0) {
+                            replay_record_ws(client->player_id, payload, payload_len);
+                        }
+
                         if (strcmp(msg_type, "handshake") == 0) {
                             // Processing HANDSHAKE message
                             // Extract player name from handshake if provided
@@ -6859,163 +7305,9 @@ int websocket_server_update(struct Sim* sim) {
 
                                     // Send current placed structures
                                     {
-                                        static char hs_structs_buf[131072];
-                                        int hs_sp = 0;
-                                        hs_sp += snprintf(hs_structs_buf + hs_sp, sizeof(hs_structs_buf) - hs_sp,
-                                                          "{\"type\":\"STRUCTURES\",\"structures\":[");
-                                        bool hs_sfirst = true;
-                                        for (uint32_t si = 0; si < placed_structure_count; si++) {
-                                            if (!placed_structures[si].active) continue;
-                                        const char* hs_stype =
-                                            placed_structures[si].type == STRUCT_WOODEN_FLOOR ? "wooden_floor" :
-                                            placed_structures[si].type == STRUCT_WORKBENCH    ? "workbench" :
-                                            placed_structures[si].type == STRUCT_WALL         ? "wall" :
-                                            placed_structures[si].type == STRUCT_DOOR_FRAME   ? "door_frame" :
-                                            placed_structures[si].type == STRUCT_DOOR         ? "door" :
-                                            placed_structures[si].type == STRUCT_SHIPYARD     ? "shipyard" :
-                                            placed_structures[si].type == STRUCT_WRECK        ? "wreck" :
-                                            placed_structures[si].type == STRUCT_CEILING      ? "wood_ceiling" :
-                                            placed_structures[si].type == STRUCT_CANNON       ? "cannon" :
-                                            placed_structures[si].type == STRUCT_FLAG_FORT    ? "flag_fort" :
-                                            placed_structures[si].type == STRUCT_CLAIM_FLAG   ? "claim_flag" :
-                                            placed_structures[si].type == STRUCT_COMPANY_FORTRESS ? "company_fortress" :
-                                            placed_structures[si].type == STRUCT_CHEST        ? "chest" :
-                                            "unknown";
-                                        bool hs_is_door = (placed_structures[si].type == STRUCT_DOOR);
-                                        bool hs_is_sy   = (placed_structures[si].type == STRUCT_SHIPYARD);
-                                        bool hs_is_cannon = (placed_structures[si].type == STRUCT_CANNON);
-                                        bool hs_is_cfrt   = (placed_structures[si].type == STRUCT_COMPANY_FORTRESS);
-                                        bool hs_is_cflag  = (placed_structures[si].type == STRUCT_CLAIM_FLAG);
-                                        /* Build extra fields for shipyard construction state */
-                                        char hs_sy_extra[256] = "";
-                                        char hs_cannon_extra[96] = "";
-                                        char hs_claim_extra[320] = "";
-                                        char hs_dom_extra[512] = "";
-                                        char hs_chest_extra[128] = "";
-                                        char hs_wreck_extra[40] = "";
-                                        char hs_qt_extra[24] = "";
-                                        if (placed_structures[si].type == STRUCT_WRECK) {
-                                            int hwt = wreck_best_tier(&placed_structures[si]);
-                                            if (hwt >= 0) snprintf(hs_wreck_extra, sizeof(hs_wreck_extra), ",\"wreck_tier\":%d", hwt);
-                                        }
-                                        {
-                                            int hqt = structure_quality_tier(&placed_structures[si]);
-                                            if (hqt >= 0) snprintf(hs_qt_extra, sizeof(hs_qt_extra), ",\"qt\":%d", hqt);
-                                        }
-                                        format_dominators_extra(&placed_structures[si], hs_dom_extra, sizeof(hs_dom_extra));
-                                        if (placed_structures[si].type == STRUCT_CHEST
-                                            || placed_structures[si].type == STRUCT_SHIPYARD) {
-                                            snprintf(hs_chest_extra, sizeof(hs_chest_extra),
-                                                     ",\"chest_wood\":%u,\"chest_fiber\":%u,\"chest_metal\":%u,\"chest_stone\":%u",
-                                                     (unsigned)placed_structures[si].chest_wood,
-                                                     (unsigned)placed_structures[si].chest_fiber,
-                                                     (unsigned)placed_structures[si].chest_metal,
-                                                     (unsigned)placed_structures[si].chest_stone);
-                                        }
-                                        if (hs_is_sy) {
-                                            char hs_mj[128] = "[]";
-                                            if (placed_structures[si].modules_placed) {
-                                                int hm = 0;
-                                                hs_mj[hm++] = '[';
-                                                const char* hmn[6] = {"hull_left","hull_right","deck","mast","cannon_port","cannon_stbd"};
-                                                bool hmf = true;
-                                                for (int b = 0; b < 6; b++) {
-                                                    if (placed_structures[si].modules_placed & (1u << b)) {
-                                                        if (!hmf) hs_mj[hm++] = ',';
-                                                        hm += snprintf(hs_mj + hm, (int)sizeof(hs_mj) - hm, "\"%s\"", hmn[b]);
-                                                        hmf = false;
-                                                    }
-                                                }
-                                                hs_mj[hm++] = ']';
-                                                hs_mj[hm]   = '\0';
-                                            }
-                                            const char* hs_phase = placed_structures[si].construction_phase == CONSTRUCTION_BUILDING ? "building" : "empty";
-                                            snprintf(hs_sy_extra, sizeof(hs_sy_extra),
-                                                     ",\"construction_phase\":\"%s\",\"modules_placed\":%s,\"scaffolded_ship_id\":%u",
-                                                     hs_phase, hs_mj, (unsigned)placed_structures[si].scaffolded_ship_id);
-                                        }
-                                        if (hs_is_cannon) {
-                                            snprintf(hs_cannon_extra, sizeof(hs_cannon_extra),
-                                                     ",\"cannon_aim_angle\":%.4f,\"cannon_reload_ms\":%u,\"cannon_loaded_ammo\":%u",
-                                                     placed_structures[si].cannon_aim_angle,
-                                                     placed_structures[si].cannon_reload_ms,
-                                                     (unsigned)placed_structures[si].cannon_loaded_ammo);
-                                        }
-                                        if (hs_is_cfrt) {
-                                            snprintf(hs_claim_extra, sizeof(hs_claim_extra),
-                                                     ",\"fortress_build_progress\":%.0f,\"fortress_complete\":%s,\"fortress_contested\":%s,\"claim_orphaned\":%s",
-                                                     placed_structures[si].claim_progress_ms,
-                                                     placed_structures[si].fortress_complete ? "true" : "false",
-                                                     placed_structures[si].claim_contested   ? "true" : "false",
-                                                     placed_structures[si].claim_orphaned    ? "true" : "false");
-                                        }
-                                        if (hs_is_cflag) {
-                                            snprintf(hs_claim_extra, sizeof(hs_claim_extra),
-                                                     ",\"claim_progress_ms\":%.0f,\"claim_contested\":%s,\"claim_state\":%u,\"claim_grace_ms\":%.0f,\"claim_targets_fortress\":%s,\"claim_linked_fort\":%u,\"claim_source_enemy\":%u",
-                                                     placed_structures[si].claim_progress_ms,
-                                                     placed_structures[si].claim_contested         ? "true" : "false",
-                                                     (unsigned)placed_structures[si].claim_state,
-                                                     placed_structures[si].claim_grace_ms,
-                                                     placed_structures[si].claim_targets_fortress  ? "true" : "false",
-                                                     (unsigned)placed_structures[si].claim_linked_fort,
-                                                     (unsigned)placed_structures[si].claim_source_enemy);
-                                        } else if (placed_structures[si].type == STRUCT_FLAG_FORT) {
-                                            float ff_prog = (placed_structures[si].max_hp > 0)
-                                                ? ((float)placed_structures[si].hp / (float)placed_structures[si].max_hp) * (float)FLAG_FORT_BUILD_MS
-                                                : 0.0f;
-                                            snprintf(hs_claim_extra, sizeof(hs_claim_extra),
-                                                     ",\"claim_orphaned\":%s"
-                                                     ",\"fortress_complete\":%s"
-                                                     ",\"fortress_build_progress\":%.0f"
-                                                     ",\"fortress_contested\":%s"
-                                                     ",\"claim_phase\":%u"
-                                                     ",\"claim_progress_ms\":%.0f,\"claim_total_ms\":%u"
-                                                     ",\"claim_state\":%u,\"claim_grace_ms\":%.0f",
-                                                     placed_structures[si].claim_orphaned   ? "true" : "false",
-                                                     placed_structures[si].fortress_complete ? "true" : "false",
-                                                     ff_prog,
-                                                     placed_structures[si].claim_contested  ? "true" : "false",
-                                                     (unsigned)placed_structures[si].claim_phase,
-                                                     (placed_structures[si].claim_phase == FLAG_FORT_PHASE_CLAIMING) ? placed_structures[si].claim_progress_ms : 0.0f,
-                                                     (unsigned)FLAG_FORT_CLAIM_MS,
-                                                     (unsigned)placed_structures[si].claim_state,
-                                                     placed_structures[si].claim_grace_ms);
-                                        }
-                                        hs_sp += snprintf(hs_structs_buf + hs_sp, sizeof(hs_structs_buf) - hs_sp,
-                                                          "%s{\"id\":%u,\"structure_type\":\"%s\","
-                                                          "\"island_id\":%u,\"x\":%.1f,\"y\":%.1f,"
-                                                          "\"company_id\":%u,\"hp\":%u,\"max_hp\":%u,\"target_hp\":%u,\"placer_name\":\"%s\""
-                                                          ",\"rotation\":%.2f%s%s%s%s%s%s%s%s%s}",
-                                                          hs_sfirst ? "" : ",",
-                                                          placed_structures[si].id, hs_stype,
-                                                          placed_structures[si].island_id,
-                                                          placed_structures[si].x, placed_structures[si].y,
-                                                          (unsigned)placed_structures[si].company_id,
-                                                          (unsigned)placed_structures[si].hp,
-                                                          (unsigned)placed_structures[si].max_hp,
-                                                          (unsigned)placed_structures[si].target_hp,
-                                                          placed_structures[si].placer_name,
-                                                          placed_structures[si].rotation,
-                                                          hs_is_door ? (placed_structures[si].open ? ",\"open\":true" : ",\"open\":false") : "",
-                                                          hs_is_door ? (placed_structures[si].door_locked ? ",\"locked\":true" : ",\"locked\":false") : "",
-                                                          hs_sy_extra,
-                                                          hs_cannon_extra,
-                                                          hs_claim_extra,
-                                                          hs_dom_extra,
-                                                          hs_chest_extra,
-                                                          hs_wreck_extra,
-                                                          hs_qt_extra);
-                                            hs_sfirst = false;
-                                        }
-                                        hs_sp += snprintf(hs_structs_buf + hs_sp, sizeof(hs_structs_buf) - hs_sp, "]}");
-                                        char hs_sf[131086];
-                                        size_t hs_sflen = websocket_create_frame(
-                                            WS_OPCODE_TEXT, hs_structs_buf, (size_t)hs_sp,
-                                            hs_sf, sizeof(hs_sf));
-                                        if (hs_sflen > 0 && hs_sflen < sizeof(hs_sf))
-                                            send_all(client->fd, hs_sf, hs_sflen);
-                                        log_info("📦 Sent STRUCTURES (%u) to JSON-handshake player %u",
-                                                 placed_structure_count, client->player_id);
+                                        int hs_sn = send_structures_list(client);
+                                        log_info("📦 Sent STRUCTURES (%d) to JSON-handshake player %u",
+                                                 hs_sn, client->player_id);
                                     }
 
                                     // Skip normal response sending since we already sent
@@ -9622,6 +9914,7 @@ int websocket_server_update(struct Sim* sim) {
 
                                                 gp_sim->modules[gp_sim->module_count++]       = ng;
                                                 gp_simple->modules[gp_simple->module_count++] = ng;
+                                                ship_flooding_touch(gp_sim);
 
                                                 module_place_consume(player, payload, _res_ship,
                                                     _ship_only, _pack_only, _yard_only,
@@ -9699,6 +9992,7 @@ int websocket_server_update(struct Sim* sim) {
                                                     for (uint8_t cms = 0; cms < tog_simple->module_count; cms++) {
                                                         if (tog_simple->modules[cms].id == tog_sim->modules[cm].id) {
                                                             tog_simple->modules[cms].local_pos.y = cannon_new_y;
+                                                            ship_module_grid_invalidate(&tog_simple->module_grid);
                                                             break;
                                                         }
                                                     }
@@ -9706,6 +10000,7 @@ int websocket_server_update(struct Sim* sim) {
                                                 }
                                                 recalc_ship_mass(tog_simple);
                                             }
+                                            ship_flooding_touch(tog_sim);
                                             found = true;
                                             log_info("🔳 Player %u toggled gunport %u → %s on ship %u",
                                                      player->player_id, gunport_id,
@@ -10489,6 +10784,7 @@ int websocket_server_update(struct Sim* sim) {
                                                         log_info("🎯 Cannon %u → group %d (%s) company %u ship %u",
                                                                  nc.id, auto_group, sector_name, (unsigned)co, simple->ship_id);
                                                     }
+                                                    weapon_groups_changed(simple);
                                                 }
                                             }
 
@@ -13786,322 +14082,16 @@ int websocket_server_update(struct Sim* sim) {
                                     }
                                 }
                                 /* Send current placed structures */
-                                {
-                                    static char structs_buf[16384];
-                                    int spos = 0;
-                                    spos += snprintf(structs_buf + spos, sizeof(structs_buf) - spos,
-                                                     "{\"type\":\"STRUCTURES\",\"structures\":[");
-                                    bool sfirst = true;
-                                    for (uint32_t si = 0; si < placed_structure_count; si++) {
-                                        if (!placed_structures[si].active) continue;
-                                        const char* stype_str =
-                                            placed_structures[si].type == STRUCT_WOODEN_FLOOR ? "wooden_floor" :
-                                            placed_structures[si].type == STRUCT_WORKBENCH    ? "workbench" :
-                                            placed_structures[si].type == STRUCT_WALL         ? "wall" :
-                                            placed_structures[si].type == STRUCT_DOOR_FRAME   ? "door_frame" :
-                                            placed_structures[si].type == STRUCT_DOOR         ? "door" :
-                                            placed_structures[si].type == STRUCT_SHIPYARD     ? "shipyard" :
-                                            placed_structures[si].type == STRUCT_WRECK        ? "wreck" :
-                                            placed_structures[si].type == STRUCT_CEILING      ? "wood_ceiling" :
-                                            placed_structures[si].type == STRUCT_CANNON       ? "cannon" :
-                                            placed_structures[si].type == STRUCT_FLAG_FORT    ? "flag_fort" :
-                                            placed_structures[si].type == STRUCT_CLAIM_FLAG   ? "claim_flag" :
-                                            placed_structures[si].type == STRUCT_COMPANY_FORTRESS ? "company_fortress" :
-                                            placed_structures[si].type == STRUCT_CHEST        ? "chest" :
-                                            "unknown";
-                                        bool is_door_s   = (placed_structures[si].type == STRUCT_DOOR);
-                                        bool is_sy_s     = (placed_structures[si].type == STRUCT_SHIPYARD);
-                                        bool is_cannon_s = (placed_structures[si].type == STRUCT_CANNON);
-                                        bool is_cfrt_s   = (placed_structures[si].type == STRUCT_COMPANY_FORTRESS);
-                                        bool is_cflag_s  = (placed_structures[si].type == STRUCT_CLAIM_FLAG);
-                                        char sy_extra_s[256] = "";
-                                        char cannon_extra_s[96] = "";
-                                        char claim_extra_s[320] = "";
-                                        char dom_extra_s[512] = "";
-                                        char chest_extra_s[128] = "";
-                                        char wreck_extra_s[40] = "";
-                                        char qt_extra_s[24] = "";
-                                        if (placed_structures[si].type == STRUCT_WRECK) {
-                                            int wt = wreck_best_tier(&placed_structures[si]);
-                                            if (wt >= 0) snprintf(wreck_extra_s, sizeof(wreck_extra_s), ",\"wreck_tier\":%d", wt);
-                                        }
-                                        {
-                                            int qt = structure_quality_tier(&placed_structures[si]);
-                                            if (qt >= 0) snprintf(qt_extra_s, sizeof(qt_extra_s), ",\"qt\":%d", qt);
-                                        }
-                                        format_dominators_extra(&placed_structures[si], dom_extra_s, sizeof(dom_extra_s));
-                                        if (placed_structures[si].type == STRUCT_CHEST
-                                            || placed_structures[si].type == STRUCT_SHIPYARD) {
-                                            snprintf(chest_extra_s, sizeof(chest_extra_s),
-                                                     ",\"chest_wood\":%u,\"chest_fiber\":%u,\"chest_metal\":%u,\"chest_stone\":%u",
-                                                     (unsigned)placed_structures[si].chest_wood,
-                                                     (unsigned)placed_structures[si].chest_fiber,
-                                                     (unsigned)placed_structures[si].chest_metal,
-                                                     (unsigned)placed_structures[si].chest_stone);
-                                        }
-                                        if (is_sy_s) {
-                                            char smj[128] = "[]";
-                                            if (placed_structures[si].modules_placed) {
-                                                int smp = 0;
-                                                smj[smp++] = '[';
-                                                const char* smn[6] = {"hull_left","hull_right","deck","mast","cannon_port","cannon_stbd"};
-                                                bool smf = true;
-                                                for (int b = 0; b < 6; b++) {
-                                                    if (placed_structures[si].modules_placed & (1u << b)) {
-                                                        if (!smf) smj[smp++] = ',';
-                                                        smp += snprintf(smj + smp, (int)sizeof(smj) - smp, "\"%s\"", smn[b]);
-                                                        smf = false;
-                                                    }
-                                                }
-                                                smj[smp++] = ']';
-                                                smj[smp]   = '\0';
-                                            }
-                                            const char* sphase = placed_structures[si].construction_phase == CONSTRUCTION_BUILDING ? "building" : "empty";
-                                            snprintf(sy_extra_s, sizeof(sy_extra_s),
-                                                     ",\"construction_phase\":\"%s\",\"modules_placed\":%s",
-                                                     sphase, smj);
-                                        }
-                                        if (is_cannon_s) {
-                                            snprintf(cannon_extra_s, sizeof(cannon_extra_s),
-                                                     ",\"cannon_aim_angle\":%.4f,\"cannon_reload_ms\":%u,\"cannon_loaded_ammo\":%u",
-                                                     placed_structures[si].cannon_aim_angle,
-                                                     placed_structures[si].cannon_reload_ms,
-                                                     (unsigned)placed_structures[si].cannon_loaded_ammo);
-                                        }
-                                        if (is_cfrt_s) {
-                                            snprintf(claim_extra_s, sizeof(claim_extra_s),
-                                                     ",\"fortress_build_progress\":%.0f,\"fortress_complete\":%s,\"fortress_contested\":%s,\"claim_orphaned\":%s",
-                                                     placed_structures[si].claim_progress_ms,
-                                                     placed_structures[si].fortress_complete ? "true" : "false",
-                                                     placed_structures[si].claim_contested   ? "true" : "false",
-                                                     placed_structures[si].claim_orphaned    ? "true" : "false");
-                                        }
-                                        if (is_cflag_s) {
-                                            snprintf(claim_extra_s, sizeof(claim_extra_s),
-                                                     ",\"claim_progress_ms\":%.0f,\"claim_contested\":%s,\"claim_state\":%u,\"claim_grace_ms\":%.0f,\"claim_targets_fortress\":%s,\"claim_linked_fort\":%u,\"claim_source_enemy\":%u",
-                                                     placed_structures[si].claim_progress_ms,
-                                                     placed_structures[si].claim_contested        ? "true" : "false",
-                                                     (unsigned)placed_structures[si].claim_state,
-                                                     placed_structures[si].claim_grace_ms,
-                                                     placed_structures[si].claim_targets_fortress ? "true" : "false",
-                                                     (unsigned)placed_structures[si].claim_linked_fort,
-                                                     (unsigned)placed_structures[si].claim_source_enemy);
-                                        } else if (placed_structures[si].type == STRUCT_FLAG_FORT) {
-                                            float ff_prog = (placed_structures[si].max_hp > 0)
-                                                ? ((float)placed_structures[si].hp / (float)placed_structures[si].max_hp) * (float)FLAG_FORT_BUILD_MS
-                                                : 0.0f;
-                                            snprintf(claim_extra_s, sizeof(claim_extra_s),
-                                                     ",\"claim_orphaned\":%s"
-                                                     ",\"fortress_complete\":%s"
-                                                     ",\"fortress_build_progress\":%.0f"
-                                                     ",\"fortress_contested\":%s"
-                                                     ",\"claim_phase\":%u"
-                                                     ",\"claim_progress_ms\":%.0f,\"claim_total_ms\":%u"
-                                                     ",\"claim_state\":%u,\"claim_grace_ms\":%.0f",
-                                                     placed_structures[si].claim_orphaned   ? "true" : "false",
-                                                     placed_structures[si].fortress_complete ? "true" : "false",
-                                                     ff_prog,
-                                                     placed_structures[si].claim_contested  ? "true" : "false",
-                                                     (unsigned)placed_structures[si].claim_phase,
-                                                     (placed_structures[si].claim_phase == FLAG_FORT_PHASE_CLAIMING) ? placed_structures[si].claim_progress_ms : 0.0f,
-                                                     (unsigned)FLAG_FORT_CLAIM_MS,
-                                                     (unsigned)placed_structures[si].claim_state,
-                                                     placed_structures[si].claim_grace_ms);
-                                        }
-                                        spos += snprintf(structs_buf + spos, sizeof(structs_buf) - spos,
-                                                         "%s{\"id\":%u,\"structure_type\":\"%s\","
-                                                         "\"island_id\":%u,\"x\":%.1f,\"y\":%.1f,"
-                                                         "\"company_id\":%u,\"hp\":%u,\"max_hp\":%u,\"target_hp\":%u,\"placer_name\":\"%s\""
-                                                         ",\"rotation\":%.2f%s%s%s%s%s%s%s%s}",
-                                                         sfirst ? "" : ",",
-                                                         placed_structures[si].id,
-                                                         stype_str,
-                                                         placed_structures[si].island_id,
-                                                         placed_structures[si].x,
-                                                         placed_structures[si].y,
-                                                         (unsigned)placed_structures[si].company_id,
-                                                         (unsigned)placed_structures[si].hp,
-                                                         (unsigned)placed_structures[si].max_hp,
-                                                         (unsigned)placed_structures[si].target_hp,
-                                                         placed_structures[si].placer_name,
-                                                         placed_structures[si].rotation,
-                                                         is_door_s ? (placed_structures[si].open ? ",\"open\":true" : ",\"open\":false") : "",
-                                                         sy_extra_s,
-                                                         cannon_extra_s,
-                                                         claim_extra_s,
-                                                         dom_extra_s,
-                                                         chest_extra_s,
-                                                         wreck_extra_s,
-                                                         qt_extra_s);
-                                        sfirst = false;
-                                    }
-                                    spos += snprintf(structs_buf + spos, sizeof(structs_buf) - spos, "]}");
-                                    char sf[16640];
-                                    size_t sflen = websocket_create_frame(
-                                        WS_OPCODE_TEXT, structs_buf, (size_t)spos, sf, sizeof(sf));
-                                    if (sflen > 0 && sflen < sizeof(sf))
-                                        send(client->fd, sf, sflen, 0);
-                                }
+                                (void)send_structures_list(client);
                             }
                             handled = true;
                             
                         } else if (strncmp(payload, "GET_STRUCTURES", 14) == 0) {
                             /* Re-send the full placed-structures list to this client. */
                             {
-                                static char gs_buf[131072];
-                                int gp = 0;
-                                gp += snprintf(gs_buf + gp, sizeof(gs_buf) - gp,
-                                               "{\"type\":\"STRUCTURES\",\"structures\":[");
-                                bool gfirst = true;
-                                for (uint32_t si = 0; si < placed_structure_count; si++) {
-                                    if (!placed_structures[si].active) continue;
-                                    const char* gs_type =
-                                        placed_structures[si].type == STRUCT_WOODEN_FLOOR ? "wooden_floor" :
-                                        placed_structures[si].type == STRUCT_WORKBENCH    ? "workbench" :
-                                        placed_structures[si].type == STRUCT_WALL         ? "wall" :
-                                        placed_structures[si].type == STRUCT_DOOR_FRAME   ? "door_frame" :
-                                        placed_structures[si].type == STRUCT_DOOR         ? "door" :
-                                        placed_structures[si].type == STRUCT_SHIPYARD     ? "shipyard" :
-                                        placed_structures[si].type == STRUCT_WRECK        ? "wreck" :
-                                        placed_structures[si].type == STRUCT_CEILING      ? "wood_ceiling" :
-                                        placed_structures[si].type == STRUCT_CANNON       ? "cannon" :
-                                        placed_structures[si].type == STRUCT_FLAG_FORT    ? "flag_fort" :
-                                        placed_structures[si].type == STRUCT_CLAIM_FLAG   ? "claim_flag" :
-                                        placed_structures[si].type == STRUCT_COMPANY_FORTRESS ? "company_fortress" :
-                                        placed_structures[si].type == STRUCT_CHEST        ? "chest" :
-                                        "unknown";
-                                    bool gs_is_door   = (placed_structures[si].type == STRUCT_DOOR);
-                                    bool gs_is_sy     = (placed_structures[si].type == STRUCT_SHIPYARD);
-                                    bool gs_is_cannon = (placed_structures[si].type == STRUCT_CANNON);
-                                    bool gs_is_cfrt   = (placed_structures[si].type == STRUCT_COMPANY_FORTRESS);
-                                    bool gs_is_cflag  = (placed_structures[si].type == STRUCT_CLAIM_FLAG);
-                                    char gs_sy_extra[256] = "";
-                                    char gs_cannon_extra[96] = "";
-                                    char gs_claim_extra[320] = "";
-                                    char gs_dom_extra[512] = "";
-                                    char gs_chest_extra[128] = "";
-                                    char gs_wreck_extra[40] = "";
-                                    char gs_qt_extra[24] = "";
-                                    if (placed_structures[si].type == STRUCT_WRECK) {
-                                        int gwt = wreck_best_tier(&placed_structures[si]);
-                                        if (gwt >= 0) snprintf(gs_wreck_extra, sizeof(gs_wreck_extra), ",\"wreck_tier\":%d", gwt);
-                                    }
-                                    {
-                                        int gqt = structure_quality_tier(&placed_structures[si]);
-                                        if (gqt >= 0) snprintf(gs_qt_extra, sizeof(gs_qt_extra), ",\"qt\":%d", gqt);
-                                    }
-                                    format_dominators_extra(&placed_structures[si], gs_dom_extra, sizeof(gs_dom_extra));
-                                    if (placed_structures[si].type == STRUCT_CHEST
-                                        || placed_structures[si].type == STRUCT_SHIPYARD) {
-                                        snprintf(gs_chest_extra, sizeof(gs_chest_extra),
-                                                 ",\"chest_wood\":%u,\"chest_fiber\":%u,\"chest_metal\":%u,\"chest_stone\":%u",
-                                                 (unsigned)placed_structures[si].chest_wood,
-                                                 (unsigned)placed_structures[si].chest_fiber,
-                                                 (unsigned)placed_structures[si].chest_metal,
-                                                 (unsigned)placed_structures[si].chest_stone);
-                                    }
-                                    if (gs_is_sy) {
-                                        char gmj[128] = "[]";
-                                        if (placed_structures[si].modules_placed) {
-                                            int gmp = 0;
-                                            gmj[gmp++] = '[';
-                                            const char* gmn[6] = {"hull_left","hull_right","deck","mast","cannon_port","cannon_stbd"};
-                                            bool gmf = true;
-                                            for (int b = 0; b < 6; b++) {
-                                                if (placed_structures[si].modules_placed & (1u << b)) {
-                                                    if (!gmf) gmj[gmp++] = ',';
-                                                    gmp += snprintf(gmj + gmp, (int)sizeof(gmj) - gmp, "\"%s\"", gmn[b]);
-                                                    gmf = false;
-                                                }
-                                            }
-                                            gmj[gmp++] = ']';
-                                            gmj[gmp]   = '\0';
-                                        }
-                                        const char* gphase = placed_structures[si].construction_phase == CONSTRUCTION_BUILDING ? "building" : "empty";
-                                        snprintf(gs_sy_extra, sizeof(gs_sy_extra),
-                                                 ",\"construction_phase\":\"%s\",\"modules_placed\":%s",
-                                                 gphase, gmj);
-                                    }
-                                                                        if (gs_is_cannon) {
-                                                                                snprintf(gs_cannon_extra, sizeof(gs_cannon_extra),
-                                                                                                 ",\"cannon_aim_angle\":%.4f,\"cannon_reload_ms\":%u,\"cannon_loaded_ammo\":%u",
-                                                                                                 placed_structures[si].cannon_aim_angle,
-                                                                                                 placed_structures[si].cannon_reload_ms,
-                                                                                                 (unsigned)placed_structures[si].cannon_loaded_ammo);
-                                                                        }
-                                    if (gs_is_cfrt) {
-                                        snprintf(gs_claim_extra, sizeof(gs_claim_extra),
-                                                 ",\"fortress_build_progress\":%.0f,\"fortress_complete\":%s,\"fortress_contested\":%s,\"claim_orphaned\":%s",
-                                                 placed_structures[si].claim_progress_ms,
-                                                 placed_structures[si].fortress_complete ? "true" : "false",
-                                                 placed_structures[si].claim_contested   ? "true" : "false",
-                                                 placed_structures[si].claim_orphaned    ? "true" : "false");
-                                    }
-                                    if (gs_is_cflag) {
-                                        snprintf(gs_claim_extra, sizeof(gs_claim_extra),
-                                                 ",\"claim_progress_ms\":%.0f,\"claim_contested\":%s,\"claim_state\":%u,\"claim_grace_ms\":%.0f,\"claim_targets_fortress\":%s,\"claim_linked_fort\":%u,\"claim_source_enemy\":%u",
-                                                 placed_structures[si].claim_progress_ms,
-                                                 placed_structures[si].claim_contested        ? "true" : "false",
-                                                 (unsigned)placed_structures[si].claim_state,
-                                                 placed_structures[si].claim_grace_ms,
-                                                 placed_structures[si].claim_targets_fortress ? "true" : "false",
-                                                 (unsigned)placed_structures[si].claim_linked_fort,
-                                                 (unsigned)placed_structures[si].claim_source_enemy);
-                                    } else if (placed_structures[si].type == STRUCT_FLAG_FORT) {
-                                        float ff_prog = (placed_structures[si].max_hp > 0)
-                                            ? ((float)placed_structures[si].hp / (float)placed_structures[si].max_hp) * (float)FLAG_FORT_BUILD_MS
-                                            : 0.0f;
-                                        snprintf(gs_claim_extra, sizeof(gs_claim_extra),
-                                                 ",\"claim_orphaned\":%s"
-                                                 ",\"fortress_complete\":%s"
-                                                 ",\"fortress_build_progress\":%.0f"
-                                                 ",\"fortress_contested\":%s"
-                                                 ",\"claim_phase\":%u"
-                                                 ",\"claim_progress_ms\":%.0f,\"claim_total_ms\":%u"
-                                                 ",\"claim_state\":%u,\"claim_grace_ms\":%.0f",
-                                                 placed_structures[si].claim_orphaned   ? "true" : "false",
-                                                 placed_structures[si].fortress_complete ? "true" : "false",
-                                                 ff_prog,
-                                                 placed_structures[si].claim_contested  ? "true" : "false",
-                                                 (unsigned)placed_structures[si].claim_phase,
-                                                 (placed_structures[si].claim_phase == FLAG_FORT_PHASE_CLAIMING) ? placed_structures[si].claim_progress_ms : 0.0f,
-                                                 (unsigned)FLAG_FORT_CLAIM_MS,
-                                                 (unsigned)placed_structures[si].claim_state,
-                                                 placed_structures[si].claim_grace_ms);
-                                    }
-                                    gp += snprintf(gs_buf + gp, sizeof(gs_buf) - gp,
-                                                   "%s{\"id\":%u,\"structure_type\":\"%s\","
-                                                   "\"island_id\":%u,\"x\":%.1f,\"y\":%.1f,"
-                                                   "\"company_id\":%u,\"hp\":%u,\"max_hp\":%u,\"target_hp\":%u,\"placer_name\":\"%s\""
-                                                                                                     ",\"rotation\":%.2f%s%s%s%s%s%s%s%s}",
-                                                   gfirst ? "" : ",",
-                                                   placed_structures[si].id, gs_type,
-                                                   placed_structures[si].island_id,
-                                                   placed_structures[si].x, placed_structures[si].y,
-                                                   (unsigned)placed_structures[si].company_id,
-                                                   (unsigned)placed_structures[si].hp,
-                                                   (unsigned)placed_structures[si].max_hp,
-                                                   (unsigned)placed_structures[si].target_hp,
-                                                   placed_structures[si].placer_name,
-                                                   placed_structures[si].rotation,
-                                                   gs_is_door ? (placed_structures[si].open ? ",\"open\":true" : ",\"open\":false") : "",
-                                                                                                     gs_sy_extra,
-                                                                                                     gs_cannon_extra,
-                                                                                                     gs_claim_extra,
-                                                                                                     gs_dom_extra,
-                                                                                                     gs_chest_extra,
-                                                                                                     gs_wreck_extra,
-                                                                                                     gs_qt_extra);
-                                    gfirst = false;
-                                }
-                                gp += snprintf(gs_buf + gp, sizeof(gs_buf) - gp, "]}");
-                                char gf[131086];
-                                size_t gflen = websocket_create_frame(
-                                    WS_OPCODE_TEXT, gs_buf, (size_t)gp, gf, sizeof(gf));
-                                if (gflen > 0 && gflen < sizeof(gf))
-                                    send_all(client->fd, gf, gflen);
-                                log_info("📦 Sent STRUCTURES (%u) on GET_STRUCTURES to player %u",
-                                         placed_structure_count, client->player_id);
+                                int gs_n = send_structures_list(client);
+                                log_info("📦 Sent STRUCTURES (%d) on GET_STRUCTURES to player %u",
+                                         gs_n, client->player_id);
                             }
                             strcpy(response, "{\"type\":\"ack\"}");
                             handled = true;
@@ -14172,7 +14162,17 @@ int websocket_server_update(struct Sim* sim) {
                         // PONG sent
                     }
                 } else if (opcode == WS_OPCODE_PONG) {
-                    // PONG received
+                    /* Echo of our outstanding RTT probe; stale, repeated or
+                     * unsolicited PONGs don't match the nonce and are ignored */
+                    uint32_t echoed = 0;
+                    if (payload_len == sizeof(echoed)) memcpy(&echoed, payload, sizeof(echoed));
+                    if (client->ping_nonce && echoed == client->ping_nonce) {
+                        uint32_t rtt = get_time_ms() - client->last_ping_time;
+                        client->ping_nonce = 0;
+                        client->rtt_ms = client->rtt_ms > 0.0f
+                            ? client->rtt_ms + ((float)rtt - client->rtt_ms) * 0.125f
+                            : (float)rtt;
+                    }
                 } else {
                     log_warn("⚠️ Unknown WebSocket opcode 0x%X from %s:%u (Player: %u)", 
                             opcode, client->ip_address, client->port, client->player_id);
@@ -14259,6 +14259,7 @@ void websocket_server_send_game_state(void) {
 
     if (send_now) {
         uint64_t _ship_build_t0_us = get_time_us();
+        PROF_BEGIN("send.blobs");
         
         /* ── Pre-build shared blobs (players, projectiles, NPCs, tombstones,
          * dropped items, companies) in worker with synchronous fallback.
@@ -14337,6 +14338,7 @@ void websocket_server_send_game_state(void) {
 
         g_ship_json_last_us = get_time_us() - _ship_build_t0_us;
         if (g_ship_json_last_us > g_ship_json_max_us) g_ship_json_max_us = g_ship_json_last_us;
+        PROF_END();
 
         const SharedBlobOutput* blobs = shared_blob_ptr;
         const char* ships_json = blobs->ships_json;
@@ -14377,6 +14379,7 @@ void websocket_server_send_game_state(void) {
         static char per_frame[PER_GS_BUF + 14];
         uint64_t _send_loop_t0_us = get_time_us();
         uint64_t _send_build_t0_us = get_time_us();
+        PROF_BEGIN("send.build");
 
         /* Prebuild JSON sections identical for every client (proj + tmb/ditem/co). */
         static char gs_proj_section[65536 + 16];
@@ -14620,6 +14623,7 @@ void websocket_server_send_game_state(void) {
             per_gs_len[_send_count] = _goff;
 
             g_gs_total_last = _goff;
+            metrics_observe(g_ws_metrics.gs_payload, _goff);
             if (_goff > g_gs_total_max) g_gs_total_max = _goff;
             g_gs_ships_last    = _sec_ships;
             g_gs_players_last  = _sec_players;
@@ -14635,6 +14639,7 @@ void websocket_server_send_game_state(void) {
         }
         g_send_build_last_us = get_time_us() - _send_build_t0_us;
         if (g_send_build_last_us > g_send_build_max_us) g_send_build_max_us = g_send_build_last_us;
+        PROF_END();
 
         /* Phase 2: round-robin bounded frame+send.
          *
@@ -14646,6 +14651,7 @@ void websocket_server_send_game_state(void) {
          * the next tick — they skip at most one frame which is imperceptible at 20 Hz.
          */
         uint64_t _send_dispatch_t0_us = get_time_us();
+        PROF_BEGIN("send.dispatch");
         int _rr_sent = 0;
         if (_send_count > 0) {
             /* Find the slot whose client index >= watermark (array is sorted ascending). */
@@ -14671,6 +14677,7 @@ void websocket_server_send_game_state(void) {
                     if (_sent > 0) {
                         ws_server.packets_sent++;
                         _rr_sent++;
+                        metrics_inc(g_ws_metrics.bytes_game_state, (uint64_t)_sent);
                     } else if (_sent < 0) {
                         if (errno == EAGAIN || errno == EWOULDBLOCK) {
                             /* TCP send buffer full — frame skipped, client will get next tick. */
@@ -14688,6 +14695,8 @@ void websocket_server_send_game_state(void) {
                     }
                 }
             }
+            metrics_inc(g_ws_metrics.send_eagain, _tick_eagain);
+            metrics_inc(g_ws_metrics.send_errors, _tick_errors);
             g_send_eagain_last = _tick_eagain;
             if (_tick_eagain > g_send_eagain_max) g_send_eagain_max = _tick_eagain;
             g_send_error_last = _tick_errors;
@@ -14699,8 +14708,10 @@ void websocket_server_send_game_state(void) {
         }
         g_rr_deferred_last = (uint64_t)(_send_count - _rr_sent);
         if (g_rr_deferred_last > g_rr_deferred_max) g_rr_deferred_max = g_rr_deferred_last;
+        metrics_gauge_set(g_ws_metrics.send_deferred, (int64_t)g_rr_deferred_last);
         g_send_dispatch_last_us = get_time_us() - _send_dispatch_t0_us;
         if (g_send_dispatch_last_us > g_send_dispatch_max_us) g_send_dispatch_max_us = g_send_dispatch_last_us;
+        PROF_END();
         g_send_loop_last_us = get_time_us() - _send_loop_t0_us;
         if (g_send_loop_last_us > g_send_loop_max_us) g_send_loop_max_us = g_send_loop_last_us;
         last_game_state_time = current_time;
@@ -14807,6 +14818,8 @@ void websocket_server_broadcast(const char* message) {
             ssize_t sent = send(ws_server.clients[i].fd, frame, frame_len, 0);
             if (sent <= 0) {
                 log_warn("Failed to send WebSocket broadcast to client %d", i);
+            } else {
+                metrics_inc(g_ws_metrics.bytes_broadcast, (uint64_t)sent);
             }
         }
     }
@@ -14951,40 +14964,6 @@ int websocket_server_set_player_company(uint32_t player_id, uint8_t company_id)
     return -1; // not found
 }
 
-/* ── Resource respawn tick ──────────────────────────────────────────────────
- * Runs every server tick.  For each depleted resource whose timer has expired
- * and whose footprint is clear of structures, restore health and broadcast. */
-static void tick_resource_respawn(void)
-{
-    uint32_t now = get_time_ms();
-    for (int ii = 0; ii < ISLAND_COUNT; ii++) {
-        IslandDef *isl = &ISLAND_PRESETS[ii];
-        for (int ri = 0; ri < isl->resource_count; ri++) {
-            IslandResource *res = &isl->resources[ri];
-            if (res->health > 0 || res->respawn_at_ms == 0) continue;
-            if (now < res->respawn_at_ms) continue;
-            /* Check no structure is built over this spot */
-            float wx = isl->x + res->ox;
-            float wy = isl->y + res->oy;
-            if (!island_resource_can_respawn(wx, wy, placed_structures, placed_structure_count))
-                continue;
-            /* Restore the node */
-            res->health = res->max_health;
-            res->respawn_at_ms = 0;
-            if (res->type_id == RES_WOOD) {
-                island_mark_tree_alive(isl, ri);
-            }
-            /* Broadcast to all clients */
-            char rmsg[160];
-            snprintf(rmsg, sizeof(rmsg),
-                     "{\"type\":\"resource_respawned\",\"island_id\":%d,\"ri\":%d,"
-                     "\"ox\":%.1f,\"oy\":%.1f,\"hp\":%d,\"maxHp\":%d}",
-                     isl->id, ri, res->ox, res->oy, res->health, res->max_health);
-            websocket_server_broadcast(rmsg);
-        }
-    }
-}
-
 // HYBRID: Apply movement state to all active players (called every server tick)
 void websocket_server_tick(float dt) {
     uint32_t current_time = get_time_ms();
@@ -14992,7 +14971,9 @@ void websocket_server_tick(float dt) {
     // ===== SYNC SHIP STATE FROM SIMULATION =====
     // This ensures SimpleShip has current position/rotation for mounted player updates
     sync_simple_ships_from_simulation();
+    record_ship_history();
 
+    PROF_BEGIN("wstick.hit_events");
     // ===== BROADCAST HIT EVENTS FROM SIMULATION =====
     // All hit-event frames for this tick are accumulated into a single buffer
     // and flushed with ONE send() per client at the end.  Previously, each event
@@ -15141,6 +15122,7 @@ void websocket_server_tick(float dt) {
                                 memmove(&simple->modules[m], &simple->modules[m + 1],
                                         (simple->module_count - m - 1) * sizeof(ShipModule));
                                 simple->module_count--;
+                                ship_module_grid_invalidate(&simple->module_grid);
                                 break;
                             }
                         }
@@ -15214,6 +15196,7 @@ void websocket_server_tick(float dt) {
                                 memmove(&simple->modules[m], &simple->modules[m + 1],
                                         (simple->module_count - m - 1) * sizeof(ShipModule));
                                 simple->module_count--;
+                                ship_module_grid_invalidate(&simple->module_grid);
                             }
                         }
                         // Dismount any players whose module was just wiped
@@ -15238,14 +15221,10 @@ void websocket_server_tick(float dt) {
                     }
 
                     // Spawn chest_ruin wreck if the destroyed module was a chest with resources
+                    PlacedStructure *wr = NULL;
                     if (chest_ruin_active &&
                         (chest_ruin_wood + chest_ruin_fiber + chest_ruin_metal + chest_ruin_stone) > 0 &&
-                        placed_structure_count < MAX_PLACED_STRUCTURES) {
-                        PlacedStructure *wr = &placed_structures[placed_structure_count];
-                        memset(wr, 0, sizeof(*wr));
-                        wr->active               = true;
-                        wr->id                   = next_structure_id++;
-                        wr->type                 = STRUCT_WRECK;
+                        (wr = structure_alloc(STRUCT_WRECK)) != NULL) {
                         wr->x                    = chest_ruin_wx;
                         wr->y                    = chest_ruin_wy;
                         wr->island_id            = 0; /* at sea */
@@ -15256,8 +15235,6 @@ void websocket_server_tick(float dt) {
                         wr->chest_stone          = chest_ruin_stone;
                         wr->wreck_expires_ms     = get_time_ms() + 900000u; /* 15 min */
                         snprintf(wr->placer_name, sizeof(wr->placer_name), "chest_ruin");
-                        placed_structure_count++;
-                        structure_index_rebuild();
                         char wbcast[256];
                         snprintf(wbcast, sizeof(wbcast),
                             "{\"type\":\"wreck_spawned\",\"id\":%u,\"x\":%.1f,\"y\":%.1f"
@@ -15367,6 +15344,7 @@ void websocket_server_tick(float dt) {
                                             memmove(&simple->modules[m], &simple->modules[m+1],
                                                     (simple->module_count - (uint8_t)m - 1) * sizeof(ShipModule));
                                             simple->module_count--;
+                                            ship_module_grid_invalidate(&simple->module_grid);
                                         }
                                     }
                                 }
@@ -15380,6 +15358,7 @@ void websocket_server_tick(float dt) {
                                 memmove(&simple->modules[m], &simple->modules[m + 1],
                                         (simple->module_count - m - 1) * sizeof(ShipModule));
                                 simple->module_count--;
+                                ship_module_grid_invalidate(&simple->module_grid);
                                 break;
                             }
                         }
@@ -15467,12 +15446,16 @@ void websocket_server_tick(float dt) {
         if (hit_batch_len > 0) {
             for (int i = 0; i < WS_MAX_CLIENTS; i++) {
                 struct WebSocketClient* client = &ws_server.clients[i];
-                if (client->connected && client->handshake_complete)
-                    send(client->fd, hit_batch, hit_batch_len, 0);
+                if (client->connected && client->handshake_complete &&
+                    send(client->fd, hit_batch, hit_batch_len, 0) > 0)
+                    metrics_inc(g_ws_metrics.bytes_hit_events, hit_batch_len);
             }
         }
     }
 
+    PROF_END();
+
+    PROF_BEGIN("wstick.projectile_hits");
     // ===== CANNONBALL / BAR SHOT / GRAPESHOT / CANISTER SHOT vs ENTITY HIT DETECTION =====
     // Cannonballs (PROJ_TYPE_CANNONBALL) deal base 75 HP to on-deck crew.
     // Bar shot (PROJ_TYPE_BAR_SHOT) passes through hull/masts but deals base 15 HP
@@ -15830,6 +15813,8 @@ void websocket_server_tick(float dt) {
         #undef ENTITY_PROJ_ENTERED_HIT
     }
 
+    PROF_END();
+
     // ===== TICK WORLD WIND =====
     {
         /* 20-minute clockwise cycle: 2π / (20 × 60) ≈ 0.00524 rad/s */
@@ -15844,10 +15829,15 @@ void websocket_server_tick(float dt) {
         }
     }
 
+    PROF_BEGIN("wstick.npcs");
     // ===== TICK NPC AGENTS =====
-    tick_npc_agents(dt);
-    tick_world_npcs(dt);
+    npc_sched_plan(dt);
+    tick_npc_agents();
+    tick_world_npcs();
 
+    PROF_END();
+
+    PROF_BEGIN("wstick.crew_weapons");
     // ===== APPLY DESIRED SAIL STATE TO UNMANNED MASTS =====
     /* Rigger NPCs handle masts they are explicitly assigned to.  Any mast that
      * has no active rigger covering it must be driven directly so that helm
@@ -15934,18 +15924,22 @@ void websocket_server_tick(float dt) {
     }
 
     // ===== ASSIGN CREW TO WEAPON-GROUP CANNONS + SWIVELS =====
-    // Mark swivels needed, expire stale NEEDED flags, then dispatch idle gunners.
+    // Expire stale NEEDED flags, then dispatch idle gunners (both walk only
+    // the NEEDED weapons on each ship's crew job board).
     tick_cannon_needed_expiry();
     for (int s = 0; s < ship_count; s++) {
-        if (ships[s].active) {
-            tick_swivel_crew_demand(&ships[s]);
-            assign_weapon_group_crew(&ships[s]);
-        }
+        if (ships[s].active) assign_weapon_group_crew(&ships[s]);
     }
 
     // ===== TICK SHIP WEAPON GROUPS (TARGETFIRE auto-aim) =====
     tick_ship_weapon_groups();
 
+    PROF_END();
+
+    PROF_BEGIN("wstick.world");
+    // Structure slots freed last tick become reusable
+    structure_store_reclaim();
+
     // ===== TICK SINKING SHIPS (velocity=0, despawn after 8s) =====
     tick_sinking_ships();
     tick_wrecks();
@@ -15957,15 +15951,16 @@ void websocket_server_tick(float dt) {
     // ===== TICK GHOST SPAWN POINTS (configured respawn system) =====
     tick_ghost_spawn_points(dt);
 
-    // ===== TICK RESOURCE RESPAWNS =====
-    tick_resource_respawn();
+    // ===== FIRE DUE TIMERS (repairs, forts, respawns, expiry) =====
+    timer_wheel_advance(current_time);
 
     // ===== TICK ISLAND CANNON RELOAD TIMERS =====
     {
         uint32_t tick_ms = (uint32_t)(dt * 1000.0f + 0.5f);
-        for (uint32_t _csi = 0; _csi < placed_structure_count; _csi++) {
-            PlacedStructure* _cs = &placed_structures[_csi];
-            if (!_cs->active || _cs->type != STRUCT_CANNON) continue;
+        uint32_t _cn;
+        const uint32_t *_cslots = structure_slots_of_type(STRUCT_CANNON, &_cn);
+        for (uint32_t _csi = 0; _csi < _cn; _csi++) {
+            PlacedStructure* _cs = &placed_structures[_cslots[_csi]];
             if (_cs->cannon_reload_ms > 0) {
                 uint32_t prev_ms = _cs->cannon_reload_ms;
                 _cs->cannon_reload_ms = (prev_ms > tick_ms) ? prev_ms - tick_ms : 0;
@@ -15980,14 +15975,18 @@ void websocket_server_tick(float dt) {
         }
     }
 
+    PROF_END();
+
+    PROF_BEGIN("wstick.aim");
     // ===== ADVANCE CANNON AIM TOWARD DESIRED (turn-speed limit) =====
     // Normal cannons: 60 deg/s.  Ghost ship cannons: 180 deg/s so their swept
     // barrels track the oscillation without visible lag.
     {
         const float CANNON_TURN_SPEED        = 60.0f  * (float)(M_PI / 180.0f); // rad/s
-        for (uint32_t _csi = 0; _csi < placed_structure_count; _csi++) {
-            PlacedStructure* _cs = &placed_structures[_csi];
-            if (!_cs->active || _cs->type != STRUCT_CANNON) continue;
+        uint32_t _cn;
+        const uint32_t *_cslots = structure_slots_of_type(STRUCT_CANNON, &_cn);
+        for (uint32_t _csi = 0; _csi < _cn; _csi++) {
+            PlacedStructure* _cs = &placed_structures[_cslots[_csi]];
             float cur  = _cs->cannon_aim_angle;
             float tgt  = _cs->cannon_desired_aim_angle;
             float diff = tgt - cur;
@@ -16095,6 +16094,8 @@ void websocket_server_tick(float dt) {
         }
     }
 
+    PROF_END();
+
     int moving_players = 0;
     
     // Count moving players (for adaptive tick rate)
@@ -16104,6 +16105,7 @@ void websocket_server_tick(float dt) {
         }
     }
     
+    PROF_BEGIN("wstick.player_sync");
     // ===== SYNC WEBSOCKET PLAYERS TO SIMULATION FOR COLLISION DETECTION =====
     if (global_sim) {
         // Physics constants (scaled to server units via WORLD_SCALE_FACTOR)
@@ -16647,7 +16649,7 @@ void websocket_server_tick(float dt) {
                                 float dist_sq = dx * dx + dy * dy;
                                 bool still_inside;
                                 if (isl_mv->vertex_count > 0) {
-                                    still_inside = island_poly_contains(isl_mv, new_x, new_y);
+                                    still_inside = island_layer_contains(isl_mv, ISLAND_LAYER_LAND, new_x, new_y);
                                 } else {
                                     float angle   = atan2f(dy, dx);
                                     float beach_r = island_boundary_r(isl_mv->beach_radius_px,
@@ -16674,42 +16676,49 @@ void websocket_server_tick(float dt) {
                                 /* Resolve collisions with walls and closed doors on this island */
                                 {
                                     const float PLAYER_R = 8.0f;
-                                    for (uint32_t wi = 0; wi < placed_structure_count; wi++) {
-                                        PlacedStructure *ws = &placed_structures[wi];
-                                        if (!ws->active) continue;
-                                        if (ws->island_id != ws_player->on_island_id) continue;
-                                        bool is_wall = (ws->type == STRUCT_WALL);
-                                        bool is_door = (ws->type == STRUCT_DOOR && !ws->open);
-                                        if (!is_wall && !is_door) continue;
-                                        /* OBB collision: rotate player into wall-local space */
-                                        float wrad = wall_get_rad(ws->x, ws->y);
-                                        float wc  = cosf(-wrad), wsn = sinf(-wrad);
-                                        float cpx = new_x - ws->x;
-                                        float cpy = new_y - ws->y;
-                                        float lx = cpx * wc  - cpy * wsn;
-                                        float ly = cpx * wsn + cpy * wc;
-                                        float clamp_x = lx < -25.0f ? -25.0f : (lx > 25.0f ? 25.0f : lx);
-                                        float clamp_y = ly < -5.0f  ? -5.0f  : (ly > 5.0f  ? 5.0f  : ly);
-                                        float dlx = lx - clamp_x, dly = ly - clamp_y;
-                                        float dist_sq = dlx*dlx + dly*dly;
-                                        if (dist_sq < PLAYER_R * PLAYER_R && dist_sq > 0.0001f) {
-                                            float dist = sqrtf(dist_sq);
-                                            float pen  = PLAYER_R - dist;
-                                            /* Push in local space, rotate back to world space */
-                                            float push_lx = (dlx / dist) * pen;
-                                            float push_ly = (dly / dist) * pen;
-                                            float wc_b = cosf(wrad), wsn_b = sinf(wrad);
-                                            new_x += push_lx * wc_b - push_ly * wsn_b;
-                                            new_y += push_lx * wsn_b + push_ly * wc_b;
+                                    /* Walls, then closed doors */
+                                    for (int wt = 0; wt < 2; wt++) {
+                                        uint32_t wn;
+                                        const uint32_t *wslots = structure_slots_of_type(
+                                            wt == 0 ? STRUCT_WALL : STRUCT_DOOR, &wn);
+                                        for (uint32_t wi = 0; wi < wn; wi++) {
+                                            PlacedStructure *ws = &placed_structures[wslots[wi]];
+                                            if (ws->island_id != ws_player->on_island_id) continue;
+                                            if (ws->type == STRUCT_DOOR && ws->open) continue;
+                                            /* OBB collision: rotate player into wall-local space */
+                                            float wrad = wall_get_rad(ws->x, ws->y);
+                                            float wc  = cosf(-wrad), wsn = sinf(-wrad);
+                                            float cpx = new_x - ws->x;
+                                            float cpy = new_y - ws->y;
+                                            float lx = cpx * wc  - cpy * wsn;
+                                            float ly = cpx * wsn + cpy * wc;
+                                            float clamp_x = lx < -25.0f ? -25.0f : (lx > 25.0f ? 25.0f : lx);
+                                            float clamp_y = ly < -5.0f  ? -5.0f  : (ly > 5.0f  ? 5.0f  : ly);
+                                            float dlx = lx - clamp_x, dly = ly - clamp_y;
+                                            float dist_sq = dlx*dlx + dly*dly;
+                                            if (dist_sq < PLAYER_R * PLAYER_R && dist_sq > 0.0001f) {
+                                                float dist = sqrtf(dist_sq);
+                                                float pen  = PLAYER_R - dist;
+                                                /* Push in local space, rotate back to world space */
+                                                float push_lx = (dlx / dist) * pen;
+                                                float push_ly = (dly / dist) * pen;
+                                                float wc_b = cosf(wrad), wsn_b = sinf(wrad);
+                                                new_x += push_lx * wc_b - push_ly * wsn_b;
+                                                new_y += push_lx * wsn_b + push_ly * wc_b;
+                                            }
                                         }
                                     }
                                 }
                                 /* Tree trunk collision — push player out of trunk radius
-                                 * Uses alive_wood list: skips depleted trees, O(alive) not O(total). */
+                                 * Resource grid: only standing trees near the player. */
                                 if (isl_mv) {
                                     const float PLAYER_R = 8.0f;
-                                    for (int ak = 0; ak < isl_mv->alive_wood_count; ak++) {
-                                        int ri = isl_mv->alive_wood[ak];
+                                    static IslandResourceNear near_trees;
+                                    island_resources_near(&near_trees, isl_mv, new_x, new_y,
+                                                          PLAYER_R + TREE_TRUNK_R_PX * isl_mv->grid_max_size,
+                                                          RES_MASK(RES_WOOD));
+                                    for (uint32_t k = 0; k < near_trees.count; k++) {
+                                        int ri = near_trees.ri[k];
                                         const IslandResource *tr = &isl_mv->resources[ri];
                                         float trunk_r    = TREE_TRUNK_R_PX * tr->size;
                                         float combined_r = PLAYER_R + trunk_r;
@@ -16732,9 +16741,13 @@ void websocket_server_tick(float dt) {
                                     static const float BSX[5] = { 1.00f, 0.88f, 1.18f, 0.72f, 1.35f };
                                     static const float BSY[5] = { 0.72f, 0.88f, 0.60f, 1.00f, 0.50f };
                                     static const float BSR[5] = { 0.00f, 0.40f, -0.20f, 1.20f, 0.15f };
-                                    for (int ri = 0; ri < isl_mv->resource_count; ri++) {
-                                        const IslandResource *res = &isl_mv->resources[ri];
-                                        if (res->type_id != RES_BOULDER && res->type_id != RES_STONE_BOULDER) continue;
+                                    static IslandResourceNear near_boulders;
+                                    /* Widest ellipse axis is 1.35 × base × size */
+                                    island_resources_near(&near_boulders, isl_mv, new_x, new_y,
+                                                          PLAYER_R + BOULDER_BASE_R * 1.35f * isl_mv->grid_max_size,
+                                                          RES_MASK(RES_BOULDER) | RES_MASK(RES_STONE_BOULDER));
+                                    for (uint32_t k = 0; k < near_boulders.count; k++) {
+                                        const IslandResource *res = &isl_mv->resources[near_boulders.ri[k]];
                                         if (res->health <= 0) continue;
                                         uint32_t bseed = ((uint32_t)((int)res->ox * 73856093)) ^
                                                          ((uint32_t)((int)res->oy * 19349663));
@@ -16982,34 +16995,15 @@ void websocket_server_tick(float dt) {
                     /* Island enter/leave detection (every tick, all non-ship players) */
                     float wx = ws_player->x, wy = ws_player->y;
                     if (ws_player->on_island_id == 0) {
-                        /* Entering: broad phase → narrow BEACH boundary (bump-circle or polygon) */
-                        for (int ii = 0; ii < ISLAND_COUNT; ii++) {
-                            const IslandDef *isl = &ISLAND_PRESETS[ii];
-                            float dx = wx - isl->x, dy = wy - isl->y;
-                            float dist_sq = dx*dx + dy*dy;
-                            bool entering;
-                            if (isl->vertex_count > 0) {
-                                entering = (dist_sq < isl->poly_bound_r * isl->poly_bound_r)
-                                        && island_poly_contains(isl, wx, wy);
-                            } else {
-                                float broad_r = isl->beach_radius_px + isl->beach_max_bump;
-                                if (dist_sq >= broad_r * broad_r) { entering = false; }
-                                else {
-                                    float angle   = atan2f(dy, dx);
-                                    float narrow_r = island_boundary_r(isl->beach_radius_px,
-                                                                       isl->beach_bumps, angle);
-                                    entering = (dist_sq < narrow_r * narrow_r);
-                                }
-                            }
-                            if (entering) {
-                                ws_player->on_island_id = (uint32_t)isl->id;
-                                ws_player->movement_state = PLAYER_STATE_WALKING;
-                                sim_player->velocity.x = 0;
-                                sim_player->velocity.y = 0;
-                                log_info("\U0001F3DD\uFE0F Player %u stepped onto island %d",
-                                         ws_player->player_id, isl->id);
-                                break;
-                            }
+                        /* Entering: BEACH boundary (bump-circle or polygon) of any island */
+                        const IslandDef *isl = island_land_at(wx, wy);
+                        if (isl) {
+                            ws_player->on_island_id = (uint32_t)isl->id;
+                            ws_player->movement_state = PLAYER_STATE_WALKING;
+                            sim_player->velocity.x = 0;
+                            sim_player->velocity.y = 0;
+                            log_info("\U0001F3DD\uFE0F Player %u stepped onto island %d",
+                                     ws_player->player_id, isl->id);
                         }
                     } else {
                         /* Leaving: fallback exit when outside BEACH boundary + 10px hysteresis.
@@ -17026,7 +17020,7 @@ void websocket_server_tick(float dt) {
                             /* Broad phase: skip narrow test if clearly still inside */
                             bool still_on;
                             if (isl->vertex_count > 0) {
-                                still_on = island_poly_contains(isl, wx, wy);
+                                still_on = island_layer_contains(isl, ISLAND_LAYER_LAND, wx, wy);
                             } else {
                                 still_on = true;
                                 float inner_r = isl->beach_radius_px - isl->beach_max_bump;
@@ -17049,8 +17043,8 @@ void websocket_server_tick(float dt) {
                     if (ws_player->on_dock_id == 0) {
                         /* Try to step onto a dock surface (through stair gaps) */
                         if (ws_player->on_island_id == 0) {
-                            const uint32_t *yslots = structure_index_shipyard_slots();
-                            uint32_t yc = structure_index_shipyard_count();
+                            uint32_t yc;
+                            const uint32_t *yslots = structure_slots_of_type(STRUCT_SHIPYARD, &yc);
                             for (uint32_t yi = 0; yi < yc; yi++) {
                                 PlacedStructure *_dk = &placed_structures[yslots[yi]];
                                 float _dlx, _dly;
@@ -17069,8 +17063,8 @@ void websocket_server_tick(float dt) {
                         }
                         /* OBB pushout: keep swimming players outside dock walls */
                         if (ws_player->on_dock_id == 0 && ws_player->on_island_id == 0) {
-                            const uint32_t *yslots = structure_index_shipyard_slots();
-                            uint32_t yc = structure_index_shipyard_count();
+                            uint32_t yc;
+                            const uint32_t *yslots = structure_slots_of_type(STRUCT_SHIPYARD, &yc);
                             for (uint32_t yi = 0; yi < yc; yi++) {
                                 PlacedStructure *_dk = &placed_structures[yslots[yi]];
                                 bool _hs = (_dk->construction_phase == CONSTRUCTION_BUILDING);
@@ -17189,6 +17183,9 @@ void websocket_server_tick(float dt) {
         }
     }
     
+    PROF_END();
+
+    PROF_BEGIN("wstick.sails_rudder");
     // ===== GRADUALLY ADJUST SHIP SAILS TO DESIRED OPENNESS =====
     // Rate: 10% per 0.2 seconds = 50% per second
     const float SAIL_ADJUST_RATE = 50.0f; // percent per second
@@ -17284,6 +17281,9 @@ void websocket_server_tick(float dt) {
         last_rudder_update = current_time;
     }
     
+    PROF_END();
+
+    PROF_BEGIN("wstick.reload_dot");
     // ===== UPDATE CANNON AND SWIVEL RELOAD TIMERS =====
     // Track time since last fire for each cannon/swivel
     static uint32_t last_cannon_update = 0;
@@ -17525,6 +17525,7 @@ void websocket_server_tick(float dt) {
                     {
                         struct Ship* _fss = find_sim_ship(fship->ship_id);
                         if (_fss) {
+                            _fss->module_epoch++;
                             for (uint8_t gm = 0; gm < _fss->module_count; gm++) {
                                 if (_fss->modules[gm].id == mod->id) {
                                     _fss->modules[gm].data.mast.fiber_health       = mod->data.mast.fiber_health;
@@ -17595,6 +17596,7 @@ void websocket_server_tick(float dt) {
                 {
                     struct Ship* _fss = find_sim_ship(fship->ship_id);
                     if (_fss) {
+                        _fss->module_epoch++;
                         for (uint8_t gm = 0; gm < _fss->module_count; gm++) {
                             if (_fss->modules[gm].id == mod->id) {
                                 _fss->modules[gm].health     = mod->health;
@@ -17623,6 +17625,7 @@ void websocket_server_tick(float dt) {
                                     memmove(&fship->modules[rm], &fship->modules[rm + 1],
                                             (fship->module_count - rm - 1) * sizeof(ShipModule));
                                     fship->module_count--;
+                                    ship_module_grid_invalidate(&fship->module_grid);
                                     mod = NULL; /* pointer now stale */
                                     break;
                                 }
@@ -17712,48 +17715,16 @@ void websocket_server_tick(float dt) {
         } /* end FIRE DOT TICK 500ms */
     }
 
-    /* ===== TOMBSTONE EXPIRY TICK (every 10 s) ================================
-       Walk active tombstones and despawn any that have exceeded TOMBSTONE_TTL_MS.  */
-    {
-        static uint32_t last_tombstone_tick = 0;
-        if (current_time - last_tombstone_tick >= 10000u) {
-            last_tombstone_tick = current_time;
-            for (int ti = 0; ti < (int)MAX_TOMBSTONES; ti++) {
-                if (!tombstones[ti].active) continue;
-                uint32_t age = current_time - tombstones[ti].spawn_time_ms;
-                if (age >= TOMBSTONE_TTL_MS) {
-                    tombstone_deactivate(&tombstones[ti]);
-                    char dm[128];
-                    snprintf(dm, sizeof(dm),
-                        "{\"type\":\"tombstone_despawned\",\"id\":%u}", tombstones[ti].id);
-                    websocket_server_broadcast(dm);
-                    log_info("⚰️  Tombstone %u expired (15-min TTL)", tombstones[ti].id);
-                }
-            }
-        }
-    }
-
-    /* ===== DROPPED ITEM EXPIRY TICK (every 30 s) =============================
-       Walk active dropped items and despawn any older than DROPPED_ITEM_TTL_MS. */
-    {
-        static uint32_t last_drop_tick = 0;
-        if (current_time - last_drop_tick >= 30000u) {
-            last_drop_tick = current_time;
-            for (int di = 0; di < (int)MAX_DROPPED_ITEMS; di++) {
-                if (!dropped_items[di].active) continue;
-                uint32_t age = current_time - dropped_items[di].spawn_time_ms;
-                if (age >= DROPPED_ITEM_TTL_MS) {
-                    dropped_item_deactivate(&dropped_items[di]);
-                    log_info("📦  Dropped item %u expired (5-min TTL)", dropped_items[di].id);
-                }
-            }
-        }
-    }
+    PROF_END();
 
+    PROF_BEGIN("wstick.grapple");
     /* ===== GRAPPLE HOOK PHYSICS TICK =========================================
        Advance flying hooks and apply pull forces each server tick. */
     update_grapple_hooks(dt, current_time);
 
+    PROF_END();
+
+    PROF_BEGIN("wstick.ship_forces");
     // ===== APPLY WIND-BASED SHIP MOVEMENT =====
     if (global_sim && global_sim->ship_count > 0) {
         for (uint32_t s = 0; s < global_sim->ship_count; s++) {
@@ -17884,8 +17855,13 @@ void websocket_server_tick(float dt) {
      * before sim_step integrates it into position. */
     handle_ship_dock_collisions();
 
+    PROF_END();
+
+    PROF_BEGIN("wstick.claim");
     /* Advance claiming-flag timers */
     claim_tick((uint32_t)(dt * 1000.0f));
 
+    PROF_END();
+
     // Tick processing complete
 }
\ No newline at end of file
@@ -0,0 +1,198 @@
+// pirate-replay — headless re-simulation of a recorded server session
+//
+// Loads a recording made with PIRATE_REPLAY_RECORD or POST /api/replay/start,
+// replays it as fast as possible, checks the sim hash at every checkpoint and
+// prints the tick profiler's view of the re-simulated ticks, with the slowest
+// live ticks broken down scope by scope.
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sim/types.h"
+#include "sim/replay.h"
+#include "util/log.h"
+#include "util/time.h"
+#include "util/profiler.h"
+
+#define MAX_TOP 32
+
+struct SlowTick {
+    uint32_t live_us;
+    struct ProfTick prof;
+};
+
+static struct {
+    int      top;
+    long     focus_tick;          /* --tick: -1 = none */
+    bool     dump_ws;
+    int      slow_count;
+    struct SlowTick slow[MAX_TOP];
+    uint32_t live_over_budget;
+} g_opt = { .top = 5, .focus_tick = -1 };
+
+static void usage(const char* argv0) {
+    fprintf(stderr,
+        "usage: %s [options] <replay.bin>\n"
+        "  --top N        break down the N slowest live ticks (default 5, max %d)\n"
+        "  --tick T       also break down tick T and list its WebSocket messages\n"
+        "  --ws           print every recorded WebSocket message\n"
+        "  --json FILE    write profiler stats + last ticks (GET /api/profile format)\n"
+        "  --trace FILE   write the last %d ticks as a chrome://tracing file\n"
+        "exit status: 0 = hashes match, 1 = divergence, 2 = unreadable recording\n",
+        argv0, MAX_TOP, PROF_FLIGHT_TICKS);
+}
+
+static void print_breakdown(const char* label, const struct ProfTick* t, uint32_t live_us) {
+    printf("  %s tick %u: live %u us, replay %u us\n", label, t->tick, live_us, t->dur_us);
+    for (int i = 0; i < t->event_count; i++) {
+        const struct ProfEvent* e = &t->events[i];
+        if (e->depth == 0) continue;
+        printf("    %*s%-*s %6u us  @%u\n", (e->depth - 1) * 2, "",
+               34 - (e->depth - 1) * 2, prof_scope_name(e->scope), e->dur_us, e->start_us);
+    }
+    if (t->dropped) printf("    (%u scopes dropped)\n", t->dropped);
+}
+
+static void on_tick(void* user, uint32_t tick, uint32_t live_us, uint32_t replay_us) {
+    (void)user; (void)replay_us;   /* == the profiler's tick duration */
+    if (live_us > TICK_DURATION_MS * 1000) g_opt.live_over_budget++;
+
+    bool focus = g_opt.focus_tick >= 0 && (uint32_t)g_opt.focus_tick == tick;
+    /* Keep the slowest live ticks, sorted descending */
+    int pos = g_opt.slow_count;
+    while (pos > 0 && g_opt.slow[pos - 1].live_us < live_us) pos--;
+    if (pos >= g_opt.top && !focus) return;
+
+    static struct ProfTick last;
+    if (!prof_last_tick(&last)) return;
+    if (focus) print_breakdown("focus", &last, live_us);
+    if (pos >= g_opt.top) return;
+
+    int n = g_opt.slow_count < g_opt.top ? g_opt.slow_count + 1 : g_opt.top;
+    memmove(&g_opt.slow[pos + 1], &g_opt.slow[pos], (size_t)(n - 1 - pos) * sizeof(g_opt.slow[0]));
+    g_opt.slow[pos].live_us = live_us;
+    g_opt.slow[pos].prof = last;
+    g_opt.slow_count = n;
+}
+
+static void on_ws(void* user, uint32_t tick, uint32_t player_id, const char* msg, size_t len) {
+    (void)user;
+    bool focus = g_opt.focus_tick >= 0 && (uint32_t)g_opt.focus_tick == tick;
+    if (g_opt.dump_ws || focus) printf("  ws tick %u player %u: %.*s\n", tick, player_id, (int)len, msg);
+}
+
+static void on_mismatch(void* user, uint32_t tick, uint64_t expected, uint64_t actual) {
+    (void)user;
+    printf("  ❌ hash mismatch at tick %u: recorded %016llx, replayed %016llx\n", tick,
+           (unsigned long long)expected, (unsigned long long)actual);
+}
+
+static int write_file(const char* path, int (*writer)(FILE*, int), int arg) {
+    FILE* f = fopen(path, "w");
+    if (!f) {
+        perror(path);
+        return -1;
+    }
+    int rc = writer(f, arg);
+    fclose(f);
+    return rc;
+}
+
+static int write_trace(FILE* out, int unused) {
+    (void)unused;
+    return prof_write_chrome_trace(out);
+}
+
+int main(int argc, char* argv[]) {
+    const char* path = NULL;
+    const char* json_path = NULL;
+    const char* trace_path = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        const char* a = argv[i];
+        bool has_value = i + 1 < argc;
+        if (strcmp(a, "--top") == 0 && has_value) {
+            g_opt.top = atoi(argv[++i]);
+            if (g_opt.top < 0) g_opt.top = 0;
+            if (g_opt.top > MAX_TOP) g_opt.top = MAX_TOP;
+        } else if (strcmp(a, "--tick") == 0 && has_value) {
+            g_opt.focus_tick = atol(argv[++i]);
+        } else if (strcmp(a, "--ws") == 0) {
+            g_opt.dump_ws = true;
+        } else if (strcmp(a, "--json") == 0 && has_value) {
+            json_path = argv[++i];
+        } else if (strcmp(a, "--trace") == 0 && has_value) {
+            trace_path = argv[++i];
+        } else if (a[0] == '-' || path) {
+            usage(argv[0]);
+            return 2;
+        } else {
+            path = a;
+        }
+    }
+    if (!path) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    log_set_output(stderr);
+    time_init();
+    prof_init();
+
+    struct Sim* sim = calloc(1, sizeof(struct Sim));
+    if (!sim) {
+        fprintf(stderr, "out of memory\n");
+        return 2;
+    }
+
+    printf("🎬 Replaying %s\n", path);
+    struct ReplayCallbacks cb = { on_tick, on_ws, on_mismatch, NULL };
+    struct ReplayStats st;
+    int rc = replay_play(path, sim, &cb, &st);
+    if (rc != 0 && st.ticks == 0) {
+        free(sim);
+        return 2;
+    }
+
+    double live_s = st.ticks * (TICK_DURATION_MS / 1000.0);
+    printf("\nTicks %u..%u (%u ticks, %.1f s of play)%s\n", st.first_tick, st.last_tick,
+           st.ticks, live_s, st.truncated ? " — recording truncated" : "");
+    printf("Inputs %u, WebSocket messages %u, live ticks over budget %u\n",
+           st.inputs, st.ws_messages, g_opt.live_over_budget);
+    printf("Re-simulated in %.1f ms (%.0fx real time)\n", st.replay_us / 1000.0,
+           st.replay_us ? live_s * 1e6 / st.replay_us : 0.0);
+    if (st.mismatches) {
+        printf("Checkpoints: %u, ❌ %u mismatched (first at tick %u)\n",
+               st.checkpoints, st.mismatches, st.first_mismatch_tick);
+    } else {
+        printf("Checkpoints: %u, ✅ all hashes match\n", st.checkpoints);
+    }
+
+    struct ProfScopeStats stats[PROF_MAX_SCOPES];
+    int n = prof_scope_stats(stats, PROF_MAX_SCOPES);
+    printf("\n%-34s %8s %8s %8s %8s %8s %8s\n", "scope (replay, us)", "count", "mean", "p50", "p99", "p99.9", "max");
+    for (int i = 0; i < n; i++) {
+        if (!stats[i].count) continue;
+        printf("%-34s %8llu %8u %8u %8u %8u %8u\n", stats[i].name, (unsigned long long)stats[i].count,
+               stats[i].mean_us, stats[i].p50_us, stats[i].p99_us, stats[i].p999_us, stats[i].max_us);
+    }
+
+    if (g_opt.slow_count) {
+        printf("\nSlowest live ticks (live = whole server tick, replay = sim only):\n");
+        for (int i = 0; i < g_opt.slow_count; i++) {
+            print_breakdown("slow", &g_opt.slow[i].prof, g_opt.slow[i].live_us);
+        }
+    }
+
+    if (json_path && write_file(json_path, prof_write_json, PROF_FLIGHT_TICKS) == 0) {
+        printf("\nProfile written to %s\n", json_path);
+    }
+    if (trace_path && write_file(trace_path, write_trace, 0) == 0) {
+        printf("Trace written to %s\n", trace_path);
+    }
+
+    free(sim);
+    log_shutdown();
+    if (rc != 0) return 2;
+    return st.mismatches ? 1 : 0;
+}
@@ -7,15 +7,62 @@
 #include "input_validation.h"
 #include "util/time.h"
 #include "util/log.h"
+#include "util/profiler.h"
+#include "util/metrics.h"
 #include "core/rng.h"
 #include "sim/world_save.h"
+#include "sim/replay.h"
 #include "net/claim.h"
 #include "net/structures.h"
+#include "net/harvesting.h"
 #include "net/ship_init.h"
 
 volatile int g_server_shutdown_requested = 0;
 volatile int g_server_restart_requested  = 0;
 
+extern int tier_player_counts[INPUT_TIER_COUNT];
+
+/* Tick-loop metrics exported on GET /metrics (admin port) */
+static struct {
+    metric_id tick_duration;
+    metric_id tick_overruns;
+    metric_id ships;
+    metric_id players;
+    metric_id projectiles;
+    metric_id ws_clients;
+    metric_id tier_players[INPUT_TIER_COUNT];
+} g_server_metrics;
+
+static void register_server_metrics(void) {
+    if (g_server_metrics.tick_duration) return;   /* Already registered */
+    static const uint64_t tick_bounds_us[] = {
+        1000, 2500, 5000, 10000, 20000, TICK_DURATION_US, 50000, 100000, 250000, 1000000
+    };
+    g_server_metrics.tick_duration = metrics_histogram("pirate_tick_duration_seconds",
+        "Wall time of one server tick.", NULL,
+        tick_bounds_us, (int)(sizeof(tick_bounds_us) / sizeof(tick_bounds_us[0])), 1e-6);
+    g_server_metrics.tick_overruns = metrics_counter("pirate_tick_overruns",
+        "Ticks that exceeded the tick budget.", NULL);
+    g_server_metrics.ships = metrics_gauge("pirate_entities",
+        "Live simulation entities by kind.", "kind=\"ship\"");
+    g_server_metrics.players = metrics_gauge("pirate_entities",
+        "Live simulation entities by kind.", "kind=\"player\"");
+    g_server_metrics.projectiles = metrics_gauge("pirate_entities",
+        "Live simulation entities by kind.", "kind=\"projectile\"");
+    g_server_metrics.ws_clients = metrics_gauge("pirate_ws_clients",
+        "WebSocket clients with a completed handshake.", NULL);
+    static const char* const tier_labels[INPUT_TIER_COUNT] = {
+        "tier=\"idle\"", "tier=\"background\"", "tier=\"normal\"", "tier=\"critical\""
+    };
+    for (int t = 0; t < INPUT_TIER_COUNT; t++) {
+        g_server_metrics.tier_players[t] = metrics_gauge("pirate_input_tier_players",
+            "Players per input tier.", tier_labels[t]);
+    }
+    metrics_register_collector(prof_write_openmetrics);
+}
+
+static void update_server_metrics(struct ServerContext* ctx, uint64_t tick_duration);
+
 /* Auto-save every 15 minutes: 15 * 60 * TICK_RATE_HZ ticks */
 #define AUTOSAVE_INTERVAL_TICKS  (15 * 60 * TICK_RATE_HZ)
 /* Hourly archive snapshot: 60 * 60 * TICK_RATE_HZ ticks */
@@ -94,7 +141,11 @@ int server_init(struct ServerContext** out_ctx) {
         return -1;
     }
     
+    // Start the async log backend first so subsystem init logging goes through it
+    log_init(LOG_LEVEL_INFO);
     log_info("Initializing server subsystems...");
+    prof_init();
+    register_server_metrics();
     
     // Initialize timing utilities
     time_init();
@@ -152,12 +203,23 @@ int server_init(struct ServerContext** out_ctx) {
              * Clears SHIP_FLAG_SCAFFOLDED from orphaned ships so they take
              * normal water/hull damage instead of being indefinitely immune. */
             shipyard_scaffolding_sanity_sweep();
+            /* Re-arm the timers of whatever was mid-build, mid-repair or
+             * depleted when the world was saved. */
+            structure_repairs_wake_all();
+            claim_forts_wake_all();
+            harvest_respawns_wake_all();
         } else {
             log_info("💾 No save file found at '%s' — starting fresh world",
                      WORLD_SAVE_DEFAULT_PATH);
         }
     }
 
+    /* ── Replay recording from the first tick (PIRATE_REPLAY_RECORD=<path|1>) ── */
+    {
+        const char* rec = getenv("PIRATE_REPLAY_RECORD");
+        if (rec && rec[0]) replay_request_start(strcmp(rec, "1") == 0 ? NULL : rec);
+    }
+
     // Mark as initialized
     ctx->initialized = true;
     ctx->should_run = true;
@@ -188,6 +250,9 @@ void server_shutdown(struct ServerContext* ctx) {
     // Cleanup admin server
     admin_server_cleanup(&ctx->admin_server);
     
+    // Close any replay recording before the sim goes away
+    replay_recorder_shutdown();
+
     // Cleanup WebSocket server
     websocket_server_cleanup();
     
@@ -195,6 +260,9 @@ void server_shutdown(struct ServerContext* ctx) {
     free(ctx);
     
     log_info("Server shutdown complete");
+
+    // Drain queued log records; anything logged after this is synchronous
+    log_shutdown();
 }
 
 void server_request_shutdown(struct ServerContext* ctx) {
@@ -220,43 +288,56 @@ int server_run(struct ServerContext* ctx) {
     while (ctx->should_run) {
         uint64_t tick_start = get_time_us();
 
+        // Refresh the log timestamp cache once per tick instead of per line
+        log_tick();
+        prof_tick_begin(ctx->current_tick);
+        replay_tick_begin(&ctx->simulation, ctx->current_tick);
+
         /* ── Poll global command flags (set by chat command handler) ── */
         if (g_server_shutdown_requested || g_server_restart_requested) {
             ctx->should_run = false;
         }
         
         // Process incoming network packets
+        PROF_BEGIN("udp");
         process_network_input(ctx);
+        PROF_END();
 
         // Receive WebSocket messages and process player input for this tick.
         // NOTE: broadcast is intentionally NOT done here — it runs after physics
         // so clients always receive the freshest integrated positions.
-        uint64_t _t_net0 = get_time_us();
+        PROF_BEGIN("net");
         websocket_server_update(&ctx->simulation);
+        PROF_END();
 
         // HYBRID: Apply player movement states (rudder, wind, dock) to sim ships.
         // Must run AFTER websocket_server_update (inputs received) and
         // BEFORE step_simulation (so they are integrated this tick).
-        uint64_t _t_wstick0 = get_time_us();
+        PROF_BEGIN("wstick");
         websocket_server_tick(TICK_DURATION_MS / 1000.0f);
+        PROF_END();
 
-        // Update admin server (process admin panel requests)
-        uint64_t _t_admin0 = get_time_us();
+        // Service the admin thread: capture a world snapshot if one was asked
+        // for and run any pending mutating (POST) request.
+        PROF_BEGIN("admin");
         admin_server_update(&ctx->admin_server, &ctx->simulation, NULL);
+        PROF_END();
 
         // Run physics simulation step — integrates velocity/position for all ships.
-        uint64_t _t_sim0 = get_time_us();
+        PROF_BEGIN("sim");
         step_simulation(ctx);
+        PROF_END();
 
         // Broadcast fresh GAME_STATE to all clients NOW that physics is complete.
         // This replaces the pre-physics send that was inside websocket_server_update.
-        uint64_t _t_send0 = get_time_us();
+        PROF_BEGIN("send");
         websocket_server_send_game_state();
-        uint64_t _t_send1 = get_time_us();
+        PROF_END();
 
         // Send UDP snapshots (placeholder — binary snapshot path)
         send_snapshots(ctx);
 
+        PROF_BEGIN("autosave");
         /* ── Auto-save every 15 minutes ── */
         if (ctx->current_tick - last_autosave_tick >= AUTOSAVE_INTERVAL_TICKS) {
             world_save(WORLD_SAVE_DEFAULT_PATH);
@@ -269,24 +350,30 @@ int server_run(struct ServerContext* ctx) {
             last_archive_tick = ctx->current_tick;
         }
 
+        PROF_END();
+
         // Update tick counter
         ctx->current_tick++;
+        prof_tick_end();
 
         uint64_t tick_end      = get_time_us();
         uint64_t tick_duration = tick_end - tick_start;
 
-        // Log performance warning if tick took too long, with a per-section breakdown so we
-        // can see whether the overrun is in input, sim physics/collision, or send.
+        // Log performance warning if tick took too long, with the profiler's top-level
+        // breakdown so we can see whether the overrun is in input, sim or send.
+        // Nested scopes and percentiles: GET /api/profile or kill -USR2 <pid>.
+        update_server_metrics(ctx, tick_duration);
+        replay_tick_end((uint32_t)tick_duration);
         if (tick_duration > TICK_DURATION_US) {
-            log_warn("Tick %u took %lu us (budget: %u us) | net=%lu wstick=%lu admin=%lu sim=%lu send=%lu us",
-                     ctx->current_tick, tick_duration, TICK_DURATION_US,
-                     (unsigned long)(_t_wstick0 - _t_net0),
-                     (unsigned long)(_t_admin0  - _t_wstick0),
-                     (unsigned long)(_t_sim0    - _t_admin0),
-                     (unsigned long)(_t_send0   - _t_sim0),
-                     (unsigned long)(_t_send1   - _t_send0));
+            char breakdown[192];
+            prof_format_last_tick(breakdown, sizeof(breakdown));
+            log_warn("Tick %u took %lu us (budget: %u us) | %s us",
+                     ctx->current_tick, tick_duration, TICK_DURATION_US, breakdown);
         }
 
+        // SIGUSR2 profile dump — written between ticks, outside the measured work
+        prof_service_dump_request();
+
         // Advance the next-tick target.
         // If we finished on time: advance by exactly one tick interval so the
         // nanosleep below drifts back in sync.
@@ -495,6 +582,26 @@ static void init_simulation(struct ServerContext* ctx) {
     log_info("Created brigantine ship 2 (ID: %u) at (%.0f, %.0f) client px", ship2_id, MAP_CENTER_X, MAP_CENTER_Y + 600.0f);
 }
 
+static void update_server_metrics(struct ServerContext* ctx, uint64_t tick_duration) {
+    metrics_observe(g_server_metrics.tick_duration, tick_duration);
+    if (tick_duration > TICK_DURATION_US) metrics_inc(g_server_metrics.tick_overruns, 1);
+
+    metrics_gauge_set(g_server_metrics.ships, ctx->simulation.ship_count);
+    metrics_gauge_set(g_server_metrics.players, ctx->simulation.player_count);
+    metrics_gauge_set(g_server_metrics.projectiles, ctx->simulation.projectile_count);
+
+    /* Client/tier counts change slowly; refresh them once a second */
+    if (ctx->current_tick % TICK_RATE_HZ == 0) {
+        struct WebSocketStats ws;
+        if (websocket_server_get_stats(&ws) == 0) {
+            metrics_gauge_set(g_server_metrics.ws_clients, ws.connected_clients);
+        }
+        for (int t = 0; t < INPUT_TIER_COUNT; t++) {
+            metrics_gauge_set(g_server_metrics.tier_players[t], tier_player_counts[t]);
+        }
+    }
+}
+
 static void step_simulation(struct ServerContext* ctx) {
     struct Sim* sim = &ctx->simulation;
     
@@ -504,17 +611,10 @@ static void step_simulation(struct ServerContext* ctx) {
     
     // Run the full simulation step (physics, collisions, etc.)
     q16_t dt = Q16_FROM_FLOAT(TICK_DURATION_MS / 1000.0f); // Convert ms to seconds
+    // Everything the WS/admin layers wrote into the sim this tick is in the
+    // replay delta; the step itself is re-simulated.
+    replay_record_pre_step(sim);
     sim_step(sim, dt);
-
-    // ── World wrap: keep ships inside the toroidal 100 000×100 000 px map ──
-    // Operates in server units (MAP_WIDTH_SRV = 10 000).
-    for (uint32_t s = 0; s < sim->ship_count; s++) {
-        struct Ship* ship = &sim->ships[s];
-        float px = Q16_TO_FLOAT(ship->position.x);
-        float py = Q16_TO_FLOAT(ship->position.y);
-        px = WORLD_WRAP(px, MAP_WIDTH_SRV);
-        py = WORLD_WRAP(py, MAP_HEIGHT_SRV);
-        ship->position.x = Q16_FROM_FLOAT(px);
-        ship->position.y = Q16_FROM_FLOAT(py);
-    }
+    sim_wrap_world(sim);
+    replay_record_post_step(sim);
 }
\ No newline at end of file
@@ -0,0 +1,290 @@
+#include "sim/hull_sdf.h"
+#include "util/log.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_HULL_VERTS 64
+
+typedef struct {
+    uint8_t   n;
+    Vec2Q16   src[MAX_HULL_VERTS];       /* Interned vertices (server Q16)      */
+    float     vx[MAX_HULL_VERTS];        /* Same, client px                     */
+    float     vy[MAX_HULL_VERTS];
+    float     bx0, by0, bx1, by1;        /* Hull bounding box                   */
+    float     ox, oy;                    /* Grid node [0][0]                    */
+    int       w, h;                      /* Cells; nodes are (w+1) × (h+1)      */
+    float    *node;                      /* Signed distance per node            */
+    uint32_t *cand_off;                  /* Per cell: first candidate in cand[] */
+    uint8_t  *cand_n;                    /* Per cell: candidate count           */
+    uint8_t  *cand;                      /* Destination vertex indices          */
+    uint32_t  cand_count;
+} HullShape;
+
+static HullShape g_shapes[HULL_SDF_MAX_SHAPES];
+static int       g_shape_count;
+static uint8_t   g_all_edges[MAX_HULL_VERTS];   /* 0..63: "every edge" */
+
+static const uint8_t* all_edges(void) {
+    if (g_all_edges[1] == 0)
+        for (int i = 0; i < MAX_HULL_VERTS; i++) g_all_edges[i] = (uint8_t)i;
+    return g_all_edges;
+}
+
+/* ── Exact tests ──────────────────────────────────────────────────────────── */
+
+static int load_verts(const struct Ship* ship, float* vx, float* vy) {
+    int n = ship->hull_vertex_count < MAX_HULL_VERTS ? ship->hull_vertex_count : MAX_HULL_VERTS;
+    for (int i = 0; i < n; i++) {
+        vx[i] = SERVER_TO_CLIENT(Q16_TO_FLOAT(ship->hull_vertices[i].x));
+        vy[i] = SERVER_TO_CLIENT(Q16_TO_FLOAT(ship->hull_vertices[i].y));
+    }
+    return n;
+}
+
+/* Squared distance to edge d (vertex d-1 → d) */
+static float edge_dist_sq(const float* vx, const float* vy, int n, int d, float lx, float ly) {
+    int i = d ? d - 1 : n - 1;
+    float ax = vx[i], ay = vy[i];
+    float edx = vx[d] - ax, edy = vy[d] - ay;
+    float len_sq = edx * edx + edy * edy;
+    float t = 0.0f;
+    if (len_sq > 1e-10f) {
+        t = ((lx - ax) * edx + (ly - ay) * edy) / len_sq;
+        if (t < 0.0f) t = 0.0f;
+        if (t > 1.0f) t = 1.0f;
+    }
+    float cx = ax + t * edx, cy = ay + t * edy;
+    float ex = lx - cx, ey = ly - cy;
+    return ex * ex + ey * ey;
+}
+
+static bool ray_cast(const float* vx, const float* vy, int n, float lx, float ly) {
+    bool inside = false;
+    for (int i = 0, j = n - 1; i < n; j = i++) {
+        float xi = vx[i], yi = vy[i];
+        float xj = vx[j], yj = vy[j];
+        if (((yi > ly) != (yj > ly)) &&
+            (lx < (xj - xi) * (ly - yi) / (yj - yi + 1e-12f) + xi))
+            inside = !inside;
+    }
+    return inside;
+}
+
+/* ── Bake ─────────────────────────────────────────────────────────────────── */
+
+static void shape_free(HullShape* s) {
+    free(s->node);
+    free(s->cand_off);
+    free(s->cand_n);
+    free(s->cand);
+    s->node = NULL;
+    s->cand_off = NULL;
+    s->cand_n = NULL;
+    s->cand = NULL;
+}
+
+static bool shape_bake(HullShape* s) {
+    int n = s->n;
+    s->bx0 = s->bx1 = s->vx[0];
+    s->by0 = s->by1 = s->vy[0];
+    for (int i = 1; i < n; i++) {
+        s->bx0 = fminf(s->bx0, s->vx[i]);
+        s->bx1 = fmaxf(s->bx1, s->vx[i]);
+        s->by0 = fminf(s->by0, s->vy[i]);
+        s->by1 = fmaxf(s->by1, s->vy[i]);
+    }
+    s->ox = s->bx0 - HULL_SDF_MARGIN_PX;
+    s->oy = s->by0 - HULL_SDF_MARGIN_PX;
+    s->w  = (int)ceilf((s->bx1 + HULL_SDF_MARGIN_PX - s->ox) / HULL_SDF_CELL_PX);
+    s->h  = (int)ceilf((s->by1 + HULL_SDF_MARGIN_PX - s->oy) / HULL_SDF_CELL_PX);
+
+    size_t nodes = (size_t)(s->w + 1) * (size_t)(s->h + 1);
+    size_t cells = (size_t)s->w * (size_t)s->h;
+    s->node     = malloc(nodes * sizeof(float));
+    s->cand_off = malloc(cells * sizeof(uint32_t));
+    s->cand_n   = malloc(cells);
+    if (!s->node || !s->cand_off || !s->cand_n) return false;
+
+    for (int r = 0; r <= s->h; r++)
+        for (int c = 0; c <= s->w; c++) {
+            float x = s->ox + (float)c * HULL_SDF_CELL_PX;
+            float y = s->oy + (float)r * HULL_SDF_CELL_PX;
+            float best = 1e20f;
+            for (int d = 0; d < n; d++) {
+                float d2 = edge_dist_sq(s->vx, s->vy, n, d, x, y);
+                if (d2 < best) best = d2;
+            }
+            float dist = sqrtf(best);
+            s->node[r * (s->w + 1) + c] = ray_cast(s->vx, s->vy, n, x, y) ? -dist : dist;
+        }
+
+    /* The edge nearest any point p in a cell is within d_centre + H of p, so
+     * within d_centre + 2H of the centre; half a pixel absorbs rounding */
+    const float H = HULL_SDF_CELL_PX * 0.70711f;
+    uint32_t cap = 0;
+    float dc[MAX_HULL_VERTS];
+    for (int r = 0; r < s->h; r++)
+        for (int c = 0; c < s->w; c++) {
+            float x = s->ox + ((float)c + 0.5f) * HULL_SDF_CELL_PX;
+            float y = s->oy + ((float)r + 0.5f) * HULL_SDF_CELL_PX;
+            float best = 1e20f;
+            for (int d = 0; d < n; d++) {
+                dc[d] = sqrtf(edge_dist_sq(s->vx, s->vy, n, d, x, y));
+                if (dc[d] < best) best = dc[d];
+            }
+            size_t cell = (size_t)r * (size_t)s->w + (size_t)c;
+            s->cand_off[cell] = s->cand_count;
+            s->cand_n[cell]   = 0;
+            for (int d = 0; d < n; d++) {
+                if (dc[d] > best + 2.0f * H + 0.5f) continue;
+                if (s->cand_count == cap) {
+                    cap = cap ? cap * 2 : 4096;
+                    uint8_t* grown = realloc(s->cand, cap);
+                    if (!grown) return false;
+                    s->cand = grown;
+                }
+                s->cand[s->cand_count++] = (uint8_t)d;
+                s->cand_n[cell]++;
+            }
+        }
+    return true;
+}
+
+void hull_sdf_bake(struct Ship* ship) {
+    ship->hull_sdf = 0;
+    int n = ship->hull_vertex_count;
+    if (n < 3 || n > MAX_HULL_VERTS) return;
+
+    for (int k = 0; k < g_shape_count; k++) {
+        HullShape* s = &g_shapes[k];
+        if (s->n == n && memcmp(s->src, ship->hull_vertices, (size_t)n * sizeof(Vec2Q16)) == 0) {
+            ship->hull_sdf = (uint8_t)(k + 1);
+            return;
+        }
+    }
+    if (g_shape_count >= HULL_SDF_MAX_SHAPES) {
+        static bool warned;
+        if (!warned) {
+            warned = true;
+            log_warn("⛵ Hull SDF: more than %d hull shapes — extra ships use exact scans",
+                     HULL_SDF_MAX_SHAPES);
+        }
+        return;
+    }
+
+    HullShape* s = &g_shapes[g_shape_count];
+    memset(s, 0, sizeof(*s));
+    s->n = (uint8_t)n;
+    memcpy(s->src, ship->hull_vertices, (size_t)n * sizeof(Vec2Q16));
+    load_verts(ship, s->vx, s->vy);
+    if (!shape_bake(s)) {
+        shape_free(s);
+        log_error("❌ Hull SDF: out of memory baking a %d-vertex hull", n);
+        return;
+    }
+    g_shape_count++;
+    ship->hull_sdf = (uint8_t)g_shape_count;
+    log_info("⛵ Hull SDF: baked shape %d (%d vertices, %d×%d cells, %u candidate edges)",
+             g_shape_count, n, s->w, s->h, s->cand_count);
+}
+
+/* ── Queries ──────────────────────────────────────────────────────────────── */
+
+static const HullShape* shape_of(const struct Ship* ship) {
+    int k = ship->hull_sdf;
+    if (k == 0 || k > g_shape_count) return NULL;
+    const HullShape* s = &g_shapes[k - 1];
+    return s->n == ship->hull_vertex_count ? s : NULL;
+}
+
+/* Cell index of (lx, ly), or -1 off the grid */
+static long cell_of(const HullShape* s, float lx, float ly, float* fx, float* fy) {
+    *fx = (lx - s->ox) / HULL_SDF_CELL_PX;
+    *fy = (ly - s->oy) / HULL_SDF_CELL_PX;
+    if (!(*fx >= 0.0f && *fx < (float)s->w && *fy >= 0.0f && *fy < (float)s->h)) return -1;
+    return (long)(int)*fy * s->w + (int)*fx;
+}
+
+float hull_sdf_sample(const struct Ship* ship, float lx, float ly) {
+    const HullShape* s = shape_of(ship);
+    if (!s) {
+        float vx[MAX_HULL_VERTS], vy[MAX_HULL_VERTS];
+        int n = load_verts(ship, vx, vy);
+        if (n < 3) return 1e20f;
+        float d = hull_sdf_edge_dist(ship, lx, ly);
+        return ray_cast(vx, vy, n, lx, ly) ? -d : d;
+    }
+    float fx, fy;
+    long cell = cell_of(s, lx, ly, &fx, &fy);
+    if (cell < 0) {
+        /* Off the grid: distance to the bounding box bounds it from below */
+        float ox = lx < s->bx0 ? s->bx0 - lx : (lx > s->bx1 ? lx - s->bx1 : 0.0f);
+        float oy = ly < s->by0 ? s->by0 - ly : (ly > s->by1 ? ly - s->by1 : 0.0f);
+        return sqrtf(ox * ox + oy * oy);
+    }
+    int c = (int)fx, r = (int)fy;
+    float tx = fx - (float)c, ty = fy - (float)r;
+    const float* n0 = &s->node[r * (s->w + 1) + c];
+    const float* n1 = n0 + (s->w + 1);
+    float top = n0[0] + (n0[1] - n0[0]) * tx;
+    float bot = n1[0] + (n1[1] - n1[0]) * tx;
+    return top + (bot - top) * ty;
+}
+
+bool hull_sdf_contains(const struct Ship* ship, float lx, float ly) {
+    const HullShape* s = shape_of(ship);
+    if (s) {
+        float sd = hull_sdf_sample(ship, lx, ly);
+        if (sd < -HULL_SDF_ERR_PX) return true;
+        if (sd >  HULL_SDF_ERR_PX) return false;
+        return ray_cast(s->vx, s->vy, s->n, lx, ly);
+    }
+    float vx[MAX_HULL_VERTS], vy[MAX_HULL_VERTS];
+    int n = load_verts(ship, vx, vy);
+    return n >= 3 && ray_cast(vx, vy, n, lx, ly);
+}
+
+float hull_sdf_edge_dist(const struct Ship* ship, float lx, float ly) {
+    const HullShape* s = shape_of(ship);
+    float min_dist_sq = 1e20f;
+    if (s) {
+        int cn;
+        const uint8_t* cand = hull_sdf_candidates(ship, lx, ly, &cn);
+        for (int k = 0; k < cn; k++) {
+            float d = edge_dist_sq(s->vx, s->vy, s->n, cand[k], lx, ly);
+            if (d < min_dist_sq) min_dist_sq = d;
+        }
+        return sqrtf(min_dist_sq);
+    }
+    float vx[MAX_HULL_VERTS], vy[MAX_HULL_VERTS];
+    int n = load_verts(ship, vx, vy);
+    for (int d = 0; d < n; d++) {
+        float d2 = edge_dist_sq(vx, vy, n, d, lx, ly);
+        if (d2 < min_dist_sq) min_dist_sq = d2;
+    }
+    return sqrtf(min_dist_sq);
+}
+
+bool hull_sdf_within(const struct Ship* ship, float lx, float ly, float r) {
+    if (shape_of(ship)) {
+        float sd = hull_sdf_sample(ship, lx, ly);
+        if (sd > r + HULL_SDF_ERR_PX) return false;
+        if (sd < -HULL_SDF_ERR_PX) return true;
+    }
+    return hull_sdf_contains(ship, lx, ly) || hull_sdf_edge_dist(ship, lx, ly) <= r;
+}
+
+const uint8_t* hull_sdf_candidates(const struct Ship* ship, float lx, float ly, int* out_n) {
+    const HullShape* s = shape_of(ship);
+    if (s) {
+        float fx, fy;
+        long cell = cell_of(s, lx, ly, &fx, &fy);
+        if (cell >= 0) {
+            *out_n = s->cand_n[cell];
+            return &s->cand[s->cand_off[cell]];
+        }
+    }
+    *out_n = ship->hull_vertex_count < MAX_HULL_VERTS ? ship->hull_vertex_count : MAX_HULL_VERTS;
+    return all_edges();
+}
@@ -13,8 +13,8 @@
 
 #define _GNU_SOURCE
 #include "sim/island.h"
-#include "net/websocket_server.h"  /* PlacedStructure — needed for island_resource_can_respawn */
 #include "util/log.h"
+#include <stdlib.h>
 #include <string.h>
 #include <math.h>
 #include <stdbool.h>
@@ -250,45 +250,21 @@ IslandDef ISLAND_PRESETS[ISLAND_COUNT] = {
 
 /**
  * Returns non-zero if world point (px, py) lies inside the scaled grass
- * polygon of the island (ray-cast even–odd rule).
+ * polygon of the island (raster lookup, ray-cast on boundary cells).
  */
 static int inside_grass_poly(const IslandDef *isl, float px, float py)
 {
-    if (isl->grass_vertex_count == 0) return 0;
-
-    int inside = 0;
-    int n = isl->grass_vertex_count;
-    for (int i = 0, j = n - 1; i < n; j = i++) {
-        float xi = isl->x + isl->gvx[i];
-        float yi = isl->y + isl->gvy[i];
-        float xj = isl->x + isl->gvx[j];
-        float yj = isl->y + isl->gvy[j];
-        if ((yi > py) != (yj > py) &&
-            px < (xj - xi) * (py - yi) / (yj - yi) + xi)
-            inside = !inside;
-    }
-    return inside;
+    return island_layer_contains(isl, ISLAND_LAYER_GRASS, px, py);
 }
 
 /**
  * Returns non-zero if world point (px, py) lies inside the sand (outer)
- * polygon of the island (ray-cast even–odd rule, uses vx/vy).
+ * polygon of the island (raster lookup, ray-cast on boundary cells).
  */
 static int inside_sand_poly(const IslandDef *isl, float px, float py)
 {
     if (isl->vertex_count == 0) return 0;
-    int inside = 0;
-    int n = isl->vertex_count;
-    for (int i = 0, j = n - 1; i < n; j = i++) {
-        float xi = isl->x + isl->vx[i];
-        float yi = isl->y + isl->vy[i];
-        float xj = isl->x + isl->vx[j];
-        float yj = isl->y + isl->vy[j];
-        if ((yi > py) != (yj > py) &&
-            px < (xj - xi) * (py - yi) / (yj - yi) + xi)
-            inside = !inside;
-    }
-    return inside;
+    return island_layer_contains(isl, ISLAND_LAYER_LAND, px, py);
 }
 
 
@@ -406,17 +382,8 @@ static int inside_biome_poly(float cx, float cy,
 /** Returns non-zero if (px, py) is inside ANY stone or metal biome polygon. */
 static int inside_any_stone_metal_biome(const IslandDef *isl, float px, float py)
 {
-    for (int pi = 0; pi < isl->stone_poly_count; pi++) {
-        if (inside_biome_poly(isl->x, isl->y,
-                              isl->stone_vx[pi], isl->stone_vy[pi],
-                              isl->stone_vc[pi], px, py)) return 1;
-    }
-    for (int pi = 0; pi < isl->metal_poly_count; pi++) {
-        if (inside_biome_poly(isl->x, isl->y,
-                              isl->metal_vx[pi], isl->metal_vy[pi],
-                              isl->metal_vc[pi], px, py)) return 1;
-    }
-    return 0;
+    return island_layer_contains(isl, ISLAND_LAYER_STONE, px, py)
+        || island_layer_contains(isl, ISLAND_LAYER_METAL, px, py);
 }
 
 /** Bounding box (world px) of a biome polygon. */
@@ -759,122 +726,148 @@ void islands_generate_trees(void)
     }
 }
 
-/* ── Spatial grid + alive list ───────────────────────────────────────────── */
+/* ── Resource grid ───────────────────────────────────────────────────────── */
+
+static uint16_t *grid_head(IslandDef *isl, const IslandResource *r)
+{
+    int col = (int)((isl->x + r->ox - isl->grid_ox) / isl->grid_cell);
+    int row = (int)((isl->y + r->oy - isl->grid_oy) / isl->grid_cell);
+    if (col < 0) col = 0;
+    if (row < 0) row = 0;
+    if (col >= isl->grid_w) col = isl->grid_w - 1;
+    if (row >= isl->grid_h) row = isl->grid_h - 1;
+    return &isl->grid_cells[row][col][r->type_id];
+}
+
+static void grid_link(IslandDef *isl, int ri)
+{
+    IslandResource *r = &isl->resources[ri];
+    if (r->in_grid || r->type_id >= ISLAND_RES_TYPES || isl->grid_cell <= 0.0f) return;
+    uint16_t *head = grid_head(isl, r);
+    r->grid_prev = ISLAND_RES_NONE;
+    r->grid_next = *head;
+    if (*head != ISLAND_RES_NONE) isl->resources[*head].grid_prev = (uint16_t)ri;
+    *head = (uint16_t)ri;
+    r->in_grid = true;
+    isl->alive_count[r->type_id]++;
+}
+
+static void grid_unlink(IslandDef *isl, int ri)
+{
+    IslandResource *r = &isl->resources[ri];
+    if (!r->in_grid) return;
+    if (r->grid_prev != ISLAND_RES_NONE) isl->resources[r->grid_prev].grid_next = r->grid_next;
+    else                                 *grid_head(isl, r) = r->grid_next;
+    if (r->grid_next != ISLAND_RES_NONE) isl->resources[r->grid_next].grid_prev = r->grid_prev;
+    r->in_grid = false;
+    isl->alive_count[r->type_id]--;
+}
 
 void islands_build_grid(void)
 {
     for (int ii = 0; ii < ISLAND_COUNT; ii++) {
         IslandDef *isl = &ISLAND_PRESETS[ii];
 
-        /* Clear grid and alive list */
-        memset(isl->wood_grid, 0, sizeof(isl->wood_grid));
-        isl->alive_wood_count = 0;
+        memset(isl->grid_cells, 0xFF, sizeof(isl->grid_cells));
+        memset(isl->alive_count, 0, sizeof(isl->alive_count));
+        isl->grid_cell = 0.0f;
+        isl->grid_w = isl->grid_h = 0;
+        isl->grid_max_size = 1.0f;
+        for (int ri = 0; ri < isl->resource_count; ri++)
+            isl->resources[ri].in_grid = false;
 
         if (isl->resource_count == 0) continue;
 
-        /* Compute bounding box of all wood nodes to set grid origin */
+        /* Bounding box of every node sets the origin and cell size */
         float min_x =  1e9f, min_y =  1e9f;
         float max_x = -1e9f, max_y = -1e9f;
         for (int ri = 0; ri < isl->resource_count; ri++) {
             const IslandResource *r = &isl->resources[ri];
-            if (r->type_id != RES_WOOD) continue;
             float wx = isl->x + r->ox;
             float wy = isl->y + r->oy;
             if (wx < min_x) min_x = wx;
             if (wy < min_y) min_y = wy;
             if (wx > max_x) max_x = wx;
             if (wy > max_y) max_y = wy;
+            if (r->size > isl->grid_max_size) isl->grid_max_size = r->size;
         }
-        if (min_x > max_x) continue; /* no wood nodes on this island */
-
-        /* Grid origin: one cell-width before the first node so all nodes
-         * map to col/row >= 0 even with floating-point rounding */
-        isl->grid_ox = min_x - ISLAND_GRID_CELL_PX;
-        isl->grid_oy = min_y - ISLAND_GRID_CELL_PX;
-        isl->grid_w  = (int)((max_x - isl->grid_ox) / ISLAND_GRID_CELL_PX) + 2;
-        isl->grid_h  = (int)((max_y - isl->grid_oy) / ISLAND_GRID_CELL_PX) + 2;
+
+        /* One spare cell on each side absorbs floating-point rounding */
+        float extent = fmaxf(max_x - min_x, max_y - min_y);
+        float cell   = ISLAND_GRID_CELL_PX;
+        int   fit    = ISLAND_GRID_COLS < ISLAND_GRID_ROWS ? ISLAND_GRID_COLS : ISLAND_GRID_ROWS;
+        if (extent / cell + 3.0f > (float)fit) cell = extent / (float)(fit - 3);
+        isl->grid_cell = cell;
+        isl->grid_ox = min_x - cell;
+        isl->grid_oy = min_y - cell;
+        isl->grid_w  = (int)((max_x - isl->grid_ox) / cell) + 2;
+        isl->grid_h  = (int)((max_y - isl->grid_oy) / cell) + 2;
         if (isl->grid_w > ISLAND_GRID_COLS) isl->grid_w = ISLAND_GRID_COLS;
         if (isl->grid_h > ISLAND_GRID_ROWS) isl->grid_h = ISLAND_GRID_ROWS;
 
-        /* Insert each wood node into the grid + alive list */
-        for (int ri = 0; ri < isl->resource_count; ri++) {
-            const IslandResource *r = &isl->resources[ri];
-            if (r->type_id != RES_WOOD) continue;
-
-            /* Add to alive list */
-            if (isl->alive_wood_count < ISLAND_MAX_RESOURCES)
-                isl->alive_wood[isl->alive_wood_count++] = (uint16_t)ri;
-
-            /* Add to spatial grid */
-            int col = (int)((isl->x + r->ox - isl->grid_ox) / ISLAND_GRID_CELL_PX);
-            int row = (int)((isl->y + r->oy - isl->grid_oy) / ISLAND_GRID_CELL_PX);
-            if (col < 0 || col >= isl->grid_w || row < 0 || row >= isl->grid_h) continue;
-            IslandGridCell *cell = &isl->wood_grid[row][col];
-            if (cell->count < ISLAND_GRID_MAXPC)
-                cell->ri[cell->count++] = (uint16_t)ri;
-        }
+        /* Highest index first so each cell list runs in index order */
+        for (int ri = isl->resource_count - 1; ri >= 0; ri--)
+            if (isl->resources[ri].health > 0) grid_link(isl, ri);
     }
 }
 
-void island_mark_tree_dead(IslandDef *isl, int ri)
+void island_mark_resource_dead(IslandDef *isl, int ri)
 {
-    /* Remove from alive list (swap-and-pop) */
-    for (int k = 0; k < isl->alive_wood_count; k++) {
-        if (isl->alive_wood[k] == (uint16_t)ri) {
-            isl->alive_wood[k] = isl->alive_wood[--isl->alive_wood_count];
-            break;
-        }
-    }
-    /* Remove from spatial grid (swap-and-pop in the cell) */
-    int col = (int)((isl->x + isl->resources[ri].ox - isl->grid_ox) / ISLAND_GRID_CELL_PX);
-    int row = (int)((isl->y + isl->resources[ri].oy - isl->grid_oy) / ISLAND_GRID_CELL_PX);
-    if (col < 0 || col >= isl->grid_w || row < 0 || row >= isl->grid_h) return;
-    IslandGridCell *cell = &isl->wood_grid[row][col];
-    for (int k = 0; k < cell->count; k++) {
-        if (cell->ri[k] == (uint16_t)ri) {
-            cell->ri[k] = cell->ri[--cell->count];
-            return;
-        }
-    }
+    if (ri < 0 || ri >= isl->resource_count) return;
+    grid_unlink(isl, ri);
 }
 
-void island_mark_tree_alive(IslandDef *isl, int ri)
+void island_mark_resource_alive(IslandDef *isl, int ri)
 {
-    /* Guard: already in alive list? */
-    for (int k = 0; k < isl->alive_wood_count; k++) {
-        if (isl->alive_wood[k] == (uint16_t)ri) return;
-    }
-    /* Append to alive list (cap at MAX_ALIVE_WOOD if defined) */
-    if (isl->alive_wood_count < (int)(sizeof(isl->alive_wood) / sizeof(isl->alive_wood[0]))) {
-        isl->alive_wood[isl->alive_wood_count++] = (uint16_t)ri;
-    }
-    /* Re-insert into spatial grid */
-    int col = (int)((isl->x + isl->resources[ri].ox - isl->grid_ox) / ISLAND_GRID_CELL_PX);
-    int row = (int)((isl->y + isl->resources[ri].oy - isl->grid_oy) / ISLAND_GRID_CELL_PX);
-    if (col < 0 || col >= isl->grid_w || row < 0 || row >= isl->grid_h) return;
-    IslandGridCell *cell = &isl->wood_grid[row][col];
-    if (cell->count < (int)(sizeof(cell->ri) / sizeof(cell->ri[0]))) {
-        cell->ri[cell->count++] = (uint16_t)ri;
+    if (ri < 0 || ri >= isl->resource_count) return;
+    grid_link(isl, ri);
+}
+
+static void near_push(IslandResourceNear *out, uint16_t ri)
+{
+    if (out->count == out->cap) {
+        uint32_t cap = out->cap ? out->cap * 2 : 64;
+        uint16_t *grown = realloc(out->ri, cap * sizeof(uint16_t));
+        if (!grown) {
+            log_error("❌ Resource grid: out of memory for %u results", cap);
+            return;
+        }
+        out->ri  = grown;
+        out->cap = cap;
     }
+    out->ri[out->count++] = ri;
 }
 
-/**
- * Returns true if the resource at world position (rx, ry) may respawn.
- * Suppressed when any active structure is within RESPAWN_SUPPRESS_R px,
- * i.e. a player has built over the depleted node's footprint.
- */
-bool island_resource_can_respawn(float rx, float ry,
-                                 const PlacedStructure *structs,
-                                 uint32_t struct_count)
+uint32_t island_resources_near(IslandResourceNear *out, const IslandDef *isl,
+                               float wx, float wy, float r, uint32_t type_mask)
 {
-    /* Any structure type within this radius blocks respawn. */
-    const float RESPAWN_SUPPRESS_R = 60.0f;
-    for (uint32_t i = 0; i < struct_count; i++) {
-        if (!structs[i].active) continue;
-        float dx = structs[i].x - rx;
-        float dy = structs[i].y - ry;
-        if (dx*dx + dy*dy < RESPAWN_SUPPRESS_R * RESPAWN_SUPPRESS_R)
-            return false;
+    out->count = 0;
+    if (isl->grid_cell <= 0.0f) return 0;
+    int c0 = (int)floorf((wx - r - isl->grid_ox) / isl->grid_cell);
+    int c1 = (int)floorf((wx + r - isl->grid_ox) / isl->grid_cell);
+    int r0 = (int)floorf((wy - r - isl->grid_oy) / isl->grid_cell);
+    int r1 = (int)floorf((wy + r - isl->grid_oy) / isl->grid_cell);
+    if (c1 < 0 || r1 < 0 || c0 >= isl->grid_w || r0 >= isl->grid_h) return 0;
+    if (c0 < 0) c0 = 0;
+    if (r0 < 0) r0 = 0;
+    if (c1 >= isl->grid_w) c1 = isl->grid_w - 1;
+    if (r1 >= isl->grid_h) r1 = isl->grid_h - 1;
+
+    for (int row = r0; row <= r1; row++)
+        for (int col = c0; col <= c1; col++)
+            for (int t = 0; t < ISLAND_RES_TYPES; t++) {
+                if (type_mask && !(type_mask & RES_MASK(t))) continue;
+                for (uint16_t ri = isl->grid_cells[row][col][t]; ri != ISLAND_RES_NONE;
+                     ri = isl->resources[ri].grid_next)
+                    near_push(out, ri);
+            }
+
+    /* Index order, so first-match callers see what a full scan would */
+    for (uint32_t a = 1; a < out->count; a++) {
+        uint16_t v = out->ri[a];
+        uint32_t b = a;
+        for (; b > 0 && out->ri[b - 1] > v; b--) out->ri[b] = out->ri[b - 1];
+        out->ri[b] = v;
     }
-    return true;
+    return out->count;
 }
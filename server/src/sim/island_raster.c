@@ -0,0 +1,607 @@
+/**
+ * island_raster.c — Per-island land/biome rasters and shoreline distance.
+ *
+ * Built once by islands_build_rasters() from the final (rotated) polygons.
+ * Each layer is classified onto RASTER_CELL_PX cells grouped into 8×8
+ * tiles: a tile wholly inside or outside a layer stores one state, a tile
+ * an edge passes through stores 2 bits per cell, and only cells within
+ * RASTER_PAD_PX of an edge (CELL_EDGE) run the exact polygon test.  The
+ * classification is conservative, so lookups agree with the exact tests.
+ *
+ * Shoreline distance: every tile within ISLAND_SHORE_BAND_PX of the beach
+ * keeps the beach edges that can be nearest to any point in it (those within
+ * d_centre + 2·half-diagonal of its centre); tiles further out keep a lower
+ * bound instead.  The same candidates answer island_poly_nearest_exit(),
+ * so ship-vs-island pushout only tests the few edges near each hull vertex.
+ */
+
+#include "sim/island.h"
+#include "util/log.h"
+#include <math.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define RASTER_CELL_PX      16.0f
+#define RASTER_TILE_CELLS   8
+#define RASTER_TILE_PX      (RASTER_CELL_PX * RASTER_TILE_CELLS)
+#define RASTER_PAD_PX       0.5f     /* cells this close to an edge are CELL_EDGE */
+#define RASTER_MAX_CELLS    (4096 * 4096)
+
+enum { CELL_OUT = 0, CELL_IN = 1, CELL_EDGE = 2, CELL_UNSET = 0xFF };
+
+typedef struct {
+    uint8_t  state[ISLAND_LAYER_COUNT];  /* CELL_OUT / CELL_IN / CELL_EDGE      */
+    uint32_t fine[ISLAND_LAYER_COUNT];   /* CELL_EDGE: row block in fine[]       */
+    uint32_t cand_off;                   /* Candidate beach edges in cand[]      */
+    uint16_t cand_n;                     /* 0 = beyond the band: use shore_lo    */
+    float    shore_lo;                   /* Lower bound on shore distance        */
+} RasterTile;
+
+typedef struct {
+    bool        built;
+    float       ox, oy;                  /* World px of tile [0][0] corner       */
+    int         tw, th;                  /* Tile columns and rows                */
+    RasterTile *tiles;
+    uint16_t  (*fine)[RASTER_TILE_CELLS];/* 8 rows × 8 cells × 2 bits per block  */
+    uint32_t    fine_count, fine_cap;
+    uint8_t    *cand;                    /* Beach edge indices (edge j→i as i)   */
+    uint32_t    cand_count;
+    float       bx0, by0, bx1, by1;      /* Beach vertex bounding box (world)    */
+    float       shallow_bound_r;         /* Max distance to a shallow vertex     */
+} IslandRaster;
+
+static IslandRaster g_rasters[ISLAND_COUNT];
+
+static const IslandRaster *raster_of(const IslandDef *isl)
+{
+    ptrdiff_t ii = isl - ISLAND_PRESETS;
+    if (ii < 0 || ii >= ISLAND_COUNT || !g_rasters[ii].built) return NULL;
+    return &g_rasters[ii];
+}
+
+/* ── Exact tests ─────────────────────────────────────────────────────────── */
+
+/** Ray-cast even-odd test on a polygon given as offsets from (cx, cy). */
+static bool ray_cast(float cx, float cy, const float *vx, const float *vy, int n,
+                     float px, float py)
+{
+    bool inside = false;
+    for (int i = 0, j = n - 1; i < n; j = i++) {
+        float xi = cx + vx[i], yi = cy + vy[i];
+        float xj = cx + vx[j], yj = cy + vy[j];
+        if ((yi > py) != (yj > py) &&
+            px < (xj - xi) * (py - yi) / (yj - yi) + xi)
+            inside = !inside;
+    }
+    return inside;
+}
+
+bool island_layer_contains_exact(const IslandDef *isl, IslandLayer layer, float px, float py)
+{
+    switch (layer) {
+    case ISLAND_LAYER_LAND: {
+        if (isl->vertex_count > 0) return island_poly_contains(isl, px, py);
+        float dx = px - isl->x, dy = py - isl->y;
+        float ds = dx * dx + dy * dy;
+        float broad_r = isl->beach_radius_px + isl->beach_max_bump;
+        if (ds >= broad_r * broad_r) return false;
+        float r = island_boundary_r(isl->beach_radius_px, isl->beach_bumps, atan2f(dy, dx));
+        return ds < r * r;
+    }
+    case ISLAND_LAYER_GRASS:
+        return isl->grass_vertex_count > 0 &&
+               ray_cast(isl->x, isl->y, isl->gvx, isl->gvy, isl->grass_vertex_count, px, py);
+    case ISLAND_LAYER_SHALLOW:
+        return isl->shallow_vertex_count > 0 && island_shallow_poly_contains(isl, px, py);
+    case ISLAND_LAYER_STONE:
+        for (int pi = 0; pi < isl->stone_poly_count; pi++)
+            if (isl->stone_vc[pi] >= 3 &&
+                ray_cast(isl->x, isl->y, isl->stone_vx[pi], isl->stone_vy[pi], isl->stone_vc[pi], px, py))
+                return true;
+        return false;
+    case ISLAND_LAYER_METAL:
+        for (int pi = 0; pi < isl->metal_poly_count; pi++)
+            if (isl->metal_vc[pi] >= 3 &&
+                ray_cast(isl->x, isl->y, isl->metal_vx[pi], isl->metal_vy[pi], isl->metal_vc[pi], px, py))
+                return true;
+        return false;
+    default:
+        return false;
+    }
+}
+
+/* Beach edge j→i, with i the index stored; same arithmetic as
+ * island_poly_edge_dist() so the minimum comes out bit-identical.  Also
+ * writes the offset from (px, py) to the nearest point on the edge. */
+static float beach_edge_closest(const IslandDef *isl, int i, float px, float py,
+                                float *cx, float *cy)
+{
+    int j = i ? i - 1 : isl->vertex_count - 1;
+    float ax = isl->x + isl->vx[j], ay = isl->y + isl->vy[j];
+    float bx = isl->x + isl->vx[i], by = isl->y + isl->vy[i];
+    float ex = bx - ax, ey = by - ay;
+    float len2 = ex * ex + ey * ey;
+    float t = len2 > 0.0f ? ((px - ax) * ex + (py - ay) * ey) / len2 : 0.0f;
+    if (t < 0.0f) t = 0.0f; else if (t > 1.0f) t = 1.0f;
+    *cx = ax + t * ex - px;
+    *cy = ay + t * ey - py;
+    return sqrtf(*cx * *cx + *cy * *cy);
+}
+
+static float beach_edge_dist(const IslandDef *isl, int i, float px, float py)
+{
+    float cx, cy;
+    return beach_edge_closest(isl, i, px, py, &cx, &cy);
+}
+
+/* ── Build ───────────────────────────────────────────────────────────────── */
+
+typedef struct {
+    const float *vx, *vy;
+    int          n;
+} RasterPoly;
+
+static int layer_polys(const IslandDef *isl, IslandLayer layer, RasterPoly *out)
+{
+    int n = 0;
+    switch (layer) {
+    case ISLAND_LAYER_LAND:
+        if (isl->vertex_count > 0) out[n++] = (RasterPoly){ isl->vx, isl->vy, isl->vertex_count };
+        break;
+    case ISLAND_LAYER_GRASS:
+        if (isl->grass_vertex_count > 0) out[n++] = (RasterPoly){ isl->gvx, isl->gvy, isl->grass_vertex_count };
+        break;
+    case ISLAND_LAYER_SHALLOW:
+        if (isl->shallow_vertex_count > 0) out[n++] = (RasterPoly){ isl->svx, isl->svy, isl->shallow_vertex_count };
+        break;
+    case ISLAND_LAYER_STONE:
+        for (int pi = 0; pi < isl->stone_poly_count; pi++)
+            out[n++] = (RasterPoly){ isl->stone_vx[pi], isl->stone_vy[pi], isl->stone_vc[pi] };
+        break;
+    case ISLAND_LAYER_METAL:
+        for (int pi = 0; pi < isl->metal_poly_count; pi++)
+            out[n++] = (RasterPoly){ isl->metal_vx[pi], isl->metal_vy[pi], isl->metal_vc[pi] };
+        break;
+    default:
+        break;
+    }
+    return n;
+}
+
+typedef struct {
+    uint8_t *cells;
+    int      w, h;          /* Fine cells */
+    float    ox, oy;
+} FineGrid;
+
+/* Mark every cell whose padded box the segment touches (SAT on the
+ * segment's bounding box and its normal) */
+static void mark_segment(FineGrid *g, float ax, float ay, float bx, float by)
+{
+    int c0 = (int)floorf((fminf(ax, bx) - RASTER_PAD_PX - g->ox) / RASTER_CELL_PX);
+    int c1 = (int)floorf((fmaxf(ax, bx) + RASTER_PAD_PX - g->ox) / RASTER_CELL_PX);
+    int r0 = (int)floorf((fminf(ay, by) - RASTER_PAD_PX - g->oy) / RASTER_CELL_PX);
+    int r1 = (int)floorf((fmaxf(ay, by) + RASTER_PAD_PX - g->oy) / RASTER_CELL_PX);
+    if (c0 < 0) c0 = 0;
+    if (r0 < 0) r0 = 0;
+    if (c1 >= g->w) c1 = g->w - 1;
+    if (r1 >= g->h) r1 = g->h - 1;
+    float nx = by - ay, ny = ax - bx;
+    float half = RASTER_CELL_PX * 0.5f + RASTER_PAD_PX;
+    float reach = half * (fabsf(nx) + fabsf(ny));
+    for (int r = r0; r <= r1; r++) {
+        float cy = g->oy + ((float)r + 0.5f) * RASTER_CELL_PX;
+        for (int c = c0; c <= c1; c++) {
+            float cx = g->ox + ((float)c + 0.5f) * RASTER_CELL_PX;
+            if (fabsf(nx * (cx - ax) + ny * (cy - ay)) <= reach)
+                g->cells[r * g->w + c] = CELL_EDGE;
+        }
+    }
+}
+
+/* Mark every cell whose padded box straddles the ring rlo..rhi around (cx, cy) */
+static void mark_ring(FineGrid *g, float cx, float cy, float rlo, float rhi)
+{
+    rlo -= RASTER_PAD_PX;
+    rhi += RASTER_PAD_PX;
+    for (int r = 0; r < g->h; r++) {
+        float y0 = g->oy + (float)r * RASTER_CELL_PX, y1 = y0 + RASTER_CELL_PX;
+        float ny = cy < y0 ? y0 - cy : (cy > y1 ? cy - y1 : 0.0f);
+        float fy = fmaxf(fabsf(cy - y0), fabsf(cy - y1));
+        for (int c = 0; c < g->w; c++) {
+            float x0 = g->ox + (float)c * RASTER_CELL_PX, x1 = x0 + RASTER_CELL_PX;
+            float nx = cx < x0 ? x0 - cx : (cx > x1 ? cx - x1 : 0.0f);
+            float fx = fmaxf(fabsf(cx - x0), fabsf(cx - x1));
+            float dmin = sqrtf(nx * nx + ny * ny), dmax = sqrtf(fx * fx + fy * fy);
+            if (dmax >= rlo && dmin <= rhi) g->cells[r * g->w + c] = CELL_EDGE;
+        }
+    }
+}
+
+/* Classify one layer: mark boundary cells, then give each run of unmarked
+ * cells in a row the exact answer at its first cell's centre — a run never
+ * crosses an edge, so the whole run shares it. */
+static void classify_layer(FineGrid *g, const IslandDef *isl, IslandLayer layer)
+{
+    memset(g->cells, CELL_UNSET, (size_t)g->w * (size_t)g->h);
+
+    RasterPoly polys[ISLAND_MAX_BIOME_POLYS + 1];
+    int np = layer_polys(isl, layer, polys);
+    if (layer == ISLAND_LAYER_LAND && isl->vertex_count == 0) {
+        float lo = 0.0f, hi = 0.0f;
+        for (int k = 0; k < ISLAND_BUMP_COUNT; k++) {
+            lo = fminf(lo, isl->beach_bumps[k]);
+            hi = fmaxf(hi, isl->beach_bumps[k]);
+        }
+        if (isl->beach_radius_px + isl->beach_max_bump > 0.0f)
+            mark_ring(g, isl->x, isl->y, isl->beach_radius_px + lo, isl->beach_radius_px + hi);
+    }
+    for (int p = 0; p < np; p++)
+        for (int i = 0, j = polys[p].n - 1; i < polys[p].n; j = i++)
+            mark_segment(g, isl->x + polys[p].vx[j], isl->y + polys[p].vy[j],
+                            isl->x + polys[p].vx[i], isl->y + polys[p].vy[i]);
+
+    for (int r = 0; r < g->h; r++) {
+        uint8_t *row = &g->cells[r * g->w];
+        uint8_t state = CELL_OUT;
+        bool in_run = false;
+        for (int c = 0; c < g->w; c++) {
+            if (row[c] == CELL_EDGE) { in_run = false; continue; }
+            if (!in_run) {
+                float cx = g->ox + ((float)c + 0.5f) * RASTER_CELL_PX;
+                float cy = g->oy + ((float)r + 0.5f) * RASTER_CELL_PX;
+                state = island_layer_contains_exact(isl, layer, cx, cy) ? CELL_IN : CELL_OUT;
+                in_run = true;
+            }
+            row[c] = state;
+        }
+    }
+}
+
+static bool pack_layer(IslandRaster *ra, const FineGrid *g, IslandLayer layer)
+{
+    for (int ty = 0; ty < ra->th; ty++)
+        for (int tx = 0; tx < ra->tw; tx++) {
+            RasterTile *t = &ra->tiles[ty * ra->tw + tx];
+            const uint8_t *base = &g->cells[(ty * RASTER_TILE_CELLS) * g->w + tx * RASTER_TILE_CELLS];
+            uint8_t first = base[0];
+            bool uniform = first != CELL_EDGE;
+            for (int r = 0; r < RASTER_TILE_CELLS && uniform; r++)
+                for (int c = 0; c < RASTER_TILE_CELLS; c++)
+                    if (base[r * g->w + c] != first) { uniform = false; break; }
+            if (uniform) {
+                t->state[layer] = first;
+                continue;
+            }
+            if (ra->fine_count == ra->fine_cap) {
+                uint32_t cap = ra->fine_cap ? ra->fine_cap * 2 : 64;
+                void *grown = realloc(ra->fine, cap * sizeof(*ra->fine));
+                if (!grown) return false;
+                ra->fine     = grown;
+                ra->fine_cap = cap;
+            }
+            uint16_t *rows = ra->fine[ra->fine_count];
+            for (int r = 0; r < RASTER_TILE_CELLS; r++) {
+                rows[r] = 0;
+                for (int c = 0; c < RASTER_TILE_CELLS; c++)
+                    rows[r] |= (uint16_t)(base[r * g->w + c] << (2 * c));
+            }
+            t->state[layer] = CELL_EDGE;
+            t->fine[layer]  = ra->fine_count++;
+        }
+    return true;
+}
+
+/* Candidate beach edges per tile for island_shore_dist() */
+static bool build_shore(IslandRaster *ra, const IslandDef *isl)
+{
+    int n = isl->vertex_count;
+    const float H = RASTER_TILE_PX * 0.70711f;   /* half-diagonal */
+    float d[ISLAND_MAX_VERTS];
+    uint32_t cap = 0;
+    for (int ty = 0; ty < ra->th; ty++)
+        for (int tx = 0; tx < ra->tw; tx++) {
+            RasterTile *t = &ra->tiles[ty * ra->tw + tx];
+            float cx = ra->ox + ((float)tx + 0.5f) * RASTER_TILE_PX;
+            float cy = ra->oy + ((float)ty + 0.5f) * RASTER_TILE_PX;
+            float dc = 1e30f;
+            for (int i = 0; i < n; i++) {
+                d[i] = beach_edge_dist(isl, i, cx, cy);
+                if (d[i] < dc) dc = d[i];
+            }
+            t->shore_lo = fmaxf(0.0f, dc - H);
+            t->cand_n   = 0;
+            t->cand_off = ra->cand_count;
+            if (t->shore_lo > ISLAND_SHORE_BAND_PX) continue;
+            /* The edge nearest any point p in the tile is within dc + H of p,
+             * so within dc + 2H of the centre; 1 px absorbs rounding */
+            for (int i = 0; i < n; i++) {
+                if (d[i] > dc + 2.0f * H + 1.0f) continue;
+                if (ra->cand_count == cap) {
+                    cap = cap ? cap * 2 : 1024;
+                    uint8_t *grown = realloc(ra->cand, cap);
+                    if (!grown) return false;
+                    ra->cand = grown;
+                }
+                ra->cand[ra->cand_count++] = (uint8_t)i;
+                t->cand_n++;
+            }
+        }
+    return true;
+}
+
+static void raster_free(IslandRaster *ra)
+{
+    free(ra->tiles);
+    free(ra->fine);
+    free(ra->cand);
+    memset(ra, 0, sizeof(*ra));
+}
+
+static void bbox_add(float *x0, float *y0, float *x1, float *y1, float x, float y)
+{
+    if (x < *x0) *x0 = x;
+    if (y < *y0) *y0 = y;
+    if (x > *x1) *x1 = x;
+    if (y > *y1) *y1 = y;
+}
+
+static bool raster_build(IslandRaster *ra, const IslandDef *isl)
+{
+    /* Coverage: everything any layer can hold, plus the shore band */
+    float x0 = 1e30f, y0 = 1e30f, x1 = -1e30f, y1 = -1e30f;
+    RasterPoly polys[ISLAND_MAX_BIOME_POLYS + 1];
+    for (int layer = 0; layer < ISLAND_LAYER_COUNT; layer++) {
+        int np = layer_polys(isl, (IslandLayer)layer, polys);
+        for (int p = 0; p < np; p++)
+            for (int i = 0; i < polys[p].n; i++)
+                bbox_add(&x0, &y0, &x1, &y1, isl->x + polys[p].vx[i], isl->y + polys[p].vy[i]);
+    }
+    if (isl->vertex_count == 0) {
+        float br = isl->beach_radius_px + isl->beach_max_bump;
+        if (br > 0.0f) {
+            bbox_add(&x0, &y0, &x1, &y1, isl->x - br, isl->y - br);
+            bbox_add(&x0, &y0, &x1, &y1, isl->x + br, isl->y + br);
+        }
+    } else {
+        ra->bx0 = ra->by0 = 1e30f;
+        ra->bx1 = ra->by1 = -1e30f;
+        for (int i = 0; i < isl->vertex_count; i++)
+            bbox_add(&ra->bx0, &ra->by0, &ra->bx1, &ra->by1, isl->x + isl->vx[i], isl->y + isl->vy[i]);
+    }
+    if (x0 > x1) return false;   /* nothing to rasterize */
+
+    float pad = ISLAND_SHORE_BAND_PX + RASTER_TILE_PX;
+    ra->ox = x0 - pad;
+    ra->oy = y0 - pad;
+    ra->tw = (int)ceilf((x1 + pad - ra->ox) / RASTER_TILE_PX);
+    ra->th = (int)ceilf((y1 + pad - ra->oy) / RASTER_TILE_PX);
+    FineGrid g = { NULL, ra->tw * RASTER_TILE_CELLS, ra->th * RASTER_TILE_CELLS, ra->ox, ra->oy };
+    if ((int64_t)g.w * g.h > RASTER_MAX_CELLS) {
+        log_warn("🏝️  Island %d too large to rasterize (%d×%d cells) — exact tests only", isl->id, g.w, g.h);
+        return false;
+    }
+
+    ra->tiles = calloc((size_t)ra->tw * (size_t)ra->th, sizeof(RasterTile));
+    g.cells   = malloc((size_t)g.w * (size_t)g.h);
+    bool ok = ra->tiles && g.cells;
+    for (int layer = 0; ok && layer < ISLAND_LAYER_COUNT; layer++) {
+        classify_layer(&g, isl, (IslandLayer)layer);
+        ok = pack_layer(ra, &g, (IslandLayer)layer);
+    }
+    free(g.cells);
+    if (ok && isl->vertex_count > 0) ok = build_shore(ra, isl);
+    if (!ok) {
+        log_error("❌ Island %d raster: out of memory — exact tests only", isl->id);
+        return false;
+    }
+
+    ra->shallow_bound_r = 0.0f;
+    for (int vi = 0; vi < isl->shallow_vertex_count; vi++) {
+        float r = sqrtf(isl->svx[vi]*isl->svx[vi] + isl->svy[vi]*isl->svy[vi]);
+        if (r > ra->shallow_bound_r) ra->shallow_bound_r = r;
+    }
+    return true;
+}
+
+void islands_build_rasters(void)
+{
+    for (int ii = 0; ii < ISLAND_COUNT; ii++) {
+        IslandRaster *ra = &g_rasters[ii];
+        raster_free(ra);
+        if (!raster_build(ra, &ISLAND_PRESETS[ii])) {
+            raster_free(ra);
+            continue;
+        }
+        ra->built = true;
+        log_info("🏝️  Island %d raster: %d×%d tiles, %u boundary blocks, %u shore candidates",
+                 ISLAND_PRESETS[ii].id, ra->tw, ra->th, ra->fine_count, ra->cand_count);
+    }
+}
+
+/* ── Queries ─────────────────────────────────────────────────────────────── */
+
+static const RasterTile *tile_at(const IslandRaster *ra, float px, float py, int *fx, int *fy)
+{
+    *fx = (int)floorf((px - ra->ox) / RASTER_CELL_PX);
+    *fy = (int)floorf((py - ra->oy) / RASTER_CELL_PX);
+    if (*fx < 0 || *fy < 0) return NULL;
+    int tx = *fx / RASTER_TILE_CELLS, ty = *fy / RASTER_TILE_CELLS;
+    if (tx >= ra->tw || ty >= ra->th) return NULL;
+    return &ra->tiles[ty * ra->tw + tx];
+}
+
+bool island_layer_contains(const IslandDef *isl, IslandLayer layer, float px, float py)
+{
+    const IslandRaster *ra = raster_of(isl);
+    if (ra) {
+        int fx, fy;
+        const RasterTile *t = tile_at(ra, px, py, &fx, &fy);
+        if (!t) return false;    /* the raster covers every layer's extent */
+        uint8_t st = t->state[layer];
+        if (st == CELL_EDGE) {
+            uint16_t row = ra->fine[t->fine[layer]][fy % RASTER_TILE_CELLS];
+            st = (uint8_t)((row >> (2 * (fx % RASTER_TILE_CELLS))) & 3u);
+        }
+        if (st != CELL_EDGE) return st == CELL_IN;
+    }
+    return island_layer_contains_exact(isl, layer, px, py);
+}
+
+const IslandDef *island_land_at(float px, float py)
+{
+    for (int ii = 0; ii < ISLAND_COUNT; ii++) {
+        const IslandDef *isl = &ISLAND_PRESETS[ii];
+        float dx = px - isl->x, dy = py - isl->y;
+        float ds = dx * dx + dy * dy;
+        float broad_r = isl->vertex_count > 0 ? isl->poly_bound_r
+                                              : isl->beach_radius_px + isl->beach_max_bump;
+        if (ds >= broad_r * broad_r) continue;
+        if (island_layer_contains(isl, ISLAND_LAYER_LAND, px, py)) return isl;
+    }
+    return NULL;
+}
+
+float island_shore_dist(const IslandDef *isl, float px, float py, float max_dist)
+{
+    const IslandRaster *ra = raster_of(isl);
+    if (ra && isl->vertex_count > 0) {
+        int fx, fy;
+        const RasterTile *t = tile_at(ra, px, py, &fx, &fy);
+        if (!t) {
+            /* Every edge lies in the beach vertex box */
+            float ox = px < ra->bx0 ? ra->bx0 - px : (px > ra->bx1 ? px - ra->bx1 : 0.0f);
+            float oy = py < ra->by0 ? ra->by0 - py : (py > ra->by1 ? py - ra->by1 : 0.0f);
+            float lo = sqrtf(ox * ox + oy * oy);
+            if (lo > max_dist + 1.0f) return lo;
+        } else if (t->cand_n > 0) {
+            float best = 1e30f;
+            for (uint16_t k = 0; k < t->cand_n; k++) {
+                float d = beach_edge_dist(isl, ra->cand[t->cand_off + k], px, py);
+                if (d < best) best = d;
+            }
+            return best;
+        } else if (t->shore_lo > max_dist + 1.0f) {
+            return t->shore_lo;
+        }
+    }
+    return island_poly_edge_dist(isl, px, py);
+}
+
+/* Nearest of beach edges idx[0..n-1] (all edges when idx is NULL); the
+ * first of equally near edges wins, as in the edge scan. */
+static bool nearest_exit_among(const IslandDef *isl, const uint8_t *idx, int n,
+                               float px, float py,
+                               float *out_nx, float *out_ny, float *out_depth)
+{
+    float best = 1e30f, bcx = 0.0f, bcy = 0.0f;
+    int   bi   = -1;
+    for (int k = 0; k < n; k++) {
+        int i = idx ? idx[k] : k;
+        float cx, cy;
+        float d = beach_edge_closest(isl, i, px, py, &cx, &cy);
+        if (d < best) { best = d; bcx = cx; bcy = cy; bi = i; }
+    }
+    if (bi < 0) return false;
+    if (best > 0.001f) {
+        *out_nx = bcx / best;
+        *out_ny = bcy / best;
+    } else {
+        /* On the edge itself: its outward normal (CW in y-down space) */
+        int j = bi ? bi - 1 : isl->vertex_count - 1;
+        float ex = isl->vx[bi] - isl->vx[j], ey = isl->vy[bi] - isl->vy[j];
+        float len = sqrtf(ex * ex + ey * ey);
+        if (len < 0.001f) { *out_nx = 1.0f; *out_ny = 0.0f; }
+        else              { *out_nx = ey / len; *out_ny = -ex / len; }
+    }
+    *out_depth = best;
+    return true;
+}
+
+bool island_poly_nearest_exit(const IslandDef *isl, float px, float py,
+                              float *out_nx, float *out_ny, float *out_depth)
+{
+    *out_nx = 1.0f; *out_ny = 0.0f; *out_depth = 0.0f;
+    if (isl->vertex_count < 2) return false;
+    const IslandRaster *ra = raster_of(isl);
+    if (ra) {
+        int fx, fy;
+        const RasterTile *t = tile_at(ra, px, py, &fx, &fy);
+        if (t && t->cand_n > 0)
+            return nearest_exit_among(isl, &ra->cand[t->cand_off], t->cand_n,
+                                      px, py, out_nx, out_ny, out_depth);
+    }
+    return nearest_exit_among(isl, NULL, isl->vertex_count, px, py, out_nx, out_ny, out_depth);
+}
+
+static float shallow_bound_r(const IslandDef *isl)
+{
+    const IslandRaster *ra = raster_of(isl);
+    if (ra) return ra->shallow_bound_r;
+    float r_max = 0.0f;
+    for (int vi = 0; vi < isl->shallow_vertex_count; vi++) {
+        float r = sqrtf(isl->svx[vi]*isl->svx[vi] + isl->svy[vi]*isl->svy[vi]);
+        if (r > r_max) r_max = r;
+    }
+    return r_max;
+}
+
+bool island_in_shallow_water(const IslandDef *isl, float px, float py)
+{
+    float dx = px - isl->x, dy = py - isl->y;
+    float dist_sq = dx * dx + dy * dy;
+
+    if (isl->vertex_count > 0) {
+        if (isl->shallow_vertex_count > 0) {
+            float bound = shallow_bound_r(isl);
+            if (dist_sq > bound * bound) return false;
+            if (island_layer_contains(isl, ISLAND_LAYER_LAND, px, py)) return false;
+            return island_layer_contains(isl, ISLAND_LAYER_SHALLOW, px, py);
+        }
+        /* No explicit shallow polygon — no shallow zone for this island */
+        return false;
+    } else {
+        float shallow_depth = isl->beach_radius_px * SHALLOW_WATER_SCALE;
+        float broad_outer = isl->beach_radius_px + isl->beach_max_bump + shallow_depth;
+        if (dist_sq > broad_outer * broad_outer) return false;
+        float angle   = atan2f(dy, dx);
+        float beach_r = island_boundary_r(isl->beach_radius_px, isl->beach_bumps, angle);
+        float dist    = sqrtf(dist_sq);
+        return (dist > beach_r) && (dist < beach_r + shallow_depth);
+    }
+}
+
+float island_shallow_water_depth(const IslandDef *isl, float px, float py)
+{
+    float dx = px - isl->x, dy = py - isl->y;
+    float dist_sq = dx * dx + dy * dy;
+
+    if (isl->vertex_count > 0) {
+        if (isl->shallow_vertex_count > 0) {
+            float bound = shallow_bound_r(isl);
+            if (dist_sq > bound * bound) return 0.0f;
+            if (island_layer_contains(isl, ISLAND_LAYER_LAND, px, py)) return 0.0f;
+            if (!island_layer_contains(isl, ISLAND_LAYER_SHALLOW, px, py)) return 0.0f;
+            /* Gradient: 1.0 at sand edge, 0.0 at shallow boundary */
+            float shallow_depth = bound - isl->poly_bound_r;
+            if (shallow_depth <= 0.0f) return 0.0f;
+            float edge_dist = island_shore_dist(isl, px, py, shallow_depth);
+            if (edge_dist >= shallow_depth) return 0.0f;
+            float t = 1.0f - edge_dist / shallow_depth;
+            return (t > 1.0f) ? 1.0f : t;
+        }
+        /* No explicit shallow polygon — no shallow zone for this island */
+        return 0.0f;
+    } else {
+        float shallow_depth = isl->beach_radius_px * SHALLOW_WATER_SCALE;
+        float broad_outer = isl->beach_radius_px + isl->beach_max_bump + shallow_depth;
+        if (dist_sq > broad_outer * broad_outer) return 0.0f;
+        float angle   = atan2f(dy, dx);
+        float beach_r = island_boundary_r(isl->beach_radius_px, isl->beach_bumps, angle);
+        float dist    = sqrtf(dist_sq);
+        if (dist <= beach_r || dist >= beach_r + shallow_depth) return 0.0f;
+        float t = 1.0f - (dist - beach_r) / shallow_depth;
+        return (t < 0.0f) ? 0.0f : (t > 1.0f ? 1.0f : t);
+    }
+}
@@ -0,0 +1,556 @@
+#define _POSIX_C_SOURCE 200809L
+#include "sim/replay.h"
+#include "sim/simulation.h"
+#include "sim/island.h"
+#include "util/log.h"
+#include "util/time.h"
+#include "util/profiler.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/stat.h>
+
+/* ── Regions ─────────────────────────────────────────────────────────────── */
+
+/* The spatial hash holds pointers into the live sim and is rebuilt from the
+ * entity arrays, so it is neither recorded nor restored. */
+#define SIM_SKIP_OFF  offsetof(struct Sim, spatial_hash)
+#define SIM_SKIP_LEN  sizeof(((struct Sim*)0)->spatial_hash)
+
+/* The islands region is an image of ISLAND_PRESETS with each preset pointer
+ * zeroed and the preset recorded by name, so a file never carries addresses
+ * from the process that wrote it. */
+#define REPLAY_PRESET_NAME 32
+
+typedef struct {
+    IslandDef islands[ISLAND_COUNT];
+    char      preset[ISLAND_COUNT][REPLAY_PRESET_NAME];
+} IslandImage;
+
+static IslandImage g_island_image;
+
+static void island_image_capture(void) {
+    memcpy(g_island_image.islands, ISLAND_PRESETS, sizeof(g_island_image.islands));
+    for (int i = 0; i < ISLAND_COUNT; i++) {
+        g_island_image.islands[i].preset = NULL;
+        snprintf(g_island_image.preset[i], REPLAY_PRESET_NAME, "%s",
+                 ISLAND_PRESETS[i].preset ? ISLAND_PRESETS[i].preset : "");
+    }
+}
+
+static void island_image_restore(void) {
+    memcpy(ISLAND_PRESETS, g_island_image.islands, sizeof(g_island_image.islands));
+    for (int i = 0; i < ISLAND_COUNT; i++) {
+        char* name = g_island_image.preset[i];
+        name[REPLAY_PRESET_NAME - 1] = '\0';
+        ISLAND_PRESETS[i].preset = name[0] ? name : NULL;
+    }
+}
+
+static size_t region_size(int region) {
+    return region == REPLAY_REGION_SIM ? sizeof(struct Sim) : sizeof(IslandImage);
+}
+
+static uint8_t* region_base(int region, struct Sim* sim) {
+    return region == REPLAY_REGION_SIM ? (uint8_t*)sim : (uint8_t*)&g_island_image;
+}
+
+/* Word range [*w0, *w1) that is never encoded; empty for the islands */
+static void region_skip(int region, size_t* w0, size_t* w1) {
+    if (region == REPLAY_REGION_SIM) {
+        *w0 = (SIM_SKIP_OFF + 7) / 8;
+        *w1 = (SIM_SKIP_OFF + SIM_SKIP_LEN) / 8;
+    } else {
+        *w0 = *w1 = (size_t)-1;
+    }
+}
+
+/* ── Delta coding ────────────────────────────────────────────────────────────
+ * A region is a sequence of 8-byte words (the last one zero-padded).  An
+ * encoding is a list of runs: varint gap (unchanged words since the last
+ * run), varint length, then `length` words of old ^ new. */
+
+#define WORDS(size)        (((size) + 7) / 8)
+#define ENCODE_BOUND(size) (WORDS(size) * 11 + 16)
+#define SCAN_BLOCK_WORDS   32
+
+static inline uint64_t load_word(const uint8_t* p, size_t size, size_t w) {
+    uint64_t v = 0;
+    size_t off = w * 8;
+    memcpy(&v, p + off, size - off >= 8 ? 8 : size - off);
+    return v;
+}
+
+static inline void store_word(uint8_t* p, size_t size, size_t w, uint64_t v) {
+    size_t off = w * 8;
+    memcpy(p + off, &v, size - off >= 8 ? 8 : size - off);
+}
+
+static size_t put_varint(uint8_t* out, uint64_t v) {
+    size_t n = 0;
+    while (v >= 0x80) {
+        out[n++] = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    out[n++] = (uint8_t)v;
+    return n;
+}
+
+static bool get_varint(const uint8_t** p, const uint8_t* end, uint64_t* out) {
+    uint64_t v = 0;
+    for (int shift = 0; *p < end && shift < 64; shift += 7) {
+        uint8_t b = *(*p)++;
+        v |= (uint64_t)(b & 0x7F) << shift;
+        if (!(b & 0x80)) {
+            *out = v;
+            return true;
+        }
+    }
+    return false;
+}
+
+/* Encodes cur against base and leaves base equal to cur.  Returns the
+ * encoded length; 0 means nothing changed. */
+static size_t delta_encode(const uint8_t* cur, uint8_t* base, size_t size,
+                           size_t skip_w0, size_t skip_w1, uint8_t* out) {
+    size_t words = WORDS(size);
+    size_t full = size / 8;
+    size_t o = 0, w = 0, last = 0;
+
+    while (w < words) {
+        if (w == skip_w0) {
+            w = skip_w1;
+            continue;
+        }
+        /* Most of the region is unchanged: skip it a block at a time */
+        if (w % SCAN_BLOCK_WORDS == 0 && w + SCAN_BLOCK_WORDS <= full &&
+            (skip_w0 <= w || skip_w0 >= w + SCAN_BLOCK_WORDS) &&
+            memcmp(cur + w * 8, base + w * 8, SCAN_BLOCK_WORDS * 8) == 0) {
+            w += SCAN_BLOCK_WORDS;
+            continue;
+        }
+        if (load_word(cur, size, w) == load_word(base, size, w)) {
+            w++;
+            continue;
+        }
+
+        size_t start = w;
+        while (w < words && w != skip_w0 && load_word(cur, size, w) != load_word(base, size, w)) w++;
+
+        o += put_varint(out + o, start - last);
+        o += put_varint(out + o, w - start);
+        for (size_t i = start; i < w; i++) {
+            uint64_t c = load_word(cur, size, i);
+            uint64_t x = c ^ load_word(base, size, i);
+            memcpy(out + o, &x, 8);
+            o += 8;
+            store_word(base, size, i, c);
+        }
+        last = w;
+    }
+    return o;
+}
+
+static bool delta_apply(uint8_t* dst, size_t size, const uint8_t* p, const uint8_t* end) {
+    size_t words = WORDS(size);
+    size_t w = 0;
+    while (p < end) {
+        uint64_t gap, len;
+        if (!get_varint(&p, end, &gap) || !get_varint(&p, end, &len)) return false;
+        if (gap > words - w || len > words - w - gap || (uint64_t)(end - p) < len * 8) return false;
+        w += gap;
+        for (uint64_t i = 0; i < len; i++, w++) {
+            uint64_t x;
+            memcpy(&x, p, 8);
+            p += 8;
+            store_word(dst, size, w, load_word(dst, size, w) ^ x);
+        }
+    }
+    return true;
+}
+
+/* ── Recorder ────────────────────────────────────────────────────────────── */
+
+static struct {
+    pthread_mutex_t mtx;                 /* Guards requests and status */
+    bool     start_requested;
+    bool     stop_requested;
+    char     requested_path[256];
+    struct ReplayRecorderStatus status;
+
+    /* Tick thread only */
+    FILE*             fp;
+    const struct Sim* sim;
+    uint8_t*          shadow[REPLAY_REGION_COUNT];
+    uint8_t*          scratch;
+    uint32_t          tick;
+    uint64_t          bytes;
+} g_rec = { .mtx = PTHREAD_MUTEX_INITIALIZER };
+
+void replay_request_start(const char* path) {
+    pthread_mutex_lock(&g_rec.mtx);
+    g_rec.start_requested = true;
+    g_rec.stop_requested = false;
+    if (path) snprintf(g_rec.requested_path, sizeof(g_rec.requested_path), "%s", path);
+    else      g_rec.requested_path[0] = '\0';
+    pthread_mutex_unlock(&g_rec.mtx);
+}
+
+void replay_request_stop(void) {
+    pthread_mutex_lock(&g_rec.mtx);
+    g_rec.stop_requested = true;
+    g_rec.start_requested = false;
+    pthread_mutex_unlock(&g_rec.mtx);
+}
+
+bool replay_recorder_status(struct ReplayRecorderStatus* out) {
+    if (!out) return false;
+    pthread_mutex_lock(&g_rec.mtx);
+    *out = g_rec.status;
+    pthread_mutex_unlock(&g_rec.mtx);
+    return out->recording;
+}
+
+static void rec_write(uint8_t type, const void* a, size_t alen, const void* b, size_t blen) {
+    uint32_t len = (uint32_t)(alen + blen);
+    fputc(type, g_rec.fp);
+    fwrite(&len, sizeof(len), 1, g_rec.fp);
+    if (alen) fwrite(a, 1, alen, g_rec.fp);
+    if (blen) fwrite(b, 1, blen, g_rec.fp);
+    g_rec.bytes += 1 + sizeof(len) + len;
+}
+
+static void recorder_close(const char* why) {
+    if (!g_rec.fp) return;
+    int err = ferror(g_rec.fp) | fclose(g_rec.fp);
+    g_rec.fp = NULL;
+    g_rec.sim = NULL;
+    for (int r = 0; r < REPLAY_REGION_COUNT; r++) {
+        free(g_rec.shadow[r]);
+        g_rec.shadow[r] = NULL;
+    }
+    free(g_rec.scratch);
+    g_rec.scratch = NULL;
+
+    pthread_mutex_lock(&g_rec.mtx);
+    g_rec.status.recording = false;
+    g_rec.status.bytes = g_rec.bytes;
+    struct ReplayRecorderStatus st = g_rec.status;
+    pthread_mutex_unlock(&g_rec.mtx);
+
+    if (err) log_error("🎬 Replay %s failed to write (%s) — recording is incomplete", st.path, why);
+    else     log_info("🎬 Replay %s closed (%s): %u ticks, %.1f MB",
+                      st.path, why, st.ticks, st.bytes / (1024.0 * 1024.0));
+}
+
+static void recorder_open(struct Sim* sim, uint32_t tick, const char* requested) {
+    char path[256];
+    if (requested[0]) {
+        snprintf(path, sizeof(path), "%s", requested);
+    } else {
+        mkdir("data", 0755);
+        if (mkdir(REPLAY_DIR, 0755) != 0 && errno != EEXIST) {
+            log_error("🎬 Cannot create %s: %s", REPLAY_DIR, strerror(errno));
+            return;
+        }
+        snprintf(path, sizeof(path), REPLAY_DIR "/replay_%u.bin", tick);
+    }
+
+    FILE* fp = fopen(path, "wb");
+    if (!fp) {
+        log_error("🎬 Cannot open replay file %s: %s", path, strerror(errno));
+        return;
+    }
+    size_t scratch_cap = 0;
+    bool ok = true;
+    for (int r = 0; r < REPLAY_REGION_COUNT; r++) {
+        size_t size = region_size(r);
+        g_rec.shadow[r] = calloc(1, size);
+        ok = ok && g_rec.shadow[r];
+        if (ENCODE_BOUND(size) > scratch_cap) scratch_cap = ENCODE_BOUND(size);
+    }
+    g_rec.scratch = ok ? malloc(scratch_cap) : NULL;
+    if (!g_rec.scratch) {
+        log_error("🎬 Out of memory starting replay recording");
+        fclose(fp);
+        for (int r = 0; r < REPLAY_REGION_COUNT; r++) {
+            free(g_rec.shadow[r]);
+            g_rec.shadow[r] = NULL;
+        }
+        return;
+    }
+    setvbuf(fp, NULL, _IOFBF, 1 << 20);
+
+    g_rec.fp = fp;
+    g_rec.sim = sim;
+    g_rec.bytes = 0;
+
+    struct ReplayFileHeader hdr = {
+        .magic            = { REPLAY_MAGIC[0], REPLAY_MAGIC[1], REPLAY_MAGIC[2], REPLAY_MAGIC[3] },
+        .version          = REPLAY_VERSION,
+        .sim_size         = (uint32_t)region_size(REPLAY_REGION_SIM),
+        .islands_size     = (uint32_t)region_size(REPLAY_REGION_ISLANDS),
+        .input_size       = (uint32_t)sizeof(struct InputCmd),
+        .dt_q16           = Q16_FROM_FLOAT(TICK_DURATION_MS / 1000.0f),
+        .checkpoint_ticks = REPLAY_CHECKPOINT_TICKS,
+        .start_tick       = tick,
+        .start_unix_ms    = (uint64_t)time(NULL) * 1000,
+    };
+    fwrite(&hdr, sizeof(hdr), 1, fp);
+    g_rec.bytes += sizeof(hdr);
+
+    /* Shadows start zeroed, so encoding against them is the full snapshot */
+    island_image_capture();
+    for (int r = 0; r < REPLAY_REGION_COUNT; r++) {
+        size_t w0, w1;
+        region_skip(r, &w0, &w1);
+        size_t n = delta_encode(region_base(r, sim), g_rec.shadow[r], region_size(r), w0, w1, g_rec.scratch);
+        uint8_t region = (uint8_t)r;
+        rec_write(REPLAY_REC_SNAPSHOT, &region, 1, g_rec.scratch, n);
+    }
+
+    pthread_mutex_lock(&g_rec.mtx);
+    memset(&g_rec.status, 0, sizeof(g_rec.status));
+    g_rec.status.recording = true;
+    snprintf(g_rec.status.path, sizeof(g_rec.status.path), "%s", path);
+    g_rec.status.start_tick = tick;
+    g_rec.status.bytes = g_rec.bytes;
+    pthread_mutex_unlock(&g_rec.mtx);
+
+    log_info("🎬 Recording replay to %s from tick %u (snapshot %.1f KB)",
+             path, tick, g_rec.bytes / 1024.0);
+}
+
+void replay_recorder_shutdown(void) {
+    recorder_close("shutdown");
+}
+
+void replay_tick_begin(struct Sim* sim, uint32_t tick) {
+    pthread_mutex_lock(&g_rec.mtx);
+    bool start = g_rec.start_requested;
+    bool stop = g_rec.stop_requested;
+    char path[sizeof(g_rec.requested_path)];
+    memcpy(path, g_rec.requested_path, sizeof(path));
+    g_rec.start_requested = g_rec.stop_requested = false;
+    pthread_mutex_unlock(&g_rec.mtx);
+
+    if (stop) recorder_close("stopped");
+    if (start) {
+        if (g_rec.fp) log_warn("🎬 Replay already recording to %s", g_rec.status.path);
+        else          recorder_open(sim, tick, path);
+    }
+    if (!g_rec.fp) return;
+
+    g_rec.tick = tick;
+    rec_write(REPLAY_REC_TICK, &tick, sizeof(tick), NULL, 0);
+}
+
+void replay_record_input(const struct Sim* sim, const struct InputCmd* cmd) {
+    /* The shadow goes through sim_process_input too; only the live sim records */
+    if (!g_rec.fp || sim != g_rec.sim) return;
+    rec_write(REPLAY_REC_INPUT, cmd, sizeof(*cmd), NULL, 0);
+    sim_process_input((struct Sim*)g_rec.shadow[REPLAY_REGION_SIM], cmd);
+}
+
+void replay_record_ws(uint32_t player_id, const char* msg, size_t len) {
+    if (!g_rec.fp) return;
+    rec_write(REPLAY_REC_WS, &player_id, sizeof(player_id), msg, len);
+}
+
+void replay_record_pre_step(const struct Sim* sim) {
+    if (!g_rec.fp || sim != g_rec.sim) return;
+    PROF_BEGIN("replay.record");
+    island_image_capture();
+    for (int r = 0; r < REPLAY_REGION_COUNT; r++) {
+        size_t w0, w1;
+        region_skip(r, &w0, &w1);
+        size_t n = delta_encode(region_base(r, (struct Sim*)sim), g_rec.shadow[r], region_size(r),
+                                w0, w1, g_rec.scratch);
+        if (n) {
+            uint8_t region = (uint8_t)r;
+            rec_write(REPLAY_REC_DELTA, &region, 1, g_rec.scratch, n);
+        }
+    }
+    rec_write(REPLAY_REC_STEP, NULL, 0, NULL, 0);
+    PROF_END();
+}
+
+void replay_record_post_step(const struct Sim* sim) {
+    if (!g_rec.fp || sim != g_rec.sim) return;
+    PROF_BEGIN("replay.record");
+    /* The step only writes the sim; the island shadow is still current */
+    uint8_t* shadow = g_rec.shadow[REPLAY_REGION_SIM];
+    memcpy(shadow, sim, SIM_SKIP_OFF);
+    memcpy(shadow + SIM_SKIP_OFF + SIM_SKIP_LEN, (const uint8_t*)sim + SIM_SKIP_OFF + SIM_SKIP_LEN,
+           sizeof(struct Sim) - SIM_SKIP_OFF - SIM_SKIP_LEN);
+    if (g_rec.tick % REPLAY_CHECKPOINT_TICKS == 0) {
+        uint64_t hash = sim_state_hash(sim);
+        rec_write(REPLAY_REC_HASH, &hash, sizeof(hash), NULL, 0);
+    }
+    PROF_END();
+}
+
+void replay_tick_end(uint32_t tick_duration_us) {
+    if (!g_rec.fp) return;
+    rec_write(REPLAY_REC_TICK_END, &tick_duration_us, sizeof(tick_duration_us), NULL, 0);
+
+    pthread_mutex_lock(&g_rec.mtx);
+    g_rec.status.ticks++;
+    g_rec.status.bytes = g_rec.bytes;
+    pthread_mutex_unlock(&g_rec.mtx);
+
+    if (ferror(g_rec.fp)) recorder_close("write error");
+    else if (g_rec.bytes >= REPLAY_MAX_BYTES) recorder_close("size limit");
+}
+
+/* ── Playback ────────────────────────────────────────────────────────────── */
+
+static bool read_exact(FILE* fp, void* dst, size_t n) {
+    return fread(dst, 1, n, fp) == n;
+}
+
+int replay_play(const char* path, struct Sim* sim, const struct ReplayCallbacks* cb,
+                struct ReplayStats* stats) {
+    static const struct ReplayCallbacks no_callbacks = { 0 };
+    if (!cb) cb = &no_callbacks;
+    memset(stats, 0, sizeof(*stats));
+
+    FILE* fp = fopen(path, "rb");
+    if (!fp) {
+        log_error("🎬 Cannot open %s: %s", path, strerror(errno));
+        return -1;
+    }
+    struct ReplayFileHeader hdr;
+    if (!read_exact(fp, &hdr, sizeof(hdr)) || memcmp(hdr.magic, REPLAY_MAGIC, 4) != 0 ||
+        hdr.version != REPLAY_VERSION) {
+        log_error("🎬 %s is not a version %d replay", path, REPLAY_VERSION);
+        fclose(fp);
+        return -1;
+    }
+    if (hdr.sim_size != region_size(REPLAY_REGION_SIM) ||
+        hdr.islands_size != region_size(REPLAY_REGION_ISLANDS) ||
+        hdr.input_size != sizeof(struct InputCmd)) {
+        log_error("🎬 %s was recorded by a build with different struct layouts "
+                  "(Sim %u/%zu, islands %u/%zu, InputCmd %u/%zu)", path,
+                  hdr.sim_size, region_size(REPLAY_REGION_SIM),
+                  hdr.islands_size, region_size(REPLAY_REGION_ISLANDS),
+                  hdr.input_size, sizeof(struct InputCmd));
+        fclose(fp);
+        return -1;
+    }
+
+    size_t cap = 64 * 1024;
+    uint8_t* buf = malloc(cap);
+    bool in_tick = false;
+    uint32_t tick = 0;
+    uint64_t tick_start = 0;
+    int rc = 0;
+
+    for (;;) {
+        int type = fgetc(fp);
+        if (type == EOF) break;
+        uint32_t len;
+        if (!read_exact(fp, &len, sizeof(len))) { stats->truncated = true; break; }
+        if (len > cap) {
+            uint8_t* grown = buf ? realloc(buf, len) : NULL;
+            if (!grown) { rc = -1; break; }
+            buf = grown;
+            cap = len;
+        }
+        if (!buf || !read_exact(fp, buf, len)) { stats->truncated = true; break; }
+        const uint8_t* end = buf + len;
+
+        switch (type) {
+            case REPLAY_REC_SNAPSHOT:
+            case REPLAY_REC_DELTA: {
+                int region = len ? buf[0] : -1;
+                if (region < 0 || region >= REPLAY_REGION_COUNT) { rc = -1; break; }
+                PROF_BEGIN("replay.delta");
+                uint8_t* base = region_base(region, sim);
+                if (type == REPLAY_REC_SNAPSHOT) memset(base, 0, region_size(region));
+                bool ok = delta_apply(base, region_size(region), buf + 1, end);
+                if (ok && region == REPLAY_REGION_ISLANDS) island_image_restore();
+                PROF_END();
+                if (!ok) {
+                    log_error("🎬 Corrupt %s record at tick %u",
+                              type == REPLAY_REC_SNAPSHOT ? "snapshot" : "delta", tick);
+                    rc = -1;
+                }
+                break;
+            }
+            case REPLAY_REC_TICK:
+                if (len < sizeof(tick)) { rc = -1; break; }
+                memcpy(&tick, buf, sizeof(tick));
+                if (!stats->ticks) stats->first_tick = tick;
+                prof_tick_begin(tick);
+                tick_start = get_time_us();
+                in_tick = true;
+                break;
+            case REPLAY_REC_INPUT: {
+                struct InputCmd cmd;
+                if (len < sizeof(cmd)) { rc = -1; break; }
+                memcpy(&cmd, buf, sizeof(cmd));
+                PROF_BEGIN("replay.input");
+                sim_process_input(sim, &cmd);
+                PROF_END();
+                stats->inputs++;
+                break;
+            }
+            case REPLAY_REC_WS: {
+                uint32_t player_id;
+                if (len < sizeof(player_id)) { rc = -1; break; }
+                memcpy(&player_id, buf, sizeof(player_id));
+                stats->ws_messages++;
+                if (cb->on_ws) cb->on_ws(cb->user, tick, player_id, (const char*)buf + 4, len - 4);
+                break;
+            }
+            case REPLAY_REC_STEP:
+                PROF_BEGIN("sim");
+                sim_step(sim, hdr.dt_q16);
+                sim_wrap_world(sim);
+                PROF_END();
+                break;
+            case REPLAY_REC_HASH: {
+                uint64_t expected;
+                if (len < sizeof(expected)) { rc = -1; break; }
+                memcpy(&expected, buf, sizeof(expected));
+                uint64_t actual = sim_state_hash(sim);
+                stats->checkpoints++;
+                if (actual != expected) {
+                    if (!stats->mismatches) stats->first_mismatch_tick = tick;
+                    stats->mismatches++;
+                    if (cb->on_mismatch) cb->on_mismatch(cb->user, tick, expected, actual);
+                }
+                break;
+            }
+            case REPLAY_REC_TICK_END: {
+                uint32_t live_us = 0;
+                if (len >= sizeof(live_us)) memcpy(&live_us, buf, sizeof(live_us));
+                prof_tick_end();
+                in_tick = false;
+                uint32_t replay_us = (uint32_t)(get_time_us() - tick_start);
+                stats->replay_us += replay_us;
+                stats->last_tick = tick;
+                stats->ticks++;
+                if (cb->on_tick) cb->on_tick(cb->user, tick, live_us, replay_us);
+                break;
+            }
+            default:
+                log_warn("🎬 Skipping unknown replay record type %d", type);
+                break;
+        }
+        if (rc) break;
+    }
+
+    if (in_tick) {
+        prof_tick_end();
+        stats->truncated = true;
+    }
+    if (rc) log_error("🎬 Replay of %s stopped at tick %u: malformed record", path, tick);
+    free(buf);
+    fclose(fp);
+    return rc;
+}
@@ -0,0 +1,222 @@
+#include "sim/ship_flooding.h"
+#include "sim/module_types.h"
+#include "sim/ship_level.h"
+#include "core/math.h"
+#include <math.h>
+#include <stddef.h>
+
+const float FLOOD_COMPARTMENT_LINE[FLOOD_COMPARTMENTS] = { 0.01f, 0.25f, 0.75f };
+
+/* Gunport snap positions — must match client GUNPORT_SNAP_POINTS (ship-local px). */
+static const float GUNPORT_SNAP_X[12] = {
+     152.5f,  77.5f,   2.5f, -72.5f, -147.5f, -222.5f,
+     152.5f,  77.5f,   2.5f, -72.5f, -147.5f, -222.5f
+};
+static const float GUNPORT_SNAP_Y[12] = {
+    -90.0f, -90.0f, -90.0f, -90.0f, -90.0f, -90.0f,
+     90.0f,  90.0f,  90.0f,  90.0f,  90.0f,  90.0f
+};
+
+/* One row per sim ship slot, plus a scratch row for ships outside the array
+ * the last update saw.  A row is live while its generation matches g_gen and
+ * its id matches the ship. */
+#define ROWS      (FLOOD_MAX_SHIPS + 1)
+#define SCRATCH   FLOOD_MAX_SHIPS
+
+/* Gathered per ship */
+static uint32_t     g_id[ROWS];
+static uint32_t     g_row_gen[ROWS];
+static q16_t        g_hull[ROWS];
+static float        g_wet[ROWS];          /* 0 for ships that never flood, else 1 */
+static float        g_drain[ROWS];        /* ship_flood_drain_rate() × sturdiness, HP/s */
+static uint8_t      g_missing[ROWS], g_leaking[ROWS], g_open_ports[ROWS];
+static uint8_t      g_has_well[ROWS];
+static float        g_well_x[ROWS], g_well_y[ROWS];
+static uint8_t      g_opening_n[ROWS];
+static FloodOpening g_openings[ROWS][FLOOD_MAX_OPENINGS];
+
+/* Derived by update_rows() */
+static float        g_fill[ROWS], g_ingress[ROWS], g_recovery[ROWS], g_sink_s[ROWS];
+static uint8_t      g_scoop[ROWS];
+
+static const struct Ship* g_base;
+static uint32_t           g_count;
+static uint32_t           g_gen = 1;
+
+static void gunport_snap_pos(const ShipModule* mod, float* gx, float* gy) {
+    uint8_t idx = mod->data.gunport.snap_idx;
+    if (idx < 12) {
+        *gx = GUNPORT_SNAP_X[idx];
+        *gy = GUNPORT_SNAP_Y[idx];
+    } else {
+        *gx = SERVER_TO_CLIENT(Q16_TO_FLOAT(mod->local_pos.x));
+        *gy = SERVER_TO_CLIENT(Q16_TO_FLOAT(mod->local_pos.y));
+    }
+}
+
+static void add_opening(uint32_t r, const ShipModule* mod, FloodOpeningKind kind, float x, float y) {
+    if (g_opening_n[r] >= FLOOD_MAX_OPENINGS) return;
+    FloodOpening* o = &g_openings[r][g_opening_n[r]++];
+    o->x = x;
+    o->y = y;
+    o->module_id = mod->id;
+    o->kind = (uint8_t)kind;
+}
+
+/* The per-ship module scan: everything later passes need, in one go */
+static void gather(uint32_t r, const struct Ship* ship) {
+    g_id[r] = ship->id;
+    g_row_gen[r] = g_gen;
+    g_hull[r] = ship->hull_health;
+    g_opening_n[r] = 0;
+    g_has_well[r] = 0;
+    g_open_ports[r] = 0;
+
+    int remaining = 0, leaking = 0;
+    for (uint8_t m = 0; m < ship->module_count; m++) {
+        const ShipModule* mod = &ship->modules[m];
+        switch (mod->type_id) {
+        case MODULE_TYPE_PLANK:
+            if (mod->health > 0) {
+                remaining++;
+                if (mod->health < mod->max_health * 30 / 100) leaking++;
+            } else {
+                add_opening(r, mod, FLOOD_OPENING_PLANK,
+                            SERVER_TO_CLIENT(Q16_TO_FLOAT(mod->local_pos.x)),
+                            SERVER_TO_CLIENT(Q16_TO_FLOAT(mod->local_pos.y)));
+            }
+            break;
+        case MODULE_TYPE_GUNPORT: {
+            float gx, gy;
+            gunport_snap_pos(mod, &gx, &gy);
+            bool open = mod->data.gunport.is_open;
+            add_opening(r, mod, open ? FLOOD_OPENING_GUNPORT_OPEN : FLOOD_OPENING_GUNPORT_SHUT, gx, gy);
+            g_open_ports[r] += open;
+            break;
+        }
+        case MODULE_TYPE_WELL:
+            if (mod->deck_id != 0 || g_has_well[r]) break;
+            g_has_well[r] = 1;
+            g_well_x[r] = SERVER_TO_CLIENT(Q16_TO_FLOAT(mod->local_pos.x));
+            g_well_y[r] = SERVER_TO_CLIENT(Q16_TO_FLOAT(mod->local_pos.y));
+            break;
+        default:
+            break;
+        }
+    }
+
+    int missing = (int)ship->initial_plank_count - remaining;
+    if (missing < 0) missing = 0;
+    g_missing[r] = (uint8_t)(missing > 255 ? 255 : missing);
+    g_leaking[r] = (uint8_t)(leaking > 255 ? 255 : leaking);
+
+    /* Ghost hulls keep a raw HP pool, and shipyards pin hull_health at 100 */
+    bool wet = ship->company_id != 99 && !(ship->flags & SHIP_FLAG_SCAFFOLDED);
+    g_wet[r] = wet ? 1.0f : 0.0f;
+    g_drain[r] = wet ? ship_flood_drain_rate(missing, leaking) * ship_level_sturdiness_mult(&ship->level_stats)
+                     : 0.0f;
+}
+
+/* Derived state for rows [lo, hi): straight-line arithmetic over the dense
+ * arrays, no per-ship branches */
+static void update_rows(uint32_t lo, uint32_t hi) {
+    const float l0 = FLOOD_COMPARTMENT_LINE[FLOOD_BILGE] - FLOOD_SCOOP_GRACE;
+    const float l1 = FLOOD_COMPARTMENT_LINE[FLOOD_LOWER] - FLOOD_SCOOP_GRACE;
+    const float l2 = FLOOD_COMPARTMENT_LINE[FLOOD_UPPER] - FLOOD_SCOOP_GRACE;
+    for (uint32_t i = lo; i < hi; i++) {
+        float fill = 1.0f - Q16_TO_FLOAT(g_hull[i]) / 100.0f;
+        fill = fminf(fmaxf(fill, 0.0f), 1.0f) * g_wet[i];
+        float ingress = g_drain[i] * 0.01f;
+        /* A sealed hull sheds 1 HP/s (crew working the pumps) */
+        float recovery = (g_drain[i] <= 0.0f ? 0.01f : 0.0f) * g_wet[i];
+        float net = ingress - recovery;
+        g_fill[i] = fill;
+        g_ingress[i] = ingress;
+        g_recovery[i] = recovery;
+        g_sink_s[i] = net > 0.0f ? (1.0f - fill) / net : INFINITY;
+        uint8_t any = fill > 0.0f;
+        g_scoop[i] = (uint8_t)((any & (fill >= l0)) << FLOOD_BILGE |
+                               (any & (fill >= l1)) << FLOOD_LOWER |
+                               (any & (fill >= l2)) << FLOOD_UPPER);
+    }
+}
+
+void ship_flooding_update(const struct Ship* ships, uint32_t count) {
+    if (count > FLOOD_MAX_SHIPS) count = FLOOD_MAX_SHIPS;
+    if (++g_gen == 0) g_gen = 1;
+    g_base = ships;
+    g_count = count;
+    for (uint32_t i = 0; i < count; i++) gather(i, &ships[i]);
+    update_rows(0, count);
+}
+
+/* Row for ship: its slot in the array last passed to ship_flooding_update,
+ * re-gathered if stale (or forced), else the scratch row */
+static uint32_t row_of(const struct Ship* ship, bool force) {
+    uint32_t r = SCRATCH;
+    if (g_base) {
+        ptrdiff_t i = ship - g_base;
+        if (i >= 0 && (uint32_t)i < g_count) r = (uint32_t)i;
+    }
+    if (force || r == SCRATCH || g_row_gen[r] != g_gen || g_id[r] != ship->id) {
+        gather(r, ship);
+        update_rows(r, r + 1);
+    }
+    return r;
+}
+
+void ship_flooding_touch(const struct Ship* ship) {
+    if (ship) (void)row_of(ship, true);
+}
+
+void ship_flood_state(const struct Ship* ship, ShipFloodState* out) {
+    uint32_t r = row_of(ship, false);
+    out->fill           = g_fill[r];
+    out->ingress        = g_ingress[r];
+    out->recovery       = g_recovery[r];
+    out->secs_to_sink   = g_sink_s[r];
+    out->scoop_mask     = g_scoop[r];
+    out->missing_planks = g_missing[r];
+    out->leaking_planks = g_leaking[r];
+    out->open_gunports  = g_open_ports[r];
+}
+
+float ship_flood_fill(const struct Ship* ship) {
+    return ship ? g_fill[row_of(ship, false)] : 0.0f;
+}
+
+bool ship_flood_scoopable(const struct Ship* ship, FloodCompartment c) {
+    if (!ship || c >= FLOOD_COMPARTMENTS) return false;
+    return (g_scoop[row_of(ship, false)] >> c) & 1u;
+}
+
+bool ship_flood_well(const struct Ship* ship, float* out_x, float* out_y) {
+    if (!ship) return false;
+    uint32_t r = row_of(ship, false);
+    if (!g_has_well[r]) return false;
+    *out_x = g_well_x[r];
+    *out_y = g_well_y[r];
+    return true;
+}
+
+const FloodOpening* ship_flood_openings(const struct Ship* ship, int* out_n) {
+    if (!ship) { *out_n = 0; return NULL; }
+    uint32_t r = row_of(ship, false);
+    *out_n = g_opening_n[r];
+    return g_openings[r];
+}
+
+bool ship_flood_near_opening(const struct Ship* ship, float lx, float ly, float reach,
+                             uint8_t kinds, uint16_t* out_id) {
+    int n;
+    const FloodOpening* o = ship_flood_openings(ship, &n);
+    float r2 = reach * reach;
+    for (int k = 0; k < n; k++) {
+        if (!(o[k].kind & kinds)) continue;
+        float dx = lx - o[k].x, dy = ly - o[k].y;
+        if (dx * dx + dy * dy > r2) continue;
+        if (out_id) *out_id = o[k].module_id;
+        return true;
+    }
+    return false;
+}
@@ -4,10 +4,14 @@
 #include "sim/ship_level.h"
 #include "sim/island.h"
 #include "sim/deck_utils.h"
+#include "sim/hull_sdf.h"
+#include "sim/replay.h"
+#include "sim/ship_flooding.h"
 #include "net/protocol.h"
 #include "core/hash.h"
 #include "core/math.h"
 #include "util/log.h"
+#include "util/profiler.h"
 #include <string.h>
 #include <assert.h>
 #include <math.h>
@@ -233,15 +237,15 @@ static Vec2Q16 transform_hull_vertex(Vec2Q16 local_vertex, Vec2Q16 position, q16
  * Allocate a new unique entity ID
  */
 static entity_id allocate_entity_id(struct Sim* sim) {
-    (void)sim; // Mark as intentionally unused
-    static entity_id next_id = 1;
-    
-    // Simple sequential allocation
+    // Simple sequential allocation.  The counter lives in the Sim so that a
+    // snapshot (replay, rewind) carries it and re-simulation hands out the
+    // same ids.
     // TODO: Add recycling for production use
-    entity_id id = next_id++;
+    if (sim->next_entity_id == 0) sim->next_entity_id = 1;
+    entity_id id = sim->next_entity_id++;
     
     // Avoid overflow (entity_id is uint16_t)
-    if (next_id == 0) next_id = 1;
+    if (sim->next_entity_id == 0) sim->next_entity_id = 1;
     
     return id;
 }
@@ -308,14 +312,36 @@ void sim_step(struct Sim* sim, q16_t dt) {
     sim->time_ms += Q16_TO_INT(dt);
     
     // Update all subsystems in deterministic order
+    PROF_BEGIN("sim.ships");
     sim_update_ships(sim, dt);
+    PROF_END();
+    PROF_BEGIN("sim.players");
     sim_update_players(sim, dt);
+    PROF_END();
+    PROF_BEGIN("sim.projectiles");
     sim_update_projectiles(sim, dt);
+    PROF_END();
 
     // Collision handlers use brute-force / polygon tests today — not the spatial
     // hash (sim_update_spatial_hash). Skip the ~1.5 MB/tick memset until a reader
     // is wired into sim_handle_collisions.
+    PROF_BEGIN("sim.collisions");
     sim_handle_collisions(sim);
+    PROF_END();
+}
+
+void sim_wrap_world(struct Sim* sim) {
+    // ── World wrap: keep ships inside the toroidal 100 000×100 000 px map ──
+    // Operates in server units (MAP_WIDTH_SRV = 10 000).
+    for (uint32_t s = 0; s < sim->ship_count; s++) {
+        struct Ship* ship = &sim->ships[s];
+        float px = Q16_TO_FLOAT(ship->position.x);
+        float py = Q16_TO_FLOAT(ship->position.y);
+        px = WORLD_WRAP(px, MAP_WIDTH_SRV);
+        py = WORLD_WRAP(py, MAP_HEIGHT_SRV);
+        ship->position.x = Q16_FROM_FLOAT(px);
+        ship->position.y = Q16_FROM_FLOAT(py);
+    }
 }
 
 void sim_update_ships(struct Sim* sim, q16_t dt) {
@@ -462,19 +488,9 @@ void sim_update_ships(struct Sim* sim, q16_t dt) {
             if (health > 100.0f) health = 100.0f;
             ship->hull_health = Q16_FROM_FLOAT(health);
         } else {
-            // Hull is compromised — compute drain rate
-            float drain_rate = 0.0f;
-
-            // Missing planks: exponential drain (1/1.2) * 2^(missing-1)
-            if (missing > 0) {
-                int shift = missing - 1;
-                if (shift > 15) shift = 15;
-                drain_rate += (1.0f / 1.2f) * (float)(1 << shift);
-            }
-
-            // Each leaking plank contributes half the single-missing-plank base rate
-            drain_rate += 0.5f * (1.0f / 1.2f) * (float)planks_leaking;
-
+            // Hull is compromised — missing planks drain exponentially, leaking
+            // planks at half the single-missing-plank rate (see ship_flooding.h)
+            float drain_rate = ship_flood_drain_rate(missing, planks_leaking);
             float drain = drain_rate * ship_level_sturdiness_mult(&ship->level_stats) * dt_secs;
             float health = Q16_TO_FLOAT(ship->hull_health) - drain;
             if (health <= 0.0f) {
@@ -555,23 +571,7 @@ void sim_update_projectiles(struct Sim* sim, q16_t dt) {
         {
             float px_cli = SERVER_TO_CLIENT(Q16_TO_FLOAT(proj->position.x));
             float py_cli = SERVER_TO_CLIENT(Q16_TO_FLOAT(proj->position.y));
-            bool over_land = false;
-            for (int ii = 0; ii < ISLAND_COUNT && !over_land; ii++) {
-                const IslandDef *isl = &ISLAND_PRESETS[ii];
-                float dx = px_cli - isl->x, dy = py_cli - isl->y;
-                float dist_sq = dx * dx + dy * dy;
-                if (isl->vertex_count > 0) {
-                    over_land = (dist_sq < isl->poly_bound_r * isl->poly_bound_r)
-                             && island_poly_contains(isl, px_cli, py_cli);
-                } else {
-                    float broad_r = isl->beach_radius_px + isl->beach_max_bump;
-                    if (dist_sq < broad_r * broad_r) {
-                        float angle = atan2f(dy, dx);
-                        float r = island_boundary_r(isl->beach_radius_px, isl->beach_bumps, angle);
-                        over_land = (dist_sq < r * r);
-                    }
-                }
-            }
+            bool over_land = island_land_at(px_cli, py_cli) != NULL;
             proj->effective_age_ms += over_land ? dt_ms * 2 : dt_ms;
         }
         uint32_t max_lifetime = (proj->lifetime > 0)
@@ -666,7 +666,9 @@ static void handle_island_collisions(struct Sim *sim) {
              * Vertices are in client-pixel offsets from (isl->x, isl->y).
              * Convert ship hull vertices to client pixels for the polygon
              * test, then convert the resulting push depth back to server
-             * units.                                                         */
+             * units.  The land raster rejects vertices at sea by lookup, and
+             * the pushout for the rest only visits the beach edges the
+             * raster keeps for that vertex's tile.                          */
             float island_cx     = CLIENT_TO_SERVER(isl->x);
             float island_cy     = CLIENT_TO_SERVER(isl->y);
             float poly_broad_sv = CLIENT_TO_SERVER(isl->poly_bound_r);
@@ -690,10 +692,10 @@ static void handle_island_collisions(struct Sim *sim) {
                                                        ship->rotation);
                     float wx_cli = SERVER_TO_CLIENT(Q16_TO_FLOAT(wv.x));
                     float wy_cli = SERVER_TO_CLIENT(Q16_TO_FLOAT(wv.y));
-                    if (!island_poly_contains(isl, wx_cli, wy_cli)) continue;
+                    if (!island_layer_contains(isl, ISLAND_LAYER_LAND, wx_cli, wy_cli)) continue;
 
                     float nx, ny, depth_cli;
-                    if (!island_poly_pushout(isl, wx_cli, wy_cli, &nx, &ny, &depth_cli)) continue;
+                    if (!island_poly_nearest_exit(isl, wx_cli, wy_cli, &nx, &ny, &depth_cli)) continue;
                     float depth_sv = CLIENT_TO_SERVER(depth_cli);
                     if (depth_sv > max_pen) {
                         max_pen  = depth_sv;
@@ -794,6 +796,7 @@ void sim_handle_collisions(struct Sim* sim) {
      *
      * This runs BEFORE the discrete collision handlers so the discrete phase
      * sees the already-rewound positions and can fine-tune with SAT + impulse. */
+    PROF_BEGIN("sim.collisions.ccd");
     {
         /* Speed threshold: only bother with CCD if the entity moves more than
          * half its bounding radius this tick — below that, discrete is fine. */
@@ -908,24 +911,42 @@ void sim_handle_collisions(struct Sim* sim) {
             }
         }
     }
+    PROF_END();
 
     // Handle ship-to-ship collisions
+    PROF_BEGIN("sim.collisions.ship_ship");
     handle_ship_collisions(sim);
+    PROF_END();
     
     // Handle ship-to-island collisions
+    PROF_BEGIN("sim.collisions.island");
     handle_island_collisions(sim);
+    PROF_END();
     
     // Handle player-to-player collisions
+    PROF_BEGIN("sim.collisions.player_player");
     handle_player_player_collisions(sim);
+    PROF_END();
 
     // Handle player-to-boulder collisions
+    PROF_BEGIN("sim.collisions.player_boulder");
     handle_player_boulder_collisions(sim);
+    PROF_END();
     
+    // Grapple ropes: solved after every push-out so the rope wins the tie
+    PROF_BEGIN("sim.collisions.ropes");
+    sim_solve_ropes(sim);
+    PROF_END();
+
     // Handle projectile collisions with ships and players
+    PROF_BEGIN("sim.collisions.projectile");
     handle_projectile_collisions(sim);
+    PROF_END();
     
     // Handle player-ship collisions (boarding, falling off)
+    PROF_BEGIN("sim.collisions.player_ship");
     handle_player_ship_collisions(sim);
+    PROF_END();
 
     /* Age out stale contact cache entries that weren't touched this tick */
     contact_cache_age(&sim->contact_cache, sim->tick);
@@ -1068,6 +1089,7 @@ entity_id sim_create_ship(struct Sim* sim, Vec2Q16 position, q16_t rotation,
     // After scaling: bow/stern 1.02x X, all 1.1x Y → max ~423 x, 99 y
     // Max distance from center is sqrt(423^2 + 99^2) ≈ 434.5 client units = 43.45 server units
     ship->bounding_radius = Q16_FROM_FLOAT(CLIENT_TO_SERVER(435.0f)); // Conservative bounding radius
+    hull_sdf_bake(ship);  // Shared per hull shape; baked by the first ship of its type
     
     // Initialize BROADSIDE loadout modules
     // Matches BrigantineLoadouts.BROADSIDE from BrigantineTestBuilder.ts
@@ -1325,8 +1347,99 @@ struct Projectile* sim_get_projectile(struct Sim* sim, entity_id id) {
     return sim_find_projectile_sorted(sim, id);
 }
 
+/* ── Rope constraints ──────────────────────────────────────────────────────── */
+
+void sim_ropes_clear(struct Sim* sim) {
+    if (sim) sim->rope_count = 0;
+}
+
+bool sim_rope_add(struct Sim* sim, const struct RopeConstraint* rope) {
+    if (!sim || !rope || sim->rope_count >= MAX_ROPES) return false;
+    sim->ropes[sim->rope_count++] = *rope;
+    return true;
+}
+
+/* Ropes resolved to bodies once per step; lookups are binary searches, so
+ * doing them per iteration would dominate the solve. */
+typedef struct {
+    struct Player* body;
+    const struct Ship* ship;      /* ROPE_ANCHOR_SHIP   */
+    const struct Player* anchor;  /* ROPE_ANCHOR_PLAYER */
+    float ax, ay;                 /* World anchor (server units) */
+    float len;
+} RopeSolve;
+
+/* Projected Gauss-Seidel over all ropes.  Each rope is a one-sided distance
+ * limit: a taut rope puts the body back on the circle of radius `length`
+ * around its anchor and strips the outward part of its velocity; a slack
+ * rope does nothing.  Ropes sharing a body (two hooks, or a player hanging
+ * off someone else's rope) converge over ROPE_ITERATIONS sweeps instead of
+ * the last writer winning. */
+void sim_solve_ropes(struct Sim* sim) {
+    if (!sim || sim->rope_count == 0) return;
+
+    static RopeSolve rs[MAX_ROPES];
+    uint16_t n = 0;
+    for (uint16_t i = 0; i < sim->rope_count; i++) {
+        const struct RopeConstraint* rc = &sim->ropes[i];
+        struct Player* body = sim_find_player_sorted(sim, rc->body);
+        if (!body || body->ship_id != 0) continue;  /* Boarded: pinned to deck */
+
+        RopeSolve* r = &rs[n];
+        r->body = body;
+        r->ship = NULL;
+        r->anchor = NULL;
+        r->len = Q16_TO_FLOAT(rc->length);
+        if (r->len < 0.0f) r->len = 0.0f;
+
+        if (rc->anchor_kind == ROPE_ANCHOR_SHIP) {
+            r->ship = sim_find_ship_sorted(sim, rc->anchor_id);
+            if (!r->ship) continue;
+            Vec2Q16 w = transform_hull_vertex(rc->anchor_pos, r->ship->position, r->ship->rotation);
+            r->ax = Q16_TO_FLOAT(w.x);
+            r->ay = Q16_TO_FLOAT(w.y);
+        } else if (rc->anchor_kind == ROPE_ANCHOR_PLAYER) {
+            r->anchor = sim_find_player_sorted(sim, rc->anchor_id);
+            if (!r->anchor || r->anchor == body) continue;
+        } else {
+            r->ax = Q16_TO_FLOAT(rc->anchor_pos.x);
+            r->ay = Q16_TO_FLOAT(rc->anchor_pos.y);
+        }
+        n++;
+    }
+
+    for (int it = 0; it < ROPE_ITERATIONS; it++) {
+        for (uint16_t i = 0; i < n; i++) {
+            RopeSolve* r = &rs[i];
+            struct Player* p = r->body;
+            if (r->anchor) {
+                /* Re-read: the anchor player may itself be on a rope */
+                r->ax = Q16_TO_FLOAT(r->anchor->position.x);
+                r->ay = Q16_TO_FLOAT(r->anchor->position.y);
+            }
+            float dx = Q16_TO_FLOAT(p->position.x) - r->ax;
+            float dy = Q16_TO_FLOAT(p->position.y) - r->ay;
+            float d2 = dx * dx + dy * dy;
+            if (d2 <= r->len * r->len || d2 < 1e-8f) continue;
+
+            float d = sqrtf(d2);
+            float nx = dx / d, ny = dy / d;
+            p->position.x = Q16_FROM_FLOAT(r->ax + nx * r->len);
+            p->position.y = Q16_FROM_FLOAT(r->ay + ny * r->len);
+
+            float vn = Q16_TO_FLOAT(p->velocity.x) * nx + Q16_TO_FLOAT(p->velocity.y) * ny;
+            if (vn > 0.0f) {
+                p->velocity.x = Q16_FROM_FLOAT(Q16_TO_FLOAT(p->velocity.x) - vn * nx);
+                p->velocity.y = Q16_FROM_FLOAT(Q16_TO_FLOAT(p->velocity.y) - vn * ny);
+            }
+        }
+    }
+}
+
 void sim_process_input(struct Sim* sim, const struct InputCmd* cmd) {
     if (!sim || !cmd) return;
+
+    replay_record_input(sim, cmd);
     
     struct Player* player = sim_get_player(sim, cmd->player_id);
     if (!player) return;
@@ -2365,6 +2478,7 @@ void handle_projectile_collisions(struct Sim* sim) {
                             * ship_level_resistance_mult(&ship->level_stats)
                         );
                         module_apply_damage(hit_mod, effective_damage);
+                        ship->module_epoch++;
                         damage_dealt = dmg_before - (float)hit_mod->health;
                         if (damage_dealt < 0) damage_dealt = 0;
 
@@ -2393,6 +2507,7 @@ void handle_projectile_collisions(struct Sim* sim) {
                         fh -= fiber_dmg;
                         if (fh < 0.0f) fh = 0.0f;
                         hit_mod->data.mast.fiber_health = Q16_FROM_FLOAT(fh);
+                        ship->module_epoch++;
 
                         // wind_efficiency tracks fiber HP ratio (0.0 at destroyed, 1.0 at full)
                         float new_eff = fh / fhmax;
@@ -2545,6 +2660,7 @@ void handle_projectile_collisions(struct Sim* sim) {
                             Q16_TO_FLOAT(proj->damage)
                             * ship_level_resistance_mult(&ship->level_stats));
                         module_apply_damage(hit_plank, effective_damage);
+                        ship->module_epoch++;
                         float plank_damage_dealt = plank_hp_before - (float)hit_plank->health;
                         if (plank_damage_dealt < 0) plank_damage_dealt = 0;
 
@@ -2656,6 +2772,7 @@ void handle_projectile_collisions(struct Sim* sim) {
                             Q16_TO_FLOAT(proj->damage)
                             * ship_level_resistance_mult(&ship->level_stats));
                         module_apply_damage(deck, eff_dmg);
+                        ship->module_epoch++;
                         float deck_dmg = dmg_before - (float)deck->health;
                         if (deck_dmg < 0) deck_dmg = 0;
 
@@ -2779,6 +2896,7 @@ void handle_projectile_collisions(struct Sim* sim) {
                         * ship_level_resistance_mult(&ship->level_stats)
                     );
                     module_apply_damage(hit_mod, effective_damage);
+                    ship->module_epoch++;
                     float damage_dealt = dmg_before - (float)hit_mod->health;
                     if (damage_dealt < 0) damage_dealt = 0;
 
@@ -2914,9 +3032,13 @@ static void handle_player_boulder_collisions(struct Sim* sim) {
 
         for (int ii = 0; ii < ISLAND_COUNT; ii++) {
             const IslandDef *isl = &ISLAND_PRESETS[ii];
-            for (int ri = 0; ri < isl->resource_count; ri++) {
-                const IslandResource *res = &isl->resources[ri];
-                if (res->type_id != RES_BOULDER && res->type_id != RES_STONE_BOULDER) continue;
+            static IslandResourceNear near;
+            /* Widest ellipse axis is 1.35 × base × size */
+            island_resources_near(&near, isl, px_cli, py_cli,
+                                  pr_cli + BOULDER_BASE_R * 1.35f * isl->grid_max_size,
+                                  RES_MASK(RES_BOULDER) | RES_MASK(RES_STONE_BOULDER));
+            for (uint32_t k = 0; k < near.count; k++) {
+                const IslandResource *res = &isl->resources[near.ri[k]];
                 if (res->health <= 0) continue;
 
                 float bx_cli = isl->x + res->ox;
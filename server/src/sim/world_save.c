@@ -32,10 +32,13 @@
 #include "sim/ship_level.h"
 #include "net/websocket_server_internal.h"
 #include "net/npc_world.h"
+#include "net/structure_index.h"
 #include "net/module_interactions.h"
 #include "sim/island.h"
 #include "sim/module_types.h"
 #include "util/log.h"
+#include "util/time.h"
+#include "util/metrics.h"
 
 /* ── Tiny JSON helpers ─────────────────────────────────────────────────────── */
 
@@ -97,6 +100,15 @@ static bool ws_json_str(const char *json, const char *key,
 int world_save(const char *path) {
     if (!path) path = WORLD_SAVE_DEFAULT_PATH;
 
+    static metric_id m_save_duration;
+    if (!m_save_duration) {
+        static const uint64_t bounds_us[] = { 10000, 50000, 100000, 250000, 500000, 1000000, 2500000, 5000000 };
+        m_save_duration = metrics_histogram("pirate_world_save_seconds",
+            "Time to write the world save file.", NULL,
+            bounds_us, (int)(sizeof(bounds_us) / sizeof(bounds_us[0])), 1e-6);
+    }
+    uint64_t save_t0 = get_time_us();
+
     /* Ensure parent directories exist */
     mkdir("data",       0755);
     mkdir("data/saves", 0755);
@@ -116,7 +128,9 @@ int world_save(const char *path) {
     int active_npcs = 0;
     for (int i = 0; i < world_npc_count; i++)
         if (world_npcs[i].active) active_npcs++;
-    int active_structs = (int)placed_structure_count;
+    uint32_t live_structs;
+    (void)structure_live_slots(&live_structs);
+    int active_structs = (int)live_structs;
 
     /* ── meta ── */
     fprintf(f,
@@ -567,8 +581,10 @@ int world_save(const char *path) {
             fclose(fc);
         }
     }
-    log_info("💾 World saved to '%s' (%d ships, %d NPCs, %d structures)",
-             path, active_ships, active_npcs, active_structs);
+    uint64_t save_us = get_time_us() - save_t0;
+    metrics_observe(m_save_duration, save_us);
+    log_info("💾 World saved to '%s' (%d ships, %d NPCs, %d structures) in %llu ms",
+             path, active_ships, active_npcs, active_structs, (unsigned long long)(save_us / 1000));
     return 0;
 }
 
@@ -850,7 +866,9 @@ int world_load(const char *path) {
                                         bool dup = false;
                                         for (uint8_t di = 0; di < s->module_count; di++) {
                                             if (s->modules[di].id == new_mid) {
-                                                s->modules[di] = new_mod; dup = true; break;
+                                                s->modules[di] = new_mod; dup = true;
+                                                ship_module_grid_invalidate(&s->module_grid);
+                                                break;
                                             }
                                         }
                                         if (!dup && s->module_count < MAX_MODULES_PER_SHIP)
@@ -942,6 +960,7 @@ int world_load(const char *path) {
                                 }
                                 free(wgobj);
                             }
+                            weapon_groups_changed(s);
                         }
                         /* Restore ship workbench schematic pool */
                         s->ship_schematic_count = 0;
@@ -1100,6 +1119,8 @@ int world_load(const char *path) {
                             mod->state_bits |= MODULE_STATE_OCCUPIED;
                             /* deck_id 0xFF = deck-independent (e.g. mast); treat as upper */
                             n->deck_level = (mod->deck_id != 0xFF) ? mod->deck_id : 1;
+                            if (n->role == NPC_ROLE_GUNNER && n->state == WORLD_NPC_STATE_AT_GUN)
+                                npc_gunner_index_set(n, ss);
                             log_info("🤖 NPC %u restored to module %u on ship %u (deck %u)",
                                      n->id, n->assigned_weapon_id, n->ship_id, (unsigned)n->deck_level);
                         }
@@ -1253,6 +1274,7 @@ int world_load(const char *path) {
                 free(obj);
             }
         }
+        structure_index_rebuild();
     }
 
     /* ── island_resources ── */
@@ -1285,10 +1307,9 @@ int world_load(const char *path) {
                             if ((int)idx < isl->resource_count) {
                                 isl->resources[idx].health = (int)health;
                                 isl->resources[idx].respawn_at_ms = respawn_at;
-                                /* Rebuild alive_wood: remove depleted trees from the list */
-                                if (health == 0 && isl->resources[idx].type_id == RES_WOOD) {
-                                    island_mark_tree_dead(isl, (int)idx);
-                                }
+                                /* Keep the resource grid to the loaded health */
+                                if (health == 0) island_mark_resource_dead(isl, (int)idx);
+                                else             island_mark_resource_alive(isl, (int)idx);
                             }
                             free(robj);
                         }
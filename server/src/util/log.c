@@ -1,60 +1,503 @@
+#define _POSIX_C_SOURCE 200809L
 #include "util/log.h"
 #include <stdio.h>
 #include <time.h>
 #include <string.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdatomic.h>
+#include <pthread.h>
 
 static log_level_t current_min_level = LOG_LEVEL_INFO;
 
-// Use __attribute__((unused)) to suppress unused variable warning  
+// Use __attribute__((unused)) to suppress unused variable warning
 static const char* level_names[] __attribute__((unused)) = {
-    "DEBUG", "INFO", "WARN", "ERROR"  
+    "DEBUG", "INFO", "WARN", "ERROR"
 };
 
 // Use __attribute__((unused)) to suppress unused variable warning
 static const char* level_colors[] __attribute__((unused)) = {
     "\033[36m", // Cyan for DEBUG
-    "\033[32m", // Green for INFO  
+    "\033[32m", // Green for INFO
     "\033[33m", // Yellow for WARN
     "\033[31m"  // Red for ERROR
 };
 
+/* ── Captured record layout ──────────────────────────────────────────────── */
+
+typedef enum {
+    LOG_ARG_INT = 0,
+    LOG_ARG_UINT,
+    LOG_ARG_DOUBLE,
+    LOG_ARG_PTR,
+    LOG_ARG_STR
+} log_arg_type_t;
+
+typedef struct {
+    uint8_t type;
+    union {
+        long long          i;
+        unsigned long long u;
+        double             d;
+        const void*        p;
+        uint16_t           str_off;   /* Offset into LogRecord.strbuf */
+    } v;
+} LogArg;
+
+typedef struct {
+    _Atomic uint32_t seq;           /* Vyukov sequence: pos = free, pos+1 = full */
+    uint8_t     level;
+    uint8_t     argc;
+    bool        truncated;          /* Ran out of arg slots / string space */
+    uint16_t    str_used;
+    int         line;
+    uint32_t    suppressed;         /* Callsite records skipped before this one */
+    time_t      when;
+    const char* file;
+    const char* fmt;
+    LogArg      args[LOG_RECORD_MAX_ARGS];
+    char        strbuf[LOG_RECORD_STR_BYTES];
+} LogRecord;
+
+#define LOG_RING_MASK (LOG_RING_CAPACITY - 1)
+
+static LogRecord        g_ring[LOG_RING_CAPACITY];
+static _Atomic uint32_t g_enqueue_pos;
+static _Atomic uint32_t g_dequeue_pos;     /* Written by the drain thread only */
+
+static _Atomic bool     g_async_running;
+static _Atomic bool     g_drain_stop;
+static pthread_t        g_drain_thread;
+static FILE*            g_out;
+
+/* Cached wall clock — refreshed once per tick by log_tick(). */
+static _Atomic long long g_clock_sec;
+static _Atomic bool      g_clock_running;
+
+static _Atomic uint64_t g_stat_enqueued;
+static _Atomic uint64_t g_stat_written;
+static _Atomic uint64_t g_stat_dropped;
+static _Atomic uint64_t g_stat_suppressed;
+
+static FILE* log_out(void) {
+    return g_out ? g_out : stdout;
+}
+
+/* ── printf spec parsing (shared by capture and deferred formatting) ────── */
+
+typedef struct {
+    const char* start;      /* Points at '%' */
+    size_t      len;        /* Full spec length including conversion char */
+    size_t      body_len;   /* Flags/width/precision chars after '%' */
+    int         n_star;     /* '*' width and/or precision arguments */
+    bool        prec_star;  /* Precision comes from an argument */
+    int         precision;  /* Literal precision, -1 if absent or '*' */
+    char        length[3];
+    char        conv;
+} FmtSpec;
+
+static const char* parse_spec(const char* p, FmtSpec* s) {
+    memset(s, 0, sizeof(*s));
+    s->start = p++;
+    s->precision = -1;
+    while (*p && strchr("-+ #0", *p)) p++;
+    if (*p == '*') { s->n_star++; p++; }
+    else while (*p >= '0' && *p <= '9') p++;
+    if (*p == '.') {
+        p++;
+        if (*p == '*') { s->n_star++; s->prec_star = true; p++; }
+        else {
+            s->precision = 0;
+            while (*p >= '0' && *p <= '9') s->precision = s->precision * 10 + (*p++ - '0');
+        }
+    }
+    s->body_len = (size_t)(p - s->start) - 1;
+    int li = 0;
+    while (*p && strchr("hlLqjzt", *p) && li < 2) s->length[li++] = *p++;
+    s->conv = *p;
+    if (*p) p++;
+    s->len = (size_t)(p - s->start);
+    return p;
+}
+
+static bool push_arg(LogRecord* rec, uint8_t type) {
+    if (rec->argc >= LOG_RECORD_MAX_ARGS) {
+        rec->truncated = true;
+        return false;
+    }
+    rec->args[rec->argc].type = type;
+    return true;
+}
+
+static void capture_string(LogRecord* rec, const char* s, int max_len) {
+    if (!s) s = "(null)";
+    size_t room = LOG_RECORD_STR_BYTES - rec->str_used;
+    if (room == 0) {
+        rec->truncated = true;
+        rec->args[rec->argc].v.str_off = LOG_RECORD_STR_BYTES - 1;
+        return;
+    }
+    size_t limit = room - 1;
+    if (max_len >= 0 && (size_t)max_len < limit) limit = (size_t)max_len;
+    size_t n = strnlen(s, limit);
+    if (n == limit && s[n] != '\0' && (max_len < 0 || (size_t)max_len > limit))
+        rec->truncated = true;
+    memcpy(rec->strbuf + rec->str_used, s, n);
+    rec->strbuf[rec->str_used + n] = '\0';
+    rec->args[rec->argc].v.str_off = rec->str_used;
+    rec->str_used = (uint16_t)(rec->str_used + n + 1);
+}
+
+/* Walk fmt and copy every argument by its conversion type.  Strings are
+ * copied inline because callers routinely pass stack buffers. */
+static void capture_args(LogRecord* rec, const char* fmt, va_list ap) {
+    rec->argc = 0;
+    rec->str_used = 0;
+    rec->truncated = false;
+    rec->strbuf[LOG_RECORD_STR_BYTES - 1] = '\0';
+
+    for (const char* p = fmt; *p; ) {
+        if (*p != '%') { p++; continue; }
+        if (p[1] == '%') { p += 2; continue; }
+        FmtSpec s;
+        p = parse_spec(p, &s);
+
+        int last_star = -1;
+        for (int k = 0; k < s.n_star; k++) {
+            last_star = va_arg(ap, int);
+            if (!push_arg(rec, LOG_ARG_INT)) return;
+            rec->args[rec->argc++].v.i = last_star;
+        }
+
+        const char* l = s.length;
+        switch (s.conv) {
+            case 'd': case 'i':
+                if (!push_arg(rec, LOG_ARG_INT)) return;
+                if (!strcmp(l, "ll") || !strcmp(l, "q")) rec->args[rec->argc].v.i = va_arg(ap, long long);
+                else if (!strcmp(l, "l")) rec->args[rec->argc].v.i = va_arg(ap, long);
+                else if (!strcmp(l, "z")) rec->args[rec->argc].v.i = (long long)va_arg(ap, size_t);
+                else if (!strcmp(l, "j")) rec->args[rec->argc].v.i = (long long)va_arg(ap, intmax_t);
+                else if (!strcmp(l, "t")) rec->args[rec->argc].v.i = (long long)va_arg(ap, ptrdiff_t);
+                else rec->args[rec->argc].v.i = va_arg(ap, int);
+                rec->argc++;
+                break;
+            case 'u': case 'o': case 'x': case 'X':
+                if (!push_arg(rec, LOG_ARG_UINT)) return;
+                if (!strcmp(l, "ll") || !strcmp(l, "q")) rec->args[rec->argc].v.u = va_arg(ap, unsigned long long);
+                else if (!strcmp(l, "l")) rec->args[rec->argc].v.u = va_arg(ap, unsigned long);
+                else if (!strcmp(l, "z")) rec->args[rec->argc].v.u = va_arg(ap, size_t);
+                else if (!strcmp(l, "j")) rec->args[rec->argc].v.u = va_arg(ap, uintmax_t);
+                else if (!strcmp(l, "t")) rec->args[rec->argc].v.u = (unsigned long long)va_arg(ap, ptrdiff_t);
+                else if (!strcmp(l, "hh")) rec->args[rec->argc].v.u = (unsigned char)va_arg(ap, unsigned int);
+                else if (!strcmp(l, "h")) rec->args[rec->argc].v.u = (unsigned short)va_arg(ap, unsigned int);
+                else rec->args[rec->argc].v.u = va_arg(ap, unsigned int);
+                rec->argc++;
+                break;
+            case 'c':
+                if (!push_arg(rec, LOG_ARG_INT)) return;
+                rec->args[rec->argc++].v.i = va_arg(ap, int);
+                break;
+            case 'e': case 'E': case 'f': case 'F':
+            case 'g': case 'G': case 'a': case 'A':
+                if (!push_arg(rec, LOG_ARG_DOUBLE)) return;
+                if (s.length[0] == 'L') rec->args[rec->argc].v.d = (double)va_arg(ap, long double);
+                else rec->args[rec->argc].v.d = va_arg(ap, double);
+                rec->argc++;
+                break;
+            case 's': {
+                if (!push_arg(rec, LOG_ARG_STR)) return;
+                int max_len = s.prec_star ? last_star : s.precision;
+                capture_string(rec, va_arg(ap, const char*), max_len);
+                rec->argc++;
+                break;
+            }
+            case 'p': case 'n':
+                if (!push_arg(rec, LOG_ARG_PTR)) return;
+                rec->args[rec->argc++].v.p = va_arg(ap, void*);
+                break;
+            default:
+                /* Unknown conversion — can't know the argument size, stop here */
+                rec->truncated = true;
+                return;
+        }
+    }
+}
+
+/* Re-run the format against the captured args, one conversion at a time. */
+static size_t format_record(const LogRecord* rec, char* out, size_t cap) {
+    size_t off = 0;
+    int ai = 0;
+    out[0] = '\0';
+
+    for (const char* p = rec->fmt; *p && off + 1 < cap; ) {
+        if (*p != '%') { out[off++] = *p++; continue; }
+        if (p[1] == '%') { out[off++] = '%'; p += 2; continue; }
+        FmtSpec s;
+        p = parse_spec(p, &s);
+        if (s.conv == 'n') { ai++; continue; }
+        if (ai + s.n_star >= rec->argc) break;   /* Args were truncated at capture */
+
+        int star[2] = {0, 0};
+        for (int k = 0; k < s.n_star; k++) star[k] = (int)rec->args[ai++].v.i;
+        const LogArg* a = &rec->args[ai++];
+
+        char spec[32];
+        size_t body = s.body_len < sizeof(spec) - 5 ? s.body_len : sizeof(spec) - 5;
+        spec[0] = '%';
+        memcpy(spec + 1, s.start + 1, body);
+        size_t sl = body + 1;
+        if (a->type == LOG_ARG_INT && s.conv != 'c') { spec[sl++] = 'l'; spec[sl++] = 'l'; }
+        if (a->type == LOG_ARG_UINT) { spec[sl++] = 'l'; spec[sl++] = 'l'; }
+        spec[sl++] = s.conv;
+        spec[sl] = '\0';
+
+        int n = 0;
+        size_t room = cap - off;
+#define LOG_EMIT(val) \
+        switch (s.n_star) { \
+            case 0:  n = snprintf(out + off, room, spec, val); break; \
+            case 1:  n = snprintf(out + off, room, spec, star[0], val); break; \
+            default: n = snprintf(out + off, room, spec, star[0], star[1], val); break; \
+        }
+        switch (a->type) {
+            case LOG_ARG_INT:
+                if (s.conv == 'c') { int c = (int)a->v.i; LOG_EMIT(c); }
+                else { LOG_EMIT(a->v.i); }
+                break;
+            case LOG_ARG_UINT:   LOG_EMIT(a->v.u); break;
+            case LOG_ARG_DOUBLE: LOG_EMIT(a->v.d); break;
+            case LOG_ARG_PTR:    LOG_EMIT(a->v.p); break;
+            case LOG_ARG_STR: {
+                const char* str = rec->strbuf + a->v.str_off;
+                LOG_EMIT(str);
+                break;
+            }
+        }
+#undef LOG_EMIT
+        if (n < 0) break;
+        off += (size_t)n < room ? (size_t)n : room - 1;
+    }
+    out[off] = '\0';
+    return off;
+}
+
+static const char* base_name(const char* file) {
+    const char* filename = strrchr(file, '/');
+    return filename ? filename + 1 : file;
+}
+
+static void write_line(FILE* out, log_level_t level, time_t when, const char* file, int line,
+                       const char* msg, uint32_t suppressed, bool truncated) {
+    /* Cache the last converted second so localtime_r runs at most once a
+     * second on the drain thread rather than once per line. */
+    static __thread time_t    cached_when = (time_t)-1;
+    static __thread struct tm cached_tm;
+    if (when != cached_when) {
+        localtime_r(&when, &cached_tm);
+        cached_when = when;
+    }
+    fprintf(out, "%s[%02d:%02d:%02d %s:%d] %s%s",
+            level_colors[level],
+            cached_tm.tm_hour, cached_tm.tm_min, cached_tm.tm_sec,
+            base_name(file), line, msg, truncated ? "…" : "");
+    if (suppressed)
+        fprintf(out, " (+%u suppressed)", suppressed);
+    fputs("\033[0m\n", out);
+}
+
+/* ── Drain thread ───────────────────────────────────────────────────────── */
+
+static uint32_t drain_batch(FILE* out) {
+    uint32_t n = 0;
+    uint32_t pos = atomic_load_explicit(&g_dequeue_pos, memory_order_relaxed);
+    char msg[1024];
+
+    for (;;) {
+        LogRecord* rec = &g_ring[pos & LOG_RING_MASK];
+        uint32_t seq = atomic_load_explicit(&rec->seq, memory_order_acquire);
+        if ((int32_t)(seq - (pos + 1)) < 0) break;   /* Empty (or still being written) */
+
+        format_record(rec, msg, sizeof(msg));
+        write_line(out, (log_level_t)rec->level, rec->when, rec->file, rec->line,
+                   msg, rec->suppressed, rec->truncated);
+
+        atomic_store_explicit(&rec->seq, pos + LOG_RING_CAPACITY, memory_order_release);
+        pos++;
+        n++;
+        atomic_store_explicit(&g_dequeue_pos, pos, memory_order_release);
+    }
+    if (n) atomic_fetch_add_explicit(&g_stat_written, n, memory_order_relaxed);
+    return n;
+}
+
+static void report_drops(FILE* out, uint64_t* reported) {
+    uint64_t dropped = atomic_load_explicit(&g_stat_dropped, memory_order_relaxed);
+    if (dropped != *reported) {
+        fprintf(out, "%s[log] %llu records dropped (ring full)\033[0m\n",
+                level_colors[LOG_LEVEL_WARN], (unsigned long long)(dropped - *reported));
+        *reported = dropped;
+    }
+}
+
+static void* log_drain_main(void* arg) {
+    (void)arg;
+    uint64_t reported_drops = 0;
+    const struct timespec idle = { .tv_sec = 0, .tv_nsec = 2 * 1000 * 1000 };
+
+    while (!atomic_load_explicit(&g_drain_stop, memory_order_acquire)) {
+        FILE* out = log_out();
+        uint32_t n = drain_batch(out);
+        report_drops(out, &reported_drops);
+        if (n) fflush(out);
+        else nanosleep(&idle, NULL);
+    }
+    FILE* out = log_out();
+    drain_batch(out);
+    report_drops(out, &reported_drops);
+    fflush(out);
+    return NULL;
+}
+
+/* ── Public API ─────────────────────────────────────────────────────────── */
+
 void log_init(log_level_t min_level) {
     current_min_level = min_level;
+    if (atomic_load(&g_async_running)) return;
+
+    for (uint32_t i = 0; i < LOG_RING_CAPACITY; i++)
+        atomic_store_explicit(&g_ring[i].seq, i, memory_order_relaxed);
+    atomic_store(&g_enqueue_pos, 0);
+    atomic_store(&g_dequeue_pos, 0);
+    atomic_store(&g_drain_stop, false);
+
+    if (pthread_create(&g_drain_thread, NULL, log_drain_main, NULL) != 0) {
+        /* Stay synchronous — still better than no logging at all */
+        fprintf(log_out(), "[log] failed to start drain thread, logging synchronously\n");
+        return;
+    }
+    atomic_store(&g_async_running, true);
+}
+
+void log_shutdown(void) {
+    if (!atomic_load(&g_async_running)) return;
+    /* Flip producers to the synchronous path first, then let the drain
+     * thread empty the ring before it exits. */
+    atomic_store(&g_async_running, false);
+    atomic_store(&g_drain_stop, true);
+    pthread_join(g_drain_thread, NULL);
+    drain_batch(log_out());
+    fflush(log_out());
 }
 
-void log_message(log_level_t level, const char* file, int line, const char* fmt, ...) {
+void log_set_output(FILE* out) {
+    g_out = out;
+}
+
+void log_tick(void) {
+    atomic_store_explicit(&g_clock_sec, (long long)time(NULL), memory_order_relaxed);
+    atomic_store_explicit(&g_clock_running, true, memory_order_relaxed);
+}
+
+void log_flush(void) {
+    if (!atomic_load(&g_async_running)) {
+        fflush(log_out());
+        return;
+    }
+    const struct timespec wait = { .tv_sec = 0, .tv_nsec = 1000 * 1000 };
+    uint32_t target = atomic_load_explicit(&g_enqueue_pos, memory_order_acquire);
+    while ((int32_t)(atomic_load_explicit(&g_dequeue_pos, memory_order_acquire) - target) < 0 &&
+           atomic_load(&g_async_running)) {
+        nanosleep(&wait, NULL);
+    }
+}
+
+void log_get_stats(struct LogStats* out) {
+    if (!out) return;
+    out->enqueued   = atomic_load_explicit(&g_stat_enqueued, memory_order_relaxed);
+    out->written    = atomic_load_explicit(&g_stat_written, memory_order_relaxed);
+    out->dropped    = atomic_load_explicit(&g_stat_dropped, memory_order_relaxed);
+    out->suppressed = atomic_load_explicit(&g_stat_suppressed, memory_order_relaxed);
+    out->queued     = atomic_load_explicit(&g_enqueue_pos, memory_order_relaxed) -
+                      atomic_load_explicit(&g_dequeue_pos, memory_order_relaxed);
+}
+
+/* Returns false if the callsite is over its per-second budget.  Counters are
+ * updated with relaxed atomics — a callsite shared by two threads may let a
+ * record or two over the limit, which is fine for a log throttle. */
+static bool site_admit(struct LogSite* site, uint32_t now_sec, uint32_t* carried) {
+    *carried = 0;
+    if (!site || !atomic_load_explicit(&g_clock_running, memory_order_relaxed)) return true;
+
+    if (__atomic_load_n(&site->window_sec, __ATOMIC_RELAXED) != now_sec) {
+        __atomic_store_n(&site->window_sec, now_sec, __ATOMIC_RELAXED);
+        __atomic_store_n(&site->emitted, 0, __ATOMIC_RELAXED);
+    }
+    if (__atomic_fetch_add(&site->emitted, 1, __ATOMIC_RELAXED) >= LOG_SITE_MAX_PER_SEC) {
+        __atomic_fetch_add(&site->suppressed, 1, __ATOMIC_RELAXED);
+        atomic_fetch_add_explicit(&g_stat_suppressed, 1, memory_order_relaxed);
+        return false;
+    }
+    *carried = __atomic_exchange_n(&site->suppressed, 0, __ATOMIC_RELAXED);
+    return true;
+}
+
+void log_message(log_level_t level, struct LogSite* site, const char* file, int line,
+                 const char* fmt, ...) {
     if (level < current_min_level) {
         return;
     }
-    
-    // Get current time
-    time_t now = time(NULL);
-    struct tm* local_time = localtime(&now);
-    
-    // Extract filename from path
-    const char* filename = strrchr(file, '/');
-    if (filename) {
-        filename++; // Skip the '/'
-    } else {
-        filename = file;
-    }
-    
-    // Print timestamp and level
-    printf("%s[%02d:%02d:%02d %s:%d] ",
-           level_colors[level],
-           local_time->tm_hour,
-           local_time->tm_min, 
-           local_time->tm_sec,
-           filename,
-           line);
-    
-    // Print the actual message
+
+    time_t now = atomic_load_explicit(&g_clock_running, memory_order_relaxed)
+        ? (time_t)atomic_load_explicit(&g_clock_sec, memory_order_relaxed)
+        : time(NULL);
+
+    uint32_t carried = 0;
+    if (level < LOG_LEVEL_ERROR && !site_admit(site, (uint32_t)now, &carried)) return;
+
+    if (!atomic_load_explicit(&g_async_running, memory_order_acquire)) {
+        /* Synchronous path: before log_init / after log_shutdown, and in
+         * tools/tests that never start the backend. */
+        char msg[1024];
+        va_list args;
+        va_start(args, fmt);
+        vsnprintf(msg, sizeof(msg), fmt, args);
+        va_end(args);
+        write_line(log_out(), level, now, file, line, msg, carried, false);
+        fflush(log_out());
+        return;
+    }
+
+    /* Claim a slot (Vyukov bounded MPSC enqueue) */
+    uint32_t pos = atomic_load_explicit(&g_enqueue_pos, memory_order_relaxed);
+    LogRecord* rec;
+    for (;;) {
+        rec = &g_ring[pos & LOG_RING_MASK];
+        uint32_t seq = atomic_load_explicit(&rec->seq, memory_order_acquire);
+        int32_t diff = (int32_t)(seq - pos);
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&g_enqueue_pos, &pos, pos + 1,
+                                                      memory_order_relaxed,
+                                                      memory_order_relaxed))
+                break;
+        } else if (diff < 0) {
+            atomic_fetch_add_explicit(&g_stat_dropped, 1, memory_order_relaxed);
+            return;
+        } else {
+            pos = atomic_load_explicit(&g_enqueue_pos, memory_order_relaxed);
+        }
+    }
+
+    rec->level      = (uint8_t)level;
+    rec->file       = file;
+    rec->line       = line;
+    rec->fmt        = fmt;
+    rec->when       = now;
+    rec->suppressed = carried;
     va_list args;
     va_start(args, fmt);
-    vprintf(fmt, args);
+    capture_args(rec, fmt, args);
     va_end(args);
-    
-    // Reset color and newline
-    printf("\033[0m\n");
-    fflush(stdout);
-}
\ No newline at end of file
+
+    atomic_store_explicit(&rec->seq, pos + 1, memory_order_release);
+    atomic_fetch_add_explicit(&g_stat_enqueued, 1, memory_order_relaxed);
+}
@@ -0,0 +1,214 @@
+#define _POSIX_C_SOURCE 200809L
+#include "util/metrics.h"
+#include "util/log.h"
+#include <string.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+typedef enum {
+    METRIC_COUNTER = 0,
+    METRIC_GAUGE,
+    METRIC_HISTOGRAM
+} metric_type_t;
+
+struct Metric {
+    const char*   name;
+    const char*   help;
+    const char*   labels;
+    metric_type_t type;
+    uint16_t      cell;          /* First cell; histograms use bound_count + 2 */
+    uint8_t       bound_count;
+    double        scale;
+    uint64_t      bounds[METRICS_MAX_BUCKETS];
+};
+
+/* Histogram cell layout: [0..bound_count] per-bucket counts (last = +Inf),
+ * then the running sum. */
+
+static pthread_mutex_t g_metrics_mtx = PTHREAD_MUTEX_INITIALIZER;
+static struct Metric   g_metrics[METRICS_MAX + 1];     /* id 0 unused */
+static int             g_metric_count = 1;
+static int             g_cells_used = 0;
+static metrics_collector_fn g_collectors[METRICS_MAX_COLLECTORS];
+static int             g_collector_count = 0;
+
+static _Atomic uint64_t g_cells[METRICS_SHARDS][METRICS_MAX_CELLS];
+static atomic_int       g_next_shard = 0;
+static __thread int     t_shard = -1;
+
+#define METRICS_SHARED_SHARD (METRICS_SHARDS - 1)
+
+/* ── Registration ────────────────────────────────────────────────────────── */
+
+static metric_id metrics_register(const char* name, const char* help, const char* labels,
+                                  metric_type_t type, const uint64_t* bounds, int bound_count,
+                                  double scale) {
+    if (bound_count > METRICS_MAX_BUCKETS) bound_count = METRICS_MAX_BUCKETS;
+    int cells = type == METRIC_HISTOGRAM ? bound_count + 2 : 1;
+
+    metric_id id = 0;
+    pthread_mutex_lock(&g_metrics_mtx);
+    if (g_metric_count <= METRICS_MAX && g_cells_used + cells <= METRICS_MAX_CELLS) {
+        id = (metric_id)g_metric_count++;
+        struct Metric* m = &g_metrics[id];
+        m->name = name;
+        m->help = help;
+        m->labels = labels;
+        m->type = type;
+        m->cell = (uint16_t)g_cells_used;
+        m->bound_count = (uint8_t)(type == METRIC_HISTOGRAM ? bound_count : 0);
+        m->scale = scale;
+        if (type == METRIC_HISTOGRAM) memcpy(m->bounds, bounds, (size_t)bound_count * sizeof(bounds[0]));
+        g_cells_used += cells;
+    }
+    pthread_mutex_unlock(&g_metrics_mtx);
+
+    if (!id) log_warn("📈 Metrics registry full, '%s' not exported", name);
+    return id;
+}
+
+metric_id metrics_counter(const char* name, const char* help, const char* labels) {
+    return metrics_register(name, help, labels, METRIC_COUNTER, NULL, 0, 1.0);
+}
+
+metric_id metrics_gauge(const char* name, const char* help, const char* labels) {
+    return metrics_register(name, help, labels, METRIC_GAUGE, NULL, 0, 1.0);
+}
+
+metric_id metrics_histogram(const char* name, const char* help, const char* labels,
+                            const uint64_t* bounds, int bound_count, double scale) {
+    return metrics_register(name, help, labels, METRIC_HISTOGRAM, bounds, bound_count, scale);
+}
+
+void metrics_register_collector(metrics_collector_fn fn) {
+    pthread_mutex_lock(&g_metrics_mtx);
+    if (g_collector_count < METRICS_MAX_COLLECTORS) g_collectors[g_collector_count++] = fn;
+    pthread_mutex_unlock(&g_metrics_mtx);
+}
+
+/* ── Recording ───────────────────────────────────────────────────────────── */
+
+static inline int metrics_shard(void) {
+    if (t_shard < 0) {
+        int s = atomic_fetch_add_explicit(&g_next_shard, 1, memory_order_relaxed);
+        t_shard = s < METRICS_SHARED_SHARD ? s : METRICS_SHARED_SHARD;
+    }
+    return t_shard;
+}
+
+static inline void cell_add(int shard, uint16_t cell, uint64_t n) {
+    _Atomic uint64_t* c = &g_cells[shard][cell];
+    if (shard == METRICS_SHARED_SHARD) {
+        atomic_fetch_add_explicit(c, n, memory_order_relaxed);
+    } else {
+        /* Sole writer: plain read-modify-write, atomic only so scrapes see whole values */
+        atomic_store_explicit(c, atomic_load_explicit(c, memory_order_relaxed) + n,
+                              memory_order_relaxed);
+    }
+}
+
+void metrics_inc(metric_id id, uint64_t n) {
+    if (!id) return;
+    cell_add(metrics_shard(), g_metrics[id].cell, n);
+}
+
+void metrics_gauge_set(metric_id id, int64_t value) {
+    if (!id) return;
+    atomic_store_explicit(&g_cells[0][g_metrics[id].cell], (uint64_t)value, memory_order_relaxed);
+}
+
+void metrics_observe(metric_id id, uint64_t value) {
+    if (!id) return;
+    const struct Metric* m = &g_metrics[id];
+    int b = 0;
+    while (b < m->bound_count && value > m->bounds[b]) b++;
+    int shard = metrics_shard();
+    cell_add(shard, (uint16_t)(m->cell + b), 1);
+    cell_add(shard, (uint16_t)(m->cell + m->bound_count + 1), value);
+}
+
+/* ── Exposition ──────────────────────────────────────────────────────────── */
+
+static uint64_t cell_sum(uint16_t cell) {
+    uint64_t total = 0;
+    for (int s = 0; s < METRICS_SHARDS; s++) {
+        total += atomic_load_explicit(&g_cells[s][cell], memory_order_relaxed);
+    }
+    return total;
+}
+
+static const char* type_name(metric_type_t t) {
+    switch (t) {
+        case METRIC_COUNTER:   return "counter";
+        case METRIC_GAUGE:     return "gauge";
+        case METRIC_HISTOGRAM: return "histogram";
+    }
+    return "unknown";
+}
+
+static void write_metric(FILE* out, const struct Metric* m) {
+    const char* lb = m->labels ? m->labels : "";
+    const char* open = m->labels ? "{" : "";
+    const char* close = m->labels ? "}" : "";
+
+    switch (m->type) {
+        case METRIC_COUNTER:
+            fprintf(out, "%s_total%s%s%s %llu\n", m->name, open, lb, close,
+                    (unsigned long long)cell_sum(m->cell));
+            break;
+        case METRIC_GAUGE:
+            fprintf(out, "%s%s%s%s %lld\n", m->name, open, lb, close,
+                    (long long)(int64_t)atomic_load_explicit(&g_cells[0][m->cell],
+                                                             memory_order_relaxed));
+            break;
+        case METRIC_HISTOGRAM: {
+            const char* sep = m->labels ? "," : "";
+            uint64_t cumulative = 0;
+            for (int b = 0; b <= m->bound_count; b++) {
+                cumulative += cell_sum((uint16_t)(m->cell + b));
+                if (b < m->bound_count) {
+                    fprintf(out, "%s_bucket{%s%sle=\"%.9g\"} %llu\n", m->name, lb, sep,
+                            (double)m->bounds[b] * m->scale, (unsigned long long)cumulative);
+                } else {
+                    fprintf(out, "%s_bucket{%s%sle=\"+Inf\"} %llu\n", m->name, lb, sep,
+                            (unsigned long long)cumulative);
+                }
+            }
+            fprintf(out, "%s_count%s%s%s %llu\n", m->name, open, lb, close,
+                    (unsigned long long)cumulative);
+            fprintf(out, "%s_sum%s%s%s %.9g\n", m->name, open, lb, close,
+                    (double)cell_sum((uint16_t)(m->cell + m->bound_count + 1)) * m->scale);
+            break;
+        }
+    }
+}
+
+int metrics_write_openmetrics(FILE* out) {
+    if (!out) return -1;
+
+    pthread_mutex_lock(&g_metrics_mtx);
+    int count = g_metric_count;
+    int collectors = g_collector_count;
+    pthread_mutex_unlock(&g_metrics_mtx);
+
+    /* Families may be registered from several places; emit each name once
+     * with all of its label sets underneath. */
+    for (int i = 1; i < count; i++) {
+        const struct Metric* m = &g_metrics[i];
+        bool seen = false;
+        for (int j = 1; j < i && !seen; j++) seen = strcmp(g_metrics[j].name, m->name) == 0;
+        if (seen) continue;
+
+        fprintf(out, "# TYPE %s %s\n", m->name, type_name(m->type));
+        if (m->help) fprintf(out, "# HELP %s %s\n", m->name, m->help);
+        for (int j = i; j < count; j++) {
+            if (strcmp(g_metrics[j].name, m->name) == 0) write_metric(out, &g_metrics[j]);
+        }
+    }
+
+    for (int i = 0; i < collectors; i++) g_collectors[i](out);
+
+    fprintf(out, "# EOF\n");
+    return ferror(out) ? -1 : 0;
+}
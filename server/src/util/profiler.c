@@ -0,0 +1,387 @@
+#define _POSIX_C_SOURCE 200809L
+#include "util/profiler.h"
+#include "util/time.h"
+#include "util/log.h"
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sys/stat.h>
+
+/* ── State ───────────────────────────────────────────────────────────────── */
+
+static struct {
+    pthread_mutex_t mtx;              /* Guards names, hist, head, published */
+    bool            initialized;
+
+    const char*          names[PROF_MAX_SCOPES];   /* id 0 is reserved */
+    int                  scope_count;
+    struct ProfHistogram hist[PROF_MAX_SCOPES];
+
+    struct ProfTick ring[PROF_FLIGHT_TICKS];
+    uint32_t        head;             /* Slot the next tick records into     */
+    uint32_t        published;        /* Completed ticks ending at head - 1  */
+
+    /* Tick-thread only */
+    struct ProfTick* cur;
+    int              depth;           /* Open scopes, including the tick     */
+    int              depth_overflow;  /* Pushes ignored past PROF_MAX_DEPTH  */
+    uint16_t         stack_event[PROF_MAX_DEPTH];
+    uint64_t         stack_start[PROF_MAX_DEPTH];
+} g_prof = { .mtx = PTHREAD_MUTEX_INITIALIZER };
+
+/* Only the thread inside prof_tick_begin/end records; any other caller of
+ * PROF_BEGIN (worker threads, tests, tools) sees false and returns at once. */
+static __thread bool t_prof_in_tick = false;
+
+static uint16_t g_prof_tick_scope = 0;
+static volatile sig_atomic_t g_prof_dump_requested = 0;
+
+#define PROF_NO_EVENT 0xFFFFu
+
+void prof_init(void) {
+    pthread_mutex_lock(&g_prof.mtx);
+    if (!g_prof.initialized) {
+        g_prof.names[0] = "?";
+        g_prof.scope_count = 1;
+        g_prof.initialized = true;
+    }
+    pthread_mutex_unlock(&g_prof.mtx);
+    if (!g_prof_tick_scope) g_prof_tick_scope = prof_register("tick");
+}
+
+void prof_reset(void) {
+    pthread_mutex_lock(&g_prof.mtx);
+    memset(g_prof.hist, 0, sizeof(g_prof.hist));
+    g_prof.published = 0;
+    pthread_mutex_unlock(&g_prof.mtx);
+}
+
+uint16_t prof_register(const char* name) {
+    if (!g_prof.initialized) prof_init();
+    uint16_t id = 0;
+    pthread_mutex_lock(&g_prof.mtx);
+    for (int i = 1; i < g_prof.scope_count; i++) {
+        if (strcmp(g_prof.names[i], name) == 0) { id = (uint16_t)i; break; }
+    }
+    if (!id && g_prof.scope_count < PROF_MAX_SCOPES) {
+        id = (uint16_t)g_prof.scope_count++;
+        g_prof.names[id] = name;
+    }
+    pthread_mutex_unlock(&g_prof.mtx);
+    if (!id) log_warn("⏱️ Profiler scope table full, '%s' not tracked", name);
+    return id;
+}
+
+const char* prof_scope_name(uint16_t scope) {
+    const char* name = "?";
+    pthread_mutex_lock(&g_prof.mtx);
+    if (scope < g_prof.scope_count) name = g_prof.names[scope];
+    pthread_mutex_unlock(&g_prof.mtx);
+    return name;
+}
+
+/* ── Histogram ───────────────────────────────────────────────────────────── */
+
+static inline uint32_t hist_index(uint32_t v) {
+    if (v < PROF_HIST_SUB) return v;
+    int msb = 31 - __builtin_clz(v);
+    int shift = msb - PROF_HIST_SUB_BITS;
+    return PROF_HIST_SUB + (uint32_t)shift * PROF_HIST_SUB + ((v >> shift) & (PROF_HIST_SUB - 1));
+}
+
+/* Largest value that maps to bucket idx */
+static inline uint32_t hist_bucket_high(uint32_t idx) {
+    if (idx < PROF_HIST_SUB) return idx;
+    uint32_t shift = (idx - PROF_HIST_SUB) / PROF_HIST_SUB;
+    uint64_t sub = PROF_HIST_SUB + (idx - PROF_HIST_SUB) % PROF_HIST_SUB;
+    uint64_t high = ((sub + 1) << shift) - 1;
+    return high > UINT32_MAX ? UINT32_MAX : (uint32_t)high;
+}
+
+void prof_hist_record(struct ProfHistogram* h, uint32_t value_us) {
+    h->buckets[hist_index(value_us)]++;
+    h->count++;
+    h->sum_us += value_us;
+    if (value_us > h->max_us) h->max_us = value_us;
+}
+
+uint32_t prof_hist_percentile(const struct ProfHistogram* h, double pct) {
+    if (h->count == 0) return 0;
+    uint64_t rank = (uint64_t)(pct / 100.0 * (double)h->count + 0.999999);
+    if (rank < 1) rank = 1;
+    if (rank > h->count) rank = h->count;
+    uint64_t seen = 0;
+    for (uint32_t i = 0; i < PROF_HIST_BUCKETS; i++) {
+        seen += h->buckets[i];
+        if (seen >= rank) {
+            uint32_t v = hist_bucket_high(i);
+            return v < h->max_us ? v : h->max_us;
+        }
+    }
+    return h->max_us;
+}
+
+/* ── Recording ───────────────────────────────────────────────────────────── */
+
+void prof_tick_begin(uint32_t tick) {
+    if (!g_prof.initialized) prof_init();
+
+    pthread_mutex_lock(&g_prof.mtx);
+    /* Full ring: the slot we're about to reuse stops being visible to readers */
+    if (g_prof.published >= PROF_FLIGHT_TICKS) g_prof.published = PROF_FLIGHT_TICKS - 1;
+    g_prof.cur = &g_prof.ring[g_prof.head];
+    pthread_mutex_unlock(&g_prof.mtx);
+
+    struct ProfTick* t = g_prof.cur;
+    t->tick = tick;
+    t->start_us = get_time_us();
+    t->dur_us = 0;
+    t->event_count = 0;
+    t->dropped = 0;
+    g_prof.depth = 0;
+    g_prof.depth_overflow = 0;
+    t_prof_in_tick = true;
+    prof_push(g_prof_tick_scope);
+}
+
+void prof_push(uint16_t scope) {
+    if (!t_prof_in_tick) return;
+    if (g_prof.depth >= PROF_MAX_DEPTH) {
+        g_prof.depth_overflow++;
+        return;
+    }
+    struct ProfTick* t = g_prof.cur;
+    uint64_t now = get_time_us();
+    int d = g_prof.depth++;
+    g_prof.stack_start[d] = now;
+    if (t->event_count < PROF_MAX_EVENTS_PER_TICK) {
+        struct ProfEvent* e = &t->events[t->event_count];
+        e->scope = scope;
+        e->depth = (uint8_t)d;
+        e->start_us = (uint32_t)(now - t->start_us);
+        e->dur_us = 0;
+        g_prof.stack_event[d] = t->event_count++;
+    } else {
+        t->dropped++;
+        g_prof.stack_event[d] = PROF_NO_EVENT;
+    }
+}
+
+static void prof_close_top(uint64_t now) {
+    int d = --g_prof.depth;
+    uint16_t ev = g_prof.stack_event[d];
+    if (ev != PROF_NO_EVENT) {
+        g_prof.cur->events[ev].dur_us = (uint32_t)(now - g_prof.stack_start[d]);
+    }
+}
+
+void prof_pop(void) {
+    if (!t_prof_in_tick) return;
+    if (g_prof.depth_overflow > 0) {
+        g_prof.depth_overflow--;
+        return;
+    }
+    if (g_prof.depth <= 1) return;   /* The tick scope is closed by prof_tick_end */
+    prof_close_top(get_time_us());
+}
+
+void prof_tick_end(void) {
+    if (!t_prof_in_tick) return;
+    uint64_t now = get_time_us();
+    while (g_prof.depth > 0) prof_close_top(now);
+    t_prof_in_tick = false;
+
+    struct ProfTick* t = g_prof.cur;
+    t->dur_us = (uint32_t)(now - t->start_us);
+
+    pthread_mutex_lock(&g_prof.mtx);
+    for (uint16_t i = 0; i < t->event_count; i++) {
+        const struct ProfEvent* e = &t->events[i];
+        if (e->scope < PROF_MAX_SCOPES) prof_hist_record(&g_prof.hist[e->scope], e->dur_us);
+    }
+    g_prof.head = (g_prof.head + 1) % PROF_FLIGHT_TICKS;
+    g_prof.published++;
+    pthread_mutex_unlock(&g_prof.mtx);
+}
+
+/* ── Queries ─────────────────────────────────────────────────────────────── */
+
+int prof_scope_stats(struct ProfScopeStats* out, int max) {
+    int n = 0;
+    pthread_mutex_lock(&g_prof.mtx);
+    for (int i = 1; i < g_prof.scope_count && n < max; i++) {
+        const struct ProfHistogram* h = &g_prof.hist[i];
+        struct ProfScopeStats* s = &out[n++];
+        s->name    = g_prof.names[i];
+        s->count   = h->count;
+        s->sum_us  = h->sum_us;
+        s->mean_us = h->count ? (uint32_t)(h->sum_us / h->count) : 0;
+        s->p50_us  = prof_hist_percentile(h, 50.0);
+        s->p99_us  = prof_hist_percentile(h, 99.0);
+        s->p999_us = prof_hist_percentile(h, 99.9);
+        s->max_us  = h->max_us;
+    }
+    pthread_mutex_unlock(&g_prof.mtx);
+    return n;
+}
+
+/* Copy up to max of the most recent published ticks, oldest first. */
+static int prof_copy_ticks(struct ProfTick* out, int max) {
+    pthread_mutex_lock(&g_prof.mtx);
+    int n = (int)g_prof.published < max ? (int)g_prof.published : max;
+    uint32_t first = (g_prof.head + PROF_FLIGHT_TICKS - (uint32_t)n) % PROF_FLIGHT_TICKS;
+    for (int i = 0; i < n; i++) {
+        const struct ProfTick* src = &g_prof.ring[(first + (uint32_t)i) % PROF_FLIGHT_TICKS];
+        size_t used = offsetof(struct ProfTick, events) + src->event_count * sizeof(src->events[0]);
+        memcpy(&out[i], src, used);
+    }
+    pthread_mutex_unlock(&g_prof.mtx);
+    return n;
+}
+
+bool prof_last_tick(struct ProfTick* out) {
+    return prof_copy_ticks(out, 1) == 1;
+}
+
+size_t prof_format_last_tick(char* buf, size_t cap) {
+    if (!buf || cap == 0) return 0;
+    buf[0] = '\0';
+    static struct ProfTick last;     /* Tick thread only (overrun logging) */
+    if (!prof_last_tick(&last)) return 0;
+
+    size_t len = 0;
+    for (uint16_t i = 0; i < last.event_count && len < cap; i++) {
+        const struct ProfEvent* e = &last.events[i];
+        if (e->depth != 1) continue;
+        int w = snprintf(buf + len, cap - len, "%s%s=%u", len ? " " : "",
+                         prof_scope_name(e->scope), e->dur_us);
+        if (w < 0) break;
+        len += (size_t)w;
+    }
+    return len < cap ? len : cap - 1;
+}
+
+/* ── Dumps ───────────────────────────────────────────────────────────────── */
+
+int prof_write_json(FILE* out, int max_ticks) {
+    if (!out) return -1;
+    if (max_ticks < 0) max_ticks = 0;
+    if (max_ticks > PROF_FLIGHT_TICKS) max_ticks = PROF_FLIGHT_TICKS;
+
+    struct ProfScopeStats stats[PROF_MAX_SCOPES];
+    int scope_n = prof_scope_stats(stats, PROF_MAX_SCOPES);
+
+    struct ProfTick* ticks = NULL;
+    int tick_n = 0;
+    if (max_ticks > 0) {
+        ticks = malloc((size_t)max_ticks * sizeof(*ticks));
+        if (!ticks) return -1;
+        tick_n = prof_copy_ticks(ticks, max_ticks);
+    }
+
+    fprintf(out, "{\n  \"scopes\": [");
+    for (int i = 0; i < scope_n; i++) {
+        const struct ProfScopeStats* s = &stats[i];
+        fprintf(out, "%s\n    {\"name\":\"%s\",\"count\":%llu,\"mean_us\":%u,"
+                     "\"p50_us\":%u,\"p99_us\":%u,\"p999_us\":%u,\"max_us\":%u}",
+                i ? "," : "", s->name, (unsigned long long)s->count, s->mean_us,
+                s->p50_us, s->p99_us, s->p999_us, s->max_us);
+    }
+    fprintf(out, "\n  ],\n  \"ticks\": [");
+    for (int i = 0; i < tick_n; i++) {
+        const struct ProfTick* t = &ticks[i];
+        fprintf(out, "%s\n    {\"tick\":%u,\"dur_us\":%u,\"dropped\":%u,\"scopes\":[",
+                i ? "," : "", t->tick, t->dur_us, t->dropped);
+        for (uint16_t j = 0; j < t->event_count; j++) {
+            const struct ProfEvent* e = &t->events[j];
+            fprintf(out, "%s{\"name\":\"%s\",\"depth\":%u,\"start_us\":%u,\"dur_us\":%u}",
+                    j ? "," : "", prof_scope_name(e->scope), e->depth, e->start_us, e->dur_us);
+        }
+        fprintf(out, "]}");
+    }
+    fprintf(out, "\n  ]\n}\n");
+    free(ticks);
+    return ferror(out) ? -1 : 0;
+}
+
+int prof_write_chrome_trace(FILE* out) {
+    if (!out) return -1;
+    struct ProfTick* ticks = malloc(PROF_FLIGHT_TICKS * sizeof(*ticks));
+    if (!ticks) return -1;
+    int tick_n = prof_copy_ticks(ticks, PROF_FLIGHT_TICKS);
+    uint64_t base = tick_n > 0 ? ticks[0].start_us : 0;
+
+    /* Complete ("X") events; the viewer rebuilds nesting from ts/dur */
+    fprintf(out, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    bool first = true;
+    for (int i = 0; i < tick_n; i++) {
+        const struct ProfTick* t = &ticks[i];
+        for (uint16_t j = 0; j < t->event_count; j++) {
+            const struct ProfEvent* e = &t->events[j];
+            fprintf(out, "%s{\"name\":\"%s\",\"cat\":\"tick\",\"ph\":\"X\",\"pid\":1,\"tid\":1,"
+                         "\"ts\":%llu,\"dur\":%u,\"args\":{\"tick\":%u}}",
+                    first ? "" : ",\n", prof_scope_name(e->scope),
+                    (unsigned long long)(t->start_us - base + e->start_us), e->dur_us, t->tick);
+            first = false;
+        }
+    }
+    fprintf(out, "\n]}\n");
+    free(ticks);
+    return ferror(out) ? -1 : 0;
+}
+
+/* Metrics collector: per-scope quantiles as an OpenMetrics summary, so the
+ * phase timings come straight from the profiler histograms. */
+void prof_write_openmetrics(FILE* out) {
+    struct ProfScopeStats stats[PROF_MAX_SCOPES];
+    int n = prof_scope_stats(stats, PROF_MAX_SCOPES);
+
+    fprintf(out, "# TYPE pirate_phase_duration_seconds summary\n"
+                 "# HELP pirate_phase_duration_seconds Tick phase wall time from the tick profiler.\n");
+    for (int i = 0; i < n; i++) {
+        const struct ProfScopeStats* s = &stats[i];
+        fprintf(out, "pirate_phase_duration_seconds{phase=\"%s\",quantile=\"0.5\"} %.6f\n"
+                     "pirate_phase_duration_seconds{phase=\"%s\",quantile=\"0.99\"} %.6f\n"
+                     "pirate_phase_duration_seconds{phase=\"%s\",quantile=\"0.999\"} %.6f\n"
+                     "pirate_phase_duration_seconds_count{phase=\"%s\"} %llu\n"
+                     "pirate_phase_duration_seconds_sum{phase=\"%s\"} %.6f\n",
+                s->name, s->p50_us * 1e-6, s->name, s->p99_us * 1e-6, s->name, s->p999_us * 1e-6,
+                s->name, (unsigned long long)s->count, s->name, s->sum_us * 1e-6);
+    }
+}
+
+void prof_request_dump(void) {
+    g_prof_dump_requested = 1;
+}
+
+void prof_service_dump_request(void) {
+    if (!g_prof_dump_requested) return;
+    g_prof_dump_requested = 0;
+
+    mkdir("data", 0755);
+    if (mkdir(PROF_DUMP_DIR, 0755) != 0 && errno != EEXIST) {
+        log_error("⏱️ Cannot create %s: %s", PROF_DUMP_DIR, strerror(errno));
+        return;
+    }
+    static struct ProfTick last;
+    uint32_t tick = prof_last_tick(&last) ? last.tick : 0;
+
+    char path[256];
+    snprintf(path, sizeof(path), PROF_DUMP_DIR "/profile_%u.json", tick);
+    FILE* f = fopen(path, "w");
+    if (f) {
+        prof_write_json(f, PROF_FLIGHT_TICKS);
+        fclose(f);
+    }
+    char trace_path[256];
+    snprintf(trace_path, sizeof(trace_path), PROF_DUMP_DIR "/profile_%u.trace.json", tick);
+    FILE* tf = fopen(trace_path, "w");
+    if (tf) {
+        prof_write_chrome_trace(tf);
+        fclose(tf);
+    }
+    if (f && tf) log_info("⏱️ Profile written to %s (+ .trace.json)", path);
+    else         log_error("⏱️ Failed to write profile dump to %s", PROF_DUMP_DIR);
+}
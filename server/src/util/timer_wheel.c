@@ -0,0 +1,303 @@
+#include <stdlib.h>
+#include <string.h>
+#include "util/timer_wheel.h"
+#include "util/log.h"
+#include "util/metrics.h"
+
+#define SLOT_MASK   (TIMER_WHEEL_SLOTS - 1u)
+#define BUCKETS     (TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS)
+#define NO_TIMER    (-1)
+#define NO_BUCKET   0xFFFFu
+/* Ticks covered by the wheel; later deadlines wait in the last level and
+ * are re-inserted when that slot comes round. */
+#define HORIZON     (1u << (TIMER_WHEEL_SLOT_BITS * TIMER_WHEEL_LEVELS))
+#define INDEX_MASK  (TIMER_WHEEL_MAX_TIMERS - 1u)
+#define GEN_MASK    ((1u << (32 - TIMER_WHEEL_HANDLE_BITS)) - 1u)
+
+typedef struct {
+    uint32_t  expires;    /* Wheel tick the timer is due on             */
+    uint32_t  armed_ms;   /* now_ms it was scheduled at                  */
+    uint32_t  arg;
+    int32_t   next, prev; /* Bucket list (free list uses next)          */
+    uint16_t  gen;        /* Bumped on release; never 0, within GEN_MASK */
+    uint16_t  bucket;     /* NO_BUCKET while free                        */
+    TimerKind kind;
+} Timer;
+
+typedef struct {
+    TimerFn   fn;
+    uint32_t  pending;
+    uint64_t  fired;      /* Since the last metrics flush               */
+    uint64_t  dropped;    /* Refused by a full pool, since start        */
+    uint64_t  dropped_flushed;
+    metric_id m_pending;
+    metric_id m_fired;
+    metric_id m_dropped;
+} TimerKindInfo;
+
+/* Timers are referred to by index only, so the pool can move when it grows */
+static Timer*        g_timers;
+static uint32_t      g_cap;
+static int32_t       g_bucket[BUCKETS];
+static int32_t       g_free;
+static uint32_t      g_used;            /* High-water mark of g_timers  */
+static TimerKindInfo g_kinds[TIMER_WHEEL_MAX_KINDS];
+static int           g_kind_count;      /* Kind ids are 1..g_kind_count */
+
+/* Wheel clock: milliseconds since init, extended past the 32-bit wrap of
+ * get_time_ms() by accumulating deltas. */
+static bool          g_started;
+static uint32_t      g_last_ms;
+static uint64_t      g_clock_ms;
+static uint32_t      g_next_tick;       /* First tick not yet processed */
+static uint32_t      g_floor_tick;      /* Earliest tick a new timer may land on */
+
+void timer_wheel_init(uint32_t now_ms) {
+    for (int b = 0; b < (int)BUCKETS; b++) g_bucket[b] = NO_TIMER;
+    for (uint32_t i = 0; i < g_used; i++) {
+        g_timers[i].bucket = NO_BUCKET;
+        g_timers[i].gen = (uint16_t)((g_timers[i].gen + 1u) & GEN_MASK);
+        if (g_timers[i].gen == 0) g_timers[i].gen = 1;
+    }
+    g_free = NO_TIMER;
+    for (int32_t i = (int32_t)g_used - 1; i >= 0; i--) {
+        g_timers[i].next = g_free;
+        g_free = i;
+    }
+    for (int k = 1; k <= g_kind_count; k++) g_kinds[k - 1].pending = 0;
+    g_started    = true;
+    g_last_ms    = now_ms;
+    g_clock_ms   = 0;
+    g_next_tick  = 0;
+    g_floor_tick = 0;
+}
+
+TimerKind timer_wheel_kind(const char* metric_labels, TimerFn fn) {
+    if (!fn || g_kind_count >= TIMER_WHEEL_MAX_KINDS) {
+        log_error("⏲️  timer_wheel_kind: no room for %s", metric_labels ? metric_labels : "(unnamed)");
+        return 0;
+    }
+    TimerKindInfo* k = &g_kinds[g_kind_count++];
+    k->fn = fn;
+    k->m_pending = metrics_gauge("pirate_timers_pending",
+        "Timers waiting on the game timer wheel.", metric_labels);
+    k->m_fired = metrics_counter("pirate_timers_fired",
+        "Timers fired by the game timer wheel.", metric_labels);
+    k->m_dropped = metrics_counter("pirate_timers_dropped",
+        "Timers the game timer wheel could not schedule (pool full).", metric_labels);
+    return (TimerKind)g_kind_count;
+}
+
+/* ── Clock ────────────────────────────────────────────────────────────────── */
+
+static void clock_start(uint32_t now_ms) {
+    if (!g_started) timer_wheel_init(now_ms);
+}
+
+/* Wheel-clock ms for now_ms; never behind the last advance */
+static uint64_t clock_at(uint32_t now_ms) {
+    int32_t d = (int32_t)(now_ms - g_last_ms);
+    return d > 0 ? g_clock_ms + (uint64_t)d : g_clock_ms;
+}
+
+/* ── Buckets ──────────────────────────────────────────────────────────────── */
+
+static void bucket_link(int32_t i) {
+    Timer* t = &g_timers[i];
+    uint32_t expires = t->expires;
+    uint32_t delta = expires - g_next_tick;
+    if (delta >= HORIZON) {
+        delta   = HORIZON - 1u;
+        expires = g_next_tick + delta;
+    }
+    int lvl = 0;
+    while (delta >= (1u << (TIMER_WHEEL_SLOT_BITS * (lvl + 1)))) lvl++;
+    uint32_t slot = (expires >> (TIMER_WHEEL_SLOT_BITS * lvl)) & SLOT_MASK;
+    uint16_t b = (uint16_t)(lvl * TIMER_WHEEL_SLOTS + slot);
+
+    t->bucket = b;
+    t->prev   = NO_TIMER;
+    t->next   = g_bucket[b];
+    if (t->next != NO_TIMER) g_timers[t->next].prev = i;
+    g_bucket[b] = i;
+}
+
+static void bucket_unlink(int32_t i) {
+    Timer* t = &g_timers[i];
+    if (t->prev != NO_TIMER) g_timers[t->prev].next = t->next;
+    else                     g_bucket[t->bucket] = t->next;
+    if (t->next != NO_TIMER) g_timers[t->next].prev = t->prev;
+    t->bucket = NO_BUCKET;
+}
+
+static void timer_release(int32_t i) {
+    Timer* t = &g_timers[i];
+    g_kinds[t->kind - 1].pending--;
+    t->gen = (uint16_t)((t->gen + 1u) & GEN_MASK);
+    if (t->gen == 0) t->gen = 1;
+    t->next = g_free;
+    g_free  = i;
+}
+
+static Timer* timer_resolve(TimerHandle h) {
+    uint32_t i = h & INDEX_MASK;
+    if (h == 0 || i >= g_used) return NULL;
+    Timer* t = &g_timers[i];
+    if (t->bucket == NO_BUCKET || t->gen != (h >> TIMER_WHEEL_HANDLE_BITS)) return NULL;
+    return t;
+}
+
+/* Double the pool, up to TIMER_WHEEL_MAX_TIMERS.  False if it cannot grow. */
+static bool pool_grow(void) {
+    if (g_cap >= TIMER_WHEEL_MAX_TIMERS) return false;
+    uint32_t cap = g_cap ? g_cap * 2u : TIMER_WHEEL_INIT_TIMERS;
+    if (cap > TIMER_WHEEL_MAX_TIMERS) cap = TIMER_WHEEL_MAX_TIMERS;
+    Timer* grown = realloc(g_timers, (size_t)cap * sizeof(Timer));
+    if (!grown) return false;
+    g_timers = grown;
+    g_cap    = cap;
+    return true;
+}
+
+/* ── Schedule / cancel ────────────────────────────────────────────────────── */
+
+TimerHandle timer_wheel_schedule(TimerKind kind, uint32_t arg,
+                                 uint32_t now_ms, uint32_t delay_ms) {
+    if (kind == 0 || kind > g_kind_count) return 0;
+    clock_start(now_ms);
+
+    int32_t i;
+    if (g_free != NO_TIMER) {
+        i = g_free;
+        g_free = g_timers[i].next;
+    } else if (g_used < g_cap || pool_grow()) {
+        i = (int32_t)g_used++;
+        g_timers[i].gen = 1;
+    } else {
+        g_kinds[kind - 1].dropped++;
+        log_warn("⏲️  Timer wheel cannot grow past %u timers — deadline dropped", g_cap);
+        return 0;
+    }
+
+    Timer* t = &g_timers[i];
+    uint64_t due = clock_at(now_ms) + delay_ms;
+    t->expires  = (uint32_t)((due + TIMER_WHEEL_TICK_MS - 1u) / TIMER_WHEEL_TICK_MS);
+    if ((int32_t)(t->expires - g_floor_tick) < 0) t->expires = g_floor_tick;
+    t->armed_ms = now_ms;
+    t->arg      = arg;
+    t->kind     = kind;
+    bucket_link(i);
+    g_kinds[kind - 1].pending++;
+    return ((TimerHandle)t->gen << TIMER_WHEEL_HANDLE_BITS) | (TimerHandle)i;
+}
+
+bool timer_wheel_cancel(TimerHandle h) {
+    Timer* t = timer_resolve(h);
+    if (!t) return false;
+    int32_t i = (int32_t)(t - g_timers);
+    bucket_unlink(i);
+    timer_release(i);
+    return true;
+}
+
+bool timer_wheel_pending(TimerHandle h) {
+    return timer_resolve(h) != NULL;
+}
+
+uint32_t timer_wheel_pending_count(TimerKind kind) {
+    if (kind != 0) return kind <= g_kind_count ? g_kinds[kind - 1].pending : 0;
+    uint32_t n = 0;
+    for (int k = 0; k < g_kind_count; k++) n += g_kinds[k].pending;
+    return n;
+}
+
+uint64_t timer_wheel_dropped_count(TimerKind kind) {
+    if (kind != 0) return kind <= g_kind_count ? g_kinds[kind - 1].dropped : 0;
+    uint64_t n = 0;
+    for (int k = 0; k < g_kind_count; k++) n += g_kinds[k].dropped;
+    return n;
+}
+
+/* ── Advance ──────────────────────────────────────────────────────────────── */
+
+/* Move one higher-level slot's timers down to where they now belong */
+static void cascade(int lvl, uint32_t slot) {
+    uint16_t b = (uint16_t)(lvl * TIMER_WHEEL_SLOTS + slot);
+    int32_t i = g_bucket[b];
+    g_bucket[b] = NO_TIMER;
+    while (i != NO_TIMER) {
+        int32_t next = g_timers[i].next;
+        bucket_link(i);
+        i = next;
+    }
+}
+
+/* Process g_next_tick.  The clock only steps once the slot is empty, so
+ * nothing linked meanwhile (cascades, handlers, horizon re-links, all due
+ * later than `tick`) can land back in it. */
+static uint32_t run_tick(uint32_t now_ms) {
+    uint32_t tick = g_next_tick;
+    uint32_t idx  = tick & SLOT_MASK;
+    if (idx == 0) {
+        for (int lvl = 1; lvl < TIMER_WHEEL_LEVELS; lvl++) {
+            uint32_t slot = (tick >> (TIMER_WHEEL_SLOT_BITS * lvl)) & SLOT_MASK;
+            cascade(lvl, slot);
+            if (slot != 0) break;
+        }
+    }
+
+    uint32_t fired = 0;
+    int32_t i;
+    while ((i = g_bucket[idx]) != NO_TIMER) {
+        Timer* t = &g_timers[i];
+        bucket_unlink(i);
+        if ((int32_t)(t->expires - tick) > 0) {
+            /* Parked at the horizon; not due yet */
+            bucket_link(i);
+            continue;
+        }
+        TimerKind kind     = t->kind;
+        uint32_t  arg      = t->arg;
+        uint32_t  armed_ms = t->armed_ms;
+        timer_release(i);
+        g_kinds[kind - 1].fired++;
+        fired++;
+        g_kinds[kind - 1].fn(arg, now_ms, now_ms - armed_ms);
+    }
+    g_next_tick = tick + 1u;
+    return fired;
+}
+
+uint32_t timer_wheel_advance(uint32_t now_ms) {
+    clock_start(now_ms);
+    g_clock_ms = clock_at(now_ms);
+    g_last_ms  = now_ms;
+    uint32_t target = (uint32_t)(g_clock_ms / TIMER_WHEEL_TICK_MS);
+
+    uint32_t fired = 0;
+    if ((int32_t)(target - g_next_tick) >= 0) {
+        /* Handlers scheduling from here land after this advance */
+        g_floor_tick = target + 1u;
+        if (timer_wheel_pending_count(0) == 0) {
+            g_next_tick = target + 1u;
+        } else {
+            while ((int32_t)(target - g_next_tick) >= 0)
+                fired += run_tick(now_ms);
+        }
+    }
+    g_floor_tick = g_next_tick;
+
+    for (int k = 0; k < g_kind_count; k++) {
+        TimerKindInfo* info = &g_kinds[k];
+        metrics_gauge_set(info->m_pending, info->pending);
+        if (info->fired) {
+            metrics_inc(info->m_fired, info->fired);
+            info->fired = 0;
+        }
+        if (info->dropped != info->dropped_flushed) {
+            metrics_inc(info->m_dropped, info->dropped - info->dropped_flushed);
+            info->dropped_flushed = info->dropped;
+        }
+    }
+    return fired;
+}
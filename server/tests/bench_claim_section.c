@@ -0,0 +1,120 @@
+/* Claim section benchmark: 50 contested claim flags on one island.
+ * Compares the old byte-grid malloc + BFS build, the bitset build, and the
+ * cached path after a single fort change (dirty-region rebuild only). */
+
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "claim_section_ref.h"
+
+PlacedStructure placed_structures[MAX_PLACED_STRUCTURES];
+uint32_t placed_structure_count;
+uint16_t next_structure_id = 1;
+
+#define ISLAND   3
+#define ANCHORS  160
+#define FLAGS    50
+#define ROUNDS   10
+
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+static float frand(float lo, float hi) {
+    return lo + (hi - lo) * (float)rand() / (float)RAND_MAX;
+}
+
+static PlacedStructure *add(PlacedStructureType type, uint8_t company, float x, float y) {
+    PlacedStructure *s = &placed_structures[placed_structure_count];
+    memset(s, 0, sizeof(*s));
+    s->active = true;
+    s->id = (uint16_t)(placed_structure_count + 1);
+    s->type = type;
+    s->company_id = company;
+    s->island_id = ISLAND;
+    s->x = x;
+    s->y = y;
+    s->fortress_complete = true;
+    placed_structure_count++;
+    return s;
+}
+
+int main(void) {
+    srand(1);
+    /* Two companies' territory interleaved across a 6000px island */
+    for (int i = 0; i < ANCHORS; i++) {
+        PlacedStructureType t = i % 8 == 0 ? STRUCT_FLAG_FORT : STRUCT_WOODEN_FLOOR;
+        add(t, (uint8_t)(1 + i % 2), frand(0, 6000.0f), frand(0, 6000.0f));
+    }
+    /* Half the overlapping enemy pairs have dominated each other */
+    for (uint32_t i = 0; i < placed_structure_count; i++) {
+        PlacedStructure *s = &placed_structures[i];
+        for (uint32_t j = 0; j < placed_structure_count && s->dominator_count < MAX_DOMINATORS; j++) {
+            PlacedStructure *o = &placed_structures[j];
+            float dx = o->x - s->x, dy = o->y - s->y;
+            float rr = struct_claim_radius(o->type) + struct_claim_radius(s->type);
+            if (o->company_id != s->company_id && dx * dx + dy * dy < rr * rr && rand() % 2)
+                s->dominators[s->dominator_count++] = o->id;
+        }
+    }
+    structure_index_rebuild();
+
+    /* Flags only where there is a contested section */
+    PlacedStructure *flags[FLAGS];
+    int n = 0;
+    for (int tries = 0; n < FLAGS && tries < 100000; tries++) {
+        const PlacedStructure *a = &placed_structures[rand() % ANCHORS];
+        float x = a->x + frand(-400, 400), y = a->y + frand(-400, 400);
+        ClaimSectionGrid *g = claim_section_build(ISLAND, a->company_id, x, y);
+        if (!g) continue;
+        claim_section_free(g);
+        flags[n++] = add(STRUCT_CLAIM_FLAG, a->company_id, x, y);
+    }
+    if (n < FLAGS) {
+        fprintf(stderr, "only %d contested flag sites found\n", n);
+        return 1;
+    }
+    structure_index_rebuild();
+
+    double t0 = now_ms();
+    size_t cells = 0;
+    for (int r = 0; r < ROUNDS; r++)
+        for (int f = 0; f < FLAGS; f++) {
+            RefSectionGrid *g = ref_section_build(ISLAND, flags[f]->company_id, flags[f]->x, flags[f]->y);
+            if (g) cells += (size_t)g->w * g->h;
+            ref_section_free(g);
+        }
+    double ref_ms = (now_ms() - t0) / ROUNDS;
+
+    t0 = now_ms();
+    for (int r = 0; r < ROUNDS; r++)
+        for (int f = 0; f < FLAGS; f++)
+            claim_section_free(claim_section_build(ISLAND, flags[f]->company_id, flags[f]->x, flags[f]->y));
+    double bit_ms = (now_ms() - t0) / ROUNDS;
+
+    /* Cached: warm every flag, then toggle one fort per round */
+    claim_invalidate_cf_sections();
+    for (int f = 0; f < FLAGS; f++) (void)claim_flag_section(flags[f]);
+    uint64_t builds = claim_section_build_count();
+    t0 = now_ms();
+    for (int r = 0; r < ROUNDS; r++) {
+        PlacedStructure *fort = &placed_structures[(r % (ANCHORS / 8)) * 8];
+        fort->claim_orphaned = !fort->claim_orphaned;
+        claim_invalidate_cf_sections();
+        for (int f = 0; f < FLAGS; f++) (void)claim_flag_section(flags[f]);
+    }
+    double inc_ms = (now_ms() - t0) / ROUNDS;
+    builds = claim_section_build_count() - builds;
+
+    printf("claim sections, %d contested flags (%zu ref grid cells/round):\n", FLAGS, cells / ROUNDS);
+    printf("  byte grid full rebuild : %8.3f ms/round\n", ref_ms);
+    printf("  bitset full rebuild    : %8.3f ms/round  (%.1fx)\n", bit_ms, ref_ms / bit_ms);
+    printf("  cached, one fort change: %8.3f ms/round  (%.1fx, %.1f flags rebuilt)\n",
+           inc_ms, ref_ms / inc_ms, (double)builds / ROUNDS);
+    return 0;
+}
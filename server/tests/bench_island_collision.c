@@ -0,0 +1,225 @@
+/* Island collision benchmark over every ISLAND_PRESETS slot, with the real
+ * shapes from data/islands (or the directory given as argv[1]).
+ *
+ * Ship pushout: hull vertices scattered inside each polygon island near its
+ * shore, pushed out by the all-edge island_poly_pushout() scan and by
+ * island_poly_nearest_exit() on the raster's per-tile edge candidates.
+ * Projectile resources: cannonballs over and around the islands, querying
+ * trees and boulders on every island vs only the islands in reach. */
+
+#define _POSIX_C_SOURCE 200809L
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "sim/island.h"
+
+#define N_VERTS   200000
+#define N_SHOTS   200000
+#define ROUNDS    5
+
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+static float frand(float lo, float hi) {
+    return lo + (hi - lo) * (float)rand() / (float)RAND_MAX;
+}
+
+static char *slurp(const char *path) {
+    FILE *f = fopen(path, "rb");
+    if (!f) return NULL;
+    fseek(f, 0, SEEK_END);
+    long n = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    char *buf = malloc((size_t)n + 1);
+    if (buf && fread(buf, 1, (size_t)n, f) != (size_t)n) { free(buf); buf = NULL; }
+    if (buf) buf[n] = '\0';
+    fclose(f);
+    return buf;
+}
+
+/* Number after "key": in [p, end), or NAN */
+static float num_after(const char *p, const char *end, const char *key) {
+    const char *k = strstr(p, key);
+    if (!k || k >= end) return NAN;
+    k = strchr(k + strlen(key), ':');
+    return k ? strtof(k + 1, NULL) : NAN;
+}
+
+/* Sand ring of a template, centred on its centroid as the loader does.  Not
+ * a JSON parser — just enough for the files in data/islands/templates. */
+static bool load_sand(const char *dir, const char *name, IslandDef *isl) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/templates/%s.json", dir, name);
+    char *buf = slurp(path);
+    if (!buf) return false;
+    const char *p = strstr(buf, "\"sand_verts_JSON\"");
+    const char *end = p ? strchr(p, ']') : NULL;
+    int n = 0;
+    while (p && end && n < ISLAND_MAX_VERTS) {
+        const char *obj = strchr(p, '{');
+        if (!obj || obj > end) break;
+        const char *close = strchr(obj, '}');
+        isl->vx[n] = num_after(obj, close, "\"x\"");
+        isl->vy[n] = num_after(obj, close, "\"y\"");
+        n++;
+        p = close + 1;
+    }
+    free(buf);
+    if (n < 3) return false;
+    float cx = 0.0f, cy = 0.0f, max_r = 0.0f;
+    for (int i = 0; i < n; i++) { cx += isl->vx[i]; cy += isl->vy[i]; }
+    cx /= (float)n;
+    cy /= (float)n;
+    for (int i = 0; i < n; i++) {
+        isl->vx[i] -= cx;
+        isl->vy[i] -= cy;
+        max_r = fmaxf(max_r, sqrtf(isl->vx[i] * isl->vx[i] + isl->vy[i] * isl->vy[i]));
+    }
+    isl->vertex_count = n;
+    if (isl->poly_bound_r == 0.0f) isl->poly_bound_r = max_r + 50.0f;
+    return true;
+}
+
+/* Centre, rotation and template of each islands.json entry */
+static int load_world(const char *dir) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/islands.json", dir);
+    char *buf = slurp(path);
+    if (!buf) return -1;
+    int shaped = 0;
+    for (const char *p = strstr(buf, "\"id\""); p; ) {
+        const char *next = strstr(p + 4, "\"id\"");
+        const char *end = next ? next : p + strlen(p);
+        int id = (int)num_after(p, end, "\"id\"");
+        IslandDef *isl = NULL;
+        for (int k = 0; k < ISLAND_COUNT; k++)
+            if (ISLAND_PRESETS[k].id == id) isl = &ISLAND_PRESETS[k];
+        if (isl) {
+            float v;
+            if (!isnan(v = num_after(p, end, "\"x\""))) isl->x = v;
+            if (!isnan(v = num_after(p, end, "\"y\""))) isl->y = v;
+            if (!isnan(v = num_after(p, end, "\"rotation_deg\""))) isl->rotation_deg = v;
+            const char *t = strstr(p, "\"template\"");
+            char name[64];
+            if (t && t < end && sscanf(t, "\"template\" : \"%63[^\"]\"", name) == 1)
+                shaped += load_sand(dir, name, isl);
+        }
+        p = next;
+    }
+    free(buf);
+    return shaped;
+}
+
+/* A point inside the beach polygon within 300 px of its shore */
+static bool shore_point(const IslandDef *isl, float *px, float *py) {
+    int i = rand() % isl->vertex_count, j = (i + 1) % isl->vertex_count;
+    float t = frand(0.0f, 1.0f);
+    *px = isl->x + isl->vx[i] + t * (isl->vx[j] - isl->vx[i]) + frand(-300.0f, 300.0f);
+    *py = isl->y + isl->vy[i] + t * (isl->vy[j] - isl->vy[i]) + frand(-300.0f, 300.0f);
+    return island_poly_contains(isl, *px, *py);
+}
+
+static float g_vx[N_VERTS], g_vy[N_VERTS];
+
+static void bench_pushout(int ii) {
+    const IslandDef *isl = &ISLAND_PRESETS[ii];
+    if (isl->vertex_count == 0) {
+        printf("  island %d: bump circle, no edges\n", isl->id);
+        return;
+    }
+    int n = 0;
+    while (n < N_VERTS)
+        if (shore_point(isl, &g_vx[n], &g_vy[n])) n++;
+
+    volatile float sink = 0.0f;
+    double t0 = now_ms();
+    for (int r = 0; r < ROUNDS; r++)
+        for (int k = 0; k < n; k++) {
+            float nx, ny, d;
+            island_poly_pushout(isl, g_vx[k], g_vy[k], &nx, &ny, &d);
+            sink += d;
+        }
+    double t1 = now_ms();
+    for (int r = 0; r < ROUNDS; r++)
+        for (int k = 0; k < n; k++) {
+            float nx, ny, d;
+            island_poly_nearest_exit(isl, g_vx[k], g_vy[k], &nx, &ny, &d);
+            sink += d;
+        }
+    double t2 = now_ms();
+    (void)sink;
+    double per = 1e6 / ((double)n * ROUNDS);
+    printf("  island %d: %3d edges  all-edge %7.1f ns  nearest-exit %6.1f ns  (%.1fx)\n",
+           isl->id, isl->vertex_count, (t1 - t0) * per, (t2 - t1) * per, (t1 - t0) / (t2 - t1));
+}
+
+static float g_sx[N_SHOTS], g_sy[N_SHOTS];
+
+static void bench_projectiles(void) {
+    /* Half over an island, half out to two island radii */
+    for (int k = 0; k < N_SHOTS; k++) {
+        const IslandDef *isl = &ISLAND_PRESETS[rand() % ISLAND_COUNT];
+        float r = isl->vertex_count > 0 ? isl->poly_bound_r : isl->beach_radius_px + isl->beach_max_bump;
+        float s = (k & 1) ? 1.0f : 2.0f;
+        g_sx[k] = isl->x + frand(-s * r, s * r);
+        g_sy[k] = isl->y + frand(-s * r, s * r);
+    }
+    static IslandResourceNear near;
+    const uint32_t mask = RES_MASK(RES_WOOD) | RES_MASK(RES_BOULDER) | RES_MASK(RES_STONE_BOULDER);
+    volatile uint32_t found = 0;
+    double t0 = now_ms();
+    for (int r = 0; r < ROUNDS; r++)
+        for (int k = 0; k < N_SHOTS; k++)
+            for (int ii = 0; ii < ISLAND_COUNT; ii++) {
+                const IslandDef *isl = &ISLAND_PRESETS[ii];
+                found += island_resources_near(&near, isl, g_sx[k], g_sy[k], 52.0f * isl->grid_max_size, mask);
+            }
+    double t1 = now_ms();
+    for (int r = 0; r < ROUNDS; r++)
+        for (int k = 0; k < N_SHOTS; k++) {
+            uint32_t in_reach = 0;
+            for (int ii = 0; ii < ISLAND_COUNT; ii++) {
+                const IslandDef *isl = &ISLAND_PRESETS[ii];
+                float br = isl->vertex_count > 0 ? isl->poly_bound_r : isl->beach_radius_px + isl->beach_max_bump;
+                br += 52.0f * isl->grid_max_size;
+                float dx = g_sx[k] - isl->x, dy = g_sy[k] - isl->y;
+                if (dx * dx + dy * dy <= br * br) in_reach |= 1u << ii;
+            }
+            for (int ii = 0; ii < ISLAND_COUNT; ii++) {
+                if (!(in_reach & (1u << ii))) continue;
+                const IslandDef *isl = &ISLAND_PRESETS[ii];
+                found += island_resources_near(&near, isl, g_sx[k], g_sy[k], 52.0f * isl->grid_max_size, mask);
+            }
+        }
+    double t2 = now_ms();
+    (void)found;
+    double per = 1e6 / ((double)N_SHOTS * ROUNDS);
+    printf("  projectile resources: every island %6.1f ns  islands in reach %6.1f ns  (%.1fx)\n",
+           (t1 - t0) * per, (t2 - t1) * per, (t1 - t0) / (t2 - t1));
+}
+
+int main(int argc, char **argv) {
+    const char *dir = argc > 1 ? argv[1] : "data/islands";
+    int shaped = load_world(dir);
+    if (shaped < 0) {
+        fprintf(stderr, "no %s/islands.json (run from server/ or pass the islands dir)\n", dir);
+        return 1;
+    }
+    srand(47);
+    islands_apply_rotations();
+    islands_build_rasters();
+    islands_generate_zone_resources();
+    islands_generate_trees();
+    islands_build_grid();
+
+    printf("Ship hull vertex pushout, %d shore vertices x %d rounds per island:\n", N_VERTS, ROUNDS);
+    for (int ii = 0; ii < ISLAND_COUNT; ii++) bench_pushout(ii);
+    bench_projectiles();
+    return 0;
+}
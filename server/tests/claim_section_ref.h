@@ -0,0 +1,242 @@
+/* Reference claim section builder for test_claim_section and
+ * bench_claim_section: the byte-per-cell, malloc-per-build implementation
+ * claim_section.c replaced, kept verbatim apart from the lattice alignment. */
+#pragma once
+#include <math.h>
+#include <stdlib.h>
+#include "net/claim.h"
+#include "net/structure_index.h"
+#include "net/websocket_server_internal.h"
+
+typedef struct {
+    float    origin_x, origin_y;
+    float    cell_size;
+    int      w, h;
+    uint8_t *cells;   /* w*h, 1 = in section */
+} RefSectionGrid;
+
+static void ref_section_free(RefSectionGrid *g) {
+    if (!g) return;
+    free(g->cells);
+    free(g);
+}
+
+static RefSectionGrid *ref_section_build(uint8_t island_id, uint8_t company_id,
+                                         float px, float py) {
+    /* Gather Mi / Ej indices and compute the union bbox. */
+    uint32_t cap = placed_structure_count + 1;
+    uint32_t *mine_idx  = (uint32_t*)malloc(sizeof(uint32_t) * cap);
+    uint32_t *enemy_idx = (uint32_t*)malloc(sizeof(uint32_t) * cap);
+    if (!mine_idx || !enemy_idx) { free(mine_idx); free(enemy_idx); return NULL; }
+    int n_mine = 0, n_enemy = 0;
+    float bbx_min = px, bby_min = py, bbx_max = px, bby_max = py;
+    bool have_bb = false;
+
+    for (uint32_t i = 0; i < placed_structure_count; i++) {
+        PlacedStructure *ps = &placed_structures[i];
+        if (!ps->active) continue;
+        if (ps->claim_orphaned) continue;
+        if (ps->island_id != island_id) continue;
+        if (ps->type == STRUCT_FLAG_FORT && !ps->fortress_complete) continue;
+        if (ps->type == STRUCT_CLAIM_FLAG) continue;   /* not a territorial anchor */
+        if (ps->company_id == COMPANY_UNCLAIMED) continue;
+        float r = struct_claim_radius(ps->type);
+        if (ps->company_id == company_id) {
+            mine_idx[n_mine++] = i;
+        } else {
+            enemy_idx[n_enemy++] = i;
+        }
+        float xmin = ps->x - r, xmax = ps->x + r;
+        float ymin = ps->y - r, ymax = ps->y + r;
+        if (!have_bb) {
+            bbx_min = xmin; bbx_max = xmax;
+            bby_min = ymin; bby_max = ymax;
+            have_bb = true;
+        } else {
+            if (xmin < bbx_min) bbx_min = xmin;
+            if (xmax > bbx_max) bbx_max = xmax;
+            if (ymin < bby_min) bby_min = ymin;
+            if (ymax > bby_max) bby_max = ymax;
+        }
+    }
+
+    if (n_mine == 0 || n_enemy == 0) {
+        free(mine_idx); free(enemy_idx);
+        return NULL;
+    }
+
+    /* Always include the placement point in the grid bbox (1-cell margin). */
+    if (px < bbx_min) bbx_min = px;
+    if (px > bbx_max) bbx_max = px;
+    if (py < bby_min) bby_min = py;
+    if (py > bby_max) bby_max = py;
+
+    const float cell = 8.0f;
+    /* Same world-aligned lattice as claim_section.c */
+    float ox = (floorf(bbx_min / cell) - 1.0f) * cell;
+    float oy = (floorf(bby_min / cell) - 1.0f) * cell;
+    int   w  = (int)ceilf((bbx_max - ox) / cell) + 2;
+    int   h  = (int)ceilf((bby_max - oy) / cell) + 2;
+    if (w <= 0 || h <= 0 || w > 4096 || h > 4096) {
+        free(mine_idx); free(enemy_idx);
+        return NULL;
+    }
+
+    size_t n = (size_t)w * (size_t)h;
+    uint8_t *slice = (uint8_t*)calloc(n, 1);
+    uint8_t *own   = (uint8_t*)calloc(n, 1);
+    if (!slice || !own) {
+        free(slice); free(own);
+        free(mine_idx); free(enemy_idx);
+        return NULL;
+    }
+
+    /* tmp_own: cells inside some Mi.disc but not inside any of that Mi's
+     * dominator discs. */
+    for (int km = 0; km < n_mine; km++) {
+        PlacedStructure *mi = &placed_structures[mine_idx[km]];
+        float mr  = struct_claim_radius(mi->type);
+        float mr2 = mr * mr;
+        int gx0 = (int)floorf((mi->x - mr - ox) / cell);
+        int gx1 = (int)ceilf ((mi->x + mr - ox) / cell);
+        int gy0 = (int)floorf((mi->y - mr - oy) / cell);
+        int gy1 = (int)ceilf ((mi->y + mr - oy) / cell);
+        if (gx0 < 0) gx0 = 0;
+        if (gy0 < 0) gy0 = 0;
+        if (gx1 >= w) gx1 = w - 1;
+        if (gy1 >= h) gy1 = h - 1;
+        for (int gy = gy0; gy <= gy1; gy++) {
+            float wy = oy + ((float)gy + 0.5f) * cell;
+            float dy = wy - mi->y;
+            for (int gx = gx0; gx <= gx1; gx++) {
+                float wx = ox + ((float)gx + 0.5f) * cell;
+                float dx = wx - mi->x;
+                if (dx*dx + dy*dy > mr2) continue;
+                bool carved = false;
+                for (int di = 0; di < mi->dominator_count; di++) {
+                    PlacedStructure *d = structure_by_id(mi->dominators[di]);
+                    if (!d || d->claim_orphaned) continue;
+                    if (d->type == STRUCT_FLAG_FORT && !d->fortress_complete) continue;
+                    float dr  = struct_claim_radius(d->type);
+                    float ddx = wx - d->x, ddy = wy - d->y;
+                    if (ddx*ddx + ddy*ddy <= dr*dr) { carved = true; break; }
+                }
+                if (!carved) own[(size_t)gy * w + gx] = 1;
+            }
+        }
+    }
+
+    /* Lens union: for each (Mi, Ej) with overlapping discs, mark cells
+     * inside both discs. */
+    for (int km = 0; km < n_mine; km++) {
+        PlacedStructure *mi = &placed_structures[mine_idx[km]];
+        float mr  = struct_claim_radius(mi->type);
+        float mr2 = mr * mr;
+        for (int ke = 0; ke < n_enemy; ke++) {
+            PlacedStructure *ej = &placed_structures[enemy_idx[ke]];
+            float er  = struct_claim_radius(ej->type);
+            float er2 = er * er;
+            float dxc = mi->x - ej->x, dyc = mi->y - ej->y;
+            float sum = mr + er;
+            if (dxc*dxc + dyc*dyc >= sum*sum) continue;
+
+            float lxmn = (mi->x - mr) > (ej->x - er) ? (mi->x - mr) : (ej->x - er);
+            float lxmx = (mi->x + mr) < (ej->x + er) ? (mi->x + mr) : (ej->x + er);
+            float lymn = (mi->y - mr) > (ej->y - er) ? (mi->y - mr) : (ej->y - er);
+            float lymx = (mi->y + mr) < (ej->y + er) ? (mi->y + mr) : (ej->y + er);
+            int gx0 = (int)floorf((lxmn - ox) / cell);
+            int gx1 = (int)ceilf ((lxmx - ox) / cell);
+            int gy0 = (int)floorf((lymn - oy) / cell);
+            int gy1 = (int)ceilf ((lymx - oy) / cell);
+            if (gx0 < 0) gx0 = 0;
+            if (gy0 < 0) gy0 = 0;
+            if (gx1 >= w) gx1 = w - 1;
+            if (gy1 >= h) gy1 = h - 1;
+            for (int gy = gy0; gy <= gy1; gy++) {
+                float wy   = oy + ((float)gy + 0.5f) * cell;
+                float dy_m = wy - mi->y, dy_e = wy - ej->y;
+                for (int gx = gx0; gx <= gx1; gx++) {
+                    float wx   = ox + ((float)gx + 0.5f) * cell;
+                    float dx_m = wx - mi->x, dx_e = wx - ej->x;
+                    if (dx_m*dx_m + dy_m*dy_m > mr2) continue;
+                    if (dx_e*dx_e + dy_e*dy_e > er2) continue;
+                    slice[(size_t)gy * w + gx] = 1;
+                }
+            }
+        }
+    }
+
+    /* slice ∖ own */
+    for (size_t i = 0; i < n; i++) if (own[i]) slice[i] = 0;
+    free(own);
+    free(mine_idx);
+    free(enemy_idx);
+
+    /* Locate placement cell. */
+    int cgx = (int)floorf((px - ox) / cell);
+    int cgy = (int)floorf((py - oy) / cell);
+    if (cgx < 0 || cgy < 0 || cgx >= w || cgy >= h) { free(slice); return NULL; }
+    if (!slice[(size_t)cgy * w + cgx]) { free(slice); return NULL; }
+
+    /* BFS flood-fill (4-connected). */
+    uint8_t *section = (uint8_t*)calloc(n, 1);
+    int     *stack   = (int*)malloc(sizeof(int) * n);
+    if (!section || !stack) { free(slice); free(section); free(stack); return NULL; }
+    int sp = 0;
+    int seed = cgy * w + cgx;
+    section[seed] = 1;
+    stack[sp++] = seed;
+    while (sp > 0) {
+        int k = stack[--sp];
+        int x = k % w, y = k / w;
+        if (x > 0     && slice[k - 1] && !section[k - 1]) { section[k - 1] = 1; stack[sp++] = k - 1; }
+        if (x < w - 1 && slice[k + 1] && !section[k + 1]) { section[k + 1] = 1; stack[sp++] = k + 1; }
+        if (y > 0     && slice[k - w] && !section[k - w]) { section[k - w] = 1; stack[sp++] = k - w; }
+        if (y < h - 1 && slice[k + w] && !section[k + w]) { section[k + w] = 1; stack[sp++] = k + w; }
+    }
+    free(slice);
+    free(stack);
+
+    RefSectionGrid *g = (RefSectionGrid*)malloc(sizeof(*g));
+    if (!g) { free(section); return NULL; }
+    g->origin_x  = ox;
+    g->origin_y  = oy;
+    g->cell_size = cell;
+    g->w         = w;
+    g->h         = h;
+    g->cells     = section;
+    return g;
+}
+
+static inline bool ref_section_contains(const RefSectionGrid *g, float x, float y) {
+    if (!g) return false;
+    int gx = (int)floorf((x - g->origin_x) / g->cell_size);
+    int gy = (int)floorf((y - g->origin_y) / g->cell_size);
+    if (gx < 0 || gy < 0 || gx >= g->w || gy >= g->h) return false;
+    return g->cells[(size_t)gy * g->w + gx] != 0;
+}
+
+static inline bool ref_section_disc_overlaps(const RefSectionGrid *g,
+                                      float cx, float cy, float r) {
+    if (!g || r <= 0.0f) return false;
+    float r2  = r * r;
+    int gx0 = (int)floorf((cx - r - g->origin_x) / g->cell_size);
+    int gx1 = (int)ceilf ((cx + r - g->origin_x) / g->cell_size);
+    int gy0 = (int)floorf((cy - r - g->origin_y) / g->cell_size);
+    int gy1 = (int)ceilf ((cy + r - g->origin_y) / g->cell_size);
+    if (gx0 < 0) gx0 = 0;
+    if (gy0 < 0) gy0 = 0;
+    if (gx1 >= g->w) gx1 = g->w - 1;
+    if (gy1 >= g->h) gy1 = g->h - 1;
+    for (int gy = gy0; gy <= gy1; gy++) {
+        float wy = g->origin_y + ((float)gy + 0.5f) * g->cell_size;
+        float dy = wy - cy;
+        for (int gx = gx0; gx <= gx1; gx++) {
+            if (!g->cells[(size_t)gy * g->w + gx]) continue;
+            float wx = g->origin_x + ((float)gx + 0.5f) * g->cell_size;
+            float dx = wx - cx;
+            if (dx*dx + dy*dy <= r2) return true;
+        }
+    }
+    return false;
+}
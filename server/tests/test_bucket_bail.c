@@ -12,6 +12,10 @@ SimpleShip* find_ship(uint16_t ship_id) {
     return NULL;
 }
 
+/* Gunport toggles broadcast from the NPC path; nothing to do here */
+void recalc_ship_mass(SimpleShip* ship) { (void)ship; }
+void broadcast_json_all(const char* json) { (void)json; }
+
 static void setup_player_with_bucket(WebSocketPlayer* player, uint8_t deck_level) {
     memset(player, 0, sizeof(*player));
     player->parent_ship_id = 1;
@@ -24,10 +28,21 @@ static void setup_player_with_bucket(WebSocketPlayer* player, uint8_t deck_level
 static struct Ship flooded_ship(float hull_pct) {
     struct Ship ship;
     memset(&ship, 0, sizeof(ship));
+    ship.id = 1;
     ship.hull_health = Q16_FROM_FLOAT(hull_pct);
     return ship;
 }
 
+static ShipModule* add_module(struct Ship* ship, ModuleTypeId type, float x, float y) {
+    ShipModule* m = &ship->modules[ship->module_count++];
+    memset(m, 0, sizeof(*m));
+    m->id = (uint16_t)(1000 + ship->module_count);
+    m->type_id = type;
+    m->local_pos.x = Q16_FROM_FLOAT(CLIENT_TO_SERVER(x));
+    m->local_pos.y = Q16_FROM_FLOAT(CLIENT_TO_SERVER(y));
+    return m;
+}
+
 static void test_spoofed_at_well_rejected(void) {
     WebSocketPlayer player;
     setup_player_with_bucket(&player, 1);
@@ -49,10 +64,101 @@ static void test_upper_deck_threshold(void) {
     printf("  upper deck requires 75%% flood threshold\n");
 }
 
+static void test_lower_deck_and_well(void) {
+    WebSocketPlayer player;
+    setup_player_with_bucket(&player, 0);
+
+    /* Lower deck line is 25%, less the minigame grace */
+    struct Ship dry = flooded_ship(80.0f), wet = flooded_ship(76.0f);
+    assert(!bucket_can_fill(&player, &dry));
+    assert(bucket_can_fill(&player, &wet));
+
+    /* A trickle is only scoopable at the bilge well */
+    struct Ship ship = flooded_ship(98.5f);
+    ShipModule* well = add_module(&ship, MODULE_TYPE_WELL, -100.0f, 0.0f);
+    player.local_x = -100.0f + BUCKET_PROXIMITY_PX - 5.0f;
+    assert(bucket_near_well(&ship, player.local_x, player.local_y));
+    assert(bucket_can_fill(&player, &ship));
+    player.local_x = 200.0f;
+    assert(!bucket_can_fill(&player, &ship));
+
+    /* Only a lower-deck well counts, and only for lower-deck players */
+    player.local_x = -100.0f;
+    well->deck_id = 1;
+    assert(!bucket_can_fill(&player, &ship));
+    well->deck_id = 0;
+    player.deck_level = 1;
+    assert(!bucket_can_fill(&player, &ship));
+    printf("  lower deck at 25%%, bilge well from the first trickle\n");
+}
+
+static void test_fill_moves_water(void) {
+    WebSocketPlayer player;
+    setup_player_with_bucket(&player, 1);
+    struct Ship ship = flooded_ship(20.0f);
+    char resp[256];
+
+    assert(bucket_apply_fill(&player, &ship, true, 1, false, resp, sizeof(resp)));
+    assert(strstr(resp, "bucket_filled") && player.bucket_fill == 2);
+    assert(Q16_TO_FLOAT(ship.hull_health) > 20.0f + BUCKET_BAIL_FULL_HP - 0.01f);
+    assert(ship_flood_fill(&ship) < 0.77f);
+
+    /* A full bucket can't scoop again */
+    player.bucket_cooldown_until_ms = 0;
+    assert(bucket_apply_fill(&player, &ship, true, 1, false, resp, sizeof(resp)));
+    assert(strstr(resp, "bucket_already_full"));
+    printf("  a scoop lowers the flood and fills the bucket\n");
+}
+
+static void test_dump_openings(void) {
+    WebSocketPlayer player;
+    setup_player_with_bucket(&player, 0);
+    struct Ship ship = flooded_ship(50.0f);
+    ShipModule* plank = add_module(&ship, MODULE_TYPE_PLANK, 0.0f, -90.0f);
+    plank->health = 0;                       /* Destroyed: a hole to pour through */
+    ShipModule* port = add_module(&ship, MODULE_TYPE_GUNPORT, 0.0f, 0.0f);
+    port->data.gunport.snap_idx = 6;         /* (152.5, 90) */
+
+    player.local_x = 10.0f;
+    player.local_y = -70.0f;
+    assert(bucket_is_valid_dump_zone(&player, &ship));
+
+    /* A shut gunport is no opening; an open one is */
+    player.local_x = 150.0f;
+    player.local_y = 70.0f;
+    assert(!bucket_is_valid_dump_zone(&player, &ship));
+    port->data.gunport.is_open = true;
+    ship_flooding_touch(&ship);
+    assert(bucket_is_valid_dump_zone(&player, &ship));
+
+    /* The deck the player claims must be the one they're on */
+    assert(!bucket_is_valid_dump_zone_at(&player, &ship, 1));
+    printf("  lower-deck dumps only through holes and open gunports\n");
+}
+
+static void test_dry_hulls(void) {
+    WebSocketPlayer player;
+    setup_player_with_bucket(&player, 1);
+    struct Ship ship = flooded_ship(10.0f);
+    ship.flags |= SHIP_FLAG_SCAFFOLDED;
+    assert(ship_flood_fill(&ship) == 0.0f);
+    assert(!bucket_can_fill(&player, &ship));
+
+    struct Ship ghost = flooded_ship(10.0f);
+    ghost.company_id = 99;
+    assert(ship_flood_fill(&ghost) == 0.0f);
+    assert(!bucket_can_fill(&player, &ghost));
+    printf("  scaffolded and ghost hulls hold no water\n");
+}
+
 int main(void) {
     printf("Testing bucket bail authority...\n");
     test_spoofed_at_well_rejected();
     test_upper_deck_threshold();
+    test_lower_deck_and_well();
+    test_fill_moves_water();
+    test_dump_openings();
+    test_dry_hulls();
     printf("Bucket bail tests passed!\n");
     return 0;
 }
@@ -0,0 +1,257 @@
+/* Claim sections: the bitset builder must match the reference byte-grid
+ * builder cell for cell, and cached claim-flag sections must match a fresh
+ * build after any anchor change once claim_invalidate_cf_sections() runs —
+ * while rebuilding only the flags near the change.  Capture anchor sets keep
+ * every anchor of a base far past the old 256 limit. */
+
+#define _POSIX_C_SOURCE 200809L
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "claim_section_ref.h"
+
+PlacedStructure placed_structures[MAX_PLACED_STRUCTURES];
+uint32_t placed_structure_count;
+uint16_t next_structure_id = 1;
+
+#define ISLAND 3
+
+static float frand(float lo, float hi) {
+    return lo + (hi - lo) * (float)rand() / (float)RAND_MAX;
+}
+
+static PlacedStructure *add(PlacedStructureType type, uint8_t company, float x, float y) {
+    PlacedStructure *s = &placed_structures[placed_structure_count];
+    memset(s, 0, sizeof(*s));
+    s->active = true;
+    s->id = (uint16_t)(placed_structure_count + 1);
+    s->type = type;
+    s->company_id = company;
+    s->island_id = ISLAND;
+    s->x = x;
+    s->y = y;
+    s->fortress_complete = true;
+    placed_structure_count++;
+    return s;
+}
+
+/* Random island: anchors of three companies, some orphaned, some incomplete
+ * forts, and dominator lists pointing at overlapping enemies. */
+static void make_island(int anchors, float size) {
+    memset(placed_structures, 0, sizeof(placed_structures));
+    placed_structure_count = 0;
+    for (int i = 0; i < anchors; i++) {
+        int r = rand() % 10;
+        PlacedStructureType t = r == 0 ? STRUCT_FLAG_FORT : r == 1 ? STRUCT_COMPANY_FORTRESS : STRUCT_WOODEN_FLOOR;
+        PlacedStructure *s = add(t, (uint8_t)(1 + rand() % 3), frand(0, size), frand(0, size));
+        if (rand() % 12 == 0) s->claim_orphaned = true;
+        if (t == STRUCT_FLAG_FORT && rand() % 4 == 0) s->fortress_complete = false;
+    }
+    for (uint32_t i = 0; i < placed_structure_count; i++) {
+        PlacedStructure *s = &placed_structures[i];
+        for (uint32_t j = 0; j < placed_structure_count && s->dominator_count < MAX_DOMINATORS; j++) {
+            PlacedStructure *o = &placed_structures[j];
+            if (o->company_id == s->company_id) continue;
+            float dx = o->x - s->x, dy = o->y - s->y, rr = struct_claim_radius(o->type) + struct_claim_radius(s->type);
+            if (dx * dx + dy * dy < rr * rr && rand() % 2) s->dominators[s->dominator_count++] = o->id;
+        }
+    }
+    structure_index_rebuild();
+}
+
+static void expect_same(const ClaimSectionGrid *g, const RefSectionGrid *r) {
+    if (!r) { assert(!g); return; }
+    assert(g);
+    size_t ref_cells = 0, got_cells = 0;
+    for (int y = 0; y < r->h; y++)
+        for (int x = 0; x < r->w; x++) {
+            float wx = r->origin_x + ((float)x + 0.5f) * r->cell_size;
+            float wy = r->origin_y + ((float)y + 0.5f) * r->cell_size;
+            bool in = r->cells[(size_t)y * r->w + x] != 0;
+            ref_cells += in;
+            assert(claim_section_contains(g, wx, wy) == in);
+        }
+    for (int y = 0; y < g->h; y++)
+        for (int k = 0; k < g->stride; k++) got_cells += (size_t)__builtin_popcountll(g->bits[(size_t)y * g->stride + k]);
+    assert(got_cells == ref_cells);
+}
+
+static void test_matches_reference(void) {
+    srand(7);
+    int sections = 0;
+    for (int round = 0; round < 8; round++) {
+        make_island(30 + round * 8, 2500.0f);
+        for (int q = 0; q < 16; q++) {
+            /* Half the queries between two anchors, where contests are */
+            const PlacedStructure *a = &placed_structures[rand() % placed_structure_count];
+            const PlacedStructure *b = &placed_structures[rand() % placed_structure_count];
+            float px = q & 1 ? frand(0, 2500.0f) : (a->x + b->x) * 0.5f;
+            float py = q & 1 ? frand(0, 2500.0f) : (a->y + b->y) * 0.5f;
+            uint8_t co = q & 1 ? (uint8_t)(1 + rand() % 3) : a->company_id;
+            RefSectionGrid *r = ref_section_build(ISLAND, co, px, py);
+            ClaimSectionGrid *g = claim_section_build(ISLAND, co, px, py);
+            expect_same(g, r);
+            for (int d = 0; d < 20 && r; d++) {
+                float cx = frand(-200, 2700), cy = frand(-200, 2700), cr = frand(10, 700);
+                assert(claim_section_disc_overlaps(g, cx, cy, cr) == ref_section_disc_overlaps(r, cx, cy, cr));
+            }
+            sections += r != NULL;
+            ref_section_free(r);
+            claim_section_free(g);
+        }
+    }
+    printf("  bitset sections match the byte-grid reference (%d non-empty)\n", sections);
+}
+
+/* Flags on the midpoints of overlapping (mine, enemy) anchor pairs */
+static int place_flags(PlacedStructure **flags, int max) {
+    int n = 0;
+    uint32_t anchors = placed_structure_count;
+    for (uint32_t i = 0; i < anchors && n < max; i++)
+        for (uint32_t j = i + 1; j < anchors && n < max; j++) {
+            PlacedStructure *a = &placed_structures[i], *b = &placed_structures[j];
+            if (a->company_id == b->company_id) continue;
+            float dx = a->x - b->x, dy = a->y - b->y;
+            if (dx * dx + dy * dy > 500.0f * 500.0f) continue;
+            flags[n] = add(STRUCT_CLAIM_FLAG, a->company_id, (a->x + b->x) * 0.5f, (a->y + b->y) * 0.5f);
+            flags[n]->claim_linked_fort = a->id;
+            n++;
+            break;
+        }
+    structure_index_rebuild();
+    return n;
+}
+
+static void expect_cache_fresh(PlacedStructure **flags, int n) {
+    for (int f = 0; f < n; f++) {
+        if (!flags[f]->active) continue;
+        RefSectionGrid *r = ref_section_build(flags[f]->island_id, flags[f]->company_id, flags[f]->x, flags[f]->y);
+        expect_same(claim_flag_section(flags[f]), r);
+        ref_section_free(r);
+    }
+}
+
+static void test_incremental_cache(void) {
+    srand(11);
+    make_island(80, 4000.0f);
+    PlacedStructure *flags[32];
+    int n = place_flags(flags, 32);
+    assert(n >= 20);
+    claim_invalidate_cf_sections();
+    expect_cache_fresh(flags, n);
+
+    uint64_t rebuilt = 0;
+    int changes = 0;
+    for (int step = 0; step < 30; step++) {
+        PlacedStructure *a = &placed_structures[rand() % 80];
+        switch (step % 6) {
+        case 0: a->claim_orphaned = !a->claim_orphaned; break;
+        case 1: a->active = false; break;                        /* destroyed in place */
+        case 2: a->company_id = (uint8_t)(1 + a->company_id % 3); break;
+        case 3: if (a->dominator_count > 0) a->dominator_count--; break;
+        case 4:
+            if (a->type == STRUCT_FLAG_FORT) a->fortress_complete = !a->fortress_complete;
+            else                             a->type = STRUCT_FLAG_FORT;
+            break;
+        case 5: add(STRUCT_WOODEN_FLOOR, (uint8_t)(1 + rand() % 3), frand(0, 4000.0f), frand(0, 4000.0f)); break;
+        }
+        claim_invalidate_cf_sections();
+        uint64_t before = claim_section_build_count();
+        for (int f = 0; f < n; f++) (void)claim_flag_section(flags[f]);
+        rebuilt += claim_section_build_count() - before;
+        changes++;
+        expect_cache_fresh(flags, n);   /* no further builds: all cached */
+    }
+    assert(rebuilt < (uint64_t)(changes * n) / 2);
+    printf("  %d flags stay exact over %d anchor changes; %.1f rebuilt per change\n",
+           n, changes, (double)rebuilt / changes);
+
+    /* A flag that goes away is forgotten on the next sync */
+    flags[0]->active = false;
+    claim_invalidate_cf_sections();
+    uint64_t before = claim_section_build_count();
+    flags[0]->active = true;
+    (void)claim_flag_section(flags[0]);
+    assert(claim_section_build_count() == before + 1);
+    printf("  removed flags drop their cached section\n");
+}
+
+/* Whether ps is one of the capture's anchors for company co */
+static bool capture_anchor(const PlacedStructure *ps, uint8_t co) {
+    return ps->active && !ps->claim_orphaned && ps->island_id == ISLAND && ps->company_id == co &&
+           ps->type != STRUCT_CLAIM_FLAG && !(ps->type == STRUCT_FLAG_FORT && !ps->fortress_complete);
+}
+
+static bool covered_by(uint8_t co, float x, float y) {
+    for (uint32_t i = 0; i < placed_structure_count; i++) {
+        const PlacedStructure *ps = &placed_structures[i];
+        if (!capture_anchor(ps, co)) continue;
+        float dx = x - ps->x, dy = y - ps->y, r = struct_claim_radius(ps->type);
+        if (dx * dx + dy * dy <= r * r) return true;
+    }
+    return false;
+}
+
+static void expect_set(const ClaimAnchorSet *set, uint8_t co) {
+    uint32_t k = 0;
+    for (uint32_t i = 0; i < placed_structure_count; i++) {
+        const PlacedStructure *ps = &placed_structures[i];
+        if (!capture_anchor(ps, co)) continue;
+        assert(k < set->n && set->id[k] == ps->id);
+        assert(set->x[k] == ps->x && set->y[k] == ps->y && set->r[k] == struct_claim_radius(ps->type));
+        k++;
+    }
+    assert(k == set->n);
+}
+
+static void test_capture_anchors(void) {
+    srand(36);
+    make_island(1200, 6000.0f);
+    /* Noise the gather must skip: another island, claim flags */
+    for (int i = 0; i < 40; i++) {
+        add(STRUCT_WOODEN_FLOOR, 1, frand(0, 6000.0f), frand(0, 6000.0f))->island_id = ISLAND + 1;
+        add(STRUCT_CLAIM_FLAG, 2, frand(0, 6000.0f), frand(0, 6000.0f));
+    }
+    /* A far corner held only by the last anchors in slot order */
+    for (int i = 0; i < 20; i++) {
+        add(STRUCT_WOODEN_FLOOR, 1, 9000.0f + 30.0f * (float)i, 9000.0f);
+        add(STRUCT_WOODEN_FLOOR, 2, 9000.0f + 30.0f * (float)i, 9050.0f);
+    }
+    structure_index_rebuild();
+
+    ClaimAnchorSet mine, enemy;
+    assert(claim_capture_anchors(ISLAND, 1, 2, &mine, &enemy));
+    assert(mine.n > 256 && enemy.n > 256);
+    expect_set(&mine, 1);
+    expect_set(&enemy, 2);
+
+    int in_both = 0;
+    for (int q = 0; q < 20000; q++) {
+        float x = frand(-500, 10000), y = frand(-500, 10000);
+        bool m = claim_anchor_set_covers(&mine, x, y), e = claim_anchor_set_covers(&enemy, x, y);
+        assert(m == covered_by(1, x, y) && e == covered_by(2, x, y));
+        in_both += m && e;
+    }
+    assert(claim_anchor_set_covers(&mine, 9570.0f, 9025.0f) && claim_anchor_set_covers(&enemy, 9570.0f, 9025.0f));
+    uint32_t n_mine = mine.n, n_enemy = enemy.n;
+
+    /* Reusing the pool for a different pair, then an empty one */
+    assert(claim_capture_anchors(ISLAND, 3, 1, &mine, &enemy));
+    expect_set(&mine, 3);
+    expect_set(&enemy, 1);
+    assert(claim_capture_anchors(ISLAND + 7, 1, 2, &mine, &enemy));
+    assert(mine.n == 0 && enemy.n == 0 && !claim_anchor_set_covers(&mine, 9000.0f, 9000.0f));
+    printf("  capture keeps all %u + %u anchors on a large base (%d contested samples)\n",
+           n_mine, n_enemy, in_both);
+}
+
+int main(void) {
+    printf("Testing claim sections...\n");
+    test_matches_reference();
+    test_incremental_cache();
+    test_capture_anchors();
+    printf("All claim section tests passed!\n");
+    return 0;
+}
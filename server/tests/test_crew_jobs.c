@@ -0,0 +1,154 @@
+/* Crew job board: NEEDED weapons are listed once, adopted from a fresh
+ * board and dropped when cleared or removed; repair jobs follow module
+ * damage (module_epoch) and placement/removal (module_count), and repaired
+ * modules fall off without a rebuild. */
+
+#define _POSIX_C_SOURCE 200809L
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "net/crew_jobs.h"
+
+ShipModule* find_module_on_ship(SimpleShip* ship, uint32_t module_id) {
+    for (int m = 0; m < ship->module_count; m++)
+        if (ship->modules[m].id == module_id) return &ship->modules[m];
+    return NULL;
+}
+
+static SimpleShip  ship;
+static struct Ship sim;
+
+#define SEQ 7
+
+static ShipModule* add(ShipModule* mods, uint8_t* count, uint8_t offset, ModuleTypeId type,
+                       int32_t health, int32_t max_health) {
+    ShipModule* m = &mods[(*count)++];
+    memset(m, 0, sizeof(*m));
+    m->id = MID(SEQ, offset);
+    m->type_id = type;
+    m->health = health;
+    m->max_health = max_health;
+    return m;
+}
+
+static bool listed(module_id_t id) {
+    int n;
+    const module_id_t* ids = crew_jobs_needed_weapons(&ship, &n);
+    for (int k = 0; k < n; k++)
+        if (ids[k] == id) return true;
+    return false;
+}
+
+static void test_weapons(void) {
+    memset(&ship, 0, sizeof(ship));
+    ship.ship_seq = SEQ;
+    ShipModule* c0 = add(ship.modules, &ship.module_count, 0x30, MODULE_TYPE_CANNON, 100, 100);
+    ShipModule* c1 = add(ship.modules, &ship.module_count, 0x31, MODULE_TYPE_CANNON, 100, 100);
+    add(ship.modules, &ship.module_count, 0x40, MODULE_TYPE_MAST, 100, 100);
+    ShipModule* sw = add(ship.modules, &ship.module_count, 0x50, MODULE_TYPE_SWIVEL, 100, 100);
+
+    /* Loaded with a bit already set: adopted on first use */
+    c1->state_bits |= MODULE_STATE_NEEDED;
+    int n;
+    crew_jobs_needed_weapons(&ship, &n);
+    assert(n == 1 && listed(c1->id));
+
+    crew_jobs_weapon_needed(&ship, c0);
+    crew_jobs_weapon_needed(&ship, c0);   /* aim updates repeat every tick */
+    crew_jobs_weapon_needed(&ship, sw);
+    crew_jobs_weapon_needed(&ship, c1);
+    const module_id_t* ids = crew_jobs_needed_weapons(&ship, &n);
+    assert(n == 3 && ids[0] == c1->id && ids[1] == c0->id && ids[2] == sw->id);
+    assert(c0->state_bits & MODULE_STATE_NEEDED);
+
+    /* Cleared by a mode change or expiry: drops out when walked */
+    c0->state_bits &= ~MODULE_STATE_NEEDED;
+    assert(!listed(c0->id) && ship.crew_needed_count == 2);
+
+    /* Needed again after being dropped: listed again, once */
+    crew_jobs_weapon_needed(&ship, c0);
+    crew_jobs_weapon_needed(&ship, c0);
+    crew_jobs_needed_weapons(&ship, &n);
+    assert(n == 3);
+
+    /* Removed from the ship (swap-remove) */
+    ship.modules[3] = ship.modules[--ship.module_count];
+    assert(!listed(MID(SEQ, 0x50)) && listed(c0->id) && listed(c1->id));
+    printf("  weapons: listed once, adopted, dropped when cleared or removed\n");
+}
+
+static int count_kind(const CrewRepairJob* jobs, int n, CrewJobKind kind) {
+    int c = 0;
+    for (int k = 0; k < n; k++) c += jobs[k].kind == kind;
+    return c;
+}
+
+static void test_repairs(void) {
+    memset(&ship, 0, sizeof(ship));
+    memset(&sim, 0, sizeof(sim));
+    ship.ship_seq = SEQ;
+    for (int k = 0; k < 10; k++)
+        add(sim.modules, &sim.module_count, MODULE_OFFSET_PLANK(k), MODULE_TYPE_PLANK, 100, 100);
+    add(sim.modules, &sim.module_count, MODULE_OFFSET_DECK, MODULE_TYPE_DECK, 100, 100);
+    ShipModule* mast = add(sim.modules, &sim.module_count, 0x40, MODULE_TYPE_MAST, 100, 100);
+    mast->data.mast.fiber_max_health = Q16_FROM_FLOAT(100.0f);
+    mast->data.mast.fiber_health     = Q16_FROM_FLOAT(100.0f);
+    ShipModule* cannon = add(sim.modules, &sim.module_count, 0x30, MODULE_TYPE_CANNON, 100, 100);
+
+    int n;
+    crew_jobs_repairs(&ship, &sim, &n);
+    assert(n == 0);
+
+    /* Damage without an epoch bump is not seen — the board is only rebuilt
+     * on events — and is seen once the damage site bumps it */
+    cannon->health = 40;
+    crew_jobs_repairs(&ship, &sim, &n);
+    assert(n == 0);
+    sim.module_epoch++;
+    const CrewRepairJob* jobs = crew_jobs_repairs(&ship, &sim, &n);
+    assert(n == 1 && jobs[0].kind == CREW_JOB_MODULE && jobs[0].module_id == cannon->id);
+    float ratio;
+    assert(crew_job_module(&sim, &jobs[0], &ratio) == cannon && ratio == 0.4f);
+
+    /* Sail damage counts for masts */
+    mast->data.mast.fiber_health = Q16_FROM_FLOAT(50.0f);
+    sim.module_epoch++;
+    jobs = crew_jobs_repairs(&ship, &sim, &n);
+    assert(n == 2 && count_kind(jobs, n, CREW_JOB_MODULE) == 2);
+
+    /* Repaired: drops out without a rebuild */
+    cannon->health = 100;
+    jobs = crew_jobs_repairs(&ship, &sim, &n);
+    assert(n == 1 && jobs[0].module_id == mast->id);
+
+    /* Destroyed planks and a removed deck: the count change alone rebuilds */
+    sim.modules[3].health = 0;
+    sim.modules[3].state_bits |= MODULE_STATE_DESTROYED;
+    module_id_t mast_id = mast->id;
+    sim.modules[10] = sim.modules[11];                           /* deck gone; */
+    sim.modules[11] = sim.modules[12];                           /* mast moves */
+    sim.module_count--;
+    jobs = crew_jobs_repairs(&ship, &sim, &n);
+    assert(count_kind(jobs, n, CREW_JOB_DECK) == 1 && jobs[0].kind == CREW_JOB_DECK);
+    assert(count_kind(jobs, n, CREW_JOB_PLANK) == 1);
+    for (int k = 0; k < n; k++)
+        if (jobs[k].kind == CREW_JOB_PLANK) assert(jobs[k].slot == 3 && jobs[k].module_id == MID(SEQ, MODULE_OFFSET_PLANK(3)));
+    assert(!crew_jobs_plank_intact(&sim, SEQ, 3) && crew_jobs_plank_intact(&sim, SEQ, 4));
+
+    for (int k = 0; k < n; k++)
+        if (jobs[k].kind == CREW_JOB_MODULE) assert(crew_job_module(&sim, &jobs[k], NULL) == &sim.modules[10]);
+
+    /* A job whose cached slot went stale still finds its module */
+    CrewRepairJob stale = { mast_id, CREW_JOB_MODULE, 11 };
+    assert(crew_job_module(&sim, &stale, NULL) == &sim.modules[10]);
+    printf("  repairs: rebuilt on damage and removal, repaired jobs drop out\n");
+}
+
+int main(void) {
+    printf("Testing crew job board...\n");
+    test_weapons();
+    test_repairs();
+    printf("All crew job board tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,240 @@
+/* Dock broad phase and sleeping: queries return exactly the filed docks
+ * whose AABB overlaps the query box, in ascending order and each once
+ * (boxes spanning several cells, negative coordinates, touching edges);
+ * rotated dock boxes enclose their corners; rebuilding replaces the filed
+ * set.  A ship at rest in a dock sleeps after DOCK_SLEEP_TICKS solves and
+ * wakes when it speeds up, drifts or the dock goes away; warm starts of two
+ * docks whose slots are 256 apart don't mix. */
+
+#define _POSIX_C_SOURCE 200809L
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "net/dock_broadphase.h"
+#include "net/dock_physics.h"
+#include "net/structure_index.h"
+#include "net/websocket_server_internal.h"
+
+PlacedStructure placed_structures[MAX_PLACED_STRUCTURES];
+uint32_t placed_structure_count;
+uint16_t next_structure_id = 1;
+struct Sim* global_sim;
+
+#define DOCK_SLEEP_TICKS 15   /* Mirrors dock_physics.c */
+
+static struct Sim g_sim;
+
+static DockBox box_around(float x, float y, float hx, float hy) {
+    return (DockBox){ x - hx, y - hy, x + hx, y + hy };
+}
+
+static void test_obb_box(void) {
+    DockBox flat = dock_bp_obb_box(100.0f, 200.0f, 170.0f, 420.0f, 0.0f);
+    assert(fabsf(flat.min_x + 70.0f) < 0.01f && fabsf(flat.max_x - 270.0f) < 0.01f);
+    assert(fabsf(flat.min_y + 220.0f) < 0.01f && fabsf(flat.max_y - 620.0f) < 0.01f);
+
+    /* A quarter turn swaps the extents, a half turn and a full turn more
+     * change nothing */
+    DockBox quarter = dock_bp_obb_box(0.0f, 0.0f, 170.0f, 420.0f, 90.0f);
+    assert(fabsf(quarter.max_x - 420.0f) < 0.01f && fabsf(quarter.max_y - 170.0f) < 0.01f);
+    DockBox turned = dock_bp_obb_box(100.0f, 200.0f, 170.0f, 420.0f, 540.0f);
+    assert(fabsf(turned.min_x - flat.min_x) < 0.01f && fabsf(turned.max_y - flat.max_y) < 0.01f);
+
+    /* 45°: both extents are (hx + hy) / √2 */
+    DockBox diag = dock_bp_obb_box(-3000.0f, -3000.0f, 170.0f, 420.0f, -45.0f);
+    float e = (170.0f + 420.0f) * 0.70710678f;
+    assert(fabsf(diag.max_x + 3000.0f - e) < 0.01f && fabsf(diag.min_y + 3000.0f + e) < 0.01f);
+    printf("  rotated dock boxes enclose their corners\n");
+}
+
+static void test_queries(void) {
+    /* One dock straddling the x = 0 and y = 0 cell borders, one spanning
+     * three cells, one at negative coordinates far away */
+    DockBox docks[3] = {
+        box_around(0.0f, 0.0f, 200.0f, 200.0f),
+        box_around(2048.0f, 512.0f, 1100.0f, 100.0f),
+        box_around(-50000.0f, -70000.0f, 170.0f, 420.0f),
+    };
+    dock_bp_build(docks, 3);
+    assert(dock_bp_count() == 3);
+
+    uint16_t out[4];
+    /* Inside the straddling dock, from each of its four cells */
+    for (int c = 0; c < 4; c++) {
+        DockBox q = box_around((c & 1) ? 100.0f : -100.0f, (c & 2) ? 100.0f : -100.0f, 5.0f, 5.0f);
+        assert(dock_bp_query(&q, out, 4) == 1 && out[0] == 0);
+    }
+    /* A box covering all three cells of the wide dock finds it once */
+    DockBox wide = box_around(2048.0f, 512.0f, 1500.0f, 50.0f);
+    assert(dock_bp_query(&wide, out, 4) == 1 && out[0] == 1);
+    /* Far away and negative */
+    DockBox far = box_around(-50000.0f, -69700.0f, 10.0f, 10.0f);
+    assert(dock_bp_query(&far, out, 4) == 1 && out[0] == 2);
+    DockBox sea = box_around(-20000.0f, 30000.0f, 600.0f, 600.0f);
+    assert(dock_bp_query(&sea, out, 4) == 0);
+
+    /* Touching edges count; a box just past does not */
+    DockBox edge = { 200.0f, -10.0f, 300.0f, 10.0f };
+    assert(dock_bp_query(&edge, out, 4) == 1 && out[0] == 0);
+    DockBox past = { 200.5f, -10.0f, 300.0f, 10.0f };
+    assert(dock_bp_query(&past, out, 4) == 0);
+
+    /* Ascending order; results beyond cap are left out */
+    DockBox both = box_around(1000.0f, 0.0f, 2000.0f, 600.0f);
+    assert(dock_bp_query(&both, out, 4) == 2 && out[0] == 0 && out[1] == 1);
+    assert(dock_bp_query(&both, out, 1) == 1 && out[0] == 0);
+
+    /* Rebuilding drops docks that are gone */
+    dock_bp_build(docks, 1);
+    assert(dock_bp_count() == 1);
+    assert(dock_bp_query(&wide, out, 4) == 0);
+    dock_bp_build(docks, 0);
+    assert(dock_bp_query(&edge, out, 4) == 0);
+    printf("  cell borders, multi-cell boxes, edges, cap and rebuilds\n");
+}
+
+/* ── Sleeping and warm starts through handle_ship_dock_collisions() ─────── */
+
+static void reset_world(void) {
+    memset(placed_structures, 0, sizeof(placed_structures));
+    placed_structure_count = 0;
+    structure_index_rebuild();
+    memset(&g_sim, 0, sizeof(g_sim));
+    global_sim = &g_sim;
+    handle_ship_dock_collisions();   /* No docks: forgets every pair */
+}
+
+/* Shipyards in exactly the given slots, walls in the rest below them */
+static void place_docks(const uint32_t *slots, const float (*pos)[2], int n) {
+    uint32_t top = slots[n - 1];
+    for (uint32_t s = 0; s <= top; s++) {
+        int d = -1;
+        for (int k = 0; k < n; k++) if (slots[k] == s) d = k;
+        PlacedStructure *ps = structure_alloc(d >= 0 ? STRUCT_SHIPYARD : STRUCT_WALL);
+        assert(ps == &placed_structures[s]);
+        ps->x = d >= 0 ? pos[d][0] : -90000.0f;
+        ps->y = d >= 0 ? pos[d][1] : -90000.0f;
+    }
+}
+
+/* 200 × 40 px box hull lying along x */
+static struct Ship *add_ship(float x, float y) {
+    struct Ship *s = &g_sim.ships[g_sim.ship_count++];
+    s->id = (entity_id)(100 + g_sim.ship_count);
+    const float hx = 100.0f, hy = 20.0f;
+    const float cx[4] = { -hx, hx, hx, -hx }, cy[4] = { -hy, -hy, hy, hy };
+    for (int i = 0; i < 4; i++)
+        s->hull_vertices[i] = (Vec2Q16){ Q16_FROM_FLOAT(CLIENT_TO_SERVER(cx[i])),
+                                         Q16_FROM_FLOAT(CLIENT_TO_SERVER(cy[i])) };
+    s->hull_vertex_count = 4;
+    s->bounding_radius = Q16_FROM_FLOAT(CLIENT_TO_SERVER(sqrtf(hx * hx + hy * hy)));
+    s->mass = Q16_FROM_FLOAT(500.0f);
+    s->moment_inertia = Q16_FROM_FLOAT(50.0f);
+    s->position.x = Q16_FROM_FLOAT(CLIENT_TO_SERVER(x));
+    s->position.y = Q16_FROM_FLOAT(CLIENT_TO_SERVER(y));
+    return s;
+}
+
+static void tick(uint32_t want_solved, uint32_t want_sleeping) {
+    uint32_t solved, sleeping;
+    handle_ship_dock_collisions();
+    dock_physics_last_counts(&solved, &sleeping);
+    assert(solved == want_solved && sleeping == want_sleeping);
+}
+
+/* DOCK_SLEEP_TICKS quiet solves, then asleep */
+static void settle(void) {
+    for (int t = 0; t < DOCK_SLEEP_TICKS; t++) tick(1, 0);
+    tick(0, 1);
+    tick(0, 1);
+}
+
+static void test_sleep_wake(void) {
+    reset_world();
+    static const uint32_t slot[1] = { 5 };
+    static const float pos[1][2] = { { 0.0f, 0.0f } };
+    place_docks(slot, pos, 1);
+    struct Ship *ship = add_ship(0.0f, 0.0f);   /* Clear of every wall */
+
+    settle();
+
+    /* Speeding up wakes the pair; it counts from zero once slow again */
+    ship->velocity.y = Q16_FROM_FLOAT(CLIENT_TO_SERVER(10.0f));
+    tick(1, 0);
+    tick(1, 0);
+    ship->velocity.y = 0;
+    settle();
+
+    /* Turning wakes it */
+    ship->angular_velocity = Q16_FROM_FLOAT(0.05f);
+    tick(1, 0);
+    ship->angular_velocity = 0;
+    settle();
+
+    /* Drifting a pixel off the resting pose wakes it; less does not */
+    ship->position.x += Q16_FROM_FLOAT(CLIENT_TO_SERVER(0.25f));
+    tick(0, 1);
+    ship->position.x += Q16_FROM_FLOAT(CLIENT_TO_SERVER(1.0f));
+    settle();
+
+    /* The dock going away drops the pair; a new dock starts from scratch */
+    structure_free(&placed_structures[5]);
+    tick(0, 0);
+    structure_store_reclaim();
+    PlacedStructure *again = structure_alloc(STRUCT_SHIPYARD);
+    again->x = again->y = 0.0f;
+    settle();
+
+    /* A ship pressed into a wall is corrected every tick and never sleeps */
+    ship->position.x = Q16_FROM_FLOAT(CLIENT_TO_SERVER(40.0f));
+    ship->velocity.x = Q16_FROM_FLOAT(CLIENT_TO_SERVER(60.0f));
+    for (int t = 0; t < 3 * DOCK_SLEEP_TICKS; t++) {
+        ship->velocity.x = Q16_FROM_FLOAT(CLIENT_TO_SERVER(60.0f));
+        ship->position.x += Q16_FROM_FLOAT(CLIENT_TO_SERVER(2.0f));
+        tick(1, 0);
+    }
+    printf("  ships at rest sleep; speed, turn, drift and dock removal wake them\n");
+}
+
+typedef struct { q16_t x, y, vx, vy, w; } Pose;
+
+/* Two docks in `slots` on the same spot, a ship driven into their shared
+ * starboard arm every tick; its pose after every tick */
+static void run_pair(const uint32_t *slots, Pose *out, int ticks) {
+    reset_world();
+    static const float pos[2][2] = { { 0.0f, 0.0f }, { 0.0f, 0.0f } };
+    place_docks(slots, pos, 2);
+    struct Ship *ship = add_ship(30.0f, 0.0f);
+    for (int t = 0; t < ticks; t++) {
+        ship->velocity.x = Q16_FROM_FLOAT(CLIENT_TO_SERVER(40.0f));
+        ship->velocity.y = Q16_FROM_FLOAT(CLIENT_TO_SERVER(20.0f));
+        ship->position.x += Q16_FROM_FLOAT(CLIENT_TO_SERVER(40.0f / TICK_RATE_HZ));
+        tick(2, 0);
+        out[t] = (Pose){ ship->position.x, ship->position.y,
+                         ship->velocity.x, ship->velocity.y, ship->angular_velocity };
+    }
+}
+
+static void test_aliased_slots(void) {
+    enum { TICKS = 20 };
+    static const uint32_t aliased[2] = { 5, 5 + 256 }, apart[2] = { 5, 6 };
+    Pose a[TICKS], b[TICKS];
+    run_pair(aliased, a, TICKS);
+    run_pair(apart, b, TICKS);
+    assert(memcmp(a, b, sizeof(a)) == 0);
+    /* The arm pushed back */
+    assert(a[TICKS - 1].vx < Q16_FROM_FLOAT(CLIENT_TO_SERVER(40.0f)));
+    printf("  docks in slots 5 and 261 warm-start independently\n");
+}
+
+int main(void) {
+    printf("Testing dock broad phase...\n");
+    test_obb_box();
+    test_queries();
+    test_sleep_wake();
+    test_aliased_slots();
+    printf("All dock broad phase tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,165 @@
+/* Hazard grid: a point inside a registered cone always has that cone's bit
+ * in its sample (at the apex, on the rim, and for cones crossing the ±π
+ * seam, slivers and cones wider than a half-turn); far-away points sample
+ * 0; overlapping cones share cells; the source table fills to exactly
+ * HAZARD_MAX_SOURCES; waves that expire between ticks leave their cells;
+ * and overfilling the cell table falls back to reporting every source. */
+
+#define _POSIX_C_SOURCE 200809L
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+
+#include "net/hazard_grid.h"
+
+#define PI_F     3.14159265f
+
+static bool in_cone(const HazardSource *h, float x, float y) {
+    float dx = x - h->ox, dy = y - h->oy;
+    float d = sqrtf(dx * dx + dy * dy);
+    if (d > h->reach) return false;
+    if (d < 0.01f) return true;
+    float c = (dx * h->dir_x + dy * h->dir_y) / d;
+    return acosf(fminf(1.0f, fmaxf(-1.0f, c))) <= h->half_angle;
+}
+
+/* Every in-cone point of a 16 px lattice over the cone's box, plus apex
+ * and rim points, has the cone's bit */
+static void check_cone(uint32_t i) {
+    const HazardSource *h = hazard_grid_source(i);
+    uint32_t bit = 1u << i;
+    for (float y = h->oy - h->reach; y <= h->oy + h->reach; y += 16.0f)
+        for (float x = h->ox - h->reach; x <= h->ox + h->reach; x += 16.0f)
+            if (in_cone(h, x, y)) assert(hazard_grid_sample(x, y) & bit);
+    float base = atan2f(h->dir_y, h->dir_x);
+    for (float t = -0.999f; t <= 1.0f; t += 0.333f) {
+        float a = base + h->half_angle * t;
+        for (float r = 0.001f; r < 1.0f; r += 0.333f) {
+            float x = h->ox + h->reach * r * cosf(a), y = h->oy + h->reach * r * sinf(a);
+            if (in_cone(h, x, y)) assert(hazard_grid_sample(x, y) & bit);
+        }
+        float x = h->ox + h->reach * 0.999f * cosf(a), y = h->oy + h->reach * 0.999f * sinf(a);
+        if (in_cone(h, x, y)) assert(hazard_grid_sample(x, y) & bit);
+    }
+    assert(hazard_grid_sample(h->ox, h->oy) & bit);
+}
+
+static void test_shapes(void) {
+    hazard_grid_clear();
+    /* Flamethrower cone, one across the ±π seam, one across a cell corner at
+     * negative coordinates, a sliver, and one wider than a half-turn */
+    assert(hazard_grid_add_cone(HAZARD_FLAME, 0, 1000.0f, 1000.0f, 0.3f, 0.44f, 320.0f) == 0);
+    assert(hazard_grid_add_cone(HAZARD_FLAME, 1, 3000.0f, 0.0f, PI_F, 0.44f, 320.0f) == 1);
+    assert(hazard_grid_add_cone(HAZARD_FLAME, 2, -128.0f, -64.0f, -2.0f, 0.6f, 250.0f) == 2);
+    assert(hazard_grid_add_cone(HAZARD_FLAME, 3, -3000.0f, 2000.0f, 1.0f, 0.02f, 400.0f) == 3);
+    assert(hazard_grid_add_cone(HAZARD_FLAME, 4, 5000.0f, 5000.0f, -0.5f, 2.5f, 200.0f) == 4);
+    for (uint32_t i = 0; i < 5; i++) check_cone(i);
+
+    /* Behind the apex of the narrow cones is out of their cells */
+    assert(!(hazard_grid_sample(1000.0f - 200.0f * cosf(0.3f), 1000.0f - 200.0f * sinf(0.3f)) & 1u));
+    assert(!(hazard_grid_sample(3300.0f, 0.0f) & 2u));
+    printf("  apex, rim and interior of seam-crossing, sliver and wide cones\n");
+}
+
+static void test_source_cap(void) {
+    hazard_grid_clear();
+    /* One small cone per source, each in its own cell block */
+    for (int i = 0; i < HAZARD_MAX_SOURCES - 1; i++)
+        assert(hazard_grid_add_cone(HAZARD_FLAME, (uint32_t)i, 1000.0f * (float)i, 0.0f,
+                                    0.0f, 0.4f, 100.0f) == i);
+    assert(hazard_grid_source_count() == HAZARD_MAX_SOURCES - 1);
+
+    /* The last slot takes the top mask bit */
+    int last = hazard_grid_add_cone(HAZARD_FLAME, 77, -5000.0f, -5000.0f, 0.0f, 0.4f, 100.0f);
+    assert(last == HAZARD_MAX_SOURCES - 1);
+    assert(hazard_grid_sample(-4950.0f, -5000.0f) == 1u << (HAZARD_MAX_SOURCES - 1));
+    assert(hazard_grid_source((uint32_t)last)->owner == 77);
+    for (uint32_t i = 0; i < HAZARD_MAX_SOURCES; i++) check_cone(i);
+
+    /* One more is refused and stamps nothing */
+    assert(hazard_grid_add_cone(HAZARD_FLAME, 78, 9000.0f, 9000.0f, 0.0f, 0.4f, 100.0f) == -1);
+    assert(hazard_grid_source_count() == HAZARD_MAX_SOURCES);
+    assert(hazard_grid_source(HAZARD_MAX_SOURCES) == NULL);
+    assert(hazard_grid_sample(9050.0f, 9000.0f) == 0);
+
+    /* Clearing frees the table again */
+    hazard_grid_clear();
+    assert(hazard_grid_add_cone(HAZARD_FLAME, 78, 9000.0f, 9000.0f, 0.0f, 0.4f, 100.0f) == 0);
+    assert(hazard_grid_sample(9050.0f, 9000.0f) == 1u);
+    printf("  source table fills to HAZARD_MAX_SOURCES and refuses the next\n");
+}
+
+/* Flame waves re-register every tick, as the flame pass does: a wave that
+ * expires leaves its cells, a growing wave covers new ones, and survivors
+ * take new bits */
+static void test_expiry(void) {
+    /* Tick 1: three waves */
+    hazard_grid_clear();
+    hazard_grid_add_cone(HAZARD_FLAME, 0, 0.0f, 0.0f, 0.0f, 0.44f, 120.0f);
+    hazard_grid_add_cone(HAZARD_FLAME, 1, 2000.0f, 0.0f, 0.0f, 0.44f, 120.0f);
+    hazard_grid_add_cone(HAZARD_FLAME, 2, 200.0f, 0.0f, PI_F, 0.44f, 120.0f);
+    assert(hazard_grid_sample(100.0f, 0.0f) == 5u);     /* waves 0 and 2 overlap */
+    assert(hazard_grid_sample(2100.0f, 0.0f) == 2u);
+
+    /* Tick 2: wave 0 expired, wave 1 grew */
+    hazard_grid_clear();
+    hazard_grid_add_cone(HAZARD_FLAME, 1, 2000.0f, 0.0f, 0.0f, 0.44f, 320.0f);
+    hazard_grid_add_cone(HAZARD_FLAME, 2, 200.0f, 0.0f, PI_F, 0.44f, 120.0f);
+    assert(hazard_grid_source(0)->owner == 1 && hazard_grid_source(1)->owner == 2);
+    assert(hazard_grid_sample(10.0f, 0.0f) == 0);        /* wave 0's own cells */
+    assert(hazard_grid_sample(100.0f, 0.0f) == 2u);
+    assert(hazard_grid_sample(2300.0f, 0.0f) == 1u);     /* wave 1's new reach */
+    check_cone(0);
+    check_cone(1);
+
+    /* Tick 3: everything burnt out */
+    hazard_grid_clear();
+    assert(hazard_grid_sample(100.0f, 0.0f) == 0 && hazard_grid_sample(2300.0f, 0.0f) == 0);
+    printf("  expired waves leave their cells; survivors move to new bits\n");
+}
+
+static void test_edges(void) {
+    hazard_grid_clear();
+    assert(hazard_grid_sample(0.0f, 0.0f) == 0);
+
+    /* Two flame cones from the same swivel spot, one rotated 90° */
+    assert(hazard_grid_add_cone(HAZARD_FLAME, 3, 1000.0f, 1000.0f, 0.0f, 0.44f, 320.0f) == 0);
+    assert(hazard_grid_add_cone(HAZARD_FLAME, 7, 1000.0f, 1000.0f, PI_F / 2.0f, 0.44f, 320.0f) == 1);
+    assert(hazard_grid_source(1)->owner == 7 && hazard_grid_source(2) == NULL);
+    assert(hazard_grid_sample(1000.0f, 1000.0f) == 3u);      /* apex: both    */
+    assert(hazard_grid_sample(1300.0f, 1000.0f) & 1u);       /* tip of first  */
+    assert(hazard_grid_sample(1000.0f, 1300.0f) & 2u);       /* tip of second */
+    assert(hazard_grid_sample(600.0f, 1000.0f) == 0);        /* behind apex   */
+    assert(hazard_grid_sample(-50000.0f, 80000.0f) == 0);
+
+    /* Clearing drops sources and cells */
+    hazard_grid_clear();
+    assert(hazard_grid_source_count() == 0);
+    assert(hazard_grid_sample(1000.0f, 1000.0f) == 0);
+
+    /* Full circle around the apex: every direction is covered */
+    hazard_grid_add_cone(HAZARD_FLAME, 0, -200.0f, -200.0f, 1.0f, PI_F, 150.0f);
+    for (int k = 0; k < 64; k++) {
+        float a = 2.0f * PI_F * (float)k / 64.0f;
+        assert(hazard_grid_sample(-200.0f + 149.0f * cosf(a), -200.0f + 149.0f * sinf(a)) == 1u);
+    }
+
+    /* More stamped cells than the table takes: sampling stops pruning */
+    hazard_grid_clear();
+    hazard_grid_add_cone(HAZARD_FLAME, 0, 0.0f, 0.0f, 0.0f, PI_F, 6000.0f);
+    hazard_grid_add_cone(HAZARD_FLAME, 1, 90000.0f, 0.0f, 0.0f, 0.2f, 100.0f);
+    assert(hazard_grid_sample(-70000.0f, -70000.0f) == 3u);
+    hazard_grid_clear();
+    assert(hazard_grid_sample(-70000.0f, -70000.0f) == 0);
+    printf("  apex, rim, full circle, clear and overflow\n");
+}
+
+int main(void) {
+    printf("Testing hazard grid...\n");
+    test_edges();
+    test_shapes();
+    test_source_cap();
+    test_expiry();
+    printf("All hazard grid tests passed!\n");
+    return 0;
+}
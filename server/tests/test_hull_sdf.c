@@ -0,0 +1,236 @@
+/* Hull SDF: ships with the same hull share one baked shape; the bilinear
+ * sample stays within HULL_SDF_ERR_PX of the true signed distance (and
+ * never above it off the grid); contains / edge distance / within give
+ * exactly the full-scan answers on a brigantine hull and a notched concave
+ * one (points exactly on the hull, in and around the notches, at and past
+ * the grid edge); candidate lists always hold the nearest edge, and every
+ * edge off the grid; ships without a shape fall back to the full scan. */
+
+#define _POSIX_C_SOURCE 200809L
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "sim/hull_sdf.h"
+
+static void put(struct Ship* s, float x, float y) {
+    s->hull_vertices[s->hull_vertex_count++] =
+        (Vec2Q16){ Q16_FROM_FLOAT(CLIENT_TO_SERVER(x)), Q16_FROM_FLOAT(CLIENT_TO_SERVER(y)) };
+}
+
+/* Same outline as sim_create_ship() */
+static void brigantine(struct Ship* s) {
+    memset(s, 0, sizeof(*s));
+    for (int i = 0; i <= 12; i++) {
+        float t = (float)i / 12.0f;
+        put(s, ((1-t)*(1-t)*190.0f + 2*(1-t)*t*415.0f + t*t*190.0f) * 1.02f,
+               ((1-t)*(1-t)*90.0f + t*t*(-90.0f)) * 1.1f);
+    }
+    for (int i = 1; i <= 12; i++) put(s, 190.0f + (float)i / 12.0f * -450.0f, -99.0f);
+    for (int i = 1; i <= 12; i++) {
+        float t = (float)i / 12.0f;
+        put(s, ((1-t)*(1-t)*(-260.0f) + 2*(1-t)*t*(-345.0f) + t*t*(-260.0f)) * 1.02f,
+               ((1-t)*(1-t)*(-90.0f) + t*t*90.0f) * 1.1f);
+    }
+    for (int i = 1; i < 12; i++) put(s, -260.0f + (float)i / 12.0f * 450.0f, 99.0f);
+    s->hull_vertex_count = 47;   /* as sim_create_ship(): the 48th point is written but unused */
+}
+
+/* Box with a 80 px notch cut down from the top and a 6 px slot (under two
+ * grid cells wide) cut up from the bottom; reflex corners at (±40, -20),
+ * (117, 0) and (123, 0) */
+static void notched(struct Ship* s) {
+    static const float pts[][2] = {
+        { -200, -80 }, { 117, -80 }, { 117, 0 }, { 123, 0 }, { 123, -80 }, { 200, -80 },
+        { 200, 80 }, { 40, 80 }, { 40, -20 }, { -40, -20 }, { -40, 80 }, { -200, 80 },
+    };
+    memset(s, 0, sizeof(*s));
+    for (size_t i = 0; i < sizeof(pts) / sizeof(pts[0]); i++) put(s, pts[i][0], pts[i][1]);
+}
+
+/* ── Full-scan references ─────────────────────────────────────────────────── */
+
+static void verts(const struct Ship* s, float* vx, float* vy) {
+    for (int i = 0; i < s->hull_vertex_count; i++) {
+        vx[i] = SERVER_TO_CLIENT(Q16_TO_FLOAT(s->hull_vertices[i].x));
+        vy[i] = SERVER_TO_CLIENT(Q16_TO_FLOAT(s->hull_vertices[i].y));
+    }
+}
+
+static float seg_d2(const float* vx, const float* vy, int n, int i, float lx, float ly) {
+    int j = (i + 1) % n;
+    float ax = vx[i], ay = vy[i], edx = vx[j] - ax, edy = vy[j] - ay;
+    float len_sq = edx * edx + edy * edy, t = 0.0f;
+    if (len_sq > 1e-10f) {
+        t = ((lx - ax) * edx + (ly - ay) * edy) / len_sq;
+        if (t < 0.0f) t = 0.0f;
+        if (t > 1.0f) t = 1.0f;
+    }
+    float ex = lx - (ax + t * edx), ey = ly - (ay + t * edy);
+    return ex * ex + ey * ey;
+}
+
+static float ref_dist(const struct Ship* s, float lx, float ly, int* nearest) {
+    float vx[64], vy[64], best = 1e20f;
+    verts(s, vx, vy);
+    for (int i = 0; i < s->hull_vertex_count; i++) {
+        float d = seg_d2(vx, vy, s->hull_vertex_count, i, lx, ly);
+        if (d < best) { best = d; *nearest = (i + 1) % s->hull_vertex_count; }
+    }
+    return sqrtf(best);
+}
+
+static bool ref_inside(const struct Ship* s, float lx, float ly) {
+    float vx[64], vy[64];
+    verts(s, vx, vy);
+    bool inside = false;
+    int n = s->hull_vertex_count;
+    for (int i = 0, j = n - 1; i < n; j = i++)
+        if (((vy[i] > ly) != (vy[j] > ly)) &&
+            (lx < (vx[j] - vx[i]) * (ly - vy[i]) / (vy[j] - vy[i] + 1e-12f) + vx[i]))
+            inside = !inside;
+    return inside;
+}
+
+/* ── Checks ───────────────────────────────────────────────────────────────── */
+
+static void bounds(const struct Ship* s, float* x0, float* y0, float* x1, float* y1) {
+    float vx[64], vy[64];
+    verts(s, vx, vy);
+    *x0 = *y0 = 1e9f;
+    *x1 = *y1 = -1e9f;
+    for (int i = 0; i < s->hull_vertex_count; i++) {
+        *x0 = fminf(*x0, vx[i]); *x1 = fmaxf(*x1, vx[i]);
+        *y0 = fminf(*y0, vy[i]); *y1 = fmaxf(*y1, vy[i]);
+    }
+}
+
+/* Every query against the full scan; returns the signed distance */
+static float check_point(const struct Ship* s, float lx, float ly) {
+    float x0, y0, x1, y1;
+    bounds(s, &x0, &y0, &x1, &y1);
+    bool on_grid = lx >= x0 - HULL_SDF_MARGIN_PX + 1.0f && lx <= x1 + HULL_SDF_MARGIN_PX - 1.0f &&
+                   ly >= y0 - HULL_SDF_MARGIN_PX + 1.0f && ly <= y1 + HULL_SDF_MARGIN_PX - 1.0f;
+    float far = HULL_SDF_MARGIN_PX + HULL_SDF_CELL_PX;
+    bool off_grid = lx < x0 - far || lx > x1 + far || ly < y0 - far || ly > y1 + far;
+    int nearest = -1;
+    float d = ref_dist(s, lx, ly, &nearest);
+    bool in = ref_inside(s, lx, ly);
+    float sd = in ? -d : d;
+
+    assert(hull_sdf_contains(s, lx, ly) == in);
+    assert(hull_sdf_edge_dist(s, lx, ly) == d);
+    for (float r = 0.0f; r <= 40.0f; r += 2.0f)
+        assert(hull_sdf_within(s, lx, ly, r) == (in || d <= r));
+
+    float sample = hull_sdf_sample(s, lx, ly);
+    assert(sample <= sd + HULL_SDF_ERR_PX);
+    if (on_grid) assert(sample >= sd - HULL_SDF_ERR_PX);
+
+    int cn;
+    const uint8_t* cand = hull_sdf_candidates(s, lx, ly, &cn);
+    bool found = false;
+    for (int k = 0; k < cn; k++) {
+        if (k) assert(cand[k - 1] < cand[k]);
+        found |= cand[k] == nearest;
+    }
+    assert(found);
+    if (off_grid && s->hull_sdf) assert(cn == s->hull_vertex_count);
+    return sd;
+}
+
+/* Points exactly on every vertex, edge midpoint and edge quarter point */
+static void test_on_hull(const struct Ship* s, const char* name) {
+    float vx[64], vy[64];
+    verts(s, vx, vy);
+    int n = s->hull_vertex_count;
+    for (int i = 0; i < n; i++) {
+        int j = (i + 1) % n;
+        for (float t = 0.0f; t < 1.0f; t += 0.25f) {
+            float lx = vx[i] + t * (vx[j] - vx[i]), ly = vy[i] + t * (vy[j] - vy[i]);
+            check_point(s, lx, ly);
+            assert(hull_sdf_within(s, lx, ly, 0.01f));
+        }
+    }
+    printf("  %s: points on the hull match the full scan\n", name);
+}
+
+/* Grid edges and well past them: exact answers, every edge a candidate */
+static void test_off_grid(const struct Ship* s, const char* name) {
+    float x0, y0, x1, y1;
+    bounds(s, &x0, &y0, &x1, &y1);
+    float m = HULL_SDF_MARGIN_PX, cx = 0.5f * (x0 + x1), cy = 0.5f * (y0 + y1);
+    const float reach[] = { m - 1.0f, m, m + 0.5f, m + HULL_SDF_CELL_PX, 800.0f, 1e5f };
+    for (size_t k = 0; k < sizeof(reach) / sizeof(reach[0]); k++) {
+        float r = reach[k];
+        check_point(s, x1 + r, cy);
+        check_point(s, x0 - r, cy);
+        check_point(s, cx, y1 + r);
+        check_point(s, cx, y0 - r);
+        check_point(s, x1 + r, y1 + r);
+        check_point(s, x0 - r, y0 - r);
+        assert(!hull_sdf_contains(s, x1 + r, cy));
+    }
+    printf("  %s: points at and beyond the grid edge match the full scan\n", name);
+}
+
+static void test_notches(const struct Ship* s, const char* name) {
+    /* Mid-notch: outside, 40 px from both walls */
+    float sd = check_point(s, 0.0f, 30.0f);
+    assert(fabsf(sd - 40.0f) < 0.5f);
+    /* Under the notch floor: inside, 30 px from floor and keel */
+    sd = check_point(s, 0.0f, -50.0f);
+    assert(fabsf(sd + 30.0f) < 0.5f);
+    /* Off a reflex corner: inside, nearest point is the corner */
+    sd = check_point(s, 50.0f, -30.0f);
+    assert(fabsf(sd + sqrtf(200.0f)) < 0.5f);
+    /* Thin slot: water 3 px from either wall, land a hair past them */
+    sd = check_point(s, 120.0f, -40.0f);
+    assert(fabsf(sd - 3.0f) < 0.5f);
+    assert(!hull_sdf_within(s, 120.0f, -40.0f, 2.0f) && hull_sdf_within(s, 120.0f, -40.0f, 4.0f));
+    assert(check_point(s, 116.0f, -40.0f) < 0.0f && check_point(s, 124.0f, -40.0f) < 0.0f);
+    /* Just past the slot's head and the notch mouth */
+    check_point(s, 120.0f, 0.5f);
+    check_point(s, 120.0f, -0.5f);
+    check_point(s, 0.0f, 80.5f);
+    check_point(s, 39.5f, 79.5f);
+    /* Every 1 px across both notches */
+    for (float ly = -90.0f; ly <= 90.0f; ly += 1.0f) {
+        for (float lx = -50.0f; lx <= 50.0f; lx += 1.0f) check_point(s, lx, ly);
+        for (float lx = 110.0f; lx <= 130.0f; lx += 1.0f) check_point(s, lx, ly);
+    }
+    printf("  %s: notch and slot points match the full scan\n", name);
+}
+
+int main(void) {
+    printf("Testing hull SDF...\n");
+    static struct Ship a, b, c, bare, bare_c;
+    brigantine(&a);
+    brigantine(&b);
+    notched(&c);
+
+    /* Unbaked: plain scans */
+    bare = a;
+    bare_c = c;
+    test_on_hull(&bare, "brigantine (no shape)");
+    test_notches(&bare_c, "notched hull (no shape)");
+
+    hull_sdf_bake(&a);
+    hull_sdf_bake(&b);
+    hull_sdf_bake(&c);
+    assert(a.hull_sdf != 0 && a.hull_sdf == b.hull_sdf);
+    assert(c.hull_sdf != 0 && c.hull_sdf != a.hull_sdf);
+    test_on_hull(&a, "brigantine");
+    test_on_hull(&c, "notched hull");
+    test_notches(&c, "notched hull");
+    test_off_grid(&a, "brigantine");
+    test_off_grid(&c, "notched hull");
+
+    /* Degenerate hulls get no shape */
+    bare.hull_vertex_count = 2;
+    hull_sdf_bake(&bare);
+    assert(bare.hull_sdf == 0);
+    printf("All hull SDF tests passed!\n");
+    return 0;
+}
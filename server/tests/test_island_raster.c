@@ -0,0 +1,258 @@
+/* Island rasters: layer lookups give the exact polygon test's answer on a
+ * concave shore (in and around a notch, on its edges and vertices, and on
+ * cell corners), on a bump-circle island and outside the raster's bounds;
+ * shoreline distance is bit-identical to island_poly_edge_dist() inside
+ * its range, and so is the nearest-exit depth, whose push points at the
+ * nearest shore point even past a reflex corner; and land_at, the exit
+ * and the shallow-water helpers answer the same with rasters as without. */
+
+#define _POSIX_C_SOURCE 200809L
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "sim/island.h"
+
+#define NOTCH_X  10000.0f
+#define NOTCH_Y  10000.0f
+#define BUMP_X   10000.0f
+#define BUMP_Y   15000.0f
+
+static void rect(float *vx, float *vy, float x0, float y0, float x1, float y1) {
+    vx[0] = x0; vy[0] = y0;
+    vx[1] = x1; vy[1] = y0;
+    vx[2] = x1; vy[2] = y1;
+    vx[3] = x0; vy[3] = y1;
+}
+
+/* 1200 px square with a 200 px wide notch cut in from the east edge to the
+ * centre, so the beach has two reflex corners at (0, ±100) */
+static void set_notch_island(IslandDef *isl) {
+    static const float vx[] = { -600,  600,  600,    0,   0, 600, 600, -600 };
+    static const float vy[] = { -600, -600, -100, -100, 100, 100, 600,  600 };
+    memset(isl->beach_bumps, 0, sizeof(isl->beach_bumps));
+    isl->x = NOTCH_X;
+    isl->y = NOTCH_Y;
+    isl->vertex_count = 8;
+    memcpy(isl->vx, vx, sizeof(vx));
+    memcpy(isl->vy, vy, sizeof(vy));
+    isl->poly_bound_r = 600.0f * 1.4143f + 10.0f;
+    isl->grass_vertex_count = 4;
+    rect(isl->gvx, isl->gvy, -500.0f, -500.0f, -50.0f, 500.0f);
+    isl->shallow_vertex_count = 4;
+    rect(isl->svx, isl->svy, -900.0f, -900.0f, 900.0f, 900.0f);
+    isl->stone_poly_count = 1;
+    isl->stone_vc[0] = 4;
+    rect(isl->stone_vx[0], isl->stone_vy[0], -400.0f, 200.0f, -200.0f, 400.0f);
+    isl->metal_poly_count = 1;
+    isl->metal_vc[0] = 3;
+    isl->metal_vx[0][0] = -400.0f; isl->metal_vy[0][0] = -400.0f;
+    isl->metal_vx[0][1] = -100.0f; isl->metal_vy[0][1] = -400.0f;
+    isl->metal_vx[0][2] = -400.0f; isl->metal_vy[0][2] = -100.0f;
+}
+
+static void set_bump_island(IslandDef *isl, float x, float y) {
+    static const float bumps[ISLAND_BUMP_COUNT] = {
+        0, 140, -90, 160, 60, -120, 150, 30, -70, 100, -50, 120, 80, -110, 70, -90 };
+    isl->x = x;
+    isl->y = y;
+    isl->vertex_count = isl->grass_vertex_count = isl->shallow_vertex_count = 0;
+    isl->stone_poly_count = isl->metal_poly_count = 0;
+    isl->beach_radius_px = 900.0f;
+    memcpy(isl->beach_bumps, bumps, sizeof(bumps));
+    isl->beach_max_bump = 160.0f;
+}
+
+static bool layer_matches(const IslandDef *isl, float px, float py) {
+    for (int layer = 0; layer < ISLAND_LAYER_COUNT; layer++)
+        if (island_layer_contains(isl, (IslandLayer)layer, px, py) !=
+            island_layer_contains_exact(isl, (IslandLayer)layer, px, py)) return false;
+    return true;
+}
+
+static bool land(const IslandDef *isl, float dx, float dy) {
+    return island_layer_contains(isl, ISLAND_LAYER_LAND, isl->x + dx, isl->y + dy);
+}
+
+static void test_concave_shore(const IslandDef *isl) {
+    /* Arms either side of the notch are land, the notch is water up to its
+     * back wall */
+    assert(land(isl, 300.0f, -300.0f) && land(isl, 300.0f, 300.0f));
+    assert(!land(isl, 300.0f, 0.0f) && !land(isl, 599.0f, 0.0f) && !land(isl, 1.0f, 0.0f));
+    assert(land(isl, -1.0f, 0.0f));
+
+    /* A hair either side of each notch edge */
+    assert(land(isl, 300.0f, -100.01f) && !land(isl, 300.0f, -99.99f));
+    assert(land(isl, 300.0f, 100.01f) && !land(isl, 300.0f, 99.99f));
+    assert(land(isl, -0.01f, 50.0f) && !land(isl, 0.01f, 50.0f));
+
+    /* Exactly on vertices and edges, including both reflex corners */
+    static const float on[][2] = {
+        { 0, -100 }, { 0, 100 }, { 600, -100 }, { 600, 100 }, { 300, -100 },
+        { 300, 100 }, { 0, 0 }, { 600, 0 }, { -600, 0 }, { 600, 600 },
+    };
+    for (size_t k = 0; k < sizeof(on) / sizeof(on[0]); k++)
+        assert(layer_matches(isl, isl->x + on[k][0], isl->y + on[k][1]));
+
+    /* Whole-pixel points across the notch hit every cell and tile corner */
+    for (float dy = -160.0f; dy <= 160.0f; dy += 1.0f)
+        for (float dx = -32.0f; dx <= 640.0f; dx += 8.0f)
+            assert(layer_matches(isl, isl->x + dx, isl->y + dy));
+
+    /* Biome layers inside the island */
+    assert(island_layer_contains(isl, ISLAND_LAYER_STONE, isl->x - 300.0f, isl->y + 300.0f));
+    assert(island_layer_contains(isl, ISLAND_LAYER_METAL, isl->x - 350.0f, isl->y - 350.0f));
+    assert(!island_layer_contains(isl, ISLAND_LAYER_GRASS, isl->x + 300.0f, isl->y - 300.0f));
+    printf("  concave shore: notch, edges, reflex corners and cell corners match\n");
+}
+
+static void test_bump_shore(const IslandDef *isl) {
+    for (int b = 0; b < ISLAND_BUMP_COUNT; b++) {
+        float a = (float)b * 6.2831853f / ISLAND_BUMP_COUNT;
+        float r = island_boundary_r(isl->beach_radius_px, isl->beach_bumps, a);
+        for (float d = -1.0f; d <= 1.0f; d += 0.5f)
+            assert(layer_matches(isl, isl->x + (r + d) * cosf(a), isl->y + (r + d) * sinf(a)));
+        assert(land(isl, (r - 2.0f) * cosf(a), (r - 2.0f) * sinf(a)));
+        assert(!land(isl, (r + 2.0f) * cosf(a), (r + 2.0f) * sinf(a)));
+    }
+    printf("  bump circle: each bump's shore matches\n");
+}
+
+static void test_out_of_bounds(const IslandDef *isl) {
+    static const float far[][2] = { { 5000, 0 }, { -5000, 0 }, { 0, 5000 }, { 0, -5000 }, { 1e6f, -1e6f } };
+    for (size_t k = 0; k < sizeof(far) / sizeof(far[0]); k++) {
+        float px = isl->x + far[k][0], py = isl->y + far[k][1];
+        for (int layer = 0; layer < ISLAND_LAYER_COUNT; layer++)
+            assert(!island_layer_contains(isl, (IslandLayer)layer, px, py));
+        assert(layer_matches(isl, px, py));
+    }
+    printf("  points outside the raster are outside every layer\n");
+}
+
+static void test_shore(const IslandDef *isl) {
+    /* Mid-notch: both notch edges 100 px away, the back wall 300 px */
+    float d = island_shore_dist(isl, isl->x + 300.0f, isl->y, 600.0f);
+    assert(d == island_poly_edge_dist(isl, isl->x + 300.0f, isl->y) && fabsf(d - 100.0f) < 1e-3f);
+    /* Off a reflex corner: nearest is the corner itself */
+    d = island_shore_dist(isl, isl->x + 30.0f, isl->y - 60.0f, 600.0f);
+    assert(d == island_poly_edge_dist(isl, isl->x + 30.0f, isl->y - 60.0f) && fabsf(d - 30.0f) < 1e-3f);
+    /* Inland and at sea, inside and past max_dist */
+    static const float pts[][3] = {
+        { -300, 0, 600 }, { -300, 0, 100 }, { -1000, 0, 600 }, { -1000, 0, 100 },
+        { 300, -300, 250 }, { 300, -300, 50 }, { 2000, 2000, 100 },
+    };
+    for (size_t k = 0; k < sizeof(pts) / sizeof(pts[0]); k++) {
+        float px = isl->x + pts[k][0], py = isl->y + pts[k][1], m = pts[k][2];
+        float exact = island_poly_edge_dist(isl, px, py);
+        d = island_shore_dist(isl, px, py, m);
+        if (exact <= m) assert(d == exact);
+        else            assert(d > m);
+    }
+    printf("  shore distance bit-identical to the edge scan in range\n");
+}
+
+/* Land points near the notch: offset, depth and exit direction */
+typedef struct { float dx, dy, depth, nx, ny; } ExitCase;
+static const ExitCase EXITS[] = {
+    {  300.0f, -150.0f, 50.0f,  0.0f, 1.0f },      /* Under the notch       */
+    {  300.0f,  150.0f, 50.0f,  0.0f, -1.0f },     /* Over it               */
+    {  -50.0f,    0.0f, 50.0f,  1.0f, 0.0f },      /* Behind its back wall  */
+    {  -30.0f, -130.0f, 42.426407f, 0.70710678f, 0.70710678f },  /* Past a reflex corner */
+    {  590.0f, -300.0f, 10.0f,  1.0f, 0.0f },      /* At the east shore     */
+    { -300.0f, -590.0f, 10.0f,  0.0f, -1.0f },     /* At the south shore    */
+};
+#define N_EXITS (sizeof(EXITS) / sizeof(EXITS[0]))
+
+typedef struct { float nx, ny, depth; } ExitAnswer;
+
+static void exit_answers(const IslandDef *isl, ExitAnswer *out) {
+    for (size_t k = 0; k < N_EXITS; k++)
+        assert(island_poly_nearest_exit(isl, isl->x + EXITS[k].dx, isl->y + EXITS[k].dy,
+                                        &out[k].nx, &out[k].ny, &out[k].depth));
+}
+
+static void test_exit(const IslandDef *isl, const IslandDef *bump, const ExitAnswer *before) {
+    ExitAnswer got[N_EXITS];
+    exit_answers(isl, got);
+    for (size_t k = 0; k < N_EXITS; k++) {
+        const ExitCase *c = &EXITS[k];
+        float px = isl->x + c->dx, py = isl->y + c->dy;
+        assert(got[k].depth == island_poly_edge_dist(isl, px, py));
+        assert(fabsf(got[k].depth - c->depth) < 1e-3f);
+        assert(fabsf(got[k].nx - c->nx) < 1e-4f && fabsf(got[k].ny - c->ny) < 1e-4f);
+        /* The push lands on the shoreline */
+        assert(island_poly_edge_dist(isl, px + got[k].nx * got[k].depth,
+                                     py + got[k].ny * got[k].depth) < 0.05f);
+        /* The full edge scan without a raster picked the same edge */
+        assert(got[k].nx == before[k].nx && got[k].ny == before[k].ny &&
+               got[k].depth == before[k].depth);
+    }
+    float nx, ny, depth;
+    assert(!island_poly_nearest_exit(bump, bump->x, bump->y, &nx, &ny, &depth));
+    printf("  nearest exit: depth, direction and edge match the raster-less scan\n");
+}
+
+/* Points whose world answers are compared with and without rasters */
+static const float WORLD_PTS[][2] = {
+    { NOTCH_X + 300, NOTCH_Y - 300 }, { NOTCH_X + 300, NOTCH_Y },      { NOTCH_X - 1, NOTCH_Y },
+    { NOTCH_X + 800, NOTCH_Y },       { NOTCH_X + 300, NOTCH_Y + 99 }, { NOTCH_X - 1000, NOTCH_Y },
+    { BUMP_X, BUMP_Y },               { BUMP_X + 1200, BUMP_Y },       { 40000, 40000 },
+};
+#define N_WORLD (sizeof(WORLD_PTS) / sizeof(WORLD_PTS[0]))
+
+typedef struct {
+    const IslandDef *land;
+    bool  shallow;
+    float depth;
+} WorldAnswer;
+
+static void world_answers(const IslandDef *notch, WorldAnswer *out) {
+    for (size_t k = 0; k < N_WORLD; k++) {
+        out[k].land    = island_land_at(WORLD_PTS[k][0], WORLD_PTS[k][1]);
+        out[k].shallow = island_in_shallow_water(notch, WORLD_PTS[k][0], WORLD_PTS[k][1]);
+        out[k].depth   = island_shallow_water_depth(notch, WORLD_PTS[k][0], WORLD_PTS[k][1]);
+    }
+}
+
+static void test_world(const IslandDef *notch, const IslandDef *bump, const WorldAnswer *before) {
+    WorldAnswer after[N_WORLD];
+    world_answers(notch, after);
+    for (size_t k = 0; k < N_WORLD; k++) {
+        assert(after[k].land == before[k].land);
+        assert(after[k].shallow == before[k].shallow && after[k].depth == before[k].depth);
+    }
+    assert(after[0].land == notch && after[2].land == notch && after[6].land == bump);
+    assert(!after[1].land && !after[3].land && !after[7].land && !after[8].land);
+    /* The notch and the water off the east edge are shallows; land is not */
+    assert(after[1].shallow && after[3].shallow && !after[0].shallow && !after[8].shallow);
+    assert(after[4].depth > after[1].depth && after[0].depth == 0.0f);
+    printf("  land_at and shallow water answer the same with and without rasters\n");
+}
+
+int main(void) {
+    printf("Testing island rasters...\n");
+    /* Move every preset far away; the two under test sit apart */
+    for (int ii = 0; ii < ISLAND_COUNT; ii++) {
+        set_bump_island(&ISLAND_PRESETS[ii], 200000.0f + 10000.0f * (float)ii, -200000.0f);
+        ISLAND_PRESETS[ii].beach_radius_px = 300.0f;
+    }
+    IslandDef *notch = &ISLAND_PRESETS[0], *bump = &ISLAND_PRESETS[1];
+    set_notch_island(notch);
+    set_bump_island(bump, BUMP_X, BUMP_Y);
+
+    /* Without rasters every query is the exact test */
+    WorldAnswer before[N_WORLD];
+    ExitAnswer exits_before[N_EXITS];
+    world_answers(notch, before);
+    exit_answers(notch, exits_before);
+    islands_build_rasters();
+    test_concave_shore(notch);
+    test_bump_shore(bump);
+    test_out_of_bounds(notch);
+    test_shore(notch);
+    test_exit(notch, bump, exits_before);
+    test_world(notch, bump, before);
+    printf("All island raster tests passed!\n");
+    return 0;
+}
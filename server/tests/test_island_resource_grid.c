@@ -0,0 +1,169 @@
+/* Island resource grid: near-queries return every standing node of the
+ * asked-for types within the square, in index order, and nothing depleted;
+ * dead/alive marks are idempotent and keep the per-type counts; islands too
+ * big for 32×32 minimum-size cells get wider cells instead of dropping
+ * nodes. */
+
+#define _POSIX_C_SOURCE 200809L
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sim/island.h"
+
+#define N_NODES   3000
+#define N_QUERIES 4000
+
+static float frand(float lo, float hi) {
+    return lo + (hi - lo) * ((float)rand() / (float)RAND_MAX);
+}
+
+static void scatter(IslandDef *isl, int n, float half_extent) {
+    isl->resource_count = n;
+    for (int ri = 0; ri < n; ri++) {
+        IslandResource *r = &isl->resources[ri];
+        memset(r, 0, sizeof(*r));
+        r->ox = frand(-half_extent, half_extent);
+        r->oy = frand(-half_extent, half_extent);
+        r->type_id = (uint8_t)(rand() % ISLAND_RES_TYPES);
+        r->size = frand(0.5f, 1.8f);
+        r->max_health = 100;
+        r->health = (rand() % 5) ? 100 : 0;
+    }
+}
+
+static void reset_islands(void) {
+    for (int ii = 0; ii < ISLAND_COUNT; ii++) ISLAND_PRESETS[ii].resource_count = 0;
+}
+
+static int standing(const IslandDef *isl, int t) {
+    int n = 0;
+    for (int ri = 0; ri < isl->resource_count; ri++)
+        n += isl->resources[ri].type_id == t && isl->resources[ri].health > 0;
+    return n;
+}
+
+/* Every standing node in the square is listed; everything listed is
+ * standing, of a masked type, and in strictly ascending index order. */
+static void check_near(IslandResourceNear *near, const IslandDef *isl,
+                       float wx, float wy, float r, uint32_t mask) {
+    island_resources_near(near, isl, wx, wy, r, mask);
+    for (uint32_t k = 0; k < near->count; k++) {
+        const IslandResource *res = &isl->resources[near->ri[k]];
+        assert(res->health > 0 && res->in_grid);
+        assert(!mask || (mask & RES_MASK(res->type_id)));
+        if (k) assert(near->ri[k - 1] < near->ri[k]);
+    }
+    uint32_t k = 0;
+    for (int ri = 0; ri < isl->resource_count; ri++) {
+        const IslandResource *res = &isl->resources[ri];
+        if (res->health <= 0 || (mask && !(mask & RES_MASK(res->type_id)))) continue;
+        float dx = isl->x + res->ox - wx, dy = isl->y + res->oy - wy;
+        if (dx < -r || dx > r || dy < -r || dy > r) continue;
+        while (k < near->count && near->ri[k] < ri) k++;
+        assert(k < near->count && near->ri[k] == ri);
+    }
+}
+
+static void test_queries(void) {
+    reset_islands();
+    IslandDef *isl = &ISLAND_PRESETS[0];
+    srand(0x15a1);
+    scatter(isl, N_NODES, 3000.0f);
+    islands_build_grid();
+    assert(isl->grid_cell == ISLAND_GRID_CELL_PX);
+    for (int t = 0; t < ISLAND_RES_TYPES; t++) assert(isl->alive_count[t] == standing(isl, t));
+
+    IslandResourceNear near = {0};
+    for (int q = 0; q < N_QUERIES; q++) {
+        float wx = isl->x + frand(-3600.0f, 3600.0f);
+        float wy = isl->y + frand(-3600.0f, 3600.0f);
+        float r  = (q % 8) ? frand(0.0f, 200.0f) : frand(0.0f, 2500.0f);
+        uint32_t mask = (q % 3) ? RES_MASK(rand() % ISLAND_RES_TYPES) : 0u;
+        if (q % 5 == 0) mask |= RES_MASK(RES_BOULDER) | RES_MASK(RES_STONE_BOULDER);
+        check_near(&near, isl, wx, wy, r, mask);
+    }
+    /* Far outside the grid on every side */
+    assert(island_resources_near(&near, isl, isl->x - 50000.0f, isl->y, 100.0f, 0) == 0);
+    assert(island_resources_near(&near, isl, isl->x, isl->y + 50000.0f, 100.0f, 0) == 0);
+    free(near.ri);
+    printf("  %d random queries over %d nodes match a full scan\n", N_QUERIES, N_NODES);
+}
+
+static void test_marks(void) {
+    IslandDef *isl = &ISLAND_PRESETS[0];
+    IslandResourceNear near = {0};
+    int ri = 0;
+    while (isl->resources[ri].health <= 0) ri++;
+    IslandResource *res = &isl->resources[ri];
+    int t = res->type_id, before = isl->alive_count[t];
+    float wx = isl->x + res->ox, wy = isl->y + res->oy;
+
+    /* Depleted: out of the grid, once */
+    res->health = 0;
+    island_mark_resource_dead(isl, ri);
+    island_mark_resource_dead(isl, ri);
+    assert(!res->in_grid && isl->alive_count[t] == before - 1);
+    check_near(&near, isl, wx, wy, 10.0f, RES_MASK(t));
+
+    /* Respawned: back in, once */
+    res->health = res->max_health;
+    island_mark_resource_alive(isl, ri);
+    island_mark_resource_alive(isl, ri);
+    assert(res->in_grid && isl->alive_count[t] == before);
+    check_near(&near, isl, wx, wy, 10.0f, RES_MASK(t));
+    check_near(&near, isl, wx, wy, 400.0f, 0);
+
+    /* Churn every node through dead and back in a shuffled order */
+    for (int k = 0; k < 2 * N_NODES; k++) {
+        int j = rand() % isl->resource_count;
+        IslandResource *rj = &isl->resources[j];
+        if (rj->health > 0) { rj->health = 0;   island_mark_resource_dead(isl, j); }
+        else                { rj->health = 100; island_mark_resource_alive(isl, j); }
+    }
+    for (int t2 = 0; t2 < ISLAND_RES_TYPES; t2++) assert(isl->alive_count[t2] == standing(isl, t2));
+    for (int q = 0; q < 500; q++)
+        check_near(&near, isl, isl->x + frand(-3000.0f, 3000.0f), isl->y + frand(-3000.0f, 3000.0f),
+                   frand(0.0f, 600.0f), 0);
+
+    /* Out-of-range indices are ignored */
+    island_mark_resource_dead(isl, -1);
+    island_mark_resource_alive(isl, isl->resource_count);
+    free(near.ri);
+    printf("  dead/alive marks are idempotent and keep queries exact\n");
+}
+
+static void test_wide_island(void) {
+    reset_islands();
+    IslandDef *isl = &ISLAND_PRESETS[1];
+    srand(0xb16);
+    scatter(isl, N_NODES, 20000.0f);   /* 40 000 px across: > 32 × 320 */
+    islands_build_grid();
+    assert(isl->grid_cell > ISLAND_GRID_CELL_PX);
+    assert(isl->grid_w <= ISLAND_GRID_COLS && isl->grid_h <= ISLAND_GRID_ROWS);
+    int in = 0;
+    for (int ri = 0; ri < isl->resource_count; ri++) in += isl->resources[ri].in_grid;
+    assert(in == standing(isl, 0) + standing(isl, 1) + standing(isl, 2) +
+                 standing(isl, 3) + standing(isl, 4) + standing(isl, 5));
+
+    IslandResourceNear near = {0};
+    for (int q = 0; q < 1000; q++)
+        check_near(&near, isl, isl->x + frand(-21000.0f, 21000.0f), isl->y + frand(-21000.0f, 21000.0f),
+                   frand(0.0f, 1500.0f), (q & 1) ? RES_MASK(RES_WOOD) : 0u);
+
+    /* No resources at all: no grid, no results */
+    assert(ISLAND_PRESETS[2].grid_cell == 0.0f);
+    assert(island_resources_near(&near, &ISLAND_PRESETS[2], ISLAND_PRESETS[2].x, ISLAND_PRESETS[2].y, 1000.0f, 0) == 0);
+    free(near.ri);
+    printf("  a 40 000 px island widens its cells and keeps every node\n");
+}
+
+int main(void) {
+    printf("Testing island resource grid...\n");
+    test_queries();
+    test_marks();
+    test_wide_island();
+    printf("All island resource grid tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,91 @@
+/* Metrics registry: per-thread counter shards must sum exactly on scrape,
+ * histograms export cumulative buckets in scaled units, and label sets of
+ * one family are grouped under a single TYPE line ending in "# EOF". */
+
+#define _POSIX_C_SOURCE 200809L
+#include <assert.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "util/metrics.h"
+
+#define THREADS      8
+#define INCS_PER_THR 100000
+
+static metric_id g_hits;
+
+static void* hammer(void* arg) {
+    (void)arg;
+    for (int i = 0; i < INCS_PER_THR; i++) metrics_inc(g_hits, 1);
+    return NULL;
+}
+
+static char*  g_scrape_buf;
+static size_t g_scrape_len;
+
+static char* scrape(void) {
+    FILE* ms = open_memstream(&g_scrape_buf, &g_scrape_len);
+    assert(ms);
+    assert(metrics_write_openmetrics(ms) == 0);
+    fclose(ms);
+    return g_scrape_buf;
+}
+
+static void extra_family(FILE* out) {
+    fprintf(out, "# TYPE test_extra gauge\ntest_extra 7\n");
+}
+
+int main(void) {
+    printf("Testing metrics registry...\n");
+
+    g_hits = metrics_counter("test_hits", "Hits.", "src=\"a\"");
+    metric_id other = metrics_gauge("test_depth", "Depth.", NULL);
+    metric_id hits_b = metrics_counter("test_hits", "Hits.", "src=\"b\"");
+    static const uint64_t bounds[] = { 1000, 10000 };
+    metric_id lat = metrics_histogram("test_latency_seconds", "Latency.", NULL, bounds, 2, 1e-6);
+    assert(g_hits && other && hits_b && lat);
+    metrics_register_collector(extra_family);
+
+    pthread_t th[THREADS];
+    for (int i = 0; i < THREADS; i++) pthread_create(&th[i], NULL, hammer, NULL);
+    for (int i = 0; i < THREADS; i++) pthread_join(th[i], NULL);
+    metrics_inc(hits_b, 3);
+    metrics_gauge_set(other, -5);
+    metrics_observe(lat, 500);
+    metrics_observe(lat, 1000);
+    metrics_observe(lat, 5000);
+    metrics_observe(lat, 20000);
+
+    char* text = scrape();
+    printf("%s", text);
+
+    char expect[128];
+    snprintf(expect, sizeof(expect), "test_hits_total{src=\"a\"} %d\n", THREADS * INCS_PER_THR);
+    assert(strstr(text, expect));
+    assert(strstr(text, "test_hits_total{src=\"b\"} 3\n"));
+    /* One TYPE line per family, label sets grouped under it */
+    const char* type_line = strstr(text, "# TYPE test_hits counter\n");
+    assert(type_line && !strstr(type_line + 1, "# TYPE test_hits counter"));
+    assert(strstr(type_line, "src=\"b\"") < strstr(text, "# TYPE test_depth gauge"));
+    assert(strstr(text, "test_depth -5\n"));
+
+    assert(strstr(text, "test_latency_seconds_bucket{le=\"0.001\"} 2\n"));
+    assert(strstr(text, "test_latency_seconds_bucket{le=\"0.01\"} 3\n"));
+    assert(strstr(text, "test_latency_seconds_bucket{le=\"+Inf\"} 4\n"));
+    assert(strstr(text, "test_latency_seconds_count 4\n"));
+    assert(strstr(text, "test_latency_seconds_sum 0.0265\n"));
+
+    assert(strstr(text, "test_extra 7\n") < strstr(text, "# EOF\n"));
+    size_t len = strlen(text);
+    assert(len >= 6 && strcmp(text + len - 6, "# EOF\n") == 0);
+    free(text);
+
+    /* Failed registration yields id 0 and recording is a no-op */
+    metrics_inc(0, 1);
+    metrics_observe(0, 1);
+
+    printf("All metrics tests passed!\n");
+    return 0;
+}
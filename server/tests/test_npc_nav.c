@@ -0,0 +1,273 @@
+/* NPC navigation: straight walks on convex decks, corner paths around
+ * concave shapes that never leave walkable cells, unreachable goals, starts
+ * in blocked cells, paths round an island bay, the path cache and the
+ * per-tick search budget.  ISLAND_PRESETS is defined here with synthetic
+ * islands. */
+
+#define _POSIX_C_SOURCE 200809L
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "net/npc_nav.h"
+#include "sim/island.h"
+
+IslandDef ISLAND_PRESETS[ISLAND_COUNT];
+
+/* Brigantine-like deck hexagon (client px) */
+static const float HEX[6][2] = {
+    { 260.0f,   0.0f }, { 150.0f,  95.0f }, { -260.0f,  95.0f },
+    { -300.0f,  0.0f }, { -260.0f, -95.0f }, { 150.0f, -95.0f },
+};
+
+/* A U: two 60px-wide arms joined at the bottom; walking between the arm
+ * tips has to go round the gap. */
+static const float U[8][2] = {
+    { -150.0f, -200.0f }, { -90.0f, -200.0f }, { -90.0f, 100.0f }, {  90.0f, 100.0f },
+    {   90.0f, -200.0f }, { 150.0f, -200.0f }, { 150.0f, 160.0f }, { -150.0f, 160.0f },
+};
+
+/* Two 100px rooms joined by a 20px corridor: with 10px clearance on each
+ * side no cell of the corridor is walkable. */
+static const float DUMBBELL[12][2] = {
+    { -150.0f, -50.0f }, { -50.0f, -50.0f }, { -50.0f, -10.0f }, {  50.0f, -10.0f },
+    {   50.0f, -50.0f }, { 150.0f, -50.0f }, { 150.0f,  50.0f }, {  50.0f,  50.0f },
+    {   50.0f,  10.0f }, { -50.0f,  10.0f }, { -50.0f,  50.0f }, { -150.0f, 50.0f },
+};
+
+/* Every sampled point of the leg is on a walkable cell, except within a
+ * cell of either end (ends may sit in the clearance band). */
+static void check_leg(int grid, float ax, float ay, float bx, float by, float slack) {
+    float len = hypotf(bx - ax, by - ay);
+    for (float d = slack; d < len - slack; d += 1.0f) {
+        float t = d / len;
+        assert(npc_nav_walkable(grid, ax + (bx - ax) * t, ay + (by - ay) * t));
+    }
+}
+
+static void check_path(int grid, float sx, float sy, float gx, float gy, const NpcNavPath *p) {
+    float ax = sx, ay = sy;
+    for (int c = 0; c < p->count; c++) {
+        assert(npc_nav_walkable(grid, p->corner[c][0], p->corner[c][1]));
+        check_leg(grid, ax, ay, p->corner[c][0], p->corner[c][1], c == 0 ? 15.0f : 0.0f);
+        ax = p->corner[c][0];
+        ay = p->corner[c][1];
+    }
+    if (!p->partial) check_leg(grid, ax, ay, gx, gy, 15.0f);
+}
+
+static void test_convex_deck(void) {
+    /* Bow to stern, beam to beam, and corner to corner across the deck */
+    static const float WALKS[][4] = {
+        { 200.0f,   0.0f, -260.0f,   0.0f },
+        { -50.0f, -75.0f,  -50.0f,  75.0f },
+        { 120.0f,  70.0f, -230.0f, -70.0f },
+        {-230.0f,  70.0f,  120.0f, -70.0f },
+    };
+    int g = npc_nav_deck_grid(3, 1, HEX, 6);
+    assert(g >= 0 && npc_nav_deck_grid(3, 1, HEX, 6) == g);   /* baked once */
+    NpcNavStats before, after;
+    npc_nav_stats(&before);
+    for (size_t q = 0; q < sizeof(WALKS) / sizeof(WALKS[0]); q++) {
+        NpcNavPath p;
+        assert(npc_nav_path(g, WALKS[q][0], WALKS[q][1], WALKS[q][2], WALKS[q][3], &p) == NPC_NAV_OK);
+        assert(p.count == 0 && !p.partial);
+    }
+    npc_nav_stats(&after);
+    assert(after.direct - before.direct == sizeof(WALKS) / sizeof(WALKS[0]));
+    assert(after.searches == before.searches);
+    printf("  convex deck: walks are straight, no searches\n");
+}
+
+static void test_concave_deck(void) {
+    int g = npc_nav_deck_grid(99, 0, U, 8);
+    assert(g >= 0);
+    NpcNavPath p;
+    npc_nav_begin_tick();
+    assert(npc_nav_path(g, -120.0f, -180.0f, 120.0f, -180.0f, &p) == NPC_NAV_OK);
+    assert(p.count >= 2 && !p.partial);
+    check_path(g, -120.0f, -180.0f, 120.0f, -180.0f, &p);
+    /* Both corners sit at the bottom, below the gap */
+    for (int c = 0; c < p.count; c++) assert(p.corner[c][1] > 100.0f);
+
+    /* Foot of one arm to the tip of the other needs one corner at most */
+    npc_nav_begin_tick();
+    assert(npc_nav_path(g, -120.0f, 130.0f, 120.0f, -180.0f, &p) == NPC_NAV_OK);
+    assert(p.count >= 1 && !p.partial);
+    check_path(g, -120.0f, 130.0f, 120.0f, -180.0f, &p);
+
+    /* Off the deck entirely */
+    assert(npc_nav_path(g, -120.0f, -180.0f, 0.0f, -150.0f, &p) == NPC_NAV_NO_PATH);
+    printf("  concave deck: corner paths stay on walkable cells\n");
+}
+
+static void test_unreachable_goal(void) {
+    int g = npc_nav_deck_grid(98, 0, DUMBBELL, 12);
+    assert(g >= 0);
+    assert(npc_nav_walkable(g, -100.0f, 0.0f) && npc_nav_walkable(g, 100.0f, 0.0f));
+    assert(!npc_nav_walkable(g, 0.0f, 0.0f));
+
+    NpcNavStats a, b;
+    NpcNavPath p;
+    npc_nav_begin_tick();
+    npc_nav_stats(&a);
+    assert(npc_nav_path(g, -100.0f, 0.0f, 100.0f, 0.0f, &p) == NPC_NAV_NO_PATH);
+    assert(p.count == 0);
+    npc_nav_stats(&b);
+    assert(b.searches == a.searches + 1 && b.no_path == a.no_path + 1);
+
+    /* The failed search is cached like a found one */
+    assert(npc_nav_path(g, -100.0f, 0.0f, 100.0f, 0.0f, &p) == NPC_NAV_NO_PATH);
+    npc_nav_stats(&a);
+    assert(a.searches == b.searches && a.cache_hits == b.cache_hits + 1);
+
+    /* Within one room the walk is straight */
+    assert(npc_nav_path(g, -130.0f, -30.0f, -70.0f, 30.0f, &p) == NPC_NAV_OK && p.count == 0);
+    printf("  goal across an impassable neck: NO_PATH, and cached\n");
+}
+
+static void test_blocked_start(void) {
+    int g = npc_nav_deck_grid(99, 0, U, 8);
+    NpcNavPath p;
+
+    /* 5px from the left arm's inner edge: inside the deck but in the
+     * clearance band, so the start snaps to the nearest walkable cell */
+    assert(!npc_nav_walkable(g, -95.0f, -100.0f));
+    npc_nav_begin_tick();
+    assert(npc_nav_path(g, -95.0f, -100.0f, 120.0f, -180.0f, &p) == NPC_NAV_OK);
+    assert(p.count >= 2 && !p.partial);
+    /* The first leg starts in the band; every leg after it is clear */
+    for (int c = 0; c < p.count; c++) assert(npc_nav_walkable(g, p.corner[c][0], p.corner[c][1]));
+    for (int c = 1; c < p.count; c++)
+        check_leg(g, p.corner[c - 1][0], p.corner[c - 1][1], p.corner[c][0], p.corner[c][1], 0.0f);
+    check_leg(g, p.corner[p.count - 1][0], p.corner[p.count - 1][1], 120.0f, -180.0f, 15.0f);
+
+    /* Mid-gap is farther from any walkable cell than the snap reaches */
+    assert(npc_nav_path(g, 0.0f, -100.0f, 120.0f, -180.0f, &p) == NPC_NAV_NO_PATH);
+    /* And so is anything off the grid */
+    assert(npc_nav_path(g, -5000.0f, 0.0f, 120.0f, -180.0f, &p) == NPC_NAV_NO_PATH);
+    printf("  start in the clearance band snaps; deep in blocked cells fails\n");
+}
+
+static void test_cache(void) {
+    int g = npc_nav_deck_grid(99, 0, U, 8);
+    npc_nav_cache_clear();
+    npc_nav_begin_tick();
+    NpcNavPath first, again;
+    NpcNavStats a, b;
+    assert(npc_nav_path(g, -120.0f, -150.0f, 120.0f, -150.0f, &first) == NPC_NAV_OK);
+    npc_nav_stats(&a);
+    /* A few px away: same start and goal cells, same answer, no search */
+    assert(npc_nav_path(g, -118.0f, -148.0f, 122.0f, -146.0f, &again) == NPC_NAV_OK);
+    npc_nav_stats(&b);
+    assert(b.cache_hits == a.cache_hits + 1 && b.searches == a.searches);
+    assert(again.count == first.count);
+    assert(memcmp(again.corner, first.corner, sizeof(float) * 2 * (size_t)first.count) == 0);
+    printf("  repeated route served from the cache\n");
+}
+
+static void test_islands(void) {
+    IslandDef *round = &ISLAND_PRESETS[0];
+    round->id = 1;
+    round->x = 9000.0f;
+    round->y = 62000.0f;
+    round->beach_radius_px = 185.0f;
+    static const float bumps[] = { 0, 14, -9, 20, 6, -13, 16, 3, -7, 18, -5, 10, 12, -11, 7, -9 };
+    memcpy(round->beach_bumps, bumps, sizeof(bumps));
+    round->beach_max_bump = 20.0f;
+
+    /* A C-shaped polygon island opening to +x */
+    IslandDef *cee = &ISLAND_PRESETS[1];
+    static const float cx[] = { 600, -600, -600, 600, 600, -300, -300, 600 };
+    static const float cy[] = { -600, -600, 600, 600, 300, 300, -300, -300 };
+    cee->id = 2;
+    cee->x = 20000.0f;
+    cee->y = 20000.0f;
+    cee->vertex_count = 8;
+    memcpy(cee->vx, cx, sizeof(cx));
+    memcpy(cee->vy, cy, sizeof(cy));
+    cee->poly_bound_r = 900.0f;
+
+    for (int k = 0; k < 2; k++) {
+        int g = npc_nav_island_grid(k);
+        assert(g >= 0 && npc_nav_island_grid(k) == g);
+    }
+    assert(npc_nav_island_grid(-1) < 0 && npc_nav_island_grid(ISLAND_COUNT) < 0);
+
+    /* Round island: two cells inside the bumpy shore is land, two cells
+     * outside is water, in every bump direction */
+    int gr = npc_nav_island_grid(0);
+    for (int b = 0; b < ISLAND_BUMP_COUNT; b++) {
+        float a = (float)b * 6.2831853f / ISLAND_BUMP_COUNT;
+        float shore = island_boundary_r(round->beach_radius_px, round->beach_bumps, a);
+        float in = shore - 2.0f * NPC_NAV_ISLAND_CELL, out = shore + 2.0f * NPC_NAV_ISLAND_CELL;
+        assert(npc_nav_walkable(gr, round->x + cosf(a) * in,  round->y + sinf(a) * in));
+        assert(!npc_nav_walkable(gr, round->x + cosf(a) * out, round->y + sinf(a) * out));
+    }
+
+    /* C island: arms and back are land, the bay and beyond the mouth water */
+    int gc = npc_nav_island_grid(1);
+    assert(npc_nav_walkable(gc, 20300.0f, 19550.0f) && npc_nav_walkable(gc, 20300.0f, 20450.0f));
+    assert(npc_nav_walkable(gc, 19550.0f, 20000.0f));
+    assert(!npc_nav_walkable(gc, 20300.0f, 20000.0f) && !npc_nav_walkable(gc, 20750.0f, 20000.0f));
+    printf("  islands: grids follow the shore and the bay\n");
+}
+
+/* Top arm to bottom arm of the C goes round the back of the bay, turning at
+ * its two inner corners rather than swinging wide through the back */
+static void test_path_round_bay(void) {
+    int g = npc_nav_island_grid(1);
+    NpcNavPath p;
+    npc_nav_begin_tick();
+    float sx = 20450.0f, sy = 19550.0f, gx = 20450.0f, gy = 20450.0f;
+    assert(npc_nav_path(g, sx, sy, gx, gy, &p) == NPC_NAV_OK && p.count >= 2 && !p.partial);
+    check_path(g, sx, sy, gx, gy, &p);
+    const float reach = 3.0f * NPC_NAV_ISLAND_CELL;
+    for (int c = 0; c < p.count; c++) {
+        float x = p.corner[c][0], y = p.corner[c][1];
+        assert(x < 20000.0f - 300.0f + 1.0f);
+        float d_top = hypotf(x - 19700.0f, y - 19700.0f);
+        float d_bot = hypotf(x - 19700.0f, y - 20300.0f);
+        assert(d_top < reach || d_bot < reach);
+    }
+    printf("  island path hugs the bay's inner corners\n");
+}
+
+/* Uses the C island from test_islands: a few thousand cells, so a handful
+ * of arm-to-arm searches spend the tick */
+static void test_budget(void) {
+    int g = npc_nav_island_grid(1);
+    npc_nav_cache_clear();
+    npc_nav_begin_tick();
+    NpcNavPath p;
+    int served = 0;
+    NpcNavResult r = NPC_NAV_OK;
+    for (float y = 19450.0f; y < 19650.0f && r != NPC_NAV_BUSY; y += 25.0f)
+        for (float x = 20000.0f; x < 20550.0f && r != NPC_NAV_BUSY; x += 25.0f) {
+            r = npc_nav_path(g, x, y, 20450.0f, 20450.0f, &p);
+            if (r == NPC_NAV_OK) served++;
+        }
+    assert(r == NPC_NAV_BUSY && served > 0);
+    /* Cached routes are still answered while the budget is spent ... */
+    assert(npc_nav_path(g, 20000.0f, 19450.0f, 20450.0f, 20450.0f, &p) == NPC_NAV_OK);
+    /* ... and the next tick searches again */
+    npc_nav_begin_tick();
+    assert(npc_nav_path(g, 20300.0f, 19400.0f, 20300.0f, 20500.0f, &p) == NPC_NAV_OK);
+    printf("  budget: %d searches in one tick, then BUSY until the next\n", served);
+}
+
+int main(void) {
+    printf("Testing NPC navigation...\n");
+    npc_nav_init();
+    test_convex_deck();
+    test_concave_deck();
+    test_unreachable_goal();
+    test_blocked_start();
+    test_cache();
+    test_islands();
+    test_path_round_bay();
+    test_budget();
+    printf("All NPC navigation tests passed!\n");
+    return 0;
+}
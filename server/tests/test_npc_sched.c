@@ -0,0 +1,152 @@
+/* NPC AI scheduler: LOD cadence by distance and state, the per-tick budget,
+ * and dt accumulation for NPCs that sit ticks out.  The server globals the
+ * scheduler reads are defined here. */
+
+#define _POSIX_C_SOURCE 200809L
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "net/npc_sched.h"
+#include "net/websocket_server_internal.h"
+
+WebSocketPlayer players[WS_MAX_CLIENTS];
+WorldNpc world_npcs[MAX_WORLD_NPCS];
+int world_npc_count;
+NpcAgent npc_agents[MAX_NPC_AGENTS];
+int npc_count;
+SimpleShip ships[MAX_SIMPLE_SHIPS];
+int ship_count;
+
+SimpleShip* find_ship(uint16_t ship_id) {
+    for (int i = 0; i < ship_count; i++)
+        if (ships[i].active && ships[i].ship_id == ship_id) return &ships[i];
+    return NULL;
+}
+
+void world_npc_grapple_mask(bool* mask, int count) {
+    memset(mask, 0, (size_t)count * sizeof(bool));
+}
+
+#define DT (1.0f / 30.0f)
+
+static void reset(void) {
+    memset(players, 0, sizeof(players));
+    memset(world_npcs, 0, sizeof(world_npcs));
+    memset(npc_agents, 0, sizeof(npc_agents));
+    memset(ships, 0, sizeof(ships));
+    world_npc_count = npc_count = ship_count = 0;
+    /* Let every slot go inactive so the scheduler forgets it */
+    npc_sched_plan(DT);
+}
+
+static void add_npc(int i, float x, float y, WorldNpcState state) {
+    world_npcs[i].active = true;
+    world_npcs[i].x = x;
+    world_npcs[i].y = y;
+    world_npcs[i].state = state;
+    if (i + 1 > world_npc_count) world_npc_count = i + 1;
+}
+
+/* Runs `ticks` plans and counts how often world NPC i ran and for how long */
+static int run_ticks(int ticks, int i, float* total_dt) {
+    int runs = 0;
+    *total_dt = 0.0f;
+    for (int t = 0; t < ticks; t++) {
+        npc_sched_plan(DT);
+        for (int n = 0; n < world_npc_count; n++) {
+            float dt;
+            if (npc_sched_world_take(n, &dt) && n == i) {
+                runs++;
+                *total_dt += dt;
+            }
+        }
+    }
+    return runs;
+}
+
+static void test_lod_cadence(void) {
+    reset();
+    players[0].active = true;
+    add_npc(0, 100.0f, 0.0f, WORLD_NPC_STATE_IDLE);                          /* in view   */
+    add_npc(1, NPC_LOD_HOT_DIST + 500.0f, 0.0f, WORLD_NPC_STATE_IDLE);       /* warm ring */
+    add_npc(2, NPC_LOD_WARM_DIST * 3.0f, 0.0f, WORLD_NPC_STATE_IDLE);        /* far idle  */
+    add_npc(3, NPC_LOD_WARM_DIST * 3.0f, 0.0f, WORLD_NPC_STATE_MOVING);      /* far, walking */
+
+    npc_sched_plan(DT);
+    NpcSchedTickStats st;
+    npc_sched_last_stats(&st, NULL);
+    assert(st.active == 4);
+    assert(st.per_lod[NPC_LOD_HOT] == 1 && st.per_lod[NPC_LOD_WARM] == 2 && st.per_lod[NPC_LOD_COLD] == 1);
+    for (int n = 0; n < 4; n++) { float dt; (void)npc_sched_world_take(n, &dt); }
+
+    float total;
+    assert(run_ticks(90, 0, &total) == 90);
+    assert(run_ticks(90, 1, &total) == 90 / NPC_LOD_WARM_TICKS);
+    assert(run_ticks(90, 2, &total) == 90 / NPC_LOD_COLD_TICKS);
+    assert(fabsf(total - 90 * DT) < 1e-3f);   /* sat-out time is handed over */
+    assert(run_ticks(90, 3, &total) == 90 / NPC_LOD_WARM_TICKS);
+    printf("  hot every tick, warm every %d, cold every %d, dt carried over\n",
+           NPC_LOD_WARM_TICKS, NPC_LOD_COLD_TICKS);
+}
+
+static void test_budget(void) {
+    reset();
+    players[0].active = true;
+    for (int i = 0; i < MAX_WORLD_NPCS; i++) add_npc(i, (float)i, 0.0f, WORLD_NPC_STATE_MOVING);
+
+    int ran[MAX_WORLD_NPCS] = {0};
+    for (int t = 0; t < 40; t++) {
+        npc_sched_plan(DT);
+        NpcSchedTickStats st;
+        npc_sched_last_stats(&st, NULL);
+        assert(st.scheduled <= NPC_SCHED_WORLD_BUDGET);
+        assert(st.scheduled + st.deferred + st.skipped == MAX_WORLD_NPCS);
+        for (int n = 0; n < MAX_WORLD_NPCS; n++) {
+            float dt;
+            if (npc_sched_world_take(n, &dt)) ran[n]++;
+        }
+    }
+    /* 512 HOT NPCs share a 128 budget: each runs about every 4th tick, none starve */
+    int min_runs = 1 << 30, max_runs = 0;
+    for (int n = 0; n < MAX_WORLD_NPCS; n++) {
+        if (ran[n] < min_runs) min_runs = ran[n];
+        if (ran[n] > max_runs) max_runs = ran[n];
+    }
+    assert(min_runs >= 40 * NPC_SCHED_WORLD_BUDGET / MAX_WORLD_NPCS - 1);
+    assert(max_runs - min_runs <= 2);
+    printf("  512 hot NPCs under a %d budget: %d..%d runs in 40 ticks\n",
+           NPC_SCHED_WORLD_BUDGET, min_runs, max_runs);
+}
+
+static void test_agents_follow_ship(void) {
+    reset();
+    players[0].active = true;
+    ships[0] = (SimpleShip){ .ship_id = 7, .active = true, .x = NPC_LOD_WARM_DIST * 2.0f };
+    ship_count = 1;
+    npc_agents[0] = (NpcAgent){ .ship_id = 7, .active = true, .role = NPC_ROLE_RIGGER };
+    npc_agents[1] = (NpcAgent){ .ship_id = 7, .active = true, .role = NPC_ROLE_GUNNER, .target_ship_id = 9 };
+    npc_count = 2;
+
+    npc_sched_plan(DT);
+    NpcSchedTickStats st;
+    npc_sched_last_stats(NULL, &st);
+    assert(st.per_lod[NPC_LOD_COLD] == 1 && st.per_lod[NPC_LOD_WARM] == 1);
+
+    ships[0].x = 50.0f;   /* ship sails into view */
+    npc_sched_plan(DT);
+    npc_sched_last_stats(NULL, &st);
+    assert(st.per_lod[NPC_LOD_HOT] == 2);
+    printf("  agents take their ship's LOD; gunners with a target stay warm\n");
+}
+
+int main(void) {
+    printf("Testing NPC AI scheduler...\n");
+    npc_sched_init();
+    test_lod_cadence();
+    test_budget();
+    test_agents_follow_ship();
+    printf("All NPC scheduler tests passed!\n");
+    return 0;
+}
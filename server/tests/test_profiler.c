@@ -0,0 +1,133 @@
+/* Tick profiler: histogram percentiles stay within the log-linear bucket
+ * error, nested scopes land in the flight recorder with the right depth and
+ * containment, and the ring only ever exposes completed ticks. */
+
+#define _POSIX_C_SOURCE 200809L
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "util/profiler.h"
+
+static void test_histogram_percentiles(void) {
+    printf("Testing histogram percentiles...\n");
+    static struct ProfHistogram h;
+    memset(&h, 0, sizeof(h));
+
+    /* 1..10000 µs uniformly: p50 ≈ 5000, p99 ≈ 9900, p99.9 ≈ 9990 */
+    for (uint32_t v = 1; v <= 10000; v++) prof_hist_record(&h, v);
+    uint32_t p50 = prof_hist_percentile(&h, 50.0);
+    uint32_t p99 = prof_hist_percentile(&h, 99.0);
+    uint32_t p999 = prof_hist_percentile(&h, 99.9);
+    printf("  p50=%u p99=%u p999=%u max=%u\n", p50, p99, p999, h.max_us);
+    assert(p50 >= 5000 && p50 <= 5000 + 5000 / PROF_HIST_SUB);
+    assert(p99 >= 9900 && p99 <= 10000);
+    assert(p999 >= 9990 && p999 <= 10000);
+    assert(h.max_us == 10000);
+
+    /* Small values are exact, huge ones don't overflow the bucket table */
+    memset(&h, 0, sizeof(h));
+    prof_hist_record(&h, 7);
+    assert(prof_hist_percentile(&h, 50.0) == 7);
+    prof_hist_record(&h, UINT32_MAX);
+    assert(prof_hist_percentile(&h, 100.0) == UINT32_MAX);
+}
+
+static void spin_us(uint32_t us) {
+    struct timespec ts = { 0, (long)us * 1000L };
+    nanosleep(&ts, NULL);
+}
+
+static void test_nested_scopes(void) {
+    printf("Testing nested scopes and flight recorder...\n");
+    prof_init();
+    prof_reset();
+
+    /* Outside a tick scopes are ignored entirely */
+    PROF_BEGIN("outside");
+    PROF_END();
+
+    for (uint32_t tick = 1; tick <= PROF_FLIGHT_TICKS + 10; tick++) {
+        prof_tick_begin(tick);
+        PROF_BEGIN("sim");
+        PROF_BEGIN("sim.collisions");
+        spin_us(50);
+        PROF_END();
+        PROF_END();
+        PROF_BEGIN("send");
+        if (tick % 2) {
+            PROF_END();
+        }
+        /* Even ticks leave "send" open; prof_tick_end must close it */
+        prof_tick_end();
+    }
+
+    static struct ProfTick last;
+    assert(prof_last_tick(&last));
+    assert(last.tick == PROF_FLIGHT_TICKS + 10);
+    assert(last.event_count == 4);
+    assert(strcmp(prof_scope_name(last.events[0].scope), "tick") == 0 && last.events[0].depth == 0);
+    assert(strcmp(prof_scope_name(last.events[1].scope), "sim") == 0 && last.events[1].depth == 1);
+    assert(strcmp(prof_scope_name(last.events[2].scope), "sim.collisions") == 0 && last.events[2].depth == 2);
+    assert(strcmp(prof_scope_name(last.events[3].scope), "send") == 0 && last.events[3].depth == 1);
+    /* Children sit inside their parent */
+    assert(last.events[2].start_us >= last.events[1].start_us);
+    assert(last.events[2].start_us + last.events[2].dur_us <=
+           last.events[1].start_us + last.events[1].dur_us);
+    assert(last.events[2].dur_us >= 50);
+    assert(last.events[0].dur_us >= last.events[1].dur_us);
+
+    char line[128];
+    prof_format_last_tick(line, sizeof(line));
+    printf("  last tick: %s\n", line);
+    assert(strstr(line, "sim=") && strstr(line, "send=") && !strstr(line, "collisions"));
+
+    struct ProfScopeStats stats[PROF_MAX_SCOPES];
+    int n = prof_scope_stats(stats, PROF_MAX_SCOPES);
+    bool saw_outside = false;
+    for (int i = 0; i < n; i++) {
+        if (strcmp(stats[i].name, "sim.collisions") == 0) {
+            assert(stats[i].count == PROF_FLIGHT_TICKS + 10);
+            assert(stats[i].p50_us >= 50);
+        }
+        if (strcmp(stats[i].name, "outside") == 0) saw_outside = stats[i].count > 0;
+    }
+    assert(!saw_outside);
+}
+
+static void test_dumps(void) {
+    printf("Testing JSON and Chrome trace dumps...\n");
+    FILE* f = tmpfile();
+    assert(f);
+    assert(prof_write_json(f, 5) == 0);
+    long json_len = ftell(f);
+    assert(json_len > 0);
+
+    rewind(f);
+    assert(prof_write_chrome_trace(f) == 0);
+    long trace_len = ftell(f);
+    char* buf = malloc((size_t)trace_len + 1);
+    rewind(f);
+    size_t got = fread(buf, 1, (size_t)trace_len, f);
+    buf[got] = '\0';
+    fclose(f);
+
+    assert(strncmp(buf, "{\"displayTimeUnit\"", 18) == 0);
+    assert(strstr(buf, "\"ph\":\"X\""));
+    /* Whole ring exported: PROF_FLIGHT_TICKS ticks × 4 scopes */
+    int events = 0;
+    for (const char* p = buf; (p = strstr(p, "\"ph\":\"X\"")); p++) events++;
+    printf("  %d trace events, %ld bytes JSON\n", events, json_len);
+    assert(events == PROF_FLIGHT_TICKS * 4);
+    free(buf);
+}
+
+int main(void) {
+    test_histogram_percentiles();
+    test_nested_scopes();
+    test_dumps();
+    printf("All profiler tests passed!\n");
+    return 0;
+}
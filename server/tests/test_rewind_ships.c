@@ -0,0 +1,128 @@
+/* Rewind ship history: samples between two frames interpolate position and
+ * take the short way round for rotation; times outside the recorded span
+ * clamp to the oldest/newest frame; ships that spawn or despawn mid-window
+ * use the frames they appear in; unknown ships and an empty history report
+ * false; the ring keeps only the newest REWIND_BUFFER_SIZE frames; and the
+ * rewind window grows with RTT up to MAX_REWIND_TIME_MS. */
+
+#define _POSIX_C_SOURCE 200809L
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "rewind_buffer.h"
+
+#define PI_F 3.14159265f
+
+static rewind_ship_history_t g_hist;
+
+static bool near(float a, float b) { return fabsf(a - b) < 1e-3f; }
+
+/* Frame t: ship 10 at (100t, -50t) rotating 0.1 rad/frame; ship 20 parked */
+static void record_frame(uint32_t t, uint32_t ts) {
+    uint16_t ids[2] = { 10, 20 };
+    float xs[2]   = { 100.0f * (float)t, 500.0f };
+    float ys[2]   = { -50.0f * (float)t, 500.0f };
+    float rots[2] = { 0.1f * (float)t, 1.0f };
+    rewind_ships_record(&g_hist, t, ts, 2, ids, xs, ys, rots);
+}
+
+static void test_interpolate(void) {
+    rewind_ships_init(&g_hist);
+    float x, y, r;
+    assert(!rewind_ships_sample(&g_hist, 10, 1000, &x, &y, &r));
+
+    for (uint32_t t = 0; t < 8; t++) record_frame(t, 1000 + 33 * t);
+
+    /* Exactly on a frame, then a third of the way to the next */
+    assert(rewind_ships_sample(&g_hist, 10, 1000 + 33 * 3, &x, &y, &r));
+    assert(near(x, 300.0f) && near(y, -150.0f) && near(r, 0.3f));
+    assert(rewind_ships_sample(&g_hist, 10, 1000 + 33 * 3 + 11, &x, &y, &r));
+    assert(near(x, 333.333f) && near(y, -166.667f) && near(r, 0.3333f));
+
+    /* Clamped beyond either end: no extrapolation */
+    assert(rewind_ships_sample(&g_hist, 10, 5000, &x, &y, &r) && near(x, 700.0f));
+    assert(rewind_ships_sample(&g_hist, 10, 10, &x, &y, &r) && near(x, 0.0f));
+
+    /* Other ships and unknown ids */
+    assert(rewind_ships_sample(&g_hist, 20, 1050, &x, &y, &r) && near(x, 500.0f) && near(r, 1.0f));
+    assert(!rewind_ships_sample(&g_hist, 99, 1050, &x, &y, &r));
+    printf("  interpolation, clamping and unknown ships\n");
+}
+
+static void test_wrap_angle(void) {
+    rewind_ships_init(&g_hist);
+    uint16_t id = 7;
+    float x = 0.0f, y = 0.0f, r0 = PI_F - 0.1f, r1 = -PI_F + 0.1f;
+    rewind_ships_record(&g_hist, 0, 0, 1, &id, &x, &y, &r0);
+    rewind_ships_record(&g_hist, 1, 100, 1, &id, &x, &y, &r1);
+    float ox, oy, r;
+    assert(rewind_ships_sample(&g_hist, 7, 50, &ox, &oy, &r));
+    /* Halfway across ±π is π, not 0 */
+    assert(fabsf(remainderf(r - PI_F, 2.0f * PI_F)) < 1e-3f);
+    printf("  rotation takes the short arc across +-pi\n");
+}
+
+static void test_spawn_despawn(void) {
+    rewind_ships_init(&g_hist);
+    uint16_t a = 1, b = 2, both[2] = { 1, 2 };
+    float v0 = 0.0f, v1 = 10.0f, xs[2] = { 10.0f, 80.0f }, zs[2] = { 0.0f, 0.0f };
+    rewind_ships_record(&g_hist, 0, 0, 1, &a, &v0, &v0, &v0);        /* only 1  */
+    rewind_ships_record(&g_hist, 1, 100, 2, both, xs, zs, zs);      /* 1 and 2 */
+    rewind_ships_record(&g_hist, 2, 200, 1, &b, &v1, &v1, &v1);      /* only 2  */
+    float x, y, r;
+    /* Ship 2 before it spawned uses its first frame; ship 1 after despawn its last */
+    assert(rewind_ships_sample(&g_hist, 2, 50, &x, &y, &r) && near(x, 80.0f));
+    assert(rewind_ships_sample(&g_hist, 1, 150, &x, &y, &r) && near(x, 10.0f));
+    assert(rewind_ships_sample(&g_hist, 1, 250, &x, &y, &r) && near(x, 10.0f));
+    /* Reordered ids between frames still pair up */
+    assert(rewind_ships_sample(&g_hist, 2, 150, &x, &y, &r) && near(x, 45.0f));
+    printf("  ships spawning and despawning inside the window\n");
+}
+
+static void test_ring(void) {
+    rewind_ships_init(&g_hist);
+    const uint32_t n = REWIND_BUFFER_SIZE * 3 + 5;
+    for (uint32_t t = 0; t < n; t++) record_frame(t, 1000 + 33 * t);
+    assert(g_hist.frames == REWIND_BUFFER_SIZE);
+    float x, y, r;
+    /* Oldest surviving frame is n - REWIND_BUFFER_SIZE */
+    uint32_t oldest = n - REWIND_BUFFER_SIZE;
+    assert(rewind_ships_sample(&g_hist, 10, 0, &x, &y, &r) && near(x, 100.0f * (float)oldest));
+    for (uint32_t t = oldest; t + 1 < n; t++) {
+        assert(rewind_ships_sample(&g_hist, 10, 1000 + 33 * t + 16, &x, &y, &r));
+        assert(fabsf(x - (100.0f * (float)t + 100.0f * 16.0f / 33.0f)) < 0.01f);
+    }
+
+    /* More ships than a frame holds: the first REWIND_SHIP_MAX are kept */
+    static uint16_t ids[REWIND_SHIP_MAX + 10];
+    static float xs[REWIND_SHIP_MAX + 10];
+    for (int i = 0; i < REWIND_SHIP_MAX + 10; i++) { ids[i] = (uint16_t)(i + 1); xs[i] = (float)i; }
+    rewind_ships_record(&g_hist, n, 1000 + 33 * n, REWIND_SHIP_MAX + 10, ids, xs, xs, xs);
+    assert(rewind_ships_sample(&g_hist, REWIND_SHIP_MAX, 1000 + 33 * n, &x, &y, &r) &&
+           near(x, (float)(REWIND_SHIP_MAX - 1)));
+    assert(!rewind_ships_sample(&g_hist, REWIND_SHIP_MAX + 1, 1000 + 33 * n, &x, &y, &r));
+    printf("  ring keeps the newest %d frames, %d ships each\n", REWIND_BUFFER_SIZE, REWIND_SHIP_MAX);
+}
+
+static void test_window(void) {
+    assert(rewind_window_ms(0.0f) == REWIND_INTERP_DELAY_MS);
+    assert(rewind_window_ms(-5.0f) == REWIND_INTERP_DELAY_MS);
+    assert(rewind_window_ms(80.0f) == REWIND_INTERP_DELAY_MS + 40);
+    assert(rewind_window_ms(2000.0f) == MAX_REWIND_TIME_MS);
+    /* The ring must cover the longest window at 30 Hz */
+    assert(REWIND_BUFFER_SIZE * 1000 / 30 > MAX_REWIND_TIME_MS);
+    printf("  window grows with RTT and caps at %d ms\n", MAX_REWIND_TIME_MS);
+}
+
+int main(void) {
+    printf("Testing rewind ship history...\n");
+    test_interpolate();
+    test_wrap_angle();
+    test_spawn_despawn();
+    test_ring();
+    test_window();
+    printf("All rewind ship history tests passed!\n");
+    return 0;
+}
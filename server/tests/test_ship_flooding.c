@@ -0,0 +1,274 @@
+/* Ship flooding rows: a hull sinking from dry to awash passes the scoop
+ * mask through each compartment line (less the grace) and back as it is
+ * bailed; ingress matches the sim's drain formula scaled by sturdiness, and
+ * a sealed hull recovers instead; missing planks and gunports show up as
+ * openings at the right spots and answer near-opening queries by kind and
+ * reach; rows stay put until touched or the next update, but re-gather when
+ * a slot changes ship; ghost and scaffolded ships stay dry; and ships
+ * outside the updated array go through the scratch row without disturbing
+ * it. */
+
+#define _POSIX_C_SOURCE 200809L
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "sim/ship_flooding.h"
+#include "sim/module_types.h"
+#include "sim/ship_level.h"
+#include "core/math.h"
+
+static struct Ship g_ships[4];
+static struct Ship g_loose;
+
+static bool near(float a, float b) { return fabsf(a - b) < 1e-4f; }
+
+static ShipModule* add_module(struct Ship* s, uint16_t id, ModuleTypeId type, float x, float y) {
+    ShipModule* m = &s->modules[s->module_count++];
+    memset(m, 0, sizeof(*m));
+    m->id = id;
+    m->type_id = type;
+    m->local_pos.x = Q16_FROM_FLOAT(x);
+    m->local_pos.y = Q16_FROM_FLOAT(y);
+    return m;
+}
+
+/* Ten planks round the hull, two gunports per side, a bilge well below and
+ * a stray well on the upper deck */
+static void build_ship(struct Ship* s, uint32_t id, float hull) {
+    memset(s, 0, sizeof(*s));
+    s->id = id;
+    s->company_id = 1;
+    s->hull_health = Q16_FROM_FLOAT(hull);
+    ship_level_init(&s->level_stats);
+    for (int p = 0; p < 10; p++) {
+        ShipModule* m = add_module(s, (uint16_t)(100 + p), MODULE_TYPE_PLANK,
+                                   -30.0f + 6.0f * (float)(p % 5), p < 5 ? -9.0f : 9.0f);
+        m->health = m->max_health = 10000;
+    }
+    s->initial_plank_count = 10;
+    for (int g = 0; g < 4; g++) {
+        ShipModule* m = add_module(s, (uint16_t)(200 + g), MODULE_TYPE_GUNPORT, 0.0f, 0.0f);
+        m->data.gunport.snap_idx = (uint8_t)(g < 2 ? g : 4 + g);
+    }
+    ShipModule* w = add_module(s, 300, MODULE_TYPE_WELL, 4.0f, 1.5f);
+    w->deck_id = 0;
+    w = add_module(s, 301, MODULE_TYPE_WELL, -4.0f, 0.0f);
+    w->deck_id = 1;
+}
+
+static ShipModule* module_by_id(struct Ship* s, uint16_t id) {
+    for (uint8_t m = 0; m < s->module_count; m++)
+        if (s->modules[m].id == id) return &s->modules[m];
+    return NULL;
+}
+
+/* Fill and scoop mask of g_ships[1] after the next update */
+static void expect(float hull, uint8_t mask) {
+    g_ships[1].hull_health = Q16_FROM_FLOAT(hull);
+    ship_flooding_update(g_ships, 4);
+    ShipFloodState st;
+    ship_flood_state(&g_ships[1], &st);
+    assert(fabsf(st.fill - (1.0f - hull / 100.0f)) < 1e-3f);
+    assert(st.scoop_mask == mask);
+    for (int c = 0; c < FLOOD_COMPARTMENTS; c++)
+        assert(ship_flood_scoopable(&g_ships[1], (FloodCompartment)c) == ((mask >> c) & 1));
+    assert(ship_flood_fill(&g_ships[0]) == 0.0f);
+}
+
+static void test_transitions(void) {
+    for (int i = 0; i < 4; i++) build_ship(&g_ships[i], (uint32_t)(i + 1), 100.0f);
+
+    /* Sinking: dry, then each compartment takes water two points early */
+    expect(100.0f, 0x0);
+    expect(99.5f, 0x1);    /* bilge from the first trickle */
+    expect(79.0f, 0x1);    /* 21%: lower deck still dry */
+    expect(77.0f, 0x3);    /* 23%: within the grace of 25% */
+    expect(29.0f, 0x3);    /* 71%: upper deck still dry */
+    expect(27.0f, 0x7);    /* 73%: within the grace of 75% */
+    expect(0.0f, 0x7);
+
+    /* Bailing back out drops them in reverse */
+    expect(40.0f, 0x3);
+    expect(90.0f, 0x1);
+    expect(100.0f, 0x0);
+    printf("  dry -> bilge -> lower -> upper and back (lines %.2f / %.2f / %.2f, grace %.2f)\n",
+           FLOOD_COMPARTMENT_LINE[FLOOD_BILGE], FLOOD_COMPARTMENT_LINE[FLOOD_LOWER],
+           FLOOD_COMPARTMENT_LINE[FLOOD_UPPER], FLOOD_SCOOP_GRACE);
+}
+
+static void test_rates(void) {
+    struct Ship* s = &g_ships[2];
+    build_ship(s, 3, 60.0f);
+    ship_flooding_update(g_ships, 4);
+    ShipFloodState st;
+    ship_flood_state(s, &st);
+    assert(st.ingress == 0.0f && near(st.recovery, 0.01f) && isinf(st.secs_to_sink));
+    assert(st.missing_planks == 0 && st.leaking_planks == 0);
+
+    /* Two planks gone, one under 30%, sturdiness upgraded twice */
+    module_by_id(s, 101)->health = 0;
+    module_by_id(s, 107)->health = 0;
+    module_by_id(s, 104)->health = 2999;
+    module_by_id(s, 105)->health = 3000;   /* exactly 30%: sound */
+    s->level_stats.levels[SHIP_ATTR_STURDINESS] = 3;
+    ship_flooding_update(g_ships, 4);
+    ship_flood_state(s, &st);
+    assert(st.missing_planks == 2 && st.leaking_planks == 1);
+    float hp_per_s = ship_flood_drain_rate(2, 1) * ship_level_sturdiness_mult(&s->level_stats);
+    assert(near(st.ingress, hp_per_s / 100.0f) && st.recovery == 0.0f);
+    assert(fabsf(st.secs_to_sink - 0.6f / st.ingress) < 1e-2f);
+
+    /* Patched up again: ingress stops and the hull sheds water */
+    module_by_id(s, 101)->health = module_by_id(s, 107)->health = 10000;
+    module_by_id(s, 104)->health = 10000;
+    ship_flooding_update(g_ships, 4);
+    ship_flood_state(s, &st);
+    assert(st.ingress == 0.0f && near(st.recovery, 0.01f) && isinf(st.secs_to_sink));
+
+    /* The shared formula: missing planks double, leaks add half of one */
+    assert(ship_flood_drain_rate(0, 0) == 0.0f);
+    assert(near(ship_flood_drain_rate(1, 0), 1.0f / 1.2f));
+    assert(near(ship_flood_drain_rate(3, 0), 4.0f / 1.2f));
+    assert(near(ship_flood_drain_rate(0, 2), 1.0f / 1.2f));
+    assert(ship_flood_drain_rate(40, 0) == ship_flood_drain_rate(16, 0));
+    assert(ship_flood_drain_rate(-3, 0) == 0.0f);
+    printf("  leaks raise ingress, a sealed hull recovers\n");
+}
+
+static void test_openings(void) {
+    struct Ship* s = &g_ships[0];
+    build_ship(s, 1, 50.0f);
+    module_by_id(s, 103)->health = 0;
+    module_by_id(s, 201)->data.gunport.is_open = 1;
+    ship_flooding_update(g_ships, 4);
+
+    int n;
+    const FloodOpening* o = ship_flood_openings(s, &n);
+    assert(n == 5);
+    int planks = 0, open = 0, shut = 0;
+    for (int k = 0; k < n; k++) {
+        if (o[k].kind == FLOOD_OPENING_PLANK) {
+            planks++;
+            assert(o[k].module_id == 103);
+            assert(near(o[k].x, SERVER_TO_CLIENT(-30.0f + 18.0f)) && near(o[k].y, SERVER_TO_CLIENT(-9.0f)));
+        } else if (o[k].kind == FLOOD_OPENING_GUNPORT_OPEN) {
+            open++;
+            assert(o[k].module_id == 201 && near(o[k].x, 77.5f) && near(o[k].y, -90.0f));
+        } else {
+            assert(o[k].kind == FLOOD_OPENING_GUNPORT_SHUT);
+            shut++;
+        }
+    }
+    assert(planks == 1 && open == 1 && shut == 3);
+
+    ShipFloodState st;
+    ship_flood_state(s, &st);
+    assert(st.open_gunports == 1);
+
+    /* Only the lower-deck well counts */
+    float wx, wy;
+    assert(ship_flood_well(s, &wx, &wy));
+    assert(near(wx, SERVER_TO_CLIENT(4.0f)) && near(wy, SERVER_TO_CLIENT(1.5f)));
+    struct Ship* dry = &g_ships[3];
+    build_ship(dry, 4, 100.0f);
+    module_by_id(dry, 300)->deck_id = 1;
+    ship_flooding_touch(dry);
+    assert(!ship_flood_well(dry, &wx, &wy));
+
+    /* Near-opening queries pick by kind and reach (inclusive) */
+    uint16_t id = 0;
+    assert(ship_flood_near_opening(s, -120.0f, -90.0f, 1.0f, FLOOD_OPENING_PLANK, &id) && id == 103);
+    assert(!ship_flood_near_opening(s, -120.0f, -80.0f, 9.0f, FLOOD_OPENING_PLANK, NULL));
+    assert(ship_flood_near_opening(s, -120.0f, -80.0f, 10.0f, FLOOD_OPENING_PLANK, &id) && id == 103);
+    assert(!ship_flood_near_opening(s, -120.0f, -90.0f, 1.0f, FLOOD_OPENING_GUNPORT_OPEN, NULL));
+    assert(!ship_flood_near_opening(s, 77.5f, -90.0f, 5.0f, FLOOD_OPENING_PLANK, NULL));
+    assert(ship_flood_near_opening(s, 77.5f, -90.0f, 5.0f, FLOOD_OPENING_GUNPORT_OPEN, &id) && id == 201);
+    assert(!ship_flood_near_opening(s, 77.5f, -90.0f, 5.0f, FLOOD_OPENING_GUNPORT_SHUT, NULL));
+    assert(ship_flood_near_opening(s, 152.5f, 85.0f, 5.0f, FLOOD_OPENING_GUNPORT_SHUT, &id) && id == 202);
+    assert(ship_flood_near_opening(s, 0.0f, -90.0f, 100.0f, 0x7, &id) && id == 201);
+    assert(!ship_flood_near_opening(s, 0.0f, 0.0f, 80.0f, 0x7, NULL));
+    printf("  openings, the bilge well and near-opening queries\n");
+}
+
+static void test_staleness(void) {
+    for (int i = 0; i < 4; i++) build_ship(&g_ships[i], (uint32_t)(i + 1), 100.0f);
+    ship_flooding_update(g_ships, 4);
+    assert(ship_flood_fill(&g_ships[2]) == 0.0f);
+
+    /* Same tick, no touch: the row still holds the gathered value */
+    g_ships[2].hull_health = Q16_FROM_FLOAT(40.0f);
+    assert(ship_flood_fill(&g_ships[2]) == 0.0f);
+    ship_flooding_touch(&g_ships[2]);
+    assert(near(ship_flood_fill(&g_ships[2]), 0.6f));
+
+    /* Opening a gunport mid-tick shows up after touch */
+    module_by_id(&g_ships[2], 200)->data.gunport.is_open = 1;
+    assert(!ship_flood_near_opening(&g_ships[2], 152.5f, -90.0f, 1.0f, FLOOD_OPENING_GUNPORT_OPEN, NULL));
+    ship_flooding_touch(&g_ships[2]);
+    assert(ship_flood_near_opening(&g_ships[2], 152.5f, -90.0f, 1.0f, FLOOD_OPENING_GUNPORT_OPEN, NULL));
+
+    /* A slot that now holds another ship re-gathers on read */
+    build_ship(&g_ships[3], 77, 10.0f);
+    assert(near(ship_flood_fill(&g_ships[3]), 0.9f));
+
+    /* The next update picks up everything */
+    g_ships[0].hull_health = Q16_FROM_FLOAT(90.0f);
+    ship_flooding_update(g_ships, 4);
+    assert(near(ship_flood_fill(&g_ships[0]), 0.1f));
+    assert(near(ship_flood_fill(&g_ships[2]), 0.6f));
+    printf("  rows hold until touched, re-gather on a new ship or the next update\n");
+}
+
+static void test_dry_ships(void) {
+    build_ship(&g_ships[0], 1, 0.0f);
+    g_ships[0].company_id = 99;                     /* ghost: raw HP pool */
+    g_ships[0].hull_health = 20000;
+    module_by_id(&g_ships[0], 100)->health = 0;
+    build_ship(&g_ships[1], 2, 30.0f);
+    g_ships[1].flags |= SHIP_FLAG_SCAFFOLDED;
+    module_by_id(&g_ships[1], 100)->health = 0;
+    ship_flooding_update(g_ships, 2);
+    for (int i = 0; i < 2; i++) {
+        ShipFloodState st;
+        ship_flood_state(&g_ships[i], &st);
+        assert(st.fill == 0.0f && st.scoop_mask == 0 && st.ingress == 0.0f && st.recovery == 0.0f);
+        assert(isinf(st.secs_to_sink));
+    }
+    printf("  ghost and scaffolded ships stay dry\n");
+}
+
+static void test_scratch(void) {
+    for (int i = 0; i < 4; i++) build_ship(&g_ships[i], (uint32_t)(i + 1), 80.0f - 10.0f * (float)i);
+    ship_flooding_update(g_ships, 3);
+
+    /* Outside the array, and past its updated count: both use the scratch row */
+    build_ship(&g_loose, 500, 5.0f);
+    assert(near(ship_flood_fill(&g_loose), 0.95f));
+    assert(near(ship_flood_fill(&g_ships[3]), 0.5f));
+    assert(near(ship_flood_fill(&g_loose), 0.95f));
+    for (int i = 0; i < 3; i++)
+        assert(near(ship_flood_fill(&g_ships[i]), 0.2f + 0.1f * (float)i));
+
+    /* NULL ships are dry and have nothing to offer */
+    int n = -1;
+    float wx, wy;
+    assert(ship_flood_fill(NULL) == 0.0f && !ship_flood_scoopable(NULL, FLOOD_BILGE));
+    assert(ship_flood_openings(NULL, &n) == NULL && n == 0);
+    assert(!ship_flood_well(NULL, &wx, &wy));
+    assert(!ship_flood_near_opening(NULL, 0.0f, 0.0f, 1000.0f, 0x7, NULL));
+    printf("  scratch row for ships outside the updated array\n");
+}
+
+int main(void) {
+    printf("Testing ship flooding...\n");
+    test_transitions();
+    test_rates();
+    test_openings();
+    test_staleness();
+    test_dry_ships();
+    test_scratch();
+    printf("All ship flooding tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,213 @@
+/* Ship module grid: queries return exactly the filed modules whose centre is
+ * within reach on both axes, in modules[] order — for modules on and beside
+ * cell borders, at the hull edge, after removal and re-insertion, and for
+ * oversized (coarser cells) and stacked layouts; filtered types stay out;
+ * module_count changes and invalidation mark the grid stale. */
+
+#define _POSIX_C_SOURCE 200809L
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "net/ship_module_grid.h"
+
+static ShipModule g_mods[MAX_MODULES_PER_SHIP];
+static ShipModuleGrid g_grid;
+
+static float mod_x(uint8_t m) { return SERVER_TO_CLIENT(Q16_TO_FLOAT(g_mods[m].local_pos.x)); }
+static float mod_y(uint8_t m) { return SERVER_TO_CLIENT(Q16_TO_FLOAT(g_mods[m].local_pos.y)); }
+
+static bool solid_only(ModuleTypeId type) {
+    return type != MODULE_TYPE_PLANK && type != MODULE_TYPE_DECK;
+}
+
+static void place(uint8_t m, ModuleTypeId type, float x, float y) {
+    memset(&g_mods[m], 0, sizeof(ShipModule));
+    g_mods[m].id = (uint16_t)(0x100 | m);
+    g_mods[m].type_id = type;
+    g_mods[m].local_pos.x = Q16_FROM_FLOAT(CLIENT_TO_SERVER(x));
+    g_mods[m].local_pos.y = Q16_FROM_FLOAT(CLIENT_TO_SERVER(y));
+}
+
+/* Query result == brute force over every module */
+static uint32_t check_query(uint8_t count, float x, float y, float reach) {
+    uint8_t got[MAX_MODULES_PER_SHIP];
+    uint8_t n = ship_module_grid_query(&g_grid, x, y, reach, got);
+    uint8_t want = 0;
+    for (uint8_t m = 0; m < count; m++) {
+        if (!solid_only(g_mods[m].type_id)) continue;
+        if (fabsf(mod_x(m) - x) > reach || fabsf(mod_y(m) - y) > reach) continue;
+        assert(want < n && got[want] == m);
+        want++;
+    }
+    assert(n == want);
+    return n;
+}
+
+/* Check a row of queries sliding across (x0..x1, y) */
+static void sweep(uint8_t count, float x0, float x1, float y, float reach) {
+    for (float x = x0; x <= x1; x += 0.5f) check_query(count, x, y, reach);
+}
+
+static void test_cell_borders(void) {
+    /* Origin is the first module, so 160 and 320 sit exactly on cell
+     * borders (and store exactly), 159.99 / 160.01 a hair either side */
+    const float xs[] = { 0.0f, 159.99f, 160.0f, 160.01f, 320.0f, 479.99f };
+    uint8_t n = 0;
+    for (size_t i = 0; i < sizeof(xs) / sizeof(xs[0]); i++) {
+        place(n++, MODULE_TYPE_CANNON, xs[i], 0.0f);
+        place(n++, MODULE_TYPE_MAST, xs[i], 160.0f);
+    }
+    ship_module_grid_build(&g_grid, g_mods, n, solid_only);
+    assert(g_grid.inv_cell == 1.0f / SHIP_MODULE_GRID_CELL_PX);
+
+    uint8_t out[MAX_MODULES_PER_SHIP];
+    /* Reach ends exactly on the border modules: inclusive */
+    assert(ship_module_grid_query(&g_grid, 240.0f, 0.0f, 80.0f, out) == 3 &&
+           out[0] == 4 && out[1] == 6 && out[2] == 8);
+    /* Only the module on the border, not its neighbours either side */
+    assert(ship_module_grid_query(&g_grid, 160.0f, 0.0f, 0.005f, out) == 1 && out[0] == 4);
+    assert(ship_module_grid_query(&g_grid, 160.0f, 0.0f, 0.02f, out) == 3);
+    /* Both rows, from the cell between them */
+    assert(ship_module_grid_query(&g_grid, 320.0f, 80.0f, 80.0f, out) == 2 &&
+           out[0] == 8 && out[1] == 9);
+
+    for (float y = -32.0f; y <= 192.0f; y += 32.0f) {
+        sweep(n, -40.0f, 520.0f, y, 0.01f);
+        sweep(n, -40.0f, 520.0f, y, 16.0f);
+        sweep(n, -40.0f, 520.0f, y, 80.0f);
+    }
+    printf("  modules on and beside cell borders\n");
+}
+
+static void test_remove_reinsert(void) {
+    place(0, MODULE_TYPE_HELM, 0.0f, 0.0f);
+    place(1, MODULE_TYPE_CANNON, 50.0f, 0.0f);
+    place(2, MODULE_TYPE_MAST, 100.0f, 0.0f);
+    place(3, MODULE_TYPE_CANNON, 150.0f, 0.0f);
+    ship_module_grid_build(&g_grid, g_mods, 4, solid_only);
+
+    uint8_t out[MAX_MODULES_PER_SHIP];
+    assert(ship_module_grid_query(&g_grid, 100.0f, 0.0f, 10.0f, out) == 1 && out[0] == 2);
+
+    /* Remove the mast: later modules shift down, count drops */
+    memmove(&g_mods[2], &g_mods[3], sizeof(ShipModule));
+    ship_module_grid_invalidate(&g_grid);
+    assert(!ship_module_grid_current(&g_grid, 3));
+    ship_module_grid_build(&g_grid, g_mods, 3, solid_only);
+    assert(ship_module_grid_query(&g_grid, 100.0f, 0.0f, 10.0f, out) == 0);
+    assert(ship_module_grid_query(&g_grid, 150.0f, 0.0f, 10.0f, out) == 1 && out[0] == 2);
+
+    /* Remove then re-insert elsewhere before the next use: same count, but
+     * the invalidation still forces a rebuild */
+    ship_module_grid_invalidate(&g_grid);
+    place(2, MODULE_TYPE_MAST, -80.0f, 40.0f);
+    assert(!ship_module_grid_current(&g_grid, 3));
+    ship_module_grid_build(&g_grid, g_mods, 3, solid_only);
+    assert(ship_module_grid_current(&g_grid, 3));
+    assert(ship_module_grid_query(&g_grid, 150.0f, 0.0f, 10.0f, out) == 0);
+    assert(ship_module_grid_query(&g_grid, -80.0f, 40.0f, 10.0f, out) == 1 && out[0] == 2);
+
+    /* Appending one more shows up as a count change alone */
+    place(3, MODULE_TYPE_CANNON, 200.0f, -40.0f);
+    assert(!ship_module_grid_current(&g_grid, 4));
+    ship_module_grid_build(&g_grid, g_mods, 4, solid_only);
+    sweep(4, -120.0f, 240.0f, 0.0f, 40.0f);
+    printf("  removal, re-insertion and appends\n");
+}
+
+static void test_hull_edge(void) {
+    /* Brigantine-like layout: cannons along both sides at the hull edge,
+     * helm and masts on the centreline, planks around the rim */
+    uint8_t n = 0;
+    for (int i = 0; i < 6; i++) {
+        float x = -250.0f + 100.0f * (float)i;
+        place(n++, MODULE_TYPE_CANNON, x, -90.0f);
+        place(n++, MODULE_TYPE_CANNON, x, 90.0f);
+        place(n++, MODULE_TYPE_PLANK, x, -100.0f);
+        place(n++, MODULE_TYPE_PLANK, x, 100.0f);
+    }
+    place(n++, MODULE_TYPE_HELM, -300.0f, 0.0f);
+    place(n++, MODULE_TYPE_MAST, 0.0f, 0.0f);
+    place(n++, MODULE_TYPE_MAST, 320.0f, 0.0f);
+    ship_module_grid_build(&g_grid, g_mods, n, solid_only);
+
+    uint8_t out[MAX_MODULES_PER_SHIP];
+    /* A walker at the starboard rail reaches the cannon beside it only */
+    assert(ship_module_grid_query(&g_grid, -50.0f, 110.0f, 30.0f, out) == 1 && out[0] == 9);
+    /* The outermost cells, queried from past the hull on every side */
+    assert(ship_module_grid_query(&g_grid, 340.0f, 0.0f, 20.0f, out) == 1 && out[0] == n - 1);
+    assert(ship_module_grid_query(&g_grid, 340.01f, 0.0f, 20.0f, out) == 0);
+    assert(ship_module_grid_query(&g_grid, -320.0f, 0.0f, 20.0f, out) == 1 && out[0] == n - 3);
+    assert(ship_module_grid_query(&g_grid, 250.0f, -120.0f, 30.0f, out) == 1 && out[0] == 20);
+    for (float y = -130.0f; y <= 130.0f; y += 20.0f) sweep(n, -360.0f, 360.0f, y, 30.0f);
+    printf("  queries at and past the hull edge\n");
+}
+
+static void test_layouts(void) {
+    /* Oversized ship: the cell doubles until it fits */
+    place(0, MODULE_TYPE_CANNON, -6000.0f, -3000.0f);
+    place(1, MODULE_TYPE_MAST, 6000.0f, 3000.0f);
+    place(2, MODULE_TYPE_HELM, 0.0f, 0.0f);
+    ship_module_grid_build(&g_grid, g_mods, 3, solid_only);
+    assert(g_grid.cols <= SHIP_MODULE_GRID_MAX_COLS && g_grid.rows <= SHIP_MODULE_GRID_MAX_ROWS);
+    assert(g_grid.inv_cell < 1.0f / SHIP_MODULE_GRID_CELL_PX);
+    uint8_t out[MAX_MODULES_PER_SHIP];
+    assert(ship_module_grid_query(&g_grid, 5990.0f, 2990.0f, 10.0f, out) == 1 && out[0] == 1);
+    assert(ship_module_grid_query(&g_grid, 0.0f, 0.0f, 6000.0f, out) == 3);
+
+    /* Stacked: several modules on one point, all in one cell, in order */
+    for (uint8_t m = 0; m < 8; m++) place(m, MODULE_TYPE_CANNON, 40.0f, -40.0f);
+    ship_module_grid_build(&g_grid, g_mods, 8, solid_only);
+    assert(g_grid.cols == 1 && g_grid.rows == 1);
+    assert(ship_module_grid_query(&g_grid, 40.0f, -40.0f, 0.0f, out) == 8);
+    for (uint8_t m = 0; m < 8; m++) assert(out[m] == m);
+    printf("  oversized and stacked layouts\n");
+}
+
+static void test_edges(void) {
+    place(0, MODULE_TYPE_HELM, 100.0f, 0.0f);
+    place(1, MODULE_TYPE_PLANK, 100.0f, 0.0f);
+    place(2, MODULE_TYPE_CANNON, -200.0f, 60.0f);
+    ship_module_grid_build(&g_grid, g_mods, 3, solid_only);
+
+    uint8_t out[MAX_MODULES_PER_SHIP];
+    /* Planks are not filed; reach is inclusive */
+    assert(ship_module_grid_query(&g_grid, 100.0f, 0.0f, 1.0f, out) == 1 && out[0] == 0);
+    assert(ship_module_grid_query(&g_grid, 70.0f, 0.0f, 30.0f, out) == 1);
+    assert(ship_module_grid_query(&g_grid, 69.0f, 0.0f, 30.0f, out) == 0);
+    /* Far outside the grid on either side */
+    assert(ship_module_grid_query(&g_grid, 5000.0f, 0.0f, 40.0f, out) == 0);
+    assert(ship_module_grid_query(&g_grid, -5000.0f, -5000.0f, 40.0f, out) == 0);
+    /* Covering everything returns both filed modules in order */
+    assert(ship_module_grid_query(&g_grid, 0.0f, 0.0f, 1000.0f, out) == 2 &&
+           out[0] == 0 && out[1] == 2);
+
+    /* Staleness: appends change module_count; removals invalidate */
+    assert(ship_module_grid_current(&g_grid, 3));
+    assert(!ship_module_grid_current(&g_grid, 4));
+    ship_module_grid_invalidate(&g_grid);
+    assert(!ship_module_grid_current(&g_grid, 3));
+
+    /* Empty ships and all-zero (never built) grids answer nothing */
+    ship_module_grid_build(&g_grid, g_mods, 0, solid_only);
+    assert(ship_module_grid_current(&g_grid, 0));
+    assert(ship_module_grid_query(&g_grid, 0.0f, 0.0f, 1000.0f, out) == 0);
+    ShipModuleGrid fresh;
+    memset(&fresh, 0, sizeof(fresh));
+    assert(!ship_module_grid_current(&fresh, 0));
+    assert(ship_module_grid_query(&fresh, 0.0f, 0.0f, 1000.0f, out) == 0);
+    printf("  filters, edges and staleness\n");
+}
+
+int main(void) {
+    printf("Testing ship module grid...\n");
+    test_edges();
+    test_cell_borders();
+    test_remove_reinsert();
+    test_hull_edge();
+    test_layouts();
+    printf("All ship module grid tests passed!\n");
+    return 0;
+}
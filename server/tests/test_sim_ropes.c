@@ -0,0 +1,165 @@
+/* Rope constraints: a taut rope puts its body back on the rope circle and
+ * strips only the outward velocity; slack and boarded bodies are left alone;
+ * ship anchors follow the ship transform; chained ropes (a player hanging off
+ * another roped player) converge; the table refuses ropes past MAX_ROPES; and
+ * a rope declared before sim_step holds a swimmer through integration. */
+
+#define _POSIX_C_SOURCE 200809L
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "sim/simulation.h"
+#include "util/profiler.h"
+
+#define EPS 0.05f   /* Server units; Q16 round trip plus solver tolerance */
+
+static float fx(q16_t v) { return Q16_TO_FLOAT(v); }
+
+static Vec2Q16 v2(float x, float y) {
+    return (Vec2Q16){ Q16_FROM_FLOAT(x), Q16_FROM_FLOAT(y) };
+}
+
+static float dist_to(const struct Player* p, float ax, float ay) {
+    float dx = fx(p->position.x) - ax, dy = fx(p->position.y) - ay;
+    return sqrtf(dx * dx + dy * dy);
+}
+
+static void fresh_sim(struct Sim* sim) {
+    static bool inited;
+    if (inited) sim_cleanup(sim);
+    inited = true;
+    struct SimConfig cfg = { .random_seed = 45,
+                             .water_friction = Q16_FROM_FLOAT(0.95f),
+                             .air_friction = Q16_FROM_FLOAT(0.99f),
+                             .buoyancy_factor = Q16_FROM_FLOAT(1.2f) };
+    assert(sim_init(sim, &cfg) == 0);
+}
+
+static void add_world_rope(struct Sim* sim, entity_id body, float ax, float ay, float len) {
+    struct RopeConstraint rc = { .body = body, .anchor_kind = ROPE_ANCHOR_WORLD,
+                                 .anchor_pos = v2(ax, ay), .length = Q16_FROM_FLOAT(len) };
+    assert(sim_rope_add(sim, &rc));
+}
+
+static void test_world_anchor(struct Sim* sim) {
+    fresh_sim(sim);
+    entity_id taut  = sim_create_player(sim, v2(600.0f, 500.0f), 0);
+    entity_id slack = sim_create_player(sim, v2(520.0f, 600.0f), 0);
+    struct Player* p = sim_get_player(sim, taut);
+    p->velocity = v2(5.0f, 3.0f);   /* Outward (+x) and tangential (+y) */
+
+    add_world_rope(sim, taut, 500.0f, 500.0f, 60.0f);
+    add_world_rope(sim, slack, 500.0f, 600.0f, 60.0f);
+    sim_solve_ropes(sim);
+
+    p = sim_get_player(sim, taut);
+    assert(fabsf(fx(p->position.x) - 560.0f) < EPS && fabsf(fx(p->position.y) - 500.0f) < EPS);
+    assert(fabsf(fx(p->velocity.x)) < EPS && fabsf(fx(p->velocity.y) - 3.0f) < EPS);
+
+    struct Player* s = sim_get_player(sim, slack);
+    assert(fabsf(fx(s->position.x) - 520.0f) < EPS && fabsf(fx(s->position.y) - 600.0f) < EPS);
+
+    /* Inward velocity on a taut rope is kept */
+    p->position = v2(600.0f, 500.0f);
+    p->velocity = v2(-4.0f, 0.0f);
+    sim_solve_ropes(sim);
+    assert(fabsf(fx(p->velocity.x) + 4.0f) < EPS);
+    printf("  world anchors: taut projected, slack untouched\n");
+}
+
+static void test_ship_anchor(struct Sim* sim) {
+    fresh_sim(sim);
+    const float half_pi = 1.5707963f;
+    entity_id ship = sim_create_ship(sim, v2(500.0f, 500.0f), Q16_FROM_FLOAT(half_pi), 0xFF, 1);
+    entity_id body = sim_create_player(sim, v2(500.0f, 700.0f), 0);
+    entity_id aboard = sim_create_player(sim, v2(500.0f, 900.0f), ship);
+    assert(ship && body && aboard);
+
+    /* Local (+40, 0) on a ship rotated 90° sits at world (500, 540) */
+    struct RopeConstraint rc = { .body = body, .anchor_id = ship, .anchor_kind = ROPE_ANCHOR_SHIP,
+                                 .anchor_pos = v2(40.0f, 0.0f), .length = Q16_FROM_FLOAT(50.0f) };
+    assert(sim_rope_add(sim, &rc));
+    rc.body = aboard;
+    assert(sim_rope_add(sim, &rc));
+    Vec2Q16 aboard_before = sim_get_player(sim, aboard)->position;
+    sim_solve_ropes(sim);
+
+    /* q16_sin/q16_cos are 1024-entry tables: ~0.006 rad, ~0.25 units at 40 */
+    struct Player* p = sim_get_player(sim, body);
+    assert(fabsf(fx(p->position.x) - 500.0f) < 0.5f);
+    assert(fabsf(fx(p->position.y) - 590.0f) < 0.5f);
+
+    /* Boarded bodies are pinned to their deck by the sim; ropes skip them */
+    struct Player* a = sim_get_player(sim, aboard);
+    assert(a->position.x == aboard_before.x && a->position.y == aboard_before.y);
+    printf("  ship anchors follow the hull transform; boarded bodies skipped\n");
+}
+
+static void test_chain(struct Sim* sim) {
+    fresh_sim(sim);
+    entity_id a = sim_create_player(sim, v2(700.0f, 500.0f), 0);
+    entity_id b = sim_create_player(sim, v2(900.0f, 500.0f), 0);
+    struct RopeConstraint rc = { .body = b, .anchor_id = a, .anchor_kind = ROPE_ANCHOR_PLAYER,
+                                 .length = Q16_FROM_FLOAT(50.0f) };
+    /* Declared child-first: sweeps, not declaration order, must settle it */
+    assert(sim_rope_add(sim, &rc));
+    add_world_rope(sim, a, 500.0f, 500.0f, 100.0f);
+    sim_solve_ropes(sim);
+
+    struct Player* pa = sim_get_player(sim, a);
+    struct Player* pb = sim_get_player(sim, b);
+    assert(fabsf(dist_to(pa, 500.0f, 500.0f) - 100.0f) < EPS);
+    assert(dist_to(pb, fx(pa->position.x), fx(pa->position.y)) <= 50.0f + EPS);
+
+    /* Missing bodies / anchors are ignored rather than dereferenced */
+    struct RopeConstraint ghost = { .body = 999, .anchor_kind = ROPE_ANCHOR_WORLD };
+    struct RopeConstraint orphan = { .body = b, .anchor_id = 998, .anchor_kind = ROPE_ANCHOR_SHIP };
+    assert(sim_rope_add(sim, &ghost) && sim_rope_add(sim, &orphan));
+    sim_solve_ropes(sim);
+    printf("  chained ropes converge\n");
+}
+
+static void test_capacity(struct Sim* sim) {
+    fresh_sim(sim);
+    struct RopeConstraint rc = { .body = 1, .anchor_kind = ROPE_ANCHOR_WORLD };
+    for (int i = 0; i < MAX_ROPES; i++) assert(sim_rope_add(sim, &rc));
+    assert(!sim_rope_add(sim, &rc));
+    assert(sim->rope_count == MAX_ROPES);
+    sim_ropes_clear(sim);
+    assert(sim->rope_count == 0 && sim_rope_add(sim, &rc));
+    printf("  table caps at MAX_ROPES and clears\n");
+}
+
+static void test_step_holds_swimmer(struct Sim* sim) {
+    fresh_sim(sim);
+    entity_id body = sim_create_player(sim, v2(500.0f, 500.0f), 0);
+    q16_t dt = Q16_FROM_FLOAT(TICK_DURATION_MS / 1000.0f);
+    for (int t = 0; t < 60; t++) {
+        struct Player* p = sim_get_player(sim, body);
+        p->velocity = v2(8.0f, 1.0f);   /* Swimming away every tick */
+        sim_ropes_clear(sim);
+        add_world_rope(sim, body, 480.0f, 500.0f, 40.0f);
+        sim->tick = (uint32_t)t;
+        sim_step(sim, dt);
+        assert(dist_to(sim_get_player(sim, body), 480.0f, 500.0f) <= 40.0f + EPS);
+    }
+    printf("  rope holds a swimmer through sim_step\n");
+}
+
+int main(void) {
+    printf("Testing sim rope constraints...\n");
+    prof_init();
+    struct Sim* sim = calloc(1, sizeof(struct Sim));
+    assert(sim);
+    test_world_anchor(sim);
+    test_ship_anchor(sim);
+    test_chain(sim);
+    test_capacity(sim);
+    test_step_holds_swimmer(sim);
+    sim_cleanup(sim);
+    free(sim);
+    printf("All sim rope tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,314 @@
+/* Structure index: the slot map (alloc/free/reuse, handles, dense live and
+ * per-type lists), id lookups, the claim territory grid — candidates for
+ * a point must be a slot-ordered superset of every active structure whose
+ * claim circle covers it — and the placement grid, which must list exactly
+ * the matching structures in range through alloc/free churn.  All must follow
+ * structure_index_rebuild() and silent count changes (world load). */
+
+#define _POSIX_C_SOURCE 200809L
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+
+#include "net/structure_index.h"
+#include "net/websocket_server_internal.h"
+
+PlacedStructure placed_structures[MAX_PLACED_STRUCTURES];
+uint32_t placed_structure_count;
+uint16_t next_structure_id = 1;
+
+/* Mirrors struct_claim_radius() in claim.c */
+static float claim_radius(PlacedStructureType t) {
+    if (t == STRUCT_FLAG_FORT)        return CLAIM_RADIUS_FLAG_FORT;
+    if (t == STRUCT_COMPANY_FORTRESS) return CLAIM_RADIUS_COMPANY_FORT;
+    return CLAIM_RADIUS_DEFAULT;
+}
+
+static float frand(float lo, float hi) {
+    return lo + (hi - lo) * (float)rand() / (float)RAND_MAX;
+}
+
+/* Every covering structure appears, and the list is strictly increasing */
+static void check_point(float wx, float wy) {
+    uint32_t n;
+    const uint32_t *cand = structure_index_claim_candidates(wx, wy, &n);
+    for (uint32_t k = 1; k < n; k++) assert(cand[k - 1] < cand[k]);
+    uint32_t k = 0;
+    for (uint32_t i = 0; i < placed_structure_count; i++) {
+        const PlacedStructure *s = &placed_structures[i];
+        float dx = wx - s->x, dy = wy - s->y, r = claim_radius(s->type);
+        while (k < n && cand[k] < i) k++;
+        bool listed = k < n && cand[k] == i;
+        if (s->active && dx * dx + dy * dy <= r * r) assert(listed);
+        if (!s->active) assert(!listed);
+    }
+}
+
+static void fill(uint32_t count, float spread) {
+    memset(placed_structures, 0, sizeof(placed_structures));
+    for (uint32_t i = 0; i < count; i++) {
+        PlacedStructure *s = &placed_structures[i];
+        s->active = (rand() % 8) != 0;
+        s->id = (uint16_t)(i + 1);
+        s->type = (rand() % 4 == 0) ? STRUCT_FLAG_FORT : STRUCT_WALL;
+        s->x = frand(-spread, spread);
+        s->y = frand(-spread, spread);
+    }
+    placed_structure_count = count;
+}
+
+static void test_superset(void) {
+    srand(1234);
+    fill(MAX_PLACED_STRUCTURES, 20000.0f);
+    structure_index_rebuild();
+    for (int q = 0; q < 4000; q++) check_point(frand(-21000.0f, 21000.0f), frand(-21000.0f, 21000.0f));
+    /* Points right on structures hit the densest cells */
+    for (uint32_t i = 0; i < placed_structure_count; i++)
+        check_point(placed_structures[i].x, placed_structures[i].y);
+    printf("  %u structures: candidates cover every claim circle, in slot order\n", placed_structure_count);
+}
+
+static void test_clustered(void) {
+    srand(99);
+    fill(MAX_PLACED_STRUCTURES, 900.0f);   /* One crowded island */
+    structure_index_rebuild();
+    for (int q = 0; q < 2000; q++) check_point(frand(-1600.0f, 1600.0f), frand(-1600.0f, 1600.0f));
+    printf("  crowded island handled\n");
+}
+
+static void test_follows_changes(void) {
+    fill(0, 0.0f);
+    structure_index_rebuild();
+    uint32_t n;
+    (void)structure_index_claim_candidates(0.0f, 0.0f, &n);
+    assert(n == 0);
+
+    /* Loader appends without calling rebuild: the count change is noticed */
+    placed_structures[0] = (PlacedStructure){ .active = true, .id = 1, .type = STRUCT_WALL, .x = 10.0f, .y = 10.0f };
+    placed_structure_count = 1;
+    const uint32_t *cand = structure_index_claim_candidates(0.0f, 0.0f, &n);
+    assert(n == 1 && cand[0] == 0);
+
+    /* Removal goes through rebuild */
+    placed_structures[0].active = false;
+    structure_index_rebuild();
+    (void)structure_index_claim_candidates(0.0f, 0.0f, &n);
+    assert(n == 0);
+    printf("  grid follows rebuilds and loader appends\n");
+}
+
+static void test_id_lookup(void) {
+    fill(0, 0.0f);
+    placed_structures[0] = (PlacedStructure){ .active = true,  .id = 40000, .type = STRUCT_WALL };
+    placed_structures[1] = (PlacedStructure){ .active = false, .id = 7,     .type = STRUCT_WALL };
+    placed_structures[2] = (PlacedStructure){ .active = true,  .id = 9,     .type = STRUCT_SHIPYARD };
+    placed_structure_count = 3;
+    structure_index_rebuild();
+    assert(structure_by_id(40000) == &placed_structures[0]);   /* full uint16 range */
+    assert(structure_by_id(7) == NULL);                        /* destroyed ...    */
+    assert(structure_by_id_any(7) == &placed_structures[1]);   /* ... until reused  */
+    assert(shipyard_by_id(9) == &placed_structures[2]);
+    assert(shipyard_by_id(40000) == NULL);
+    assert(structure_by_id(0) == NULL && structure_by_id(70000) == NULL && structure_by_id(8) == NULL);
+
+    /* Destroyed in place without a rebuild: the stale entry fails */
+    placed_structures[0].active = false;
+    assert(structure_by_id(40000) == NULL);
+
+    /* Wholesale rewrite (as a reload would) moves slot 2 down */
+    placed_structures[0] = placed_structures[2];
+    placed_structure_count = 1;
+    structure_index_rebuild();
+    assert(structure_by_id(9) == &placed_structures[0]);
+    assert(structure_by_id_any(7) == NULL && structure_by_id_any(40000) == NULL);
+
+    /* Appended without a rebuild */
+    placed_structures[1] = (PlacedStructure){ .active = true, .id = 10, .type = STRUCT_WRECK };
+    placed_structure_count = 2;
+    assert(structure_by_id(10) == &placed_structures[1]);
+    printf("  id lookups follow destroy, rewrites and appends\n");
+}
+
+/* Dense lists hold exactly the active slots, each once, with matching type */
+static void check_lists(void) {
+    uint32_t n, seen = 0;
+    const uint32_t *live = structure_live_slots(&n);
+    static bool listed[MAX_PLACED_STRUCTURES];
+    memset(listed, 0, sizeof(listed));
+    for (uint32_t i = 0; i < n; i++) {
+        assert(live[i] < placed_structure_count && placed_structures[live[i]].active);
+        assert(!listed[live[i]]);
+        listed[live[i]] = true;
+    }
+    for (uint32_t i = 0; i < placed_structure_count; i++) seen += placed_structures[i].active;
+    assert(seen == n);
+    const PlacedStructureType types[] = { STRUCT_WALL, STRUCT_CHEST, STRUCT_SHIPYARD, STRUCT_FLAG_FORT };
+    for (size_t t = 0; t < sizeof(types) / sizeof(types[0]); t++) {
+        const uint32_t *slots = structure_slots_of_type(types[t], &n);
+        uint32_t want = 0;
+        for (uint32_t i = 0; i < placed_structure_count; i++)
+            want += placed_structures[i].active && placed_structures[i].type == types[t];
+        assert(n == want);
+        for (uint32_t i = 0; i < n; i++) assert(placed_structures[slots[i]].type == types[t]);
+    }
+}
+
+static void test_slot_map(void) {
+    fill(0, 0.0f);
+    placed_structure_count = 0;
+    next_structure_id = 1;
+    structure_index_rebuild();
+
+    PlacedStructure *a = structure_alloc(STRUCT_WALL);
+    PlacedStructure *b = structure_alloc(STRUCT_CHEST);
+    assert(a == &placed_structures[0] && b == &placed_structures[1]);
+    assert(a->active && a->type == STRUCT_WALL && a->id == 1 && b->id == 2);
+    StructureHandle ha = structure_handle(a);
+    assert(ha != 0 && structure_from_handle(ha) == a);
+    check_lists();
+
+    /* A freed slot keeps its data and is not handed out before the reclaim */
+    structure_free(a);
+    structure_free(a);                              /* idempotent */
+    assert(!a->active && a->id == 1 && structure_by_id_any(1) == a);
+    assert(structure_from_handle(ha) == NULL);
+    uint32_t yard_epoch = structure_type_epoch(STRUCT_SHIPYARD);
+    uint32_t wall_epoch = structure_type_epoch(STRUCT_WALL);
+    PlacedStructure *c = structure_alloc(STRUCT_SHIPYARD);
+    assert(c == &placed_structures[2]);
+    assert(structure_type_epoch(STRUCT_SHIPYARD) != yard_epoch);
+    assert(structure_type_epoch(STRUCT_WALL) == wall_epoch);   /* other types untouched */
+    check_lists();
+
+    structure_store_reclaim();
+    PlacedStructure *d = structure_alloc(STRUCT_FLAG_FORT);
+    assert(d == a && d->type == STRUCT_FLAG_FORT && d->id == 4);
+    assert(d->x == 0.0f && d->hp == 0);             /* zeroed */
+    assert(structure_from_handle(ha) == NULL);      /* same slot, new generation */
+    assert(structure_from_handle(structure_handle(d)) == d);
+    assert(structure_by_id(1) == NULL && structure_by_id(4) == d);
+    check_lists();
+
+    /* Churn up to capacity: lists stay exact and a full store refuses */
+    srand(5);
+    uint32_t live_peak = 0;
+    for (int step = 0; step < 20000; step++) {
+        uint32_t n;
+        const uint32_t *live = structure_live_slots(&n);
+        if (n > 0 && rand() % 3 == 0) {
+            structure_free(&placed_structures[live[(uint32_t)rand() % n]]);
+        } else if (structure_store_has_room()) {
+            const PlacedStructureType types[] = { STRUCT_WALL, STRUCT_CHEST, STRUCT_SHIPYARD, STRUCT_FLAG_FORT, STRUCT_WRECK };
+            assert(structure_alloc(types[rand() % 5]) != NULL);
+        } else {
+            assert(structure_alloc(STRUCT_WALL) == NULL);
+        }
+        if (step % 64 == 0) structure_store_reclaim();
+        (void)structure_live_slots(&n);
+        if (n > live_peak) live_peak = n;
+        if (step % 1000 == 0) check_lists();
+    }
+    check_lists();
+    assert(placed_structure_count <= MAX_PLACED_STRUCTURES);
+    printf("  slot map: %u slots used for a peak of %u live structures\n", placed_structure_count, live_peak);
+
+    /* Id space wraps past 65535, skipping 0 and ids still held */
+    fill(0, 0.0f);
+    placed_structure_count = 0;
+    structure_index_rebuild();
+    PlacedStructure *keep = structure_alloc(STRUCT_WALL);
+    next_structure_id = 65535;
+    PlacedStructure *e = structure_alloc(STRUCT_WALL);
+    assert(e->id == 65535);
+    uint16_t held = keep->id;
+    next_structure_id = held;
+    PlacedStructure *f = structure_alloc(STRUCT_WALL);
+    assert(f->id != 0 && f->id != held && structure_by_id(held) == keep);
+    next_structure_id = 0;
+    PlacedStructure *g = structure_alloc(STRUCT_WALL);
+    assert(g->id != 0 && g->id != held);
+    printf("  handles go stale on reuse; ids skip 0 and live ids on wrap\n");
+}
+
+/* Exactly the active, type-matching structures whose cell is in range, in slot order */
+static void check_near(StructureNear *near, float wx, float wy, float r, uint32_t mask) {
+    structure_index_near(near, wx, wy, r, mask);
+    for (uint32_t k = 1; k < near->count; k++) assert(near->slots[k - 1] < near->slots[k]);
+    int32_t x0 = structure_cell(wx - r), x1 = structure_cell(wx + r);
+    int32_t y0 = structure_cell(wy - r), y1 = structure_cell(wy + r);
+    uint32_t k = 0;
+    for (uint32_t i = 0; i < placed_structure_count; i++) {
+        const PlacedStructure *s = &placed_structures[i];
+        int32_t cx = structure_cell(s->x), cy = structure_cell(s->y);
+        bool want = s->active && (!mask || (mask & STRUCT_MASK(s->type))) &&
+                    cx >= x0 && cx <= x1 && cy >= y0 && cy <= y1;
+        bool listed = k < near->count && near->slots[k] == i;
+        assert(want == listed);
+        if (listed) k++;
+        /* Every centre within r on both axes is in range */
+        if (s->active && (!mask || (mask & STRUCT_MASK(s->type))) &&
+            fabsf(s->x - wx) <= r && fabsf(s->y - wy) <= r) assert(listed);
+    }
+    assert(k == near->count);
+}
+
+static void test_placement_grid(void) {
+    static StructureNear near;
+    const PlacedStructureType types[] = { STRUCT_WOODEN_FLOOR, STRUCT_WALL, STRUCT_CEILING, STRUCT_DOOR };
+    const uint32_t floors = STRUCT_MASK(STRUCT_WOODEN_FLOOR);
+    const uint32_t walls  = STRUCT_MASK(STRUCT_WALL) | STRUCT_MASK(STRUCT_DOOR);
+
+    /* Loaded world: filed by the rebuild */
+    srand(77);
+    fill(4000, 1500.0f);
+    for (uint32_t i = 0; i < placed_structure_count; i++) placed_structures[i].type = types[rand() % 4];
+    structure_index_rebuild();
+    for (int q = 0; q < 500; q++) {
+        float r = frand(0.0f, 120.0f);
+        check_near(&near, frand(-1600.0f, 1600.0f), frand(-1600.0f, 1600.0f), r, q % 3 ? floors : 0);
+    }
+
+    /* Placement and demolish churn: a structure is positioned after alloc,
+     * freed slots come back after the reclaim, some land on the same cell */
+    for (int step = 0; step < 20000; step++) {
+        uint32_t n;
+        const uint32_t *live = structure_live_slots(&n);
+        if (n > 0 && rand() % 2 == 0) {
+            structure_free(&placed_structures[live[(uint32_t)rand() % n]]);
+        } else if (structure_store_has_room()) {
+            PlacedStructure *s = structure_alloc(types[rand() % 4]);
+            s->x = roundf(frand(-1500.0f, 1500.0f) / 25.0f) * 25.0f;
+            s->y = roundf(frand(-1500.0f, 1500.0f) / 25.0f) * 25.0f;
+        }
+        if (step % 7 == 0) {
+            PlacedStructure *s = &placed_structures[(uint32_t)rand() % placed_structure_count];
+            check_near(&near, s->x, s->y, step % 14 ? 0.0f : 60.0f, step % 3 ? walls : 0);
+        }
+        if (step % 50 == 0) structure_store_reclaim();
+    }
+
+    /* Nested queries keep their own lists */
+    static StructureNear inner;
+    structure_index_near(&near, 0.0f, 0.0f, 400.0f, floors);
+    uint32_t outer_n = near.count;
+    for (uint32_t k = 0; k < outer_n; k++) {
+        const PlacedStructure *f = &placed_structures[near.slots[k]];
+        check_near(&inner, f->x, f->y, 25.0f, walls);
+    }
+    assert(near.count == outer_n);
+    printf("  placement grid: exact neighbourhoods through %u slots of churn\n", placed_structure_count);
+}
+
+int main(void) {
+    printf("Testing structure index...\n");
+    test_slot_map();
+    test_id_lookup();
+    test_superset();
+    test_clustered();
+    test_follows_changes();
+    test_placement_grid();
+    printf("All structure index tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,171 @@
+/* Timer wheel: timers fire once, never early and at most one wheel tick
+ * late, across every level and past the horizon; cancel and stale handles;
+ * handlers re-arming with delay 0 run once per advance; pending counts;
+ * the pool growing past its initial size; and the 32-bit millisecond clock
+ * wrapping. */
+
+#define _POSIX_C_SOURCE 200809L
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "util/timer_wheel.h"
+
+#define N_RANDOM 5000
+
+static uint32_t g_due[N_RANDOM];     /* Absolute deadline (ms) per arg */
+static uint32_t g_fired_at[N_RANDOM];
+static int      g_fire_count[N_RANDOM];
+
+static void on_random(uint32_t arg, uint32_t now_ms, uint32_t elapsed_ms) {
+    (void)elapsed_ms;
+    g_fired_at[arg] = now_ms;
+    g_fire_count[arg]++;
+}
+
+static int      g_rearm_runs;
+static uint32_t g_rearm_elapsed;
+static TimerKind g_rearm_kind;
+static void on_rearm(uint32_t arg, uint32_t now_ms, uint32_t elapsed_ms) {
+    g_rearm_runs++;
+    g_rearm_elapsed += elapsed_ms;
+    if (arg) timer_wheel_schedule(g_rearm_kind, arg - 1, now_ms, 0);
+}
+
+static TimerKind g_random_kind;
+
+static uint32_t g_bulk_fired;
+static void on_bulk(uint32_t arg, uint32_t now_ms, uint32_t elapsed_ms) {
+    (void)arg; (void)now_ms; (void)elapsed_ms;
+    g_bulk_fired++;
+}
+
+/* Step the clock by `step` ms until `end`, checking every fire */
+static void run_until(uint32_t start, uint32_t end, uint32_t step) {
+    for (uint32_t now = start; (int32_t)(end - now) >= 0; now += step)
+        timer_wheel_advance(now);
+}
+
+static void test_random(uint32_t base) {
+    timer_wheel_init(base);
+    memset(g_fire_count, 0, sizeof(g_fire_count));
+    srand(base ^ 0x5eed);
+    /* Deadlines from "now" out to ~5 h: every level gets some */
+    for (uint32_t k = 0; k < N_RANDOM; k++) {
+        uint32_t delay;
+        switch (k % 4) {
+            case 0:  delay = (uint32_t)(rand() % 1000);           break;
+            case 1:  delay = (uint32_t)(rand() % 65000);          break;
+            case 2:  delay = (uint32_t)(rand() % 4000000);        break;
+            default: delay = (uint32_t)(rand() % 18000000);       break;
+        }
+        g_due[k] = base + delay;
+        assert(timer_wheel_schedule(g_random_kind, k, base, delay) != 0);
+    }
+    assert(timer_wheel_pending_count(g_random_kind) == N_RANDOM);
+    /* ~30 Hz with jitter for the first minute, then coarser */
+    uint32_t now = base;
+    while ((int32_t)(now - (base + 60000u)) < 0) {
+        now += 28u + (uint32_t)(rand() % 12);
+        timer_wheel_advance(now);
+    }
+    run_until(now, base + 18000000u + 1000u, 997u);
+
+    for (uint32_t k = 0; k < N_RANDOM; k++) {
+        assert(g_fire_count[k] == 1);
+        int32_t late = (int32_t)(g_fired_at[k] - g_due[k]);
+        assert(late >= 0);
+        /* One wheel tick plus the caller's own step */
+        uint32_t step = (int32_t)(g_due[k] - (base + 60000u)) < 0 ? 40u : 997u;
+        assert(late <= (int32_t)(TIMER_WHEEL_TICK_MS + step));
+    }
+    assert(timer_wheel_pending_count(0) == 0);
+    printf("  %d timers from 0 to 5 h (base %u): each fired once, never early\n", N_RANDOM, base);
+}
+
+static void test_cancel(void) {
+    timer_wheel_init(1000);
+    memset(g_fire_count, 0, sizeof(g_fire_count));
+    TimerHandle a = timer_wheel_schedule(g_random_kind, 1, 1000, 500);
+    TimerHandle b = timer_wheel_schedule(g_random_kind, 2, 1000, 500);
+    TimerHandle c = timer_wheel_schedule(g_random_kind, 3, 1000, 90000);
+    assert(a && b && c && a != b);
+    assert(timer_wheel_pending(a) && timer_wheel_pending_count(g_random_kind) == 3);
+    assert(timer_wheel_cancel(b) && !timer_wheel_cancel(b) && !timer_wheel_pending(b));
+    assert(timer_wheel_cancel(c));
+    assert(timer_wheel_pending_count(g_random_kind) == 1);
+
+    /* A released slot comes back with a new generation */
+    TimerHandle d = timer_wheel_schedule(g_random_kind, 4, 1000, 500);
+    const uint32_t slot = TIMER_WHEEL_MAX_TIMERS - 1u;
+    assert((d & slot) == (c & slot) && d != c && !timer_wheel_pending(c));
+    assert(!timer_wheel_cancel(0));
+
+    run_until(1000, 2000, 33);
+    assert(g_fire_count[1] == 1 && g_fire_count[2] == 0 && g_fire_count[3] == 0 && g_fire_count[4] == 1);
+    assert(!timer_wheel_pending(a) && !timer_wheel_cancel(a));
+    run_until(2000, 100000, 1000);
+    assert(g_fire_count[3] == 0 && timer_wheel_pending_count(0) == 0);
+    printf("  cancel: cancelled timers never fire, stale handles are refused\n");
+}
+
+static void test_rearm(void) {
+    timer_wheel_init(0);
+    g_rearm_runs = 0;
+    g_rearm_elapsed = 0;
+    /* Re-arms itself with delay 0 nine times */
+    timer_wheel_schedule(g_rearm_kind, 9, 0, 0);
+    assert(timer_wheel_advance(0) == 1 && g_rearm_runs == 1);
+    /* A 100 ms gap spans several wheel ticks: still one run per advance,
+     * and it is handed the whole gap */
+    assert(timer_wheel_advance(100) == 1 && g_rearm_runs == 2 && g_rearm_elapsed == 100);
+    for (uint32_t now = 133; g_rearm_runs < 10; now += 33) timer_wheel_advance(now);
+    assert(timer_wheel_pending_count(g_rearm_kind) == 0);
+    printf("  delay 0 from a handler: next advance, elapsed covers the gap\n");
+}
+
+static void test_horizon(void) {
+    timer_wheel_init(0);
+    memset(g_fire_count, 0, sizeof(g_fire_count));
+    /* Past the ~74 h horizon */
+    uint32_t far = 90u * 3600u * 1000u;
+    timer_wheel_schedule(g_random_kind, 7, 0, far);
+    run_until(0, far - 60000u, 60000u);
+    assert(g_fire_count[7] == 0);
+    run_until(far - 60000u + 16u, far + 100u, 16u);
+    assert(g_fire_count[7] == 1 && (int32_t)(g_fired_at[7] - far) >= 0);
+    printf("  a 90 h timer waits out the horizon and fires on time\n");
+}
+
+/* Well past the initial pool (and the old fixed 32768): the pool grows,
+ * handles taken before the growth stay valid, and nothing is dropped */
+static void test_growth(TimerKind kind) {
+    const uint32_t n = TIMER_WHEEL_INIT_TIMERS * 10u;
+    timer_wheel_init(0);
+    g_bulk_fired = 0;
+    TimerHandle first = timer_wheel_schedule(kind, 0, 0, 5000);
+    for (uint32_t i = 1; i < n; i++)
+        assert(timer_wheel_schedule(kind, i, 0, 1000 + (i % 4000)));
+    assert(timer_wheel_pending(first) && timer_wheel_pending_count(kind) == n);
+    assert(timer_wheel_cancel(first));
+    run_until(0, 6000, 16);
+    assert(g_bulk_fired == n - 1 && timer_wheel_pending_count(0) == 0);
+    assert(timer_wheel_dropped_count(0) == 0);
+    printf("  %u timers pending at once, none dropped\n", n);
+}
+
+int main(void) {
+    printf("Testing timer wheel...\n");
+    g_random_kind = timer_wheel_kind("kind=\"test\"", on_random);
+    g_rearm_kind  = timer_wheel_kind("kind=\"test_rearm\"", on_rearm);
+    assert(g_random_kind && g_rearm_kind && g_random_kind != g_rearm_kind);
+    test_random(1000);
+    test_random(0xFFFFFFFFu - 3600000u);   /* get_time_ms() wraps an hour in */
+    test_cancel();
+    test_rearm();
+    test_horizon();
+    test_growth(timer_wheel_kind("kind=\"test_bulk\"", on_bulk));
+    printf("All timer wheel tests passed!\n");
+    return 0;
+}